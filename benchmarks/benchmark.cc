@@ -18,19 +18,43 @@
 #include "google/protobuf/descriptor.pb.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_check.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/compiler/parser.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/descriptor_database.h"
 #include "google/protobuf/dynamic_message.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/tokenizer.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 #include "google/protobuf/json/json.h"
+#include "google/protobuf/lazy_field.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/text_format.h"
+#include "google/protobuf/unknown_field_set.h"
+#include "google/protobuf/wire_format_lite.h"
+#include "benchmarks/200_msgs.pb.h"
 #include "benchmarks/descriptor.pb.h"
 #include "benchmarks/descriptor.upb.h"
 #include "benchmarks/descriptor.upbdefs.h"
 #include "benchmarks/descriptor_sv.pb.h"
+#include "benchmarks/workloads.pb.h"
 #include "upb/base/string_view.h"
 #include "upb/base/upcast.h"
+#include "upb/hash/common.h"
+#include "upb/hash/int_table.h"
 #include "upb/json/decode.h"
 #include "upb/json/encode.h"
 #include "upb/mem/arena.h"
+#include "upb/message/copy.h"
+#include "upb/message/message.h"
 #include "upb/reflection/def.hpp"
+#include "upb/text/debug_string.h"
+#include "upb/text/encode.h"
 #include "upb/wire/decode.h"
+#include "utf8_range.h"
 
 upb_StringView descriptor =
     benchmarks_descriptor_proto_upbdefinit.descriptor;
@@ -115,6 +139,114 @@ static void BM_ArenaFuseBalanced(benchmark::State& state) {
 }
 BENCHMARK(BM_ArenaFuseBalanced)->Range(2, 128);
 
+// Every thread fuses new arenas into one shared arena, as when many threads
+// assign sub-messages into the same message tree.
+upb_Arena* shared_fuse_root;
+
+static void BM_ArenaFuseThreaded(benchmark::State& state) {
+  if (state.thread_index() == 0) shared_fuse_root = upb_Arena_New();
+  for (auto _ : state) {
+    upb_Arena* arena = upb_Arena_New();
+    upb_Arena_Fuse(shared_fuse_root, arena);
+    upb_Arena_Free(arena);
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) upb_Arena_Free(shared_fuse_root);
+}
+// Bound the iterations since fused arenas live until the whole group is freed.
+BENCHMARK(BM_ArenaFuseThreaded)
+    ->Iterations(1 << 16)
+    ->ThreadRange(1, 128)
+    ->UseRealTime();
+
+// Every thread allocates from a small set of shared arenas, switching arena on
+// each allocation. This defeats the per-thread "last arena" cache so each
+// allocation has to find the thread's SerialArena in the arena.
+constexpr int kSharedArenas = 4;
+protobuf::Arena* shared_arenas[kSharedArenas];
+
+static void BM_ArenaSharedAlloc_Proto2(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    for (auto& arena : shared_arenas) arena = new protobuf::Arena;
+  }
+  int i = state.thread_index();
+  for (auto _ : state) {
+    protobuf::Arena* arena = shared_arenas[i++ % kSharedArenas];
+    benchmark::DoNotOptimize(protobuf::Arena::CreateArray<char>(arena, 8));
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    for (auto& arena : shared_arenas) delete arena;
+  }
+}
+// Bound the iterations so the arenas do not grow without limit.
+BENCHMARK(BM_ArenaSharedAlloc_Proto2)
+    ->Iterations(1 << 18)
+    ->ThreadRange(1, 128)
+    ->UseRealTime();
+
+enum IntTableKeys {
+  Dense,
+  Pointers,
+};
+
+// Keys past the array part, as for sparse field numbers or pointers.
+template <IntTableKeys Keys>
+static std::vector<uintptr_t> MakeIntTableKeys(upb_Arena* arena, size_t n) {
+  std::vector<uintptr_t> keys;
+  for (size_t i = 0; i < n; i++) {
+    keys.push_back(Keys == Pointers ? (uintptr_t)upb_Arena_Malloc(arena, 24)
+                                    : 1000 + i);
+  }
+  return keys;
+}
+
+template <IntTableKeys Keys>
+static void BM_IntTableInsert(benchmark::State& state) {
+  upb_Arena* key_arena = upb_Arena_New();
+  std::vector<uintptr_t> keys =
+      MakeIntTableKeys<Keys>(key_arena, state.range(0));
+  for (auto _ : state) {
+    upb_Arena* arena = upb_Arena_New();
+    upb_inttable t;
+    upb_inttable_init(&t, arena);
+    for (uintptr_t key : keys) {
+      upb_inttable_insert(&t, key, upb_value_uintptr(key), arena);
+    }
+    upb_Arena_Free(arena);
+  }
+  upb_Arena_Free(key_arena);
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK_TEMPLATE(BM_IntTableInsert, Dense)->Range(16, 1 << 14);
+BENCHMARK_TEMPLATE(BM_IntTableInsert, Pointers)->Range(16, 1 << 14);
+
+// Table sizes between powers of two exercise different load factors.
+template <IntTableKeys Keys>
+static void BM_IntTableLookup(benchmark::State& state) {
+  upb_Arena* arena = upb_Arena_New();
+  std::vector<uintptr_t> keys = MakeIntTableKeys<Keys>(arena, state.range(0));
+  upb_inttable t;
+  upb_inttable_init(&t, arena);
+  for (uintptr_t key : keys) {
+    upb_inttable_insert(&t, key, upb_value_uintptr(key), arena);
+  }
+  for (auto _ : state) {
+    for (uintptr_t key : keys) {
+      upb_value v;
+      benchmark::DoNotOptimize(upb_inttable_lookup(&t, key, &v));
+    }
+  }
+  upb_Arena_Free(arena);
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK_TEMPLATE(BM_IntTableLookup, Dense)
+    ->RangeMultiplier(3)
+    ->Range(16, 1 << 14);
+BENCHMARK_TEMPLATE(BM_IntTableLookup, Pointers)
+    ->RangeMultiplier(3)
+    ->Range(16, 1 << 14);
+
 enum LoadDescriptorMode {
   NoLayout,
   WithLayout,
@@ -197,6 +329,38 @@ static void BM_LoadAdsDescriptor_Upb(benchmark::State& state) {
 BENCHMARK_TEMPLATE(BM_LoadAdsDescriptor_Upb, NoLayout);
 BENCHMARK_TEMPLATE(BM_LoadAdsDescriptor_Upb, WithLayout);
 
+// Only measures upb_DefPool_AddFile(): the descriptors are parsed once,
+// before the loop, and no MiniTables are built.
+static void BM_AddAdsFiles_Upb(benchmark::State& state) {
+  extern _upb_DefPool_Init
+      google_ads_googleads_v16_services_google_ads_service_proto_upbdefinit;
+  std::vector<upb_StringView> serialized_files;
+  absl::flat_hash_set<const _upb_DefPool_Init*> seen_files;
+  CollectFileDescriptors(
+      &google_ads_googleads_v16_services_google_ads_service_proto_upbdefinit,
+      serialized_files, seen_files);
+  upb::Arena arena;
+  std::vector<const google_protobuf_FileDescriptorProto*> files;
+  size_t bytes_per_iter = 0;
+  for (auto file : serialized_files) {
+    files.push_back(google_protobuf_FileDescriptorProto_parse_ex(
+        file.data, file.size, nullptr, kUpb_DecodeOption_AliasString,
+        arena.ptr()));
+    ABSL_CHECK(files.back() != nullptr);
+    bytes_per_iter += file.size;
+  }
+  for (auto _ : state) {
+    upb::DefPool defpool;
+    for (auto file : files) {
+      upb::Status status;
+      ABSL_CHECK(upb_DefPool_AddFile(defpool.ptr(), file, status.ptr()))
+          << status.error_message();
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * bytes_per_iter);
+}
+BENCHMARK(BM_AddAdsFiles_Upb);
+
 template <LoadDescriptorMode Mode>
 static void BM_LoadAdsDescriptor_Proto2(benchmark::State& state) {
   extern _upb_DefPool_Init
@@ -240,6 +404,41 @@ static void BM_LoadAdsDescriptor_Proto2(benchmark::State& state) {
 BENCHMARK_TEMPLATE(BM_LoadAdsDescriptor_Proto2, NoLayout);
 BENCHMARK_TEMPLATE(BM_LoadAdsDescriptor_Proto2, WithLayout);
 
+enum RegisterMode {
+  Eager,
+  Lazy,
+};
+
+// Registers many synthetic files with a database, as the generated code of a
+// large binary does at startup, and then builds just one of them.
+template <RegisterMode Mode>
+static void BM_RegisterSyntheticFiles_Proto2(benchmark::State& state) {
+  // Copies of 200_msgs.proto, each in its own package.
+  protobuf::FileDescriptorProto proto;
+  upb_benchmark::Message::descriptor()->file()->CopyTo(&proto);
+  std::vector<std::string> files(state.range(0));
+  for (size_t i = 0; i < files.size(); ++i) {
+    proto.set_name(absl::StrCat("synthetic_", i, ".proto"));
+    proto.set_package(absl::StrCat("synthetic", i));
+    files[i] = proto.SerializeAsString();
+  }
+  for (auto _ : state) {
+    protobuf::EncodedDescriptorDatabase database;
+    for (const std::string& file : files) {
+      if (Mode == Eager) {
+        ABSL_CHECK(database.Add(file.data(), file.size()));
+      } else {
+        database.AddLazily(file.data(), file.size());
+      }
+    }
+    protobuf::DescriptorPool pool(&database);
+    ABSL_CHECK(pool.FindMessageTypeByName("synthetic0.Message") != nullptr);
+  }
+  state.SetItemsProcessed(state.iterations() * files.size());
+}
+BENCHMARK_TEMPLATE(BM_RegisterSyntheticFiles_Proto2, Eager)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_RegisterSyntheticFiles_Proto2, Lazy)->Range(64, 4096);
+
 enum CopyStrings {
   Copy,
   Alias,
@@ -341,6 +540,108 @@ BENCHMARK_TEMPLATE(BM_Parse_Proto2, FileDesc, UseArena, Copy);
 BENCHMARK_TEMPLATE(BM_Parse_Proto2, FileDesc, InitBlock, Copy);
 BENCHMARK_TEMPLATE(BM_Parse_Proto2, FileDescSV, InitBlock, Alias);
 
+// Parses into one message over and over, as a server reusing its request
+// proto does.  Clear() keeps the elements of repeated fields and the buffers
+// of strings, so after the first iteration the parser only refills them.
+template <class P>
+void BM_Parse_Proto2_ReusedMessage(benchmark::State& state) {
+  P proto;
+  absl::string_view input(descriptor.data, descriptor.size);
+  for (auto _ : state) {
+    bool ok = proto.ParseFromString(input);
+    if (!ok) {
+      printf("Failed to parse.\n");
+      exit(1);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * descriptor.size);
+}
+BENCHMARK_TEMPLATE(BM_Parse_Proto2_ReusedMessage, FileDesc);
+
+// Parses messages of a few dozen bytes, as key-value stores holding small
+// values do, where the fixed cost of each parse dominates.
+template <class P>
+void BM_Parse_Proto2_Tiny(benchmark::State& state) {
+  P source;
+  source.set_name(std::string(state.range(0), 'x'));
+  source.set_package("pkg");
+  const std::string input = source.SerializeAsString();
+  P proto;
+  for (auto _ : state) {
+    bool ok = proto.ParseFromString(input);
+    if (!ok) {
+      printf("Failed to parse.\n");
+      exit(1);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK_TEMPLATE(BM_Parse_Proto2_Tiny, FileDesc)->Arg(4)->Arg(16)->Arg(48);
+
+// A schema shaped like unittest_enormous_descriptor.proto: a single message
+// with `fields` fields with long names and long string defaults.
+static std::string MakeEnormousProto(int fields) {
+  std::string text =
+      "syntax = \"proto2\";\n"
+      "package benchmark;\n"
+      "message TestEnormousDescriptor {\n";
+  const std::string name(72, 'o');
+  const std::string value(81, 'o');
+  for (int i = 1; i <= fields; ++i) {
+    absl::StrAppend(&text, "  optional string long_field_name_is_l", name,
+                    "ng_", i, " = ", i,
+                    " [default=\"long default value is also l", value,
+                    "ng\"];\n");
+  }
+  text += "}\n";
+  return text;
+}
+
+class CheckingErrorCollector : public protobuf::io::ErrorCollector {
+ public:
+  void RecordError(int line, int column, absl::string_view message) override {
+    ABSL_CHECK(false) << line << ":" << column << ": " << message;
+  }
+};
+
+static void BM_ParseProtoText(benchmark::State& state) {
+  const std::string text = MakeEnormousProto(state.range(0));
+  CheckingErrorCollector errors;
+  for (auto _ : state) {
+    protobuf::io::ArrayInputStream input(text.data(),
+                                         static_cast<int>(text.size()));
+    protobuf::io::Tokenizer tokenizer(&input, &errors);
+    protobuf::compiler::Parser parser;
+    parser.RecordErrorsTo(&errors);
+    protobuf::FileDescriptorProto file;
+    ABSL_CHECK(parser.Parse(&tokenizer, &file));
+    benchmark::DoNotOptimize(file);
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_ParseProtoText)->Range(1 << 10, 1 << 16);
+
+// A sub-message that is only routed costs a copy of its bytes when held in a
+// LazyField, compared to a full parse above. kAccess adds the parse on first
+// access.
+template <bool kAccess>
+static void BM_LazyField_Proto2(benchmark::State& state) {
+  const absl::Cord input(absl::string_view(descriptor.data, descriptor.size));
+  for (auto _ : state) {
+    protobuf::Arena arena;
+    auto* field =
+        protobuf::Arena::Create<protobuf::internal::LazyField>(&arena, &arena);
+    field->SetEncoded(input);
+    if (kAccess) {
+      benchmark::DoNotOptimize(&field->Get(FileDesc::default_instance()));
+    }
+    benchmark::DoNotOptimize(field->ByteSizeLong());
+  }
+  state.SetBytesProcessed(state.iterations() * descriptor.size);
+}
+BENCHMARK_TEMPLATE(BM_LazyField_Proto2, false);
+BENCHMARK_TEMPLATE(BM_LazyField_Proto2, true);
+
 static void BM_SerializeDescriptor_Proto2(benchmark::State& state) {
   upb_benchmark::FileDescriptorProto proto;
   proto.ParseFromArray(descriptor.data, descriptor.size);
@@ -381,6 +682,26 @@ static void BM_SerializeDescriptor_Upb(benchmark::State& state) {
 }
 BENCHMARK(BM_SerializeDescriptor_Upb);
 
+static void BM_DeepCloneDescriptor_Upb(benchmark::State& state) {
+  upb_Arena* arena = upb_Arena_New();
+  upb_benchmark_FileDescriptorProto* set = UpbParseDescriptor(arena);
+  for (auto _ : state) {
+    upb_Arena* clone_arena =
+        upb_Arena_Init(buf, sizeof(buf), &upb_alloc_global);
+    upb_Message* clone = upb_Message_DeepClone(
+        UPB_UPCAST(set), &upb_0benchmark__FileDescriptorProto_msg_init,
+        clone_arena);
+    if (!clone) {
+      printf("Failed to clone.\n");
+      exit(1);
+    }
+    upb_Arena_Free(clone_arena);
+  }
+  upb_Arena_Free(arena);
+  state.SetBytesProcessed(state.iterations() * descriptor.size);
+}
+BENCHMARK(BM_DeepCloneDescriptor_Upb);
+
 static absl::string_view UpbJsonEncode(upb_benchmark_FileDescriptorProto* proto,
                                        const upb_MessageDef* md,
                                        upb_Arena* arena) {
@@ -469,3 +790,839 @@ static void BM_JsonSerialize_Proto2(benchmark::State& state) {
   state.SetBytesProcessed(state.iterations() * json.size());
 }
 BENCHMARK(BM_JsonSerialize_Proto2);
+
+static void BM_TextSerialize_Upb(benchmark::State& state) {
+  upb_Arena* arena = upb_Arena_New();
+  upb_benchmark_FileDescriptorProto* set =
+      upb_benchmark_FileDescriptorProto_parse(descriptor.data, descriptor.size,
+                                              arena);
+  ABSL_CHECK(set != nullptr);
+
+  upb::DefPool defpool;
+  const upb_MessageDef* md =
+      upb_benchmark_FileDescriptorProto_getmsgdef(defpool.ptr());
+  size_t size = upb_TextEncode(UPB_UPCAST(set), md, nullptr, 0, nullptr, 0);
+  std::string text;
+  text.resize(size + 1);
+
+  for (auto _ : state) {
+    upb_TextEncode(UPB_UPCAST(set), md, nullptr, 0, text.data(), text.size());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+  upb_Arena_Free(arena);
+}
+BENCHMARK(BM_TextSerialize_Upb);
+
+static void BM_DebugString_Upb(benchmark::State& state) {
+  upb_Arena* arena = upb_Arena_New();
+  upb_benchmark_FileDescriptorProto* set =
+      upb_benchmark_FileDescriptorProto_parse(descriptor.data, descriptor.size,
+                                              arena);
+  ABSL_CHECK(set != nullptr);
+
+  const upb_MiniTable* mt = &upb_0benchmark__FileDescriptorProto_msg_init;
+  size_t size = upb_DebugString(UPB_UPCAST(set), mt, 0, nullptr, 0);
+  std::string text;
+  text.resize(size + 1);
+
+  for (auto _ : state) {
+    upb_DebugString(UPB_UPCAST(set), mt, 0, text.data(), text.size());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+  upb_Arena_Free(arena);
+}
+BENCHMARK(BM_DebugString_Upb);
+
+static void BM_TextSerialize_Proto2(benchmark::State& state) {
+  protobuf::FileDescriptorProto proto;
+  absl::string_view input(descriptor.data, descriptor.size);
+  proto.ParseFromString(input);
+  std::string text;
+  for (auto _ : state) {
+    text.clear();
+    ABSL_CHECK(protobuf::TextFormat::PrintToString(proto, &text));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_TextSerialize_Proto2);
+
+// Builds a string of `size` bytes. When `non_ascii` is set, every eighth
+// character is a two byte codepoint, which forces the non-ASCII path.
+static std::string MakeUtf8String(size_t size, bool non_ascii) {
+  std::string str;
+  while (str.size() + 2 <= size) {
+    if (non_ascii && str.size() % 8 == 6) {
+      str.append("\xc3\xa9");
+    } else {
+      str.push_back('a' + str.size() % 26);
+    }
+  }
+  str.resize(size, 'z');
+  return str;
+}
+
+template <bool kNonAscii>
+static void BM_Utf8Validate(benchmark::State& state) {
+  std::string str = MakeUtf8String(state.range(0), kNonAscii);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(utf8_range_IsValid(str.data(), str.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+}
+BENCHMARK_TEMPLATE(BM_Utf8Validate, false)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Utf8Validate, true)->Range(8, 1 << 16);
+
+// A descriptor whose name is a string of `size` bytes with a newline, which
+// has to be escaped, in every 64 bytes.
+static upb_benchmark_FileDescriptorProto* UpbStringProto(std::string& name,
+                                                         size_t size,
+                                                         upb_Arena* arena) {
+  name = MakeUtf8String(size, /*non_ascii=*/true);
+  for (size_t i = 63; i < name.size(); i += 64) name[i] = '\n';
+  upb_benchmark_FileDescriptorProto* proto =
+      upb_benchmark_FileDescriptorProto_new(arena);
+  upb_benchmark_FileDescriptorProto_set_name(
+      proto, upb_StringView_FromDataAndSize(name.data(), name.size()));
+  return proto;
+}
+
+static void BM_JsonStringParse_Upb(benchmark::State& state) {
+  upb_Arena* arena = upb_Arena_New();
+  std::string name;
+  upb::DefPool defpool;
+  const upb_MessageDef* md =
+      upb_benchmark_FileDescriptorProto_getmsgdef(defpool.ptr());
+  auto json = UpbJsonEncode(UpbStringProto(name, state.range(0), arena), md,
+                            arena);
+
+  for (auto _ : state) {
+    upb_Arena* arena = upb_Arena_New();
+    upb_benchmark_FileDescriptorProto* proto =
+        upb_benchmark_FileDescriptorProto_new(arena);
+    upb_JsonDecode(json.data(), json.size(), UPB_UPCAST(proto), md,
+                   defpool.ptr(), 0, arena, nullptr);
+    upb_Arena_Free(arena);
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+  upb_Arena_Free(arena);
+}
+BENCHMARK(BM_JsonStringParse_Upb)->Range(8, 1 << 16);
+
+static void BM_JsonStringSerialize_Upb(benchmark::State& state) {
+  upb_Arena* arena = upb_Arena_New();
+  std::string name;
+  upb::DefPool defpool;
+  const upb_MessageDef* md =
+      upb_benchmark_FileDescriptorProto_getmsgdef(defpool.ptr());
+  upb_benchmark_FileDescriptorProto* proto =
+      UpbStringProto(name, state.range(0), arena);
+  auto json = UpbJsonEncode(proto, md, arena);
+  std::string json_str(json.size(), '\0');
+
+  for (auto _ : state) {
+    upb_JsonEncode(UPB_UPCAST(proto), md, nullptr, 0, json_str.data(),
+                   json_str.size(), nullptr);
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+  upb_Arena_Free(arena);
+}
+BENCHMARK(BM_JsonStringSerialize_Upb)->Range(8, 1 << 16);
+
+// Workloads for the C++ runtime, from workloads.proto.  Each one builds a
+// single message shaped like a common kind of production data, and the
+// benchmarks below run every operation of the runtime over each of them.
+namespace workloads = ::upb_benchmark::workloads;
+
+// Sets every singular scalar field of `message`, with varints of varying
+// lengths.
+static void SetScalarFields(protobuf::Message& message, int seed) {
+  const protobuf::Reflection* reflection = message.GetReflection();
+  const protobuf::Descriptor* descriptor = message.GetDescriptor();
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const protobuf::FieldDescriptor* field = descriptor->field(i);
+    if (field->is_repeated()) continue;
+    const uint64_t value = (uint64_t{1} << (field->number() * 5 % 60)) + seed;
+    switch (field->cpp_type()) {
+      case protobuf::FieldDescriptor::CPPTYPE_INT32:
+        reflection->SetInt32(&message, field, static_cast<int32_t>(value));
+        break;
+      case protobuf::FieldDescriptor::CPPTYPE_INT64:
+        reflection->SetInt64(&message, field, static_cast<int64_t>(value));
+        break;
+      case protobuf::FieldDescriptor::CPPTYPE_UINT32:
+        reflection->SetUInt32(&message, field, static_cast<uint32_t>(value));
+        break;
+      case protobuf::FieldDescriptor::CPPTYPE_UINT64:
+        reflection->SetUInt64(&message, field, value);
+        break;
+      case protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+        reflection->SetDouble(&message, field, value * 0.5);
+        break;
+      case protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+        reflection->SetFloat(&message, field, value * 0.25f);
+        break;
+      case protobuf::FieldDescriptor::CPPTYPE_BOOL:
+        reflection->SetBool(&message, field, true);
+        break;
+      case protobuf::FieldDescriptor::CPPTYPE_ENUM:
+        reflection->SetEnumValue(&message, field,
+                                 static_cast<int>(1 + value % 3));
+        break;
+      case protobuf::FieldDescriptor::CPPTYPE_STRING:
+        reflection->SetString(&message, field,
+                              absl::StrCat(field->name(), "_", value));
+        break;
+      case protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
+        break;
+    }
+  }
+}
+
+struct WideWorkload {
+  using Proto = workloads::Wide;
+  static void Fill(Proto& proto) { SetScalarFields(proto, 1); }
+};
+
+struct NestedWorkload {
+  using Proto = workloads::Nested;
+  static void Fill(Proto& proto) {
+    workloads::Nested* node = &proto;
+    for (int i = 0; i < 64; ++i) {
+      node->set_value(i);
+      node->set_name(absl::StrCat("node_", i));
+      node = node->mutable_child();
+    }
+  }
+};
+
+struct StringsWorkload {
+  using Proto = workloads::Strings;
+  static void Fill(Proto& proto) {
+    for (int i = 0; i < 256; ++i) {
+      proto.add_values(MakeUtf8String(8 + i % 120, /*non_ascii=*/i % 4 == 0));
+    }
+    proto.set_blob(std::string(4096, 'x'));
+  }
+};
+
+struct PackedWorkload {
+  using Proto = workloads::Packed;
+  static void Fill(Proto& proto) {
+    for (int i = 0; i < 1024; ++i) {
+      proto.add_int32s(i * 37);
+      proto.add_int64s(int64_t{i} << 20);
+      proto.add_sint64s(i - 512);
+      proto.add_fixed32s(i);
+      proto.add_doubles(i * 0.5);
+      proto.add_floats(i * 0.25f);
+    }
+  }
+};
+
+struct MapsWorkload {
+  using Proto = workloads::Maps;
+  static void Fill(Proto& proto) {
+    for (int i = 0; i < 256; ++i) {
+      (*proto.mutable_string_to_int64())[absl::StrCat("key_", i)] = i;
+      (*proto.mutable_int32_to_string())[i] = absl::StrCat("value_", i);
+      workloads::Nested& nested =
+          (*proto.mutable_string_to_message())[absl::StrCat("message_", i)];
+      nested.set_value(i);
+      nested.set_name("name");
+    }
+  }
+};
+
+struct ExtensionsWorkload {
+  using Proto = workloads::Extendable;
+  static void Fill(Proto& proto) {
+    proto.set_id(1);
+    proto.SetExtension(workloads::ext_int32, 2);
+    proto.SetExtension(workloads::ext_int64, int64_t{3} << 40);
+    proto.SetExtension(workloads::ext_double, 4.5);
+    proto.SetExtension(workloads::ext_string, "five");
+    proto.MutableExtension(workloads::ext_message)->set_value(6);
+    for (int i = 0; i < 64; ++i) {
+      proto.AddExtension(workloads::ext_int32s, i);
+      proto.AddExtension(workloads::ext_strings, absl::StrCat("string_", i));
+      proto.AddExtension(workloads::ext_messages)->set_value(i);
+    }
+  }
+};
+
+struct UnknownsWorkload {
+  using Proto = workloads::Unknowns;
+  static void Fill(Proto& proto) {
+    workloads::Wide wide;
+    WideWorkload::Fill(wide);
+    workloads::Nested nested;
+    NestedWorkload::Fill(nested);
+    ABSL_CHECK(proto.ParseFromString(
+        absl::StrCat(wide.SerializeAsString(), nested.SerializeAsString())));
+  }
+};
+
+struct AnyWorkload {
+  using Proto = workloads::Anys;
+  static void Fill(Proto& proto) {
+    for (int i = 0; i < 16; ++i) {
+      if (i % 2 == 0) {
+        workloads::Wide wide;
+        SetScalarFields(wide, i);
+        ABSL_CHECK(proto.add_payloads()->PackFrom(wide));
+      } else {
+        workloads::Nested nested;
+        NestedWorkload::Fill(nested);
+        ABSL_CHECK(proto.add_payloads()->PackFrom(nested));
+      }
+    }
+  }
+};
+
+template <class W>
+static const typename W::Proto& WorkloadMessage() {
+  static const auto* const proto = [] {
+    auto* proto = new typename W::Proto;
+    W::Fill(*proto);
+    return proto;
+  }();
+  return *proto;
+}
+
+enum ParseInput {
+  FromString,
+  FromCord,
+  FromStream,
+};
+
+// The chunk size of the Cord and stream inputs.
+constexpr size_t kWorkloadChunkSize = 4096;
+
+template <class W, ArenaMode AMode, ParseInput kInput>
+static void BM_Workload_Parse(benchmark::State& state) {
+  const std::string input = WorkloadMessage<W>().SerializeAsString();
+  absl::Cord cord;
+  for (size_t i = 0; i < input.size(); i += kWorkloadChunkSize) {
+    cord.Append(absl::string_view(input).substr(i, kWorkloadChunkSize));
+  }
+  for (auto _ : state) {
+    Proto2Factory<AMode, typename W::Proto> proto_factory;
+    auto proto = proto_factory.GetProto();
+    bool ok;
+    if (kInput == FromString) {
+      ok = proto->ParseFromString(input);
+    } else if (kInput == FromCord) {
+      ok = proto->ParseFromCord(cord);
+    } else {
+      protobuf::io::ArrayInputStream stream(
+          input.data(), static_cast<int>(input.size()), kWorkloadChunkSize);
+      ok = proto->ParseFromZeroCopyStream(&stream);
+    }
+    ABSL_CHECK(ok);
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+template <class W>
+static void BM_Workload_Serialize(benchmark::State& state) {
+  const typename W::Proto& proto = WorkloadMessage<W>();
+  std::string output;
+  for (auto _ : state) {
+    ABSL_CHECK(proto.SerializeToString(&output));
+  }
+  state.SetBytesProcessed(state.iterations() * output.size());
+}
+
+template <class W>
+static void BM_Workload_ByteSize(benchmark::State& state) {
+  const typename W::Proto& proto = WorkloadMessage<W>();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(proto.ByteSizeLong());
+  }
+  state.SetBytesProcessed(state.iterations() * proto.ByteSizeLong());
+}
+
+// Merges into a new message, as when building a message from parts.
+template <class W, ArenaMode AMode>
+static void BM_Workload_MergeFrom(benchmark::State& state) {
+  const typename W::Proto& source = WorkloadMessage<W>();
+  for (auto _ : state) {
+    Proto2Factory<AMode, typename W::Proto> proto_factory;
+    proto_factory.GetProto()->MergeFrom(source);
+  }
+  state.SetBytesProcessed(state.iterations() * source.ByteSizeLong());
+}
+
+// Copies over a message that already holds the same data, which reuses its
+// allocations, as servers that reuse their messages do.  Only on the heap,
+// since an arena would grow with every iteration.
+template <class W>
+static void BM_Workload_CopyFrom(benchmark::State& state) {
+  const typename W::Proto& source = WorkloadMessage<W>();
+  typename W::Proto proto = source;
+  for (auto _ : state) {
+    proto.CopyFrom(source);
+  }
+  state.SetBytesProcessed(state.iterations() * source.ByteSizeLong());
+}
+
+template <class W>
+static void BM_Workload_Clear(benchmark::State& state) {
+  const typename W::Proto& source = WorkloadMessage<W>();
+  typename W::Proto proto;
+  for (auto _ : state) {
+    state.PauseTiming();
+    proto.MergeFrom(source);
+    state.ResumeTiming();
+    proto.Clear();
+  }
+  state.SetBytesProcessed(state.iterations() * source.ByteSizeLong());
+}
+
+// Reads every set field through reflection, returning the number of values.
+static size_t VisitFields(const protobuf::Message& message) {
+  const protobuf::Reflection* reflection = message.GetReflection();
+  std::vector<const protobuf::FieldDescriptor*> fields;
+  reflection->ListFields(message, &fields);
+  std::string scratch;
+  size_t values = 0;
+  for (const protobuf::FieldDescriptor* field : fields) {
+    const int size =
+        field->is_repeated() ? reflection->FieldSize(message, field) : 1;
+    for (int i = 0; i < size; ++i) {
+      ++values;
+      switch (field->cpp_type()) {
+#define HANDLE_TYPE(CPPTYPE, METHOD)                                     \
+  case protobuf::FieldDescriptor::CPPTYPE_##CPPTYPE:                     \
+    benchmark::DoNotOptimize(                                            \
+        field->is_repeated()                                             \
+            ? reflection->GetRepeated##METHOD(message, field, i)         \
+            : reflection->Get##METHOD(message, field));                  \
+    break;
+        HANDLE_TYPE(INT32, Int32);
+        HANDLE_TYPE(INT64, Int64);
+        HANDLE_TYPE(UINT32, UInt32);
+        HANDLE_TYPE(UINT64, UInt64);
+        HANDLE_TYPE(DOUBLE, Double);
+        HANDLE_TYPE(FLOAT, Float);
+        HANDLE_TYPE(BOOL, Bool);
+        HANDLE_TYPE(ENUM, EnumValue);
+#undef HANDLE_TYPE
+        case protobuf::FieldDescriptor::CPPTYPE_STRING:
+          benchmark::DoNotOptimize(
+              field->is_repeated()
+                  ? reflection->GetRepeatedStringReference(message, field, i,
+                                                           &scratch)
+                  : reflection->GetStringReference(message, field, &scratch));
+          break;
+        case protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
+          values += VisitFields(
+              field->is_repeated()
+                  ? reflection->GetRepeatedMessage(message, field, i)
+                  : reflection->GetMessage(message, field));
+          break;
+      }
+    }
+  }
+  return values;
+}
+
+template <class W>
+static void BM_Workload_Reflection(benchmark::State& state) {
+  const typename W::Proto& proto = WorkloadMessage<W>();
+  size_t values = 0;
+  for (auto _ : state) {
+    values = VisitFields(proto);
+  }
+  state.SetItemsProcessed(state.iterations() * values);
+}
+
+template <class W>
+static void BM_Workload_JsonSerialize(benchmark::State& state) {
+  const typename W::Proto& proto = WorkloadMessage<W>();
+  std::string json;
+  for (auto _ : state) {
+    json.clear();
+    ABSL_CHECK_OK(protobuf::json::MessageToJsonString(proto, &json));
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+}
+
+template <class W>
+static void BM_Workload_JsonParse(benchmark::State& state) {
+  std::string json;
+  ABSL_CHECK_OK(
+      protobuf::json::MessageToJsonString(WorkloadMessage<W>(), &json));
+  for (auto _ : state) {
+    typename W::Proto proto;
+    ABSL_CHECK_OK(protobuf::json::JsonStringToMessage(json, &proto));
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+}
+
+template <class W>
+static void BM_Workload_TextSerialize(benchmark::State& state) {
+  const typename W::Proto& proto = WorkloadMessage<W>();
+  std::string text;
+  for (auto _ : state) {
+    ABSL_CHECK(protobuf::TextFormat::PrintToString(proto, &text));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+template <class W>
+static void BM_Workload_TextParse(benchmark::State& state) {
+  std::string text;
+  ABSL_CHECK(protobuf::TextFormat::PrintToString(WorkloadMessage<W>(), &text));
+  for (auto _ : state) {
+    typename W::Proto proto;
+    ABSL_CHECK(protobuf::TextFormat::ParseFromString(text, &proto));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+#define BENCHMARK_WORKLOAD_BINARY(W)                                 \
+  BENCHMARK_TEMPLATE(BM_Workload_Parse, W, NoArena, FromString);     \
+  BENCHMARK_TEMPLATE(BM_Workload_Parse, W, UseArena, FromString);    \
+  BENCHMARK_TEMPLATE(BM_Workload_Parse, W, InitBlock, FromString);   \
+  BENCHMARK_TEMPLATE(BM_Workload_Parse, W, NoArena, FromCord);       \
+  BENCHMARK_TEMPLATE(BM_Workload_Parse, W, NoArena, FromStream);     \
+  BENCHMARK_TEMPLATE(BM_Workload_Serialize, W);                      \
+  BENCHMARK_TEMPLATE(BM_Workload_ByteSize, W);                       \
+  BENCHMARK_TEMPLATE(BM_Workload_MergeFrom, W, NoArena);             \
+  BENCHMARK_TEMPLATE(BM_Workload_MergeFrom, W, UseArena);            \
+  BENCHMARK_TEMPLATE(BM_Workload_MergeFrom, W, InitBlock);           \
+  BENCHMARK_TEMPLATE(BM_Workload_CopyFrom, W);                       \
+  BENCHMARK_TEMPLATE(BM_Workload_Clear, W);                          \
+  BENCHMARK_TEMPLATE(BM_Workload_Reflection, W)
+
+#define BENCHMARK_WORKLOAD(W)                                        \
+  BENCHMARK_WORKLOAD_BINARY(W);                                      \
+  BENCHMARK_TEMPLATE(BM_Workload_JsonSerialize, W);                  \
+  BENCHMARK_TEMPLATE(BM_Workload_JsonParse, W);                      \
+  BENCHMARK_TEMPLATE(BM_Workload_TextSerialize, W);                  \
+  BENCHMARK_TEMPLATE(BM_Workload_TextParse, W)
+
+BENCHMARK_WORKLOAD(WideWorkload);
+BENCHMARK_WORKLOAD(NestedWorkload);
+BENCHMARK_WORKLOAD(StringsWorkload);
+BENCHMARK_WORKLOAD(PackedWorkload);
+BENCHMARK_WORKLOAD(MapsWorkload);
+BENCHMARK_WORKLOAD(ExtensionsWorkload);
+BENCHMARK_WORKLOAD(AnyWorkload);
+// Unknown fields are not printed as JSON, and text format can't parse them.
+BENCHMARK_WORKLOAD_BINARY(UnknownsWorkload);
+
+// Worst cases.  Each benchmark parses an adversarial input of growing size, as
+// found by the fuzzers, and fits the time to O(N): a quadratic cost shows up
+// as a poor fit and a growing per item time, instead of a timeout in a
+// service.
+
+// The default recursion limit of both the C++ and the upb parser.
+constexpr int kRecursionLimit = 100;
+
+static void SetWorstCaseCounters(benchmark::State& state, size_t bytes) {
+  state.SetComplexityN(state.range(0));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+// A chain of `depth` messages nested in a file, as nested_type of each other.
+static std::string DeeplyNestedDescriptor(int depth) {
+  protobuf::FileDescriptorProto file;
+  protobuf::DescriptorProto* message = file.add_message_type();
+  for (int i = 1; i < depth; ++i) message = message->add_nested_type();
+  return file.SerializeAsString();
+}
+
+static void BM_WorstCase_DeepNesting_Proto2(benchmark::State& state) {
+  const std::string input = DeeplyNestedDescriptor(state.range(0));
+  for (auto _ : state) {
+    FileDesc proto;
+    ABSL_CHECK(proto.ParseFromString(input));
+  }
+  SetWorstCaseCounters(state, input.size());
+}
+BENCHMARK(BM_WorstCase_DeepNesting_Proto2)
+    ->Range(8, 64)
+    ->Arg(kRecursionLimit - 1)
+    ->Complexity(benchmark::oN);
+
+static void BM_WorstCase_DeepNesting_Upb(benchmark::State& state) {
+  const std::string input = DeeplyNestedDescriptor(state.range(0));
+  for (auto _ : state) {
+    upb_Arena* arena = upb_Arena_New();
+    ABSL_CHECK(upb_benchmark_FileDescriptorProto_parse(input.data(),
+                                                       input.size(), arena));
+    upb_Arena_Free(arena);
+  }
+  SetWorstCaseCounters(state, input.size());
+}
+BENCHMARK(BM_WorstCase_DeepNesting_Upb)
+    ->Range(8, 64)
+    ->Arg(kRecursionLimit - 1)
+    ->Complexity(benchmark::oN);
+
+// `count` varint fields, with numbers that no message of the benchmarks uses.
+static std::string UnknownFields(int count) {
+  workloads::Unknowns proto;
+  for (int i = 0; i < count; ++i) {
+    proto.mutable_unknown_fields()->AddVarint(1000 + i, i);
+  }
+  return proto.SerializeAsString();
+}
+
+static void BM_WorstCase_UnknownFields_Proto2(benchmark::State& state) {
+  const std::string input = UnknownFields(state.range(0));
+  for (auto _ : state) {
+    workloads::Unknowns proto;
+    ABSL_CHECK(proto.ParseFromString(input));
+  }
+  SetWorstCaseCounters(state, input.size());
+}
+BENCHMARK(BM_WorstCase_UnknownFields_Proto2)
+    ->Range(1 << 6, 1 << 16)
+    ->Complexity(benchmark::oN);
+
+static void BM_WorstCase_UnknownFields_Upb(benchmark::State& state) {
+  const std::string input = UnknownFields(state.range(0));
+  for (auto _ : state) {
+    upb_Arena* arena = upb_Arena_New();
+    ABSL_CHECK(upb_benchmark_FileDescriptorProto_parse(input.data(),
+                                                       input.size(), arena));
+    upb_Arena_Free(arena);
+  }
+  SetWorstCaseCounters(state, input.size());
+}
+BENCHMARK(BM_WorstCase_UnknownFields_Upb)
+    ->Range(1 << 6, 1 << 16)
+    ->Complexity(benchmark::oN);
+
+// Merges a message with one unknown field at a time, as a proxy that collects
+// the parts of a message does.  Every merge appends to the same
+// UnknownFieldSet, which must not copy the fields already there.
+static void BM_WorstCase_MergeUnknownFields_Proto2(benchmark::State& state) {
+  const std::string input = UnknownFields(1);
+  std::vector<workloads::Unknowns> parts(state.range(0));
+  for (workloads::Unknowns& part : parts) {
+    ABSL_CHECK(part.ParseFromString(input));
+  }
+  for (auto _ : state) {
+    workloads::Unknowns proto;
+    for (const workloads::Unknowns& part : parts) proto.MergeFrom(part);
+    benchmark::DoNotOptimize(proto);
+  }
+  SetWorstCaseCounters(state, parts.size() * input.size());
+}
+BENCHMARK(BM_WorstCase_MergeUnknownFields_Proto2)
+    ->Range(1 << 6, 1 << 14)
+    ->Complexity(benchmark::oN);
+
+// Entries of a map that all have the same key, of which only the last one is
+// kept.
+static void BM_WorstCase_DuplicateMapKeys_Proto2(benchmark::State& state) {
+  workloads::Maps entry;
+  (*entry.mutable_string_to_int64())["key"] = 1;
+  std::string input;
+  for (int i = 0; i < state.range(0); ++i) {
+    input += entry.SerializeAsString();
+  }
+  for (auto _ : state) {
+    workloads::Maps proto;
+    ABSL_CHECK(proto.ParseFromString(input));
+  }
+  SetWorstCaseCounters(state, input.size());
+}
+BENCHMARK(BM_WorstCase_DuplicateMapKeys_Proto2)
+    ->Range(1 << 6, 1 << 16)
+    ->Complexity(benchmark::oN);
+
+// `count` MessageSet items.  With `kKnown`, they all have the type id of the
+// same extension, and are merged into it.  Otherwise each has its own type id
+// and is kept in the unknown fields.
+template <bool kKnown>
+static std::string MessageSetItems(int count) {
+  using WireFormatLite = protobuf::internal::WireFormatLite;
+  std::string output;
+  {
+    protobuf::io::StringOutputStream stream(&output);
+    protobuf::io::CodedOutputStream coded(&stream);
+    for (int i = 0; i < count; ++i) {
+      workloads::MessageSetItem item;
+      item.set_value(i);
+      const std::string bytes = item.SerializeAsString();
+      coded.WriteTag(WireFormatLite::kMessageSetItemStartTag);
+      coded.WriteTag(WireFormatLite::kMessageSetTypeIdTag);
+      coded.WriteVarint32(
+          kKnown ? workloads::MessageSetItem::kMessageSetExtensionFieldNumber
+                 : 2000 + i);
+      coded.WriteTag(WireFormatLite::kMessageSetMessageTag);
+      coded.WriteVarint32(static_cast<uint32_t>(bytes.size()));
+      coded.WriteString(bytes);
+      coded.WriteTag(WireFormatLite::kMessageSetItemEndTag);
+    }
+  }
+  return output;
+}
+
+template <bool kKnown>
+static void BM_WorstCase_MessageSetItems_Proto2(benchmark::State& state) {
+  const std::string input = MessageSetItems<kKnown>(state.range(0));
+  for (auto _ : state) {
+    workloads::MessageSet proto;
+    ABSL_CHECK(proto.ParseFromString(input));
+  }
+  SetWorstCaseCounters(state, input.size());
+}
+BENCHMARK_TEMPLATE(BM_WorstCase_MessageSetItems_Proto2, true)
+    ->Range(1 << 6, 1 << 16)
+    ->Complexity(benchmark::oN);
+BENCHMARK_TEMPLATE(BM_WorstCase_MessageSetItems_Proto2, false)
+    ->Range(1 << 6, 1 << 16)
+    ->Complexity(benchmark::oN);
+
+// A descriptor whose name is `count` escaped surrogate pairs, which both
+// parsers have to combine and re-encode as UTF-8.
+static std::string JsonEscapedName(int count) {
+  std::string json = "{\"name\": \"";
+  for (int i = 0; i < count; ++i) json += "\\ud83d\\ude00";
+  json += "\"}";
+  return json;
+}
+
+static void BM_WorstCase_JsonEscapes_Proto2(benchmark::State& state) {
+  const std::string json = JsonEscapedName(state.range(0));
+  for (auto _ : state) {
+    protobuf::FileDescriptorProto proto;
+    ABSL_CHECK_OK(protobuf::json::JsonStringToMessage(json, &proto));
+  }
+  SetWorstCaseCounters(state, json.size());
+}
+BENCHMARK(BM_WorstCase_JsonEscapes_Proto2)
+    ->Range(1 << 6, 1 << 16)
+    ->Complexity(benchmark::oN);
+
+static void BM_WorstCase_JsonEscapes_Upb(benchmark::State& state) {
+  const std::string json = JsonEscapedName(state.range(0));
+  upb::DefPool defpool;
+  const upb_MessageDef* md =
+      upb_benchmark_FileDescriptorProto_getmsgdef(defpool.ptr());
+  for (auto _ : state) {
+    upb_Arena* arena = upb_Arena_New();
+    upb_benchmark_FileDescriptorProto* proto =
+        upb_benchmark_FileDescriptorProto_new(arena);
+    ABSL_CHECK(upb_JsonDecode(json.data(), json.size(), UPB_UPCAST(proto), md,
+                              defpool.ptr(), 0, arena, nullptr));
+    upb_Arena_Free(arena);
+  }
+  SetWorstCaseCounters(state, json.size());
+}
+BENCHMARK(BM_WorstCase_JsonEscapes_Upb)
+    ->Range(1 << 6, 1 << 16)
+    ->Complexity(benchmark::oN);
+
+// Thread scaling.  Each benchmark runs the same operation on 1 to 128 threads
+// sharing one object.  With perfect scaling, `per_thread` stays constant as
+// the thread count grows; its ratio to the single-threaded value is the
+// scaling efficiency.
+static void SetThreadScalingCounters(benchmark::State& state,
+                                     int64_t items_per_iteration) {
+  state.SetItemsProcessed(state.iterations() * items_per_iteration);
+  state.counters["per_thread"] =
+      benchmark::Counter(state.iterations() * items_per_iteration,
+                         benchmark::Counter::kAvgThreadsRate);
+}
+
+// The full names of all messages in benchmarks/descriptor.proto.
+static std::vector<std::string> DescriptorProtoMessageNames() {
+  std::vector<std::string> names;
+  std::vector<const protobuf::Descriptor*> pending;
+  const protobuf::FileDescriptor* file = FileDesc::descriptor()->file();
+  for (int i = 0; i < file->message_type_count(); ++i) {
+    pending.push_back(file->message_type(i));
+  }
+  while (!pending.empty()) {
+    const protobuf::Descriptor* descriptor = pending.back();
+    pending.pop_back();
+    names.push_back(std::string(descriptor->full_name()));
+    for (int i = 0; i < descriptor->nested_type_count(); ++i) {
+      pending.push_back(descriptor->nested_type(i));
+    }
+  }
+  return names;
+}
+
+static void BM_DescriptorPoolFind_Threaded(benchmark::State& state) {
+  const std::vector<std::string> names = DescriptorProtoMessageNames();
+  const protobuf::DescriptorPool* pool =
+      protobuf::DescriptorPool::generated_pool();
+  for (auto _ : state) {
+    for (const std::string& name : names) {
+      benchmark::DoNotOptimize(pool->FindMessageTypeByName(name));
+    }
+  }
+  SetThreadScalingCounters(state, names.size());
+}
+BENCHMARK(BM_DescriptorPoolFind_Threaded)->ThreadRange(1, 128)->UseRealTime();
+
+protobuf::DynamicMessageFactory* shared_factory;
+
+static void BM_DynamicMessageFactoryGetPrototype_Threaded(
+    benchmark::State& state) {
+  std::vector<const protobuf::Descriptor*> descriptors;
+  for (const std::string& name : DescriptorProtoMessageNames()) {
+    descriptors.push_back(
+        protobuf::DescriptorPool::generated_pool()->FindMessageTypeByName(
+            name));
+  }
+  if (state.thread_index() == 0) {
+    // Build the prototypes up front, so that only lookups are measured.
+    shared_factory = new protobuf::DynamicMessageFactory;
+    for (const protobuf::Descriptor* descriptor : descriptors) {
+      shared_factory->GetPrototype(descriptor);
+    }
+  }
+  for (auto _ : state) {
+    for (const protobuf::Descriptor* descriptor : descriptors) {
+      benchmark::DoNotOptimize(shared_factory->GetPrototype(descriptor));
+    }
+  }
+  SetThreadScalingCounters(state, descriptors.size());
+  if (state.thread_index() == 0) delete shared_factory;
+}
+BENCHMARK(BM_DynamicMessageFactoryGetPrototype_Threaded)
+    ->ThreadRange(1, 128)
+    ->UseRealTime();
+
+// Every extension is looked up in the global registry through
+// GeneratedExtensionFinder while parsing.
+static void BM_ParseExtensions_Threaded(benchmark::State& state) {
+  const std::string input =
+      WorkloadMessage<ExtensionsWorkload>().SerializeAsString();
+  for (auto _ : state) {
+    workloads::Extendable proto;
+    ABSL_CHECK(proto.ParseFromString(input));
+  }
+  SetThreadScalingCounters(state, 1);
+}
+BENCHMARK(BM_ParseExtensions_Threaded)->ThreadRange(1, 128)->UseRealTime();
+
+protobuf::Arena* shared_parse_arena;
+
+static void BM_ParseIntoSharedArena_Threaded(benchmark::State& state) {
+  if (state.thread_index() == 0) shared_parse_arena = new protobuf::Arena;
+  absl::string_view input(descriptor.data, descriptor.size);
+  for (auto _ : state) {
+    auto* proto = protobuf::Arena::Create<FileDesc>(shared_parse_arena);
+    ABSL_CHECK(proto->ParseFromString(input));
+  }
+  SetThreadScalingCounters(state, 1);
+  state.SetBytesProcessed(state.iterations() * input.size());
+  if (state.thread_index() == 0) delete shared_parse_arena;
+}
+// Bound the iterations, since every parse grows the arena by a few tens of
+// kilobytes.
+BENCHMARK(BM_ParseIntoSharedArena_Threaded)
+    ->Iterations(1 << 6)
+    ->ThreadRange(1, 128)
+    ->UseRealTime();
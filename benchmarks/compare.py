@@ -35,10 +35,12 @@
 This script benchmarks both size and speed. Sample output:
 """
 
+import argparse
 import contextlib
 import json
 import os
 import re
+import statistics
 import subprocess
 import sys
 import tempfile
@@ -58,7 +60,8 @@ def GitWorktree(commit):
 def Run(cmd):
   subprocess.check_call(cmd, shell=True)
 
-def Benchmark(outbase, bench_cpu=True, runs=12, fasttable=False):
+def Benchmark(outbase, bench_cpu=True, runs=12, fasttable=False,
+              benchmark_filter=""):
   tmpfile = "/tmp/bench-output.json"
   Run("rm -rf {}".format(tmpfile))
   #Run("CC=clang bazel test ...")
@@ -69,7 +72,8 @@ def Benchmark(outbase, bench_cpu=True, runs=12, fasttable=False):
 
   if bench_cpu:
     Run("CC=clang bazel build -c opt --copt=-march=native benchmarks:benchmark" + extra_args)
-    Run("./bazel-bin/benchmarks/benchmark --benchmark_out_format=json --benchmark_out={} --benchmark_repetitions={} --benchmark_min_time=0.05 --benchmark_enable_random_interleaving=true".format(tmpfile, runs))
+    Run("./bazel-bin/benchmarks/benchmark --benchmark_out_format=json --benchmark_out={} --benchmark_repetitions={} --benchmark_min_time=0.05 --benchmark_enable_random_interleaving=true --benchmark_filter='{}'".format(tmpfile, runs, benchmark_filter))
+    Run("cp -f {} {}.json".format(tmpfile, outbase))
     with open(tmpfile) as f:
       bench_json = json.load(f)
 
@@ -91,23 +95,56 @@ def Benchmark(outbase, bench_cpu=True, runs=12, fasttable=False):
   Run("cp -f bazel-bin/conformance_upb {}.bin".format(outbase))
 
 
-baseline = "main"
+def MedianCpuTimes(filename):
+  """Returns the median CPU time of each benchmark in a JSON output file."""
+  with open(filename) as f:
+    bench_json = json.load(f)
+  times = {}
+  for run in bench_json["benchmarks"]:
+    if run["run_type"] == "aggregate":
+      continue
+    times.setdefault(run.get("run_name", run["name"]), []).append(
+        run["cpu_time"])
+  return {name: statistics.median(t) for name, t in times.items()}
+
+def Regressions(old_filename, new_filename, max_regression):
+  """Returns the benchmarks that got slower by more than max_regression%."""
+  old = MedianCpuTimes(old_filename)
+  new = MedianCpuTimes(new_filename)
+  regressions = []
+  for name in sorted(old.keys() & new.keys()):
+    change = (new[name] - old[name]) / old[name] * 100
+    if change > max_regression:
+      regressions.append((name, old[name], new[name], change))
+  return regressions
+
+
+parser = argparse.ArgumentParser(description=__doc__)
+parser.add_argument("baseline", nargs="?", default="main",
+                    help="The commit to compare against.")
+parser.add_argument("--benchmark_filter", default="",
+                    help="Only run the benchmarks matching this regex.")
+parser.add_argument("--max_regression", type=float, default=None,
+                    help="Exit with an error if the median CPU time of any "
+                    "benchmark regresses by more than this many percent.")
+args = parser.parse_args()
+
+baseline = args.baseline
 bench_cpu = True
 fasttable = False
 
-if len(sys.argv) > 1:
-  baseline = sys.argv[1]
-
-  # Quickly verify that the baseline exists.
-  with GitWorktree(baseline):
-    pass
+# Quickly verify that the baseline exists.
+with GitWorktree(baseline):
+  pass
 
 # Benchmark our current directory first, since it's more likely to be broken.
-Benchmark("/tmp/new", bench_cpu, fasttable=fasttable)
+Benchmark("/tmp/new", bench_cpu, fasttable=fasttable,
+          benchmark_filter=args.benchmark_filter)
 
 # Benchmark the baseline.
 with GitWorktree(baseline):
-  Benchmark("/tmp/old", bench_cpu, fasttable=fasttable)
+  Benchmark("/tmp/old", bench_cpu, fasttable=fasttable,
+            benchmark_filter=args.benchmark_filter)
 
 print()
 print()
@@ -121,3 +158,14 @@ print()
 Run("objcopy --strip-debug /tmp/old.bin /tmp/old.bin.stripped")
 Run("objcopy --strip-debug /tmp/new.bin /tmp/new.bin.stripped")
 Run("~/code/bloaty/bloaty /tmp/new.bin.stripped -- /tmp/old.bin.stripped --debug-file=/tmp/old.bin --debug-file=/tmp/new.bin -d compileunits,symbols")
+
+if bench_cpu and args.max_regression is not None:
+  regressions = Regressions("/tmp/old.json", "/tmp/new.json",
+                            args.max_regression)
+  print()
+  print()
+  for name, old_time, new_time, change in regressions:
+    print("REGRESSION: {}: {:.1f} -> {:.1f} ns ({:+.1f}%)".format(
+        name, old_time, new_time, change))
+  if regressions:
+    sys.exit(1)
@@ -35,6 +35,9 @@ import re
 
 include = sys.argv[1]
 msg_basename = sys.argv[2]
+# In startup mode the binary also builds the descriptors of the messages in
+# the generated pool, and reports how long that took and the peak RSS.
+startup = len(sys.argv) > 3 and sys.argv[3] == 'startup'
 count = 1
 
 m = re.search(r'(.*\D)(\d+)$', sys.argv[2])
@@ -42,6 +45,15 @@ if m:
   msg_basename = m.group(1)
   count = int(m.group(2))
 
+if startup:
+  print('''
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdio>
+
+#include "google/protobuf/descriptor.h"''')
+
 print('''
 #include "{include}"
 
@@ -64,6 +76,25 @@ RefMessage(msg_basename)
 for i in range(2, count + 1):
   RefMessage(msg_basename + str(i))
 
+if startup:
+  print('''
+  const auto start = std::chrono::steady_clock::now();
+  const google::protobuf::DescriptorPool* pool =
+      google::protobuf::DescriptorPool::generated_pool();''')
+  names = [msg_basename] + [msg_basename + str(i) for i in range(2, count + 1)]
+  for name in names:
+    print('  pool->FindMessageTypeByName("{}");'.format(name.replace('::', '.')))
+  print('''  const auto pool_init = std::chrono::steady_clock::now() - start;
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  // ru_maxrss is in kilobytes on Linux.
+  printf("{\\"pool_init_ns\\": %lld, \\"max_rss_kb\\": %ld}\\n",
+         static_cast<long long>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(pool_init)
+                 .count()),
+         static_cast<long>(usage.ru_maxrss));''')
+
 print('''
   return 0;
 }''')
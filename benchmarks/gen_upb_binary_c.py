@@ -35,6 +35,9 @@ import re
 
 include = sys.argv[1]
 msg_basename = sys.argv[2]
+# In startup mode the binary also reports its peak RSS.  upb has no generated
+# pool to initialize.
+startup = len(sys.argv) > 3 and sys.argv[3] == 'startup'
 count = 1
 
 m = re.search(r'(.*\D)(\d+)$', sys.argv[2])
@@ -42,6 +45,11 @@ if m:
   msg_basename = m.group(1)
   count = int(m.group(2))
 
+if startup:
+  print('''
+#include <stdio.h>
+#include <sys/resource.h>''')
+
 print('''
 #include "{include}"
 
@@ -65,6 +73,13 @@ RefMessage(msg_basename)
 for i in range(2, count + 1):
   RefMessage(msg_basename + str(i))
 
+if startup:
+  print('''
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  /* ru_maxrss is in kilobytes on Linux. */
+  printf("{\\"max_rss_kb\\": %ld}\\n", (long)usage.ru_maxrss);''')
+
 print('''
   return 0;
 }''')
@@ -0,0 +1,206 @@
+#!/usr/bin/python3
+#
+# Protocol Buffers - Google's data interchange format
+# Copyright 2024 Google LLC.  All rights reserved.
+#
+# Use of this source code is governed by a BSD-style
+# license that can be found in the LICENSE file or at
+# https://developers.google.com/open-source/licenses/bsd
+
+"""Tracks the performance of the working directory over time.
+
+For both protobuf and upb, this measures:
+  - parse and serialize throughput, with the benchmark binary;
+  - generated code size per message, for the synthetic protos;
+  - startup time of a binary using the synthetic protos, which includes static
+    initialization;
+  - peak RSS of that binary, after it built the descriptors of the generated
+    pool (protobuf only, upb has no generated pool), and how long building
+    them took.
+
+Every run is appended as one JSON line to a history file and compared with the
+previous line.  With --max_regression, the script exits with an error if any
+metric got worse by more than that many percent, so that CI can run it on
+every change.
+"""
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import time
+
+# The number of messages in each synthetic proto, see gen_synthetic_protos.py.
+SYNTHETIC_PROTOS = {
+    "100_msgs": 100,
+    "200_msgs": 200,
+    "100_fields": 1,
+    "200_fields": 1,
+}
+RUNTIMES = ["upb", "protobuf"]
+BAZEL_BIN = "bazel-bin/benchmarks/"
+
+# Metrics for which larger values are better.  For all others, smaller values
+# are better.
+HIGHER_IS_BETTER_SUFFIXES = ("/bytes_per_second",)
+
+
+def Run(cmd):
+  subprocess.check_call(cmd, shell=True)
+
+
+def Output(cmd):
+  return subprocess.check_output(cmd, shell=True, text=True)
+
+
+def Build(targets):
+  Run("CC=clang bazel build -c opt " +
+      " ".join("benchmarks:" + t for t in targets))
+
+
+def CodeSize(binary):
+  """Returns the size of the code and data of a binary."""
+  # --format=GNU counts rodata with data, not text, like :size_data.
+  lines = Output("size --format=GNU -d " + binary).splitlines()
+  text, data = lines[1].split()[:2]
+  return int(text) + int(data)
+
+
+def CodeSizeMetrics(protos):
+  metrics = {}
+  for runtime in RUNTIMES:
+    empty = CodeSize(BAZEL_BIN + "empty_{}_binary".format(runtime))
+    for proto in protos:
+      size = CodeSize(BAZEL_BIN + "{}_{}_binary".format(proto, runtime))
+      metrics["size/{}/{}/bytes_per_message".format(proto, runtime)] = (
+          (size - empty) / SYNTHETIC_PROTOS[proto])
+  return metrics
+
+
+def StartupMetrics(protos, runs):
+  metrics = {}
+  for runtime in RUNTIMES:
+    for proto in protos:
+      binary = BAZEL_BIN + "{}_{}_startup".format(proto, runtime)
+      wall_ns = []
+      reports = []
+      for _ in range(runs):
+        start = time.perf_counter_ns()
+        out = Output(binary)
+        wall_ns.append(time.perf_counter_ns() - start)
+        reports.append(json.loads(out))
+      prefix = "startup/{}/{}/".format(proto, runtime)
+      metrics[prefix + "wall_ns"] = statistics.median(wall_ns)
+      for key in reports[0]:
+        metrics[prefix + key] = statistics.median(r[key] for r in reports)
+  return metrics
+
+
+def ThroughputMetrics(benchmark_filter, runs):
+  tmpfile = "/tmp/track-bench-output.json"
+  Run("./bazel-bin/benchmarks/benchmark --benchmark_out_format=json "
+      "--benchmark_out={} --benchmark_repetitions={} "
+      "--benchmark_min_time=0.05 --benchmark_enable_random_interleaving=true "
+      "--benchmark_filter='{}'".format(tmpfile, runs, benchmark_filter))
+  with open(tmpfile) as f:
+    bench_json = json.load(f)
+  rates = {}
+  for run in bench_json["benchmarks"]:
+    if run["run_type"] == "aggregate" or "bytes_per_second" not in run:
+      continue
+    rates.setdefault(run.get("run_name", run["name"]), []).append(
+        run["bytes_per_second"])
+  return {"throughput/{}/bytes_per_second".format(name): statistics.median(r)
+          for name, r in rates.items()}
+
+
+def Regressions(old, new, max_regression):
+  """Returns the metrics that got worse by more than max_regression%."""
+  regressions = []
+  for name in sorted(old.keys() & new.keys()):
+    if old[name] == 0:
+      continue
+    change = (new[name] - old[name]) / old[name] * 100
+    worse = -change if name.endswith(HIGHER_IS_BETTER_SUFFIXES) else change
+    if worse > max_regression:
+      regressions.append((name, old[name], new[name], change))
+  return regressions
+
+
+def LastEntry(history):
+  if not os.path.exists(history):
+    return None
+  last = None
+  with open(history) as f:
+    for line in f:
+      if line.strip():
+        last = json.loads(line)
+  return last
+
+
+parser = argparse.ArgumentParser(description=__doc__)
+parser.add_argument("--history", default="benchmarks/history.jsonl",
+                    help="The file the results are appended to.")
+parser.add_argument("--protos", default="100_msgs,200_fields",
+                    help="Comma separated synthetic protos to measure.")
+parser.add_argument("--startup_runs", type=int, default=20,
+                    help="How many times to run each startup binary.")
+parser.add_argument("--benchmark_runs", type=int, default=5,
+                    help="Repetitions of each throughput benchmark.")
+parser.add_argument("--benchmark_filter", default="BM_Parse_|BM_Serialize",
+                    help="The throughput benchmarks to run, as a regex.")
+parser.add_argument("--max_regression", type=float, default=None,
+                    help="Exit with an error if any metric got worse by more "
+                    "than this many percent since the last entry.")
+args = parser.parse_args()
+
+protos = args.protos.split(",")
+for proto in protos:
+  if proto not in SYNTHETIC_PROTOS:
+    sys.exit("Unknown synthetic proto: " + proto)
+
+targets = ["benchmark"]
+for runtime in RUNTIMES:
+  targets.append("empty_{}_binary".format(runtime))
+  for proto in protos:
+    targets.append("{}_{}_binary".format(proto, runtime))
+    targets.append("{}_{}_startup".format(proto, runtime))
+Build(targets)
+
+metrics = {}
+metrics.update(CodeSizeMetrics(protos))
+metrics.update(StartupMetrics(protos, args.startup_runs))
+metrics.update(ThroughputMetrics(args.benchmark_filter, args.benchmark_runs))
+
+previous = LastEntry(args.history)
+entry = {
+    "commit": Output("git rev-parse HEAD").strip(),
+    "dirty": bool(Output("git status --porcelain --untracked-files=no")),
+    "timestamp": int(time.time()),
+    "metrics": metrics,
+}
+with open(args.history, "a") as f:
+  f.write(json.dumps(entry, sort_keys=True) + "\n")
+
+old = previous["metrics"] if previous else {}
+print()
+print("{:<64} {:>16} {:>16} {:>8}".format("metric", "previous", "current",
+                                          "change"))
+for name in sorted(metrics):
+  if name in old and old[name] != 0:
+    change = "{:+.1f}%".format((metrics[name] - old[name]) / old[name] * 100)
+    print("{:<64} {:>16.1f} {:>16.1f} {:>8}".format(name, old[name],
+                                                    metrics[name], change))
+  else:
+    print("{:<64} {:>16} {:>16.1f} {:>8}".format(name, "-", metrics[name], ""))
+
+if previous and args.max_regression is not None:
+  regressions = Regressions(old, metrics, args.max_regression)
+  print()
+  for name, old_value, new_value, change in regressions:
+    print("REGRESSION: {}: {:.1f} -> {:.1f} ({:+.1f}%) since {}".format(
+        name, old_value, new_value, change, previous["commit"][:12]))
+  if regressions:
+    sys.exit(1)
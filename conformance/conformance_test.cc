@@ -25,9 +25,12 @@
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "conformance/conformance.pb.h"
 #include "failure_list_trie_node.h"
 #include "google/protobuf/descriptor_legacy.h"
@@ -177,6 +180,30 @@ bool CheckSetEmpty(const absl::btree_map<std::string, TestStatus>& set_to_check,
   return false;
 }
 
+
+// Returns the payload of `request`, and the name of its format.
+static std::pair<absl::string_view, absl::string_view> RequestPayload(
+    const ConformanceRequest& request) {
+  switch (request.payload_case()) {
+    case ConformanceRequest::kProtobufPayload:
+      return {"PROTOBUF", request.protobuf_payload()};
+    case ConformanceRequest::kJsonPayload:
+      return {"JSON", request.json_payload()};
+    case ConformanceRequest::kJspbPayload:
+      return {"JSPB", request.jspb_payload()};
+    case ConformanceRequest::kTextPayload:
+      return {"TEXT_FORMAT", request.text_payload()};
+    default:
+      return {"UNSPECIFIED", ""};
+  }
+}
+
+static absl::string_view MessageSyntax(const ConformanceRequest& request) {
+  const absl::string_view type = request.message_type();
+  if (absl::StrContains(type, ".editions.")) return "Editions";
+  if (absl::StrContains(type, ".proto2.")) return "Proto2";
+  return "Proto3";
+}
 }  // namespace
 
 namespace google {
@@ -610,9 +637,36 @@ bool ConformanceTestSuite::RunTest(const std::string& test_name,
         test_name, TruncateRequest(request).ShortDebugString(),
         TruncateResponse(*response).ShortDebugString());
   }
+
+  // Replaying requests that crash or hang the testee would only measure how
+  // long it takes to restart it.
+  if (throughput_iterations_ > 0 &&
+      response->result_case() != ConformanceResponse::kRuntimeError &&
+      response->result_case() != ConformanceResponse::kTimeoutError) {
+    MeasureThroughput(test_name, request, len, serialized_request);
+  }
   return true;
 }
 
+void ConformanceTestSuite::MeasureThroughput(
+    const std::string& test_name, const ConformanceRequest& request,
+    uint32_t len, const std::string& serialized_request) {
+  std::string serialized_response;
+  const absl::Time start = absl::Now();
+  for (int i = 0; i < throughput_iterations_; ++i) {
+    runner_->RunTest(test_name, len, serialized_request, &serialized_response);
+  }
+  const absl::Duration time = absl::Now() - start;
+
+  const auto [input_format, payload] = RequestPayload(request);
+  ThroughputStats& stats = throughput_stats_[absl::StrCat(
+      input_format, "->", WireFormatToString(request.requested_output_format()),
+      " ", MessageSyntax(request))];
+  stats.requests += throughput_iterations_;
+  stats.bytes += static_cast<int64_t>(payload.size()) * throughput_iterations_;
+  stats.time += time;
+}
+
 std::string ConformanceTestSuite::WireFormatToString(WireFormat wire_format) {
   switch (wire_format) {
     case conformance::PROTOBUF:
@@ -656,6 +710,7 @@ bool ConformanceTestSuite::RunSuite(ConformanceTestRunner* runner,
   test_names_ran_.clear();
   unexpected_failing_tests_.clear();
   unexpected_succeeding_tests_.clear();
+  throughput_stats_.clear();
 
   std::string mode = debug_ ? "DEBUG" : "TEST";
   absl::StrAppendFormat(
@@ -776,6 +831,24 @@ bool ConformanceTestSuite::RunSuite(ConformanceTestRunner* runner,
                   output_dir_, &output_);
   }
 
+  if (throughput_iterations_ > 0) {
+    // The time includes the round trip through the pipe to the testee, which
+    // is the same for all testees.
+    absl::StrAppendFormat(&output_,
+                          "CONFORMANCE THROUGHPUT (%d replays of each test):\n",
+                          throughput_iterations_);
+    absl::StrAppendFormat(&output_, "  %-32s %10s %12s %10s\n", "category",
+                          "requests", "ns/request", "MB/s");
+    for (const auto& [category, stats] : throughput_stats_) {
+      const double seconds = absl::ToDoubleSeconds(stats.time);
+      absl::StrAppendFormat(
+          &output_, "  %-32s %10d %12.0f %10.2f\n", category, stats.requests,
+          absl::ToDoubleNanoseconds(stats.time) / stats.requests,
+          seconds > 0 ? stats.bytes / seconds / 1e6 : 0.0);
+    }
+    absl::StrAppendFormat(&output_, "\n");
+  }
+
   absl::StrAppendFormat(&output_,
                         "CONFORMANCE SUITE %s: %d successes, %zu skipped, "
                         "%d expected failures, %zu unexpected failures.\n",
@@ -25,6 +25,7 @@
 #include "absl/container/btree_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "conformance/conformance.pb.h"
+#include "absl/time/time.h"
 #include "failure_list_trie_node.h"
 #include "google/protobuf/descriptor.h"
 
@@ -168,6 +169,13 @@ class ConformanceTestSuite {
   // Sets the file path of the testee.
   void SetTestee(const std::string& testee) { testee_ = testee; }
 
+  // Sets how many times each test request is sent again to the testee, after
+  // the run that checks its response, to measure throughput.  The timings are
+  // reported per category at the end of the suite.  Zero disables this.
+  void SetThroughputIterations(int iterations) {
+    throughput_iterations_ = iterations;
+  }
+
   // Sets the names of tests to ONLY be run isolated from all the others.
   void SetNamesToTest(absl::flat_hash_set<std::string> names_to_test) {
     names_to_test_ = std::move(names_to_test);
@@ -298,6 +306,12 @@ class ConformanceTestSuite {
   // wildcards; otherwise, returns true.
   bool AddExpectedFailedTest(const conformance::TestStatus& failure);
 
+  // Sends `serialized_request` to the testee throughput_iterations_ times and
+  // accounts the time taken to the category of `request`.
+  void MeasureThroughput(const std::string& test_name,
+                         const conformance::ConformanceRequest& request,
+                         uint32_t len, const std::string& serialized_request);
+
   virtual void RunSuiteImpl() = 0;
 
   ConformanceTestRunner* runner_;
@@ -318,6 +332,7 @@ class ConformanceTestSuite {
   // If names were given for names_to_test_, only those tests
   // will be run and this bool will be set to true.
   bool isolated_ = false;
+  int throughput_iterations_ = 0;
 
   // The set of test names (expanded from wildcard(s) and non-expanded) that are
   // expected to fail in this run, but haven't failed yet.
@@ -365,6 +380,15 @@ class ConformanceTestSuite {
 
   // Keeps track of how many tests matched to each failure list entry.
   absl::btree_map<std::string, int> number_of_matches_;
+
+  struct ThroughputStats {
+    int64_t requests = 0;
+    int64_t bytes = 0;
+    absl::Duration time;
+  };
+  // Throughput measurements, keyed by input format, output format and syntax
+  // of the test message, e.g. "JSON->PROTOBUF Proto3".
+  absl::btree_map<std::string, ThroughputStats> throughput_stats_;
 };
 
 }  // namespace protobuf
@@ -52,6 +52,7 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_log.h"
 #include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "conformance/conformance.pb.h"
@@ -168,6 +169,11 @@ void UsageError() {
   fprintf(stderr, "  --performance               Boolean option\n");
   fprintf(stderr, "                              for enabling run of\n");
   fprintf(stderr, "                              performance tests.\n");
+  fprintf(stderr,
+          "  --throughput <iterations>   Replay each test request\n"
+          "                              <iterations> more times and\n"
+          "                              report timings per format and\n"
+          "                              syntax.\n");
   exit(1);
 }
 
@@ -236,6 +242,7 @@ int ForkPipeRunner::Run(int argc, char *argv[],
   std::string output_dir;
   bool verbose = false;
   bool isolated = false;
+  int throughput_iterations = 0;
 
   for (int arg = 1; arg < argc; ++arg) {
     if (strcmp(argv[arg], "--performance") == 0) {
@@ -254,6 +261,13 @@ int ForkPipeRunner::Run(int argc, char *argv[],
         UsageError();
       }
       maximum_edition = edition;
+    } else if (strcmp(argv[arg], "--throughput") == 0) {
+      if (++arg == argc) UsageError();
+      if (!absl::SimpleAtoi(argv[arg], &throughput_iterations) ||
+          throughput_iterations < 0) {
+        fprintf(stderr, "Invalid throughput iterations: %s\n", argv[arg]);
+        UsageError();
+      }
     } else if (strcmp(argv[arg], "--output_dir") == 0) {
       if (++arg == argc) UsageError();
       output_dir = argv[arg];
@@ -311,6 +325,7 @@ int ForkPipeRunner::Run(int argc, char *argv[],
     suite->SetNamesToTest(names_to_test);
     suite->SetTestee(program);
     suite->SetIsolated(isolated);
+    suite->SetThroughputIterations(throughput_iterations);
 
     ForkPipeRunner runner(program, program_args, performance);
 
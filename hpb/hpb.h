@@ -21,6 +21,7 @@
 #include "google/protobuf/hpb/internal/template_help.h"
 #include "google/protobuf/hpb/ptr.h"
 #include "google/protobuf/hpb/status.h"
+#include "upb/message/internal/message.h"
 #include "upb/wire/decode.h"
 
 #ifdef HPB_BACKEND_UPB
@@ -35,9 +36,11 @@ namespace hpb {
 namespace backend = ::hpb::internal::backend::upb;
 #endif
 
+// T::minitable() is a constant known to the compiler, so the inline
+// _upb_Message_New() reduces to a bump allocation of a fixed size and a memset.
 template <typename T>
 typename T::Proxy CreateMessage(hpb::Arena& arena) {
-  return typename T::Proxy(upb_Message_New(T::minitable(), arena.ptr()),
+  return typename T::Proxy(_upb_Message_New(T::minitable(), arena.ptr()),
                            arena.ptr());
 }
 
@@ -12,6 +12,7 @@
 #include <utility>
 
 #include "upb/mem/arena.h"
+#include "upb/message/internal/message.h"
 #include "upb/message/message.h"
 
 namespace hpb::internal {
@@ -35,7 +36,7 @@ struct PrivateAccess {
   }
   template <typename T>
   static auto CreateMessage(upb_Arena* arena) {
-    return typename T::Proxy(upb_Message_New(T::minitable(), arena), arena);
+    return typename T::Proxy(_upb_Message_New(T::minitable(), arena), arena);
   }
 
   template <typename T, typename... Args>
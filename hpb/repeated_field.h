@@ -11,10 +11,12 @@
 #include <assert.h>
 
 #include <cstddef>
+#include <cstring>
 #include <iterator>
 #include <type_traits>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "google/protobuf/hpb/backend/upb/interop.h"
 #include "google/protobuf/hpb/internal/template_help.h"
 #include "google/protobuf/hpb/repeated_field_iterator.h"
@@ -240,6 +242,44 @@ class RepeatedFieldScalarProxy
     upb_Array_Append(this->arr_, message_value, this->arena_);
   }
 
+  // Returns the elements, which are contiguous in memory. Only valid until the
+  // field is next modified.
+  absl::Span<const value_type> span() const {
+    if (this->arr_ == nullptr) return {};
+    return absl::Span<const value_type>(unsafe_array(), this->size());
+  }
+
+  // Replaces the elements with `values`, with one resize and one copy.
+  // Returns false on allocation failure.
+  template <int&... DeductionBlocker, bool b = !kIsConst,
+            typename = std::enable_if_t<b>>
+  bool assign(absl::Span<const value_type> values) {
+    if (!upb_Array_Resize(this->arr_, values.size(), this->arena_)) {
+      return false;
+    }
+    if (!values.empty()) {
+      memcpy(unsafe_array(), values.data(), values.size() * sizeof(T));
+    }
+    return true;
+  }
+
+  // Appends `values`, with one resize and one copy.
+  // Returns false on allocation failure.
+  template <int&... DeductionBlocker, bool b = !kIsConst,
+            typename = std::enable_if_t<b>>
+  bool append(absl::Span<const value_type> values) {
+    const size_t old_size = this->size();
+    if (!upb_Array_Resize(this->arr_, old_size + values.size(),
+                          this->arena_)) {
+      return false;
+    }
+    if (!values.empty()) {
+      memcpy(unsafe_array() + old_size, values.data(),
+             values.size() * sizeof(T));
+    }
+    return true;
+  }
+
   iterator begin() const { return iterator({unsafe_array()}); }
   iterator cbegin() const { return begin(); }
   iterator end() const { return iterator({unsafe_array() + this->size()}); }
@@ -101,11 +101,18 @@ void WriteFieldAccessorsInHeader(const protobuf::Descriptor* desc,
     } else {
       // non-repeated.
       if (field->cpp_type() == protobuf::FieldDescriptor::CPPTYPE_STRING) {
-        ctx.EmitLegacy(R"cc(
-                         $0 $1() const;
-                         void set_$1($0 value);
-                       )cc",
-                       CppConstType(field), resolved_field_name);
+        // The getter is inline, like the scalar ones, so that it reduces
+        // to a load at a constant offset.
+        ctx.EmitLegacy(
+            R"cc(
+              inline $0 $1() const {
+                return hpb::interop::upb::FromUpbStringView($2_$3(msg_));
+              }
+              void set_$1($0 value);
+            )cc",
+            CppConstType(field), resolved_field_name,
+            upb::generator::CApiMessageType(desc->full_name()),
+            resolved_upbc_name);
       } else if (field->cpp_type() ==
                  protobuf::FieldDescriptor::CPPTYPE_MESSAGE) {
         ctx.EmitLegacy(R"cc(
@@ -238,15 +245,6 @@ void WriteAccessorsInSource(const protobuf::Descriptor* desc, Context& ctx) {
     } else {
       // non-repeated field.
       if (field->cpp_type() == protobuf::FieldDescriptor::CPPTYPE_STRING) {
-        ctx.EmitLegacy(
-            R"cc(
-              $1 $0::$2() const {
-                return hpb::interop::upb::FromUpbStringView($3_$4(msg_));
-              }
-            )cc",
-            class_name, CppConstType(field), resolved_field_name,
-            upb::generator::CApiMessageType(desc->full_name()),
-            resolved_upbc_name);
         // Set string.
         ctx.EmitLegacy(
             R"cc(
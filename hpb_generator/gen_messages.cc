@@ -242,6 +242,9 @@ void WriteModelPublicDeclaration(
     // for typetrait checking
     ctx.EmitLegacy("using ExtendableType = $0;\n", ClassName(descriptor));
   }
+  // Defined inline so that the minitable is a compile time constant of the
+  // hot paths using it, like ::hpb::CreateMessage.
+  //
   // Note: free function friends that are templates such as ::hpb::Parse
   // require explicit <$2> type parameter in declaration to be able to compile
   // with gcc otherwise the compiler will fail with
@@ -249,9 +252,9 @@ void WriteModelPublicDeclaration(
   // namespace qualifier, cross namespace matching fails.
   ctx.EmitLegacy(
       R"cc(
-        static const upb_MiniTable* minitable();
+        static const upb_MiniTable* minitable() { return &$0; }
       )cc",
-      ClassName(descriptor));
+      ::upb::generator::MiniTableMessageVarName(descriptor->full_name()));
   ctx.Emit("\n");
   WriteConstFieldNumbers(ctx, descriptor);
   ctx.EmitLegacy(
@@ -443,14 +446,6 @@ void WriteMessageImplementation(
         ::upb::generator::MiniTableMessageVarName(descriptor->full_name()),
         QualifiedClassName(descriptor));
     ctx.Emit("\n");
-    // Minitable
-    ctx.EmitLegacy(
-        R"cc(
-          const upb_MiniTable* $0::minitable() { return &$1; }
-        )cc",
-        ClassName(descriptor),
-        ::upb::generator::MiniTableMessageVarName(descriptor->full_name()));
-    ctx.Emit("\n");
   }
 
   WriteAccessorsInSource(descriptor, ctx);
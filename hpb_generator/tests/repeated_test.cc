@@ -116,6 +116,25 @@ TEST(CppGeneratedCode, RepeatedFieldProxyForScalars) {
               ElementsAre(27, 16, 5));
 }
 
+TEST(CppGeneratedCode, RepeatedFieldSpanForScalars) {
+  ::hpb::Arena arena;
+  auto test_model = ::hpb::CreateMessage<TestModel>(arena);
+  EXPECT_TRUE(test_model.value_array().span().empty());
+
+  const int32_t values[] = {5, 16, 27};
+  ASSERT_TRUE(test_model.mutable_value_array()->assign(values));
+  EXPECT_THAT(test_model.value_array().span(), ElementsAre(5, 16, 27));
+
+  ASSERT_TRUE(test_model.mutable_value_array()->append(values));
+  EXPECT_THAT(test_model.value_array().span(),
+              ElementsAre(5, 16, 27, 5, 16, 27));
+
+  ASSERT_TRUE(test_model.mutable_value_array()->assign({7}));
+  EXPECT_THAT(test_model.mutable_value_array()->span(), ElementsAre(7));
+  ASSERT_TRUE(test_model.mutable_value_array()->assign({}));
+  EXPECT_EQ(0, test_model.value_array_size());
+}
+
 TEST(CppGeneratedCode, RepeatedScalarIterator) {
   ::hpb::Arena arena;
   auto test_model = ::hpb::CreateMessage<TestModel>(arena);
@@ -997,9 +997,20 @@ PHP_METHOD(DescriptorPool, internalAddGeneratedFile) {
     return;
   }
 
+  // Every request of a worker loads the same generated files again. Skip the
+  // ones that the persistent generated pool already has.
+  bool generated = intern->symtab == get_global_symtab();
+  if (generated && GeneratedFiles_Contains(data, data_len)) {
+    return;
+  }
+
   arena = upb_Arena_New();
   add_descriptor_set(intern->symtab, data, data_len, arena);
   upb_Arena_Free(arena);
+
+  if (generated) {
+    GeneratedFiles_Add(data, data_len);
+  }
 }
 
 // clang-format off
@@ -50,6 +50,11 @@ ZEND_BEGIN_MODULE_GLOBALS(protobuf)
   HashTable name_msg_cache;
   HashTable name_enum_cache;
 
+  // The serialized descriptor sets that have been added to global_symtab, so
+  // that generated code loading them again in a later request can skip parsing
+  // them (see interface in protobuf.h).  Lives as long as global_symtab.
+  HashTable generated_files;
+
   // An array of descriptor objects constructed during this request. These are
   // logically referenced by the corresponding class entry, but since we can't
   // actually write a class entry destructor, we reference them here, to be
@@ -61,6 +66,7 @@ ZEND_END_MODULE_GLOBALS(protobuf)
 void free_protobuf_globals(zend_protobuf_globals* globals) {
   zend_hash_destroy(&globals->name_msg_cache);
   zend_hash_destroy(&globals->name_enum_cache);
+  zend_hash_destroy(&globals->generated_files);
   upb_DefPool_Free(globals->global_symtab);
   globals->global_symtab = NULL;
 }
@@ -148,6 +154,7 @@ static PHP_RINIT_FUNCTION(protobuf) {
     PROTOBUF_G(global_symtab) = upb_DefPool_New();
     zend_hash_init(&PROTOBUF_G(name_msg_cache), 64, NULL, NULL, persistent);
     zend_hash_init(&PROTOBUF_G(name_enum_cache), 64, NULL, NULL, persistent);
+    zend_hash_init(&PROTOBUF_G(generated_files), 64, NULL, NULL, persistent);
   }
 
   zend_hash_init(&PROTOBUF_G(object_cache), 64, NULL, NULL, 0);
@@ -213,6 +220,18 @@ bool ObjCache_Get(const void* upb_obj, zval* val) {
   }
 }
 
+// -----------------------------------------------------------------------------
+// Generated files.
+// -----------------------------------------------------------------------------
+
+bool GeneratedFiles_Contains(const char* data, size_t size) {
+  return zend_hash_str_exists(&PROTOBUF_G(generated_files), data, size);
+}
+
+void GeneratedFiles_Add(const char* data, size_t size) {
+  zend_hash_str_add_empty_element(&PROTOBUF_G(generated_files), data, size);
+}
+
 // -----------------------------------------------------------------------------
 // Name Cache.
 // -----------------------------------------------------------------------------
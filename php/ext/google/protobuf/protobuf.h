@@ -63,6 +63,13 @@ const upb_EnumDef* NameMap_GetEnum(zend_class_entry* ce);
 void NameMap_EnterConstructor(zend_class_entry* ce);
 void NameMap_ExitConstructor(zend_class_entry* ce);
 
+// Serialized descriptor sets already added to the generated pool. When
+// protobuf.keep_descriptor_pool_after_request is set, the pool and this set
+// persist across requests, so each generated file is parsed once per process
+// instead of once per request.
+bool GeneratedFiles_Contains(const char* data, size_t size);
+void GeneratedFiles_Add(const char* data, size_t size);
+
 // Add this descriptor object to the global list of descriptors that will be
 // kept alive for the duration of the request but destroyed when the request
 // is ending.
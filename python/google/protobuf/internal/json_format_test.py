@@ -1644,6 +1644,51 @@ class JsonFormatTest(JsonFormatBase):
     expected = {'int32Value': 12345}
     self.assertEqual(expected, json_format.MessageToDict(message))
 
+  def testMessageToDictMatchesPrinter(self):
+    # MessageToDict() can take a native path, which must agree with the
+    # printer for every kind of field.
+    # pylint: disable=protected-access
+    def PrinterDict(message, **kwargs):
+      printer = json_format._Printer(**kwargs)
+      return printer._MessageToJsonObject(message)
+
+    message = json_format_proto3_pb2.TestMessage()
+    self.FillAllFields(message)
+    message.repeated_float_value.append(0.9)
+    for kwargs in (
+        {},
+        {'preserving_proto_field_name': True},
+        {'use_integers_for_enums': True},
+    ):
+      self.assertEqual(
+          PrinterDict(message, **kwargs),
+          json_format.MessageToDict(message, **kwargs),
+      )
+
+    message = json_format_proto3_pb2.TestMap()
+    message.bool_map[True] = 1
+    message.int64_map[-5] = 2
+    message.uint64_map[7] = 3
+    message.string_map['key'] = 4
+    self.assertEqual(PrinterDict(message), json_format.MessageToDict(message))
+
+    message = json_format_proto3_pb2.TestWrapper()
+    message.bool_value.value = False
+    message.int64_value.value = 4
+    message.float_value.value = 0.1
+    message.bytes_value.value = b'\x00\xff'
+    self.assertEqual(PrinterDict(message), json_format.MessageToDict(message))
+
+    message = json_format_proto3_pb2.TestTimestamp()
+    message.value.seconds = 1
+    message.repeated_value.add().nanos = 10
+    self.assertEqual(PrinterDict(message), json_format.MessageToDict(message))
+
+    message = unittest_pb2.TestAllExtensions()
+    message.Extensions[unittest_pb2.optional_int32_extension] = 5
+    message.Extensions[unittest_pb2.repeated_string_extension].append('a')
+    self.assertEqual(PrinterDict(message), json_format.MessageToDict(message))
+
   def testJsonName(self):
     message = json_format_proto3_pb2.TestCustomJsonName()
     message.value = 12345
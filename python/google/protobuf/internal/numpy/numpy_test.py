@@ -11,6 +11,7 @@ import unittest
 
 import numpy as np
 
+from google.protobuf.internal import api_implementation
 from google.protobuf.internal import testing_refleaks
 from google.protobuf import unittest_pb2
 
@@ -188,5 +189,73 @@ class NumpyProtoIndexingTest(unittest.TestCase):
                                          buffer=np.array([0]),
                                          dtype=int)]
 
+@unittest.skipIf(api_implementation.Type() != 'upb',
+                 'buffer protocol of the upb implementation')
+@testing_refleaks.TestCase
+class NumpyBufferTest(unittest.TestCase):
+
+  def setUp(self):
+    super().setUp()
+    try:
+      memoryview(unittest_pb2.TestAllTypes().repeated_int32)
+    except TypeError:
+      self.skipTest('built with a limited API without the buffer protocol')
+
+  # np.frombuffer() aliases the storage of the field
+  def testFromBufferAliasesRepeated(self):
+    data = unittest_pb2.TestAllTypes(repeated_float=[1.0, 2.0, 3.0])
+    array = np.frombuffer(data.repeated_float, dtype=np.float32)
+    self.assertEqual([1.0, 2.0, 3.0], array.tolist())
+    array[0] = 5.0
+    self.assertEqual(5.0, data.repeated_float[0])
+
+  def testMemoryviewFormat(self):
+    data = unittest_pb2.TestAllTypes(repeated_int64=[1, -2],
+                                     repeated_uint32=[3])
+    view = memoryview(data.repeated_int64)
+    self.assertEqual('q', view.format)
+    self.assertEqual(8, view.itemsize)
+    self.assertEqual((2,), view.shape)
+    self.assertEqual([1, -2], view.tolist())
+    self.assertEqual([3], memoryview(data.repeated_uint32).tolist())
+
+  def testEmptyRepeatedToBuffer(self):
+    data = unittest_pb2.TestAllTypes()
+    self.assertEqual([], memoryview(data.repeated_double).tolist())
+
+  # Bools and enums are not exported
+  def testBoolAndEnumRepeatedToBuffer_RaisesBufferError(self):
+    data = unittest_pb2.TestAllTypes()
+    with self.assertRaises(BufferError):
+      memoryview(data.repeated_bool)
+    with self.assertRaises(BufferError):
+      memoryview(data.repeated_nested_enum)
+
+  # Extending from an ndarray of the same type copies it in bulk
+  def testExtendFromSameTypeArray(self):
+    data = unittest_pb2.TestAllTypes(repeated_double=[-1.0])
+    data.repeated_double.extend(np.arange(4, dtype=np.float64))
+    self.assertEqual([-1.0, 0.0, 1.0, 2.0, 3.0], data.repeated_double)
+    data.repeated_int32.extend(np.array([1, -1], dtype=np.int32))
+    self.assertEqual([1, -1], data.repeated_int32)
+
+  # Extending from an ndarray of another type still converts every element
+  def testExtendFromOtherTypeArray(self):
+    data = unittest_pb2.TestAllTypes()
+    data.repeated_int32.extend(np.arange(3, dtype=np.int64))
+    self.assertEqual([0, 1, 2], data.repeated_int32)
+    data.repeated_float.extend(np.array([0.5], dtype=np.float64))
+    self.assertEqual([0.5], data.repeated_float)
+    with self.assertRaises(TypeError):
+      data.repeated_int64.extend(np_2_float_array)
+    with self.assertRaises(TypeError):
+      data.repeated_int64.extend(np_22_int_array)
+
+  def testExtendFromOwnBuffer(self):
+    data = unittest_pb2.TestAllTypes(repeated_int32=[1, 2])
+    data.repeated_int32.extend(data.repeated_int32)
+    self.assertEqual([1, 2, 1, 2], data.repeated_int32)
+
+
 if __name__ == '__main__':
   unittest.main()
@@ -11,6 +11,7 @@
 import io
 import unittest
 
+from google.protobuf import message
 from google.protobuf import proto
 from google.protobuf.internal import encoder
 from google.protobuf.internal import test_proto2_pb2
@@ -18,6 +19,7 @@ from google.protobuf.internal import test_util
 from google.protobuf.internal import testing_refleaks
 
 from absl.testing import parameterized
+from google.protobuf import map_unittest_pb2
 from google.protobuf import unittest_pb2
 from google.protobuf import unittest_proto3_arena_pb2
 
@@ -77,6 +79,65 @@ class ProtoTest(unittest.TestCase):
         str(context.exception),
     )
 
+  def test_parse_many(self, message_module):
+    msgs = [message_module.TestAllTypes(optional_int32=i) for i in range(3)]
+    test_util.SetAllFields(msgs[1])
+    parsed = proto.parse_many(
+        message_module.TestAllTypes, [proto.serialize(msg) for msg in msgs]
+    )
+    self.assertEqual(msgs, parsed)
+    self.assertEqual([], proto.parse_many(message_module.TestAllTypes, []))
+
+  def test_parse_many_invalid(self, message_module):
+    with self.assertRaises(message.DecodeError):
+      proto.parse_many(message_module.TestAllTypes, [b'', b'\xff'])
+
+  def test_parse_length_prefixed_many(self, message_module):
+    msgs = [message_module.TestAllTypes(optional_int32=i) for i in range(3)]
+    test_util.SetAllFields(msgs[2])
+    out = io.BytesIO()
+    for msg in msgs:
+      proto.serialize_length_prefixed(msg, out)
+    parsed = proto.parse_length_prefixed_many(
+        message_module.TestAllTypes, out.getvalue()
+    )
+    self.assertEqual(msgs, parsed)
+
+  def test_parse_length_prefixed_many_truncated(self, message_module):
+    out = io.BytesIO()
+    proto.serialize_length_prefixed(
+        message_module.TestAllTypes(optional_int32=1), out
+    )
+    encoder._VarintEncoder()(out.write, 9999)
+    with self.assertRaises(ValueError):
+      proto.parse_length_prefixed_many(
+          message_module.TestAllTypes, out.getvalue()
+      )
+
+  def test_to_dict(self, message_module):
+    msg = message_module.TestAllTypes(
+        optional_int32=1,
+        optional_bytes=b'\x00',
+        optional_nested_message={'bb': 2},
+        optional_nested_enum=message_module.TestAllTypes.BAR,
+        repeated_string=['a', 'b'],
+    )
+    msg.repeated_nested_message.add(bb=3)
+    msg.repeated_nested_message.add()
+    self.assertEqual(
+        {
+            'optional_int32': 1,
+            'optional_bytes': b'\x00',
+            'optional_nested_message': {'bb': 2},
+            'optional_nested_enum': message_module.TestAllTypes.BAR,
+            'repeated_string': ['a', 'b'],
+            'repeated_nested_message': [{'bb': 3}, {}],
+        },
+        proto.to_dict(msg),
+    )
+    self.assertEqual({}, proto.to_dict(message_module.TestAllTypes()))
+    self.assertEqual({}, proto.to_dict(msg.optional_foreign_message))
+
   def test_byte_size(self, message_module):
     msg = message_module.TestAllTypes()
     self.assertEqual(0, proto.byte_size(msg))
@@ -99,6 +160,35 @@ class ProtoTest(unittest.TestCase):
     self.assertEqual(0, msg.optional_int32)
 
 
+@testing_refleaks.TestCase
+class ToDictTest(unittest.TestCase):
+
+  def test_maps(self):
+    msg = map_unittest_pb2.TestMap()
+    msg.map_int32_int32[1] = 2
+    msg.map_int32_foreign_message[3].c = 4
+    msg.map_int32_foreign_message[5].SetInParent()
+    self.assertEqual(
+        {
+            'map_int32_int32': {1: 2},
+            'map_int32_foreign_message': {3: {'c': 4}, 5: {}},
+        },
+        proto.to_dict(msg),
+    )
+
+  def test_extensions(self):
+    msg = unittest_pb2.TestAllExtensions()
+    msg.Extensions[unittest_pb2.optional_int32_extension] = 1
+    msg.Extensions[unittest_pb2.repeated_string_extension].append('a')
+    self.assertEqual(
+        {
+            '[protobuf_unittest.optional_int32_extension]': 1,
+            '[protobuf_unittest.repeated_string_extension]': ['a'],
+        },
+        proto.to_dict(msg),
+    )
+
+
 class SelfFieldTest(unittest.TestCase):
 
   def test_pytype_allows_unset_self_field(self):
@@ -159,6 +159,19 @@ def MessageToDict(
       always_print_fields_with_no_presence,
   )
   # pylint: disable=protected-access
+  if (
+      not always_print_fields_with_no_presence
+      and float_precision is None
+      and hasattr(message, '_ToJsonDict')
+  ):
+    # The upb extension walks the message natively, and only calls back into
+    # the printer for the well-known types with special JSON representations.
+    return message._ToJsonDict(
+        preserving_proto_field_name,
+        use_integers_for_enums,
+        printer._MessageToJsonObject,
+        SerializeToJsonError,
+    )
   return printer._MessageToJsonObject(message)
 
 
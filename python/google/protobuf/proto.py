@@ -8,8 +8,9 @@
 """Contains the Nextgen Pythonic protobuf APIs."""
 
 import io
-from typing import Text, Type, TypeVar
+from typing import Any, Dict, List, Sequence, Text, Type, TypeVar
 
+from google.protobuf.descriptor import FieldDescriptor
 from google.protobuf.internal import decoder
 from google.protobuf.internal import encoder
 from google.protobuf.message import Message
@@ -116,6 +117,96 @@ def parse_length_prefixed(
   return message
 
 
+def parse_many(
+    message_class: Type[_MESSAGE], payloads: Sequence[bytes]
+) -> List[_MESSAGE]:
+  """Deserializes each of the payloads into a new Message.
+
+  With the upb implementation, all of the messages are parsed into one arena
+  without holding the GIL, so that threads parsing other batches run in
+  parallel.
+
+  Args:
+    message_class: The message meta class.
+    payloads: Serialized bytes in binary form.
+
+  Returns:
+    A list of the new messages, in the order of payloads.
+
+  Raises:
+    DecodeError: if any of the payloads cannot be parsed.
+  """
+  if hasattr(message_class, '_ParseMany'):
+    return message_class._ParseMany(payloads)
+  return [parse(message_class, payload) for payload in payloads]
+
+
+def parse_length_prefixed_many(
+    message_class: Type[_MESSAGE], payload: bytes
+) -> List[_MESSAGE]:
+  """Parses all of the length prefixed messages in payload.
+
+  Like calling parse_length_prefixed() until the end of payload, with the same
+  batching as parse_many().
+
+  Args:
+    message_class: The message meta class.
+    payload: Messages written by serialize_length_prefixed().
+
+  Returns:
+    A list of the new messages, in the order of payload.
+
+  Raises:
+    DecodeError: if any of the messages cannot be parsed.
+    ValueError: if the last message is truncated.
+  """
+  if hasattr(message_class, '_ParseLengthPrefixedMany'):
+    return message_class._ParseLengthPrefixedMany(payload)
+  input_bytes = io.BytesIO(payload)
+  messages = []
+  while True:
+    message = parse_length_prefixed(message_class, input_bytes)
+    if message is None:
+      return messages
+    messages.append(message)
+
+
+def to_dict(message: Message) -> Dict[str, Any]:
+  """Converts the set fields of the message to a dict.
+
+  Fields are keyed by name, and extensions by their full name in brackets.
+  Sub-messages are converted to dicts too, repeated fields to lists and map
+  fields to dicts.  Unlike json_format.MessageToDict(), values keep their
+  Python types: enums are numbers and bytes stay bytes.
+
+  With the upb implementation, this reads the message natively, without
+  creating a wrapper for any of its sub-messages or containers.
+
+  Args:
+    message: The proto message to be converted.
+
+  Returns:
+    A new dict with one entry for each set field.
+  """
+  if hasattr(message, '_ToDict'):
+    return message._ToDict()
+  result = {}
+  for field, value in message.ListFields():
+    key = '[%s]' % field.full_name if field.is_extension else field.name
+    if field.message_type and field.message_type.GetOptions().map_entry:
+      value_field = field.message_type.fields_by_name['value']
+      result[key] = {k: _ValueToDict(value_field, v) for k, v in value.items()}
+    elif field.label == FieldDescriptor.LABEL_REPEATED:
+      result[key] = [_ValueToDict(field, v) for v in value]
+    else:
+      result[key] = _ValueToDict(field, value)
+  return result
+
+
+def _ValueToDict(field: FieldDescriptor, value: Any) -> Any:
+  return to_dict(value) if field.message_type else value
+
+
 def byte_size(message: Message) -> int:
   """Returns the serialized size of this message.
 
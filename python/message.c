@@ -7,14 +7,21 @@
 
 #include "python/message.h"
 
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "python/convert.h"
 #include "python/descriptor.h"
 #include "python/extension_dict.h"
 #include "python/map.h"
 #include "python/repeated.h"
 #include "upb/base/string_view.h"
+#include "upb/message/array.h"
 #include "upb/message/compare.h"
 #include "upb/message/copy.h"
+#include "upb/message/map.h"
 #include "upb/message/message.h"
 #include "upb/reflection/def.h"
 #include "upb/reflection/message.h"
@@ -1547,6 +1554,522 @@ err:
   goto done;
 }
 
+// Parses `count` serialized messages of type `cls` into one new arena, with the
+// GIL released for the whole batch, and returns a list of the messages.  The
+// buffers in `spans` must stay alive and unchanged until this returns.
+static PyObject* PyUpb_Message_DecodeMany(PyObject* cls,
+                                          const upb_StringView* spans,
+                                          Py_ssize_t count) {
+  const upb_MessageDef* msgdef = PyUpb_MessageMeta_GetMsgdef(cls);
+  const upb_FileDef* file = upb_MessageDef_File(msgdef);
+  const upb_ExtensionRegistry* extreg =
+      upb_DefPool_ExtensionRegistry(upb_FileDef_Pool(file));
+  const upb_MiniTable* layout = upb_MessageDef_MiniTable(msgdef);
+  PyUpb_ModuleState* state = PyUpb_ModuleState_Get();
+  int options =
+      upb_DecodeOptions_MaxDepth(state->allow_oversize_protos ? UINT16_MAX : 0);
+
+  upb_Message** msgs = PyMem_Malloc(count * sizeof(*msgs) + 1);
+  if (!msgs) return PyErr_NoMemory();
+  PyObject* arena = PyUpb_Arena_New();
+  upb_Arena* upb_arena = PyUpb_Arena_Get(arena);
+  Py_ssize_t failed = -1;
+
+  // Nothing but the new arena is written, and the decoder is reentrant.  The
+  // extension registry is read without the GIL, so files must not be added to
+  // its pool by other threads during the batch.
+  Py_BEGIN_ALLOW_THREADS;
+  for (Py_ssize_t i = 0; i < count; i++) {
+    msgs[i] = upb_Message_New(layout, upb_arena);
+    if (!msgs[i] ||
+        upb_Decode(spans[i].data, spans[i].size, msgs[i], layout, extreg,
+                   options, upb_arena) != kUpb_DecodeStatus_Ok) {
+      failed = i;
+      break;
+    }
+  }
+  Py_END_ALLOW_THREADS;
+
+  PyObject* ret = NULL;
+  if (failed >= 0) {
+    PyErr_Format(state->decode_error_class,
+                 "Error parsing message with type '%s' at index %zd",
+                 upb_MessageDef_FullName(msgdef), failed);
+  } else if ((ret = PyList_New(count))) {
+    for (Py_ssize_t i = 0; i < count; i++) {
+      PyList_SetItem(ret, i, PyUpb_Message_Get(msgs[i], msgdef, arena));
+    }
+  }
+  PyMem_Free(msgs);
+  Py_DECREF(arena);
+  return ret;
+}
+
+static PyObject* PyUpb_Message_ParseMany(PyObject* cls, PyObject* serialized) {
+  // A tuple holds references to the items, so that no other thread can free
+  // them while the GIL is released.
+  PyObject* items = PySequence_Tuple(serialized);
+  if (!items) return NULL;
+  Py_ssize_t count = PyTuple_Size(items);
+  upb_StringView* spans = PyMem_Malloc(count * sizeof(*spans) + 1);
+  PyObject* ret = NULL;
+  if (!spans) {
+    PyErr_NoMemory();
+    goto done;
+  }
+  for (Py_ssize_t i = 0; i < count; i++) {
+    PyObject* item = PyTuple_GetItem(items, i);
+    char* buf;
+    Py_ssize_t size;
+    // Only bytes, since the contents of mutable buffers could change while
+    // they are parsed.
+    if (!PyBytes_Check(item)) {
+      PyErr_Format(PyExc_TypeError,
+                   "Expected a sequence of bytes, got %S at index %zd",
+                   Py_TYPE(item), i);
+      goto done;
+    }
+    PyBytes_AsStringAndSize(item, &buf, &size);
+    spans[i] = upb_StringView_FromDataAndSize(buf, size);
+  }
+  ret = PyUpb_Message_DecodeMany(cls, spans, count);
+
+done:
+  PyMem_Free(spans);
+  Py_DECREF(items);
+  return ret;
+}
+
+// Reads the varint size in front of a length prefixed message, or returns NULL
+// if it is truncated.
+static const char* PyUpb_Message_ReadLengthPrefix(const char* ptr,
+                                                  const char* end,
+                                                  uint64_t* size) {
+  uint64_t val = 0;
+  for (int shift = 0; shift < 64 && ptr < end; shift += 7) {
+    uint8_t byte = *ptr++;
+    val |= (uint64_t)(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *size = val;
+      return ptr;
+    }
+  }
+  return NULL;
+}
+
+static PyObject* PyUpb_Message_ParseLengthPrefixedMany(PyObject* cls,
+                                                      PyObject* data) {
+  char* buf;
+  Py_ssize_t size;
+  if (!PyBytes_Check(data)) {
+    PyErr_Format(PyExc_TypeError, "Expected bytes, got %S", Py_TYPE(data));
+    return NULL;
+  }
+  PyBytes_AsStringAndSize(data, &buf, &size);
+
+  const char* ptr = buf;
+  const char* end = buf + size;
+  Py_ssize_t count = 0;
+  Py_ssize_t capacity = 16;
+  upb_StringView* spans = PyMem_Malloc(capacity * sizeof(*spans));
+  PyObject* ret = NULL;
+  if (!spans) return PyErr_NoMemory();
+  while (ptr < end) {
+    uint64_t msg_size;
+    const char* msg = PyUpb_Message_ReadLengthPrefix(ptr, end, &msg_size);
+    if (!msg || msg_size > (uint64_t)(end - msg)) {
+      PyErr_Format(PyExc_ValueError,
+                   "Truncated length prefixed message at offset %zd",
+                   (Py_ssize_t)(ptr - buf));
+      goto done;
+    }
+    if (count == capacity) {
+      capacity *= 2;
+      upb_StringView* grown = PyMem_Realloc(spans, capacity * sizeof(*spans));
+      if (!grown) {
+        PyErr_NoMemory();
+        goto done;
+      }
+      spans = grown;
+    }
+    spans[count++] = upb_StringView_FromDataAndSize(msg, msg_size);
+    ptr = msg + msg_size;
+  }
+  ret = PyUpb_Message_DecodeMany(cls, spans, count);
+
+done:
+  PyMem_Free(spans);
+  return ret;
+}
+
+static PyObject* PyUpb_Message_MessageToDict(const upb_Message* msg,
+                                             const upb_MessageDef* m,
+                                             const upb_DefPool* symtab);
+
+// Converts a single value of `f` to Python, or to a dict if it is a message.
+static PyObject* PyUpb_Message_ValueToDict(upb_MessageValue val,
+                                           const upb_FieldDef* f,
+                                           const upb_DefPool* symtab) {
+  if (upb_FieldDef_IsSubMessage(f)) {
+    return PyUpb_Message_MessageToDict(val.msg_val,
+                                       upb_FieldDef_MessageSubDef(f), symtab);
+  }
+  // The arena is only used for messages.
+  return PyUpb_UpbToPy(val, f, NULL);
+}
+
+static PyObject* PyUpb_Message_FieldToDict(upb_MessageValue val,
+                                           const upb_FieldDef* f,
+                                           const upb_DefPool* symtab) {
+  if (upb_FieldDef_IsMap(f)) {
+    const upb_MessageDef* entry_m = upb_FieldDef_MessageSubDef(f);
+    const upb_FieldDef* key_f = upb_MessageDef_Field(entry_m, 0);
+    const upb_FieldDef* val_f = upb_MessageDef_Field(entry_m, 1);
+    PyObject* dict = PyDict_New();
+    if (!dict) return NULL;
+    size_t iter = kUpb_Map_Begin;
+    upb_MessageValue map_key, map_val;
+    while (upb_Map_Next(val.map_val, &map_key, &map_val, &iter)) {
+      PyObject* key = PyUpb_UpbToPy(map_key, key_f, NULL);
+      PyObject* value = PyUpb_Message_ValueToDict(map_val, val_f, symtab);
+      int err = !key || !value || PyDict_SetItem(dict, key, value) < 0;
+      Py_XDECREF(key);
+      Py_XDECREF(value);
+      if (err) {
+        Py_DECREF(dict);
+        return NULL;
+      }
+    }
+    return dict;
+  } else if (upb_FieldDef_IsRepeated(f)) {
+    size_t size = upb_Array_Size(val.array_val);
+    PyObject* list = PyList_New(size);
+    if (!list) return NULL;
+    for (size_t i = 0; i < size; i++) {
+      PyObject* value = PyUpb_Message_ValueToDict(
+          upb_Array_Get(val.array_val, i), f, symtab);
+      if (!value) {
+        Py_DECREF(list);
+        return NULL;
+      }
+      PyList_SetItem(list, i, value);
+    }
+    return list;
+  } else {
+    return PyUpb_Message_ValueToDict(val, f, symtab);
+  }
+}
+
+// Converts `msg` to a dict of its set fields, converting sub-messages to dicts
+// too, without creating a wrapper for any of them.
+static PyObject* PyUpb_Message_MessageToDict(const upb_Message* msg,
+                                             const upb_MessageDef* m,
+                                             const upb_DefPool* symtab) {
+  if (Py_EnterRecursiveCall(" while converting a message to a dict")) {
+    return NULL;
+  }
+  PyObject* dict = PyDict_New();
+  if (!dict) goto done;
+  size_t iter = kUpb_Message_Begin;
+  const upb_FieldDef* f;
+  upb_MessageValue val;
+  while (upb_Message_Next(msg, m, symtab, &f, &val, &iter)) {
+    PyObject* key =
+        upb_FieldDef_IsExtension(f)
+            ? PyUnicode_FromFormat("[%s]", upb_FieldDef_FullName(f))
+            : PyUnicode_FromString(upb_FieldDef_Name(f));
+    PyObject* value = PyUpb_Message_FieldToDict(val, f, symtab);
+    int err = !key || !value || PyDict_SetItem(dict, key, value) < 0;
+    Py_XDECREF(key);
+    Py_XDECREF(value);
+    if (err) {
+      Py_CLEAR(dict);
+      goto done;
+    }
+  }
+
+done:
+  Py_LeaveRecursiveCall();
+  return dict;
+}
+
+static PyObject* PyUpb_Message_ToDict(PyObject* _self, PyObject* arg) {
+  upb_Message* msg = PyUpb_Message_GetIfReified(_self);
+  if (!msg) return PyDict_New();
+  const upb_MessageDef* m = PyUpb_Message_GetMsgdef(_self);
+  const upb_DefPool* symtab = upb_FileDef_Pool(upb_MessageDef_File(m));
+  return PyUpb_Message_MessageToDict(msg, m, symtab);
+}
+
+// -----------------------------------------------------------------------------
+// JSON dict
+// -----------------------------------------------------------------------------
+
+// The options of json_format.MessageToDict() that are supported natively.
+typedef struct {
+  bool proto_names;    // preserving_proto_field_name
+  bool enums_as_ints;  // use_integers_for_enums
+  // Called with a message wrapper to convert the well-known types, other than
+  // the wrappers, in Python: _Printer._MessageToJsonObject().
+  PyObject* py_converter;
+  PyObject* error_class;  // json_format.SerializeToJsonError
+  PyObject* arena;
+  const upb_DefPool* symtab;
+} PyUpb_JsonDictOptions;
+
+static PyObject* PyUpb_JsonDict_Message(const upb_Message* msg,
+                                        const upb_MessageDef* m,
+                                        PyUpb_JsonDictOptions* opts);
+
+static PyObject* PyUpb_JsonDict_Base64(upb_StringView str) {
+  static const char kAlphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  const unsigned char* in = (const unsigned char*)str.data;
+  Py_ssize_t size = (str.size + 2) / 3 * 4;
+  char* out = PyMem_Malloc(size + 1);
+  if (!out) return PyErr_NoMemory();
+  char* ptr = out;
+  size_t i = 0;
+  for (; i + 2 < str.size; i += 3) {
+    *ptr++ = kAlphabet[in[i] >> 2];
+    *ptr++ = kAlphabet[((in[i] & 0x3) << 4) | (in[i + 1] >> 4)];
+    *ptr++ = kAlphabet[((in[i + 1] & 0xf) << 2) | (in[i + 2] >> 6)];
+    *ptr++ = kAlphabet[in[i + 2] & 0x3f];
+  }
+  if (i + 1 == str.size) {
+    *ptr++ = kAlphabet[in[i] >> 2];
+    *ptr++ = kAlphabet[(in[i] & 0x3) << 4];
+    *ptr++ = '=';
+    *ptr++ = '=';
+  } else if (i + 2 == str.size) {
+    *ptr++ = kAlphabet[in[i] >> 2];
+    *ptr++ = kAlphabet[((in[i] & 0x3) << 4) | (in[i + 1] >> 4)];
+    *ptr++ = kAlphabet[(in[i + 1] & 0xf) << 2];
+    *ptr++ = '=';
+  }
+  PyObject* ret = PyUnicode_DecodeASCII(out, size, NULL);
+  PyMem_Free(out);
+  return ret;
+}
+
+static PyObject* PyUpb_JsonDict_Float(double val, bool is_float) {
+  if (isinf(val)) {
+    return PyUnicode_FromString(val < 0 ? "-Infinity" : "Infinity");
+  }
+  if (isnan(val)) return PyUnicode_FromString("NaN");
+  if (!is_float) return PyFloat_FromDouble(val);
+  // Like type_checkers.ToShortestFloat(), the shortest decimal that is still
+  // the same float.
+  char buf[32];
+  for (int precision = 6; precision <= 9; precision++) {
+    snprintf(buf, sizeof(buf), "%.*g", precision, val);
+    if ((float)strtod(buf, NULL) == (float)val) break;
+  }
+  return PyFloat_FromDouble(strtod(buf, NULL));
+}
+
+static PyObject* PyUpb_JsonDict_Enum(int32_t num, const upb_FieldDef* f,
+                                     PyUpb_JsonDictOptions* opts) {
+  if (opts->enums_as_ints) return PyLong_FromLong(num);
+  const upb_EnumDef* e = upb_FieldDef_EnumSubDef(f);
+  if (strcmp(upb_EnumDef_FullName(e), "google.protobuf.NullValue") == 0) {
+    Py_RETURN_NONE;
+  }
+  const upb_EnumValueDef* ev = upb_EnumDef_FindValueByNumber(e, num);
+  if (ev) return PyUnicode_FromString(upb_EnumValueDef_Name(ev));
+  if (upb_EnumDef_IsClosed(e)) {
+    PyErr_SetString(opts->error_class,
+                    "Enum field contains an integer value which can not "
+                    "mapped to an enum value.");
+    return NULL;
+  }
+  return PyLong_FromLong(num);
+}
+
+// Converts a single value of `f`, like _Printer._FieldToJsonObject().
+static PyObject* PyUpb_JsonDict_Value(upb_MessageValue val,
+                                      const upb_FieldDef* f,
+                                      PyUpb_JsonDictOptions* opts) {
+  switch (upb_FieldDef_CType(f)) {
+    case kUpb_CType_Message:
+      return PyUpb_JsonDict_Message(val.msg_val, upb_FieldDef_MessageSubDef(f),
+                                    opts);
+    case kUpb_CType_Enum:
+      return PyUpb_JsonDict_Enum(val.int32_val, f, opts);
+    case kUpb_CType_Bytes:
+      return PyUpb_JsonDict_Base64(val.str_val);
+    case kUpb_CType_Int64:
+      return PyUnicode_FromFormat("%lld", (long long)val.int64_val);
+    case kUpb_CType_UInt64:
+      return PyUnicode_FromFormat("%llu", (unsigned long long)val.uint64_val);
+    case kUpb_CType_Float:
+      return PyUpb_JsonDict_Float(val.float_val, true);
+    case kUpb_CType_Double:
+      return PyUpb_JsonDict_Float(val.double_val, false);
+    case kUpb_CType_String: {
+      PyObject* str = PyUpb_UpbToPy(val, f, NULL);
+      // Invalid UTF-8 is returned as bytes, which str() prints as a literal.
+      if (str && !PyUnicode_Check(str)) {
+        PyObject* repr = PyObject_Str(str);
+        Py_DECREF(str);
+        return repr;
+      }
+      return str;
+    }
+    default:
+      return PyUpb_UpbToPy(val, f, NULL);
+  }
+}
+
+static PyObject* PyUpb_JsonDict_MapKey(upb_MessageValue key,
+                                       const upb_FieldDef* f) {
+  if (upb_FieldDef_CType(f) == kUpb_CType_Bool) {
+    return PyUnicode_FromString(key.bool_val ? "true" : "false");
+  }
+  PyObject* py_key = PyUpb_UpbToPy(key, f, NULL);
+  if (!py_key || PyUnicode_Check(py_key)) return py_key;
+  PyObject* str = PyObject_Str(py_key);
+  Py_DECREF(py_key);
+  return str;
+}
+
+static PyObject* PyUpb_JsonDict_Field(upb_MessageValue val,
+                                      const upb_FieldDef* f,
+                                      PyUpb_JsonDictOptions* opts) {
+  if (upb_FieldDef_IsMap(f)) {
+    const upb_MessageDef* entry_m = upb_FieldDef_MessageSubDef(f);
+    const upb_FieldDef* key_f = upb_MessageDef_Field(entry_m, 0);
+    const upb_FieldDef* val_f = upb_MessageDef_Field(entry_m, 1);
+    PyObject* dict = PyDict_New();
+    if (!dict) return NULL;
+    size_t iter = kUpb_Map_Begin;
+    upb_MessageValue map_key, map_val;
+    while (upb_Map_Next(val.map_val, &map_key, &map_val, &iter)) {
+      PyObject* key = PyUpb_JsonDict_MapKey(map_key, key_f);
+      PyObject* value = key ? PyUpb_JsonDict_Value(map_val, val_f, opts) : NULL;
+      int err = !value || PyDict_SetItem(dict, key, value) < 0;
+      Py_XDECREF(key);
+      Py_XDECREF(value);
+      if (err) {
+        Py_DECREF(dict);
+        return NULL;
+      }
+    }
+    return dict;
+  } else if (upb_FieldDef_IsRepeated(f)) {
+    size_t size = upb_Array_Size(val.array_val);
+    PyObject* list = PyList_New(size);
+    if (!list) return NULL;
+    for (size_t i = 0; i < size; i++) {
+      PyObject* value =
+          PyUpb_JsonDict_Value(upb_Array_Get(val.array_val, i), f, opts);
+      if (!value) {
+        Py_DECREF(list);
+        return NULL;
+      }
+      PyList_SetItem(list, i, value);
+    }
+    return list;
+  } else {
+    return PyUpb_JsonDict_Value(val, f, opts);
+  }
+}
+
+// Replaces a pending ValueError with a SerializeToJsonError naming `f`, as
+// _Printer._RegularMessageToJsonObject() does.
+static void PyUpb_JsonDict_WrapValueError(const upb_FieldDef* f,
+                                          PyUpb_JsonDictOptions* opts) {
+  if (!PyErr_ExceptionMatches(PyExc_ValueError)) return;
+  PyObject *type, *value, *traceback;
+  PyErr_Fetch(&type, &value, &traceback);
+  PyErr_NormalizeException(&type, &value, &traceback);
+  PyObject* exc = NULL;
+  PyObject* msg = PyUnicode_FromFormat("Failed to serialize %s field: %S.",
+                                       upb_FieldDef_Name(f), value);
+  if (msg) {
+    exc = PyObject_CallFunctionObjArgs(opts->error_class, msg, NULL);
+    Py_DECREF(msg);
+  }
+  Py_XDECREF(type);
+  Py_XDECREF(traceback);
+  if (!exc) {
+    Py_XDECREF(value);
+    return;
+  }
+  PyException_SetCause(exc, value);  // Steals `value`.
+  PyErr_SetObject((PyObject*)Py_TYPE(exc), exc);
+  Py_DECREF(exc);
+}
+
+// Converts a message, like _Printer._MessageToJsonObject().
+static PyObject* PyUpb_JsonDict_Message(const upb_Message* msg,
+                                        const upb_MessageDef* m,
+                                        PyUpb_JsonDictOptions* opts) {
+  upb_WellKnown wkt = upb_MessageDef_WellKnownType(m);
+  if (wkt >= kUpb_WellKnown_DoubleValue && wkt <= kUpb_WellKnown_BoolValue) {
+    const upb_FieldDef* f = upb_MessageDef_FindFieldByNumber(m, 1);
+    return PyUpb_JsonDict_Value(upb_Message_GetFieldByDef(msg, f), f, opts);
+  }
+  if (wkt != kUpb_WellKnown_Unspecified) {
+    PyObject* py_msg = PyUpb_Message_Get((upb_Message*)msg, m, opts->arena);
+    PyObject* ret =
+        PyObject_CallFunctionObjArgs(opts->py_converter, py_msg, NULL);
+    Py_DECREF(py_msg);
+    return ret;
+  }
+
+  if (Py_EnterRecursiveCall(" while converting a message to a dict")) {
+    return NULL;
+  }
+  PyObject* dict = PyDict_New();
+  if (!dict) goto done;
+  size_t iter = kUpb_Message_Begin;
+  const upb_FieldDef* f;
+  upb_MessageValue val;
+  while (upb_Message_Next(msg, m, opts->symtab, &f, &val, &iter)) {
+    PyObject* key;
+    if (upb_FieldDef_IsExtension(f)) {
+      key = PyUnicode_FromFormat("[%s]", upb_FieldDef_FullName(f));
+    } else {
+      key = PyUnicode_FromString(opts->proto_names ? upb_FieldDef_Name(f)
+                                                   : upb_FieldDef_JsonName(f));
+    }
+    PyObject* value = key ? PyUpb_JsonDict_Field(val, f, opts) : NULL;
+    if (key && !value) PyUpb_JsonDict_WrapValueError(f, opts);
+    int err = !value || PyDict_SetItem(dict, key, value) < 0;
+    Py_XDECREF(key);
+    Py_XDECREF(value);
+    if (err) {
+      Py_CLEAR(dict);
+      goto done;
+    }
+  }
+
+done:
+  Py_LeaveRecursiveCall();
+  return dict;
+}
+
+static PyObject* PyUpb_Message_ToJsonDict(PyObject* _self, PyObject* args) {
+  PyUpb_Message* self = (void*)_self;
+  PyUpb_JsonDictOptions opts;
+  int proto_names;
+  int enums_as_ints;
+  if (!PyArg_ParseTuple(args, "ppOO", &proto_names, &enums_as_ints,
+                        &opts.py_converter, &opts.error_class)) {
+    return NULL;
+  }
+  upb_Message* msg = PyUpb_Message_GetIfReified(_self);
+  // Stubs are empty, which Python converts quickly enough.
+  if (!msg) return PyObject_CallFunctionObjArgs(opts.py_converter, _self, NULL);
+  const upb_MessageDef* m = PyUpb_Message_GetMsgdef(_self);
+  opts.proto_names = proto_names;
+  opts.enums_as_ints = enums_as_ints;
+  opts.arena = self->arena;
+  opts.symtab = upb_FileDef_Pool(upb_MessageDef_File(m));
+  return PyUpb_JsonDict_Message(msg, m, &opts);
+}
+
 const upb_FieldDef* PyUpb_Message_GetExtensionDef(PyObject* _self,
                                                   PyObject* key) {
   const upb_FieldDef* f = PyUpb_FieldDescriptor_GetDef(key);
@@ -1781,6 +2304,15 @@ static PyMethodDef PyUpb_Message_Methods[] = {
     {"_CheckCalledFromGeneratedFile",
      PyUpb_Message_CheckCalledFromGeneratedFile, METH_NOARGS | METH_STATIC,
      "Raises TypeError if the caller is not in a _pb2.py file."},
+    {"_ParseLengthPrefixedMany", PyUpb_Message_ParseLengthPrefixedMany,
+     METH_O | METH_CLASS,
+     "Parses length prefixed messages, see proto.parse_length_prefixed_many()"},
+    {"_ParseMany", PyUpb_Message_ParseMany, METH_O | METH_CLASS,
+     "Parses many messages, see proto.parse_many()"},
+    {"_ToJsonDict", PyUpb_Message_ToJsonDict, METH_VARARGS,
+     "Converts the message to a dict, see json_format.MessageToDict()"},
+    {"_ToDict", PyUpb_Message_ToDict, METH_NOARGS,
+     "Converts the message to a dict, see proto.to_dict()"},
     {NULL, NULL}};
 
 static PyType_Slot PyUpb_Message_Slots[] = {
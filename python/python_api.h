@@ -38,4 +38,11 @@ PyAPI_FUNC(const char*)
     PyUnicode_AsUTF8AndSize(PyObject* unicode, Py_ssize_t* size);
 #endif
 
+// The buffer protocol was not added to the limited API until 3.11.  Without
+// it, repeated fields can't be exported as buffers.
+
+#if !defined(Py_LIMITED_API) || Py_LIMITED_API >= 0x030b0000
+#define PYUPB_HAS_BUFFER_PROTOCOL 1
+#endif
+
 #endif  // PYUPB_PYTHON_H__
@@ -7,6 +7,8 @@
 
 #include "python/repeated.h"
 
+#include <string.h>
+
 #include "python/convert.h"
 #include "python/message.h"
 #include "python/protobuf.h"
@@ -15,6 +17,12 @@ static PyObject* PyUpb_RepeatedCompositeContainer_Append(PyObject* _self,
                                                          PyObject* value);
 static PyObject* PyUpb_RepeatedScalarContainer_Append(PyObject* _self,
                                                       PyObject* value);
+#ifdef PYUPB_HAS_BUFFER_PROTOCOL
+static int PyUpb_RepeatedScalarContainer_ExtendFromBuffer(upb_Array* arr,
+                                                          const upb_FieldDef* f,
+                                                          PyObject* value,
+                                                          upb_Arena* arena);
+#endif
 
 // Wrapper for a repeated field.
 typedef struct {
@@ -171,14 +179,26 @@ PyObject* PyUpb_RepeatedContainer_Extend(PyObject* _self, PyObject* value) {
   PyUpb_RepeatedContainer* self = (PyUpb_RepeatedContainer*)_self;
   upb_Array* arr = PyUpb_RepeatedContainer_EnsureReified(_self);
   size_t start_size = upb_Array_Size(arr);
+  const upb_FieldDef* f = PyUpb_RepeatedContainer_GetField(self);
+  bool submsg = upb_FieldDef_IsSubMessage(f);
+
+#ifdef PYUPB_HAS_BUFFER_PROTOCOL
+  // Buffers of the same element type, such as NumPy arrays, are copied in
+  // with a single memcpy().
+  if (!submsg && PyObject_CheckBuffer(value)) {
+    int copied = PyUpb_RepeatedScalarContainer_ExtendFromBuffer(
+        arr, f, value, PyUpb_Arena_Get(self->arena));
+    if (copied < 0) return NULL;
+    if (copied) Py_RETURN_NONE;
+  }
+#endif
+
   PyObject* it = PyObject_GetIter(value);
   if (!it) {
     PyErr_SetString(PyExc_TypeError, "Value must be iterable");
     return NULL;
   }
 
-  const upb_FieldDef* f = PyUpb_RepeatedContainer_GetField(self);
-  bool submsg = upb_FieldDef_IsSubMessage(f);
   PyObject* e;
 
   if (submsg) {
@@ -715,6 +735,141 @@ static PyObject* PyUpb_RepeatedScalarContainer_Reduce(PyObject* unused_self,
   return NULL;
 }
 
+#ifdef PYUPB_HAS_BUFFER_PROTOCOL
+
+// Returns the struct module format of the elements of `f` and sets `itemsize`
+// to their size, or returns NULL if they can't be exported as a buffer.  Bools
+// and enums are not exported, since writes through the buffer could store
+// values that are not valid for them.
+static const char* PyUpb_RepeatedScalarContainer_BufferFormat(
+    const upb_FieldDef* f, Py_ssize_t* itemsize) {
+  switch (upb_FieldDef_CType(f)) {
+    case kUpb_CType_Int32:
+      *itemsize = sizeof(int32_t);
+      return "i";
+    case kUpb_CType_UInt32:
+      *itemsize = sizeof(uint32_t);
+      return "I";
+    case kUpb_CType_Int64:
+      *itemsize = sizeof(int64_t);
+      return "q";
+    case kUpb_CType_UInt64:
+      *itemsize = sizeof(uint64_t);
+      return "Q";
+    case kUpb_CType_Float:
+      *itemsize = sizeof(float);
+      return "f";
+    case kUpb_CType_Double:
+      *itemsize = sizeof(double);
+      return "d";
+    default:
+      return NULL;
+  }
+}
+
+// Returns 'i' for a native signed integer format, 'u' for a native unsigned
+// integer format and 'f' for a native floating point format, or 0 for any
+// other format.  The sizes are compared separately.
+static char PyUpb_BufferFormatKind(const char* format) {
+  if (!format) return 'u';  // Unsigned bytes.
+  if (*format == '@' || *format == '=') format++;
+  if (format[0] == '\0' || format[1] != '\0') return 0;
+  if (strchr("bhilqn", format[0])) return 'i';
+  if (strchr("BHILQN", format[0])) return 'u';
+  if (strchr("fd", format[0])) return 'f';
+  return 0;
+}
+
+// Exports the elements as a one dimensional, writable buffer that aliases the
+// storage of the array, so that `memoryview` and `numpy.frombuffer` don't copy
+// them.  The buffer holds a reference to the container, and so to its arena,
+// which keeps the storage alive.  However, growing the field may move its
+// elements, after which the buffer still refers to their old storage.
+static int PyUpb_RepeatedScalarContainer_GetBuffer(PyObject* _self,
+                                                   Py_buffer* view,
+                                                   int flags) {
+  PyUpb_RepeatedContainer* self = (PyUpb_RepeatedContainer*)_self;
+  const upb_FieldDef* f = PyUpb_RepeatedContainer_GetField(self);
+  Py_ssize_t itemsize;
+  const char* format = PyUpb_RepeatedScalarContainer_BufferFormat(f, &itemsize);
+  if (!format) {
+    PyErr_Format(PyExc_BufferError,
+                 "repeated field %s can't be exported as a buffer",
+                 upb_FieldDef_FullName(f));
+    view->obj = NULL;
+    return -1;
+  }
+
+  // The shape and strides, freed when the buffer is released.
+  Py_ssize_t* dims = PyMem_Malloc(2 * sizeof(Py_ssize_t));
+  if (!dims) {
+    PyErr_NoMemory();
+    view->obj = NULL;
+    return -1;
+  }
+  upb_Array* arr = PyUpb_RepeatedContainer_GetIfReified(self);
+  Py_ssize_t size = arr ? upb_Array_Size(arr) : 0;
+  dims[0] = size;
+  dims[1] = itemsize;
+
+  Py_INCREF(_self);
+  view->obj = _self;
+  // An empty buffer still needs a valid pointer.
+  view->buf = arr ? upb_Array_MutableDataPtr(arr) : (void*)dims;
+  view->len = size * itemsize;
+  view->itemsize = itemsize;
+  view->readonly = 0;
+  view->ndim = 1;
+  view->format = (flags & PyBUF_FORMAT) ? (char*)format : NULL;
+  view->shape = (flags & PyBUF_ND) ? &dims[0] : NULL;
+  view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &dims[1] : NULL;
+  view->suboffsets = NULL;
+  view->internal = dims;
+  return 0;
+}
+
+static void PyUpb_RepeatedScalarContainer_ReleaseBuffer(PyObject* _self,
+                                                        Py_buffer* view) {
+  PyMem_Free(view->internal);
+}
+
+// Appends the elements of the buffer `value` to `arr` if they have the same
+// type as the elements of `f`.  Returns 1 if they were appended, 0 if `value`
+// must be iterated instead, or -1 with an exception set on failure.
+static int PyUpb_RepeatedScalarContainer_ExtendFromBuffer(upb_Array* arr,
+                                                          const upb_FieldDef* f,
+                                                          PyObject* value,
+                                                          upb_Arena* arena) {
+  Py_ssize_t itemsize;
+  const char* format = PyUpb_RepeatedScalarContainer_BufferFormat(f, &itemsize);
+  if (!format) return 0;
+  Py_buffer view;
+  if (PyObject_GetBuffer(value, &view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0) {
+    PyErr_Clear();
+    return 0;
+  }
+  int ret = 0;
+  if (view.ndim <= 1 && view.itemsize == itemsize &&
+      PyUpb_BufferFormatKind(view.format) == PyUpb_BufferFormatKind(format)) {
+    size_t start_size = upb_Array_Size(arr);
+    size_t count = view.len / itemsize;
+    if (upb_Array_Resize(arr, start_size + count, arena)) {
+      if (count) {
+        memcpy((char*)upb_Array_MutableDataPtr(arr) + start_size * itemsize,
+               view.buf, view.len);
+      }
+      ret = 1;
+    } else {
+      PyErr_NoMemory();
+      ret = -1;
+    }
+  }
+  PyBuffer_Release(&view);
+  return ret;
+}
+
+#endif  // PYUPB_HAS_BUFFER_PROTOCOL
+
 static PyMethodDef PyUpb_RepeatedScalarContainer_Methods[] = {
     {"__deepcopy__", PyUpb_RepeatedContainer_DeepCopy, METH_VARARGS,
      "Makes a deep copy of the class."},
@@ -751,6 +906,10 @@ static PyType_Slot PyUpb_RepeatedScalarContainer_Slots[] = {
     {Py_mp_ass_subscript, PyUpb_RepeatedContainer_AssignSubscript},
     {Py_tp_richcompare, PyUpb_RepeatedContainer_RichCompare},
     {Py_tp_hash, PyObject_HashNotImplemented},
+#ifdef PYUPB_HAS_BUFFER_PROTOCOL
+    {Py_bf_getbuffer, PyUpb_RepeatedScalarContainer_GetBuffer},
+    {Py_bf_releasebuffer, PyUpb_RepeatedScalarContainer_ReleaseBuffer},
+#endif
     {0, NULL}};
 
 static PyType_Spec PyUpb_RepeatedScalarContainer_Spec = {
@@ -7,6 +7,8 @@
 
 #include "message.h"
 
+#include <ruby/thread.h>
+
 #include "convert.h"
 #include "defs.h"
 #include "map.h"
@@ -988,6 +990,151 @@ VALUE Message_decode_bytes(int size, const char* bytes, int options,
   return msg_rb;
 }
 
+typedef struct {
+  const upb_MiniTable* layout;
+  const upb_ExtensionRegistry* extreg;
+  int options;
+  upb_Arena* arena;
+  long count;
+  const upb_StringView* datas;
+  upb_Message** msgs;
+  long next;    // Index of the next payload to decode.
+  bool failed;  // Whether the payload at `next` failed to decode.
+  volatile bool interrupted;
+} DecodeManyArgs;
+
+// Runs without the GVL, so it must not touch any Ruby object.
+static void* Message_decode_many_nogvl(void* _args) {
+  DecodeManyArgs* args = _args;
+  for (; args->next < args->count && !args->interrupted; args->next++) {
+    const upb_StringView data = args->datas[args->next];
+    upb_DecodeStatus status =
+        upb_Decode(data.data, data.size, args->msgs[args->next], args->layout,
+                   args->extreg, args->options, args->arena);
+    if (status != kUpb_DecodeStatus_Ok) {
+      args->failed = true;
+      break;
+    }
+  }
+  return NULL;
+}
+
+static void Message_decode_many_ubf(void* _args) {
+  DecodeManyArgs* args = _args;
+  args->interrupted = true;
+}
+
+/*
+ * call-seq:
+ *     MessageClass.decode_many(datas, options) => [message, ...]
+ *
+ * Decodes each string in the given array like MessageClass.decode, and returns
+ * the messages in the same order. All of the messages share one arena, and the
+ * GVL is released while decoding, so that other threads can run.
+ * @param options [Hash] options for the decoder
+ *  recursion_limit: set to maximum decoding depth for message (default is 64)
+ *  freeze: set true to return frozen messages, which can be shared between
+ *  Ractors without copying (default is false)
+ */
+static VALUE Message_decode_many(int argc, VALUE* argv, VALUE klass) {
+  int options = 0;
+  bool freeze = false;
+
+  if (argc < 1 || argc > 2) {
+    rb_raise(rb_eArgError, "Expected 1 or 2 arguments.");
+  }
+
+  if (argc == 2) {
+    VALUE hash_args = argv[1];
+    if (TYPE(hash_args) != T_HASH) {
+      rb_raise(rb_eArgError, "Expected hash arguments.");
+    }
+
+    VALUE depth =
+        rb_hash_lookup(hash_args, ID2SYM(rb_intern("recursion_limit")));
+
+    if (depth != Qnil && TYPE(depth) == T_FIXNUM) {
+      options |= upb_DecodeOptions_MaxDepth(FIX2INT(depth));
+    }
+
+    freeze = RTEST(rb_hash_lookup2(hash_args, ID2SYM(rb_intern("freeze")),
+                                   Qfalse));
+  }
+
+  VALUE datas_rb = argv[0];
+  if (TYPE(datas_rb) != T_ARRAY) {
+    rb_raise(rb_eArgError,
+             "Expected array of strings for binary protobuf data.");
+  }
+
+  VALUE descriptor = rb_ivar_get(klass, descriptor_instancevar_interned);
+  const upb_MessageDef* m = Descriptor_GetMsgDef(descriptor);
+  const upb_MiniTable* layout = upb_MessageDef_MiniTable(m);
+  long count = RARRAY_LEN(datas_rb);
+  VALUE ret = rb_ary_new_capa(count);
+  if (count == 0) return ret;
+
+  VALUE arena_rb = Arena_new();
+  upb_Arena* arena = Arena_get(arena_rb);
+  upb_StringView* datas = upb_Arena_Malloc(arena, count * sizeof(*datas));
+  upb_Message** msgs = upb_Arena_Malloc(arena, count * sizeof(*msgs));
+  if (!datas || !msgs) rb_raise(rb_eNoMemError, "Out of memory");
+
+  // Frozen copies share the bytes of the strings, which then stay in place
+  // even if a string is modified by another thread while we are decoding.
+  VALUE frozen_rb = rb_ary_new_capa(count);
+  for (long i = 0; i < count; i++) {
+    VALUE data = rb_ary_entry(datas_rb, i);
+    if (TYPE(data) != T_STRING) {
+      rb_raise(rb_eArgError, "Expected string for binary protobuf data.");
+    }
+    data = rb_str_new_frozen(data);
+    rb_ary_push(frozen_rb, data);
+    datas[i] = upb_StringView_FromDataAndSize(RSTRING_PTR(data),
+                                              RSTRING_LEN(data));
+    msgs[i] = upb_Message_New(layout, arena);
+    if (!msgs[i]) rb_raise(rb_eNoMemError, "Out of memory");
+  }
+
+  DecodeManyArgs args = {
+      .layout = layout,
+      .extreg = upb_DefPool_ExtensionRegistry(
+          upb_FileDef_Pool(upb_MessageDef_File(m))),
+      .options = options,
+      .arena = arena,
+      .count = count,
+      .datas = datas,
+      .msgs = msgs,
+      .next = 0,
+      .failed = false,
+      .interrupted = false,
+  };
+  while (args.next < count && !args.failed) {
+    rb_thread_call_without_gvl(Message_decode_many_nogvl, &args,
+                               Message_decode_many_ubf, &args);
+    // Raises if the thread was interrupted by Thread#raise or Thread#kill,
+    // otherwise we resume where the decoder stopped.
+    rb_thread_check_ints();
+    args.interrupted = false;
+  }
+  RB_GC_GUARD(frozen_rb);
+
+  if (args.failed) {
+    rb_raise(cParseError, "Error occurred during parsing of message %ld",
+             args.next);
+  }
+
+  for (long i = 0; i < count; i++) {
+    VALUE msg_rb = Message_alloc(klass);
+    Message_InitPtr(msg_rb, msgs[i], arena_rb);
+    if (freeze) {
+      Message_freeze(msg_rb);
+    }
+    rb_ary_push(ret, msg_rb);
+  }
+  return ret;
+}
+
 /*
  * call-seq:
  *     MessageClass.decode_json(data, options = {}) => message
@@ -1406,6 +1553,7 @@ static void Message_define_class(VALUE klass) {
   rb_define_method(klass, "[]", Message_index, 1);
   rb_define_method(klass, "[]=", Message_index_set, 2);
   rb_define_singleton_method(klass, "decode", Message_decode, -1);
+  rb_define_singleton_method(klass, "decode_many", Message_decode_many, -1);
   rb_define_singleton_method(klass, "encode", Message_encode, -1);
   rb_define_singleton_method(klass, "decode_json", Message_decode_json, -1);
   rb_define_singleton_method(klass, "encode_json", Message_encode_json, -1);
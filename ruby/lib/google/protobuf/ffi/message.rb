@@ -211,6 +211,29 @@ module Google
             message
           end
 
+          ##
+          # call-seq:
+          #    MessageClass.decode_many(datas, options) => [message, ...]
+          #
+          # Decodes each string in the given array like MessageClass.decode, and
+          # returns the messages in the same order.
+          # @param datas [Array<String>] Binary strings in Protobuf wire format to decode
+          # @param options [Hash] options for the decoder
+          # @option options [Integer] :recursion_limit Set to maximum decoding depth for message (default is 64)
+          # @option options [Boolean] :freeze Set true to return frozen messages (default is false)
+          def self.decode_many(datas, options = {})
+            raise ArgumentError.new "Expected hash arguments." unless options.is_a? Hash
+            raise ArgumentError.new "Expected array of strings for binary protobuf data." unless datas.is_a? Array
+            datas.each_with_index.map do |data, index|
+              begin
+                message = decode(data, options)
+              rescue ParseError
+                raise ParseError.new "Error occurred during parsing of message #{index}"
+              end
+              options[:freeze] ? message.freeze : message
+            end
+          end
+
           ##
           # call-seq:
           #    MessageClass.encode(msg, options) => bytes
@@ -188,6 +188,33 @@ class EncodeDecodeTest < Test::Unit::TestCase
     assert_match msg.to_json, msg_out.to_json
   end
 
+  def test_decode_many
+    msgs = [
+      A::B::C::TestMessage.new(optional_int32: 1, repeated_string: ["a"]),
+      A::B::C::TestMessage.new,
+      A::B::C::TestMessage.new(optional_msg: A::B::C::TestMessage.new(optional_int32: 3)),
+    ]
+    datas = msgs.map { |msg| A::B::C::TestMessage.encode(msg) }
+
+    assert_equal msgs, A::B::C::TestMessage.decode_many(datas)
+    assert_equal [], A::B::C::TestMessage.decode_many([])
+
+    frozen = A::B::C::TestMessage.decode_many(datas, { freeze: true })
+    assert_equal msgs, frozen
+    assert frozen.all?(&:frozen?)
+    assert frozen[2].optional_msg.frozen?
+
+    assert_raises Google::Protobuf::ParseError do
+      A::B::C::TestMessage.decode_many([datas[0], "\xff".b])
+    end
+    assert_raises ArgumentError do
+      A::B::C::TestMessage.decode_many([datas[0], 1])
+    end
+    assert_raises ArgumentError do
+      A::B::C::TestMessage.decode_many(datas[0])
+    end
+  end
+
   def test_encode_depth_limit
     msg = A::B::C::TestMessage.new(
       optional_msg: A::B::C::TestMessage.new(
@@ -85,6 +85,17 @@ pub(crate) mod read {
 
     pub trait Serialize: SealedInternal {
         fn serialize(&self) -> Result<Vec<u8>, crate::SerializeError>;
+
+        /// Appends the serialization of this message to `out`. On error, `out`
+        /// is left unchanged.
+        ///
+        /// Unlike `serialize`, this writes into a buffer the caller owns, so
+        /// clearing and reusing one buffer for many messages avoids an
+        /// allocation per message.
+        fn serialize_into(&self, out: &mut Vec<u8>) -> Result<(), crate::SerializeError> {
+            out.extend_from_slice(&self.serialize()?);
+            Ok(())
+        }
     }
 }
 
@@ -106,10 +106,46 @@ extern "C" {
     pub fn proto2_rust_Message_clear(m: RawMessage);
     pub fn proto2_rust_Message_parse(m: RawMessage, input: SerializedData) -> bool;
     pub fn proto2_rust_Message_serialize(m: RawMessage, output: &mut SerializedData) -> bool;
+    pub fn proto2_rust_Message_byte_size(m: RawMessage) -> usize;
+    pub fn proto2_rust_Message_serialize_to_array(m: RawMessage, out: *mut u8, len: usize)
+        -> bool;
     pub fn proto2_rust_Message_copy_from(dst: RawMessage, src: RawMessage) -> bool;
     pub fn proto2_rust_Message_merge_from(dst: RawMessage, src: RawMessage) -> bool;
 }
 
+/// Appends the serialization of `msg` to `out`, writing it in place into the
+/// spare capacity of `out`. Reusing `out` across messages avoids allocating for
+/// each of them.
+///
+/// # Safety
+/// - `msg` must be a valid message.
+#[doc(hidden)]
+pub unsafe fn serialize_into(
+    msg: RawMessage,
+    out: &mut Vec<u8>,
+) -> Result<(), crate::SerializeError> {
+    // SAFETY: `msg` is a valid message.
+    let len = unsafe { proto2_rust_Message_byte_size(msg) };
+    if len > i32::MAX as usize {
+        // Exceeds the maximum protobuf size of 2GB.
+        return Err(crate::SerializeError);
+    }
+    out.reserve(len);
+    // SAFETY:
+    // - `msg` is a valid message, and has not changed since its size was
+    //   computed and cached.
+    // - `out` has room for `len` more bytes.
+    let success = unsafe {
+        proto2_rust_Message_serialize_to_array(msg, out.as_mut_ptr().add(out.len()), len)
+    };
+    if !success {
+        return Err(crate::SerializeError);
+    }
+    // SAFETY: the serializer initialized the `len` bytes after `out.len()`.
+    unsafe { out.set_len(out.len() + len) };
+    Ok(())
+}
+
 impl Drop for InnerProtoString {
     fn drop(&mut self) {
         // SAFETY: `self.owned_ptr` points to a valid std::string object.
@@ -502,7 +538,10 @@ macro_rules! impl_repeated_primitives {
         $clear_thunk:ident,
         $copy_from_thunk:ident,
         $reserve_thunk:ident $(,)?
-    ]),* $(,)?) => {
+    ] $(slices [
+        $data_thunk:ident,
+        $extend_thunk:ident $(,)?
+    ])?),* $(,)?) => {
         $(
             extern "C" {
                 fn $new_thunk() -> RawRepeatedField;
@@ -521,6 +560,10 @@ macro_rules! impl_repeated_primitives {
                 fn $reserve_thunk(
                     f: RawRepeatedField,
                     additional: usize);
+                $(
+                    fn $data_thunk(f: RawRepeatedField) -> *const $t;
+                    fn $extend_thunk(f: RawRepeatedField, data: *const $t, len: usize);
+                )?
             }
 
             unsafe impl ProxiedInRepeated for $t {
@@ -565,9 +608,55 @@ macro_rules! impl_repeated_primitives {
                 fn repeated_reserve(mut f: Mut<Repeated<$t>>, additional: usize) {
                     unsafe { $reserve_thunk(f.as_raw(Private), additional) }
                 }
+                $(
+                    #[inline]
+                    fn repeated_as_slice<'msg>(
+                        f: View<'msg, Repeated<$t>>,
+                    ) -> Option<&'msg [View<'msg, $t>]> {
+                        let len = f.len();
+                        if len == 0 {
+                            return Some(&[]);
+                        }
+                        // SAFETY:
+                        // - A non-empty `RepeatedField<T>` stores its `len` elements
+                        //   contiguously, and `T` has the layout of the view type.
+                        // - The field can't be mutated while it is viewed for `'msg`.
+                        Some(unsafe {
+                            std::slice::from_raw_parts($data_thunk(f.as_raw(Private)), len)
+                        })
+                    }
+                    #[inline]
+                    fn repeated_extend_from_slice(
+                        mut f: Mut<Repeated<$t>>,
+                        vals: &[View<'_, $t>],
+                    ) -> bool {
+                        unsafe { $extend_thunk(f.as_raw(Private), vals.as_ptr(), vals.len()) }
+                        true
+                    }
+                )?
             }
         )*
     };
+    (@scalars $($t:ty),* $(,)?) => {
+        paste!{
+            impl_repeated_primitives!(@impl $(
+                $t => [
+                    [< proto2_rust_RepeatedField_ $t _new >],
+                    [< proto2_rust_RepeatedField_ $t _free >],
+                    [< proto2_rust_RepeatedField_ $t _add >],
+                    [< proto2_rust_RepeatedField_ $t _size >],
+                    [< proto2_rust_RepeatedField_ $t _get >],
+                    [< proto2_rust_RepeatedField_ $t _set >],
+                    [< proto2_rust_RepeatedField_ $t _clear >],
+                    [< proto2_rust_RepeatedField_ $t _copy_from >],
+                    [< proto2_rust_RepeatedField_ $t _reserve >],
+                ] slices [
+                    [< proto2_rust_RepeatedField_ $t _data >],
+                    [< proto2_rust_RepeatedField_ $t _extend >],
+                ],
+            )*);
+        }
+    };
     ($($t:ty),* $(,)?) => {
         paste!{
             impl_repeated_primitives!(@impl $(
@@ -587,7 +676,9 @@ macro_rules! impl_repeated_primitives {
     };
 }
 
-impl_repeated_primitives!(i32, u32, i64, u64, f32, f64, bool, ProtoString, ProtoBytes);
+// The scalars are stored contiguously, so they can also be read as slices.
+impl_repeated_primitives!(@scalars i32, u32, i64, u64, f32, f64, bool);
+impl_repeated_primitives!(ProtoString, ProtoBytes);
 
 extern "C" {
     pub fn proto2_rust_RepeatedField_Message_new() -> RawRepeatedField;
@@ -1,3 +1,5 @@
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 
 #include "google/protobuf/message_lite.h"
@@ -22,6 +24,15 @@ bool proto2_rust_Message_serialize(const google::protobuf::MessageLite* m,
   return google::protobuf::rust::SerializeMsg(m, output);
 }
 
+size_t proto2_rust_Message_byte_size(const google::protobuf::MessageLite* m) {
+  return m->ByteSizeLong();
+}
+
+bool proto2_rust_Message_serialize_to_array(const google::protobuf::MessageLite* m,
+                                            uint8_t* out, size_t len) {
+  return google::protobuf::rust::SerializeMsgToArray(m, out, len);
+}
+
 void proto2_rust_Message_copy_from(google::protobuf::MessageLite* dst,
                                    const google::protobuf::MessageLite& src) {
   dst->Clear();
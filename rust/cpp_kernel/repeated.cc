@@ -46,6 +46,14 @@ extern "C" {
   void proto2_rust_RepeatedField_##rust_ty##_reserve(                          \
       google::protobuf::RepeatedField<ty>* r, size_t additional) {                       \
     r->Reserve(r->size() + additional);                                        \
+  }                                                                            \
+  const ty* proto2_rust_RepeatedField_##rust_ty##_data(                        \
+      const google::protobuf::RepeatedField<ty>* r) {                                    \
+    return r->data();                                                          \
+  }                                                                            \
+  void proto2_rust_RepeatedField_##rust_ty##_extend(                           \
+      google::protobuf::RepeatedField<ty>* r, const ty* data, size_t len) {              \
+    r->Add(data, data + len);                                                  \
   }
 
 expose_repeated_field_methods(int32_t, i32);
@@ -56,6 +56,21 @@ inline bool SerializeMsg(const google::protobuf::MessageLite* msg, SerializedDat
   return true;
 }
 
+// Serializes `msg` into `out`, which must be writable for `len` bytes, where
+// `len` is what `msg->ByteSizeLong()` returned since `msg` was last modified.
+// Lets Rust serialize into a buffer it owns and reuses.
+inline bool SerializeMsgToArray(const google::protobuf::MessageLite* msg,
+                                uint8_t* out, size_t len) {
+  ABSL_DCHECK(msg->IsInitialized());
+  ABSL_DCHECK_EQ(len, static_cast<size_t>(msg->GetCachedSize()));
+  if (len > INT_MAX) {
+    ABSL_LOG(ERROR) << msg->GetTypeName()
+                    << " exceeded maximum protobuf size of 2GB: " << len;
+    return false;
+  }
+  return msg->SerializeWithCachedSizesToArray(out) != nullptr;
+}
+
 }  // namespace rust
 }  // namespace protobuf
 }  // namespace google
@@ -118,6 +118,15 @@ where
     pub fn iter(self) -> RepeatedIter<'msg, T> {
         self.into_iter()
     }
+
+    /// Returns the values as a slice, without copying them.
+    ///
+    /// Returns `None` for the element types that are not stored as a
+    /// contiguous array of their views: strings, bytes, enums and messages.
+    #[inline]
+    pub fn as_slice(self) -> Option<&'msg [View<'msg, T>]> {
+        T::repeated_as_slice(self)
+    }
 }
 
 #[doc(hidden)]
@@ -206,6 +215,17 @@ where
         self.as_view().into_iter()
     }
 
+    /// Appends all of `vals` to the end of the repeated field, with a single
+    /// copy for the element types that are stored contiguously.
+    pub fn extend_from_slice<'a>(&mut self, vals: &[View<'a, T>])
+    where
+        View<'a, T>: Copy + IntoProxied<T>,
+    {
+        if !T::repeated_extend_from_slice(self.as_mut(), vals) {
+            self.extend(vals.iter().copied());
+        }
+    }
+
     /// Copies from the `src` repeated field into this one.
     pub fn copy_from(&mut self, src: RepeatedView<'_, T>) {
         T::repeated_copy_from(src, self.as_mut())
@@ -274,6 +294,8 @@ where
 /// # Safety
 /// - It must be sound to call `*_unchecked*(x)` with an `index` less than
 ///   `repeated_len(x)`.
+/// - `repeated_as_slice` must only return `Some` if `View<Self>` is `Copy`, as
+///   the elements are read out of the slice by value.
 pub unsafe trait ProxiedInRepeated: Proxied {
     /// Constructs a new owned `Repeated` field.
     #[doc(hidden)]
@@ -313,15 +335,46 @@ pub unsafe trait ProxiedInRepeated: Proxied {
     /// Ensures that the repeated field has enough space allocated to insert at
     /// least `additional` values without an allocation.
     fn repeated_reserve(repeated: Mut<Repeated<Self>>, additional: usize);
+
+    /// Returns the elements as a slice, if the kernel stores them contiguously
+    /// as their views. This lets them be read without a kernel call for each
+    /// element.
+    #[doc(hidden)]
+    #[inline]
+    fn repeated_as_slice<'msg>(
+        _repeated: View<'msg, Repeated<Self>>,
+    ) -> Option<&'msg [View<'msg, Self>]> {
+        None
+    }
+
+    /// Appends `vals` with a single copy, if the kernel stores the elements
+    /// contiguously as their views. Returns `false`, and appends nothing,
+    /// otherwise.
+    #[doc(hidden)]
+    #[inline]
+    fn repeated_extend_from_slice(
+        _repeated: Mut<Repeated<Self>>,
+        _vals: &[View<'_, Self>],
+    ) -> bool {
+        false
+    }
 }
 
 /// An iterator over the values inside of a [`View<Repeated<T>>`](RepeatedView).
-pub struct RepeatedIter<'msg, T> {
+pub struct RepeatedIter<'msg, T: ProxiedInRepeated + 'msg> {
     view: RepeatedView<'msg, T>,
     current_index: usize,
+    // The elements, when they can be read without calling into the kernel.
+    slice: Option<&'msg [View<'msg, T>]>,
 }
 
-impl<'msg, T> Debug for RepeatedIter<'msg, T> {
+impl<'msg, T: ProxiedInRepeated + 'msg> RepeatedIter<'msg, T> {
+    fn new(view: RepeatedView<'msg, T>) -> Self {
+        RepeatedIter { view, current_index: 0, slice: T::repeated_as_slice(view) }
+    }
+}
+
+impl<'msg, T: ProxiedInRepeated + 'msg> Debug for RepeatedIter<'msg, T> {
     fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
         f.debug_struct("RepeatedIter")
             .field("view", &self.view)
@@ -512,6 +565,12 @@ where
 
     #[inline]
     fn next(&mut self) -> Option<Self::Item> {
+        if let Some(slice) = self.slice {
+            let val = slice.get(self.current_index)?;
+            self.current_index += 1;
+            // SAFETY: `repeated_as_slice` only returns slices of `Copy` views.
+            return Some(unsafe { std::ptr::read(val) });
+        }
         let val = self.view.get(self.current_index);
         if val.is_some() {
             self.current_index += 1;
@@ -527,7 +586,7 @@ where
 
 impl<'msg, T: ProxiedInRepeated> ExactSizeIterator for RepeatedIter<'msg, T> {
     fn len(&self) -> usize {
-        self.view.len() - self.current_index
+        self.slice.map_or_else(|| self.view.len(), |slice| slice.len()) - self.current_index
     }
 }
 
@@ -542,7 +601,7 @@ where
     type IntoIter = RepeatedIter<'msg, T>;
 
     fn into_iter(self) -> Self::IntoIter {
-        RepeatedIter { view: self, current_index: 0 }
+        RepeatedIter::new(self)
     }
 }
 
@@ -554,7 +613,7 @@ where
     type IntoIter = RepeatedIter<'msg, T>;
 
     fn into_iter(self) -> Self::IntoIter {
-        RepeatedIter { view: *self, current_index: 0 }
+        RepeatedIter::new(*self)
     }
 }
 
@@ -566,7 +625,7 @@ where
     type IntoIter = RepeatedIter<'borrow, T>;
 
     fn into_iter(self) -> Self::IntoIter {
-        RepeatedIter { view: self.as_view(), current_index: 0 }
+        RepeatedIter::new(self.as_view())
     }
 }
 
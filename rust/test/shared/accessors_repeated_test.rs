@@ -91,6 +91,28 @@ macro_rules! generate_repeated_numeric_test {
             // Also check FusedIterator - calling `next` multiple times should return `None`.
             assert_that!(iter.next(), eq(None));
           }
+
+          #[gtest]
+          fn [< test_repeated_ $field _slices >]() {
+            let mut msg = TestAllTypes::new();
+            assert_that!(msg.[< repeated_ $field >]().as_slice(), some(empty()));
+
+            let mut mutator = msg.[<repeated_ $field _mut>]();
+            mutator.extend_from_slice(&[1 as $t, 2 as $t]);
+            mutator.extend_from_slice(&[]);
+            mutator.push(3 as $t);
+            mutator.extend_from_slice(&[4 as $t]);
+
+            let view = msg.[< repeated_ $field >]();
+            assert_that!(
+              view.as_slice(),
+              some(eq(&[1 as $t, 2 as $t, 3 as $t, 4 as $t][..]))
+            );
+            assert_that!(
+              view.iter().collect::<Vec<_>>(),
+              eq(&vec![1 as $t, 2 as $t, 3 as $t, 4 as $t])
+            );
+          }
       )* }
   };
 }
@@ -134,6 +156,13 @@ fn test_repeated_bool_accessors() {
     assert_that!(msg.repeated_bool(), each(eq(false)));
 }
 
+#[gtest]
+fn test_repeated_bool_slices() {
+    let mut msg = TestAllTypes::new();
+    msg.repeated_bool_mut().extend_from_slice(&[true, false, true]);
+    assert_that!(msg.repeated_bool().as_slice(), some(eq(&[true, false, true][..])));
+}
+
 #[gtest]
 fn test_repeated_enum_accessors() {
     use test_all_types::NestedEnum;
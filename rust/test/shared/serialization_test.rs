@@ -52,6 +52,27 @@ macro_rules! generate_parameterized_serialization_test {
                 assert_that!(msg.optional_bytes(), eq(msg2.optional_bytes()));
             }
 
+            #[gtest]
+            fn [< serialize_into_appends_ $name_ext>]() {
+                let mut msg = [< $type >]::new();
+                msg.set_optional_int64(42);
+                msg.set_optional_bytes(b"serialize into test");
+                let serialized = msg.serialize().unwrap();
+
+                // Into an empty buffer, and after existing contents.
+                let mut out = Vec::new();
+                msg.serialize_into(&mut out).unwrap();
+                assert_that!(out, eq(&serialized));
+                msg.as_view().serialize_into(&mut out).unwrap();
+                assert_that!(out.len(), eq(2 * serialized.len()));
+                assert_that!(&out[serialized.len()..], eq(&serialized[..]));
+
+                // Reusing a buffer with more capacity than needed.
+                out.clear();
+                msg.as_mut().serialize_into(&mut out).unwrap();
+                assert_that!(out, eq(&serialized));
+            }
+
             #[gtest]
             fn [< deserialize_empty_ $name_ext>]() {
                 assert!([< $type >]::parse(&[]).is_ok());
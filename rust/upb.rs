@@ -302,6 +302,46 @@ macro_rules! impl_repeated_primitives {
                           size_of::<$elem_t>() * src.len());
                     }
                 }
+
+                #[inline]
+                fn repeated_as_slice<'msg>(
+                    f: View<'msg, Repeated<$t>>,
+                ) -> Option<&'msg [View<'msg, $t>]> {
+                    let len = f.len();
+                    if len == 0 {
+                        return Some(&[]);
+                    }
+                    // SAFETY:
+                    // - The data pointer of a non-empty array is valid for `len` elements,
+                    //   and `$elem_t` is the view type `$t`.
+                    // - The array can't be mutated while it is viewed for `'msg`.
+                    Some(unsafe {
+                        slice::from_raw_parts(upb_Array_DataPtr(f.as_raw(Private)).cast(), len)
+                    })
+                }
+
+                fn repeated_extend_from_slice(
+                    mut f: Mut<Repeated<$t>>,
+                    vals: &[View<'_, $t>],
+                ) -> bool {
+                    let len = f.len();
+                    let arena = f.raw_arena(Private);
+                    // SAFETY:
+                    // - `upb_Array_Resize` is unsafe but assumed to be always sound to call.
+                    // - After the resize, the array has room for `vals` after its first
+                    //   `len` elements, and `vals` can't alias the array, which is
+                    //   borrowed mutably.
+                    unsafe {
+                        if (!upb_Array_Resize(f.as_raw(Private), len + vals.len(), arena)) {
+                            panic!("upb_Array_Resize failed.");
+                        }
+                        ptr::copy_nonoverlapping(
+                          vals.as_ptr(),
+                          upb_Array_MutableDataPtr(f.as_raw(Private)).cast::<$t>().add(len),
+                          vals.len());
+                    }
+                    true
+                }
             }
         )*
     }
@@ -15,6 +15,7 @@ pub enum EncodeStatus {
     OutOfMemory = 1,
     MaxDepthExceeded = 2,
     MissingRequired = 3,
+    BufferTooSmall = 4,
 }
 // LINT.ThenChange()
 
@@ -39,6 +40,7 @@ enum DecodeOption {
     CheckRequired = 2,
     ExperimentalAllowUnlinked = 4,
     AlwaysValidateUtf8 = 8,
+    ReuseStorage = 16,
 }
 
 /// If Err, then EncodeStatus != Ok.
@@ -67,6 +69,57 @@ pub unsafe fn encode(
     }
 }
 
+/// Appends the encoding of `msg` to `out`. If Err, then EncodeStatus != Ok and
+/// `out` is unchanged.
+///
+/// The message is first encoded straight into the spare capacity of `out`, so
+/// reusing a buffer across messages avoids allocating for each of them. Only
+/// when the spare capacity is too small is the message encoded into an arena
+/// and copied, after which `out` has room for it next time.
+///
+/// # Safety
+/// - `msg` must be associated with `mini_table`.
+pub unsafe fn encode_into(
+    msg: RawMessage,
+    mini_table: *const upb_MiniTable,
+    out: &mut Vec<u8>,
+) -> Result<(), EncodeStatus> {
+    let spare = out.spare_capacity_mut();
+    let mut len = 0usize;
+
+    // SAFETY:
+    // - `mini_table` is the one associated with `msg`.
+    // - `spare` is legally writable for `spare.len()` bytes.
+    let status = unsafe {
+        upb_EncodeToBuffer(msg, mini_table, 0, spare.as_mut_ptr().cast(), spare.len(), &mut len)
+    };
+    match status {
+        EncodeStatus::Ok => {
+            // SAFETY: upb initialized the first `len` bytes of the spare capacity.
+            unsafe { out.set_len(out.len() + len) };
+            Ok(())
+        }
+        EncodeStatus::BufferTooSmall => {
+            let arena = Arena::new();
+            let mut buf: *mut u8 = core::ptr::null_mut();
+
+            // SAFETY:
+            // - `mini_table` is the one associated with `msg`.
+            // - `buf` and `buf_size` are legally writable.
+            let status =
+                unsafe { upb_Encode(msg, mini_table, 0, arena.raw(), &mut buf, &mut len) };
+            if status != EncodeStatus::Ok {
+                return Err(status);
+            }
+            assert!(!buf.is_null()); // EncodeStatus Ok should never return NULL data, even for len=0.
+            // SAFETY: upb guarantees that `buf` is valid to read for `len`.
+            out.extend_from_slice(unsafe { &*core::ptr::slice_from_raw_parts(buf, len) });
+            Ok(())
+        }
+        _ => Err(status),
+    }
+}
+
 /// Decodes into the provided message (merge semantics). If Err, then
 /// DecodeStatus != Ok.
 ///
@@ -108,6 +161,18 @@ extern "C" {
         buf_size: *mut usize,
     ) -> EncodeStatus;
 
+    // SAFETY:
+    // - `mini_table` is the one associated with `msg`
+    // - `buf` is legally writable for `capacity` bytes.
+    pub fn upb_EncodeToBuffer(
+        msg: RawMessage,
+        mini_table: *const upb_MiniTable,
+        options: i32,
+        buf: *mut u8,
+        capacity: usize,
+        size: *mut usize,
+    ) -> EncodeStatus;
+
     // SAFETY:
     // - `mini_table` is the one associated with `msg`
     // - `buf` is legally readable for at least `buf_size` bytes.
@@ -132,6 +197,7 @@ mod tests {
     fn assert_wire_linked() {
         use crate::assert_linked;
         assert_linked!(upb_Encode);
+        assert_linked!(upb_EncodeToBuffer);
         assert_linked!(upb_Decode);
     }
 }
@@ -205,6 +205,9 @@ constexpr auto Any::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(Any),
                                             alignof(Any));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Any_reflection_data_;
+
 constexpr auto Any::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -224,6 +227,7 @@ constexpr auto Any::InternalGenerateClassData_() {
       },
       &Any::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fany_2eproto,
+      &Any_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -350,6 +354,13 @@ PROTOBUF_NOINLINE void Any::Clear() {
 ::size_t Any::ByteSizeLong() const {
   const Any& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t Any::UncachedByteSizeLong() const {
+  const Any& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.Any)
   ::size_t total_size = 0;
 
@@ -375,8 +386,11 @@ PROTOBUF_NOINLINE void Any::Clear() {
       }
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void Any::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -48,7 +48,11 @@ bool InternalPackFromLite(const MessageLite& message,
                           absl::string_view type_url_prefix,
                           absl::string_view type_name, UrlType* dst_url,
                           ValueType* dst_value) {
-  *dst_url = GetTypeUrl(type_name, type_url_prefix);
+  // Build the URL in place, so that packing into the same Any again reuses
+  // its buffer, as SerializeToString() does for the value.
+  dst_url->assign(type_url_prefix.data(), type_url_prefix.size());
+  if (dst_url->empty() || dst_url->back() != '/') dst_url->push_back('/');
+  dst_url->append(type_name.data(), type_name.size());
   return message.SerializeToString(dst_value);
 }
 
@@ -100,6 +100,24 @@ TEST(AnyTest, TestPackWithCustomTypeUrl) {
   EXPECT_EQ(12345, submessage.int32_value());
 }
 
+TEST(AnyTest, TestRepackReplacesTypeUrlAndValue) {
+  proto2_unittest::TestAny submessage;
+  submessage.set_text(std::string(100, 'a'));
+  google::protobuf::Any any;
+  ASSERT_TRUE(any.PackFrom(submessage, "type.myservice.com/with/a/long/path"));
+
+  proto2_unittest::TestAllTypes payload;
+  payload.set_optional_int32(17);
+  ASSERT_TRUE(any.PackFrom(payload));
+  EXPECT_EQ("type.googleapis.com/proto2_unittest.TestAllTypes",
+            any.type_url());
+  EXPECT_EQ(payload.SerializeAsString(), any.value());
+  EXPECT_FALSE(any.UnpackTo(&submessage));
+  proto2_unittest::TestAllTypes unpacked;
+  ASSERT_TRUE(any.UnpackTo(&unpacked));
+  EXPECT_EQ(17, unpacked.optional_int32());
+}
+
 TEST(AnyTest, TestIs) {
   proto2_unittest::TestAny submessage;
   submessage.set_int32_value(12345);
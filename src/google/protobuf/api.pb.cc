@@ -375,6 +375,9 @@ constexpr auto Api::InternalNewImpl_() {
                                  alignof(Api));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Api_reflection_data_;
+
 constexpr auto Api::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -394,6 +397,7 @@ constexpr auto Api::InternalGenerateClassData_() {
       },
       &Api::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fapi_2eproto,
+      &Api_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -577,7 +581,8 @@ PROTOBUF_NOINLINE void Api::Clear() {
   // .google.protobuf.SourceContext source_context = 5;
   if ((cached_has_bits & 0x00000004u) != 0) {
     target = ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
-        5, *this_._impl_.source_context_, this_._impl_.source_context_->GetCachedSize(), target,
+        5, *this_._impl_.source_context_,
+        static_cast<int>(this_._impl_.source_context_->UncachedByteSizeLong()), target,
         stream);
   }
 
@@ -586,10 +591,10 @@ PROTOBUF_NOINLINE void Api::Clear() {
                            this_._internal_mixins_size());
        i < n; i++) {
     const auto& repfield = this_._internal_mixins().Get(i);
-    target =
-        ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
-            6, repfield, repfield.GetCachedSize(),
-            target, stream);
+    target = ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
+        6, repfield,
+        static_cast<int>(repfield.UncachedByteSizeLong()),
+        target, stream);
   }
 
   // .google.protobuf.Syntax syntax = 7;
@@ -644,7 +649,7 @@ PROTOBUF_NOINLINE void Api::Clear() {
     {
       total_size += 1UL * this_._internal_mixins_size();
       for (const auto& msg : this_._internal_mixins()) {
-        total_size += ::google::protobuf::internal::WireFormatLite::MessageSize(msg);
+        total_size += ::google::protobuf::internal::WireFormatLite::UncachedMessageSize(msg);
       }
     }
   }
@@ -667,7 +672,7 @@ PROTOBUF_NOINLINE void Api::Clear() {
     // .google.protobuf.SourceContext source_context = 5;
     if ((cached_has_bits & 0x00000004u) != 0) {
       total_size += 1 +
-                    ::google::protobuf::internal::WireFormatLite::MessageSize(*this_._impl_.source_context_);
+                    ::google::protobuf::internal::WireFormatLite::UncachedMessageSize(*this_._impl_.source_context_);
     }
     // .google.protobuf.Syntax syntax = 7;
     if ((cached_has_bits & 0x00000008u) != 0) {
@@ -874,6 +879,9 @@ constexpr auto Method::InternalNewImpl_() {
                                  alignof(Method));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Method_reflection_data_;
+
 constexpr auto Method::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -893,6 +901,7 @@ constexpr auto Method::InternalGenerateClassData_() {
       },
       &Method::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fapi_2eproto,
+      &Method_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -1341,6 +1350,9 @@ constexpr auto Mixin::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(Mixin),
                                             alignof(Mixin));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Mixin_reflection_data_;
+
 constexpr auto Mixin::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -1360,6 +1372,7 @@ constexpr auto Mixin::InternalGenerateClassData_() {
       },
       &Mixin::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fapi_2eproto,
+      &Mixin_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -1489,6 +1502,13 @@ PROTOBUF_NOINLINE void Mixin::Clear() {
 ::size_t Mixin::ByteSizeLong() const {
   const Mixin& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t Mixin::UncachedByteSizeLong() const {
+  const Mixin& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.Mixin)
   ::size_t total_size = 0;
 
@@ -1514,8 +1534,11 @@ PROTOBUF_NOINLINE void Mixin::Clear() {
       }
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void Mixin::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -11,10 +11,18 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <limits>
+#include <new>
 #include <string>
 #include <vector>
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include "absl/base/attributes.h"
 #include "absl/base/dynamic_annotations.h"
 #include "absl/base/optimization.h"
@@ -69,25 +77,157 @@ inline size_t AllocationSize(size_t last_size, size_t start_size,
   return std::min(2 * last_size, max_size);
 }
 
-SizedPtr AllocateMemory(const AllocationPolicy& policy, size_t size) {
+// Blocks released by arenas with `max_thread_cached_bytes` set are kept here,
+// per thread, so that arenas created and destroyed in quick succession on the
+// same thread reuse memory instead of going back to the system allocator.
+// Only blocks obtained from AllocateAtLeast are ever cached.
+class ThreadBlockCache {
+ public:
+  ThreadBlockCache() = default;
+  ThreadBlockCache(const ThreadBlockCache&) = delete;
+  ThreadBlockCache& operator=(const ThreadBlockCache&) = delete;
+
+  ~ThreadBlockCache() {
+    // Arenas destroyed later during thread exit must not use the cache.
+    alive_ = false;
+    while (head_ != nullptr) {
+      Node* node = head_;
+      head_ = node->next;
+      internal::SizedDelete(node, node->size);
+    }
+  }
+
+  static ThreadBlockCache& Get() {
+    static thread_local ThreadBlockCache cache;
+    return cache;
+  }
+
+  // Returns the smallest cached block of at least `size` bytes, or
+  // {nullptr, 0} if there is none.
+  SizedPtr Take(size_t size) {
+    Node** best = nullptr;
+    for (Node** it = &head_; *it != nullptr; it = &(*it)->next) {
+      if ((*it)->size < size) continue;
+      if (best == nullptr || (*it)->size < (*best)->size) {
+        best = it;
+        if ((*it)->size == size) break;
+      }
+    }
+    if (best == nullptr) return {nullptr, 0};
+    Node* node = *best;
+    *best = node->next;
+    bytes_ -= node->size;
+    SizedPtr mem = {node, node->size};
+    ABSL_ANNOTATE_MEMORY_IS_UNINITIALIZED(mem.p, mem.n);
+    return mem;
+  }
+
+  // Caches `mem` if that keeps the cache within `max_bytes`.
+  bool Put(SizedPtr mem, size_t max_bytes) {
+    if (!alive_ || mem.n < sizeof(Node) || bytes_ > max_bytes ||
+        mem.n > max_bytes - bytes_) {
+      return false;
+    }
+    head_ = new (mem.p) Node{head_, mem.n};
+    bytes_ += mem.n;
+    return true;
+  }
+
+ private:
+  struct Node {
+    Node* next;
+    size_t size;
+  };
+
+  Node* head_ = nullptr;
+  size_t bytes_ = 0;
+  bool alive_ = true;
+};
+
+constexpr size_t kHugePageSize = size_t{2} << 20;
+constexpr size_t kSmallPageSize = size_t{4} << 10;
+
+// Returns the alignment of placed blocks of `size` bytes, or 0 if such a block
+// is allocated and freed as usual.
+size_t PlacedBlockAlignment(ArenaBlockPlacement placement, size_t size) {
+  switch (placement) {
+    case ArenaBlockPlacement::kHugePages:
+      return size >= kHugePageSize ? kHugePageSize : 0;
+    case ArenaBlockPlacement::kNumaLocal:
+      return size >= kSmallPageSize ? kSmallPageSize : 0;
+    case ArenaBlockPlacement::kDefault:
+      break;
+  }
+  return 0;
+}
+
+// Asks the OS to apply `placement` to the whole pages of the block at `p`,
+// which is aligned to at least a page. Returns false if that is not supported.
+bool ApplyBlockPlacement(ArenaBlockPlacement placement, void* p, size_t size) {
+#if defined(__linux__)
+  const size_t length = size & ~(kSmallPageSize - 1);
+  if (placement == ArenaBlockPlacement::kHugePages) {
+#if defined(MADV_HUGEPAGE)
+    return madvise(p, length, MADV_HUGEPAGE) == 0;
+#endif
+  } else if (placement == ArenaBlockPlacement::kNumaLocal) {
+#if defined(SYS_mbind)
+    // Values from <linux/mempolicy.h>, which we avoid depending on.
+    constexpr int kMpolLocal = 4;
+    constexpr unsigned kMpolMfMove = 1 << 1;
+    return syscall(SYS_mbind, p, length, kMpolLocal, nullptr, 0,
+                   kMpolMfMove) == 0;
+#endif
+  }
+#endif  // __linux__
+  (void)placement;
+  (void)p;
+  (void)size;
+  return false;
+}
+
+SizedPtr AllocateMemory(const AllocationPolicy& policy, size_t size,
+                        ThreadSafeArenaStats* stats = nullptr) {
   if (policy.block_alloc == nullptr) {
+    if (policy.UsesBlockPlacement()) {
+      if (size_t alignment =
+              PlacedBlockAlignment(policy.block_placement, size)) {
+        void* p = ::operator new(size, std::align_val_t{alignment});
+        ThreadSafeArenaStats::RecordBlockPlacementStats(
+            stats, policy.block_placement == ArenaBlockPlacement::kHugePages,
+            ApplyBlockPlacement(policy.block_placement, p, size));
+        return {p, size};
+      }
+    }
+    if (policy.UsesThreadBlockCache()) {
+      SizedPtr mem = ThreadBlockCache::Get().Take(size);
+      ThreadSafeArenaStats::RecordBlockCacheStats(stats, mem.p != nullptr);
+      if (mem.p != nullptr) return mem;
+    }
     return AllocateAtLeast(size);
   }
   return {policy.block_alloc(size), size};
 }
 
-SizedPtr AllocateBlock(const AllocationPolicy* policy_ptr, size_t last_size,
-                       size_t min_bytes) {
-  AllocationPolicy policy;  // default policy
-  if (policy_ptr) policy = *policy_ptr;
+// Returns the size of the block following one of `last_size` bytes, which
+// must fit `min_bytes` after the block header.
+size_t BlockSize(const AllocationPolicy& policy, size_t last_size,
+                 size_t min_bytes) {
   size_t size =
       AllocationSize(last_size, policy.start_block_size, policy.max_block_size);
   // Verify that min_bytes + kBlockHeaderSize won't overflow.
   ABSL_CHECK_LE(min_bytes, std::numeric_limits<size_t>::max() -
                                SerialArena::kBlockHeaderSize);
-  size = std::max(size, SerialArena::kBlockHeaderSize + min_bytes);
+  return std::max(size, SerialArena::kBlockHeaderSize + min_bytes);
+}
 
-  return AllocateMemory(policy, size);
+SizedPtr AllocateBlock(const AllocationPolicy* policy_ptr, size_t last_size,
+                       size_t min_bytes,
+                       ThreadSafeArenaStats* stats = nullptr) {
+  AllocationPolicy policy;  // default policy
+  if (policy_ptr) policy = *policy_ptr;
+  return AllocateMemory(policy, BlockSize(policy, last_size, min_bytes),
+                        stats);
 }
 
 SizedPtr AllocateCleanupChunk(const AllocationPolicy* policy_ptr,
@@ -104,18 +244,29 @@ SizedPtr AllocateCleanupChunk(const AllocationPolicy* policy_ptr,
 class GetDeallocator {
  public:
   explicit GetDeallocator(const AllocationPolicy* policy)
-      : dealloc_(policy ? policy->block_dealloc : nullptr) {}
+      : dealloc_(policy ? policy->block_dealloc : nullptr),
+        max_thread_cached_bytes_(policy && policy->UsesThreadBlockCache()
+                                     ? policy->max_thread_cached_bytes
+                                     : 0),
+        placement_(policy && policy->UsesBlockPlacement()
+                       ? policy->block_placement
+                       : ArenaBlockPlacement::kDefault) {}
 
   void operator()(SizedPtr mem) const {
     if (dealloc_) {
       dealloc_(mem.p, mem.n);
-    } else {
+    } else if (size_t alignment = PlacedBlockAlignment(placement_, mem.n)) {
+      ::operator delete(mem.p, std::align_val_t{alignment});
+    } else if (max_thread_cached_bytes_ == 0 ||
+               !ThreadBlockCache::Get().Put(mem, max_thread_cached_bytes_)) {
       internal::SizedDelete(mem.p, mem.n);
     }
   }
 
  private:
   void (*dealloc_)(void*, size_t);
+  size_t max_thread_cached_bytes_;
+  ArenaBlockPlacement placement_;
 };
 
 }  // namespace
@@ -328,7 +479,7 @@ void SerialArena::AllocateNewBlock(size_t n) {
   // but with a CPU regression. The regression might have been an artifact of
   // the microbenchmark.
 
-  auto mem = AllocateBlock(parent_.AllocPolicy(), old_head->size, n);
+  auto mem = parent_.AllocateBlockForSerialArena(old_head->size, n);
   AddSpaceAllocated(mem.n);
   ThreadSafeArenaStats::RecordAllocateStats(parent_.arena_stats_.MutableStats(),
                                             /*used=*/used,
@@ -551,6 +702,39 @@ ThreadSafeArena::SerialArenaChunk* ThreadSafeArena::SentrySerialArenaChunk() {
 
 alignas(kCacheAlignment) ABSL_CONST_INIT
     std::atomic<ThreadSafeArena::LifecycleId> ThreadSafeArena::lifecycle_id_{0};
+
+namespace {
+
+// A small direct-mapped, per-thread map from arena lifecycle id to this
+// thread's SerialArena in that arena. ThreadCache only remembers the last
+// arena used; this lets threads that alternate between a few arenas find their
+// SerialArena without walking the arena's SerialArenaChunk list, whose length
+// grows with the number of threads using the arena. Entries of destroyed or
+// reset arenas never match again as lifecycle ids are not reused.
+struct SerialArenaLookupEntry {
+  uint64_t lifecycle_id;
+  SerialArena* serial;
+};
+constexpr size_t kSerialArenaLookupSize = 16;
+
+#if defined(PROTOBUF_NO_THREADLOCAL)
+SerialArenaLookupEntry* SerialArenaLookup(uint64_t) { return nullptr; }
+#else
+PROTOBUF_CONSTINIT PROTOBUF_THREAD_LOCAL SerialArenaLookupEntry
+    serial_arena_lookup[kSerialArenaLookupSize] = {};
+
+SerialArenaLookupEntry* SerialArenaLookup(uint64_t lifecycle_id) {
+  // Lifecycle ids are handed out in per-thread batches, so mix the bits
+  // before picking a slot.
+  const size_t index = static_cast<size_t>(
+      (lifecycle_id * uint64_t{0x9E3779B97F4A7C15}) >> 60);
+  static_assert(kSerialArenaLookupSize == 16, "index uses the top 4 bits");
+  return &serial_arena_lookup[index];
+}
+#endif
+
+}  // namespace
+
 #if defined(PROTOBUF_NO_THREADLOCAL)
 ThreadSafeArena::ThreadCache& ThreadSafeArena::thread_cache() {
   static internal::ThreadLocalStorage<ThreadCache>* thread_cache_ =
@@ -758,8 +942,9 @@ ThreadSafeArena::~ThreadSafeArena() {
   // Have to do this in a first pass, because some of the destructors might
   // refer to memory in other blocks.
   CleanupList();
+  FreeRetainedBlocks();
 
-  auto mem = Free();
+  auto mem = Free(GetDeallocator(alloc_policy_.get()));
   if (alloc_policy_.is_user_owned_initial_block()) {
     // Unpoison the initial block, now that it's going back to the user.
     internal::UnpoisonMemoryRegion(mem.p, mem.n);
@@ -768,9 +953,87 @@ ThreadSafeArena::~ThreadSafeArena() {
   }
 }
 
-SizedPtr ThreadSafeArena::Free() {
-  auto deallocator = GetDeallocator(alloc_policy_.get());
+// Blocks retained by Reset() are linked through a header written over the
+// start of each block.
+struct ThreadSafeArena::RetainedBlock {
+  RetainedBlock* next;
+  size_t size;
+};
+
+// Deallocator used by Reset() that keeps blocks, up to a byte budget, on a
+// list for reuse and frees the others.
+class ThreadSafeArena::RetainingDeallocator {
+ public:
+  RetainingDeallocator(const AllocationPolicy* policy, RetainedBlock* retained)
+      : deallocator_(policy),
+        budget_(policy ? policy->max_retained_bytes_on_reset : 0) {
+    // Blocks that were retained by a previous Reset() and not reused since
+    // count towards the budget again.
+    while (retained != nullptr) {
+      RetainedBlock* next = retained->next;
+      (*this)({retained, retained->size});
+      retained = next;
+    }
+  }
+
+  void operator()(SizedPtr mem) {
+    if (mem.n < sizeof(RetainedBlock) || mem.n > budget_) {
+      deallocator_(mem);
+      return;
+    }
+    budget_ -= mem.n;
+    head_ = new (mem.p) RetainedBlock{head_, mem.n};
+  }
+
+  RetainedBlock* retained() const { return head_; }
+
+ private:
+  GetDeallocator deallocator_;
+  size_t budget_;
+  RetainedBlock* head_ = nullptr;
+};
+
+SizedPtr ThreadSafeArena::AllocateBlockForSerialArena(size_t last_size,
+                                                      size_t min_bytes) {
+  if (ABSL_PREDICT_FALSE(retained_blocks_.load(std::memory_order_relaxed) !=
+                         nullptr)) {
+    AllocationPolicy policy;  // default policy
+    if (AllocPolicy()) policy = *AllocPolicy();
+    const size_t size = BlockSize(policy, last_size, min_bytes);
+
+    // Take the smallest retained block that is big enough.
+    absl::MutexLock lock(&mutex_);
+    RetainedBlock* head = retained_blocks_.load(std::memory_order_relaxed);
+    RetainedBlock** best = nullptr;
+    for (RetainedBlock** it = &head; *it != nullptr; it = &(*it)->next) {
+      if ((*it)->size < size) continue;
+      if (best == nullptr || (*it)->size < (*best)->size) best = it;
+    }
+    if (best != nullptr) {
+      RetainedBlock* block = *best;
+      *best = block->next;
+      retained_blocks_.store(head, std::memory_order_relaxed);
+      SizedPtr mem = {block, block->size};
+      ABSL_ANNOTATE_MEMORY_IS_UNINITIALIZED(mem.p, mem.n);
+      return mem;
+    }
+  }
+  return AllocateBlock(AllocPolicy(), last_size, min_bytes,
+                       arena_stats_.MutableStats());
+}
+
+void ThreadSafeArena::FreeRetainedBlocks() {
+  GetDeallocator deallocator(alloc_policy_.get());
+  RetainedBlock* block = retained_blocks_.exchange(nullptr);
+  while (block != nullptr) {
+    RetainedBlock* next = block->next;
+    deallocator({block, block->size});
+    block = next;
+  }
+}
 
+template <typename Deallocator>
+SizedPtr ThreadSafeArena::Free(Deallocator deallocator) {
   WalkSerialArenaChunk([&](SerialArenaChunk* chunk) {
     absl::Span<std::atomic<SerialArena*>> span = chunk->arenas();
     // Walks arenas backward to handle the first serial arena the last. Freeing
@@ -804,8 +1067,13 @@ uint64_t ThreadSafeArena::Reset() {
   first_arena_.cleanup_list_ = cleanup::ChunkList();
 
   // Discard all blocks except the first one. Whether it is user-provided or
-  // allocated, always reuse the first block for the first arena.
-  auto mem = Free();
+  // allocated, always reuse the first block for the first arena. Other blocks
+  // are kept for reuse if the policy allows it.
+  RetainingDeallocator deallocator(
+      alloc_policy_.get(),
+      retained_blocks_.exchange(nullptr, std::memory_order_relaxed));
+  auto mem = Free(std::ref(deallocator));
+  retained_blocks_.store(deallocator.retained(), std::memory_order_relaxed);
 
   // Reset the first arena with the first block. This avoids redundant
   // free / allocation and re-allocating for AllocationPolicy. Adjust offset if
@@ -965,6 +1233,14 @@ SerialArena* ThreadSafeArena::GetSerialArenaFallback(size_t n) {
     return &first_arena_;
   }
 
+  SerialArenaLookupEntry* lookup = SerialArenaLookup(tag_and_id_);
+  // Empty entries have a null `serial`; lifecycle id 0 is a valid id.
+  if (lookup != nullptr && lookup->serial != nullptr &&
+      lookup->lifecycle_id == tag_and_id_) {
+    CacheSerialArena(lookup->serial);
+    return lookup->serial;
+  }
+
   // Search matching SerialArena.
   SerialArena* serial = nullptr;
   WalkConstSerialArenaChunk([&serial, id](const SerialArenaChunk* chunk) {
@@ -982,26 +1258,39 @@ SerialArena* ThreadSafeArena::GetSerialArenaFallback(size_t n) {
     // This thread doesn't have any SerialArena, which also means it doesn't
     // have any blocks yet.  So we'll allocate its first block now. It must be
     // big enough to host SerialArena and the pending request.
-    serial = SerialArena::New(
-        AllocateBlock(alloc_policy_.get(), 0, n + kSerialArenaSize), *this);
+    serial =
+        SerialArena::New(AllocateBlockForSerialArena(0, n + kSerialArenaSize),
+                         *this);
 
     AddSerialArena(id, serial);
   }
 
+  if (lookup != nullptr) *lookup = {tag_and_id_, serial};
   CacheSerialArena(serial);
   return serial;
 }
 
 }  // namespace internal
 
-void* Arena::Allocate(size_t n) { return impl_.AllocateAligned(n); }
+void* Arena::Allocate(size_t n) {
+#if defined(PROTOBUF_ARENA_TRACE)
+  internal::RecordArenaAllocation(this, n);
+#endif  // PROTOBUF_ARENA_TRACE
+  return impl_.AllocateAligned(n);
+}
 
 void* Arena::AllocateForArray(size_t n) {
+#if defined(PROTOBUF_ARENA_TRACE)
+  internal::RecordArenaAllocation(this, n);
+#endif  // PROTOBUF_ARENA_TRACE
   return impl_.AllocateAligned<internal::AllocationClient::kArray>(n);
 }
 
 void* Arena::AllocateAlignedWithCleanup(size_t n, size_t align,
                                         void (*destructor)(void*)) {
+#if defined(PROTOBUF_ARENA_TRACE)
+  internal::RecordArenaAllocation(this, n);
+#endif  // PROTOBUF_ARENA_TRACE
   return impl_.AllocateAlignedWithCleanup(n, align, destructor);
 }
 
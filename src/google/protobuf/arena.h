@@ -13,6 +13,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <memory>
 #include <new>  // IWYU pragma: keep for operator new().
 #include <string>
 #include <type_traits>
@@ -35,6 +36,7 @@ using type_info = ::type_info;
 #include "absl/utility/internal/if_constexpr.h"
 #include "google/protobuf/arena_align.h"
 #include "google/protobuf/arena_allocation_policy.h"
+#include "google/protobuf/arena_trace.h"
 #include "google/protobuf/port.h"
 #include "google/protobuf/serial_arena.h"
 #include "google/protobuf/thread_safe_arena.h"
@@ -55,6 +57,9 @@ class Message;  // defined in message.h
 class MessageLite;
 template <typename Key, typename T>
 class Map;
+class ArenaMemoryResource;  // defined in arena_memory_resource.h
+template <typename T>
+class ArenaAllocator;  // defined in arena_memory_resource.h
 namespace internal {
 struct RepeatedFieldBase;
 class ExtensionSet;
@@ -137,6 +142,29 @@ struct ArenaOptions {
   // calls free.
   void (*block_dealloc)(void*, size_t) = nullptr;
 
+  // If non-zero, blocks freed by this arena are kept in a cache owned by the
+  // freeing thread, up to this many bytes in total, instead of being returned
+  // to the system allocator. Arenas created on that thread with this option
+  // set reuse cached blocks, including for their initial block. This is
+  // useful when arenas are short-lived, e.g. one per request. The cache is
+  // released when the thread exits. Ignored if `block_alloc` or
+  // `block_dealloc` is set.
+  size_t max_thread_cached_bytes = 0;
+
+  // If non-zero, `Reset()` keeps blocks, up to this many bytes in total on top
+  // of the first block, and the arena reuses them before allocating new ones.
+  // Arenas that are reset after every unit of work thus settle at a steady
+  // footprint without allocator traffic. Retained blocks are freed when the
+  // arena is destroyed.
+  size_t max_retained_bytes_on_reset = 0;
+
+  // Selects a built-in placement strategy for large blocks, e.g. transparent
+  // huge pages or NUMA-local memory. See `internal::ArenaBlockPlacement`.
+  // Ignored if `block_alloc` or `block_dealloc` is set. Huge pages only help
+  // if `max_block_size` allows blocks of at least 2 MiB.
+  using BlockPlacement = internal::ArenaBlockPlacement;
+  BlockPlacement block_placement = BlockPlacement::kDefault;
+
  private:
   internal::AllocationPolicy AllocationPolicy() const {
     internal::AllocationPolicy res;
@@ -144,6 +172,9 @@ struct ArenaOptions {
     res.max_block_size = max_block_size;
     res.block_alloc = block_alloc;
     res.block_dealloc = block_dealloc;
+    res.max_thread_cached_bytes = max_thread_cached_bytes;
+    res.max_retained_bytes_on_reset = max_retained_bytes_on_reset;
+    res.block_placement = block_placement;
     return res;
   }
 
@@ -195,6 +226,7 @@ class PROTOBUF_EXPORT PROTOBUF_ALIGNAS(8) Arena final {
   // otherwise, returns a heap-allocated object.
   template <typename T, typename... Args>
   PROTOBUF_NDEBUG_INLINE static T* Create(Arena* arena, Args&&... args) {
+    PROTOBUF_ARENA_TRACE_SCOPE(internal::ArenaTraceTypeLabel<T>());
     return absl::utility_internal::IfConstexprElse<
         is_arena_constructable<T>::value>(
         // Arena-constructable
@@ -274,6 +306,7 @@ class PROTOBUF_EXPORT PROTOBUF_ALIGNAS(8) Arena final {
     if (ABSL_PREDICT_FALSE(arena == nullptr)) {
       return new T[num_elements];
     } else {
+      PROTOBUF_ARENA_TRACE_SCOPE(internal::ArenaTraceTypeLabel<T>());
       // We count on compiler to realize that if sizeof(T) is a multiple of
       // 8 AlignUpTo can be elided.
       return static_cast<T*>(
@@ -318,6 +351,13 @@ class PROTOBUF_EXPORT PROTOBUF_ALIGNAS(8) Arena final {
     }
   }
 
+  // Transfers ownership of |arena| to this arena: |arena|, and everything
+  // allocated on it, is destroyed when this arena is destroyed or reset. A
+  // message on |arena| can then be handed to the users of this arena in O(1),
+  // instead of being copied onto it. The message still lives on |arena|, so
+  // Swap() and moves between it and messages on this arena still copy.
+  void Adopt(std::unique_ptr<Arena> arena) { Own(arena.release()); }
+
   // Adds |object| to a list of objects whose destructors will be manually
   // called when the arena is destroyed or reset. This differs from Own() in
   // that it does not free the underlying memory with |delete|; hence, it is
@@ -625,6 +665,9 @@ class PROTOBUF_EXPORT PROTOBUF_ALIGNAS(8) Arena final {
   friend class internal::RepeatedPtrFieldBase;  // For ReturnArrayMemory
   friend class internal::UntypedMapBase;        // For ReturnArrayMemory
   friend class internal::ExtensionSet;          // For ReturnArrayMemory
+  friend class ArenaMemoryResource;             // For ReturnArrayMemory
+  template <typename>
+  friend class ArenaAllocator;  // For ReturnArrayMemory
 
   friend struct internal::ArenaTestPeer;
 };
@@ -636,6 +679,7 @@ class PROTOBUF_EXPORT PROTOBUF_ALIGNAS(8) Arena final {
 template <typename T>
 PROTOBUF_NOINLINE void* Arena::DefaultConstruct(Arena* arena) {
   static_assert(is_destructor_skippable<T>::value, "");
+  PROTOBUF_ARENA_TRACE_SCOPE(internal::ArenaTraceTypeLabel<T>());
   void* mem = arena != nullptr ? arena->AllocateAligned(sizeof(T))
                                : ::operator new(sizeof(T));
   return new (mem) T(arena);
@@ -650,6 +694,7 @@ PROTOBUF_NOINLINE void* Arena::CopyConstruct(Arena* arena, const void* from) {
     PROTOBUF_PREFETCH_WITH_OFFSET(from, 64);
   }
   static_assert(is_destructor_skippable<T>::value, "");
+  PROTOBUF_ARENA_TRACE_SCOPE(internal::ArenaTraceTypeLabel<T>());
   void* mem = arena != nullptr ? arena->AllocateAligned(sizeof(T))
                                : ::operator new(sizeof(T));
   return new (mem) T(arena, *static_cast<const T*>(from));
@@ -15,6 +15,21 @@ namespace google {
 namespace protobuf {
 namespace internal {
 
+// Built-in placement strategies for arena blocks allocated with the default
+// allocation functions. They only apply to blocks that are at least one
+// (huge) page in size; smaller blocks are allocated as usual.
+enum class ArenaBlockPlacement : uint8_t {
+  // Blocks come from `::operator new`.
+  kDefault,
+  // Blocks of 2 MiB or more are 2 MiB aligned and, where supported
+  // (`madvise(MADV_HUGEPAGE)` on Linux), backed by transparent huge pages.
+  kHugePages,
+  // Blocks of a page or more are bound, where supported (`mbind(MPOL_LOCAL)`
+  // on Linux), to the NUMA node of the thread that first touches them, which
+  // is the thread allocating from that block.
+  kNumaLocal,
+};
+
 // `AllocationPolicy` defines `Arena` allocation policies. Applications can
 // customize the initial and maximum sizes for arena allocation, as well as set
 // custom allocation and deallocation functions. `AllocationPolicy` is for
@@ -30,10 +45,38 @@ struct AllocationPolicy {
   void* (*block_alloc)(size_t) = nullptr;
   void (*block_dealloc)(void*, size_t) = nullptr;
 
+  // Upper bound for the bytes of freed blocks kept in the per-thread block
+  // cache. Zero disables the cache.
+  size_t max_thread_cached_bytes = 0;
+
+  // Upper bound for the bytes of blocks kept by `Reset()` for reuse, in
+  // addition to the first block. Zero frees them.
+  size_t max_retained_bytes_on_reset = 0;
+
+  ArenaBlockPlacement block_placement = ArenaBlockPlacement::kDefault;
+
   bool IsDefault() const {
     return start_block_size == kDefaultStartBlockSize &&
            max_block_size == kDefaultMaxBlockSize && block_alloc == nullptr &&
-           block_dealloc == nullptr;
+           block_dealloc == nullptr && max_thread_cached_bytes == 0 &&
+           max_retained_bytes_on_reset == 0 &&
+           block_placement == ArenaBlockPlacement::kDefault;
+  }
+
+  // Block placement only applies with the default allocation functions.
+  bool UsesBlockPlacement() const {
+    return block_placement != ArenaBlockPlacement::kDefault &&
+           block_alloc == nullptr && block_dealloc == nullptr;
+  }
+
+  // The block cache is only used with the default allocation functions, as
+  // blocks from a user-provided allocator can only be returned to it. Placed
+  // blocks are not cached either, so that they are never handed to an arena
+  // with a different placement.
+  bool UsesThreadBlockCache() const {
+    return max_thread_cached_bytes != 0 && block_alloc == nullptr &&
+           block_dealloc == nullptr &&
+           block_placement == ArenaBlockPlacement::kDefault;
   }
 };
 
@@ -0,0 +1,40 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/arena_memory_resource.h"
+
+#include <cstddef>
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+
+#if defined(__cpp_lib_memory_resource)
+
+void* ArenaMemoryResource::do_allocate(size_t bytes, size_t alignment) {
+  return arena_->AllocateAlignedForArray(bytes, alignment);
+}
+
+void ArenaMemoryResource::do_deallocate(void* p, size_t bytes,
+                                        size_t /*alignment*/) {
+  // The arena only keeps blocks that can hold one of its free list nodes.
+  if (bytes >= 16) arena_->ReturnArrayMemory(p, bytes);
+}
+
+bool ArenaMemoryResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+#endif  // __cpp_lib_memory_resource
+
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
@@ -0,0 +1,113 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Adapters that let standard containers allocate from an Arena, so that the
+// temporary data built next to arena messages shares their lifetime:
+//
+//   Arena arena;
+//   ArenaMemoryResource resource(&arena);
+//   std::pmr::vector<std::pmr::string> names(&resource);
+//
+//   std::vector<int, ArenaAllocator<int>> ids(ArenaAllocator<int>(&arena));
+//
+// Memory that the containers give back, for example when a vector grows, is
+// kept by the arena for reuse by later array allocations, such as those of
+// repeated fields.  Nothing is returned to the heap before the arena is
+// destroyed, so the containers must not outlive it.
+
+#ifndef GOOGLE_PROTOBUF_ARENA_MEMORY_RESOURCE_H__
+#define GOOGLE_PROTOBUF_ARENA_MEMORY_RESOURCE_H__
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+#include "absl/log/absl_check.h"
+#include "google/protobuf/arena.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+
+#if defined(__cpp_lib_memory_resource)
+
+// A std::pmr::memory_resource that allocates from `arena`, which must outlive
+// it.  Deallocated blocks are kept by the arena for reuse.
+class PROTOBUF_EXPORT ArenaMemoryResource final
+    : public std::pmr::memory_resource {
+ public:
+  explicit ArenaMemoryResource(Arena* arena) : arena_(arena) {
+    ABSL_DCHECK(arena != nullptr);
+  }
+  ArenaMemoryResource(const ArenaMemoryResource&) = delete;
+  ArenaMemoryResource& operator=(const ArenaMemoryResource&) = delete;
+
+  Arena* arena() const { return arena_; }
+
+ private:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override;
+
+  Arena* arena_;
+};
+
+#endif  // __cpp_lib_memory_resource
+
+// A standard allocator that allocates from `arena`, or from the heap if
+// `arena` is null.  Deallocated arena blocks are kept by the arena for reuse.
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit ArenaAllocator(Arena* arena) : arena_(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other)  // NOLINT
+      : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    if (arena_ == nullptr) return std::allocator<T>().allocate(n);
+    ABSL_CHECK_LE(n, std::numeric_limits<size_t>::max() / sizeof(T));
+    return static_cast<T*>(
+        arena_->AllocateAlignedForArray(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* p, size_t n) {
+    if (arena_ == nullptr) return std::allocator<T>().deallocate(p, n);
+    // The arena only keeps blocks that can hold one of its free list nodes.
+    if (n * sizeof(T) >= 16) arena_->ReturnArrayMemory(p, n * sizeof(T));
+  }
+
+  Arena* arena() const { return arena_; }
+
+  template <typename U>
+  friend bool operator==(const ArenaAllocator& a, const ArenaAllocator<U>& b) {
+    return a.arena() == b.arena();
+  }
+  template <typename U>
+  friend bool operator!=(const ArenaAllocator& a, const ArenaAllocator<U>& b) {
+    return a.arena() != b.arena();
+  }
+
+ private:
+  Arena* arena_;
+};
+
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_ARENA_MEMORY_RESOURCE_H__
@@ -0,0 +1,144 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/arena_trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/base/optimization.h"
+#include "absl/functional/function_ref.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+
+#if defined(PROTOBUF_ARENA_TRACE)
+#include "absl/base/internal/raw_logging.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#endif  // PROTOBUF_ARENA_TRACE
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+#if defined(PROTOBUF_ARENA_TRACE)
+namespace {
+
+PROTOBUF_CONSTINIT std::atomic<int32_t> g_arena_trace_sample_rate{1};
+PROTOBUF_CONSTINIT std::atomic<ArenaTraceHandler> g_arena_trace_handler{
+    nullptr};
+// Number of allocations left before the next sample on this thread.
+PROTOBUF_THREAD_LOCAL int32_t arena_trace_countdown = 0;
+
+struct ArenaTraceRegistry {
+  absl::Mutex mu;
+  absl::flat_hash_map<std::string, ArenaTraceStats> stats ABSL_GUARDED_BY(mu);
+};
+
+ArenaTraceRegistry& GlobalArenaTraceRegistry() {
+  static auto* registry = new ArenaTraceRegistry();
+  return *registry;
+}
+
+}  // namespace
+
+PROTOBUF_THREAD_LOCAL const absl::string_view* arena_trace_label = nullptr;
+
+void RecordArenaAllocation(const Arena* arena, size_t bytes) {
+  if (ABSL_PREDICT_TRUE(--arena_trace_countdown > 0)) return;
+  const int32_t rate =
+      g_arena_trace_sample_rate.load(std::memory_order_relaxed);
+  arena_trace_countdown = rate;
+
+  const absl::string_view label =
+      arena_trace_label != nullptr ? *arena_trace_label : "<unattributed>";
+  {
+    ArenaTraceRegistry& registry = GlobalArenaTraceRegistry();
+    absl::MutexLock lock(&registry.mu);
+    auto it = registry.stats.find(label);
+    if (it == registry.stats.end()) {
+      it = registry.stats.emplace(std::string(label), ArenaTraceStats()).first;
+      it->second.label = it->first;
+    }
+    it->second.allocations += rate;
+    it->second.bytes += static_cast<uint64_t>(rate) * bytes;
+  }
+  ArenaTraceHandler handler =
+      g_arena_trace_handler.load(std::memory_order_acquire);
+  if (handler != nullptr) handler(arena, label, bytes);
+}
+
+void IterateArenaTrace(absl::FunctionRef<void(const ArenaTraceStats&)> f) {
+  std::vector<ArenaTraceStats> all;
+  {
+    ArenaTraceRegistry& registry = GlobalArenaTraceRegistry();
+    absl::MutexLock lock(&registry.mu);
+    all.reserve(registry.stats.size());
+    for (const auto& entry : registry.stats) all.push_back(entry.second);
+  }
+  // `f` runs without the lock held, so it may allocate from arenas.
+  for (const ArenaTraceStats& stats : all) f(stats);
+}
+
+void ResetArenaTrace() {
+  ArenaTraceRegistry& registry = GlobalArenaTraceRegistry();
+  absl::MutexLock lock(&registry.mu);
+  registry.stats.clear();
+}
+
+void SetArenaTraceHandler(ArenaTraceHandler handler) {
+  g_arena_trace_handler.store(handler, std::memory_order_release);
+}
+
+void SetArenaTraceSampleRate(int32_t rate) {
+  if (rate > 0) {
+    g_arena_trace_sample_rate.store(rate, std::memory_order_relaxed);
+  } else {
+    ABSL_RAW_LOG(ERROR, "Invalid arena trace sample rate: %lld",
+                 static_cast<long long>(rate));  // NOLINT(runtime/int)
+  }
+}
+
+#else   // PROTOBUF_ARENA_TRACE
+
+void IterateArenaTrace(absl::FunctionRef<void(const ArenaTraceStats&)>) {}
+void ResetArenaTrace() {}
+void SetArenaTraceHandler(ArenaTraceHandler) {}
+void SetArenaTraceSampleRate(int32_t) {}
+
+#endif  // PROTOBUF_ARENA_TRACE
+
+std::string ArenaTraceDebugString() {
+  std::vector<ArenaTraceStats> all;
+  IterateArenaTrace(
+      [&](const ArenaTraceStats& stats) { all.push_back(stats); });
+  std::sort(all.begin(), all.end(),
+            [](const ArenaTraceStats& a, const ArenaTraceStats& b) {
+              return a.bytes > b.bytes;
+            });
+  std::string out =
+      absl::StrFormat("%-48s %12s %14s\n", "label", "allocations", "bytes");
+  for (const ArenaTraceStats& stats : all) {
+    absl::StrAppendFormat(&out, "%-48s %12d %14d\n", stats.label,
+                          stats.allocations, stats.bytes);
+  }
+  return out;
+}
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
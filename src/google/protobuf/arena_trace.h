@@ -0,0 +1,120 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Attribution of arena allocations to the types that make them.
+//
+// When compiled with -DPROTOBUF_ARENA_TRACE, every allocation from an Arena is
+// attributed to a label: the message type for messages created by the runtime,
+// the container for the growth of repeated fields and maps, and the C++ type
+// for `Arena::Create<T>` and `Arena::CreateArray<T>`.  A sample of the
+// allocations is aggregated per label and optionally reported to a handler, in
+// the spirit of upb's `upb_Arena_SetTraceHandler`.  Otherwise the hooks, which
+// are spelled PROTOBUF_ARENA_TRACE_SCOPE(label), compile to nothing.
+
+#ifndef GOOGLE_PROTOBUF_ARENA_TRACE_H__
+#define GOOGLE_PROTOBUF_ARENA_TRACE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <typeinfo>
+
+#include "absl/functional/function_ref.h"
+#include "absl/strings/string_view.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+
+class Arena;
+
+namespace internal {
+
+struct ArenaTraceStats {
+  std::string label;
+  // Estimated number and size of the allocations, weighted by the sampling
+  // rate.
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+};
+
+// Called for every sampled allocation.  `bytes` is the size requested from the
+// arena, after alignment.  The handler must not allocate from an arena.
+using ArenaTraceHandler = void (*)(const Arena* arena, absl::string_view label,
+                                   size_t bytes);
+
+#if defined(PROTOBUF_ARENA_TRACE)
+
+extern PROTOBUF_THREAD_LOCAL const absl::string_view* arena_trace_label;
+
+// Attributes the arena allocations made in its scope to `label`, which must
+// outlive the scope.  Scopes nest with the outermost label winning, so that,
+// for instance, the array behind a growing repeated field is attributed to the
+// field and not to `char`, and a message copied with `Arena::Create<T>` is
+// attributed to `T` along with the copies of its fields.
+class ArenaTraceScope {
+ public:
+  explicit ArenaTraceScope(absl::string_view label) : label_(label) {
+    if (arena_trace_label == nullptr) {
+      arena_trace_label = &label_;
+      owner_ = true;
+    }
+  }
+  ~ArenaTraceScope() {
+    if (owner_) arena_trace_label = nullptr;
+  }
+
+  ArenaTraceScope(const ArenaTraceScope&) = delete;
+  ArenaTraceScope& operator=(const ArenaTraceScope&) = delete;
+
+ private:
+  absl::string_view label_;
+  bool owner_ = false;
+};
+
+// Returns the label of allocations made by `Arena::Create<T>`.
+template <typename T>
+absl::string_view ArenaTraceTypeLabel() {
+#if PROTOBUF_RTTI
+  return typeid(T).name();
+#else
+  return "<unknown type>";
+#endif
+}
+
+// Records an allocation of `bytes` from `arena`, under the current label.
+PROTOBUF_EXPORT void RecordArenaAllocation(const Arena* arena, size_t bytes);
+
+#endif  // PROTOBUF_ARENA_TRACE
+
+// Calls `f` with the stats of every label seen so far.  Does nothing unless
+// built with PROTOBUF_ARENA_TRACE.
+PROTOBUF_EXPORT void IterateArenaTrace(
+    absl::FunctionRef<void(const ArenaTraceStats&)> f);
+
+// Drops all the stats collected so far.
+PROTOBUF_EXPORT void ResetArenaTrace();
+
+// Returns a human readable table of the stats, largest labels first.
+PROTOBUF_EXPORT std::string ArenaTraceDebugString();
+
+// Sets the handler called for sampled allocations, or nullptr for none.
+PROTOBUF_EXPORT void SetArenaTraceHandler(ArenaTraceHandler handler);
+
+// Samples one in `rate` allocations.  Defaults to 1, that is to every
+// allocation.
+PROTOBUF_EXPORT void SetArenaTraceSampleRate(int32_t rate);
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_ARENA_TRACE_H__
@@ -32,6 +32,8 @@
 #include "absl/synchronization/barrier.h"
 #include "absl/utility/utility.h"
 #include "google/protobuf/arena_cleanup.h"
+#include "google/protobuf/arena_memory_resource.h"
+#include "google/protobuf/arena_trace.h"
 #include "google/protobuf/arena_test_util.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/extension_set.h"
@@ -279,6 +281,23 @@ TEST(ArenaTest, BasicCreate) {
   EXPECT_EQ(2, notifier.GetCount());
 }
 
+TEST(ArenaTest, Adopt) {
+  Notifier notifier;
+  Arena arena;
+  auto stage_arena = std::make_unique<Arena>();
+  auto* message =
+      Arena::Create<proto2_unittest::TestAllTypes>(stage_arena.get());
+  TestUtil::SetAllFields(message);
+  Arena::Create<SimpleDataType>(stage_arena.get())->SetNotifier(&notifier);
+  arena.Adopt(std::move(stage_arena));
+
+  // The message stays valid until the adopting arena is reset.
+  TestUtil::ExpectAllFieldsSet(*message);
+  EXPECT_EQ(0, notifier.GetCount());
+  arena.Reset();
+  EXPECT_EQ(1, notifier.GetCount());
+}
+
 TEST(ArenaTest, CreateAndConstCopy) {
   Arena arena;
   const std::string s("foo");
@@ -617,6 +636,41 @@ TEST(ArenaTest, Parsing) {
             strlen(arena_message->optional_string().c_str()));
 }
 
+TEST(ArenaTest, ParsingRepeatedMessagesAllocatesThemContiguously) {
+  TestAllTypes original;
+  for (int i = 0; i < 100; ++i) {
+    original.add_repeated_nested_message()->set_bb(i);
+  }
+  const std::string data = original.SerializeAsString();
+
+  Arena arena;
+  TestAllTypes* arena_message = Arena::Create<TestAllTypes>(&arena);
+  ASSERT_TRUE(arena_message->ParseFromString(data));
+  const auto& field = arena_message->repeated_nested_message();
+  ASSERT_EQ(field.size(), 100);
+  const auto stride = reinterpret_cast<const char*>(&field.Get(1)) -
+                      reinterpret_cast<const char*>(&field.Get(0));
+  EXPECT_GE(stride,
+            static_cast<ptrdiff_t>(sizeof(TestAllTypes::NestedMessage)));
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(field.Get(i).bb(), i);
+    if (i > 0) {
+      EXPECT_EQ(reinterpret_cast<const char*>(&field.Get(i)) -
+                    reinterpret_cast<const char*>(&field.Get(i - 1)),
+                stride);
+    }
+  }
+
+  // Merging appends after the existing elements.
+  ASSERT_TRUE(arena_message->MergeFromString(data));
+  ASSERT_EQ(field.size(), 200);
+  for (int i = 0; i < 200; ++i) EXPECT_EQ(field.Get(i).bb(), i % 100);
+
+  // A truncated run fails cleanly.
+  TestAllTypes* truncated = Arena::Create<TestAllTypes>(&arena);
+  EXPECT_FALSE(truncated->ParseFromString(data.substr(0, data.size() - 1)));
+}
+
 TEST(ArenaTest, UnknownFields) {
   TestAllTypes original;
   TestUtil::SetAllFields(&original);
@@ -1756,6 +1810,133 @@ TEST(ArenaTest, BlockSizeSmallerThanAllocation) {
   }
 }
 
+TEST(ArenaTest, ThreadBlockCacheReusesBlocks) {
+  if (!internal::HaveAllocateAtLeastHook()) {
+    GTEST_SKIP() << "Requires the AllocateAtLeast hook to count allocations.";
+  }
+  ArenaOptions options;
+  options.max_thread_cached_bytes = 1 << 20;
+  auto fill_arena = [&options] {
+    Arena arena(options);
+    for (int i = 0; i < 100; ++i) Arena::CreateArray<char>(&arena, 1000);
+    return arena.SpaceAllocated();
+  };
+
+  // The first arena populates this thread's cache when it is destroyed.
+  const uint64_t space_allocated = fill_arena();
+
+  int allocations = 0;
+  internal::SetAllocateAtLeastHook(
+      [](size_t size, void* context) {
+        ++*static_cast<int*>(context);
+        return internal::SizedPtr{::operator new(size), size};
+      },
+      &allocations);
+  EXPECT_EQ(fill_arena(), space_allocated);
+  internal::SetAllocateAtLeastHook(nullptr);
+
+  // All blocks of the second arena, including the one holding the allocation
+  // policy, came from the cache.
+  EXPECT_EQ(allocations, 0);
+}
+
+TEST(ArenaTest, ResetRetainsBlocks) {
+  if (!internal::HaveAllocateAtLeastHook()) {
+    GTEST_SKIP() << "Requires the AllocateAtLeast hook to count allocations.";
+  }
+  ArenaOptions options;
+  options.max_retained_bytes_on_reset = 1 << 20;
+  Arena arena(options);
+  auto fill_arena = [&arena] {
+    for (int i = 0; i < 100; ++i) Arena::CreateArray<char>(&arena, 1000);
+    return arena.SpaceAllocated();
+  };
+
+  const uint64_t space_allocated = fill_arena();
+  EXPECT_EQ(arena.Reset(), space_allocated);
+
+  int allocations = 0;
+  internal::SetAllocateAtLeastHook(
+      [](size_t size, void* context) {
+        ++*static_cast<int*>(context);
+        return internal::SizedPtr{::operator new(size), size};
+      },
+      &allocations);
+  EXPECT_EQ(fill_arena(), space_allocated);
+  EXPECT_EQ(arena.Reset(), space_allocated);
+  internal::SetAllocateAtLeastHook(nullptr);
+
+  EXPECT_EQ(allocations, 0);
+}
+
+TEST(ArenaTest, ResetRetainedBlocksAreNotCountedAsAllocated) {
+  ArenaOptions options;
+  options.start_block_size = 512;
+  Arena plain_arena(options);
+  options.max_retained_bytes_on_reset = 4096;
+  Arena retaining_arena(options);
+  for (Arena* arena : {&plain_arena, &retaining_arena}) {
+    for (int i = 0; i < 100; ++i) Arena::CreateArray<char>(arena, 1000);
+    arena->Reset();
+  }
+
+  // Only the first block, which holds the allocation policy, is accounted for
+  // until retained blocks are reused.
+  EXPECT_EQ(retaining_arena.SpaceAllocated(), plain_arena.SpaceAllocated());
+}
+
+TEST(ArenaTest, BlockPlacementAlignsLargeBlocks) {
+  struct Case {
+    ArenaOptions::BlockPlacement placement;
+    size_t alignment;
+  };
+  for (const Case& c :
+       {Case{ArenaOptions::BlockPlacement::kHugePages, size_t{2} << 20},
+        Case{ArenaOptions::BlockPlacement::kNumaLocal, size_t{4} << 10}}) {
+    ArenaOptions options;
+    options.block_placement = c.placement;
+    Arena arena(options);
+    // Small allocations are served from regular blocks.
+    *Arena::Create<int64_t>(&arena) = 42;
+
+    // A large allocation gets its own block, which starts right before it.
+    const size_t size = 3 * c.alignment;
+    char* p = Arena::CreateArray<char>(&arena, size);
+    memset(p, 0, size);
+    EXPECT_EQ((reinterpret_cast<uintptr_t>(p) -
+               internal::SerialArena::kBlockHeaderSize) %
+                  c.alignment,
+              0u);
+    EXPECT_GE(arena.SpaceAllocated(), size);
+  }
+}
+
+TEST(ArenaTest, ThreadAlternatingBetweenArenasUsesTheirSerialArenas) {
+  constexpr int kArenas = 3;
+  Arena arenas[kArenas];
+  // Allocate on this thread first so the other thread is not the owner of the
+  // first SerialArena.
+  for (Arena& arena : arenas) *Arena::Create<int64_t>(&arena) = 1;
+
+  auto alternate = [&] {
+    for (int i = 0; i < 300; ++i) {
+      Arena& arena = arenas[i % kArenas];
+      const size_t used = arena.SpaceUsed();
+      *Arena::Create<int64_t>(&arena) = i;
+      EXPECT_GT(arena.SpaceUsed(), used);
+    }
+  };
+  std::thread(alternate).join();
+
+  // After Reset() the arena has a new identity and must not hand out the
+  // SerialArena the thread used before.
+  for (Arena& arena : arenas) arena.Reset();
+  std::thread([&] {
+    alternate();
+    alternate();
+  }).join();
+}
+
 TEST(ArenaTest, GetArenaShouldReturnTheArenaForArenaAllocatedMessages) {
   Arena arena;
   ArenaMessage* message = Arena::Create<ArenaMessage>(&arena);
@@ -1880,6 +2061,98 @@ TEST(ArenaTest, SpaceReusePoisonsAndUnpoisonsMemory) {
   }
 }
 
+#if defined(PROTOBUF_ARENA_TRACE)
+uint64_t ArenaTraceBytes(absl::string_view label) {
+  uint64_t bytes = 0;
+  internal::IterateArenaTrace([&](const internal::ArenaTraceStats& stats) {
+    if (stats.label == label) bytes = stats.bytes;
+  });
+  return bytes;
+}
+
+std::atomic<int> arena_trace_handler_calls{0};
+
+TEST(ArenaTest, TraceAttributesAllocationsToTypes) {
+  internal::ResetArenaTrace();
+  arena_trace_handler_calls = 0;
+  internal::SetArenaTraceHandler(
+      [](const Arena*, absl::string_view, size_t) {
+        ++arena_trace_handler_calls;
+      });
+  {
+    Arena arena;
+    auto* message = Arena::Create<proto2_unittest::TestAllTypes>(&arena);
+    for (int i = 0; i < 100; ++i) message->add_repeated_int32(i);
+  }
+  internal::SetArenaTraceHandler(nullptr);
+
+  EXPECT_GE(ArenaTraceBytes(
+                internal::ArenaTraceTypeLabel<proto2_unittest::TestAllTypes>()),
+            sizeof(proto2_unittest::TestAllTypes));
+  EXPECT_GE(ArenaTraceBytes("RepeatedField"), 100 * sizeof(int32_t));
+  EXPECT_GT(arena_trace_handler_calls.load(), 1);
+  EXPECT_THAT(internal::ArenaTraceDebugString(),
+              testing::HasSubstr("RepeatedField"));
+  internal::ResetArenaTrace();
+}
+#else   // PROTOBUF_ARENA_TRACE
+TEST(ArenaTest, TraceCompiledOut) {
+  Arena arena;
+  Arena::Create<proto2_unittest::TestAllTypes>(&arena)->add_repeated_int32(1);
+  int labels = 0;
+  internal::IterateArenaTrace(
+      [&](const internal::ArenaTraceStats&) { ++labels; });
+  EXPECT_EQ(labels, 0);
+}
+#endif  // PROTOBUF_ARENA_TRACE
+
+TEST(ArenaTest, ArenaAllocatorReusesReturnedMemory) {
+  using Vector = std::vector<int, ArenaAllocator<int>>;
+  Arena arena;
+  const void* first_block;
+  {
+    Vector first{ArenaAllocator<int>(&arena)};
+    Vector second{ArenaAllocator<int>(&arena)};
+    first.reserve(64);
+    second.reserve(64);
+    EXPECT_GE(arena.SpaceUsed(), 2 * 64 * sizeof(int));
+    first_block = first.data();
+  }
+  // `second` is destroyed first and its block becomes the arena's free list,
+  // which then keeps the block of `first` for reuse.
+  EXPECT_EQ(Arena::CreateArray<char>(&arena, 64 * sizeof(int)), first_block);
+
+  Vector growing{ArenaAllocator<int>(&arena)};
+  for (int i = 0; i < 1000; ++i) growing.push_back(i);
+  EXPECT_EQ(growing[999], 999);
+
+  Vector heap_vector{ArenaAllocator<int>(nullptr)};
+  heap_vector.assign(100, 7);
+  EXPECT_EQ(heap_vector[99], 7);
+  EXPECT_EQ(ArenaAllocator<int>(&arena), ArenaAllocator<char>(&arena));
+  EXPECT_NE(ArenaAllocator<int>(&arena), ArenaAllocator<int>(nullptr));
+}
+
+#if defined(__cpp_lib_memory_resource)
+TEST(ArenaTest, ArenaMemoryResource) {
+  Arena arena;
+  ArenaMemoryResource resource(&arena);
+  EXPECT_EQ(resource.arena(), &arena);
+  {
+    std::pmr::vector<std::pmr::string> names(&resource);
+    for (int i = 0; i < 100; ++i) {
+      names.emplace_back(std::string(100, static_cast<char>('a' + i % 26)));
+    }
+    EXPECT_EQ(names[99], std::string(100, 'v'));
+    EXPECT_EQ(names[99].get_allocator().resource(), &resource);
+    EXPECT_GE(arena.SpaceUsed(), 100 * 100);
+  }
+  EXPECT_TRUE(resource.is_equal(resource));
+  ArenaMemoryResource other(&arena);
+  EXPECT_FALSE(resource.is_equal(other));
+}
+#endif  // __cpp_lib_memory_resource
+
 
 }  // namespace protobuf
 }  // namespace google
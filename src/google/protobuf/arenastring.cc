@@ -8,6 +8,9 @@
 #include "google/protobuf/arenastring.h"
 
 #include <cstddef>
+#include <cstring>
+#include <new>
+#include <string>
 
 #include "absl/base/optimization.h"
 #include "absl/log/absl_check.h"
@@ -92,6 +95,69 @@ TaggedStringPtr CreateArenaString(Arena& arena, absl::string_view s) {
 
 #endif  // !GOOGLE_PROTOBUF_INTERNAL_DONATE_STEAL
 
+// Fixed size arena strings (see TaggedStringPtr::kFixedSizeArena) are created
+// by the parser for long strings: the std::string instance is followed by its
+// contents in a single arena allocation, instead of owning a heap buffer that
+// the arena has to destroy. Constructing one requires knowing the layout of
+// std::string, so they are only used with the C++11 ABI of libstdc++, whose
+// layout is checked once at runtime.
+#if defined(__GLIBCXX__) && _GLIBCXX_USE_CXX11_ABI
+
+struct LibStdCxxStringRep {
+  char* data;
+  size_t size;
+  union {
+    char local_buf[16];
+    size_t capacity;
+  };
+};
+static_assert(sizeof(LibStdCxxStringRep) == sizeof(std::string), "");
+
+bool FixedSizeArenaStringsSupported() {
+  static const bool supported = [] {
+    std::string probe(2 * sizeof(std::string), 'x');
+    LibStdCxxStringRep rep;
+    memcpy(&rep, &probe, sizeof(rep));
+    return rep.data == probe.data() && rep.size == probe.size() &&
+           rep.capacity == probe.capacity();
+  }();
+  return supported;
+}
+
+// Strings that fit in the std::string instance gain nothing from being fixed
+// size.
+constexpr size_t kMinFixedSizeArenaString =
+    sizeof(LibStdCxxStringRep::local_buf);
+
+std::string* CreateFixedSizeArenaString(Arena& arena, const char* data,
+                                        size_t size) {
+  void* mem = arena.AllocateAligned(sizeof(std::string) + size + 1,
+                                    alignof(std::string));
+  char* contents = static_cast<char*>(mem) + sizeof(std::string);
+  memcpy(contents, data, size);
+  contents[size] = '\0';
+  auto* str = ::new (mem) std::string();
+  LibStdCxxStringRep rep;
+  rep.data = contents;
+  rep.size = size;
+  rep.capacity = size;
+  memcpy(static_cast<void*>(str), &rep, sizeof(rep));
+  return str;
+}
+
+#else  // __GLIBCXX__ && _GLIBCXX_USE_CXX11_ABI
+
+bool FixedSizeArenaStringsSupported() { return false; }
+
+constexpr size_t kMinFixedSizeArenaString = 0;
+
+std::string* CreateFixedSizeArenaString(Arena&, const char*, size_t) {
+  ABSL_CHECK(false) << "fixed size arena strings are not supported";
+  return nullptr;
+}
+
+#endif  // __GLIBCXX__ && _GLIBCXX_USE_CXX11_ABI
+
 }  // namespace
 
 TaggedStringPtr TaggedStringPtr::ForceCopy(Arena* arena) const {
@@ -106,6 +172,8 @@ void ArenaStringPtr::Set(absl::string_view value, Arena* arena) {
     // possible copy cost later.
     tagged_ptr_ = arena != nullptr ? CreateArenaString(*arena, value)
                                    : CreateString(value);
+  } else if (IsFixedSizeArena()) {
+    tagged_ptr_ = CreateArenaString(*arena, value);
   } else {
     if (internal::DebugHardenForceCopyDefaultString()) {
       if (arena == nullptr) {
@@ -131,6 +199,8 @@ void ArenaStringPtr::Set(const std::string& value, Arena* arena) {
     // possible copy cost later.
     tagged_ptr_ = arena != nullptr ? CreateArenaString(*arena, value)
                                    : CreateString(value);
+  } else if (IsFixedSizeArena()) {
+    tagged_ptr_ = CreateArenaString(*arena, value);
   } else {
     if (internal::DebugHardenForceCopyDefaultString()) {
       if (arena == nullptr) {
@@ -186,7 +256,7 @@ std::string* ArenaStringPtr::MutableNoCopy(Arena* arena) {
   if (tagged_ptr_.IsMutable()) {
     return tagged_ptr_.Get();
   } else {
-    ABSL_DCHECK(IsDefault());
+    ABSL_DCHECK(IsDefault() || IsFixedSizeArena());
     // Allocate empty. The contents are not relevant.
     return NewString(arena);
   }
@@ -195,6 +265,14 @@ std::string* ArenaStringPtr::MutableNoCopy(Arena* arena) {
 template <typename... Lazy>
 std::string* ArenaStringPtr::MutableSlow(::google::protobuf::Arena* arena,
                                          const Lazy&... lazy_default) {
+  if (IsFixedSizeArena()) {
+    // Replaces the instance with one owning a copy of the contents, which
+    // follow the instance in the arena and so survive its construction.
+    std::string* current = tagged_ptr_.Get();
+    auto* s = new (current) std::string(current->data(), current->size());
+    arena->OwnDestructor(s);
+    return tagged_ptr_.SetMutableArena(s);
+  }
   ABSL_DCHECK(IsDefault());
 
   // For empty defaults, this ends up calling the default constructor which is
@@ -260,6 +338,8 @@ void ArenaStringPtr::ClearToDefault(const LazyString& default_value,
   (void)arena;
   if (IsDefault()) {
     // Already set to default -- do nothing.
+  } else if (IsFixedSizeArena()) {
+    tagged_ptr_ = CreateArenaString(*arena, default_value.get());
   } else {
     UnsafeMutablePointer()->assign(default_value.get());
   }
@@ -274,6 +354,13 @@ const char* EpsCopyInputStream::ReadArenaString(const char* ptr,
   int size = ReadSize(&ptr);
   if (!ptr) return nullptr;
 
+  if (static_cast<size_t>(size) > kMinFixedSizeArenaString &&
+      size <= BytesAvailable(ptr) && FixedSizeArenaStringsSupported()) {
+    s->tagged_ptr_.SetFixedSizeArena(
+        CreateFixedSizeArenaString(*arena, ptr, size));
+    return ptr + size;
+  }
+
   auto* str = s->NewString(arena);
   ptr = ReadString(ptr, size, str);
   GOOGLE_PROTOBUF_PARSER_ASSERT(ptr);
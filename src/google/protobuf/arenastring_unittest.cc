@@ -16,12 +16,14 @@
 
 #include <gtest/gtest.h>
 #include "absl/log/absl_check.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "google/protobuf/explicitly_constructed.h"
 #include "google/protobuf/generated_message_util.h"
 #include "google/protobuf/io/coded_stream.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
 #include "google/protobuf/message_lite.h"
+#include "google/protobuf/parse_context.h"
 #include "google/protobuf/port.h"
 
 
@@ -201,6 +203,71 @@ TEST_P(SingleArena, CopyConstructLong) {
   field.Destroy();
 }
 
+// Parses a length delimited `value` into `field`, the way the parser does for
+// string fields of messages on an arena.
+void ParseArenaString(absl::string_view value, ArenaStringPtr* field,
+                      Arena* arena) {
+  std::string wire(1, static_cast<char>(value.size()));
+  wire.append(value.data(), value.size());
+  const char* ptr;
+  internal::ParseContext ctx(io::CodedInputStream::GetDefaultRecursionLimit(),
+                             false, &ptr, wire);
+  ptr = ctx.ReadArenaString(ptr, field, arena);
+  ASSERT_NE(ptr, nullptr);
+}
+
+const char kLongValue[] = "A string long enough to not be inlined";
+
+TEST(ArenaStringPtrTest, ParseLongStringThenMutate) {
+  Arena arena;
+  ArenaStringPtr field;
+  field.InitDefault();
+  ParseArenaString(kLongValue, &field, &arena);
+  EXPECT_EQ(field.Get(), kLongValue);
+
+  ArenaStringPtr copy(&arena, field);
+  EXPECT_EQ(copy.Get(), kLongValue);
+
+  field.Mutable(&arena)->append("!");
+  EXPECT_EQ(field.Get(), absl::StrCat(kLongValue, "!"));
+  EXPECT_EQ(copy.Get(), kLongValue);
+}
+
+TEST(ArenaStringPtrTest, ParseLongStringThenSet) {
+  Arena arena;
+  ArenaStringPtr field;
+  field.InitDefault();
+  ParseArenaString(kLongValue, &field, &arena);
+  field.Set(absl::StrCat(kLongValue, kLongValue), &arena);
+  EXPECT_EQ(field.Get(), absl::StrCat(kLongValue, kLongValue));
+
+  ParseArenaString(kLongValue, &field, &arena);
+  field.Set(std::string("short"), &arena);
+  EXPECT_EQ(field.Get(), "short");
+
+  ParseArenaString(kLongValue, &field, &arena);
+  field.ClearToEmpty();
+  EXPECT_EQ(field.Get(), "");
+
+  ParseArenaString(kLongValue, &field, &arena);
+  field.ClearToDefault(nonempty_default, &arena);
+  EXPECT_EQ(field.Get(), "default");
+
+  ParseArenaString(kLongValue, &field, &arena);
+  *field.MutableNoCopy(&arena) = "overwritten";
+  EXPECT_EQ(field.Get(), "overwritten");
+}
+
+TEST(ArenaStringPtrTest, ParseLongStringThenRelease) {
+  Arena arena;
+  ArenaStringPtr field;
+  field.InitDefault();
+  ParseArenaString(kLongValue, &field, &arena);
+  std::unique_ptr<std::string> released(field.Release());
+  EXPECT_EQ(*released, kLongValue);
+  EXPECT_TRUE(field.IsDefault());
+}
+
 
 }  // namespace protobuf
 }  // namespace google
@@ -65,6 +65,11 @@ void ThreadSafeArenaStats::PrepareForSampling(int64_t stride) {
   for (auto& blockstats : block_histogram) blockstats.PrepareForSampling();
   max_block_size.store(0, std::memory_order_relaxed);
   thread_ids.store(0, std::memory_order_relaxed);
+  block_cache_hits.store(0, std::memory_order_relaxed);
+  block_cache_misses.store(0, std::memory_order_relaxed);
+  huge_page_blocks.store(0, std::memory_order_relaxed);
+  numa_local_blocks.store(0, std::memory_order_relaxed);
+  placement_fallback_blocks.store(0, std::memory_order_relaxed);
   weight = stride;
   // The inliner makes hardcoded skip_count difficult (especially when combined
   // with LTO).  We use the ability to exclude stacks by regex when encoding
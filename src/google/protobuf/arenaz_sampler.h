@@ -74,6 +74,19 @@ struct ThreadSafeArenaStats
   // create sampling artifacts.
   std::atomic<uint64_t> thread_ids;
 
+  // Number of block allocations served from, respectively not found in, the
+  // per-thread block cache (see `ArenaOptions::max_thread_cached_bytes`).
+  std::atomic<size_t> block_cache_hits;
+  std::atomic<size_t> block_cache_misses;
+
+  // Number of blocks for which the huge page, respectively NUMA-local,
+  // placement was requested and accepted by the OS (see
+  // `ArenaOptions::block_placement`), and number of blocks for which it was
+  // requested but not available.
+  std::atomic<size_t> huge_page_blocks;
+  std::atomic<size_t> numa_local_blocks;
+  std::atomic<size_t> placement_fallback_blocks;
+
   // All of the fields below are set by `PrepareForSampling`, they must not
   // be mutated in `Record*` functions.  They are logically `const` in that
   // sense. These are guarded by init_mu, but that is not externalized to
@@ -87,6 +100,20 @@ struct ThreadSafeArenaStats
     if (ABSL_PREDICT_TRUE(info == nullptr)) return;
     RecordAllocateSlow(info, used, allocated, wasted);
   }
+  static void RecordBlockCacheStats(ThreadSafeArenaStats* info, bool hit) {
+    if (ABSL_PREDICT_TRUE(info == nullptr)) return;
+    (hit ? info->block_cache_hits : info->block_cache_misses)
+        .fetch_add(1, std::memory_order_relaxed);
+  }
+  static void RecordBlockPlacementStats(ThreadSafeArenaStats* info,
+                                        bool huge_pages, bool applied) {
+    if (ABSL_PREDICT_TRUE(info == nullptr)) return;
+    std::atomic<size_t>& counter =
+        !applied ? info->placement_fallback_blocks
+                 : (huge_pages ? info->huge_page_blocks
+                               : info->numa_local_blocks);
+    counter.fetch_add(1, std::memory_order_relaxed);
+  }
 
   // Returns the bin for the provided size.
   static size_t FindBin(size_t bytes);
@@ -167,6 +194,10 @@ using SamplingState = int64_t;
 struct ThreadSafeArenaStats {
   static void RecordAllocateStats(ThreadSafeArenaStats*, size_t /*requested*/,
                                   size_t /*allocated*/, size_t /*wasted*/) {}
+  static void RecordBlockCacheStats(ThreadSafeArenaStats*, bool /*hit*/) {}
+  static void RecordBlockPlacementStats(ThreadSafeArenaStats*,
+                                        bool /*huge_pages*/,
+                                        bool /*applied*/) {}
 };
 
 ThreadSafeArenaStats* SampleSlow(SamplingState& next_sample);
@@ -124,6 +124,12 @@ class PROTOC_EXPORT CodeGenerator {
   // proto files with an edition after this will result in an error.
   virtual Edition GetMaximumEdition() const { return Edition::EDITION_UNKNOWN; }
 
+  // Returns true if Generate() may be called concurrently for different files,
+  // and GenerateAll() is not overridden.  protoc --jobs then generates several
+  // files at a time, writing each file's output to a separate context and
+  // applying them in order, so the result is the same as for GenerateAll().
+  virtual bool SupportsConcurrentGenerate() const { return false; }
+
   // Builds a default feature set mapping for this generator.
   //
   // This will use the extensions specified by GetFeatureExtensions(), with the
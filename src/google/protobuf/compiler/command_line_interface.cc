@@ -18,6 +18,7 @@
 #include <sys/types.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -26,6 +27,7 @@
 #include <memory>
 #include <ostream>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 #ifdef major
@@ -60,6 +62,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_replace.h"
@@ -1190,6 +1193,7 @@ int CommandLineInterface::Run(int argc, const char* const argv[]) {
       databases_per_descriptor_set;
   std::unique_ptr<MergedDescriptorDatabase> descriptor_set_in_database;
 
+  std::unique_ptr<DiskParseCache> parse_cache;
   std::unique_ptr<SourceTreeDescriptorDatabase> source_tree_database;
 
   // Any --descriptor_set_in FileDescriptorSet objects will be used as a
@@ -1229,6 +1233,8 @@ int CommandLineInterface::Run(int argc, const char* const argv[]) {
         descriptor_set_in_database.get(), error_collector.get());
   } else {
     disk_source_tree = std::make_unique<DiskSourceTree>();
+    // The tree does not change during the run.
+    disk_source_tree->EnableDirectoryCache();
     if (!InitializeDiskSourceTree(disk_source_tree.get(),
                                   descriptor_set_in_database.get())) {
       return 1;
@@ -1240,6 +1246,10 @@ int CommandLineInterface::Run(int argc, const char* const argv[]) {
     source_tree_database = std::make_unique<SourceTreeDescriptorDatabase>(
         disk_source_tree.get(), descriptor_set_in_database.get());
     source_tree_database->RecordErrorsTo(error_collector.get());
+    if (!parse_cache_dir_.empty()) {
+      parse_cache = std::make_unique<DiskParseCache>(parse_cache_dir_);
+      source_tree_database->SetParseCache(parse_cache.get());
+    }
 
     descriptor_pool = std::make_unique<DescriptorPool>(
         source_tree_database.get(),
@@ -1654,6 +1664,8 @@ void CommandLineInterface::Clear() {
   descriptor_set_in_names_.clear();
   descriptor_set_out_name_.clear();
   dependency_out_name_.clear();
+  parse_cache_dir_.clear();
+  jobs_ = 1;
 
   experimental_editions_ = false;
   edition_defaults_out_name_.clear();
@@ -2182,6 +2194,23 @@ CommandLineInterface::InterpretArgument(const std::string& name,
     }
     dependency_out_name_ = value;
 
+  } else if (name == "--parse_cache_dir") {
+    if (!parse_cache_dir_.empty()) {
+      std::cerr << name << " may only be passed once." << std::endl;
+      return PARSE_ARGUMENT_FAIL;
+    }
+    if (value.empty()) {
+      std::cerr << name << " requires a non-empty value." << std::endl;
+      return PARSE_ARGUMENT_FAIL;
+    }
+    parse_cache_dir_ = value;
+
+  } else if (name == "--jobs") {
+    if (!absl::SimpleAtoi(value, &jobs_) || jobs_ < 1) {
+      std::cerr << name << " requires a positive number of jobs." << std::endl;
+      return PARSE_ARGUMENT_FAIL;
+    }
+
   } else if (name == "--include_imports") {
     if (imports_in_descriptor_set_) {
       std::cerr << name << " may only be passed once." << std::endl;
@@ -2490,6 +2519,13 @@ Parse PROTO_FILES and generate output based on the options given:
   --dependency_out=FILE       Write a dependency output file in the format
                               expected by make. This writes the transitive
                               set of input file paths to FILE
+  --parse_cache_dir=DIR       Cache the results of parsing .proto files in
+                              the existing directory DIR, and reuse them for
+                              files whose contents did not change. DIR may be
+                              shared by concurrent protoc invocations.
+  --jobs=N                    Allow generators which support it to generate
+                              code for up to N input files at a time. The
+                              output does not depend on N. Defaults to 1.
   --error_format=FORMAT       Set the format in which to print errors.
                               FORMAT may be 'gcc' (the default) or 'msvs'
                               (Microsoft Visual Studio format).
@@ -2634,6 +2670,160 @@ bool CommandLineInterface::EnforceProtocEditionsSupport(
   return true;
 }
 
+namespace {
+
+// A GeneratorContext which records the files written to it, so that
+// generators running on several threads can each write to their own context,
+// and the outputs can then be applied to the real context in a deterministic
+// order.
+class RecordingGeneratorContext : public GeneratorContext {
+ public:
+  explicit RecordingGeneratorContext(GeneratorContext* target)
+      : target_(target) {}
+
+  // Writes the recorded outputs to target_, in the order their streams were
+  // closed, as if they were written to it directly.
+  void Replay() {
+    for (const std::unique_ptr<Output>& output : outputs_) {
+      std::unique_ptr<io::ZeroCopyOutputStream> stream;
+      switch (output->kind) {
+        case Output::kOpen:
+          stream.reset(target_->Open(output->filename));
+          break;
+        case Output::kAppend:
+          stream.reset(target_->OpenForAppend(output->filename));
+          break;
+        case Output::kInsert:
+          stream.reset(target_->OpenForInsertWithGeneratedCodeInfo(
+              output->filename, output->insertion_point, output->info));
+          break;
+      }
+      if (stream == nullptr) continue;
+      io::CodedOutputStream coded_out(stream.get());
+      coded_out.WriteRaw(output->data.data(),
+                         static_cast<int>(output->data.size()));
+    }
+    outputs_.clear();
+  }
+
+  // implements GeneratorContext --------------------------------------
+  io::ZeroCopyOutputStream* Open(const std::string& filename) override {
+    return new RecordingOutputStream(this, Output::kOpen, filename, "", {});
+  }
+  io::ZeroCopyOutputStream* OpenForAppend(
+      const std::string& filename) override {
+    return new RecordingOutputStream(this, Output::kAppend, filename, "", {});
+  }
+  io::ZeroCopyOutputStream* OpenForInsert(
+      const std::string& filename,
+      const std::string& insertion_point) override {
+    return new RecordingOutputStream(this, Output::kInsert, filename,
+                                     insertion_point, {});
+  }
+  io::ZeroCopyOutputStream* OpenForInsertWithGeneratedCodeInfo(
+      const std::string& filename, const std::string& insertion_point,
+      const google::protobuf::GeneratedCodeInfo& info) override {
+    return new RecordingOutputStream(this, Output::kInsert, filename,
+                                     insertion_point, info);
+  }
+  void ListParsedFiles(std::vector<const FileDescriptor*>* output) override {
+    target_->ListParsedFiles(output);
+  }
+  void GetCompilerVersion(Version* version) const override {
+    target_->GetCompilerVersion(version);
+  }
+
+ private:
+  struct Output {
+    enum Kind { kOpen, kAppend, kInsert };
+    Kind kind;
+    std::string filename;
+    std::string insertion_point;
+    google::protobuf::GeneratedCodeInfo info;
+    std::string data;
+  };
+
+  class RecordingOutputStream : public io::ZeroCopyOutputStream {
+   public:
+    RecordingOutputStream(RecordingGeneratorContext* context, Output::Kind kind,
+                          const std::string& filename,
+                          const std::string& insertion_point,
+                          const google::protobuf::GeneratedCodeInfo& info)
+        : context_(context),
+          output_(new Output{kind, filename, insertion_point, info, ""}),
+          inner_(&output_->data) {}
+    ~RecordingOutputStream() override {
+      context_->outputs_.push_back(std::move(output_));
+    }
+
+    // implements ZeroCopyOutputStream ---------------------------------
+    bool Next(void** data, int* size) override {
+      return inner_.Next(data, size);
+    }
+    void BackUp(int count) override { inner_.BackUp(count); }
+    int64_t ByteCount() const override { return inner_.ByteCount(); }
+
+   private:
+    RecordingGeneratorContext* context_;
+    std::unique_ptr<Output> output_;
+    io::StringOutputStream inner_;
+  };
+
+  GeneratorContext* target_;
+  std::vector<std::unique_ptr<Output>> outputs_;
+};
+
+// Like CodeGenerator::GenerateAll(), but calls Generate() for up to `jobs`
+// files at a time.  The outputs are written to `generator_context` in file
+// order, so they are the same as for a sequential run.
+bool GenerateConcurrently(const CodeGenerator& generator,
+                          const std::vector<const FileDescriptor*>& files,
+                          const std::string& parameter, int jobs,
+                          GeneratorContext* generator_context,
+                          std::string* error) {
+  std::vector<std::unique_ptr<RecordingGeneratorContext>> contexts;
+  contexts.reserve(files.size());
+  for (size_t i = 0; i < files.size(); ++i) {
+    contexts.push_back(
+        std::make_unique<RecordingGeneratorContext>(generator_context));
+  }
+  std::vector<std::string> errors(files.size());
+  std::unique_ptr<bool[]> succeeded(new bool[files.size()]);
+
+  std::atomic<size_t> next_file{0};
+  auto worker = [&] {
+    for (size_t i = next_file.fetch_add(1); i < files.size();
+         i = next_file.fetch_add(1)) {
+      succeeded[i] =
+          generator.Generate(files[i], parameter, contexts[i].get(), &errors[i]);
+    }
+  };
+  std::vector<std::thread> threads;
+  const size_t thread_count =
+      std::min(files.size(), static_cast<size_t>(jobs)) - 1;
+  for (size_t i = 0; i < thread_count; ++i) threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads) thread.join();
+
+  // Report the first failure, after the outputs of the files before it, as
+  // GenerateAll() does.
+  for (size_t i = 0; i < files.size(); ++i) {
+    contexts[i]->Replay();
+    if (!succeeded[i] && errors[i].empty()) {
+      errors[i] =
+          "Code generator returned false but provided no error "
+          "description.";
+    }
+    if (!errors[i].empty()) {
+      *error = absl::StrCat(files[i]->name(), ": ", errors[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 bool CommandLineInterface::GenerateOutput(
     const std::vector<const FileDescriptor*>& parsed_files,
     const OutputDirective& output_directive,
@@ -2682,8 +2872,15 @@ bool CommandLineInterface::GenerateOutput(
       return false;
     }
 
-    if (!output_directive.generator->GenerateAll(parsed_files, parameters,
-                                                 generator_context, &error)) {
+    const CodeGenerator& generator = *output_directive.generator;
+    const bool succeeded =
+        jobs_ > 1 && parsed_files.size() > 1 &&
+                generator.SupportsConcurrentGenerate()
+            ? GenerateConcurrently(generator, parsed_files, parameters, jobs_,
+                                   generator_context, &error)
+            : generator.GenerateAll(parsed_files, parameters,
+                                    generator_context, &error);
+    if (!succeeded) {
       // Generator returned an error.
       std::cerr << output_directive.name << ": " << error << std::endl;
       return false;
@@ -453,6 +453,13 @@ class PROTOC_EXPORT CommandLineInterface {
   // dependency file will be written. Otherwise, empty.
   std::string dependency_out_name_;
 
+  // The number of files a generator may generate at a time, from --jobs.
+  int jobs_ = 1;
+
+  // If --parse_cache_dir was given, parsed .proto files are cached in this
+  // directory.  Otherwise, empty.
+  std::string parse_cache_dir_;
+
   bool experimental_editions_ = false;
 
   // True if --include_imports was given, meaning that we should
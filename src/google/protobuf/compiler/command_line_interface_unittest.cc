@@ -619,6 +619,57 @@ TEST_F(CommandLineInterfaceTest, MultipleInputs) {
                                     "bar.proto", "Bar");
 }
 
+TEST_F(CommandLineInterfaceTest, MultipleInputsWithJobs) {
+  mock_generator_->set_supports_concurrent_generate(true);
+  CreateTempFile("foo.proto",
+                 "syntax = \"proto2\";\n"
+                 "message Foo {}\n");
+  CreateTempFile("bar.proto",
+                 "syntax = \"proto2\";\n"
+                 "message Bar {}\n");
+  CreateTempFile("baz.proto",
+                 "syntax = \"proto2\";\n"
+                 "message Baz {}\n");
+
+  Run("protocol_compiler --test_out=$tmpdir --jobs=2 "
+      "--proto_path=$tmpdir foo.proto bar.proto baz.proto");
+
+  ExpectNoErrors();
+  ExpectGeneratedWithMultipleInputs(
+      "test_generator", "foo.proto,bar.proto,baz.proto", "foo.proto", "Foo");
+  ExpectGeneratedWithMultipleInputs(
+      "test_generator", "foo.proto,bar.proto,baz.proto", "bar.proto", "Bar");
+  ExpectGeneratedWithMultipleInputs(
+      "test_generator", "foo.proto,bar.proto,baz.proto", "baz.proto", "Baz");
+}
+
+TEST_F(CommandLineInterfaceTest, GeneratorErrorWithJobs) {
+  mock_generator_->set_supports_concurrent_generate(true);
+  CreateTempFile("foo.proto",
+                 "syntax = \"proto2\";\n"
+                 "message Foo {}\n");
+  CreateTempFile("bar.proto",
+                 "syntax = \"proto2\";\n"
+                 "message MockCodeGenerator_Error {}\n");
+
+  Run("protocol_compiler --test_out=$tmpdir --jobs=4 "
+      "--proto_path=$tmpdir foo.proto bar.proto");
+
+  ExpectErrorSubstring(
+      "--test_out: bar.proto: Saw message type MockCodeGenerator_Error.");
+}
+
+TEST_F(CommandLineInterfaceTest, JobsMustBePositive) {
+  CreateTempFile("foo.proto",
+                 "syntax = \"proto2\";\n"
+                 "message Foo {}\n");
+
+  Run("protocol_compiler --test_out=$tmpdir --jobs=0 "
+      "--proto_path=$tmpdir foo.proto");
+
+  ExpectErrorSubstring("--jobs requires a positive number of jobs.");
+}
+
 TEST_F(CommandLineInterfaceTest, MultipleInputs_DescriptorSetIn) {
   // Test parsing multiple input files.
   FileDescriptorSet file_descriptor_set;
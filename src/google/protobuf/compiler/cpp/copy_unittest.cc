@@ -59,6 +59,61 @@ TEST(CopyMessageTest, ArenaEnabledCopyConstructorArenaLeakTest) {
   EXPECT_EQ(message2->repeated_string(0), message1.repeated_string(0));
 }
 
+TEST(CopyMessageTest, CopyFrom) {
+  proto2_unittest::TestAllTypes message1;
+  TestUtil::SetAllFields(&message1);
+  proto2_unittest::TestAllTypes message2;
+  message2.set_optional_int32(7);
+  message2.set_optional_fixed64(8);
+  message2.CopyFrom(message1);
+  TestUtil::ExpectAllFieldsSet(message2);
+}
+
+TEST(CopyMessageTest, ArenaToArenaCopyFrom) {
+  Arena arena1;
+  Arena arena2;
+  auto* message1 = Arena::Create<proto2_unittest::TestAllTypes>(&arena1);
+  TestUtil::SetAllFields(message1);
+  auto* message2 = Arena::Create<proto2_unittest::TestAllTypes>(&arena2);
+  message2->set_optional_bool(false);
+  message2->CopyFrom(*message1);
+  TestUtil::ExpectAllFieldsSet(*message2);
+}
+
+TEST(CopyMessageTest, MergeSomeScalarsIntoClearMessage) {
+  proto2_unittest::TestAllTypes message1;
+  message1.set_optional_int32(101);
+  message1.set_optional_double(110.5);
+  proto2_unittest::TestAllTypes message2;
+  message2.MergeFrom(message1);
+
+  EXPECT_TRUE(message2.has_optional_int32());
+  EXPECT_EQ(message2.optional_int32(), 101);
+  EXPECT_TRUE(message2.has_optional_double());
+  EXPECT_EQ(message2.optional_double(), 110.5);
+  EXPECT_FALSE(message2.has_optional_int64());
+  EXPECT_EQ(message2.optional_int64(), 0);
+  EXPECT_FALSE(message2.has_default_int32());
+  EXPECT_EQ(message2.default_int32(), 41);
+}
+
+TEST(CopyMessageTest, MergeScalarsKeepsScalarsOfDestination) {
+  proto2_unittest::TestAllTypes message1;
+  message1.set_optional_int32(101);
+  message1.set_optional_uint64(104);
+  proto2_unittest::TestAllTypes message2;
+  message2.set_optional_int32(1);
+  message2.set_optional_int64(102);
+  message2.set_optional_float(111);
+  message2.MergeFrom(message1);
+
+  EXPECT_EQ(message2.optional_int32(), 101);
+  EXPECT_EQ(message2.optional_uint64(), 104);
+  EXPECT_EQ(message2.optional_int64(), 102);
+  EXPECT_EQ(message2.optional_float(), 111);
+  EXPECT_FALSE(message2.has_optional_uint32());
+}
+
 }  // namespace
 }  // namespace cpp
 }  // namespace compiler
@@ -437,9 +437,9 @@ void EnumGenerator::GenerateMethods(int idx, io::Printer* p) {
     // contains the bulk of the data and is sorted by name, while
     // _entries_by_number is sorted by number and just contains pointers into
     // _entries. The two tables allow mapping from name to number and number to
-    // name, both in time logarithmic in the number of enum entries. This could
-    // probably be made faster, but for now the tables are intended to be simple
-    // and compact.
+    // name, both in time logarithmic in the number of enum entries, or
+    // constant for dense enums. The _entries_by_name_hash table additionally
+    // maps names to _entries indices in expected constant time, for Parse().
     //
     // Enums with allow_alias = true support multiple entries with the same
     // numerical value. In cases where there are multiple names for the same
@@ -479,6 +479,12 @@ void EnumGenerator::GenerateMethods(int idx, io::Printer* p) {
       return a.number < b.number;
     });
 
+    std::vector<absl::string_view> names;
+    names.reserve(name_to_number.size());
+    for (const auto& e : name_to_number) names.push_back(e.first);
+    const std::vector<int> name_table =
+        google::protobuf::internal::GenerateEnumNameTable(names);
+
     offsets_by_number.erase(
         std::unique(
             offsets_by_number.begin(), offsets_by_number.end(),
@@ -488,7 +494,6 @@ void EnumGenerator::GenerateMethods(int idx, io::Printer* p) {
     p->Emit(
         {
             {"num_unique", number_to_canonical_name.size()},
-            {"num_declared", enum_->value_count()},
             {"names",
              // We concatenate all the names for a given enum into one big
              // string literal. If instead we store an array of string
@@ -513,6 +518,13 @@ void EnumGenerator::GenerateMethods(int idx, io::Printer* p) {
                          )cc");
                }
              }},
+            {"name_table_size", name_table.size()},
+            {"entries_by_name_hash",
+             [&] {
+               for (int index : name_table) {
+                 p->Emit({{"index", index}}, "$index$, ");
+               }
+             }},
             {"entries_by_number",
              [&] {
                for (const auto& offset : offsets_by_number) {
@@ -541,6 +553,9 @@ void EnumGenerator::GenerateMethods(int idx, io::Printer* p) {
               $entries_by_number$,
           };
 
+          static const int $Msg_Enum$_entries_by_name_hash[] = {
+              $entries_by_name_hash$};
+
           $return_type$ $Msg_Enum$_Name($Msg_Enum$ value) {
             static const bool kDummy = $pbi$::InitializeEnumStrings(
                 $Msg_Enum$_entries, $Msg_Enum$_entries_by_number, $num_unique$,
@@ -556,7 +571,8 @@ void EnumGenerator::GenerateMethods(int idx, io::Printer* p) {
           bool $Msg_Enum$_Parse(absl::string_view name, $Msg_Enum$* $nonnull$ value) {
             int int_value;
             bool success = $pbi$::LookUpEnumValue(
-                $Msg_Enum$_entries, $num_declared$, name, &int_value);
+                $Msg_Enum$_entries, $Msg_Enum$_entries_by_name_hash,
+                $name_table_size$, name, &int_value);
             if (success) {
               *value = static_cast<$Msg_Enum$>(int_value);
             }
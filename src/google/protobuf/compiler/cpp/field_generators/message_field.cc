@@ -139,6 +139,13 @@ class SingularMessage : public FieldGeneratorBase {
  private:
   friend class OneofMessage;
 
+  // Whether the size of the submessage is recomputed instead of cached, see
+  // HasUncachedByteSize.
+  bool has_uncached_size() const {
+    return !is_weak() && !is_group() &&
+           HasUncachedByteSize(field_->message_type(), *opts_);
+  }
+
   const Options* opts_;
   bool has_required_;
   bool has_hasbit_;
@@ -388,7 +395,14 @@ void SingularMessage::GenerateCopyConstructorCode(io::Printer* p) const {
 
 void SingularMessage::GenerateSerializeWithCachedSizesToArray(
     io::Printer* p) const {
-  if (!is_group()) {
+  if (has_uncached_size()) {
+    p->Emit(R"cc(
+      target = $pbi$::WireFormatLite::InternalWriteMessage(
+          $number$, *this_.$field_$,
+          static_cast<int>(this_.$field_$->UncachedByteSizeLong()), target,
+          stream);
+    )cc");
+  } else if (!is_group()) {
     p->Emit(R"cc(
       target = $pbi$::WireFormatLite::InternalWrite$declared_type$(
           $number$, *this_.$field_$, this_.$field_$->GetCachedSize(), target,
@@ -404,6 +418,13 @@ void SingularMessage::GenerateSerializeWithCachedSizesToArray(
 }
 
 void SingularMessage::GenerateByteSize(io::Printer* p) const {
+  if (has_uncached_size()) {
+    p->Emit(R"cc(
+      total_size += $tag_size$ +
+                    $pbi$::WireFormatLite::UncachedMessageSize(*this_.$field_$);
+    )cc");
+    return;
+  }
   p->Emit(R"cc(
     total_size += $tag_size$ +
                   $pbi$::WireFormatLite::$declared_type$Size(*this_.$field_$);
@@ -740,6 +761,12 @@ class RepeatedMessage : public FieldGeneratorBase {
   bool NeedsIsInitialized() const override;
 
  private:
+  // See SingularMessage::has_uncached_size.
+  bool has_uncached_size() const {
+    return !is_weak() && !is_group() &&
+           HasUncachedByteSize(field_->message_type(), *opts_);
+  }
+
   const Options* opts_;
   bool has_required_;
 };
@@ -980,7 +1007,16 @@ void RepeatedMessage::GenerateSerializeWithCachedSizesToArray(
   } else {
     p->Emit({{"serialize_field",
               [&] {
-                if (field_->type() == FieldDescriptor::TYPE_MESSAGE) {
+                if (has_uncached_size()) {
+                  p->Emit(
+                      R"cc(
+                        const auto& repfield = this_._internal_$name$().Get(i);
+                        target = $pbi$::WireFormatLite::InternalWriteMessage(
+                            $number$, repfield,
+                            static_cast<int>(repfield.UncachedByteSizeLong()),
+                            target, stream);
+                      )cc");
+                } else if (field_->type() == FieldDescriptor::TYPE_MESSAGE) {
                   p->Emit(
                       R"cc(
                         const auto& repfield = this_._internal_$name$().Get(i);
@@ -1011,6 +1047,16 @@ void RepeatedMessage::GenerateSerializeWithCachedSizesToArray(
 }
 
 void RepeatedMessage::GenerateByteSize(io::Printer* p) const {
+  if (has_uncached_size()) {
+    p->Emit(
+        R"cc(
+          total_size += $tag_size$UL * this_._internal_$name$_size();
+          for (const auto& msg : this_._internal_$name$()) {
+            total_size += $pbi$::WireFormatLite::UncachedMessageSize(msg);
+          }
+        )cc");
+    return;
+  }
   p->Emit(
       R"cc(
         total_size += $tag_size$UL * this_._internal_$name$_size();
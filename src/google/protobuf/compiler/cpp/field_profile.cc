@@ -0,0 +1,83 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/compiler/cpp/field_profile.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "google/protobuf/descriptor.h"
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+namespace cpp {
+
+absl::StatusOr<FieldProfile> FieldProfile::Parse(absl::string_view contents) {
+  FieldProfile profile;
+  int line_number = 0;
+  for (absl::string_view line : absl::StrSplit(contents, '\n')) {
+    ++line_number;
+    line = absl::StripAsciiWhitespace(line);
+    if (line.empty() || line[0] == '#') continue;
+
+    std::vector<absl::string_view> parts =
+        absl::StrSplit(line, absl::ByAnyChar(" \t"), absl::SkipEmpty());
+    float probability;
+    if (parts.size() != 2 || !absl::SimpleAtof(parts[1], &probability) ||
+        !(probability >= 0 && probability <= 1)) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Invalid profile entry on line ", line_number, ": \"", line,
+          "\". Expected \"<field full name> <presence probability>\"."));
+    }
+    profile.presence_[std::string(parts[0])] = probability;
+  }
+  return profile;
+}
+
+absl::StatusOr<FieldProfile> FieldProfile::Load(const std::string& path) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return absl::NotFoundError(
+        absl::StrCat("Could not open profile file: ", path));
+  }
+
+  std::string contents;
+  char buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    contents.append(buffer, n);
+  }
+  int error = ferror(file);
+  fclose(file);
+  if (error != 0) {
+    return absl::InternalError(
+        absl::StrCat("Failed to read profile file: ", path));
+  }
+  return Parse(contents);
+}
+
+absl::optional<float> FieldProfile::GetPresenceProbability(
+    const FieldDescriptor* field) const {
+  auto it = presence_.find(field->full_name());
+  if (it == presence_.end()) return absl::nullopt;
+  return it->second;
+}
+
+}  // namespace cpp
+}  // namespace compiler
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,64 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// FieldProfile holds field presence probabilities collected from a running
+// program, for use by the C++ generator's layout and has-bit heuristics. It is
+// loaded with the `profile` generator option:
+//
+//   protoc --cpp_out=profile=/path/to/profile.txt:outdir foo.proto
+//
+// The profile is a text file with one field per line:
+//
+//   # Lines starting with '#' and blank lines are ignored.
+//   my.pkg.Request.user_id 1.0
+//   my.pkg.Request.debug_options 0.0001
+//
+// Each line holds the full name of a field and the fraction of sampled
+// messages in which the field was present, in [0, 1]. Fields that do not
+// appear in the profile get the generator's default treatment.
+
+#ifndef GOOGLE_PROTOBUF_COMPILER_CPP_FIELD_PROFILE_H__
+#define GOOGLE_PROTOBUF_COMPILER_CPP_FIELD_PROFILE_H__
+
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "google/protobuf/descriptor.h"
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+namespace cpp {
+
+class FieldProfile {
+ public:
+  // Parses a profile in the format described above.
+  static absl::StatusOr<FieldProfile> Parse(absl::string_view contents);
+
+  // Reads and parses the profile stored at `path`.
+  static absl::StatusOr<FieldProfile> Load(const std::string& path);
+
+  // Returns the presence probability of `field`, or nullopt if the profile has
+  // no data for it.
+  absl::optional<float> GetPresenceProbability(
+      const FieldDescriptor* field) const;
+
+  bool empty() const { return presence_.empty(); }
+
+ private:
+  absl::flat_hash_map<std::string, float> presence_;
+};
+
+}  // namespace cpp
+}  // namespace compiler
+}  // namespace protobuf
+}  // namespace google
+
+#endif  // GOOGLE_PROTOBUF_COMPILER_CPP_FIELD_PROFILE_H__
@@ -899,6 +899,12 @@ void FileGenerator::GenerateGlobalSource(io::Printer* p) {
   }
 }
 
+void FileGenerator::GenerateLayoutReport(io::Printer* p) {
+  for (const auto& generator : message_generators_) {
+    generator->GenerateLayoutReport(p);
+  }
+}
+
 void FileGenerator::GenerateSource(io::Printer* p) {
   auto v = p->WithVars(FileVars(file_, options_));
 
@@ -1380,11 +1386,25 @@ void FileGenerator::GenerateReflectionInitializationCode(io::Printer* p) {
         });
       }
     }
-    static_initializers_[kInitPriority102].push_back([](auto* p) {
+    if (options_.lazy_descriptor_registration) {
       p->Emit(R"cc(
-        ::_pbi::AddDescriptors(&$desc_table$),
+        //~ Emit wants an indented line, so give it a comment to strip.
+#ifdef PROTOBUF_DESCRIPTOR_TABLE_SECTION
+        PROTOBUF_DESCRIPTOR_TABLE_SECTION
+        static const ::_pbi::DescriptorTable* const $desc_table$_entry =
+            &$desc_table$;
+#else   // PROTOBUF_DESCRIPTOR_TABLE_SECTION
+        PROTOBUF_ATTRIBUTE_INIT_PRIORITY2
+        static ::_pbi::AddDescriptorsRunner $desc_table$_runner(&$desc_table$);
+#endif  // !PROTOBUF_DESCRIPTOR_TABLE_SECTION
       )cc");
-    });
+    } else {
+      static_initializers_[kInitPriority102].push_back([](auto* p) {
+        p->Emit(R"cc(
+          ::_pbi::AddDescriptors(&$desc_table$),
+        )cc");
+      });
+    }
   }
 
   // However, we must provide a way to force initialize the default instances
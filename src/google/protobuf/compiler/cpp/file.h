@@ -56,6 +56,10 @@ class PROTOC_EXPORT FileGenerator {
   void GeneratePBHeader(io::Printer* p, absl::string_view info_path);
   void GenerateSource(io::Printer* p);
 
+  // Generates a report of the estimated memory layout of every message in the
+  // file, for the layout_report option.
+  void GenerateLayoutReport(io::Printer* p);
+
   // The following member functions are used when the lite_implicit_weak_fields
   // option is set. In this mode the code is organized a bit differently to
   // promote better linker stripping of unused code. In particular, we generate
@@ -22,12 +22,15 @@
 #include "absl/log/absl_check.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/match.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "google/protobuf/compiler/code_generator.h"
+#include "google/protobuf/compiler/cpp/field_profile.h"
 #include "google/protobuf/compiler/cpp/file.h"
 #include "google/protobuf/compiler/cpp/helpers.h"
 #include "google/protobuf/compiler/cpp/options.h"
@@ -126,6 +129,34 @@ bool CppGenerator::Generate(const FileDescriptor* file,
   file_options.opensource_runtime = opensource_runtime_;
   file_options.runtime_include_base = runtime_include_base_;
 
+  // If the profile option is passed to the compiler, field presence
+  // probabilities are read from the given file (see field_profile.h) and used
+  // to order fields and group has-bit checks.
+  //
+  // If the auto_split option is passed to the compiler, fields that are rarely
+  // present according to the profile, and deprecated fields, are moved out of
+  // line into a separately allocated split struct. force_split splits every
+  // eligible field.
+  //
+  // If the auto_inline_string option is passed to the compiler, singular
+  // string fields that are likely present according to the profile are stored
+  // inline in the message (see inlined_string_field.h).
+  //
+  // If the layout_report option is passed to the compiler, a
+  // <basename>.pb.layout.txt file lists the estimated offset, size and cache
+  // line of every member of every message.
+  //
+  // If the arena_only option is passed to the compiler, the generated messages
+  // must be created on an arena. Their heap destructors no longer free fields,
+  // and constructing one without an arena fails a debug check.
+  //
+  // If the lazy_descriptor_registration option is passed to the compiler, the
+  // file's descriptor table is collected in a linker section and registered
+  // with the generated pool when the pool is first used. Files then run no
+  // static initializer for descriptor registration. On platforms without
+  // linker sections the registration stays in a static initializer.
+  absl::optional<FieldProfile> field_profile;
+
   for (const auto& option : options) {
     const auto& key = option.first;
     const auto& value = option.second;
@@ -188,6 +219,26 @@ bool CppGenerator::Generate(const FileDescriptor* file,
       file_options.force_eagerly_verified_lazy = true;
     } else if (key == "experimental_strip_nonfunctional_codegen") {
       file_options.strip_nonfunctional_codegen = true;
+    } else if (key == "layout_report") {
+      file_options.layout_report = true;
+    } else if (key == "arena_only") {
+      file_options.arena_only = true;
+    } else if (key == "lazy_descriptor_registration") {
+      file_options.lazy_descriptor_registration = true;
+    } else if (key == "force_split") {
+      file_options.force_split = true;
+    } else if (key == "auto_split") {
+      file_options.auto_split = true;
+    } else if (key == "auto_inline_string") {
+      file_options.auto_inline_string = true;
+    } else if (key == "profile") {
+      absl::StatusOr<FieldProfile> loaded = FieldProfile::Load(value);
+      if (!loaded.ok()) {
+        *error = std::string(loaded.status().message());
+        return false;
+      }
+      field_profile = *std::move(loaded);
+      file_options.field_profile = &*field_profile;
     } else {
       *error = absl::StrCat("Unknown generator option: ", key);
       return false;
@@ -345,6 +396,13 @@ bool CppGenerator::Generate(const FileDescriptor* file,
     file_generator.GenerateSource(&p);
   }
 
+  if (file_options.layout_report) {
+    auto output = absl::WrapUnique(
+        generator_context->Open(absl::StrCat(basename, ".pb.layout.txt")));
+    io::Printer p(output.get());
+    file_generator.GenerateLayoutReport(&p);
+  }
+
   return true;
 }
 
@@ -8,9 +8,11 @@
 #include "google/protobuf/compiler/cpp/generator.h"
 
 #include <memory>
+#include <string>
 
 #include "google/protobuf/descriptor.pb.h"
 #include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
 #include "google/protobuf/compiler/command_line_interface_tester.h"
 #include "google/protobuf/cpp_features.pb.h"
 
@@ -310,6 +312,226 @@ TEST_F(CppGeneratorTest, CtypeOnExtensionTest) {
       "Extension bar specifies CORD string type which is not supported for "
       "extensions");
 }
+
+TEST_F(CppGeneratorTest, Profile) {
+  CreateTempFile("foo.proto",
+                 R"schema(
+    syntax = "proto2";
+    message Foo {
+      optional int32 hot = 1;
+      optional int32 cold = 2;
+      optional string cold_string = 3;
+    })schema");
+  CreateTempFile("profile.txt",
+                 R"profile(
+    # Field presence probabilities.
+    Foo.hot 1.0
+    Foo.cold 0.0001
+    Foo.cold_string 0
+  )profile");
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir "
+      "--cpp_out=profile=$tmpdir/profile.txt:$tmpdir foo.proto");
+
+  ExpectNoErrors();
+}
+
+TEST_F(CppGeneratorTest, ProfileNotFound) {
+  CreateTempFile("foo.proto",
+                 R"schema(
+    syntax = "proto2";
+    message Foo {
+      optional int32 bar = 1;
+    })schema");
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir "
+      "--cpp_out=profile=$tmpdir/missing.txt:$tmpdir foo.proto");
+
+  ExpectErrorSubstring("Could not open profile file");
+}
+
+TEST_F(CppGeneratorTest, ProfileMalformed) {
+  CreateTempFile("foo.proto",
+                 R"schema(
+    syntax = "proto2";
+    message Foo {
+      optional int32 bar = 1;
+    })schema");
+  CreateTempFile("profile.txt", "Foo.bar 1.5\n");
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir "
+      "--cpp_out=profile=$tmpdir/profile.txt:$tmpdir foo.proto");
+
+  ExpectErrorSubstring("Invalid profile entry on line 1");
+}
+
+TEST_F(CppGeneratorTest, ProfileSerializePresencePattern) {
+  CreateTempFile("foo.proto",
+                 R"schema(
+    syntax = "proto2";
+    message Bar {}
+    message Foo {
+      optional int32 id = 1;
+      optional string name = 2;
+      optional Bar bar = 3;
+      optional int64 debug = 4;
+    })schema");
+  CreateTempFile("profile.txt",
+                 "Foo.id 1\nFoo.name 0.99\nFoo.bar 1\nFoo.debug 0\n");
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir "
+      "--cpp_out=profile=$tmpdir/profile.txt:$tmpdir foo.proto");
+
+  ExpectNoErrors();
+}
+
+TEST_F(CppGeneratorTest, AutoSplit) {
+  CreateTempFile("foo.proto",
+                 R"schema(
+    syntax = "proto2";
+    message Foo {
+      optional int32 hot = 1;
+      optional int32 legacy = 2 [deprecated = true];
+      optional string cold = 3;
+      repeated int64 cold_list = 4;
+      map<int32, int32> cold_map = 5;
+      oneof kind {
+        int32 cold_choice = 6;
+      }
+    })schema");
+  CreateTempFile("profile.txt",
+                 "Foo.cold 0\nFoo.cold_list 0\nFoo.cold_map 0\n"
+                 "Foo.cold_choice 0\n");
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir "
+      "--cpp_out=auto_split,profile=$tmpdir/profile.txt:$tmpdir foo.proto");
+
+  ExpectNoErrors();
+}
+
+TEST_F(CppGeneratorTest, AutoInlineString) {
+  CreateTempFile("foo.proto",
+                 R"schema(
+    syntax = "proto2";
+    message Foo {
+      optional string hot = 1;
+      optional bytes hot_bytes = 2;
+      optional string cold = 3;
+      repeated string names = 4;
+      oneof kind {
+        string text = 5;
+      }
+    })schema");
+  CreateTempFile("profile.txt",
+                 "Foo.hot 1\nFoo.hot_bytes 0.99\nFoo.cold 0\nFoo.names 1\n"
+                 "Foo.text 1\n");
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir "
+      "--cpp_out=auto_inline_string,profile=$tmpdir/profile.txt:$tmpdir "
+      "foo.proto");
+
+  ExpectNoErrors();
+}
+
+TEST_F(CppGeneratorTest, AutoInlineStringWithAutoSplit) {
+  CreateTempFile("foo.proto",
+                 R"schema(
+    syntax = "proto2";
+    message Foo {
+      optional string hot = 1;
+      optional string cold = 2;
+    })schema");
+  CreateTempFile("profile.txt", "Foo.hot 1\nFoo.cold 0\n");
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir "
+      "--cpp_out=auto_inline_string,auto_split,profile=$tmpdir/profile.txt:"
+      "$tmpdir foo.proto");
+
+  ExpectNoErrors();
+}
+
+TEST_F(CppGeneratorTest, ArenaOnly) {
+  CreateTempFile("foo.proto",
+                 R"schema(
+    syntax = "proto2";
+    message Foo {
+      optional string name = 1;
+      optional Foo child = 2;
+      repeated int32 values = 3;
+      oneof kind {
+        string text = 4;
+      }
+    })schema");
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir "
+      "--cpp_out=arena_only:$tmpdir foo.proto");
+
+  ExpectNoErrors();
+}
+
+TEST_F(CppGeneratorTest, LazyDescriptorRegistration) {
+  CreateTempFile("foo.proto",
+                 R"schema(
+    syntax = "proto2";
+    message Foo {
+      optional int32 bar = 1;
+    })schema");
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir "
+      "--cpp_out=lazy_descriptor_registration:$tmpdir foo.proto");
+
+  ExpectNoErrors();
+}
+
+TEST_F(CppGeneratorTest, LayoutReport) {
+  CreateTempFile("foo.proto",
+                 R"schema(
+    syntax = "proto2";
+    message Foo {
+      optional int32 a = 1;
+      optional int64 b = 2;
+      optional string s = 3;
+    })schema");
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir "
+      "--cpp_out=layout_report:$tmpdir foo.proto");
+
+  ExpectNoErrors();
+  ExpectFileContent("foo.pb.layout.txt",
+                    "Foo: ~44 bytes, 1 cache line(s)\n"
+                    "  offset  size line  member\n"
+                    "      16     4    0  _has_bits_\n"
+                    "      20     4    0  _cached_size_\n"
+                    "      24     8    0  s\n"
+                    "      32     8    0  b\n"
+                    "      40     4    0  a\n"
+                    "\n");
+}
+
+TEST_F(CppGeneratorTest, WideMessageClear) {
+  std::string schema = "syntax = \"proto2\";\nmessage Foo {\n";
+  for (int i = 1; i <= 40; ++i) {
+    absl::StrAppend(&schema, "  optional int32 i", i, " = ", i, ";\n");
+    absl::StrAppend(&schema, "  optional string s", i, " = ", 100 + i, ";\n");
+  }
+  absl::StrAppend(&schema, "}\n");
+  CreateTempFile("foo.proto", schema);
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir --cpp_out=$tmpdir foo.proto");
+
+  ExpectNoErrors();
+}
 }  // namespace
 }  // namespace cpp
 }  // namespace compiler
@@ -46,6 +46,7 @@
 #include "google/protobuf/arenastring.h"
 #include "google/protobuf/compiler/code_generator.h"
 #include "google/protobuf/compiler/code_generator_lite.h"
+#include "google/protobuf/compiler/cpp/field_profile.h"
 #include "google/protobuf/compiler/cpp/names.h"
 #include "google/protobuf/compiler/cpp/options.h"
 #include "google/protobuf/compiler/scc.h"
@@ -1034,23 +1035,37 @@ bool IsProfileDriven(const Options& options) {
          options.access_info_map != nullptr;
 }
 
+bool HasPresenceProfile(const Options& options) {
+  return IsProfileDriven(options) || options.field_profile != nullptr;
+}
+
+// Fields whose profiled presence probability lies below (above) this threshold
+// are treated as rarely (likely) present.
+static constexpr float kRarelyPresentThreshold = 0.005f;
+static constexpr float kLikelyPresentThreshold = 0.95f;
+
 bool IsRarelyPresent(const FieldDescriptor* field, const Options& options) {
-  return false;
+  absl::optional<float> probability = GetPresenceProbability(field, options);
+  return probability.has_value() && *probability < kRarelyPresentThreshold;
 }
 
 bool IsLikelyPresent(const FieldDescriptor* field, const Options& options) {
-  return false;
+  absl::optional<float> probability = GetPresenceProbability(field, options);
+  return probability.has_value() && *probability > kLikelyPresentThreshold;
 }
 
 absl::optional<float> GetPresenceProbability(const FieldDescriptor* field,
                                              const Options& options) {
+  if (options.field_profile != nullptr) {
+    return options.field_profile->GetPresenceProbability(field);
+  }
   return absl::nullopt;
 }
 
 absl::optional<float> GetFieldGroupPresenceProbability(
     const std::vector<const FieldDescriptor*>& fields, const Options& options) {
   ABSL_DCHECK(!fields.empty());
-  if (!IsProfileDriven(options)) return absl::nullopt;
+  if (!HasPresenceProfile(options)) return absl::nullopt;
 
   double all_absent_probability = 1.0;
 
@@ -1065,7 +1080,8 @@ absl::optional<float> GetFieldGroupPresenceProbability(
 }
 
 bool IsStringInliningEnabled(const Options& options) {
-  return options.force_inline_string || IsProfileDriven(options);
+  return options.force_inline_string || IsProfileDriven(options) ||
+         (options.auto_inline_string && options.field_profile != nullptr);
 }
 
 bool CanStringBeInlined(const FieldDescriptor* field) {
@@ -1086,9 +1102,15 @@ bool CanStringBeInlined(const FieldDescriptor* field) {
 }
 
 bool IsStringInlined(const FieldDescriptor* field, const Options& options) {
-  (void)field;
-  (void)options;
-  return false;
+  if (!IsStringInliningEnabled(options) || !CanStringBeInlined(field)) {
+    return false;
+  }
+  // The donated bits of inlined strings live in the message, not in the split
+  // struct.
+  if (ShouldSplit(field, options)) return false;
+  // A field that is almost always set always pays for a std::string anyway;
+  // inlining it saves an allocation and an indirection on every access.
+  return options.auto_inline_string && IsLikelyPresent(field, options);
 }
 
 static bool HasLazyFields(const Descriptor* descriptor, const Options& options,
@@ -1154,8 +1176,43 @@ VerifySimpleType ShouldVerifySimple(const Descriptor* descriptor) {
   return VerifySimpleType::kCustom;
 }
 
-bool ShouldSplit(const Descriptor*, const Options&) { return false; }
-bool ShouldSplit(const FieldDescriptor*, const Options&) { return false; }
+// Returns true if `field` can be stored in the split struct of its message.
+static bool CanSplit(const FieldDescriptor* field, const Options& options) {
+  if (options.bootstrap) return false;
+  const Descriptor* desc = field->containing_type();
+  if (IsMapEntryMessage(desc) || desc->options().message_set_wire_format()) {
+    return false;
+  }
+  return !field->is_required() && !field->is_map() &&
+         !field->real_containing_oneof() && !IsWeak(field, options);
+}
+
+// Cold fields are rarely present according to the profile, or deprecated and
+// therefore unlikely to be set by current code.
+static bool IsColdField(const FieldDescriptor* field, const Options& options) {
+  return IsRarelyPresent(field, options) || field->options().deprecated();
+}
+
+bool ShouldSplit(const Descriptor* desc, const Options& options) {
+  if (!options.force_split && !options.auto_split) return false;
+  for (int i = 0; i < desc->field_count(); ++i) {
+    if (ShouldSplit(desc->field(i), options)) return true;
+  }
+  return false;
+}
+
+bool ShouldSplit(const FieldDescriptor* field, const Options& options) {
+  if (!CanSplit(field, options)) return false;
+  if (options.force_split) return true;
+  return options.auto_split && IsColdField(field, options);
+}
+
+bool HasUncachedByteSize(const Descriptor* desc, const Options& options) {
+  return desc->field_count() != 0 && !HasSimpleBaseClass(desc, options) &&
+         HasGeneratedMethods(desc->file(), options) &&
+         !desc->options().message_set_wire_format() &&
+         !IsMapEntryMessage(desc) && internal::cpp::IsSmallLeafMessage(desc);
+}
 
 bool ShouldForceAllocationOnConstruction(const Descriptor* desc,
                                          const Options& options) {
@@ -360,10 +360,14 @@ inline bool IsString(const FieldDescriptor* field) {
 
 bool IsProfileDriven(const Options& options);
 
-// Returns true if `field` is unlikely to be present based on PDProto profile.
+// Returns true if field presence probabilities are available, either from a
+// PDProto profile or from a profile loaded with the `profile` option.
+bool HasPresenceProfile(const Options& options);
+
+// Returns true if `field` is unlikely to be present based on the profile.
 bool IsRarelyPresent(const FieldDescriptor* field, const Options& options);
 
-// Returns true if `field` is likely to be present based on PDProto profile.
+// Returns true if `field` is likely to be present based on the profile.
 bool IsLikelyPresent(const FieldDescriptor* field, const Options& options);
 
 absl::optional<float> GetPresenceProbability(const FieldDescriptor* field,
@@ -381,8 +385,9 @@ bool IsStringInliningEnabled(const Options& options);
 // Returns true if the provided field is a singular string and can be inlined.
 bool CanStringBeInlined(const FieldDescriptor* field);
 
-// Returns true if `field` is a string field that can and should be inlined
-// based on PDProto profile.
+// Returns true if `field` is a string field that can and should be inlined:
+// `auto_inline_string` is set and the profile says that the field is likely
+// present.
 bool IsStringInlined(const FieldDescriptor* field, const Options& options);
 
 // Returns true if `field` should be inlined based on PDProto profile.
@@ -878,6 +883,14 @@ inline bool HasImplData(const Descriptor* desc, const Options& options) {
   return !HasSimpleBaseClass(desc, options);
 }
 
+// Returns true if this message is a small leaf, whose size is cheap enough to
+// compute that its parents recompute it with UncachedByteSizeLong() instead of
+// caching it in _cached_size_ between ByteSizeLong() and serialization.
+//
+// Parents in other files rely on this, so besides the descriptor it only looks
+// at options that are the same for every file of a build.
+bool HasUncachedByteSize(const Descriptor* desc, const Options& options);
+
 // DO NOT USE IN NEW CODE! Use io::Printer directly instead. See b/242326974.
 //
 // Formatter is a functor class which acts as a closure around printer and
@@ -588,7 +588,7 @@ bool MaybeEmitHaswordsCheck(ChunkIterator it, ChunkIterator end,
                             const std::vector<int>& has_bit_indices,
                             int cached_has_word_index, const std::string& from,
                             io::Printer* p) {
-  if (!it->has_hasbit || !IsProfileDriven(options) ||
+  if (!it->has_hasbit || !HasPresenceProfile(options) ||
       std::distance(it, end) < 2 || !it->is_rarely_present) {
     return false;
   }
@@ -2046,6 +2046,12 @@ void MessageGenerator::GenerateClassDefinition(io::Printer* p) {
        {"decl_non_simple_base",
         [&] {
           if (HasSimpleBaseClass(descriptor_, options_)) return;
+          if (HasUncachedByteSize(descriptor_, options_)) {
+            p->Emit(R"cc(
+              // Like ByteSizeLong(), without storing the size in the message.
+              ::size_t UncachedByteSizeLong() const;
+            )cc");
+          }
           p->Emit(
               R"cc(
                 int GetCachedSize() const { return $cached_size$.Get(); }
@@ -2382,6 +2388,73 @@ void MessageGenerator::GenerateInlineMethods(io::Printer* p) {
   }
 }
 
+void MessageGenerator::GenerateLayoutReport(io::Printer* p) const {
+  // Mirrors the member order of GenerateImplDefinition(). Offsets are
+  // estimates for a 64-bit target, counting the vtable and internal metadata
+  // of the base class and assuming the object starts on a cache line.
+  constexpr int kCacheLineSize = 64;
+  int offset = 16;
+  std::string rows;
+  auto add_member = [&](absl::string_view name, int size, int align,
+                        absl::string_view note) {
+    offset = (offset + align - 1) / align * align;
+    absl::StrAppendFormat(&rows, "  %6d %5d %4d  %s%s\n", offset, size,
+                          offset / kCacheLineSize, name, note);
+    offset += size;
+  };
+  auto presence_note = [&](const FieldDescriptor* field) -> absl::string_view {
+    if (IsLikelyPresent(field, options_)) return " [likely]";
+    if (IsRarelyPresent(field, options_)) return " [rarely]";
+    return "";
+  };
+
+  bool need_cached_size = !HasSimpleBaseClass(descriptor_, options_);
+  if (descriptor_->extension_range_count() > 0) {
+    add_member("_extensions_", 24, 8, "");
+  }
+  if (!inlined_string_indices_.empty()) {
+    add_member("_inlined_string_donated_",
+               4 * static_cast<int>(InlinedStringDonatedSize()), 4, "");
+  }
+  if (!has_bit_indices_.empty()) {
+    add_member("_has_bits_", 4 * static_cast<int>(HasBitsSize()), 4, "");
+    if (need_cached_size) {
+      add_member("_cached_size_", 4, 4, "");
+      need_cached_size = false;
+    }
+  }
+  int split_fields = 0;
+  for (auto field : optimized_order_) {
+    if (ShouldSplit(field, options_)) {
+      ++split_fields;
+      continue;
+    }
+    add_member(field->name(), EstimateSize(field), EstimateAlignmentSize(field),
+               presence_note(field));
+  }
+  if (split_fields > 0) {
+    add_member("_split_", 8, 8,
+               absl::StrCat(" [", split_fields, " split fields]"));
+  }
+  for (auto oneof : OneOfRange(descriptor_)) {
+    int size = 0;
+    for (auto field : FieldRange(oneof)) {
+      size = std::max(size, EstimateSize(field));
+    }
+    add_member(absl::StrCat(oneof->name(), "_"), size, 8, "");
+  }
+  if (need_cached_size) add_member("_cached_size_", 4, 4, "");
+  if (descriptor_->real_oneof_decl_count() > 0) {
+    add_member("_oneof_case_", 4 * descriptor_->real_oneof_decl_count(), 4,
+               "");
+  }
+
+  p->PrintRaw(absl::StrFormat(
+      "%s: ~%d bytes, %d cache line(s)\n  offset  size line  member\n%s\n",
+      descriptor_->full_name(), offset,
+      (offset + kCacheLineSize - 1) / kCacheLineSize, rows));
+}
+
 void MessageGenerator::GenerateSchema(io::Printer* p, int offset,
                                       int has_offset) {
   has_offset = !has_bit_indices_.empty() || IsMapEntryMessage(descriptor_)
@@ -2997,6 +3070,8 @@ void MessageGenerator::GenerateInitDefaultSplitInstance(io::Printer* p) {
 void MessageGenerator::GenerateSharedDestructorCode(io::Printer* p) {
   if (HasSimpleBaseClass(descriptor_, options_)) return;
   auto emit_field_dtors = [&](bool split_fields) {
+    // Arena-only messages never own their fields, so there is nothing to free.
+    if (options_.arena_only) return;
     // Write the destructors for each field except oneof members.
     // optimized_order_ does not contain oneof fields.
     for (const auto* field : optimized_order_) {
@@ -3009,7 +3084,9 @@ void MessageGenerator::GenerateSharedDestructorCode(io::Printer* p) {
           {"field_dtors", [&] { emit_field_dtors(/* split_fields= */ false); }},
           {"split_field_dtors",
            [&] {
-             if (!ShouldSplit(descriptor_, options_)) return;
+             if (!ShouldSplit(descriptor_, options_) || options_.arena_only) {
+               return;
+             }
              p->Emit(
                  {
                      {"split_field_dtors_impl",
@@ -3025,6 +3102,7 @@ void MessageGenerator::GenerateSharedDestructorCode(io::Printer* p) {
            }},
           {"oneof_field_dtors",
            [&] {
+             if (options_.arena_only) return;
              for (const auto* oneof : OneOfRange(descriptor_)) {
                p->Emit({{"name", oneof->name()}},
                        R"cc(
@@ -3036,7 +3114,7 @@ void MessageGenerator::GenerateSharedDestructorCode(io::Printer* p) {
            }},
           {"weak_fields_dtor",
            [&] {
-             if (num_weak_fields_ == 0) return;
+             if (num_weak_fields_ == 0 || options_.arena_only) return;
              // Generate code to destruct oneofs. Clearing should do the work.
              p->Emit(R"cc(
                this_.$weak_field_map$.ClearAll();
@@ -3463,9 +3541,18 @@ void MessageGenerator::GenerateStructors(io::Printer* p) {
           {"ctor_body",
            [&] {
              if (HasSimpleBaseClass(descriptor_, options_)) return;
+             if (options_.arena_only) {
+               p->Emit(R"cc($DCHK$(arena != nullptr);)cc");
+             }
              p->Emit(R"cc(SharedCtor(arena);)cc");
              switch (NeedsArenaDestructor()) {
                case ArenaDtorNeeds::kRequired: {
+                 if (options_.arena_only) {
+                   p->Emit(R"cc(
+                     arena->OwnCustomDestructor(this, &$classname$::ArenaDtor);
+                   )cc");
+                   break;
+                 }
                  p->Emit(R"cc(
                    if (arena != nullptr) {
                      arena->OwnCustomDestructor(this, &$classname$::ArenaDtor);
@@ -3583,6 +3670,8 @@ void MessageGenerator::GenerateClear(io::Printer* p) {
   // The maximum number of bytes we will memset to zero without checking their
   // hasbit to see if a zero-init is necessary.
   const int kMaxUnconditionalPrimitiveBytesClear = 4;
+  // The same, for the bulk clear of wide messages described below.
+  const int kMaxUnconditionalBulkClearBytes = 128;
 
   format(
       "PROTOBUF_NOINLINE void $classname$::Clear() {\n"
@@ -3602,10 +3691,63 @@ void MessageGenerator::GenerateClear(io::Printer* p) {
     format("$extensions$.Clear();\n");
   }
 
+  // Wide messages (more than one has-bit word) get two extra strategies:
+  // - The longest run of zero-initializable fields is cleared with a single
+  //   unconditional memset if it is small, or likely populated according to
+  //   the profile. That is cheaper than testing its has-bits chunk by chunk.
+  // - Chunks that share a has-bit word are skipped together when the word is
+  //   zero, so clearing a mostly empty message costs one test per word.
+  const bool is_wide = HasBitsSize() > 1;
+  std::vector<const FieldDescriptor*> chunk_fields = optimized_order_;
+  const FieldDescriptor* bulk_start = nullptr;
+  const FieldDescriptor* bulk_end = nullptr;
+  if (is_wide) {
+    auto can_bulk_clear = [&](const FieldDescriptor* field) {
+      return CanClearByZeroing(field) && !ShouldSplit(field, options_);
+    };
+    auto run_begin = chunk_fields.end();
+    auto run_end = chunk_fields.end();
+    for (auto i = chunk_fields.begin(); i != chunk_fields.end();) {
+      if (!can_bulk_clear(*i)) {
+        ++i;
+        continue;
+      }
+      auto j = std::find_if_not(i, chunk_fields.end(), can_bulk_clear);
+      if (j - i > run_end - run_begin) {
+        run_begin = i;
+        run_end = j;
+      }
+      i = j;
+    }
+    if (run_end - run_begin > 1) {
+      int run_bytes = 0;
+      for (auto i = run_begin; i != run_end; ++i) {
+        int align = EstimateAlignmentSize(*i);
+        run_bytes = (run_bytes + align - 1) / align * align + EstimateSize(*i);
+      }
+      std::vector<const FieldDescriptor*> run(run_begin, run_end);
+      absl::optional<float> probability =
+          GetFieldGroupPresenceProbability(run, options_);
+      if (run_bytes <= kMaxUnconditionalBulkClearBytes ||
+          (probability.has_value() && *probability >= 0.5f)) {
+        bulk_start = run.front();
+        bulk_end = run.back();
+        chunk_fields.erase(run_begin, run_end);
+      }
+    }
+  }
+  if (bulk_start != nullptr) {
+    format(
+        "::memset(&$1$, 0, static_cast<::size_t>(\n"
+        "    reinterpret_cast<char*>(&$2$) -\n"
+        "    reinterpret_cast<char*>(&$1$)) + sizeof($2$));\n",
+        FieldMemberName(bulk_start, false), FieldMemberName(bulk_end, false));
+  }
+
   // Collect fields into chunks. Each chunk may have an if() condition that
   // checks all hasbits in the chunk and skips it if none are set.
   int zero_init_bytes = 0;
-  for (const auto& field : optimized_order_) {
+  for (const auto& field : chunk_fields) {
     if (CanClearByZeroing(field)) {
       zero_init_bytes += EstimateAlignmentSize(field);
     }
@@ -3614,7 +3756,7 @@ void MessageGenerator::GenerateClear(io::Printer* p) {
   int chunk_count = 0;
 
   std::vector<FieldChunk> chunks = CollectFields(
-      optimized_order_, options_,
+      chunk_fields, options_,
       [&](const FieldDescriptor* a, const FieldDescriptor* b) -> bool {
         chunk_count++;
         // This predicate guarantees that there is only a single zero-init
@@ -3630,9 +3772,107 @@ void MessageGenerator::GenerateClear(io::Printer* p) {
         return same;
       });
 
+  int cached_has_word_index = -1;
+  auto emit_chunk = [&](const FieldChunk& chunk) {
+    const std::vector<const FieldDescriptor*>& fields = chunk.fields;
+    bool chunk_is_split = chunk.should_split;
+
+    const FieldDescriptor* memset_start = nullptr;
+    const FieldDescriptor* memset_end = nullptr;
+    bool saw_non_zero_init = false;
+
+    for (const auto& field : fields) {
+      if (CanClearByZeroing(field)) {
+        ABSL_CHECK(!saw_non_zero_init);
+        if (!memset_start) memset_start = field;
+        memset_end = field;
+      } else {
+        saw_non_zero_init = true;
+      }
+    }
+
+    // Whether we wrap this chunk in:
+    //   if (cached_has_bits & <chunk hasbits) { /* chunk. */ }
+    // We can omit the if() for chunk size 1, or if our fields do not have
+    // hasbits. I don't understand the rationale for the last part of the
+    // condition, but it matches the old logic.
+    const bool check_has_byte =
+        HasBitIndex(fields.front()) != kNoHasbit && fields.size() > 1 &&
+        !IsLikelyPresent(fields.back(), options_) &&
+        (memset_end != fields.back() || merge_zero_init);
+
+    DebugAssertUniformLikelyPresence(fields, options_);
+
+    if (check_has_byte) {
+      // Emit an if() that will let us skip the whole chunk if none are set.
+      uint32_t chunk_mask = GenChunkMask(fields, has_bit_indices_);
+
+      // Check (up to) 8 has_bits at a time if we have more than one field in
+      // this chunk.  Due to field layout ordering, we may check
+      // _has_bits_[last_chunk * 8 / 32] multiple times.
+      ABSL_DCHECK_LE(2, popcnt(chunk_mask));
+      ABSL_DCHECK_GE(8, popcnt(chunk_mask));
+
+      if (cached_has_word_index != HasWordIndex(fields.front())) {
+        cached_has_word_index = HasWordIndex(fields.front());
+        format("cached_has_bits = $has_bits$[$1$];\n", cached_has_word_index);
+      }
+
+      format("if ($1$) {\n", GenerateConditionMaybeWithProbabilityForGroup(
+                                 chunk_mask, fields, options_));
+      format.Indent();
+    }
+
+    if (memset_start) {
+      if (memset_start == memset_end) {
+        // For clarity, do not memset a single field.
+        field_generators_.get(memset_start).GenerateMessageClearingCode(p);
+      } else {
+        ABSL_CHECK_EQ(chunk_is_split, ShouldSplit(memset_start, options_));
+        ABSL_CHECK_EQ(chunk_is_split, ShouldSplit(memset_end, options_));
+        format(
+            "::memset(&$1$, 0, static_cast<::size_t>(\n"
+            "    reinterpret_cast<char*>(&$2$) -\n"
+            "    reinterpret_cast<char*>(&$1$)) + sizeof($2$));\n",
+            FieldMemberName(memset_start, chunk_is_split),
+            FieldMemberName(memset_end, chunk_is_split));
+      }
+    }
+
+    // Clear all non-zero-initializable fields in the chunk.
+    for (const auto& field : fields) {
+      if (CanClearByZeroing(field)) continue;
+      // It's faster to just overwrite primitive types, but we should only
+      // clear strings and messages if they were set.
+      //
+      // TODO:  Let the CppFieldGenerator decide this somehow.
+      bool have_enclosing_if =
+          HasBitIndex(field) != kNoHasbit &&
+          (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE ||
+           field->cpp_type() == FieldDescriptor::CPPTYPE_STRING);
+
+      if (have_enclosing_if) {
+        PrintPresenceCheck(field, has_bit_indices_, p, &cached_has_word_index,
+                           options_);
+        format.Indent();
+      }
+
+      field_generators_.get(field).GenerateMessageClearingCode(p);
+
+      if (have_enclosing_if) {
+        format.Outdent();
+        format("}\n");
+      }
+    }
+
+    if (check_has_byte) {
+      format.Outdent();
+      format("}\n");
+    }
+  };
+
   auto it = chunks.begin();
   auto end = chunks.end();
-  int cached_has_word_index = -1;
   while (it != end) {
     auto next = FindNextUnequalChunk(it, end, MayGroupChunksForHaswordsCheck);
     bool has_haswords_check = MaybeEmitHaswordsCheck(
@@ -3644,106 +3884,32 @@ void MessageGenerator::GenerateClear(io::Printer* p) {
       format("if (!IsSplitMessageDefault()) {\n");
       format.Indent();
     }
-    while (it != next) {
-      const std::vector<const FieldDescriptor*>& fields = it->fields;
-      bool chunk_is_split = it->should_split;
-      ABSL_CHECK_EQ(has_default_split_check, chunk_is_split);
-
-      const FieldDescriptor* memset_start = nullptr;
-      const FieldDescriptor* memset_end = nullptr;
-      bool saw_non_zero_init = false;
-
-      for (const auto& field : fields) {
-        if (CanClearByZeroing(field)) {
-          ABSL_CHECK(!saw_non_zero_init);
-          if (!memset_start) memset_start = field;
-          memset_end = field;
-        } else {
-          saw_non_zero_init = true;
+    if (is_wide && !has_haswords_check && it->has_hasbit &&
+        !it->should_split) {
+      while (it != next) {
+        int word = HasWordIndex(it->fields.front());
+        auto word_end = it;
+        while (word_end != next &&
+               HasWordIndex(word_end->fields.front()) == word) {
+          ++word_end;
         }
-      }
-
-      // Whether we wrap this chunk in:
-      //   if (cached_has_bits & <chunk hasbits) { /* chunk. */ }
-      // We can omit the if() for chunk size 1, or if our fields do not have
-      // hasbits. I don't understand the rationale for the last part of the
-      // condition, but it matches the old logic.
-      const bool check_has_byte =
-          HasBitIndex(fields.front()) != kNoHasbit && fields.size() > 1 &&
-          !IsLikelyPresent(fields.back(), options_) &&
-          (memset_end != fields.back() || merge_zero_init);
-
-      DebugAssertUniformLikelyPresence(fields, options_);
-
-      if (check_has_byte) {
-        // Emit an if() that will let us skip the whole chunk if none are set.
-        uint32_t chunk_mask = GenChunkMask(fields, has_bit_indices_);
-
-        // Check (up to) 8 has_bits at a time if we have more than one field in
-        // this chunk.  Due to field layout ordering, we may check
-        // _has_bits_[last_chunk * 8 / 32] multiple times.
-        ABSL_DCHECK_LE(2, popcnt(chunk_mask));
-        ABSL_DCHECK_GE(8, popcnt(chunk_mask));
-
-        if (cached_has_word_index != HasWordIndex(fields.front())) {
-          cached_has_word_index = HasWordIndex(fields.front());
-          format("cached_has_bits = $has_bits$[$1$];\n", cached_has_word_index);
+        if (std::distance(it, word_end) < 2) {
+          emit_chunk(*it++);
+          continue;
         }
-
-        format("if ($1$) {\n", GenerateConditionMaybeWithProbabilityForGroup(
-                                   chunk_mask, fields, options_));
+        cached_has_word_index = word;
+        format("cached_has_bits = $has_bits$[$1$];\n", word);
+        format("if (cached_has_bits != 0) {\n");
         format.Indent();
-      }
-
-      if (memset_start) {
-        if (memset_start == memset_end) {
-          // For clarity, do not memset a single field.
-          field_generators_.get(memset_start).GenerateMessageClearingCode(p);
-        } else {
-          ABSL_CHECK_EQ(chunk_is_split, ShouldSplit(memset_start, options_));
-          ABSL_CHECK_EQ(chunk_is_split, ShouldSplit(memset_end, options_));
-          format(
-              "::memset(&$1$, 0, static_cast<::size_t>(\n"
-              "    reinterpret_cast<char*>(&$2$) -\n"
-              "    reinterpret_cast<char*>(&$1$)) + sizeof($2$));\n",
-              FieldMemberName(memset_start, chunk_is_split),
-              FieldMemberName(memset_end, chunk_is_split));
-        }
-      }
-
-      // Clear all non-zero-initializable fields in the chunk.
-      for (const auto& field : fields) {
-        if (CanClearByZeroing(field)) continue;
-        // It's faster to just overwrite primitive types, but we should only
-        // clear strings and messages if they were set.
-        //
-        // TODO:  Let the CppFieldGenerator decide this somehow.
-        bool have_enclosing_if =
-            HasBitIndex(field) != kNoHasbit &&
-            (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE ||
-             field->cpp_type() == FieldDescriptor::CPPTYPE_STRING);
-
-        if (have_enclosing_if) {
-          PrintPresenceCheck(field, has_bit_indices_, p, &cached_has_word_index,
-                             options_);
-          format.Indent();
-        }
-
-        field_generators_.get(field).GenerateMessageClearingCode(p);
-
-        if (have_enclosing_if) {
-          format.Outdent();
-          format("}\n");
-        }
-      }
-
-      if (check_has_byte) {
+        for (; it != word_end; ++it) emit_chunk(*it);
         format.Outdent();
         format("}\n");
       }
-
-      // To next chunk.
-      ++it;
+    } else {
+      for (; it != next; ++it) {
+        ABSL_CHECK_EQ(has_default_split_check, it->should_split);
+        emit_chunk(*it);
+      }
     }
 
     if (has_default_split_check) {
@@ -3794,31 +3960,34 @@ void MessageGenerator::GenerateOneofClear(io::Printer* p) {
         "// @@protoc_insertion_point(one_of_clear_start:$full_name$)\n");
     format.Indent();
     format("$pbi$::TSanWrite(&_impl_);\n");
-    format("switch ($oneofname$_case()) {\n");
-    format.Indent();
+    // We clear only allocated objects in oneofs.  The other members share the
+    // default case, which keeps the switch as small as the number of members
+    // that own memory, however large the oneof.
+    bool has_allocated_members = false;
     for (auto field : FieldRange(oneof)) {
-      format("case k$1$: {\n", UnderscoresToCamelCase(field->name(), true));
+      if (IsStringOrMessage(field)) has_allocated_members = true;
+    }
+    if (has_allocated_members) {
+      format("switch ($oneofname$_case()) {\n");
       format.Indent();
-      // We clear only allocated objects in oneofs
-      if (!IsStringOrMessage(field)) {
-        format("// No need to clear\n");
-      } else {
+      for (auto field : FieldRange(oneof)) {
+        if (!IsStringOrMessage(field)) continue;
+        format("case k$1$: {\n", UnderscoresToCamelCase(field->name(), true));
+        format.Indent();
         field_generators_.get(field).GenerateClearingCode(p);
+        format("break;\n");
+        format.Outdent();
+        format("}\n");
       }
-      format("break;\n");
+      format(
+          "default: {\n"
+          "  break;\n"
+          "}\n");
       format.Outdent();
       format("}\n");
     }
-    format(
-        "case $1$_NOT_SET: {\n"
-        "  break;\n"
-        "}\n",
-        absl::AsciiStrToUpper(oneof->name()));
-    format.Outdent();
-    format(
-        "}\n"
-        "$oneof_case$[$1$] = $2$_NOT_SET;\n",
-        i, absl::AsciiStrToUpper(oneof->name()));
+    format("$oneof_case$[$1$] = $2$_NOT_SET;\n", i,
+           absl::AsciiStrToUpper(oneof->name()));
     format.Outdent();
     format(
         "}\n"
@@ -4191,6 +4360,9 @@ void MessageGenerator::GenerateClassData(io::Printer* p) {
              }},
         },
         R"cc(
+          PROTOBUF_CONSTINIT static $pbi$::ClassDataFull::ReflectionData
+              $classname$_reflection_data_;
+
           constexpr auto $classname$::InternalGenerateClassData_() {
             return $pbi$::ClassDataFull{
                 $pbi$::ClassData{
@@ -4210,6 +4382,7 @@ void MessageGenerator::GenerateClassData(io::Printer* p) {
                 },
                 &$classname$::kDescriptorMethods,
                 &$desc_table$,
+                &$classname$_reflection_data_,
                 $tracker_on_get_metadata$,
             };
           }
@@ -4362,6 +4535,36 @@ void MessageGenerator::GenerateClassSpecificMergeImpl(io::Printer* p) {
         format.Indent();
       }
 
+      // A run of scalars can be copied with a single memcpy when none of them
+      // is set in the destination, e.g. in CopyFrom(): unset fields hold their
+      // default value on both sides, as the copy constructor also assumes.
+      const bool memcpy_chunk =
+          cache_has_bits && fields.size() > 1 &&
+          absl::c_all_of(fields, [&](const FieldDescriptor* field) {
+            return IsPOD(field) && !ShouldSplit(field, options_) &&
+                   GetFieldHasbitMode(field) == HasbitMode::kTrueHasbit;
+          });
+      if (memcpy_chunk) {
+        p->Emit({{"index", HasWordIndex(fields.front())},
+                 {"mask", absl::StrFormat(
+                              "0x%08xu",
+                              GenChunkMask(fields, has_bit_indices_))},
+                 {"first", FieldName(fields.front())},
+                 {"last", FieldName(fields.back())}},
+                R"cc(
+                  if ((_this->$has_bits$[$index$] & $mask$) == 0) {
+                    ::memcpy(reinterpret_cast<char*>(&_this->_impl_) +
+                                 offsetof(Impl_, $first$_),
+                             reinterpret_cast<const char*>(&from._impl_) +
+                                 offsetof(Impl_, $first$_),
+                             offsetof(Impl_, $last$_) -
+                                 offsetof(Impl_, $first$_) +
+                                 sizeof(Impl_::$last$_));
+                  } else {
+                )cc");
+        p->Indent();
+      }
+
       // Go back and emit merging code for each of the fields we processed.
       for (const auto* field : fields) {
         const auto& generator = field_generators_.get(field);
@@ -4415,6 +4618,13 @@ void MessageGenerator::GenerateClassSpecificMergeImpl(io::Printer* p) {
         }
       }
 
+      if (memcpy_chunk) {
+        p->Outdent();
+        p->Emit(R"cc(
+          }
+        )cc");
+      }
+
       if (check_has_byte) {
         format.Outdent();
         format("}\n");
@@ -4658,6 +4868,31 @@ void MessageGenerator::GenerateSerializeOneField(io::Printer* p,
   p->Emit("\n");
 }
 
+absl::optional<uint32_t> MessageGenerator::CommonSerializePresencePattern()
+    const {
+  // Only messages whose fields all live in the first has-bit word qualify, and
+  // every field must be predicted either present or absent. A field without
+  // explicit presence also needs a non-default check, so it does not qualify.
+  if (!HasPresenceProfile(options_) || HasBitsSize() != 1 ||
+      descriptor_->field_count() < 2 ||
+      descriptor_->extension_range_count() > 0 || num_weak_fields_ > 0) {
+    return absl::nullopt;
+  }
+  uint32_t pattern = 0;
+  for (const auto* field : FieldRange(descriptor_)) {
+    if (!HasHasbit(field) || !field->has_presence() ||
+        field->real_containing_oneof() != nullptr) {
+      return absl::nullopt;
+    }
+    if (IsLikelyPresent(field, options_)) {
+      pattern |= uint32_t{1} << HasBitIndex(field);
+    } else if (!IsRarelyPresent(field, options_)) {
+      return absl::nullopt;
+    }
+  }
+  return pattern;
+}
+
 void MessageGenerator::GenerateSerializeOneExtensionRange(io::Printer* p,
                                                           int start, int end) {
   auto v = p->WithVars(variables_);
@@ -4897,6 +5132,38 @@ void MessageGenerator::GenerateSerializeWithCachedSizesBody(io::Printer* p) {
   }
   std::sort(sorted_extensions.begin(), sorted_extensions.end(),
             ExtensionRangeSorter());
+  auto emit_fields = [&] {
+    // Merge fields and extension ranges, sorted by field number.
+    LazySerializerEmitter e(this, p);
+    LazyExtensionRangeEmitter re(this, p);
+    LargestWeakFieldHolder largest_weak_field;
+    size_t i, j;
+    for (i = 0, j = 0;
+         i < ordered_fields.size() || j < sorted_extensions.size();) {
+      bool no_more_extensions = j == sorted_extensions.size();
+      if (no_more_extensions ||
+          (i < static_cast<size_t>(descriptor_->field_count()) &&
+           ordered_fields[i]->number() <
+               sorted_extensions[j]->start_number())) {
+        const FieldDescriptor* field = ordered_fields[i++];
+        re.Flush(no_more_extensions);
+        if (field->options().weak()) {
+          largest_weak_field.ReplaceIfLarger(field);
+          PrintFieldComment(Formatter{p}, field, options_);
+        } else {
+          e.EmitIfNotNull(largest_weak_field.Release());
+          e.Emit(field);
+        }
+      } else {
+        e.EmitIfNotNull(largest_weak_field.Release());
+        e.Flush();
+        re.AddToRange(sorted_extensions[j++]);
+      }
+    }
+    re.Flush(/*is_last_range=*/true);
+    e.EmitIfNotNull(largest_weak_field.Release());
+  };
+
   p->Emit(
       {
           {"handle_weak_fields",
@@ -4907,37 +5174,36 @@ void MessageGenerator::GenerateSerializeWithCachedSizesBody(io::Printer* p) {
                    this_.$weak_field_map$);
              )cc");
            }},
-          {"handle_lazy_fields",
+          {"handle_fields",
            [&] {
-             // Merge fields and extension ranges, sorted by field number.
-             LazySerializerEmitter e(this, p);
-             LazyExtensionRangeEmitter re(this, p);
-             LargestWeakFieldHolder largest_weak_field;
-             size_t i, j;
-             for (i = 0, j = 0;
-                  i < ordered_fields.size() || j < sorted_extensions.size();) {
-               bool no_more_extensions = j == sorted_extensions.size();
-               if (no_more_extensions ||
-                   (i < static_cast<size_t>(descriptor_->field_count()) &&
-                    ordered_fields[i]->number() <
-                        sorted_extensions[j]->start_number())) {
-                 const FieldDescriptor* field = ordered_fields[i++];
-                 re.Flush(no_more_extensions);
-                 if (field->options().weak()) {
-                   largest_weak_field.ReplaceIfLarger(field);
-                   PrintFieldComment(Formatter{p}, field, options_);
-                 } else {
-                   e.EmitIfNotNull(largest_weak_field.Release());
-                   e.Emit(field);
-                 }
-               } else {
-                 e.EmitIfNotNull(largest_weak_field.Release());
-                 e.Flush();
-                 re.AddToRange(sorted_extensions[j++]);
-               }
+             absl::optional<uint32_t> pattern =
+                 CommonSerializePresencePattern();
+             if (!pattern.has_value()) {
+               emit_fields();
+               return;
              }
-             re.Flush(/*is_last_range=*/true);
-             e.EmitIfNotNull(largest_weak_field.Release());
+             // The expected presence pattern is written without any per-field
+             // branches.
+             p->Emit({{"pattern", absl::StrFormat("0x%08xu", *pattern)},
+                      {"fields",
+                       [&] {
+                         for (const auto* field : ordered_fields) {
+                           if (!IsLikelyPresent(field, options_)) continue;
+                           auto v = p->WithVars(FieldVars(field, options_));
+                           PrintFieldComment(Formatter{p}, field, options_);
+                           field_generators_.get(field)
+                               .GenerateSerializeWithCachedSizesToArray(p);
+                         }
+                       }},
+                      {"other_patterns", emit_fields}},
+                     R"cc(
+                       cached_has_bits = this_._impl_._has_bits_[0];
+                       if (cached_has_bits == $pattern$) {
+                         $fields$;
+                       } else {
+                         $other_patterns$;
+                       }
+                     )cc");
            }},
           {"handle_unknown_fields",
            [&] {
@@ -4961,7 +5227,7 @@ void MessageGenerator::GenerateSerializeWithCachedSizesBody(io::Printer* p) {
         $uint32$ cached_has_bits = 0;
         (void)cached_has_bits;
 
-        $handle_lazy_fields$;
+        $handle_fields$;
         if (ABSL_PREDICT_FALSE(this_.$have_unknown_fields$)) {
           $handle_unknown_fields$;
         }
@@ -5176,8 +5442,44 @@ void MessageGenerator::GenerateByteSize(io::Printer* p) {
     chunks.insert(it, std::move(chunk));
   }
 
+  const bool uncached = HasUncachedByteSize(descriptor_, options_);
   p->Emit(
-      {{"handle_extension_set",
+      {{"signature",
+        [&] {
+          if (!uncached) {
+            p->Emit(R"cc(
+              //~ Emit wants an indented line, so give it a comment to strip.
+#if defined(PROTOBUF_CUSTOM_VTABLE)
+              ::size_t $classname$::ByteSizeLong(const MessageLite& base) {
+                const $classname$& this_ = static_cast<const $classname$&>(base);
+#else   // PROTOBUF_CUSTOM_VTABLE
+              ::size_t $classname$::ByteSizeLong() const {
+                const $classname$& this_ = *this;
+#endif  // PROTOBUF_CUSTOM_VTABLE
+            )cc");
+            return;
+          }
+          // Leaves only cache their size when they are sized on their own, see
+          // HasUncachedByteSize.
+          p->Emit(R"cc(
+            //~ Emit wants an indented line, so give it a comment to strip.
+#if defined(PROTOBUF_CUSTOM_VTABLE)
+            ::size_t $classname$::ByteSizeLong(const MessageLite& base) {
+              const $classname$& this_ = static_cast<const $classname$&>(base);
+#else   // PROTOBUF_CUSTOM_VTABLE
+            ::size_t $classname$::ByteSizeLong() const {
+              const $classname$& this_ = *this;
+#endif  // PROTOBUF_CUSTOM_VTABLE
+              const ::size_t total_size = this_.UncachedByteSizeLong();
+              this_.$cached_size$.Set(::_pbi::ToCachedSize(total_size));
+              return total_size;
+            }
+
+            ::size_t $classname$::UncachedByteSizeLong() const {
+              const $classname$& this_ = *this;
+          )cc");
+        }},
+       {"handle_extension_set",
         [&] {
           if (descriptor_->extension_range_count() == 0) return;
           p->Emit(R"cc(
@@ -5365,7 +5667,24 @@ void MessageGenerator::GenerateByteSize(io::Printer* p) {
         }},
        {"handle_unknown_fields",
         [&] {
-          if (UseUnknownFieldSet(descriptor_->file(), options_)) {
+          if (uncached) {
+            if (UseUnknownFieldSet(descriptor_->file(), options_)) {
+              p->Emit(R"cc(
+                if (ABSL_PREDICT_FALSE(this_.$have_unknown_fields$)) {
+                  total_size += $pbi$::WireFormat::ComputeUnknownFieldsSize(
+                      this_.$unknown_fields$);
+                }
+                return total_size;
+              )cc");
+            } else {
+              p->Emit(R"cc(
+                if (ABSL_PREDICT_FALSE(this_.$have_unknown_fields$)) {
+                  total_size += this_.$unknown_fields$.size();
+                }
+                return total_size;
+              )cc");
+            }
+          } else if (UseUnknownFieldSet(descriptor_->file(), options_)) {
             // We go out of our way to put the computation of the uncommon
             // path of unknown fields in tail position. This allows for
             // better code generation of this function for simple protos.
@@ -5393,13 +5712,7 @@ void MessageGenerator::GenerateByteSize(io::Printer* p) {
           }
         }}},
       R"cc(
-#if defined(PROTOBUF_CUSTOM_VTABLE)
-        ::size_t $classname$::ByteSizeLong(const MessageLite& base) {
-          const $classname$& this_ = static_cast<const $classname$&>(base);
-#else   // PROTOBUF_CUSTOM_VTABLE
-        ::size_t $classname$::ByteSizeLong() const {
-          const $classname$& this_ = *this;
-#endif  // PROTOBUF_CUSTOM_VTABLE
+        $signature$;
           $WeakDescriptorSelfPin$;
           $annotate_bytesize$;
           // @@protoc_insertion_point(message_byte_size_start:$full_name$)
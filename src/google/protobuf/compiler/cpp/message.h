@@ -21,6 +21,7 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "google/protobuf/compiler/cpp/enum.h"
 #include "google/protobuf/compiler/cpp/extension.h"
 #include "google/protobuf/compiler/cpp/field.h"
@@ -77,6 +78,10 @@ class MessageGenerator {
 
   void GenerateSchema(io::Printer* p, int offset, int has_offset);
 
+  // Writes the estimated in-memory layout of this message, one line per
+  // member with its offset, size and cache line.
+  void GenerateLayoutReport(io::Printer* p) const;
+
   // Generate the field offsets array.  Returns the a pair of the total number
   // of entries generated and the index of the first has_bit entry.
   std::pair<size_t, size_t> GenerateOffsets(io::Printer* p);
@@ -157,6 +162,10 @@ class MessageGenerator {
   // Or, if fields.size() == 1, just call GenerateSerializeOneField().
   void GenerateSerializeOneofFields(
       io::Printer* p, const std::vector<const FieldDescriptor*>& fields);
+  // Returns the has-bits of the expected presence pattern if the profile
+  // predicts one for every field, so that _InternalSerialize can special-case
+  // it. Returns nullopt otherwise.
+  absl::optional<uint32_t> CommonSerializePresencePattern() const;
   void GenerateSerializeOneExtensionRange(io::Printer* p, int start, int end);
   void GenerateSerializeAllExtensions(io::Printer* p);
 
@@ -22,6 +22,8 @@ class SplitMap;
 
 namespace cpp {
 
+class FieldProfile;
+
 enum class EnforceOptimizeMode {
   kNoEnforcement,  // Use the runtime specified by the file specific options.
   kSpeed,          // Full runtime with a generated code implementation.
@@ -44,6 +46,8 @@ struct FieldListenerOptions {
 struct Options {
   const AccessInfoMap* access_info_map = nullptr;
   const SplitMap* split_map = nullptr;
+  // Presence profile loaded with the `profile` option (see field_profile.h).
+  const FieldProfile* field_profile = nullptr;
   std::string dllexport_decl;
   std::string runtime_include_base;
   std::string annotation_pragma_name;
@@ -61,6 +65,20 @@ struct Options {
   bool opensource_runtime = false;
   bool annotate_accessor = false;
   bool force_split = false;
+  // Moves cold fields (rarely present per the profile, or deprecated) into the
+  // message's split struct.
+  bool auto_split = false;
+  // Stores singular string fields that are likely present per the profile in
+  // the message, as InlinedStringField, instead of behind a pointer.
+  bool auto_inline_string = false;
+  // Writes the estimated layout of each message to <basename>.pb.layout.txt.
+  bool layout_report = false;
+  // Messages may only be created on arenas, so their destructors never have
+  // to free fields.
+  bool arena_only = false;
+  // Registers the file's descriptor through a linker section, when the
+  // generated pool is first used, instead of from a static initializer.
+  bool lazy_descriptor_registration = false;
   // TODO: clean this up after the change is rolled out for 2
   // weeks.
   bool profile_driven_cluster_aux_subtable = true;
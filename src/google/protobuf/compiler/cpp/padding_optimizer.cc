@@ -97,7 +97,12 @@ static void OptimizeLayoutHelper(std::vector<const FieldDescriptor*>* fields,
       f = ZERO_INITIALIZABLE;
     }
 
-    const int j = field->number();
+    // Fields that the profile marks as likely (rarely) present sort before
+    // (after) all other fields of their family, so hot fields share cache
+    // lines and has-bit words.
+    double j = field->number();
+    if (IsLikelyPresent(field, options)) j -= FieldDescriptor::kMaxNumber;
+    if (IsRarelyPresent(field, options)) j += FieldDescriptor::kMaxNumber;
     switch (EstimateAlignmentSize(field)) {
       case 1:
         aligned_to_1[f].push_back(FieldGroup(j, field));
@@ -143,10 +148,11 @@ static void OptimizeLayoutHelper(std::vector<const FieldDescriptor*>* fields,
           // Move incomplete 4-byte block to the beginning.  This is done to
           // pair with the (possible) leftover blocks from the
           // ZERO_INITIALIZABLE family.
-          field_group.SetPreferredLocation(-1);
+          field_group.SetPreferredLocation(-2.0 * FieldDescriptor::kMaxNumber);
         } else {
-          // Move incomplete 4-byte block to the end.
-          field_group.SetPreferredLocation(double{FieldDescriptor::kMaxNumber});
+          // Move incomplete 4-byte block to the end, past any rarely present
+          // fields.
+          field_group.SetPreferredLocation(2.0 * FieldDescriptor::kMaxNumber);
         }
       }
       aligned_to_8[f].push_back(field_group);
@@ -195,6 +201,9 @@ static void OptimizeLayoutHelper(std::vector<const FieldDescriptor*>* fields,
 //
 // OTHER these fields are initialized one-by-one.
 //
+// When a presence profile is available, likely present fields are moved to the
+// start of their family and rarely present fields to the end.
+//
 // If there are split fields in `fields`, they will be placed at the end. The
 // order within split fields follows the same rule, aka classify and order by
 // "family".
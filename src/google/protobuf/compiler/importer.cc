@@ -15,6 +15,7 @@
 
 #ifdef _MSC_VER
 #include <direct.h>
+#include <process.h>
 #else
 #include <unistd.h>
 #endif
@@ -23,6 +24,8 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <cstdint>
+#include <cstdio>
 #include <memory>
 #include <vector>
 
@@ -32,8 +35,11 @@
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "google/protobuf/compiler/parser.h"
+#include "google/protobuf/io/coded_stream.h"
 #include "google/protobuf/io/tokenizer.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/stubs/common.h"
 
 #ifdef _WIN32
 #include "absl/strings/str_replace.h"
@@ -55,6 +61,14 @@ using google::protobuf::io::win32::access;
 using google::protobuf::io::win32::open;
 #endif
 
+#ifndef O_BINARY
+#ifdef _O_BINARY
+#define O_BINARY _O_BINARY
+#else
+#define O_BINARY 0  // If this isn't defined, the platform doesn't need it.
+#endif
+#endif
+
 // Returns true if the text looks like a Windows-style absolute path, starting
 // with a drive letter.  Example:  "C:\foo".  TODO:  Share this with
 // copy in command_line_interface.cc?
@@ -80,10 +94,12 @@ class SourceTreeDescriptorDatabase::SingleFileErrorCollector
                            MultiFileErrorCollector* multi_file_error_collector)
       : filename_(filename),
         multi_file_error_collector_(multi_file_error_collector),
-        had_errors_(false) {}
+        had_errors_(false),
+        had_warnings_(false) {}
   ~SingleFileErrorCollector() override {}
 
   bool had_errors() { return had_errors_; }
+  bool had_warnings() { return had_warnings_; }
 
   // implements ErrorCollector ---------------------------------------
   void RecordError(int line, int column, absl::string_view message) override {
@@ -99,12 +115,14 @@ class SourceTreeDescriptorDatabase::SingleFileErrorCollector
       multi_file_error_collector_->RecordWarning(filename_, line, column,
                                                  message);
     }
+    had_warnings_ = true;
   }
 
  private:
   std::string filename_;
   MultiFileErrorCollector* multi_file_error_collector_;
   bool had_errors_;
+  bool had_warnings_;
 };
 
 // ===================================================================
@@ -142,9 +160,36 @@ bool SourceTreeDescriptorDatabase::FindFileByName(const std::string& filename,
     return false;
   }
 
+  bool had_warnings = false;
+  if (parse_cache_ == nullptr) {
+    return Parse(filename, input.get(), output, &had_warnings);
+  }
+
+  // The cache is keyed by contents, so read the whole file first.
+  std::string contents;
+  const void* data;
+  int size;
+  while (input->Next(&data, &size)) {
+    contents.append(static_cast<const char*>(data), size);
+  }
+  input.reset();
+  if (parse_cache_->Lookup(filename, contents, output)) return true;
+
+  io::ArrayInputStream contents_input(contents.data(),
+                                      static_cast<int>(contents.size()));
+  if (!Parse(filename, &contents_input, output, &had_warnings)) return false;
+  // A cache hit would not repeat the warnings, e.g. for --fatal_warnings.
+  if (!had_warnings) parse_cache_->Insert(filename, contents, *output);
+  return true;
+}
+
+bool SourceTreeDescriptorDatabase::Parse(const std::string& filename,
+                                         io::ZeroCopyInputStream* input,
+                                         FileDescriptorProto* output,
+                                         bool* had_warnings) {
   // Set up the tokenizer and parser.
   SingleFileErrorCollector file_error_collector(filename, error_collector_);
-  io::Tokenizer tokenizer(input.get(), &file_error_collector);
+  io::Tokenizer tokenizer(input, &file_error_collector);
 
   Parser parser;
   if (error_collector_ != nullptr) {
@@ -156,7 +201,10 @@ bool SourceTreeDescriptorDatabase::FindFileByName(const std::string& filename,
 
   // Parse it.
   output->set_name(filename);
-  return parser.Parse(&tokenizer, output) && !file_error_collector.had_errors();
+  const bool success = parser.Parse(&tokenizer, output) &&
+                       !file_error_collector.had_errors();
+  *had_warnings = file_error_collector.had_warnings();
+  return success;
 }
 
 bool SourceTreeDescriptorDatabase::FindFileContainingSymbol(
@@ -213,6 +261,122 @@ void SourceTreeDescriptorDatabase::ValidationErrorCollector::RecordWarning(
 
 // ===================================================================
 
+namespace {
+
+// 64-bit FNV-1a.  Only used to name cache entries, which are verified on
+// lookup, so it need not be collision resistant; but unlike absl::Hash, it is
+// stable across processes.
+uint64_t Fnv1a64(absl::string_view data, uint64_t hash) {
+  for (char c : data) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= uint64_t{0x100000001b3};
+  }
+  return hash;
+}
+
+int CurrentProcessId() {
+#ifdef _MSC_VER
+  return _getpid();
+#else
+  return getpid();
+#endif
+}
+
+bool ReadLengthDelimited(io::CodedInputStream* input, std::string* value) {
+  uint32_t size;
+  return input->ReadVarint32(&size) &&
+         input->ReadString(value, static_cast<int>(size));
+}
+
+void WriteLengthDelimited(absl::string_view value,
+                          io::CodedOutputStream* output) {
+  output->WriteVarint32(static_cast<uint32_t>(value.size()));
+  output->WriteRaw(value.data(), static_cast<int>(value.size()));
+}
+
+}  // namespace
+
+ParseCache::~ParseCache() {}
+
+DiskParseCache::DiskParseCache(absl::string_view directory)
+    : directory_(directory) {}
+
+DiskParseCache::~DiskParseCache() {}
+
+std::string DiskParseCache::EntryPath(absl::string_view filename,
+                                      absl::string_view contents) const {
+  uint64_t hash = Fnv1a64(filename, uint64_t{0xcbf29ce484222325});
+  hash = Fnv1a64(absl::string_view("\0", 1), hash);
+  hash = Fnv1a64(contents, hash);
+  return absl::StrCat(directory_, "/", absl::Hex(hash, absl::kZeroPad16),
+                      ".pb");
+}
+
+// An entry holds the protobuf version, the file name and the contents, each
+// varint-prefixed, followed by the serialized FileDescriptorProto.
+bool DiskParseCache::Lookup(absl::string_view filename,
+                            absl::string_view contents,
+                            FileDescriptorProto* output) {
+  int file_descriptor;
+  do {
+    file_descriptor =
+        open(EntryPath(filename, contents).c_str(), O_RDONLY | O_BINARY);
+  } while (file_descriptor < 0 && errno == EINTR);
+  if (file_descriptor < 0) return false;
+
+  io::FileInputStream file_input(file_descriptor);
+  file_input.SetCloseOnDelete(true);
+  io::CodedInputStream input(&file_input);
+  uint32_t version;
+  std::string stored_filename, stored_contents;
+  if (!input.ReadVarint32(&version) || version != GOOGLE_PROTOBUF_VERSION ||
+      !ReadLengthDelimited(&input, &stored_filename) ||
+      stored_filename != filename ||
+      !ReadLengthDelimited(&input, &stored_contents) ||
+      stored_contents != contents) {
+    return false;
+  }
+  if (!output->ParseFromCodedStream(&input)) {
+    output->Clear();
+    return false;
+  }
+  return true;
+}
+
+void DiskParseCache::Insert(absl::string_view filename,
+                            absl::string_view contents,
+                            const FileDescriptorProto& file) {
+  const std::string path = EntryPath(filename, contents);
+  const std::string temp_path =
+      absl::StrCat(path, ".", CurrentProcessId(), ".tmp");
+  int file_descriptor;
+  do {
+    file_descriptor = open(temp_path.c_str(),
+                           O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0666);
+  } while (file_descriptor < 0 && errno == EINTR);
+  if (file_descriptor < 0) return;
+
+  bool success;
+  {
+    io::FileOutputStream file_output(file_descriptor);
+    {
+      io::CodedOutputStream output(&file_output);
+      output.WriteVarint32(GOOGLE_PROTOBUF_VERSION);
+      WriteLengthDelimited(filename, &output);
+      WriteLengthDelimited(contents, &output);
+      success = file.SerializeToCodedStream(&output) && !output.HadError();
+    }
+    success = file_output.Close() && success;
+  }
+  // Renaming fails on Windows if another process created the entry first,
+  // which is fine: it has the same contents.
+  if (!success || std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+  }
+}
+
+// ===================================================================
+
 Importer::Importer(SourceTree* source_tree,
                    MultiFileErrorCollector* error_collector)
     : database_(source_tree),
@@ -452,6 +616,7 @@ io::ZeroCopyInputStream* DiskSourceTree::OpenVirtualFile(
     std::string temp_disk_file;
     if (ApplyMapping(virtual_file, mapping.virtual_path, mapping.disk_path,
                      &temp_disk_file)) {
+      if (!DirectoryMayExist(temp_disk_file)) continue;
       io::ZeroCopyInputStream* stream = OpenDiskFile(temp_disk_file);
       if (stream != nullptr) {
         if (disk_file != nullptr) {
@@ -472,28 +637,56 @@ io::ZeroCopyInputStream* DiskSourceTree::OpenVirtualFile(
   return nullptr;
 }
 
+bool DiskSourceTree::DirectoryMayExist(absl::string_view disk_file) {
+  if (!cache_directories_) return true;
+  size_t slash = disk_file.rfind('/');
+  if (slash == absl::string_view::npos || slash == 0) return true;
+  absl::string_view directory = disk_file.substr(0, slash);
+  auto it = directory_exists_.find(directory);
+  if (it != directory_exists_.end()) return it->second;
+
+  struct stat sb;
+  int ret = 0;
+  do {
+    ret = stat(std::string(directory).c_str(), &sb);
+  } while (ret != 0 && errno == EINTR);
+  // Anything but a clear "no such directory" is left to open() to report.
+  bool exists = ret == 0 || (errno != ENOENT && errno != ENOTDIR);
+  directory_exists_.emplace(directory, exists);
+  return exists;
+}
+
 io::ZeroCopyInputStream* DiskSourceTree::OpenDiskFile(
     absl::string_view filename) {
   struct stat sb;
   int ret = 0;
+#if defined(_WIN32)
   do {
     ret = stat(std::string(filename).c_str(), &sb);
   } while (ret != 0 && errno == EINTR);
-#if defined(_WIN32)
   if (ret == 0 && sb.st_mode & S_IFDIR) {
     last_error_message_ = "Input file is a directory.";
     return nullptr;
   }
-#else
-  if (ret == 0 && S_ISDIR(sb.st_mode)) {
-    last_error_message_ = "Input file is a directory.";
-    return nullptr;
-  }
 #endif
   int file_descriptor;
   do {
     file_descriptor = open(std::string(filename).c_str(), O_RDONLY);
   } while (file_descriptor < 0 && errno == EINTR);
+#if !defined(_WIN32)
+  // Opening first and checking the descriptor resolves the path once, and
+  // only once for the common case of a file that is not there.
+  if (file_descriptor >= 0) {
+    do {
+      ret = fstat(file_descriptor, &sb);
+    } while (ret != 0 && errno == EINTR);
+    if (ret == 0 && S_ISDIR(sb.st_mode)) {
+      close(file_descriptor);
+      last_error_message_ = "Input file is a directory.";
+      return nullptr;
+    }
+  }
+#endif
   if (file_descriptor >= 0) {
     io::FileInputStream* result = new io::FileInputStream(file_descriptor);
     result->SetCloseOnDelete(true);
@@ -18,6 +18,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "google/protobuf/compiler/parser.h"
 #include "google/protobuf/descriptor.h"
@@ -38,6 +39,7 @@ namespace compiler {
 // Defined in this file.
 class Importer;
 class MultiFileErrorCollector;
+class ParseCache;
 class SourceTree;
 class DiskSourceTree;
 
@@ -83,6 +85,12 @@ class PROTOBUF_EXPORT SourceTreeDescriptorDatabase : public DescriptorDatabase {
     return &validation_error_collector_;
   }
 
+  // Consults `cache` before parsing each file, and records the files that
+  // parse without errors or warnings in it.  Files served from the cache have
+  // no source locations, so validation errors in them are reported without
+  // line numbers.  `cache` must outlive this object; nullptr disables caching.
+  void SetParseCache(ParseCache* cache) { parse_cache_ = cache; }
+
   // implements DescriptorDatabase -----------------------------------
   bool FindFileByName(const std::string& filename,
                       FileDescriptorProto* output) override;
@@ -95,9 +103,14 @@ class PROTOBUF_EXPORT SourceTreeDescriptorDatabase : public DescriptorDatabase {
  private:
   class SingleFileErrorCollector;
 
+  // Tokenizes and parses `input`.  Sets `had_warnings` if the parser warned.
+  bool Parse(const std::string& filename, io::ZeroCopyInputStream* input,
+             FileDescriptorProto* output, bool* had_warnings);
+
   SourceTree* source_tree_;
   DescriptorDatabase* fallback_database_;
   MultiFileErrorCollector* error_collector_;
+  ParseCache* parse_cache_ = nullptr;
 
   class PROTOBUF_EXPORT ValidationErrorCollector
       : public DescriptorPool::ErrorCollector {
@@ -125,6 +138,52 @@ class PROTOBUF_EXPORT SourceTreeDescriptorDatabase : public DescriptorDatabase {
   ValidationErrorCollector validation_error_collector_;
 };
 
+// Maps the contents of .proto files to their parsed FileDescriptorProtos, so
+// that files which did not change, e.g. common imports, are not re-parsed by
+// every protoc invocation.  See SourceTreeDescriptorDatabase::SetParseCache().
+class PROTOBUF_EXPORT ParseCache {
+ public:
+  ParseCache() = default;
+  ParseCache(const ParseCache&) = delete;
+  ParseCache& operator=(const ParseCache&) = delete;
+  virtual ~ParseCache();
+
+  // If the file `filename` with the given `contents` was previously inserted,
+  // fills in `output` and returns true.
+  virtual bool Lookup(absl::string_view filename, absl::string_view contents,
+                      FileDescriptorProto* output) = 0;
+
+  // Records `file` as the result of parsing `contents`.
+  virtual void Insert(absl::string_view filename, absl::string_view contents,
+                      const FileDescriptorProto& file) = 0;
+};
+
+// A ParseCache which keeps one file per entry in a directory, so that it
+// persists across protoc invocations.  Entries are named after a hash of the
+// file name and contents, but store both to be verified on lookup, plus the
+// protobuf version so that upgrading protoc invalidates them.  Entries are
+// written to a temporary file and renamed into place, so concurrent protoc
+// runs may share a directory.  Errors accessing the directory just cause
+// misses.
+class PROTOBUF_EXPORT DiskParseCache : public ParseCache {
+ public:
+  // `directory` must exist.
+  explicit DiskParseCache(absl::string_view directory);
+  ~DiskParseCache() override;
+
+  // implements ParseCache -------------------------------------------
+  bool Lookup(absl::string_view filename, absl::string_view contents,
+              FileDescriptorProto* output) override;
+  void Insert(absl::string_view filename, absl::string_view contents,
+              const FileDescriptorProto& file) override;
+
+ private:
+  std::string EntryPath(absl::string_view filename,
+                        absl::string_view contents) const;
+
+  std::string directory_;
+};
+
 // Simple interface for parsing .proto files.  This wraps the process
 // of opening the file, parsing it with a Parser, recursively parsing all its
 // imports, and then cross-linking the results to produce a FileDescriptor.
@@ -290,6 +349,13 @@ class PROTOBUF_EXPORT DiskSourceTree : public SourceTree {
   bool VirtualFileToDiskFile(absl::string_view virtual_file,
                              std::string* disk_file);
 
+  // Remembers which directories do not exist, so that Open() does not look for
+  // files in them again.  With many mapped paths, most lookups are misses in
+  // the same few directories.  Only use this if no directories are created
+  // under the mapped paths while the tree is in use, e.g. during one protoc
+  // run.
+  void EnableDirectoryCache() { cache_directories_ = true; }
+
   // implements SourceTree -------------------------------------------
   io::ZeroCopyInputStream* Open(absl::string_view filename) override;
 
@@ -306,6 +372,12 @@ class PROTOBUF_EXPORT DiskSourceTree : public SourceTree {
   };
   std::vector<Mapping> mappings_;
   std::string last_error_message_;
+  bool cache_directories_ = false;
+  // Whether each directory looked up so far exists, if cache_directories_.
+  absl::flat_hash_map<std::string, bool> directory_exists_;
+
+  // Returns false if the directory of `disk_file` is known not to exist.
+  bool DirectoryMayExist(absl::string_view disk_file);
 
   // Like Open(), but returns the on-disk path in disk_file if disk_file is
   // non-NULL and the file could be successfully opened.
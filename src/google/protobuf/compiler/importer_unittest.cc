@@ -12,6 +12,7 @@
 #include "google/protobuf/compiler/importer.h"
 
 #include <memory>
+#include <string>
 
 #include "google/protobuf/testing/file.h"
 #include "google/protobuf/testing/file.h"
@@ -24,6 +25,7 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/substitute.h"
 #include "google/protobuf/descriptor.h"
+#include "google/protobuf/descriptor.pb.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
 
 namespace google {
@@ -231,6 +233,90 @@ TEST_F(ImporterTest, LiteRuntimeImport) {
       error_collector_.text_);
 }
 
+// ===================================================================
+
+// A ParseCache in memory, which counts lookups and insertions.
+class MockParseCache : public ParseCache {
+ public:
+  bool Lookup(absl::string_view filename, absl::string_view contents,
+              FileDescriptorProto* output) override {
+    ++lookups_;
+    auto it = files_.find(absl::StrCat(filename, ":", contents));
+    if (it == files_.end()) return false;
+    *output = it->second;
+    return true;
+  }
+
+  void Insert(absl::string_view filename, absl::string_view contents,
+              const FileDescriptorProto& file) override {
+    ++inserts_;
+    files_[absl::StrCat(filename, ":", contents)] = file;
+  }
+
+  int lookups_ = 0;
+  int inserts_ = 0;
+
+ private:
+  absl::flat_hash_map<std::string, FileDescriptorProto> files_;
+};
+
+TEST(SourceTreeDescriptorDatabaseTest, ParseCache) {
+  MockSourceTree source_tree;
+  source_tree.AddFile("foo.proto",
+                      "syntax = \"proto2\";\n"
+                      "message Foo {}\n");
+  source_tree.AddFile("bad.proto", "message {}\n");
+  MockErrorCollector error_collector;
+  MockParseCache cache;
+  SourceTreeDescriptorDatabase database(&source_tree);
+  database.RecordErrorsTo(&error_collector);
+  database.SetParseCache(&cache);
+
+  FileDescriptorProto parsed;
+  ASSERT_TRUE(database.FindFileByName("foo.proto", &parsed));
+  EXPECT_EQ(cache.lookups_, 1);
+  EXPECT_EQ(cache.inserts_, 1);
+
+  FileDescriptorProto cached;
+  ASSERT_TRUE(database.FindFileByName("foo.proto", &cached));
+  EXPECT_EQ(cache.lookups_, 2);
+  EXPECT_EQ(cache.inserts_, 1);
+  EXPECT_EQ(cached.SerializeAsString(), parsed.SerializeAsString());
+
+  // Files with errors are not cached.
+  FileDescriptorProto bad;
+  EXPECT_FALSE(database.FindFileByName("bad.proto", &bad));
+  EXPECT_EQ(cache.inserts_, 1);
+  EXPECT_NE(error_collector.text_, "");
+}
+
+TEST(DiskParseCacheTest, LookupVerifiesNameAndContents) {
+  const std::string directory =
+      absl::StrCat(TestTempDir(), "/test_proto2_parse_cache");
+  if (FileExists(directory)) {
+    File::DeleteRecursively(directory, NULL, NULL);
+  }
+  ABSL_CHECK_OK(File::CreateDir(directory, 0777));
+
+  FileDescriptorProto file;
+  file.set_name("foo.proto");
+  file.add_message_type()->set_name("Foo");
+  {
+    DiskParseCache cache(directory);
+    cache.Insert("foo.proto", "message Foo {}", file);
+  }
+
+  // A new cache on the same directory, as in a later protoc invocation.
+  DiskParseCache cache(directory);
+  FileDescriptorProto output;
+  ASSERT_TRUE(cache.Lookup("foo.proto", "message Foo {}", &output));
+  EXPECT_EQ(output.SerializeAsString(), file.SerializeAsString());
+  EXPECT_FALSE(cache.Lookup("foo.proto", "message Bar {}", &output));
+  EXPECT_FALSE(cache.Lookup("bar.proto", "message Foo {}", &output));
+
+  File::DeleteRecursively(directory, NULL, NULL);
+}
+
 
 // ===================================================================
 
@@ -372,6 +458,26 @@ TEST_F(DiskSourceTreeTest, SearchMultipleDirectories) {
   ExpectCannotOpenFile("baz", "File not found.");
 }
 
+TEST_F(DiskSourceTreeTest, DirectoryCache) {
+  // Test that caching missing directories does not change what is found.
+
+  AddSubdir(absl::StrCat(dirnames_[1], "/bar"));
+  AddFile(absl::StrCat(dirnames_[1], "/bar/foo"), "Hello World!");
+  AddFile(absl::StrCat(dirnames_[1], "/bar/baz"), "Goodbye World!");
+  source_tree_.MapPath("", dirnames_[0]);
+  source_tree_.MapPath("", dirnames_[1]);
+  source_tree_.EnableDirectoryCache();
+
+  // dirnames_[0]/bar does not exist, so it is only looked up once.
+  ExpectFileContents("bar/foo", "Hello World!");
+  ExpectFileContents("bar/baz", "Goodbye World!");
+  ExpectCannotOpenFile("bar/qux", "File not found.");
+
+  // Files may still be added to directories that exist.
+  AddFile(absl::StrCat(dirnames_[1], "/bar/qux"), "Hello again!");
+  ExpectFileContents("bar/qux", "Hello again!");
+}
+
 TEST_F(DiskSourceTreeTest, OrderingTrumpsSpecificity) {
   // Test that directories are always searched in order, even when a latter
   // directory is more-specific than a former one.
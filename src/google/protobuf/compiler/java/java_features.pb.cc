@@ -201,6 +201,9 @@ constexpr auto JavaFeatures::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(JavaFeatures),
                                             alignof(JavaFeatures));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    JavaFeatures_reflection_data_;
+
 constexpr auto JavaFeatures::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -220,6 +223,7 @@ constexpr auto JavaFeatures::InternalGenerateClassData_() {
       },
       &JavaFeatures::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fcompiler_2fjava_2fjava_5ffeatures_2eproto,
+      &JavaFeatures_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -353,6 +357,13 @@ PROTOBUF_NOINLINE void JavaFeatures::Clear() {
 ::size_t JavaFeatures::ByteSizeLong() const {
   const JavaFeatures& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t JavaFeatures::UncachedByteSizeLong() const {
+  const JavaFeatures& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:pb.JavaFeatures)
   ::size_t total_size = 0;
 
@@ -370,8 +381,11 @@ PROTOBUF_NOINLINE void JavaFeatures::Clear() {
                     ::_pbi::WireFormatLite::EnumSize(this_._internal_utf8_validation());
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void JavaFeatures::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
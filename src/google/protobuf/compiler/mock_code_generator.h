@@ -116,9 +116,17 @@ class MockCodeGenerator : public CodeGenerator {
     maximum_edition_ = maximum_edition;
   }
 
+  bool SupportsConcurrentGenerate() const override {
+    return supports_concurrent_generate_;
+  }
+  void set_supports_concurrent_generate(bool supports) {
+    supports_concurrent_generate_ = supports;
+  }
+
  private:
   std::string name_;
   uint64_t suppressed_features_ = 0;
+  bool supports_concurrent_generate_ = false;
   mutable Edition minimum_edition_ = ProtocMinimumEdition();
   mutable Edition maximum_edition_ = ProtocMaximumEdition();
   std::vector<const FieldDescriptor*> feature_extensions_ = {
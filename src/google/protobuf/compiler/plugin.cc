@@ -9,7 +9,10 @@
 
 #include "google/protobuf/compiler/plugin.h"
 
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -19,14 +22,17 @@
 #include <unistd.h>
 #endif
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "google/protobuf/compiler/code_generator.h"
 #include "google/protobuf/compiler/plugin.pb.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/descriptor.pb.h"
+#include "google/protobuf/io/coded_stream.h"
 #include "google/protobuf/io/io_win32.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
 
@@ -93,12 +99,11 @@ class GeneratorResponseContext : public GeneratorContext {
   const std::vector<const FileDescriptor*>& parsed_files_;
 };
 
-bool GenerateCode(const CodeGeneratorRequest& request,
-                  const CodeGenerator& generator,
-                  CodeGeneratorResponse* response, std::string* error_msg) {
-  DescriptorPool pool;
+namespace {
 
-  // Initialize feature set default mapping.
+// Sets the feature set defaults of `generator` on an empty `pool`.
+bool InitDescriptorPool(const CodeGenerator& generator, DescriptorPool* pool,
+                        std::string* error_msg) {
   absl::StatusOr<FeatureSetDefaults> defaults =
       generator.BuildFeatureSetDefaults();
   if (!defaults.ok()) {
@@ -106,17 +111,19 @@ bool GenerateCode(const CodeGeneratorRequest& request,
                               defaults.status().message());
     return false;
   }
-  absl::Status status = pool.SetFeatureSetDefaults(std::move(defaults).value());
+  absl::Status status =
+      pool->SetFeatureSetDefaults(std::move(defaults).value());
   ABSL_CHECK(status.ok()) << status.message();
+  return true;
+}
 
-  for (int i = 0; i < request.proto_file_size(); i++) {
-    const FileDescriptor* file = pool.BuildFile(request.proto_file(i));
-    if (file == nullptr) {
-      // BuildFile() already wrote an error message.
-      return false;
-    }
-  }
-
+// Runs `generator` on the files to generate of `request`, which must already
+// be built in `pool`.
+bool GenerateCodeFromPool(const CodeGeneratorRequest& request,
+                          const CodeGenerator& generator,
+                          const DescriptorPool& pool,
+                          CodeGeneratorResponse* response,
+                          std::string* error_msg) {
   std::vector<const FileDescriptor*> parsed_files;
   for (int i = 0; i < request.file_to_generate_size(); i++) {
     parsed_files.push_back(pool.FindFileByName(request.file_to_generate(i)));
@@ -155,11 +162,147 @@ bool GenerateCode(const CodeGeneratorRequest& request,
   return true;
 }
 
+// The descriptors a persistent plugin keeps from one request to the next.
+// Requests of one build share most of their transitive dependencies, so each
+// file is only built the first time it is sent.
+class PersistentDescriptorPool {
+ public:
+  explicit PersistentDescriptorPool(const CodeGenerator& generator)
+      : generator_(generator) {}
+
+  // Makes every file of `request` available in pool().  Starts over with an
+  // empty pool if a file differs from the one of the same name seen before.
+  bool Update(const CodeGeneratorRequest& request, std::string* error_msg) {
+    std::vector<std::string> serialized(request.proto_file_size());
+    bool reset = pool_ == nullptr;
+    for (int i = 0; i < request.proto_file_size(); i++) {
+      request.proto_file(i).SerializeToString(&serialized[i]);
+      auto it = files_.find(request.proto_file(i).name());
+      if (it != files_.end() && it->second != serialized[i]) reset = true;
+    }
+    if (reset) {
+      files_.clear();
+      pool_ = std::make_unique<DescriptorPool>();
+      if (!InitDescriptorPool(generator_, pool_.get(), error_msg)) {
+        pool_ = nullptr;
+        return false;
+      }
+    }
+
+    for (int i = 0; i < request.proto_file_size(); i++) {
+      const FileDescriptorProto& file = request.proto_file(i);
+      if (files_.contains(file.name())) continue;
+      if (pool_->BuildFile(file) == nullptr) {
+        // BuildFile() already wrote an error message.
+        files_.clear();
+        pool_ = nullptr;
+        return false;
+      }
+      files_.emplace(file.name(), std::move(serialized[i]));
+    }
+    return true;
+  }
+
+  const DescriptorPool& pool() const { return *pool_; }
+
+ private:
+  const CodeGenerator& generator_;
+  std::unique_ptr<DescriptorPool> pool_;
+  // The serialized protos of the files in pool_, by name.
+  absl::flat_hash_map<std::string, std::string> files_;
+};
+
+// Serves requests in the persistent protocol until stdin ends.
+int PersistentPluginMain(const char* argv0, const CodeGenerator* generator) {
+  io::FileInputStream input(STDIN_FILENO);
+  io::FileOutputStream output(STDOUT_FILENO);
+  PersistentDescriptorPool pool(*generator);
+
+  while (true) {
+    // The end of input between two requests ends the session.
+    const void* data;
+    int data_size;
+    if (!input.Next(&data, &data_size)) return 0;
+    input.BackUp(data_size);
+
+    CodeGeneratorRequest request;
+    {
+      io::CodedInputStream coded_input(&input);
+      uint32_t size;
+      io::CodedInputStream::Limit limit = 0;
+      bool parsed = coded_input.ReadVarint32(&size);
+      if (parsed) {
+        limit = coded_input.PushLimit(static_cast<int>(size));
+        parsed = request.ParseFromCodedStream(&coded_input) &&
+                 coded_input.ConsumedEntireMessage();
+      }
+      if (!parsed) {
+        std::cerr << argv0 << ": protoc sent unparseable request to plugin."
+                  << std::endl;
+        return 1;
+      }
+      coded_input.PopLimit(limit);
+    }
+
+    // Errors are reported in the response, so that the session can go on.
+    std::string error_msg;
+    CodeGeneratorResponse response;
+    if (!pool.Update(request, &error_msg) ||
+        !GenerateCodeFromPool(request, *generator, pool.pool(), &response,
+                              &error_msg)) {
+      response.Clear();
+      response.set_error(error_msg.empty() ? "Invalid CodeGeneratorRequest."
+                                           : error_msg);
+    }
+
+    {
+      io::CodedOutputStream coded_output(&output);
+      coded_output.WriteVarint32(
+          static_cast<uint32_t>(response.ByteSizeLong()));
+      response.SerializeWithCachedSizes(&coded_output);
+      if (coded_output.HadError()) {
+        std::cerr << argv0 << ": Error writing to stdout." << std::endl;
+        return 1;
+      }
+    }
+    if (!output.Flush()) {
+      std::cerr << argv0 << ": Error writing to stdout." << std::endl;
+      return 1;
+    }
+  }
+}
+
+}  // namespace
+
+bool GenerateCode(const CodeGeneratorRequest& request,
+                  const CodeGenerator& generator,
+                  CodeGeneratorResponse* response, std::string* error_msg) {
+  DescriptorPool pool;
+
+  // Initialize feature set default mapping.
+  if (!InitDescriptorPool(generator, &pool, error_msg)) return false;
+
+  for (int i = 0; i < request.proto_file_size(); i++) {
+    const FileDescriptor* file = pool.BuildFile(request.proto_file(i));
+    if (file == nullptr) {
+      // BuildFile() already wrote an error message.
+      return false;
+    }
+  }
+
+  return GenerateCodeFromPool(request, generator, pool, response, error_msg);
+}
+
 int PluginMain(int argc, char* argv[], const CodeGenerator* generator) {
 
-  if (argc > 1) {
-    std::cerr << argv[0] << ": Unknown option: " << argv[1] << std::endl;
-    return 1;
+  bool persistent = false;
+  for (int i = 1; i < argc; i++) {
+    if (absl::string_view(argv[i]) == "--persistent") {
+      persistent = true;
+    } else {
+      std::cerr << argv[0] << ": Unknown option: " << argv[i] << std::endl;
+      return 1;
+    }
   }
 
 #ifdef _WIN32
@@ -167,6 +310,8 @@ int PluginMain(int argc, char* argv[], const CodeGenerator* generator) {
   setmode(STDOUT_FILENO, _O_BINARY);
 #endif
 
+  if (persistent) return PersistentPluginMain(argv[0], generator);
+
   CodeGeneratorRequest request;
   if (!request.ParseFromFileDescriptor(STDIN_FILENO)) {
     std::cerr << argv[0] << ": protoc sent unparseable request to plugin."
@@ -35,6 +35,14 @@
 //     protoc --plugin=protoc-gen-NAME=path/to/mybinary --NAME_out=OUT_DIR
 //   On Windows, make sure to include the .exe suffix:
 //     protoc --plugin=protoc-gen-NAME=path/to/mybinary.exe --NAME_out=OUT_DIR
+//
+// A plugin run with the --persistent flag serves any number of requests
+// instead of one: it reads CodeGeneratorRequests from stdin, each prefixed by
+// its size as a varint, and answers each with a CodeGeneratorResponse
+// prefixed the same way, until stdin is closed.  Files sent in an earlier
+// request are not built again, so a build tool can keep one plugin process
+// for many protoc invocations.  Errors, including invalid requests, are
+// reported in CodeGeneratorResponse.error.
 
 #ifndef GOOGLE_PROTOBUF_COMPILER_PLUGIN_H__
 #define GOOGLE_PROTOBUF_COMPILER_PLUGIN_H__
@@ -389,6 +389,9 @@ constexpr auto Version::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(Version),
                                             alignof(Version));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Version_reflection_data_;
+
 constexpr auto Version::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -408,6 +411,7 @@ constexpr auto Version::InternalGenerateClassData_() {
       },
       &Version::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fcompiler_2fplugin_2eproto,
+      &Version_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -558,6 +562,13 @@ PROTOBUF_NOINLINE void Version::Clear() {
 ::size_t Version::ByteSizeLong() const {
   const Version& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t Version::UncachedByteSizeLong() const {
+  const Version& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.compiler.Version)
   ::size_t total_size = 0;
 
@@ -589,8 +600,11 @@ PROTOBUF_NOINLINE void Version::Clear() {
           this_._internal_patch());
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void Version::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -759,6 +773,9 @@ constexpr auto CodeGeneratorRequest::InternalNewImpl_() {
                                  alignof(CodeGeneratorRequest));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    CodeGeneratorRequest_reflection_data_;
+
 constexpr auto CodeGeneratorRequest::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -778,6 +795,7 @@ constexpr auto CodeGeneratorRequest::InternalGenerateClassData_() {
       },
       &CodeGeneratorRequest::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fcompiler_2fplugin_2eproto,
+      &CodeGeneratorRequest_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -918,7 +936,8 @@ PROTOBUF_NOINLINE void CodeGeneratorRequest::Clear() {
   // optional .google.protobuf.compiler.Version compiler_version = 3;
   if ((cached_has_bits & 0x00000002u) != 0) {
     target = ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
-        3, *this_._impl_.compiler_version_, this_._impl_.compiler_version_->GetCachedSize(), target,
+        3, *this_._impl_.compiler_version_,
+        static_cast<int>(this_._impl_.compiler_version_->UncachedByteSizeLong()), target,
         stream);
   }
 
@@ -1003,7 +1022,7 @@ PROTOBUF_NOINLINE void CodeGeneratorRequest::Clear() {
     // optional .google.protobuf.compiler.Version compiler_version = 3;
     if ((cached_has_bits & 0x00000002u) != 0) {
       total_size += 1 +
-                    ::google::protobuf::internal::WireFormatLite::MessageSize(*this_._impl_.compiler_version_);
+                    ::google::protobuf::internal::WireFormatLite::UncachedMessageSize(*this_._impl_.compiler_version_);
     }
   }
   return this_.MaybeComputeUnknownFieldsSize(total_size,
@@ -1165,6 +1184,9 @@ constexpr auto CodeGeneratorResponse_File::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(CodeGeneratorResponse_File),
                                             alignof(CodeGeneratorResponse_File));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    CodeGeneratorResponse_File_reflection_data_;
+
 constexpr auto CodeGeneratorResponse_File::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -1184,6 +1206,7 @@ constexpr auto CodeGeneratorResponse_File::InternalGenerateClassData_() {
       },
       &CodeGeneratorResponse_File::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fcompiler_2fplugin_2eproto,
+      &CodeGeneratorResponse_File_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -1538,6 +1561,9 @@ constexpr auto CodeGeneratorResponse::InternalNewImpl_() {
                                  alignof(CodeGeneratorResponse));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    CodeGeneratorResponse_reflection_data_;
+
 constexpr auto CodeGeneratorResponse::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -1557,6 +1583,7 @@ constexpr auto CodeGeneratorResponse::InternalGenerateClassData_() {
       },
       &CodeGeneratorResponse::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fcompiler_2fplugin_2eproto,
+      &CodeGeneratorResponse_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -90,6 +90,29 @@ void MessageSerialize(Context& ctx, const Descriptor& msg) {
   ABSL_LOG(FATAL) << "unreachable";
 }
 
+void MessageSerializeInto(Context& ctx, const Descriptor& msg) {
+  switch (ctx.opts().kernel) {
+    case Kernel::kCpp:
+      ctx.Emit({}, R"rs(
+        unsafe { $pbr$::serialize_into(self.raw_msg(), out) }
+      )rs");
+      return;
+
+    case Kernel::kUpb:
+      ctx.Emit(R"rs(
+        // SAFETY: `MINI_TABLE` is the one associated with `self.raw_msg()`.
+        let encoded = unsafe {
+          $pbr$::wire::encode_into(self.raw_msg(),
+              <Self as $pbr$::AssociatedMiniTable>::mini_table(), out)
+        };
+        encoded.map_err(|_| $pb$::SerializeError)
+      )rs");
+      return;
+  }
+
+  ABSL_LOG(FATAL) << "unreachable";
+}
+
 void MessageMutClear(Context& ctx, const Descriptor& msg) {
   switch (ctx.opts().kernel) {
     case Kernel::kCpp:
@@ -661,6 +684,7 @@ void GenerateRs(Context& ctx, const Descriptor& msg) {
           {"Msg", RsSafeName(msg.name())},
           {"Msg::new", [&] { MessageNew(ctx, msg); }},
           {"Msg::serialize", [&] { MessageSerialize(ctx, msg); }},
+          {"Msg::serialize_into", [&] { MessageSerializeInto(ctx, msg); }},
           {"MsgMut::clear", [&] { MessageMutClear(ctx, msg); }},
           {"Msg::clear_and_parse", [&] { MessageClearAndParse(ctx, msg); }},
           {"Msg::drop", [&] { MessageDrop(ctx, msg); }},
@@ -825,6 +849,10 @@ void GenerateRs(Context& ctx, const Descriptor& msg) {
           fn serialize(&self) -> $Result$<Vec<u8>, $pb$::SerializeError> {
             $pb$::AsView::as_view(self).serialize()
           }
+
+          fn serialize_into(&self, out: &mut Vec<u8>) -> $Result$<(), $pb$::SerializeError> {
+            $pb$::AsView::as_view(self).serialize_into(out)
+          }
         }
 
         impl $pb$::Clear for $Msg$ {
@@ -883,6 +911,10 @@ void GenerateRs(Context& ctx, const Descriptor& msg) {
           fn serialize(&self) -> $Result$<Vec<u8>, $pb$::SerializeError> {
             $Msg::serialize$
           }
+
+          fn serialize_into(&self, out: &mut Vec<u8>) -> $Result$<(), $pb$::SerializeError> {
+            $Msg::serialize_into$
+          }
         }
 
         impl $std$::default::Default for $Msg$View<'_> {
@@ -963,6 +995,10 @@ void GenerateRs(Context& ctx, const Descriptor& msg) {
           fn serialize(&self) -> $Result$<Vec<u8>, $pb$::SerializeError> {
             $pb$::AsView::as_view(self).serialize()
           }
+
+          fn serialize_into(&self, out: &mut Vec<u8>) -> $Result$<(), $pb$::SerializeError> {
+            $pb$::AsView::as_view(self).serialize_into(out)
+          }
         }
 
         impl $pb$::Clear for $Msg$Mut<'_> {
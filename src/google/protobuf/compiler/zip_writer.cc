@@ -13,8 +13,14 @@
 #include "google/protobuf/compiler/zip_writer.h"
 
 #include <cstdint>
+#include <string>
 
 #include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+
+#if HAVE_ZLIB
+#include "google/protobuf/io/gzip_stream.h"
+#endif
 
 namespace google {
 namespace protobuf {
@@ -85,8 +91,45 @@ static void WriteShort(io::CodedOutputStream* out, uint16_t val) {
   out->WriteRaw(p, 2);
 }
 
-ZipWriter::ZipWriter(io::ZeroCopyOutputStream* raw_output)
-    : raw_output_(raw_output) {}
+// Compression methods.
+static const uint16_t kStored = 0;
+static const uint16_t kDeflated = 8;
+
+// Compresses `contents` to raw deflate data.  Returns false if that is not
+// possible.
+static bool Deflate(const std::string& contents, std::string* deflated) {
+#if HAVE_ZLIB
+  std::string gzipped;
+  {
+    io::StringOutputStream output(&gzipped);
+    io::GzipOutputStream::Options options;
+    options.format = io::GzipOutputStream::GZIP;
+    io::GzipOutputStream gzip(&output, options);
+    {
+      io::CodedOutputStream coded(&gzip);
+      coded.WriteString(contents);
+      if (coded.HadError()) return false;
+    }
+    if (!gzip.Close()) return false;
+  }
+  // zlib writes a 10 byte gzip header, as it is given no file name, and an
+  // 8 byte trailer around the deflate data.
+  constexpr size_t kHeaderSize = 10;
+  constexpr size_t kTrailerSize = 8;
+  if (gzipped.size() < kHeaderSize + kTrailerSize) return false;
+  deflated->assign(gzipped, kHeaderSize,
+                   gzipped.size() - kHeaderSize - kTrailerSize);
+  return true;
+#else
+  (void)contents;
+  (void)deflated;
+  return false;
+#endif
+}
+
+ZipWriter::ZipWriter(io::ZeroCopyOutputStream* raw_output,
+                     Compression compression)
+    : raw_output_(raw_output), compression_(compression) {}
 ZipWriter::~ZipWriter() {}
 
 bool ZipWriter::Write(const std::string& filename,
@@ -99,23 +142,36 @@ bool ZipWriter::Write(const std::string& filename,
   info.size = contents.size();
   info.crc32 = ComputeCRC32(contents);
 
+  std::string deflated;
+  const std::string* data = &contents;
+  info.method = kStored;
+  if (compression_ == Compression::kDeflate && Deflate(contents, &deflated) &&
+      deflated.size() < contents.size()) {
+    data = &deflated;
+    info.method = kDeflated;
+  }
+  info.compressed_size = data->size();
+
   files_.push_back(info);
 
   // write file header
   io::CodedOutputStream output(raw_output_);
-  output.WriteLittleEndian32(0x04034b50);  // magic
-  WriteShort(&output, 10);                 // version needed to extract
-  WriteShort(&output, 0);                  // flags
-  WriteShort(&output, 0);                  // compression method: stored
-  WriteShort(&output, 0);                  // last modified time
-  WriteShort(&output, kDosEpoch);          // last modified date
-  output.WriteLittleEndian32(info.crc32);  // crc-32
-  output.WriteLittleEndian32(info.size);   // compressed size
-  output.WriteLittleEndian32(info.size);   // uncompressed size
-  WriteShort(&output, filename_size);      // file name length
-  WriteShort(&output, 0);                  // extra field length
-  output.WriteString(filename);            // file name
-  output.WriteString(contents);            // file data
+  uint16_t method = info.method;
+  uint16_t version = method == kDeflated ? 20 : 10;
+  uint32_t compressed_size = info.compressed_size;
+  output.WriteLittleEndian32(0x04034b50);       // magic
+  WriteShort(&output, version);                 // version needed to extract
+  WriteShort(&output, 0);                       // flags
+  WriteShort(&output, method);                  // compression method
+  WriteShort(&output, 0);                       // last modified time
+  WriteShort(&output, kDosEpoch);               // last modified date
+  output.WriteLittleEndian32(info.crc32);       // crc-32
+  output.WriteLittleEndian32(compressed_size);  // compressed size
+  output.WriteLittleEndian32(info.size);        // uncompressed size
+  WriteShort(&output, filename_size);           // file name length
+  WriteShort(&output, 0);                       // extra field length
+  output.WriteString(filename);                 // file name
+  output.WriteString(*data);                    // file data
 
   return !output.HadError();
 }
@@ -131,18 +187,21 @@ bool ZipWriter::WriteDirectory() {
     uint16_t filename_size = filename.size();
     uint32_t crc32 = files_[i].crc32;
     uint32_t size = files_[i].size;
+    uint32_t compressed_size = files_[i].compressed_size;
+    uint16_t method = files_[i].method;
+    uint16_t version = method == kDeflated ? 20 : 10;
     uint32_t offset = files_[i].offset;
 
-    output.WriteLittleEndian32(0x02014b50);  // magic
-    WriteShort(&output, 10);                 // version made by
-    WriteShort(&output, 10);                 // version needed to extract
-    WriteShort(&output, 0);                  // flags
-    WriteShort(&output, 0);                  // compression method: stored
-    WriteShort(&output, 0);                  // last modified time
-    WriteShort(&output, kDosEpoch);          // last modified date
-    output.WriteLittleEndian32(crc32);       // crc-32
-    output.WriteLittleEndian32(size);        // compressed size
-    output.WriteLittleEndian32(size);        // uncompressed size
+    output.WriteLittleEndian32(0x02014b50);       // magic
+    WriteShort(&output, version);                 // version made by
+    WriteShort(&output, version);                 // version needed to extract
+    WriteShort(&output, 0);                       // flags
+    WriteShort(&output, method);                  // compression method
+    WriteShort(&output, 0);                       // last modified time
+    WriteShort(&output, kDosEpoch);               // last modified date
+    output.WriteLittleEndian32(crc32);            // crc-32
+    output.WriteLittleEndian32(compressed_size);  // compressed size
+    output.WriteLittleEndian32(size);             // uncompressed size
     WriteShort(&output, filename_size);      // file name length
     WriteShort(&output, 0);                  // extra field length
     WriteShort(&output, 0);                  // file comment length
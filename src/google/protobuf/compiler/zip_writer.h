@@ -10,6 +10,7 @@
 #define GOOGLE_PROTOBUF_COMPILER_ZIP_WRITER_H__
 
 #include <cstdint>
+#include <string>
 #include <vector>
 
 #include "google/protobuf/stubs/common.h"
@@ -21,7 +22,15 @@ namespace compiler {
 
 class ZipWriter {
  public:
-  ZipWriter(io::ZeroCopyOutputStream* raw_output);
+  enum class Compression {
+    kStored,
+    // Entries that get smaller are deflated.  Without zlib everything is
+    // stored.
+    kDeflate,
+  };
+
+  ZipWriter(io::ZeroCopyOutputStream* raw_output,
+            Compression compression = Compression::kStored);
   ~ZipWriter();
 
   bool Write(const std::string& filename, const std::string& contents);
@@ -32,10 +41,13 @@ class ZipWriter {
     std::string name;
     uint32_t offset;
     uint32_t size;
+    uint32_t compressed_size;
+    uint16_t method;
     uint32_t crc32;
   };
 
   io::ZeroCopyOutputStream* raw_output_;
+  Compression compression_;
   std::vector<FileInfo> files_;
 };
 
@@ -195,6 +195,9 @@ constexpr auto CppFeatures::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(CppFeatures),
                                             alignof(CppFeatures));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    CppFeatures_reflection_data_;
+
 constexpr auto CppFeatures::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -214,6 +217,7 @@ constexpr auto CppFeatures::InternalGenerateClassData_() {
       },
       &CppFeatures::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fcpp_5ffeatures_2eproto,
+      &CppFeatures_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -347,6 +351,13 @@ PROTOBUF_NOINLINE void CppFeatures::Clear() {
 ::size_t CppFeatures::ByteSizeLong() const {
   const CppFeatures& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t CppFeatures::UncachedByteSizeLong() const {
+  const CppFeatures& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:pb.CppFeatures)
   ::size_t total_size = 0;
 
@@ -364,8 +375,11 @@ PROTOBUF_NOINLINE void CppFeatures::Clear() {
                     ::_pbi::WireFormatLite::EnumSize(this_._internal_string_type());
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void CppFeatures::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -221,6 +221,8 @@ class PROTOBUF_EXPORT CppFeatures final : public ::google::protobuf::Message
       ::uint8_t* PROTOBUF_NONNULL target,
       ::google::protobuf::io::EpsCopyOutputStream* PROTOBUF_NONNULL stream) const final;
   #endif  // PROTOBUF_CUSTOM_VTABLE
+  // Like ByteSizeLong(), without storing the size in the message.
+  ::size_t UncachedByteSizeLong() const;
   int GetCachedSize() const { return _impl_._cached_size_.Get(); }
 
   private:
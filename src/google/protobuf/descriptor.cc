@@ -75,6 +75,7 @@
 #include "google/protobuf/descriptor_visitor.h"
 #include "google/protobuf/dynamic_message.h"
 #include "google/protobuf/feature_resolver.h"
+#include "google/protobuf/generated_message_reflection.h"
 #include "google/protobuf/generated_message_util.h"
 #include "google/protobuf/io/strtod.h"
 #include "google/protobuf/io/tokenizer.h"
@@ -1053,6 +1054,9 @@ using DescriptorsByNameSet =
 using FieldsByNameMap =
     absl::flat_hash_map<std::pair<const void*, absl::string_view>,
                         const FieldDescriptor*>;
+using EnumValuesByNameMap =
+    absl::flat_hash_map<std::pair<const EnumDescriptor*, std::string>,
+                        const EnumValueDescriptor*>;
 
 struct ParentNumberQuery {
   std::pair<const void*, int> query;
@@ -1253,6 +1257,8 @@ class FileDescriptorTables {
       const void* parent, absl::string_view camelcase_name) const;
   inline const EnumValueDescriptor* FindEnumValueByNumber(
       const EnumDescriptor* parent, int number) const;
+  inline const EnumValueDescriptor* FindEnumValueByLowercaseName(
+      const EnumDescriptor* parent, absl::string_view lowercase_name) const;
   // This creates a new EnumValueDescriptor if not found, in a thread-safe way.
   inline const EnumValueDescriptor* FindEnumValueByNumberCreatingIfUnknown(
       const EnumDescriptor* parent, int number) const;
@@ -1291,6 +1297,9 @@ class FileDescriptorTables {
   static void FieldsByCamelcaseNamesLazyInitStatic(
       const FileDescriptorTables* tables);
   void FieldsByCamelcaseNamesLazyInitInternal() const;
+  static void EnumValuesByLowercaseNamesLazyInitStatic(
+      const FileDescriptorTables* tables);
+  void EnumValuesByLowercaseNamesLazyInitInternal() const;
 
   SymbolsByParentSet symbols_by_parent_;
   mutable absl::once_flag fields_by_lowercase_name_once_;
@@ -1300,6 +1309,9 @@ class FileDescriptorTables {
   // change anymore.
   mutable std::atomic<const FieldsByNameMap*> fields_by_lowercase_name_{};
   mutable std::atomic<const FieldsByNameMap*> fields_by_camelcase_name_{};
+  mutable absl::once_flag enum_values_by_lowercase_name_once_;
+  mutable std::atomic<const EnumValuesByNameMap*>
+      enum_values_by_lowercase_name_{};
   FieldsByNumberSet fields_by_number_;  // Not including extensions.
   EnumValuesByNumberSet enum_values_by_number_;
   mutable EnumValuesByNumberSet unknown_enum_values_by_number_
@@ -1547,6 +1559,15 @@ class DescriptorPool::Tables {
   // allocation owned by the pool.
   const FeatureSet* InternFeatureSet(FeatureSet&& features);
 
+  // Returns the cache entry for the merged features of an element of
+  // `edition` whose parent has the merged features `parent` and which sets
+  // `child` itself.  The entry holds nullptr until it is filled in.  Sibling
+  // elements, even across files, often set the same features, and merging
+  // them is much more expensive than this lookup.
+  const FeatureSet*& MergedFeatureSetCacheEntry(Edition edition,
+                                                const FeatureSet* parent,
+                                                const FeatureSet& child);
+
   // -----------------------------------------------------------------
   // Allocating memory.
 
@@ -1597,6 +1618,12 @@ class DescriptorPool::Tables {
   // these within the pool than have each file create its own feature sets.
   absl::flat_hash_map<std::string, std::unique_ptr<FeatureSet>>
       feature_set_cache_;
+  // Interned merged feature sets by edition, interned merged parent features
+  // and serialized child features.  Like the interned feature sets, entries
+  // are never rolled back.
+  absl::flat_hash_map<std::tuple<Edition, const FeatureSet*, std::string>,
+                      const FeatureSet*>
+      merged_feature_set_cache_;
 
   struct CheckPoint {
     explicit CheckPoint(const Tables* tables)
@@ -1650,6 +1677,7 @@ FileDescriptorTables::FileDescriptorTables() = default;
 FileDescriptorTables::~FileDescriptorTables() {
   delete fields_by_lowercase_name_.load(std::memory_order_acquire);
   delete fields_by_camelcase_name_.load(std::memory_order_acquire);
+  delete enum_values_by_lowercase_name_.load(std::memory_order_acquire);
 }
 
 inline const FileDescriptorTables& FileDescriptorTables::GetEmptyInstance() {
@@ -1721,6 +1749,14 @@ inline auto FileDescriptorTables::FindNestedSymbol(
 
 Symbol DescriptorPool::Tables::FindByNameHelper(const DescriptorPool* pool,
                                                 absl::string_view name) {
+  if (pool->frozen_) {
+    Symbol result = FindSymbol(name);
+    if (result.IsNull() && pool->underlay_ != nullptr) {
+      result =
+          pool->underlay_->tables_->FindByNameHelper(pool->underlay_, name);
+    }
+    return result;
+  }
   if (pool->mutex_ != nullptr) {
     // Fast path: the Symbol is already cached.  This is just a hash lookup.
     absl::ReaderMutexLock lock(pool->mutex_);
@@ -1851,6 +1887,40 @@ inline const FieldDescriptor* FileDescriptorTables::FindFieldByCamelcaseName(
   return it->second;
 }
 
+void FileDescriptorTables::EnumValuesByLowercaseNamesLazyInitStatic(
+    const FileDescriptorTables* tables) {
+  tables->EnumValuesByLowercaseNamesLazyInitInternal();
+}
+
+void FileDescriptorTables::EnumValuesByLowercaseNamesLazyInitInternal() const {
+  auto* map = new EnumValuesByNameMap;
+  for (Symbol symbol : symbols_by_parent_) {
+    if (symbol.type() != Symbol::ENUM_VALUE_OTHER_PARENT) continue;
+    const EnumValueDescriptor* value = symbol.enum_value_descriptor();
+    // If several values have the same lowercase name, keep the first one
+    // defined, which is the one a linear case-insensitive search would find.
+    const EnumValueDescriptor*& found =
+        (*map)[{value->type(), absl::AsciiStrToLower(value->name())}];
+    if (found == nullptr || found->index() > value->index()) {
+      found = value;
+    }
+  }
+  enum_values_by_lowercase_name_.store(map, std::memory_order_release);
+}
+
+inline const EnumValueDescriptor*
+FileDescriptorTables::FindEnumValueByLowercaseName(
+    const EnumDescriptor* parent, absl::string_view lowercase_name) const {
+  absl::call_once(
+      enum_values_by_lowercase_name_once_,
+      FileDescriptorTables::EnumValuesByLowercaseNamesLazyInitStatic, this);
+  const auto* values =
+      enum_values_by_lowercase_name_.load(std::memory_order_acquire);
+  auto it = values->find({parent, std::string(lowercase_name)});
+  if (it == values->end()) return nullptr;
+  return it->second;
+}
+
 inline const EnumValueDescriptor* FileDescriptorTables::FindEnumValueByNumber(
     const EnumDescriptor* parent, int number) const {
   // If `number` is within the sequential range, just index into the parent
@@ -2022,6 +2092,12 @@ const FeatureSet* DescriptorPool::Tables::InternFeatureSet(
   return result.get();
 }
 
+const FeatureSet*& DescriptorPool::Tables::MergedFeatureSetCacheEntry(
+    Edition edition, const FeatureSet* parent, const FeatureSet& child) {
+  return merged_feature_set_cache_[std::make_tuple(
+      edition, parent, child.SerializeAsString())];
+}
+
 // -------------------------------------------------------------------
 
 template <typename Type>
@@ -2162,6 +2238,12 @@ DescriptorPool::~DescriptorPool() {
   if (mutex_ != nullptr) delete mutex_;
 }
 
+void DescriptorPool::Freeze() {
+  ABSL_CHECK(!lazily_build_dependencies_)
+      << "Cannot freeze a DescriptorPool that lazily builds dependencies.";
+  frozen_ = true;
+}
+
 // DescriptorPool::BuildFile() defined later.
 // DescriptorPool::BuildFileCollectingErrors() defined later.
 
@@ -2237,6 +2319,7 @@ const DescriptorPool* DescriptorPool::generated_pool() {
   // it is unused.
   DescriptorProto::descriptor();
   pb::CppFeatures::descriptor();
+  internal::AddDescriptorsFromLinkerSection();
   return pool;
 }
 
@@ -2249,9 +2332,11 @@ void DescriptorPool::InternalAddGeneratedFile(
   // process startup, and that function calls this one in order to register
   // the raw bytes of the FileDescriptorProto representing the file.
   //
-  // We do not actually construct the descriptor objects right away.  We just
-  // hang on to the bytes until they are actually needed.  We actually construct
-  // the descriptor the first time one of the following things happens:
+  // We do not actually construct the descriptor objects right away, nor even
+  // parse the bytes to index the symbols they define.  We just hang on to the
+  // bytes until they are actually needed: the database indexes all registered
+  // files on its first lookup, and we actually construct the descriptor the
+  // first time one of the following things happens:
   // * Someone calls a method like descriptor(), GetDescriptor(), or
   //   GetReflection() on the generated types, which requires returning the
   //   descriptor or an object based on it.
@@ -2266,7 +2351,7 @@ void DescriptorPool::InternalAddGeneratedFile(
   // any descriptor-based operations, since this might cause infinite recursion
   // or deadlock.
   absl::MutexLockMaybe lock(internal_generated_pool()->mutex_);
-  ABSL_CHECK(GeneratedDatabase()->Add(encoded_file_descriptor, size));
+  GeneratedDatabase()->AddLazily(encoded_file_descriptor, size);
 }
 
 
@@ -2278,6 +2363,13 @@ void DescriptorPool::InternalAddGeneratedFile(
 
 const FileDescriptor* DescriptorPool::FindFileByName(
     absl::string_view name) const {
+  if (frozen_) {
+    const FileDescriptor* result = tables_->FindFile(name);
+    if (result == nullptr && underlay_ != nullptr) {
+      result = underlay_->FindFileByName(name);
+    }
+    return result;
+  }
   DeferredValidation deferred_validation(this);
   const FileDescriptor* result = nullptr;
   {
@@ -2304,6 +2396,13 @@ const FileDescriptor* DescriptorPool::FindFileByName(
 
 const FileDescriptor* DescriptorPool::FindFileContainingSymbol(
     absl::string_view symbol_name) const {
+  if (frozen_) {
+    Symbol result = tables_->FindSymbol(symbol_name);
+    if (!result.IsNull()) return result.GetFile();
+    return underlay_ != nullptr
+               ? underlay_->FindFileContainingSymbol(symbol_name)
+               : nullptr;
+  }
   const FileDescriptor* file_result = nullptr;
   DeferredValidation deferred_validation(this);
   {
@@ -2384,6 +2483,13 @@ const MethodDescriptor* DescriptorPool::FindMethodByName(
 const FieldDescriptor* DescriptorPool::FindExtensionByNumber(
     const Descriptor* extendee, int number) const {
   if (extendee->extension_range_count() == 0) return nullptr;
+  if (frozen_) {
+    const FieldDescriptor* result = tables_->FindExtension(extendee, number);
+    if (result == nullptr && underlay_ != nullptr) {
+      result = underlay_->FindExtensionByNumber(extendee, number);
+    }
+    return result;
+  }
   // A faster path to reduce lock contention in finding extensions, assuming
   // most extensions will be cache hit.
   if (mutex_ != nullptr) {
@@ -2467,6 +2573,11 @@ const FieldDescriptor* DescriptorPool::FindExtensionByPrintableName(
 void DescriptorPool::FindAllExtensions(
     const Descriptor* extendee,
     std::vector<const FieldDescriptor*>* out) const {
+  if (frozen_) {
+    tables_->FindAllExtensions(extendee, out);
+    if (underlay_ != nullptr) underlay_->FindAllExtensions(extendee, out);
+    return;
+  }
   DeferredValidation deferred_validation(this);
   std::vector<const FieldDescriptor*> extensions;
   {
@@ -2609,6 +2720,12 @@ const EnumValueDescriptor* EnumDescriptor::FindValueByName(
   return file()->tables_->FindNestedSymbol(this, name).enum_value_descriptor();
 }
 
+const EnumValueDescriptor* EnumDescriptor::FindValueByNameIgnoringCase(
+    absl::string_view name) const {
+  return file()->tables_->FindEnumValueByLowercaseName(
+      this, absl::AsciiStrToLower(name));
+}
+
 const EnumValueDescriptor* EnumDescriptor::FindValueByNumber(int number) const {
   return file()->tables_->FindEnumValueByNumber(this, number);
 }
@@ -4756,6 +4873,7 @@ const FileDescriptor* DescriptorPool::BuildFileCollectingErrors(
          "DescriptorDatabase.  You must instead find a way to get your file "
          "into the underlying database.";
   ABSL_CHECK(mutex_ == nullptr);  // Implied by the above ABSL_CHECK.
+  ABSL_CHECK(!frozen_) << "Cannot call BuildFile on a frozen DescriptorPool.";
   tables_->known_bad_symbols_.clear();
   tables_->known_bad_files_.clear();
   build_started_ = true;
@@ -4770,6 +4888,55 @@ const FileDescriptor* DescriptorPool::BuildFileCollectingErrors(
   return nullptr;
 }
 
+std::vector<const FileDescriptor*> DescriptorPool::BuildFiles(
+    absl::Span<const FileDescriptorProto> files) {
+  return BuildFilesCollectingErrors(files, nullptr);
+}
+
+std::vector<const FileDescriptor*> DescriptorPool::BuildFilesCollectingErrors(
+    absl::Span<const FileDescriptorProto> files,
+    ErrorCollector* error_collector) {
+  absl::flat_hash_map<absl::string_view, int> index_by_name;
+  for (int i = 0; i < static_cast<int>(files.size()); ++i) {
+    index_by_name.emplace(files[i].name(), i);
+  }
+
+  // Post-order DFS over the dependencies within `files`, iterative so that
+  // long import chains can't overflow the stack.  Each entry of `stack` is a
+  // file and the index of its next dependency to visit.  Cycles are left for
+  // BuildFile() to report.
+  std::vector<int> order;
+  order.reserve(files.size());
+  std::vector<bool> visited(files.size());
+  std::vector<std::pair<int, int>> stack;
+  for (int root = 0; root < static_cast<int>(files.size()); ++root) {
+    if (visited[root]) continue;
+    visited[root] = true;
+    stack.emplace_back(root, 0);
+    while (!stack.empty()) {
+      const int file = stack.back().first;
+      const int next = stack.back().second++;
+      if (next == files[file].dependency_size()) {
+        order.push_back(file);
+        stack.pop_back();
+        continue;
+      }
+      auto it = index_by_name.find(files[file].dependency(next));
+      if (it != index_by_name.end() && !visited[it->second]) {
+        visited[it->second] = true;
+        stack.emplace_back(it->second, 0);
+      }
+    }
+  }
+
+  std::vector<const FileDescriptor*> result(files.size());
+  for (int i : order) {
+    result[i] = BuildFileCollectingErrors(files[i], error_collector);
+    if (result[i] == nullptr) return {};
+  }
+  return result;
+}
+
 const FileDescriptor* DescriptorPool::BuildFileFromDatabase(
     const FileDescriptorProto& proto,
     DeferredValidation& deferred_validation) const {
@@ -5614,6 +5781,15 @@ void DescriptorBuilder::ResolveFeaturesImpl(
     return;
   }
 
+  // The parent's features are interned, so elements that set the same
+  // features under the same parent share one merge.
+  const FeatureSet*& cached = tables_->MergedFeatureSetCacheEntry(
+      edition, &parent_features, base_features);
+  if (cached != nullptr) {
+    descriptor->merged_features_ = cached;
+    return;
+  }
+
   // Calculate the merged features for this target.
   absl::StatusOr<FeatureSet> merged =
       feature_resolver_->MergeFeatures(parent_features, base_features);
@@ -5623,7 +5799,8 @@ void DescriptorBuilder::ResolveFeaturesImpl(
     return;
   }
 
-  descriptor->merged_features_ = tables_->InternFeatureSet(*std::move(merged));
+  cached = tables_->InternFeatureSet(*std::move(merged));
+  descriptor->merged_features_ = cached;
 }
 
 template <class DescriptorT>
@@ -10085,6 +10262,23 @@ bool IsGroupLike(const FieldDescriptor& field) {
                                     field.containing_type();
 }
 
+bool IsSmallLeafMessage(const Descriptor* desc) {
+  // Recomputing the size of these messages costs about as much as loading
+  // their cached size, which is often a cache miss.
+  static constexpr int kMaxFields = 8;
+  if (desc->extension_range_count() != 0 || desc->field_count() > kMaxFields) {
+    return false;
+  }
+  for (int i = 0; i < desc->field_count(); ++i) {
+    const FieldDescriptor* field = desc->field(i);
+    if (field->is_repeated() ||
+        field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool IsLazilyInitializedFile(absl::string_view filename) {
   if (filename == "third_party/protobuf/cpp_features.proto" ||
       filename == "google/protobuf/cpp_features.proto") {
@@ -52,6 +52,7 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "google/protobuf/descriptor_lite.h"
 #include "google/protobuf/extension_set.h"
 #include "google/protobuf/port.h"
@@ -1117,7 +1118,12 @@ class PROTOBUF_EXPORT FieldDescriptor : private internal::SymbolBase,
   uint8_t label_ : 2;
 
   // Actually a `Type`, but stored as uint8_t to save space.
-  uint8_t type_;
+  uint8_t type_ : 5;
+
+  // Actually an optional `CType`, but stored as uint8_t to save space.  This
+  // contains the original ctype option specified in the .proto file.  Shares
+  // a byte with `type_` so that `number_` below fits before the first pointer.
+  uint8_t legacy_proto_ctype_ : 2;
 
   // Logically:
   //   all_names_ = [name, full_name, lower, camel, json]
@@ -1134,10 +1140,6 @@ class PROTOBUF_EXPORT FieldDescriptor : private internal::SymbolBase,
   // Located here for bitpacking.
   bool in_real_oneof_ : 1;
 
-  // Actually an optional `CType`, but stored as uint8_t to save space.  This
-  // contains the original ctype option specified in the .proto file.
-  uint8_t legacy_proto_ctype_ : 2;
-
   // Sadly, `number_` located here to reduce padding. Unrelated to all_names_
   // and its indices above.
   int number_;
@@ -1336,6 +1338,10 @@ class PROTOBUF_EXPORT EnumDescriptor : private internal::SymbolBase {
 
   // Looks up a value by name.  Returns nullptr if no such value exists.
   const EnumValueDescriptor* FindValueByName(absl::string_view name) const;
+  // Looks up a value by name, ignoring ASCII case.  If several values match,
+  // the first one defined is returned.  Returns nullptr if none does.
+  const EnumValueDescriptor* FindValueByNameIgnoringCase(
+      absl::string_view name) const;
   // Looks up a value by number.  Returns nullptr if no such value exists.  If
   // multiple values have this number, the first one defined is returned.
   const EnumValueDescriptor* FindValueByNumber(int number) const;
@@ -2116,6 +2122,8 @@ class PROTOBUF_EXPORT DescriptorPool {
   //   the DescriptorPool. Even if the client takes care to avoid data races,
   //   changes to the content of the DescriptorDatabase may not be reflected
   //   in subsequent lookups in the DescriptorPool.
+  // - Lookups that fail are repeated in the DescriptorDatabase every time.
+  //   Wrap it in a CachingDescriptorDatabase to remember them.
   class ErrorCollector;
   explicit DescriptorPool(DescriptorDatabase* fallback_database,
                           ErrorCollector* error_collector = nullptr);
@@ -2126,6 +2134,15 @@ class PROTOBUF_EXPORT DescriptorPool {
 #endif
   ~DescriptorPool();
 
+  // Declares that the pool is complete.  Afterwards, the Find*By*() methods no
+  // longer consult the fallback database and only see the descriptors built so
+  // far, plus those in the underlay.  In exchange they no longer lock the
+  // pool's mutex, so concurrent lookups don't contend with each other.
+  // Call this once, after loading everything that will be looked up (e.g. with
+  // FindFileByName()) and before the pool is shared between threads.  Pools
+  // that lazily build dependencies can't be frozen.
+  void Freeze();
+
   // Get a pointer to the generated pool.  Generated protocol message classes
   // which are compiled into the binary will allocate their descriptors in
   // this pool.  Do not add your own descriptors to this pool.
@@ -2253,6 +2270,19 @@ class PROTOBUF_EXPORT DescriptorPool {
   const FileDescriptor* BuildFileCollectingErrors(
       const FileDescriptorProto& proto, ErrorCollector* error_collector);
 
+  // Builds all of `files`, e.g. those of a FileDescriptorSet, in dependency
+  // order.  The files may come in any order, as long as the dependencies of each
+  // are either among `files` or already in the pool.  Returns the resulting
+  // FileDescriptors in the order of `files`, or an empty vector if any file
+  // could not be built; files built before the failing one stay in the pool.
+  std::vector<const FileDescriptor*> BuildFiles(
+      absl::Span<const FileDescriptorProto> files);
+
+  // Same as BuildFiles() except errors are sent to the given ErrorCollector.
+  std::vector<const FileDescriptor*> BuildFilesCollectingErrors(
+      absl::Span<const FileDescriptorProto> files,
+      ErrorCollector* error_collector);
+
   // By default, it is an error if a FileDescriptorProto contains references
   // to types or other files that are not found in the DescriptorPool (or its
   // backing DescriptorDatabase, if any).  If you call
@@ -2463,16 +2493,18 @@ class PROTOBUF_EXPORT DescriptorPool {
     T value;
   };
 
-  // Memoize a projection of a field.  This is used to cache the results of
-  // calling a function on a field, used for expensive descriptor calculations.
-  template <typename Func>
-  const auto& MemoizeProjection(const FieldDescriptor* field, Func func) const {
-    using ResultT = std::decay_t<decltype(func(field))>;
-    ABSL_DCHECK(field->file()->pool() == this);
+  // Memoize a projection of a descriptor, such as a field or a message type.
+  // This is used to cache the results of calling a function on a descriptor,
+  // used for expensive descriptor calculations.
+  template <typename DescriptorT, typename Func>
+  const auto& MemoizeProjection(const DescriptorT* descriptor,
+                                Func func) const {
+    using ResultT = std::decay_t<decltype(func(descriptor))>;
+    ABSL_DCHECK(descriptor->file()->pool() == this);
     static_assert(std::is_empty_v<Func>);
     // This static bool is unique per-Func, so its address can be used as a key.
     static bool type_key;
-    auto key = std::pair<const void*, const void*>(field, &type_key);
+    auto key = std::pair<const void*, const void*>(descriptor, &type_key);
     {
       absl::ReaderMutexLock lock(&field_memo_table_mutex_);
       auto it = field_memo_table_.find(key);
@@ -2481,7 +2513,7 @@ class PROTOBUF_EXPORT DescriptorPool {
       }
     }
     auto result = std::make_unique<MemoData<ResultT>>();
-    result->value = func(field);
+    result->value = func(descriptor);
     {
       absl::MutexLock lock(&field_memo_table_mutex_);
       auto& res = field_memo_table_[key];
@@ -2587,6 +2619,8 @@ class PROTOBUF_EXPORT DescriptorPool {
   bool deprecated_legacy_json_field_conflicts_;
   bool enforce_naming_style_;
   mutable bool build_started_ = false;
+  // See Freeze().
+  bool frozen_ = false;
 
   // Set of files to track for additional validation. The bool value when true
   // means unused imports are treated as errors (and as warnings when false).
@@ -3085,6 +3119,13 @@ PROTOBUF_EXPORT Utf8CheckMode GetUtf8CheckMode(const FieldDescriptor* field,
 //  - Message is defined within the same scope as the field
 PROTOBUF_EXPORT bool IsGroupLike(const FieldDescriptor& field);
 
+// Returns true if `desc` is a small leaf: a message without extension ranges
+// and with a few fields, none of them repeated or messages.  Generated parents
+// recompute the size of these submessages when they serialize them instead of
+// caching it, so serializers that run after a generated ByteSizeLong() must
+// not rely on their cached size.
+PROTOBUF_EXPORT bool IsSmallLeafMessage(const Descriptor* desc);
+
 // Returns whether or not this file is lazily initialized rather than
 // pre-main via static initialization.  This has to be done for our bootstrapped
 // protos to avoid linker bloat in lite runtimes.
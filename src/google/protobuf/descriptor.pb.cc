@@ -2436,6 +2436,9 @@ constexpr auto FileDescriptorSet::InternalNewImpl_() {
                                  alignof(FileDescriptorSet));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    FileDescriptorSet_reflection_data_;
+
 constexpr auto FileDescriptorSet::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -2455,6 +2458,7 @@ constexpr auto FileDescriptorSet::InternalGenerateClassData_() {
       },
       &FileDescriptorSet::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &FileDescriptorSet_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -2770,6 +2774,9 @@ constexpr auto FileDescriptorProto::InternalNewImpl_() {
                                  alignof(FileDescriptorProto));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    FileDescriptorProto_reflection_data_;
+
 constexpr auto FileDescriptorProto::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -2789,6 +2796,7 @@ constexpr auto FileDescriptorProto::InternalGenerateClassData_() {
       },
       &FileDescriptorProto::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &FileDescriptorProto_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -3404,6 +3412,9 @@ constexpr auto DescriptorProto_ExtensionRange::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(DescriptorProto_ExtensionRange),
                                             alignof(DescriptorProto_ExtensionRange));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    DescriptorProto_ExtensionRange_reflection_data_;
+
 constexpr auto DescriptorProto_ExtensionRange::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -3423,6 +3434,7 @@ constexpr auto DescriptorProto_ExtensionRange::InternalGenerateClassData_() {
       },
       &DescriptorProto_ExtensionRange::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &DescriptorProto_ExtensionRange_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -3714,6 +3726,9 @@ constexpr auto DescriptorProto_ReservedRange::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(DescriptorProto_ReservedRange),
                                             alignof(DescriptorProto_ReservedRange));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    DescriptorProto_ReservedRange_reflection_data_;
+
 constexpr auto DescriptorProto_ReservedRange::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -3733,6 +3748,7 @@ constexpr auto DescriptorProto_ReservedRange::InternalGenerateClassData_() {
       },
       &DescriptorProto_ReservedRange::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &DescriptorProto_ReservedRange_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -3849,6 +3865,13 @@ PROTOBUF_NOINLINE void DescriptorProto_ReservedRange::Clear() {
 ::size_t DescriptorProto_ReservedRange::ByteSizeLong() const {
   const DescriptorProto_ReservedRange& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t DescriptorProto_ReservedRange::UncachedByteSizeLong() const {
+  const DescriptorProto_ReservedRange& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.DescriptorProto.ReservedRange)
   ::size_t total_size = 0;
 
@@ -3870,8 +3893,11 @@ PROTOBUF_NOINLINE void DescriptorProto_ReservedRange::Clear() {
           this_._internal_end());
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void DescriptorProto_ReservedRange::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -4053,6 +4079,9 @@ constexpr auto DescriptorProto::InternalNewImpl_() {
                                  alignof(DescriptorProto));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    DescriptorProto_reflection_data_;
+
 constexpr auto DescriptorProto::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -4072,6 +4101,7 @@ constexpr auto DescriptorProto::InternalGenerateClassData_() {
       },
       &DescriptorProto::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &DescriptorProto_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -4323,10 +4353,10 @@ PROTOBUF_NOINLINE void DescriptorProto::Clear() {
                            this_._internal_reserved_range_size());
        i < n; i++) {
     const auto& repfield = this_._internal_reserved_range().Get(i);
-    target =
-        ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
-            9, repfield, repfield.GetCachedSize(),
-            target, stream);
+    target = ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
+        9, repfield,
+        static_cast<int>(repfield.UncachedByteSizeLong()),
+        target, stream);
   }
 
   // repeated string reserved_name = 10;
@@ -4408,7 +4438,7 @@ PROTOBUF_NOINLINE void DescriptorProto::Clear() {
     {
       total_size += 1UL * this_._internal_reserved_range_size();
       for (const auto& msg : this_._internal_reserved_range()) {
-        total_size += ::google::protobuf::internal::WireFormatLite::MessageSize(msg);
+        total_size += ::google::protobuf::internal::WireFormatLite::UncachedMessageSize(msg);
       }
     }
     // repeated string reserved_name = 10;
@@ -4618,6 +4648,9 @@ constexpr auto ExtensionRangeOptions_Declaration::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(ExtensionRangeOptions_Declaration),
                                             alignof(ExtensionRangeOptions_Declaration));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    ExtensionRangeOptions_Declaration_reflection_data_;
+
 constexpr auto ExtensionRangeOptions_Declaration::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -4637,6 +4670,7 @@ constexpr auto ExtensionRangeOptions_Declaration::InternalGenerateClassData_() {
       },
       &ExtensionRangeOptions_Declaration::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &ExtensionRangeOptions_Declaration_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -4809,6 +4843,13 @@ PROTOBUF_NOINLINE void ExtensionRangeOptions_Declaration::Clear() {
 ::size_t ExtensionRangeOptions_Declaration::ByteSizeLong() const {
   const ExtensionRangeOptions_Declaration& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t ExtensionRangeOptions_Declaration::UncachedByteSizeLong() const {
+  const ExtensionRangeOptions_Declaration& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.ExtensionRangeOptions.Declaration)
   ::size_t total_size = 0;
 
@@ -4836,8 +4877,11 @@ PROTOBUF_NOINLINE void ExtensionRangeOptions_Declaration::Clear() {
           this_._internal_number());
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void ExtensionRangeOptions_Declaration::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -5001,6 +5045,9 @@ constexpr auto ExtensionRangeOptions::InternalNewImpl_() {
                                  alignof(ExtensionRangeOptions));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    ExtensionRangeOptions_reflection_data_;
+
 constexpr auto ExtensionRangeOptions::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -5020,6 +5067,7 @@ constexpr auto ExtensionRangeOptions::InternalGenerateClassData_() {
       },
       &ExtensionRangeOptions::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &ExtensionRangeOptions_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -5138,10 +5186,10 @@ PROTOBUF_NOINLINE void ExtensionRangeOptions::Clear() {
                            this_._internal_declaration_size());
        i < n; i++) {
     const auto& repfield = this_._internal_declaration().Get(i);
-    target =
-        ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
-            2, repfield, repfield.GetCachedSize(),
-            target, stream);
+    target = ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
+        2, repfield,
+        static_cast<int>(repfield.UncachedByteSizeLong()),
+        target, stream);
   }
 
   cached_has_bits = this_._impl_._has_bits_[0];
@@ -5203,7 +5251,7 @@ PROTOBUF_NOINLINE void ExtensionRangeOptions::Clear() {
     {
       total_size += 1UL * this_._internal_declaration_size();
       for (const auto& msg : this_._internal_declaration()) {
-        total_size += ::google::protobuf::internal::WireFormatLite::MessageSize(msg);
+        total_size += ::google::protobuf::internal::WireFormatLite::UncachedMessageSize(msg);
       }
     }
     // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
@@ -5407,6 +5455,9 @@ constexpr auto FieldDescriptorProto::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(FieldDescriptorProto),
                                             alignof(FieldDescriptorProto));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    FieldDescriptorProto_reflection_data_;
+
 constexpr auto FieldDescriptorProto::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -5426,6 +5477,7 @@ constexpr auto FieldDescriptorProto::InternalGenerateClassData_() {
       },
       &FieldDescriptorProto::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &FieldDescriptorProto_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -5945,6 +5997,9 @@ constexpr auto OneofDescriptorProto::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(OneofDescriptorProto),
                                             alignof(OneofDescriptorProto));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    OneofDescriptorProto_reflection_data_;
+
 constexpr auto OneofDescriptorProto::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -5964,6 +6019,7 @@ constexpr auto OneofDescriptorProto::InternalGenerateClassData_() {
       },
       &OneofDescriptorProto::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &OneofDescriptorProto_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -6235,6 +6291,9 @@ constexpr auto EnumDescriptorProto_EnumReservedRange::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(EnumDescriptorProto_EnumReservedRange),
                                             alignof(EnumDescriptorProto_EnumReservedRange));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    EnumDescriptorProto_EnumReservedRange_reflection_data_;
+
 constexpr auto EnumDescriptorProto_EnumReservedRange::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -6254,6 +6313,7 @@ constexpr auto EnumDescriptorProto_EnumReservedRange::InternalGenerateClassData_
       },
       &EnumDescriptorProto_EnumReservedRange::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &EnumDescriptorProto_EnumReservedRange_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -6370,6 +6430,13 @@ PROTOBUF_NOINLINE void EnumDescriptorProto_EnumReservedRange::Clear() {
 ::size_t EnumDescriptorProto_EnumReservedRange::ByteSizeLong() const {
   const EnumDescriptorProto_EnumReservedRange& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t EnumDescriptorProto_EnumReservedRange::UncachedByteSizeLong() const {
+  const EnumDescriptorProto_EnumReservedRange& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.EnumDescriptorProto.EnumReservedRange)
   ::size_t total_size = 0;
 
@@ -6391,8 +6458,11 @@ PROTOBUF_NOINLINE void EnumDescriptorProto_EnumReservedRange::Clear() {
           this_._internal_end());
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void EnumDescriptorProto_EnumReservedRange::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -6544,6 +6614,9 @@ constexpr auto EnumDescriptorProto::InternalNewImpl_() {
                                  alignof(EnumDescriptorProto));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    EnumDescriptorProto_reflection_data_;
+
 constexpr auto EnumDescriptorProto::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -6563,6 +6636,7 @@ constexpr auto EnumDescriptorProto::InternalGenerateClassData_() {
       },
       &EnumDescriptorProto::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &EnumDescriptorProto_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -6716,10 +6790,10 @@ PROTOBUF_NOINLINE void EnumDescriptorProto::Clear() {
                            this_._internal_reserved_range_size());
        i < n; i++) {
     const auto& repfield = this_._internal_reserved_range().Get(i);
-    target =
-        ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
-            4, repfield, repfield.GetCachedSize(),
-            target, stream);
+    target = ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
+        4, repfield,
+        static_cast<int>(repfield.UncachedByteSizeLong()),
+        target, stream);
   }
 
   // repeated string reserved_name = 5;
@@ -6766,7 +6840,7 @@ PROTOBUF_NOINLINE void EnumDescriptorProto::Clear() {
     {
       total_size += 1UL * this_._internal_reserved_range_size();
       for (const auto& msg : this_._internal_reserved_range()) {
-        total_size += ::google::protobuf::internal::WireFormatLite::MessageSize(msg);
+        total_size += ::google::protobuf::internal::WireFormatLite::UncachedMessageSize(msg);
       }
     }
     // repeated string reserved_name = 5;
@@ -6947,6 +7021,9 @@ constexpr auto EnumValueDescriptorProto::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(EnumValueDescriptorProto),
                                             alignof(EnumValueDescriptorProto));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    EnumValueDescriptorProto_reflection_data_;
+
 constexpr auto EnumValueDescriptorProto::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -6966,6 +7043,7 @@ constexpr auto EnumValueDescriptorProto::InternalGenerateClassData_() {
       },
       &EnumValueDescriptorProto::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &EnumValueDescriptorProto_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -7294,6 +7372,9 @@ constexpr auto ServiceDescriptorProto::InternalNewImpl_() {
                                  alignof(ServiceDescriptorProto));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    ServiceDescriptorProto_reflection_data_;
+
 constexpr auto ServiceDescriptorProto::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -7313,6 +7394,7 @@ constexpr auto ServiceDescriptorProto::InternalGenerateClassData_() {
       },
       &ServiceDescriptorProto::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &ServiceDescriptorProto_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -7651,6 +7733,9 @@ constexpr auto MethodDescriptorProto::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(MethodDescriptorProto),
                                             alignof(MethodDescriptorProto));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    MethodDescriptorProto_reflection_data_;
+
 constexpr auto MethodDescriptorProto::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -7670,6 +7755,7 @@ constexpr auto MethodDescriptorProto::InternalGenerateClassData_() {
       },
       &MethodDescriptorProto::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &MethodDescriptorProto_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -8114,6 +8200,9 @@ constexpr auto FileOptions::InternalNewImpl_() {
                                  alignof(FileOptions));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    FileOptions_reflection_data_;
+
 constexpr auto FileOptions::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -8133,6 +8222,7 @@ constexpr auto FileOptions::InternalGenerateClassData_() {
       },
       &FileOptions::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &FileOptions_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -8920,6 +9010,9 @@ constexpr auto MessageOptions::InternalNewImpl_() {
                                  alignof(MessageOptions));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    MessageOptions_reflection_data_;
+
 constexpr auto MessageOptions::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -8939,6 +9032,7 @@ constexpr auto MessageOptions::InternalGenerateClassData_() {
       },
       &MessageOptions::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &MessageOptions_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -9321,6 +9415,9 @@ constexpr auto FieldOptions_EditionDefault::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(FieldOptions_EditionDefault),
                                             alignof(FieldOptions_EditionDefault));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    FieldOptions_EditionDefault_reflection_data_;
+
 constexpr auto FieldOptions_EditionDefault::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -9340,6 +9437,7 @@ constexpr auto FieldOptions_EditionDefault::InternalGenerateClassData_() {
       },
       &FieldOptions_EditionDefault::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &FieldOptions_EditionDefault_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -9461,6 +9559,13 @@ PROTOBUF_NOINLINE void FieldOptions_EditionDefault::Clear() {
 ::size_t FieldOptions_EditionDefault::ByteSizeLong() const {
   const FieldOptions_EditionDefault& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t FieldOptions_EditionDefault::UncachedByteSizeLong() const {
+  const FieldOptions_EditionDefault& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.FieldOptions.EditionDefault)
   ::size_t total_size = 0;
 
@@ -9482,8 +9587,11 @@ PROTOBUF_NOINLINE void FieldOptions_EditionDefault::Clear() {
                     ::_pbi::WireFormatLite::EnumSize(this_._internal_edition());
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void FieldOptions_EditionDefault::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -9614,6 +9722,9 @@ constexpr auto FieldOptions_FeatureSupport::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(FieldOptions_FeatureSupport),
                                             alignof(FieldOptions_FeatureSupport));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    FieldOptions_FeatureSupport_reflection_data_;
+
 constexpr auto FieldOptions_FeatureSupport::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -9633,6 +9744,7 @@ constexpr auto FieldOptions_FeatureSupport::InternalGenerateClassData_() {
       },
       &FieldOptions_FeatureSupport::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &FieldOptions_FeatureSupport_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -9786,6 +9898,13 @@ PROTOBUF_NOINLINE void FieldOptions_FeatureSupport::Clear() {
 ::size_t FieldOptions_FeatureSupport::ByteSizeLong() const {
   const FieldOptions_FeatureSupport& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t FieldOptions_FeatureSupport::UncachedByteSizeLong() const {
+  const FieldOptions_FeatureSupport& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.FieldOptions.FeatureSupport)
   ::size_t total_size = 0;
 
@@ -9817,8 +9936,11 @@ PROTOBUF_NOINLINE void FieldOptions_FeatureSupport::Clear() {
                     ::_pbi::WireFormatLite::EnumSize(this_._internal_edition_removed());
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void FieldOptions_FeatureSupport::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -9998,6 +10120,9 @@ constexpr auto FieldOptions::InternalNewImpl_() {
                                  alignof(FieldOptions));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    FieldOptions_reflection_data_;
+
 constexpr auto FieldOptions::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -10017,6 +10142,7 @@ constexpr auto FieldOptions::InternalGenerateClassData_() {
       },
       &FieldOptions::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &FieldOptions_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -10275,10 +10401,10 @@ PROTOBUF_NOINLINE void FieldOptions::Clear() {
                            this_._internal_edition_defaults_size());
        i < n; i++) {
     const auto& repfield = this_._internal_edition_defaults().Get(i);
-    target =
-        ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
-            20, repfield, repfield.GetCachedSize(),
-            target, stream);
+    target = ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
+        20, repfield,
+        static_cast<int>(repfield.UncachedByteSizeLong()),
+        target, stream);
   }
 
   // optional .google.protobuf.FeatureSet features = 21;
@@ -10291,7 +10417,8 @@ PROTOBUF_NOINLINE void FieldOptions::Clear() {
   // optional .google.protobuf.FieldOptions.FeatureSupport feature_support = 22;
   if ((cached_has_bits & 0x00000002u) != 0) {
     target = ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
-        22, *this_._impl_.feature_support_, this_._impl_.feature_support_->GetCachedSize(), target,
+        22, *this_._impl_.feature_support_,
+        static_cast<int>(this_._impl_.feature_support_->UncachedByteSizeLong()), target,
         stream);
   }
 
@@ -10347,7 +10474,7 @@ PROTOBUF_NOINLINE void FieldOptions::Clear() {
     {
       total_size += 2UL * this_._internal_edition_defaults_size();
       for (const auto& msg : this_._internal_edition_defaults()) {
-        total_size += ::google::protobuf::internal::WireFormatLite::MessageSize(msg);
+        total_size += ::google::protobuf::internal::WireFormatLite::UncachedMessageSize(msg);
       }
     }
     // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
@@ -10370,7 +10497,7 @@ PROTOBUF_NOINLINE void FieldOptions::Clear() {
     // optional .google.protobuf.FieldOptions.FeatureSupport feature_support = 22;
     if ((cached_has_bits & 0x00000002u) != 0) {
       total_size += 2 +
-                    ::google::protobuf::internal::WireFormatLite::MessageSize(*this_._impl_.feature_support_);
+                    ::google::protobuf::internal::WireFormatLite::UncachedMessageSize(*this_._impl_.feature_support_);
     }
     // optional .google.protobuf.FieldOptions.CType ctype = 1 [default = STRING];
     if ((cached_has_bits & 0x00000004u) != 0) {
@@ -10597,6 +10724,9 @@ constexpr auto OneofOptions::InternalNewImpl_() {
                                  alignof(OneofOptions));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    OneofOptions_reflection_data_;
+
 constexpr auto OneofOptions::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -10616,6 +10746,7 @@ constexpr auto OneofOptions::InternalGenerateClassData_() {
       },
       &OneofOptions::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &OneofOptions_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -10943,6 +11074,9 @@ constexpr auto EnumOptions::InternalNewImpl_() {
                                  alignof(EnumOptions));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    EnumOptions_reflection_data_;
+
 constexpr auto EnumOptions::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -10962,6 +11096,7 @@ constexpr auto EnumOptions::InternalGenerateClassData_() {
       },
       &EnumOptions::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &EnumOptions_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -11351,6 +11486,9 @@ constexpr auto EnumValueOptions::InternalNewImpl_() {
                                  alignof(EnumValueOptions));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    EnumValueOptions_reflection_data_;
+
 constexpr auto EnumValueOptions::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -11370,6 +11508,7 @@ constexpr auto EnumValueOptions::InternalGenerateClassData_() {
       },
       &EnumValueOptions::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &EnumValueOptions_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -11517,7 +11656,8 @@ PROTOBUF_NOINLINE void EnumValueOptions::Clear() {
   // optional .google.protobuf.FieldOptions.FeatureSupport feature_support = 4;
   if ((cached_has_bits & 0x00000002u) != 0) {
     target = ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
-        4, *this_._impl_.feature_support_, this_._impl_.feature_support_->GetCachedSize(), target,
+        4, *this_._impl_.feature_support_,
+        static_cast<int>(this_._impl_.feature_support_->UncachedByteSizeLong()), target,
         stream);
   }
 
@@ -11580,7 +11720,7 @@ PROTOBUF_NOINLINE void EnumValueOptions::Clear() {
     // optional .google.protobuf.FieldOptions.FeatureSupport feature_support = 4;
     if ((cached_has_bits & 0x00000002u) != 0) {
       total_size += 1 +
-                    ::google::protobuf::internal::WireFormatLite::MessageSize(*this_._impl_.feature_support_);
+                    ::google::protobuf::internal::WireFormatLite::UncachedMessageSize(*this_._impl_.feature_support_);
     }
   }
   return this_.MaybeComputeUnknownFieldsSize(total_size,
@@ -11768,6 +11908,9 @@ constexpr auto ServiceOptions::InternalNewImpl_() {
                                  alignof(ServiceOptions));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    ServiceOptions_reflection_data_;
+
 constexpr auto ServiceOptions::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -11787,6 +11930,7 @@ constexpr auto ServiceOptions::InternalGenerateClassData_() {
       },
       &ServiceOptions::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &ServiceOptions_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -12140,6 +12284,9 @@ constexpr auto MethodOptions::InternalNewImpl_() {
                                  alignof(MethodOptions));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    MethodOptions_reflection_data_;
+
 constexpr auto MethodOptions::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -12159,6 +12306,7 @@ constexpr auto MethodOptions::InternalGenerateClassData_() {
       },
       &MethodOptions::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &MethodOptions_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -12511,6 +12659,9 @@ constexpr auto UninterpretedOption_NamePart::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(UninterpretedOption_NamePart),
                                             alignof(UninterpretedOption_NamePart));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    UninterpretedOption_NamePart_reflection_data_;
+
 constexpr auto UninterpretedOption_NamePart::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -12530,6 +12681,7 @@ constexpr auto UninterpretedOption_NamePart::InternalGenerateClassData_() {
       },
       &UninterpretedOption_NamePart::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &UninterpretedOption_NamePart_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -12649,6 +12801,13 @@ PROTOBUF_NOINLINE void UninterpretedOption_NamePart::Clear() {
 ::size_t UninterpretedOption_NamePart::ByteSizeLong() const {
   const UninterpretedOption_NamePart& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t UninterpretedOption_NamePart::UncachedByteSizeLong() const {
+  const UninterpretedOption_NamePart& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.UninterpretedOption.NamePart)
   ::size_t total_size = 0;
 
@@ -12666,8 +12825,11 @@ PROTOBUF_NOINLINE void UninterpretedOption_NamePart::Clear() {
                                       this_._internal_name_part());
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void UninterpretedOption_NamePart::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -12826,6 +12988,9 @@ constexpr auto UninterpretedOption::InternalNewImpl_() {
                                  alignof(UninterpretedOption));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    UninterpretedOption_reflection_data_;
+
 constexpr auto UninterpretedOption::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -12845,6 +13010,7 @@ constexpr auto UninterpretedOption::InternalGenerateClassData_() {
       },
       &UninterpretedOption::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &UninterpretedOption_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -12984,10 +13150,10 @@ PROTOBUF_NOINLINE void UninterpretedOption::Clear() {
                            this_._internal_name_size());
        i < n; i++) {
     const auto& repfield = this_._internal_name().Get(i);
-    target =
-        ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
-            2, repfield, repfield.GetCachedSize(),
-            target, stream);
+    target = ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
+        2, repfield,
+        static_cast<int>(repfield.UncachedByteSizeLong()),
+        target, stream);
   }
 
   cached_has_bits = this_._impl_._has_bits_[0];
@@ -13063,7 +13229,7 @@ PROTOBUF_NOINLINE void UninterpretedOption::Clear() {
     {
       total_size += 1UL * this_._internal_name_size();
       for (const auto& msg : this_._internal_name()) {
-        total_size += ::google::protobuf::internal::WireFormatLite::MessageSize(msg);
+        total_size += ::google::protobuf::internal::WireFormatLite::UncachedMessageSize(msg);
       }
     }
   }
@@ -13268,6 +13434,9 @@ constexpr auto FeatureSet::InternalNewImpl_() {
                                  alignof(FeatureSet));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    FeatureSet_reflection_data_;
+
 constexpr auto FeatureSet::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -13287,6 +13456,7 @@ constexpr auto FeatureSet::InternalGenerateClassData_() {
       },
       &FeatureSet::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &FeatureSet_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -13687,6 +13857,9 @@ constexpr auto FeatureSetDefaults_FeatureSetEditionDefault::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(FeatureSetDefaults_FeatureSetEditionDefault),
                                             alignof(FeatureSetDefaults_FeatureSetEditionDefault));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    FeatureSetDefaults_FeatureSetEditionDefault_reflection_data_;
+
 constexpr auto FeatureSetDefaults_FeatureSetEditionDefault::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -13706,6 +13879,7 @@ constexpr auto FeatureSetDefaults_FeatureSetEditionDefault::InternalGenerateClas
       },
       &FeatureSetDefaults_FeatureSetEditionDefault::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &FeatureSetDefaults_FeatureSetEditionDefault_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -14042,6 +14216,9 @@ constexpr auto FeatureSetDefaults::InternalNewImpl_() {
                                  alignof(FeatureSetDefaults));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    FeatureSetDefaults_reflection_data_;
+
 constexpr auto FeatureSetDefaults::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -14061,6 +14238,7 @@ constexpr auto FeatureSetDefaults::InternalGenerateClassData_() {
       },
       &FeatureSetDefaults::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &FeatureSetDefaults_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -14390,6 +14568,9 @@ constexpr auto SourceCodeInfo_Location::InternalNewImpl_() {
                                  alignof(SourceCodeInfo_Location));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    SourceCodeInfo_Location_reflection_data_;
+
 constexpr auto SourceCodeInfo_Location::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -14409,6 +14590,7 @@ constexpr auto SourceCodeInfo_Location::InternalGenerateClassData_() {
       },
       &SourceCodeInfo_Location::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &SourceCodeInfo_Location_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -14768,6 +14950,9 @@ constexpr auto SourceCodeInfo::InternalNewImpl_() {
                                  alignof(SourceCodeInfo));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    SourceCodeInfo_reflection_data_;
+
 constexpr auto SourceCodeInfo::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -14787,6 +14972,7 @@ constexpr auto SourceCodeInfo::InternalGenerateClassData_() {
       },
       &SourceCodeInfo::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &SourceCodeInfo_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -15057,6 +15243,9 @@ constexpr auto GeneratedCodeInfo_Annotation::InternalNewImpl_() {
                                  alignof(GeneratedCodeInfo_Annotation));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    GeneratedCodeInfo_Annotation_reflection_data_;
+
 constexpr auto GeneratedCodeInfo_Annotation::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -15076,6 +15265,7 @@ constexpr auto GeneratedCodeInfo_Annotation::InternalGenerateClassData_() {
       },
       &GeneratedCodeInfo_Annotation::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &GeneratedCodeInfo_Annotation_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -15424,6 +15614,9 @@ constexpr auto GeneratedCodeInfo::InternalNewImpl_() {
                                  alignof(GeneratedCodeInfo));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    GeneratedCodeInfo_reflection_data_;
+
 constexpr auto GeneratedCodeInfo::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -15443,6 +15636,7 @@ constexpr auto GeneratedCodeInfo::InternalGenerateClassData_() {
       },
       &GeneratedCodeInfo::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fdescriptor_2eproto,
+      &GeneratedCodeInfo_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -22,8 +22,13 @@
 #include "absl/strings/match.h"
 #include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "google/protobuf/descriptor.pb.h"
+#include "google/protobuf/io/coded_stream.h"
 #include "google/protobuf/parse_context.h"
+#include "google/protobuf/wire_format_lite.h"
 
 
 namespace google {
@@ -543,10 +548,196 @@ class EncodedDescriptorDatabase::DescriptorIndex {
   std::vector<ExtensionEntry> by_extension_flat_;
 };
 
+namespace {
+
+// The parts of the descriptor protos that DescriptorIndex::AddFile() reads,
+// with the same accessors.  They are scanned straight from the wire format,
+// without parsing options, fields and the like, which makes indexing many
+// encoded files much cheaper.  Strings point into the encoded file.
+struct IndexedNamed {
+  absl::string_view name_;
+  absl::string_view name() const { return name_; }
+};
+
+struct IndexedField : IndexedNamed {
+  absl::string_view extendee_;
+  int number_ = 0;
+  absl::string_view extendee() const { return extendee_; }
+  int number() const { return number_; }
+};
+
+struct IndexedMessage : IndexedNamed {
+  std::vector<IndexedMessage> nested_type_;
+  std::vector<IndexedField> extension_;
+  const std::vector<IndexedMessage>& nested_type() const {
+    return nested_type_;
+  }
+  const std::vector<IndexedField>& extension() const { return extension_; }
+};
+
+struct IndexedFile : IndexedNamed {
+  absl::string_view package_;
+  std::vector<IndexedMessage> message_type_;
+  std::vector<IndexedNamed> enum_type_;
+  std::vector<IndexedField> extension_;
+  std::vector<IndexedNamed> service_;
+  absl::string_view package() const { return package_; }
+  const std::vector<IndexedMessage>& message_type() const {
+    return message_type_;
+  }
+  const std::vector<IndexedNamed>& enum_type() const { return enum_type_; }
+  const std::vector<IndexedField>& extension() const { return extension_; }
+  const std::vector<IndexedNamed>& service() const { return service_; }
+};
+
+constexpr uint32_t LengthDelimitedTag(int field_number) {
+  return internal::WireFormatLite::MakeTag(
+      field_number, internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+}
+
+bool ReadStringView(io::CodedInputStream* input, absl::string_view* output) {
+  uint32_t size;
+  if (!input->ReadVarint32(&size)) return false;
+  if (size == 0) {
+    *output = absl::string_view();
+    return true;
+  }
+  const void* data;
+  int available;
+  if (!input->GetDirectBufferPointer(&data, &available) ||
+      size > static_cast<uint32_t>(available)) {
+    return false;
+  }
+  *output = absl::string_view(static_cast<const char*>(data), size);
+  return input->Skip(static_cast<int>(size));
+}
+
+// Reads the fields of one message with `read_field(tag, input)`, which returns
+// false on errors and sets `*handled` if it did read the field.  The others are
+// skipped.
+template <typename ReadField>
+bool ScanMessage(io::CodedInputStream* input, ReadField read_field) {
+  while (uint32_t tag = input->ReadTag()) {
+    bool handled = false;
+    if (!read_field(tag, input, &handled)) return false;
+    if (!handled && !internal::WireFormatLite::SkipField(input, tag)) {
+      return false;
+    }
+  }
+  return input->ConsumedEntireMessage();
+}
+
+template <typename ReadField>
+bool ScanSubMessage(io::CodedInputStream* input, ReadField read_field) {
+  // A sub-message must fit in its parent, as the parser also checks.
+  uint32_t size;
+  if (!input->ReadVarint32(&size) ||
+      size > static_cast<uint32_t>(input->BytesUntilLimit()) ||
+      !input->IncrementRecursionDepth()) {
+    return false;
+  }
+  io::CodedInputStream::Limit limit =
+      input->PushLimit(static_cast<int>(size));
+  bool success = ScanMessage(input, read_field);
+  input->PopLimit(limit);
+  input->DecrementRecursionDepth();
+  return success;
+}
+
+// Reads an EnumDescriptorProto or a ServiceDescriptorProto, whose names have
+// the same field number.
+bool ScanNamed(io::CodedInputStream* input, IndexedNamed* output) {
+  return ScanSubMessage(
+      input, [output](uint32_t tag, io::CodedInputStream* in, bool* handled) {
+        if (tag != LengthDelimitedTag(EnumDescriptorProto::kNameFieldNumber)) {
+          return true;
+        }
+        *handled = true;
+        return ReadStringView(in, &output->name_);
+      });
+}
+
+bool ScanField(io::CodedInputStream* input, IndexedField* output) {
+  return ScanSubMessage(
+      input, [output](uint32_t tag, io::CodedInputStream* in, bool* handled) {
+        switch (tag) {
+          case LengthDelimitedTag(FieldDescriptorProto::kNameFieldNumber):
+            *handled = true;
+            return ReadStringView(in, &output->name_);
+          case LengthDelimitedTag(FieldDescriptorProto::kExtendeeFieldNumber):
+            *handled = true;
+            return ReadStringView(in, &output->extendee_);
+          case internal::WireFormatLite::MakeTag(
+              FieldDescriptorProto::kNumberFieldNumber,
+              internal::WireFormatLite::WIRETYPE_VARINT): {
+            *handled = true;
+            uint32_t number;
+            if (!in->ReadVarint32(&number)) return false;
+            output->number_ = static_cast<int>(number);
+            return true;
+          }
+          default:
+            return true;
+        }
+      });
+}
+
+bool ScanMessageType(io::CodedInputStream* input, IndexedMessage* output) {
+  return ScanSubMessage(
+      input, [output](uint32_t tag, io::CodedInputStream* in, bool* handled) {
+        switch (tag) {
+          case LengthDelimitedTag(DescriptorProto::kNameFieldNumber):
+            *handled = true;
+            return ReadStringView(in, &output->name_);
+          case LengthDelimitedTag(DescriptorProto::kNestedTypeFieldNumber):
+            *handled = true;
+            return ScanMessageType(in, &output->nested_type_.emplace_back());
+          case LengthDelimitedTag(DescriptorProto::kExtensionFieldNumber):
+            *handled = true;
+            return ScanField(in, &output->extension_.emplace_back());
+          default:
+            return true;
+        }
+      });
+}
+
+bool ScanFile(const void* data, int size, IndexedFile* output) {
+  io::CodedInputStream input(static_cast<const uint8_t*>(data), size);
+  return ScanMessage(&input, [output](uint32_t tag, io::CodedInputStream* in,
+                                      bool* handled) {
+    switch (tag) {
+      case LengthDelimitedTag(FileDescriptorProto::kNameFieldNumber):
+        *handled = true;
+        return ReadStringView(in, &output->name_);
+      case LengthDelimitedTag(FileDescriptorProto::kPackageFieldNumber):
+        *handled = true;
+        return ReadStringView(in, &output->package_);
+      case LengthDelimitedTag(FileDescriptorProto::kMessageTypeFieldNumber):
+        *handled = true;
+        return ScanMessageType(in, &output->message_type_.emplace_back());
+      case LengthDelimitedTag(FileDescriptorProto::kEnumTypeFieldNumber):
+        *handled = true;
+        return ScanNamed(in, &output->enum_type_.emplace_back());
+      case LengthDelimitedTag(FileDescriptorProto::kExtensionFieldNumber):
+        *handled = true;
+        return ScanField(in, &output->extension_.emplace_back());
+      case LengthDelimitedTag(FileDescriptorProto::kServiceFieldNumber):
+        *handled = true;
+        return ScanNamed(in, &output->service_.emplace_back());
+      default:
+        return true;
+    }
+  });
+}
+
+}  // namespace
+
 bool EncodedDescriptorDatabase::Add(const void* encoded_file_descriptor,
                                     int size) {
-  FileDescriptorProto file;
-  if (file.ParseFromArray(encoded_file_descriptor, size)) {
+  // Lazily added files came first and win any conflict.
+  IndexLazilyAddedFiles();
+  IndexedFile file;
+  if (ScanFile(encoded_file_descriptor, size, &file)) {
     return index_->AddFile(file, std::make_pair(encoded_file_descriptor, size));
   } else {
     ABSL_LOG(ERROR) << "Invalid file descriptor data passed to "
@@ -563,18 +754,62 @@ bool EncodedDescriptorDatabase::AddCopy(const void* encoded_file_descriptor,
   return Add(copy, size);
 }
 
+void EncodedDescriptorDatabase::AddLazily(const void* encoded_file_descriptor,
+                                          int size) {
+  unindexed_files_.emplace_back(encoded_file_descriptor, size);
+}
+
+bool EncodedDescriptorDatabase::AddFileDescriptorSet(
+    const void* encoded_file_descriptor_set, int size) {
+  const auto* data = static_cast<const uint8_t*>(encoded_file_descriptor_set);
+  const uint32_t kFileTag = internal::WireFormatLite::MakeTag(
+      FileDescriptorSet::kFileFieldNumber,
+      internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+
+  std::vector<std::pair<const void*, int>> files;
+  io::CodedInputStream input(data, size);
+  while (uint32_t tag = input.ReadTag()) {
+    if (tag != kFileTag) {
+      if (!internal::WireFormatLite::SkipField(&input, tag)) return false;
+      continue;
+    }
+    uint32_t length;
+    if (!input.ReadVarint32(&length)) return false;
+    const int offset = input.CurrentPosition();
+    if (!input.Skip(length)) return false;
+    files.emplace_back(data + offset, static_cast<int>(length));
+  }
+  if (!input.ConsumedEntireMessage()) return false;
+
+  unindexed_files_.insert(unindexed_files_.end(), files.begin(), files.end());
+  return true;
+}
+
+void EncodedDescriptorDatabase::IndexLazilyAddedFiles() {
+  if (unindexed_files_.empty()) return;
+  std::vector<std::pair<const void*, int>> files;
+  files.swap(unindexed_files_);
+  for (const auto& file : files) {
+    // Errors are logged by Add().
+    Add(file.first, file.second);
+  }
+}
+
 bool EncodedDescriptorDatabase::FindFileByName(const std::string& filename,
                                                FileDescriptorProto* output) {
+  IndexLazilyAddedFiles();
   return MaybeParse(index_->FindFile(filename), output);
 }
 
 bool EncodedDescriptorDatabase::FindFileContainingSymbol(
     const std::string& symbol_name, FileDescriptorProto* output) {
+  IndexLazilyAddedFiles();
   return MaybeParse(index_->FindSymbol(symbol_name), output);
 }
 
 bool EncodedDescriptorDatabase::FindNameOfFileContainingSymbol(
     const std::string& symbol_name, std::string* output) {
+  IndexLazilyAddedFiles();
   auto encoded_file = index_->FindSymbol(symbol_name);
   if (encoded_file.first == nullptr) return false;
 
@@ -604,12 +839,14 @@ bool EncodedDescriptorDatabase::FindNameOfFileContainingSymbol(
 bool EncodedDescriptorDatabase::FindFileContainingExtension(
     const std::string& containing_type, int field_number,
     FileDescriptorProto* output) {
+  IndexLazilyAddedFiles();
   return MaybeParse(index_->FindExtension(containing_type, field_number),
                     output);
 }
 
 bool EncodedDescriptorDatabase::FindAllExtensionNumbers(
     const std::string& extendee_type, std::vector<int>* output) {
+  IndexLazilyAddedFiles();
   return index_->FindAllExtensionNumbers(extendee_type, output);
 }
 
@@ -860,6 +1097,7 @@ EncodedDescriptorDatabase::DescriptorIndex::FindFile(
 
 bool EncodedDescriptorDatabase::FindAllFileNames(
     std::vector<std::string>* output) {
+  IndexLazilyAddedFiles();
   index_->FindAllFileNames(output);
   return true;
 }
@@ -1045,5 +1283,95 @@ bool MergedDescriptorDatabase::FindAllFileNames(
   return implemented;
 }
 
+// ===================================================================
+
+CachingDescriptorDatabase::CachingDescriptorDatabase(
+    DescriptorDatabase* source, CachingDescriptorDatabaseOptions options)
+    : source_(source), options_(std::move(options)) {}
+CachingDescriptorDatabase::~CachingDescriptorDatabase() {}
+
+void CachingDescriptorDatabase::Invalidate() {
+  absl::MutexLock lock(&mutex_);
+  missing_files_.clear();
+  missing_symbols_.clear();
+  missing_extensions_.clear();
+}
+
+template <typename Key>
+bool CachingDescriptorDatabase::IsKnownMiss(const MissMap<Key>& misses,
+                                            const Key& key) const {
+  auto it = misses.find(key);
+  if (it == misses.end()) return false;
+  // Don't call absl::Now() unless the entry can expire.
+  return it->second == absl::InfiniteFuture() || absl::Now() < it->second;
+}
+
+template <typename Key>
+void CachingDescriptorDatabase::AddMiss(MissMap<Key>& misses, Key key) {
+  if (options_.max_negative_entries == 0) return;
+  absl::Time now = absl::InfinitePast();
+  if (options_.negative_ttl != absl::InfiniteDuration()) now = absl::Now();
+  if (misses.size() >= options_.max_negative_entries) {
+    absl::erase_if(misses, [now](const auto& entry) {
+      return entry.second <= now;
+    });
+    if (misses.size() >= options_.max_negative_entries) misses.clear();
+  }
+  misses[std::move(key)] = options_.negative_ttl == absl::InfiniteDuration()
+                               ? absl::InfiniteFuture()
+                               : now + options_.negative_ttl;
+}
+
+bool CachingDescriptorDatabase::FindFileByName(const std::string& filename,
+                                               FileDescriptorProto* output) {
+  {
+    absl::ReaderMutexLock lock(&mutex_);
+    if (IsKnownMiss(missing_files_, filename)) return false;
+  }
+  if (source_->FindFileByName(filename, output)) return true;
+  absl::MutexLock lock(&mutex_);
+  AddMiss(missing_files_, filename);
+  return false;
+}
+
+bool CachingDescriptorDatabase::FindFileContainingSymbol(
+    const std::string& symbol_name, FileDescriptorProto* output) {
+  {
+    absl::ReaderMutexLock lock(&mutex_);
+    if (IsKnownMiss(missing_symbols_, symbol_name)) return false;
+  }
+  if (source_->FindFileContainingSymbol(symbol_name, output)) return true;
+  absl::MutexLock lock(&mutex_);
+  AddMiss(missing_symbols_, symbol_name);
+  return false;
+}
+
+bool CachingDescriptorDatabase::FindFileContainingExtension(
+    const std::string& containing_type, int field_number,
+    FileDescriptorProto* output) {
+  std::pair<std::string, int> key(containing_type, field_number);
+  {
+    absl::ReaderMutexLock lock(&mutex_);
+    if (IsKnownMiss(missing_extensions_, key)) return false;
+  }
+  if (source_->FindFileContainingExtension(containing_type, field_number,
+                                           output)) {
+    return true;
+  }
+  absl::MutexLock lock(&mutex_);
+  AddMiss(missing_extensions_, std::move(key));
+  return false;
+}
+
+bool CachingDescriptorDatabase::FindAllExtensionNumbers(
+    const std::string& extendee_type, std::vector<int>* output) {
+  return source_->FindAllExtensionNumbers(extendee_type, output);
+}
+
+bool CachingDescriptorDatabase::FindAllFileNames(
+    std::vector<std::string>* output) {
+  return source_->FindAllFileNames(output);
+}
+
 }  // namespace protobuf
 }  // namespace google
@@ -14,11 +14,16 @@
 #ifndef GOOGLE_PROTOBUF_DESCRIPTOR_DATABASE_H__
 #define GOOGLE_PROTOBUF_DESCRIPTOR_DATABASE_H__
 
+#include <cstddef>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/port.h"
 
@@ -38,6 +43,7 @@ class SimpleDescriptorDatabase;
 class EncodedDescriptorDatabase;
 class DescriptorPoolDatabase;
 class MergedDescriptorDatabase;
+class CachingDescriptorDatabase;
 
 // Abstract interface for a database of descriptors.
 //
@@ -275,13 +281,29 @@ class PROTOBUF_EXPORT EncodedDescriptorDatabase : public DescriptorDatabase {
   // does it take ownership; it's up to the caller to make sure the bytes
   // remain valid for the life of the database.  Returns false and logs an error
   // if the bytes are not a valid FileDescriptorProto or if the file conflicted
-  // with a file already in the database.
+  // with a file already in the database.  Only the wire format and the names
+  // needed to index the file are checked; the file is fully parsed when it is
+  // looked up.
   bool Add(const void* encoded_file_descriptor, int size);
 
   // Like Add(), but makes a copy of the data, so that the caller does not
   // need to keep it around.
   bool AddCopy(const void* encoded_file_descriptor, int size);
 
+  // Like Add(), but defers parsing and indexing the file until the database is
+  // next queried, so that registering many files which are never looked up
+  // stays cheap.  Because errors are only detected then, they are logged and
+  // the offending file is skipped instead of being reported to the caller.
+  void AddLazily(const void* encoded_file_descriptor, int size);
+
+  // Adds every file of the encoded FileDescriptorSet as AddLazily() would.  The
+  // set is only scanned for file boundaries, not parsed, and is not copied.
+  // That makes it cheap to serve a large schema straight from a memory-mapped
+  // file: startup only costs the scan, files are parsed as they are looked up,
+  // and processes mapping the same file share its pages.  Returns false, and
+  // adds nothing, if the set is malformed.
+  bool AddFileDescriptorSet(const void* encoded_file_descriptor_set, int size);
+
   // Like FindFileContainingSymbol but returns only the name of the file.
   bool FindNameOfFileContainingSymbol(const std::string& symbol_name,
                                       std::string* output);
@@ -304,6 +326,11 @@ class PROTOBUF_EXPORT EncodedDescriptorDatabase : public DescriptorDatabase {
   // cleaner header.
   std::unique_ptr<DescriptorIndex> index_;
   std::vector<void*> files_to_delete_;
+  // Files passed to AddLazily() that are not in `index_` yet.
+  std::vector<std::pair<const void*, int>> unindexed_files_;
+
+  // Adds `unindexed_files_` to `index_`.  Called before every lookup.
+  void IndexLazilyAddedFiles();
 
   // If encoded_file.first is non-nullptr, parse the data into *output and
   // return true, otherwise return false.
@@ -380,6 +407,76 @@ class PROTOBUF_EXPORT MergedDescriptorDatabase : public DescriptorDatabase {
   std::vector<DescriptorDatabase*> sources_;
 };
 
+struct PROTOBUF_EXPORT CachingDescriptorDatabaseOptions {
+  // How long a failed lookup is remembered.  By default it is remembered until
+  // Invalidate() is called.
+  absl::Duration negative_ttl = absl::InfiniteDuration();
+  // The most failed lookups of each kind (file, symbol, extension) that are
+  // remembered.  When there are more, the expired ones are dropped, or all of
+  // them if none has expired.  Bounds the memory used when the names looked up
+  // come from untrusted input, such as the type URLs of Any messages.
+  size_t max_negative_entries = 10000;
+};
+
+// A DescriptorDatabase that wraps another one, and remembers which lookups in
+// it failed so that they are not repeated.  DescriptorPool only remembers
+// failed lookups in its fallback database while it builds a single file, so
+// looking up an unknown name, e.g. when resolving an Any, queries every
+// source of a MergedDescriptorDatabase each time.  Using this database as the
+// fallback database of the pool answers those lookups from the cache.
+//
+// Successful lookups are always forwarded, since the pool keeps the files it
+// builds.  The cache is thread-safe, and lookups are forwarded without holding
+// its lock, so this database can be used from several threads if the wrapped
+// one can.
+class PROTOBUF_EXPORT CachingDescriptorDatabase : public DescriptorDatabase {
+ public:
+  // The source remains property of the caller.
+  explicit CachingDescriptorDatabase(
+      DescriptorDatabase* source,
+      CachingDescriptorDatabaseOptions options = {});
+  CachingDescriptorDatabase(const CachingDescriptorDatabase&) = delete;
+  CachingDescriptorDatabase& operator=(const CachingDescriptorDatabase&) =
+      delete;
+  ~CachingDescriptorDatabase() override;
+
+  // Forgets all failed lookups.  Must be called after files are added to the
+  // source, for them to be found before the failed lookups expire.
+  void Invalidate();
+
+  // implements DescriptorDatabase -----------------------------------
+  bool FindFileByName(const std::string& filename,
+                      FileDescriptorProto* output) override;
+  bool FindFileContainingSymbol(const std::string& symbol_name,
+                                FileDescriptorProto* output) override;
+  bool FindFileContainingExtension(const std::string& containing_type,
+                                   int field_number,
+                                   FileDescriptorProto* output) override;
+  bool FindAllExtensionNumbers(const std::string& extendee_type,
+                               std::vector<int>* output) override;
+  bool FindAllFileNames(std::vector<std::string>* output) override;
+
+ private:
+  // Maps each failed lookup to its expiration time.
+  template <typename Key>
+  using MissMap = absl::flat_hash_map<Key, absl::Time>;
+
+  template <typename Key>
+  bool IsKnownMiss(const MissMap<Key>& misses, const Key& key) const
+      ABSL_SHARED_LOCKS_REQUIRED(mutex_);
+  template <typename Key>
+  void AddMiss(MissMap<Key>& misses, Key key)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  DescriptorDatabase* source_;
+  CachingDescriptorDatabaseOptions options_;
+  absl::Mutex mutex_;
+  MissMap<std::string> missing_files_ ABSL_GUARDED_BY(mutex_);
+  MissMap<std::string> missing_symbols_ ABSL_GUARDED_BY(mutex_);
+  MissMap<std::pair<std::string, int>> missing_extensions_
+      ABSL_GUARDED_BY(mutex_);
+};
+
 }  // namespace protobuf
 }  // namespace google
 
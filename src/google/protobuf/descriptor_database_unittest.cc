@@ -17,6 +17,7 @@
 #include <memory>
 
 #include "google/protobuf/descriptor.pb.h"
+#include "absl/time/time.h"
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "google/protobuf/descriptor.h"
@@ -488,6 +489,113 @@ TEST(EncodedDescriptorDatabaseExtraTest, FindNameOfFileContainingSymbol) {
   EXPECT_FALSE(db.FindNameOfFileContainingSymbol("baz.Baz", &filename));
 }
 
+TEST(EncodedDescriptorDatabaseExtraTest, AddLazily) {
+  FileDescriptorProto foo, bar, conflict;
+  foo.set_name("foo.proto");
+  foo.add_message_type()->set_name("Foo");
+  bar.set_name("bar.proto");
+  bar.add_message_type()->set_name("Bar");
+  conflict.set_name("conflict.proto");
+  conflict.add_message_type()->set_name("Foo");
+  std::string foo_data = foo.SerializeAsString();
+  std::string bar_data = bar.SerializeAsString();
+  std::string conflict_data = conflict.SerializeAsString();
+
+  EncodedDescriptorDatabase db;
+  db.AddLazily(foo_data.data(), foo_data.size());
+  db.AddLazily(conflict_data.data(), conflict_data.size());
+  // Files added with Add() are indexed after the lazily added ones.
+  EXPECT_FALSE(db.Add(foo_data.data(), foo_data.size()));
+  db.AddLazily(bar_data.data(), bar_data.size());
+
+  FileDescriptorProto file;
+  EXPECT_TRUE(db.FindFileContainingSymbol("Foo", &file));
+  EXPECT_EQ(file.name(), "foo.proto");
+  EXPECT_TRUE(db.FindFileContainingSymbol("Bar", &file));
+  EXPECT_EQ(file.name(), "bar.proto");
+
+  // The conflicting file was skipped.
+  std::vector<std::string> names;
+  EXPECT_TRUE(db.FindAllFileNames(&names));
+  EXPECT_THAT(names, testing::UnorderedElementsAre("foo.proto", "bar.proto"));
+}
+
+TEST(EncodedDescriptorDatabaseExtraTest, AddFileDescriptorSet) {
+  FileDescriptorSet set;
+  FileDescriptorProto* foo = set.add_file();
+  foo->set_name("foo.proto");
+  foo->add_message_type()->set_name("Foo");
+  FileDescriptorProto* bar = set.add_file();
+  bar->set_name("bar.proto");
+  bar->add_dependency("foo.proto");
+  DescriptorProto* bar_message = bar->add_message_type();
+  bar_message->set_name("Bar");
+  FieldDescriptorProto* field = bar_message->add_field();
+  field->set_name("foo");
+  field->set_number(1);
+  field->set_label(FieldDescriptorProto::LABEL_OPTIONAL);
+  field->set_type(FieldDescriptorProto::TYPE_MESSAGE);
+  field->set_type_name(".Foo");
+  std::string data = set.SerializeAsString();
+
+  EncodedDescriptorDatabase db;
+  // Truncated sets are rejected as a whole.
+  EXPECT_FALSE(db.AddFileDescriptorSet(data.data(), data.size() - 1));
+  ASSERT_TRUE(db.AddFileDescriptorSet(data.data(), data.size()));
+
+  DescriptorPool pool(&db);
+  const Descriptor* descriptor = pool.FindMessageTypeByName("Bar");
+  ASSERT_TRUE(descriptor != nullptr);
+  EXPECT_EQ(descriptor->field(0)->message_type(),
+            pool.FindMessageTypeByName("Foo"));
+  std::vector<std::string> names;
+  EXPECT_TRUE(db.FindAllFileNames(&names));
+  EXPECT_THAT(names, testing::UnorderedElementsAre("foo.proto", "bar.proto"));
+}
+
+TEST(EncodedDescriptorDatabaseExtraTest, AddIndexesWithoutParsing) {
+  FileDescriptorProto file;
+  file.set_name("foo.proto");
+  file.set_package("foo");
+  file.mutable_options()->set_java_package("com.foo");
+  DescriptorProto* outer = file.add_message_type();
+  outer->set_name("Outer");
+  outer->add_extension_range()->set_start(100);
+  outer->mutable_extension_range(0)->set_end(200);
+  FieldDescriptorProto* field = outer->add_field();
+  field->set_name("value");
+  field->set_number(1);
+  DescriptorProto* inner = outer->add_nested_type();
+  inner->set_name("Inner");
+  FieldDescriptorProto* extension = inner->add_extension();
+  extension->set_name("ext");
+  extension->set_extendee(".foo.Outer");
+  extension->set_number(100);
+  file.add_enum_type()->set_name("Color");
+  file.add_service()->set_name("Service");
+  std::string data = file.SerializeAsString();
+
+  EncodedDescriptorDatabase db;
+  // Truncated or malformed files are still rejected.
+  EXPECT_FALSE(db.Add(data.data(), data.size() - 1));
+  std::string bad_tag = data + '\0';
+  EXPECT_FALSE(db.Add(bad_tag.data(), bad_tag.size()));
+  ASSERT_TRUE(db.Add(data.data(), data.size()));
+
+  FileDescriptorProto output;
+  for (const char* symbol :
+       {"foo.Outer", "foo.Outer.Inner", "foo.Color", "foo.Service"}) {
+    SCOPED_TRACE(symbol);
+    EXPECT_TRUE(db.FindFileContainingSymbol(symbol, &output));
+    EXPECT_EQ(output.name(), "foo.proto");
+  }
+  EXPECT_TRUE(db.FindFileContainingExtension("foo.Outer", 100, &output));
+  EXPECT_EQ(output.name(), "foo.proto");
+  std::vector<int> numbers;
+  EXPECT_TRUE(db.FindAllExtensionNumbers("foo.Outer", &numbers));
+  EXPECT_THAT(numbers, testing::ElementsAre(100));
+}
+
 TEST(SimpleDescriptorDatabaseExtraTest, FindAllFileNames) {
   FileDescriptorProto f;
   f.set_name("foo.proto");
@@ -871,6 +979,129 @@ TEST_F(MergedDescriptorDatabaseTest, FindAllFileNames) {
                                                      "baz.proto", "baz.proto"));
 }
 
+// ===================================================================
+
+// Counts the symbol lookups that reach the wrapped database.
+class CountingDescriptorDatabase : public DescriptorDatabase {
+ public:
+  explicit CountingDescriptorDatabase(DescriptorDatabase* wrapped)
+      : wrapped_(wrapped) {}
+
+  bool FindFileByName(const std::string& filename,
+                      FileDescriptorProto* output) override {
+    return wrapped_->FindFileByName(filename, output);
+  }
+  bool FindFileContainingSymbol(const std::string& symbol_name,
+                                FileDescriptorProto* output) override {
+    ++symbol_lookups_;
+    return wrapped_->FindFileContainingSymbol(symbol_name, output);
+  }
+  bool FindFileContainingExtension(const std::string& containing_type,
+                                   int field_number,
+                                   FileDescriptorProto* output) override {
+    ++extension_lookups_;
+    return wrapped_->FindFileContainingExtension(containing_type, field_number,
+                                                 output);
+  }
+
+  int symbol_lookups_ = 0;
+  int extension_lookups_ = 0;
+
+ private:
+  DescriptorDatabase* wrapped_;
+};
+
+class CachingDescriptorDatabaseTest : public testing::Test {
+ protected:
+  CachingDescriptorDatabaseTest() : counting_(&database_) {}
+
+  void SetUp() override {
+    AddToDatabase(
+        &database_,
+        "name: \"foo.proto\" "
+        "message_type { name:\"Foo\" extension_range { start: 1 end: 100 } } "
+        "extension { name:\"foo_ext\" extendee: \".Foo\" number:3 "
+        "            label:LABEL_OPTIONAL type:TYPE_INT32 } ");
+  }
+
+  SimpleDescriptorDatabase database_;
+  CountingDescriptorDatabase counting_;
+};
+
+TEST_F(CachingDescriptorDatabaseTest, RemembersMissesUntilInvalidated) {
+  CachingDescriptorDatabase caching(&counting_);
+  FileDescriptorProto file;
+
+  // Successful lookups are always forwarded.
+  EXPECT_TRUE(caching.FindFileContainingSymbol("Foo", &file));
+  EXPECT_TRUE(caching.FindFileContainingSymbol("Foo", &file));
+  EXPECT_EQ(counting_.symbol_lookups_, 2);
+
+  EXPECT_FALSE(caching.FindFileContainingSymbol("Bar", &file));
+  EXPECT_FALSE(caching.FindFileContainingSymbol("Bar", &file));
+  EXPECT_EQ(counting_.symbol_lookups_, 3);
+
+  EXPECT_FALSE(caching.FindFileContainingExtension("Foo", 4, &file));
+  EXPECT_FALSE(caching.FindFileContainingExtension("Foo", 4, &file));
+  EXPECT_TRUE(caching.FindFileContainingExtension("Foo", 3, &file));
+  EXPECT_EQ(counting_.extension_lookups_, 2);
+
+  EXPECT_FALSE(caching.FindFileByName("bar.proto", &file));
+  AddToDatabase(&database_,
+                "name: \"bar.proto\" message_type { name:\"Bar\" }");
+  EXPECT_FALSE(caching.FindFileByName("bar.proto", &file));
+  EXPECT_FALSE(caching.FindFileContainingSymbol("Bar", &file));
+  EXPECT_EQ(counting_.symbol_lookups_, 3);
+
+  caching.Invalidate();
+  EXPECT_TRUE(caching.FindFileByName("bar.proto", &file));
+  EXPECT_TRUE(caching.FindFileContainingSymbol("Bar", &file));
+  EXPECT_EQ("bar.proto", file.name());
+  EXPECT_EQ(counting_.symbol_lookups_, 4);
+}
+
+TEST_F(CachingDescriptorDatabaseTest, ExpiredMissesAreRepeated) {
+  CachingDescriptorDatabaseOptions options;
+  options.negative_ttl = absl::ZeroDuration();
+  CachingDescriptorDatabase caching(&counting_, options);
+  FileDescriptorProto file;
+
+  EXPECT_FALSE(caching.FindFileContainingSymbol("Bar", &file));
+  EXPECT_FALSE(caching.FindFileContainingSymbol("Bar", &file));
+  EXPECT_EQ(counting_.symbol_lookups_, 2);
+}
+
+TEST_F(CachingDescriptorDatabaseTest, BoundsRememberedMisses) {
+  CachingDescriptorDatabaseOptions options;
+  options.max_negative_entries = 2;
+  CachingDescriptorDatabase caching(&counting_, options);
+  FileDescriptorProto file;
+
+  EXPECT_FALSE(caching.FindFileContainingSymbol("A", &file));
+  EXPECT_FALSE(caching.FindFileContainingSymbol("B", &file));
+  EXPECT_FALSE(caching.FindFileContainingSymbol("A", &file));
+  EXPECT_EQ(counting_.symbol_lookups_, 2);
+
+  // Remembering a third miss forgets the first two.
+  EXPECT_FALSE(caching.FindFileContainingSymbol("C", &file));
+  EXPECT_FALSE(caching.FindFileContainingSymbol("C", &file));
+  EXPECT_FALSE(caching.FindFileContainingSymbol("A", &file));
+  EXPECT_EQ(counting_.symbol_lookups_, 4);
+}
+
+TEST_F(CachingDescriptorDatabaseTest, PoolDoesNotRepeatMisses) {
+  MergedDescriptorDatabase merged(&counting_, &counting_);
+  CachingDescriptorDatabase caching(&merged);
+  DescriptorPool pool(&caching);
+
+  EXPECT_EQ(pool.FindMessageTypeByName("Bar"), nullptr);
+  EXPECT_EQ(counting_.symbol_lookups_, 2);
+  EXPECT_EQ(pool.FindMessageTypeByName("Bar"), nullptr);
+  EXPECT_EQ(pool.FindMessageTypeByName("Bar"), nullptr);
+  EXPECT_EQ(counting_.symbol_lookups_, 2);
+
+  EXPECT_NE(pool.FindMessageTypeByName("Foo"), nullptr);
+}
 
 }  // anonymous namespace
 }  // namespace protobuf
@@ -911,6 +911,13 @@ TEST_F(DescriptorTest, FieldNameDedupJsonEqFull) {
   EXPECT_EQ(file->message_type(0)->field(0)->json_name(), "Name1.Name2");
 }
 
+TEST_F(DescriptorTest, FieldDescriptorIsCompact) {
+  // Large pools hold many fields: the bitfields and `number_` must share the
+  // first word, followed by ten pointer-sized members.
+  if (sizeof(void*) != 8) GTEST_SKIP() << "Layout checked on 64-bit only.";
+  EXPECT_LE(sizeof(FieldDescriptor), 11 * sizeof(void*));
+}
+
 TEST_F(DescriptorTest, FieldsByIndex) {
   ASSERT_EQ(4, message_->field_count());
   EXPECT_EQ(foo_, message_->field(0));
@@ -1631,6 +1638,32 @@ TEST_F(EnumDescriptorTest, FindValueByName) {
   EXPECT_TRUE(enum2_->FindValueByName("BAR") == nullptr);
 }
 
+TEST_F(EnumDescriptorTest, FindValueByNameIgnoringCase) {
+  EXPECT_EQ(foo_, enum_->FindValueByNameIgnoringCase("foo"));
+  EXPECT_EQ(bar_, enum_->FindValueByNameIgnoringCase("bAr"));
+  EXPECT_EQ(foo2_, enum2_->FindValueByNameIgnoringCase("FOO"));
+  EXPECT_EQ(baz2_, enum2_->FindValueByNameIgnoringCase("Baz"));
+
+  EXPECT_TRUE(enum_->FindValueByNameIgnoringCase("baz") == nullptr);
+  EXPECT_TRUE(enum2_->FindValueByNameIgnoringCase("bar") == nullptr);
+}
+
+TEST_F(EnumDescriptorTest, FindValueByNameIgnoringCasePrefersFirstDefined) {
+  FileDescriptorProto file_proto;
+  file_proto.set_name("cased.proto");
+  EnumDescriptorProto* enum_proto = AddEnum(&file_proto, "CasedEnum");
+  AddEnumValue(enum_proto, "Foo", 1);
+  AddEnumValue(enum_proto, "FOO", 2);
+  AddEnumValue(enum_proto, "foo", 3);
+  const FileDescriptor* file = pool_.BuildFile(file_proto);
+  ASSERT_TRUE(file != nullptr);
+  const EnumDescriptor* cased = file->enum_type(0);
+
+  EXPECT_EQ(cased->value(0), cased->FindValueByNameIgnoringCase("foo"));
+  EXPECT_EQ(cased->value(0), cased->FindValueByNameIgnoringCase("FOO"));
+  EXPECT_EQ(cased->value(1), cased->FindValueByName("FOO"));
+}
+
 TEST_F(EnumDescriptorTest, FindValueByNumber) {
   EXPECT_EQ(foo_, enum_->FindValueByNumber(1));
   EXPECT_EQ(bar_, enum_->FindValueByNumber(2));
@@ -9036,6 +9069,52 @@ TEST_F(FeaturesTest, FieldFeaturesInherit) {
             pb::VALUE9);
 }
 
+TEST_F(FeaturesTest, FieldFeaturesShareMerges) {
+  BuildDescriptorMessagesInTestPool();
+  const FileDescriptor* file = BuildFile(R"pb(
+    name: "foo.proto"
+    syntax: "editions"
+    edition: EDITION_2023
+    message_type {
+      name: "Foo"
+      field {
+        name: "bar"
+        number: 1
+        label: LABEL_OPTIONAL
+        type: TYPE_INT64
+        options { features { field_presence: IMPLICIT } }
+      }
+      field {
+        name: "baz"
+        number: 2
+        label: LABEL_OPTIONAL
+        type: TYPE_INT64
+        options { features { field_presence: LEGACY_REQUIRED } }
+      }
+    }
+    message_type {
+      name: "Qux"
+      field {
+        name: "bar"
+        number: 1
+        label: LABEL_OPTIONAL
+        type: TYPE_INT64
+        options { features { field_presence: IMPLICIT } }
+      }
+    }
+  )pb");
+  const FieldDescriptor* foo_bar = file->message_type(0)->field(0);
+  const FieldDescriptor* foo_baz = file->message_type(0)->field(1);
+  const FieldDescriptor* qux_bar = file->message_type(1)->field(0);
+  EXPECT_EQ(GetFeatures(foo_bar).field_presence(), FeatureSet::IMPLICIT);
+  EXPECT_EQ(GetFeatures(foo_baz).field_presence(),
+            FeatureSet::LEGACY_REQUIRED);
+  // Fields with the same features under the same parent features share one
+  // merged instance.
+  EXPECT_EQ(&GetFeatures(foo_bar), &GetFeatures(qux_bar));
+  EXPECT_NE(&GetFeatures(foo_bar), &GetFeatures(foo_baz));
+}
+
 TEST_F(FeaturesTest, FieldFeaturesOverride) {
   BuildDescriptorMessagesInTestPool();
   BuildFileInTestPool(pb::TestFeatures::descriptor()->file());
@@ -12768,6 +12847,48 @@ TEST_F(ValidationErrorTest, PackageTooLong) {
       "aaaaaaaa: NAME: Package name is too long\n");
 }
 
+// ===================================================================
+// BuildFiles
+
+TEST(BuildFilesTest, BuildsInDependencyOrder) {
+  std::vector<FileDescriptorProto> files(3);
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      "name: 'baz.proto' dependency: 'bar.proto' dependency: 'foo.proto' "
+      "message_type { name: 'Baz' field { name: 'bar' number: 1 "
+      "  label: LABEL_OPTIONAL type_name: '.Bar' } }",
+      &files[0]));
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      "name: 'bar.proto' dependency: 'foo.proto' "
+      "message_type { name: 'Bar' field { name: 'foo' number: 1 "
+      "  label: LABEL_OPTIONAL type_name: '.Foo' } }",
+      &files[1]));
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      "name: 'foo.proto' message_type { name: 'Foo' }", &files[2]));
+
+  DescriptorPool pool;
+  std::vector<const FileDescriptor*> built = pool.BuildFiles(files);
+  ASSERT_EQ(built.size(), 3);
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(built[i] != nullptr);
+    EXPECT_EQ(built[i]->name(), files[i].name());
+  }
+  EXPECT_EQ(pool.FindMessageTypeByName("Baz")->field(0)->message_type(),
+            pool.FindMessageTypeByName("Bar"));
+}
+
+TEST(BuildFilesTest, FailsOnCycle) {
+  std::vector<FileDescriptorProto> files(2);
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      "name: 'foo.proto' dependency: 'bar.proto'", &files[0]));
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      "name: 'bar.proto' dependency: 'foo.proto'", &files[1]));
+
+  DescriptorPool pool;
+  MockErrorCollector error_collector;
+  EXPECT_TRUE(pool.BuildFilesCollectingErrors(files, &error_collector).empty());
+  EXPECT_THAT(error_collector.text_, testing::HasSubstr("bar.proto"));
+}
+
 
 // ===================================================================
 // DescriptorDatabase
@@ -13011,6 +13132,34 @@ TEST_F(DatabaseBackedPoolTest, FindAllExtensions) {
   }
 }
 
+TEST_F(DatabaseBackedPoolTest, FreezeStopsFallbackLookups) {
+  DescriptorPool pool(&database_);
+  const FileDescriptor* foo_file = pool.FindFileByName("foo.proto");
+  ASSERT_TRUE(foo_file != nullptr);
+  pool.Freeze();
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&] {
+      const Descriptor* foo = pool.FindMessageTypeByName("Foo");
+      ASSERT_TRUE(foo != nullptr);
+      EXPECT_EQ(foo->file(), foo_file);
+      EXPECT_EQ(pool.FindFileByName("foo.proto"), foo_file);
+      EXPECT_EQ(pool.FindFileContainingSymbol("TestEnum"), foo_file);
+      EXPECT_TRUE(pool.FindServiceByName("TestService") != nullptr);
+
+      // bar.proto was not built before freezing.
+      EXPECT_TRUE(pool.FindFileByName("bar.proto") == nullptr);
+      EXPECT_TRUE(pool.FindMessageTypeByName("Bar") == nullptr);
+      EXPECT_TRUE(pool.FindExtensionByNumber(foo, 5) == nullptr);
+      std::vector<const FieldDescriptor*> extensions;
+      pool.FindAllExtensions(foo, &extensions);
+      EXPECT_TRUE(extensions.empty());
+    });
+  }
+  for (auto& thread : threads) thread.join();
+}
+
 TEST_F(DatabaseBackedPoolTest, ErrorWithoutErrorCollector) {
   ErrorDescriptorDatabase error_database;
   DescriptorPool pool(&error_database);
@@ -6,9 +6,12 @@
 // https://developers.google.com/open-source/licenses/bsd
 
 #include <memory>
+#include <string>
 
 #include <gtest/gtest.h>
 #include "google/protobuf/dynamic_message.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 #include "google/protobuf/message_lite.h"
 #include "google/protobuf/unittest_drop_unknown_fields.pb.h"
 
@@ -56,5 +59,44 @@ TEST(DropUnknownFieldsTest, DynamicMessage) {
   EXPECT_EQ(2, foo_with_extra_fields.extra_int32_value());
 }
 
+TEST(DropUnknownFieldsTest, DiscardDuringParse) {
+  FooWithExtraFields foo_with_extra_fields;
+  foo_with_extra_fields.set_int32_value(1);
+  foo_with_extra_fields.set_enum_value(FooWithExtraFields::MOO);
+  foo_with_extra_fields.set_extra_int32_value(2);
+  const std::string data = foo_with_extra_fields.SerializeAsString();
+
+  DynamicMessageFactory factory;
+  Foo generated_foo;
+  std::unique_ptr<Message> dynamic_foo(
+      factory.GetPrototype(Foo::descriptor())->New());
+  for (Message* foo : {static_cast<Message*>(&generated_foo),
+                       dynamic_foo.get()}) {
+    SCOPED_TRACE(foo->GetTypeName());
+    {
+      // Flat input is parsed in place.
+      io::CodedInputStream input(
+          reinterpret_cast<const uint8_t*>(data.data()), data.size());
+      input.SetDiscardUnknownFields(true);
+      ASSERT_TRUE(foo->ParseFromCodedStream(&input));
+      EXPECT_TRUE(foo->GetReflection()->GetUnknownFields(*foo).empty());
+    }
+    {
+      io::ArrayInputStream array_input(data.data(), data.size(),
+                                       /*block_size=*/3);
+      io::CodedInputStream input(&array_input);
+      input.SetDiscardUnknownFields(true);
+      ASSERT_TRUE(foo->ParseFromCodedStream(&input));
+      EXPECT_TRUE(foo->GetReflection()->GetUnknownFields(*foo).empty());
+    }
+    FooWithExtraFields reparsed;
+    ASSERT_TRUE(reparsed.ParseFromString(foo->SerializeAsString()));
+    EXPECT_EQ(1, reparsed.int32_value());
+    EXPECT_EQ(FooWithExtraFields::MOO, reparsed.enum_value());
+    // The "extra_int32_value" field was dropped during the parse.
+    EXPECT_EQ(0, reparsed.extra_int32_value());
+  }
+}
+
 }  // namespace protobuf
 }  // namespace google
@@ -174,6 +174,9 @@ constexpr auto Duration::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(Duration),
                                             alignof(Duration));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Duration_reflection_data_;
+
 constexpr auto Duration::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -193,6 +196,7 @@ constexpr auto Duration::InternalGenerateClassData_() {
       },
       &Duration::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fduration_2eproto,
+      &Duration_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -313,6 +317,13 @@ PROTOBUF_NOINLINE void Duration::Clear() {
 ::size_t Duration::ByteSizeLong() const {
   const Duration& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t Duration::UncachedByteSizeLong() const {
+  const Duration& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.Duration)
   ::size_t total_size = 0;
 
@@ -338,8 +349,11 @@ PROTOBUF_NOINLINE void Duration::Clear() {
       }
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void Duration::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -355,6 +355,7 @@ struct DynamicMessageFactory::TypeInfo {
   std::unique_ptr<uint32_t[]> has_bits_indices;
   int weak_field_map_offset;  // The offset for the weak_field_map;
 
+  internal::ClassDataFull::ReflectionData reflection_data;
   internal::ClassDataFull class_data = {
       internal::ClassData{
           nullptr,  // default_instance
@@ -372,6 +373,7 @@ struct DynamicMessageFactory::TypeInfo {
       },
       &DynamicMessage::kDescriptorMethods,
       nullptr,  // descriptor_table
+      &reflection_data,
       nullptr,  // get_metadata_tracker
   };
 
@@ -379,9 +381,9 @@ struct DynamicMessageFactory::TypeInfo {
 
   ~TypeInfo() {
     delete class_data.prototype;
-    delete class_data.reflection;
+    delete reflection_data.reflection;
 
-    auto* type = class_data.descriptor;
+    auto* type = reflection_data.descriptor;
 
     // Scribble the payload to prevent unsanitized opt builds from silently
     // allowing use-after-free bugs where the factory is destroyed but the
@@ -434,7 +436,8 @@ inline void* DynamicMessage::MutableOneofCaseRaw(int i) {
 }
 inline void* DynamicMessage::MutableOneofFieldRaw(const FieldDescriptor* f) {
   return OffsetToPointer(
-      type_info_->offsets[type_info_->class_data.descriptor->field_count() +
+      type_info_->offsets[type_info_->reflection_data.descriptor
+                              ->field_count() +
                           f->containing_oneof()->index()]);
 }
 
@@ -448,7 +451,7 @@ void DynamicMessage::SharedCtor(bool lock_factory) {
   // in practice that's not strictly necessary for types that don't have a
   // constructor.)
 
-  const Descriptor* descriptor = type_info_->class_data.descriptor;
+  const Descriptor* descriptor = type_info_->reflection_data.descriptor;
   Arena* arena = GetArena();
   // Initialize oneof cases.
   int oneof_count = 0;
@@ -576,7 +579,7 @@ void DynamicMessage::operator delete(DynamicMessage* msg,
 #endif
 
 DynamicMessage::~DynamicMessage() {
-  const Descriptor* descriptor = type_info_->class_data.descriptor;
+  const Descriptor* descriptor = type_info_->reflection_data.descriptor;
 
   _internal_metadata_.Delete<UnknownFieldSet>();
 
@@ -697,7 +700,7 @@ void DynamicMessage::CrossLinkPrototypes() {
   ABSL_CHECK(is_prototype());
 
   DynamicMessageFactory* factory = type_info_->factory;
-  const Descriptor* descriptor = type_info_->class_data.descriptor;
+  const Descriptor* descriptor = type_info_->reflection_data.descriptor;
 
   // Cross-link default messages.
   for (int i = 0; i < descriptor->field_count(); i++) {
@@ -736,6 +739,21 @@ DynamicMessageFactory::~DynamicMessageFactory() {
 
 const Message* DynamicMessageFactory::GetPrototype(const Descriptor* type) {
   ABSL_CHECK(type != nullptr);
+  if (delegate_to_generated_factory_ &&
+      type->file()->pool() == DescriptorPool::generated_pool()) {
+    const Message* result = MessageFactory::TryGetGeneratedPrototype(type);
+    if (result != nullptr) return result;
+  }
+  {
+    // Fast path: the type was already built.  Types are built entirely under
+    // the writer lock below, so any entry found here is complete, and lookups
+    // of built types don't contend with each other.
+    absl::ReaderMutexLock lock(&prototypes_mutex_);
+    auto it = prototypes_.find(type);
+    if (it != prototypes_.end()) {
+      return static_cast<const Message*>(it->second->class_data.prototype);
+    }
+  }
   absl::MutexLock lock(&prototypes_mutex_);
   return GetPrototypeNoLock(type);
 }
@@ -758,7 +776,7 @@ const Message* DynamicMessageFactory::GetPrototypeNoLock(
   TypeInfo* type_info = new TypeInfo;
   *target = type_info;
 
-  type_info->class_data.descriptor = type;
+  type_info->reflection_data.descriptor = type;
   type_info->class_data.is_dynamic = true;
   type_info->pool = (pool_ == nullptr) ? type->file()->pool() : pool_;
   type_info->factory = this;
@@ -927,8 +945,8 @@ const Message* DynamicMessageFactory::GetPrototypeNoLock(
       -1,       // sizeof_split_
   };
 
-  type_info->class_data.reflection = new Reflection(
-      type_info->class_data.descriptor, schema, type_info->pool, this);
+  type_info->reflection_data.reflection = new Reflection(
+      type_info->reflection_data.descriptor, schema, type_info->pool, this);
 
   // Cross link prototypes.
   prototype->CrossLinkPrototypes();
@@ -22,12 +22,14 @@
 #include <cstddef>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "google/protobuf/descriptor.pb.h"
 #include <gtest/gtest.h>
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/test_util.h"
+#include "google/protobuf/unknown_field_set.h"
 #include "google/protobuf/unittest.pb.h"
 #include "google/protobuf/unittest_no_field_presence.pb.h"
 
@@ -336,6 +338,54 @@ TEST_F(DynamicMessageTest, Proto3) {
   delete message;
 }
 
+TEST_F(DynamicMessageTest, ConcurrentGetPrototype) {
+  const Descriptor* desc =
+      pool_.FindMessageTypeByName("proto2_unittest.TestRequired");
+  ASSERT_TRUE(desc != nullptr);
+  std::vector<const Message*> results(8);
+  std::vector<std::thread> threads;
+  for (auto& result : results) {
+    threads.emplace_back(
+        [this, desc, &result] { result = factory_.GetPrototype(desc); });
+  }
+  for (auto& thread : threads) thread.join();
+  for (const Message* result : results) {
+    EXPECT_EQ(result, results[0]);
+    EXPECT_EQ(result->GetDescriptor(), desc);
+  }
+}
+
+TEST_F(DynamicMessageTest, ParsesSparseClosedEnum) {
+  // The enum values are not a range, so the parser validates them with enum
+  // data built for the dynamic type.
+  const Descriptor* desc =
+      pool_.FindMessageTypeByName("proto2_unittest.SparseEnumMessage");
+  ASSERT_TRUE(desc != nullptr);
+  const FieldDescriptor* field = desc->FindFieldByName("sparse_enum");
+  ASSERT_TRUE(field != nullptr);
+
+  unittest::SparseEnumMessage valid;
+  valid.set_sparse_enum(unittest::SPARSE_E);
+  unittest::SparseEnumMessage other;
+  other.set_sparse_enum(unittest::SPARSE_A);
+  std::string data = valid.SerializeAsString();
+  // 5 is not a value of TestSparseEnum.
+  data += std::string("\x08\x05", 2);
+
+  std::unique_ptr<Message> message(factory_.GetPrototype(desc)->New());
+  ASSERT_TRUE(message->ParseFromString(data));
+  const Reflection* refl = message->GetReflection();
+  EXPECT_EQ(refl->GetEnumValue(*message, field), unittest::SPARSE_E);
+  const UnknownFieldSet& unknown_fields = refl->GetUnknownFields(*message);
+  ASSERT_EQ(unknown_fields.field_count(), 1);
+  EXPECT_EQ(unknown_fields.field(0).number(), 1);
+  EXPECT_EQ(unknown_fields.field(0).varint(), 5);
+
+  ASSERT_TRUE(message->ParseFromString(other.SerializeAsString()));
+  EXPECT_EQ(refl->GetEnumValue(*message, field), unittest::SPARSE_A);
+  EXPECT_EQ(refl->GetUnknownFields(*message).field_count(), 0);
+}
+
 INSTANTIATE_TEST_SUITE_P(UseArena, DynamicMessageTest, ::testing::Bool());
 
 
@@ -136,6 +136,9 @@ constexpr auto Empty::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(Empty),
                                             alignof(Empty));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Empty_reflection_data_;
+
 constexpr auto Empty::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -155,6 +158,7 @@ constexpr auto Empty::InternalGenerateClassData_() {
       },
       &Empty::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fempty_2eproto,
+      &Empty_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -90,30 +90,35 @@ struct ExtensionHasher {
 using ExtensionRegistry =
     absl::flat_hash_set<ExtensionInfo, ExtensionHasher, ExtensionEq>;
 
-static const ExtensionRegistry* global_registry = nullptr;
+// Lookups, which happen for every extension parsed, read the registry
+// without taking any lock.  The registry is published with release semantics
+// so that a thread that sees it also sees its contents.
+static std::atomic<const ExtensionRegistry*> global_registry{nullptr};
 
 // This function is only called at startup, so there is no need for thread-
 // safety.
 void Register(const ExtensionInfo& info) {
   static auto local_static_registry = OnShutdownDelete(new ExtensionRegistry);
-  global_registry = local_static_registry;
   if (!local_static_registry->insert(info).second) {
     ABSL_LOG(FATAL) << "Multiple extension registrations for type \""
                     << info.message->GetTypeName() << "\", field number "
                     << info.number << ".";
   }
+  global_registry.store(local_static_registry, std::memory_order_release);
 }
 
 const ExtensionInfo* FindRegisteredExtension(const MessageLite* extendee,
                                              int number) {
-  if (!global_registry) return nullptr;
+  const ExtensionRegistry* registry =
+      global_registry.load(std::memory_order_acquire);
+  if (registry == nullptr) return nullptr;
 
   ExtensionInfoKey info;
   info.message = extendee;
   info.number = number;
 
-  auto it = global_registry->find(info);
-  if (it == global_registry->end()) {
+  auto it = registry->find(info);
+  if (it == registry->end()) {
     return nullptr;
   } else {
     return &*it;
@@ -1315,6 +1320,9 @@ const char* ExtensionSet::ParseField(uint64_t tag, const char* ptr,
   ExtensionInfo extension;
   if (!FindExtensionInfoFromFieldNumber(tag & 7, number, &finder, &extension,
                                         &was_packed_on_wire)) {
+    if (ctx->data().discard_unknown_fields) {
+      return UnknownFieldParse(tag, nullptr, ptr, ctx);
+    }
     return UnknownFieldParse(
         tag, metadata->mutable_unknown_fields<std::string>(), ptr, ctx);
   }
@@ -1827,16 +1835,27 @@ const ExtensionSet::Extension* ExtensionSet::FindOrNull(int key) const {
   if (flat_size_ == 0) {
     return nullptr;
   } else if (ABSL_PREDICT_TRUE(!is_large())) {
-    for (auto it = flat_begin(), end = flat_end();
-         it != end && it->first <= key; ++it) {
-      if (it->first == key) return &it->second;
-    }
+    const KeyValue* it = FlatLowerBound(key);
+    if (it != flat_end() && it->first == key) return &it->second;
     return nullptr;
   } else {
     return FindOrNullInLargeMap(key);
   }
 }
 
+ExtensionSet::KeyValue* ExtensionSet::FlatLowerBound(int key) const {
+  ABSL_DCHECK(!is_large());
+  KeyValue* begin = map_.flat;
+  KeyValue* end = begin + flat_size_;
+  if (flat_size_ <= kMaximumLinearSearchSize) {
+    while (begin != end && begin->first < key) ++begin;
+    return begin;
+  }
+  return std::lower_bound(
+      begin, end, key,
+      [](const KeyValue& kv, int key) { return kv.first < key; });
+}
+
 const ExtensionSet::Extension* ExtensionSet::FindOrNullInLargeMap(
     int key) const {
   assert(is_large());
@@ -1872,15 +1891,12 @@ std::pair<ExtensionSet::Extension*, bool> ExtensionSet::Insert(int key) {
   }
   uint16_t i = flat_size_;
   KeyValue* flat = map_.flat;
-  // Iterating from the back to benefit the case where the keys are inserted in
-  // increasing order.
-  for (; i > 0; --i) {
-    int map_key = flat[i - 1].first;
-    if (map_key == key) {
-      return {&flat[i - 1].second, false};
-    }
-    if (map_key < key) {
-      break;
+  // Check the back first to benefit the case where the keys are inserted in
+  // increasing order, as when parsing: those are appended without a search.
+  if (i > 0 && flat[i - 1].first >= key) {
+    i = static_cast<uint16_t>(FlatLowerBound(key) - flat);
+    if (flat[i].first == key) {
+      return {&flat[i].second, false};
     }
   }
   if (flat_size_ == flat_capacity_) {
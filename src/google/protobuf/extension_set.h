@@ -835,6 +835,14 @@ class PROTOBUF_EXPORT ExtensionSet {
 
   static constexpr uint16_t kMaximumFlatCapacity = 256;
 
+  // Flat maps up to this size are searched linearly, which beats a binary
+  // search for the common handful of extensions; larger ones are searched
+  // by bisection.
+  static constexpr uint16_t kMaximumLinearSearchSize = 16;
+
+  // Returns the first element of the flat map with a key not less than |key|.
+  KeyValue* FlatLowerBound(int key) const;
+
   // Reserves capacity for the flat_capacity_ when the ExtensionSet is
   // IsCompletelyEmpty.
   // minimum_new_capacity must be <= kMaximumFlatCapacity.
@@ -328,6 +328,10 @@ const char* ExtensionSet::ParseField(uint64_t tag, const char* ptr,
   ExtensionInfo extension;
   if (!FindExtension(tag & 7, number, extendee, ctx, &extension,
                      &was_packed_on_wire)) {
+    if (ctx->data().discard_unknown_fields) {
+      return UnknownFieldParse(tag, static_cast<std::string*>(nullptr), ptr,
+                               ctx);
+    }
     return UnknownFieldParse(
         tag, metadata->mutable_unknown_fields<UnknownFieldSet>(), ptr, ctx);
   }
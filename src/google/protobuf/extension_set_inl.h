@@ -231,15 +231,17 @@ const char* ExtensionSet::ParseMessageSetItemTmpl(
         GOOGLE_PROTOBUF_PARSER_ASSERT(ptr != nullptr);
         state = State::kDone;
       } else {
-        std::string tmp;
         int32_t size = ReadSize(&ptr);
         GOOGLE_PROTOBUF_PARSER_ASSERT(ptr);
-        ptr = ctx->ReadString(ptr, size, &tmp);
-        GOOGLE_PROTOBUF_PARSER_ASSERT(ptr);
         if (state == State::kNoTag) {
-          payload = std::move(tmp);
+          // The type_id comes later; buffer the payload until then.
+          ptr = ctx->ReadString(ptr, size, &payload);
           state = State::kHasPayload;
+        } else {
+          // Only the first payload counts, so don't copy the others.
+          ptr = ctx->Skip(ptr, size);
         }
+        GOOGLE_PROTOBUF_PARSER_ASSERT(ptr);
       }
     } else {
       ptr = ReadTag(ptr - 1, &tag);
@@ -89,6 +89,30 @@ TEST(ExtensionSetTest, Accessors) {
   TestUtil::ExpectRepeatedExtensionsModified(message);
 }
 
+TEST(ExtensionSetTest, ManyExtensionsInAnyOrder) {
+  // Enough extensions that lookups bisect the flat map instead of scanning
+  // it, inserted in decreasing and then increasing order of field number.
+  constexpr int kCount = 100;
+  ExtensionSet set;
+  for (int number = kCount; number > 0; number -= 2) {
+    set.SetInt32(number, WireFormatLite::TYPE_INT32, number, nullptr);
+  }
+  for (int number = 1; number < kCount; number += 2) {
+    set.SetInt32(number, WireFormatLite::TYPE_INT32, number, nullptr);
+  }
+  EXPECT_EQ(set.NumExtensions(), kCount);
+  for (int number = 1; number <= kCount; ++number) {
+    ASSERT_TRUE(set.Has(number));
+    EXPECT_EQ(set.GetInt32(number, 0), number);
+  }
+  EXPECT_FALSE(set.Has(0));
+  EXPECT_FALSE(set.Has(kCount + 1));
+
+  set.ClearExtension(kCount / 2);
+  EXPECT_FALSE(set.Has(kCount / 2));
+  EXPECT_TRUE(set.Has(kCount / 2 + 1));
+}
+
 TEST(ExtensionSetTest, Clear) {
   // Set every field to a unique value, clear the message, then check that
   // it is cleared.
@@ -145,7 +145,16 @@ struct NoOpAccessListener {
 }  // namespace protobuf
 }  // namespace google
 
-#ifndef REPLACE_PROTO_LISTENER_IMPL
+#if defined(PROTOBUF_SAMPLED_FIELD_ACCESS)
+#include "google/protobuf/sampled_access_listener.h"
+
+namespace google {
+namespace protobuf {
+template <class T>
+using AccessListener = internal::SampledAccessListener<T>;
+}  // namespace protobuf
+}  // namespace google
+#elif !defined(REPLACE_PROTO_LISTENER_IMPL)
 namespace google {
 namespace protobuf {
 template <class T>
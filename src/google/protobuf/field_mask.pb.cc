@@ -185,6 +185,9 @@ constexpr auto FieldMask::InternalNewImpl_() {
                                  alignof(FieldMask));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    FieldMask_reflection_data_;
+
 constexpr auto FieldMask::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -204,6 +207,7 @@ constexpr auto FieldMask::InternalGenerateClassData_() {
       },
       &FieldMask::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2ffield_5fmask_2eproto,
+      &FieldMask_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -54,8 +54,47 @@ bool LookUpEnumValue(const EnumEntry* enums, size_t size,
   return false;
 }
 
+std::vector<int> GenerateEnumNameTable(
+    absl::Span<const absl::string_view> names) {
+  size_t size = 2;
+  while (size < 2 * names.size()) size *= 2;
+  std::vector<int> table(size, -1);
+  const size_t mask = size - 1;
+  for (size_t i = 0; i < names.size(); ++i) {
+    size_t slot = EnumNameHash(names[i]) & mask;
+    while (table[slot] != -1) slot = (slot + 1) & mask;
+    table[slot] = static_cast<int>(i);
+  }
+  return table;
+}
+
+bool LookUpEnumValue(const EnumEntry* enums, const int* name_table,
+                     size_t name_table_size, absl::string_view name,
+                     int* value) {
+  const size_t mask = name_table_size - 1;
+  // The table is never full, so every probe sequence ends at an empty slot.
+  for (size_t slot = EnumNameHash(name) & mask;; slot = (slot + 1) & mask) {
+    const int index = name_table[slot];
+    if (index == -1) return false;
+    if (enums[index].name == name) {
+      *value = enums[index].value;
+      return true;
+    }
+  }
+}
+
 int LookUpEnumName(const EnumEntry* enums, const int* sorted_indices,
                    size_t size, int value) {
+  // The values are unique and sorted, so the one at position i is at least
+  // i more than the smallest.  For dense enums that makes the sought value's
+  // position its offset from the smallest.
+  if (size > 0) {
+    const uint64_t offset = static_cast<uint64_t>(
+        static_cast<int64_t>(value) - enums[sorted_indices[0]].value);
+    if (offset < size && enums[sorted_indices[offset]].value == value) {
+      return static_cast<int>(offset);
+    }
+  }
   auto comparator = [enums, value](int a, int b) {
     return GetValue(enums, a, value) < GetValue(enums, b, value);
   };
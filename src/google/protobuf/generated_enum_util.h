@@ -48,6 +48,31 @@ struct EnumEntry {
 PROTOBUF_EXPORT bool LookUpEnumValue(const EnumEntry* enums, size_t size,
                                      absl::string_view name, int* value);
 
+// Hashes an enum name for the tables built by GenerateEnumNameTable().  The
+// tables are stored in generated code, so this function must never change.
+constexpr uint32_t EnumNameHash(absl::string_view name) {
+  // 32-bit FNV-1a.
+  uint32_t hash = 2166136261u;
+  for (char c : name) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+  }
+  return hash;
+}
+
+// Builds an open-addressed hash table over the names of |enums|, for
+// LookUpEnumValue() below.  Each slot holds an index into |enums|, or -1 if it
+// is empty.  The size of the table is a power of two at least twice the number
+// of names, so that probe sequences stay short.
+PROTOBUF_EXPORT std::vector<int> GenerateEnumNameTable(
+    absl::Span<const absl::string_view> names);
+
+// Looks up a numeric enum value given the string name, using a table built by
+// GenerateEnumNameTable() over |enums|.
+PROTOBUF_EXPORT bool LookUpEnumValue(const EnumEntry* enums,
+                                     const int* name_table,
+                                     size_t name_table_size,
+                                     absl::string_view name, int* value);
+
 // Looks up an enum name given the numeric value.
 PROTOBUF_EXPORT int LookUpEnumName(const EnumEntry* enums,
                                    const int* sorted_indices, size_t size,
@@ -347,7 +347,61 @@ TEST(ValidateEnumTest, GenerateEnumDataWithOverflowOnBoth) {
   TestRoundTrip(values, __LINE__);
 }
 
+TEST(LookUpEnumTest, NameTableFindsEveryName) {
+  // Sorted by name, as in generated code.
+  std::vector<std::string> storage;
+  for (int i = 0; i < 1000; ++i) storage.push_back(absl::StrFormat("V%04d", i));
+  std::vector<EnumEntry> enums;
+  std::vector<absl::string_view> names;
+  for (int i = 0; i < 1000; ++i) {
+    enums.push_back({storage[i], 3 * i});
+    names.push_back(storage[i]);
+  }
+  const std::vector<int> table = GenerateEnumNameTable(names);
+  EXPECT_GE(table.size(), 2 * names.size());
+  EXPECT_EQ(table.size() & (table.size() - 1), 0);
+
+  for (int i = 0; i < 1000; ++i) {
+    int value = -1;
+    EXPECT_TRUE(LookUpEnumValue(enums.data(), table.data(), table.size(),
+                                storage[i], &value));
+    EXPECT_EQ(value, 3 * i);
+  }
+  int value = -1;
+  EXPECT_FALSE(LookUpEnumValue(enums.data(), table.data(), table.size(),
+                               "V1000", &value));
+  EXPECT_FALSE(
+      LookUpEnumValue(enums.data(), table.data(), table.size(), "", &value));
+  EXPECT_EQ(value, -1);
+}
 
+TEST(LookUpEnumTest, NameTableOfOneName) {
+  const EnumEntry enums[] = {{"ONLY", 7}};
+  const absl::string_view names[] = {"ONLY"};
+  const std::vector<int> table = GenerateEnumNameTable(names);
+  int value;
+  EXPECT_TRUE(LookUpEnumValue(enums, table.data(), table.size(), "ONLY",
+                              &value));
+  EXPECT_EQ(value, 7);
+  EXPECT_FALSE(LookUpEnumValue(enums, table.data(), table.size(), "OTHER",
+                               &value));
+}
+
+TEST(LookUpEnumTest, NameOfDenseAndSparseValues) {
+  // Sorted by name: A=2, B=-1, C=0, D=1, E=100.
+  const EnumEntry enums[] = {{"A", 2}, {"B", -1}, {"C", 0}, {"D", 1},
+                             {"E", 100}};
+  // Sorted by value.
+  const int sorted_indices[] = {1, 2, 3, 0, 4};
+  EXPECT_EQ(LookUpEnumName(enums, sorted_indices, 5, -1), 0);
+  EXPECT_EQ(LookUpEnumName(enums, sorted_indices, 5, 2), 3);
+  EXPECT_EQ(LookUpEnumName(enums, sorted_indices, 5, 100), 4);
+  EXPECT_EQ(LookUpEnumName(enums, sorted_indices, 5, 3), -1);
+  EXPECT_EQ(LookUpEnumName(enums, sorted_indices, 5, -2), -1);
+  EXPECT_EQ(LookUpEnumName(enums, sorted_indices, 5,
+                           std::numeric_limits<int>::min()),
+            -1);
+}
 
 }  // namespace
 }  // namespace internal
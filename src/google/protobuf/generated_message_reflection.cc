@@ -32,11 +32,13 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/descriptor.pb.h"
 #include "google/protobuf/descriptor_lite.h"
 #include "google/protobuf/extension_set.h"
+#include "google/protobuf/generated_enum_util.h"
 #include "google/protobuf/generated_message_tctable_decl.h"
 #include "google/protobuf/generated_message_tctable_gen.h"
 #include "google/protobuf/generated_message_tctable_impl.h"
@@ -75,6 +77,14 @@ using google::protobuf::internal::RepeatedPtrFieldBase;
 using google::protobuf::internal::StringSpaceUsedExcludingSelfLong;
 using google::protobuf::internal::cpp::IsLazilyInitializedFile;
 
+#ifdef PROTOBUF_DESCRIPTOR_TABLE_SECTION
+// Provided by the linker, see PROTOBUF_DESCRIPTOR_TABLE_SECTION.
+extern "C" {
+extern const DescriptorTable* const __start_protobuf_descriptor_tables;
+extern const DescriptorTable* const __stop_protobuf_descriptor_tables;
+}
+#endif  // PROTOBUF_DESCRIPTOR_TABLE_SECTION
+
 namespace google {
 namespace protobuf {
 
@@ -538,6 +548,194 @@ size_t Reflection::SpaceUsedLong(const Message& message) const {
 
 namespace {
 
+// Returns the heap capacity of `str` beyond its size.
+size_t StringSlackBytes(const std::string& str) {
+  if (StringSpaceUsedExcludingSelfLong(str) == 0) return 0;
+  return str.capacity() - str.size();
+}
+
+template <typename T>
+size_t RepeatedFieldSlackBytes(const RepeatedField<T>& repeated) {
+  // Elements stored inside the field itself are not counted as used.
+  if (repeated.SpaceUsedExcludingSelfLong() == 0) return 0;
+  return static_cast<size_t>(repeated.Capacity() - repeated.size()) * sizeof(T);
+}
+
+}  // namespace
+
+MessageSpaceUsage Reflection::SpaceUsedBreakdown(const Message& message) const {
+  STATIC_USAGE_CHECK_MESSAGE(SpaceUsedBreakdown, &message);
+  // This follows SpaceUsedLong() closely, so that the two agree.
+  MessageSpaceUsage usage;
+  usage.object_bytes = schema_.GetObjectSize();
+  usage.unknown_fields_bytes =
+      GetUnknownFields(message).SpaceUsedExcludingSelfLong();
+  if (schema_.HasExtensionSet()) {
+    usage.extensions_bytes =
+        GetExtensionSet(message).SpaceUsedExcludingSelfLong();
+  }
+  usage.total_bytes =
+      usage.object_bytes + usage.unknown_fields_bytes + usage.extensions_bytes;
+
+  for (int i = 0; i <= last_non_weak_field_index_; i++) {
+    const FieldDescriptor* field = descriptor_->field(i);
+    size_t used = 0;
+    size_t repeated_slack = 0;
+    size_t string_slack = 0;
+    size_t map_overhead = 0;
+    // Submessages are accounted to the field that holds them.
+    const auto add_submessage = [&](const MessageSpaceUsage& sub) {
+      used += sub.total_bytes;
+      repeated_slack += sub.repeated_slack_bytes;
+      string_slack += sub.string_slack_bytes;
+      map_overhead += sub.map_overhead_bytes;
+    };
+
+    if (field->is_repeated()) {
+      switch (field->cpp_type()) {
+#define HANDLE_TYPE(UPPERCASE, LOWERCASE)                                     \
+  case FieldDescriptor::CPPTYPE_##UPPERCASE: {                                \
+    const auto& repeated = GetRaw<RepeatedField<LOWERCASE> >(message, field); \
+    used = repeated.SpaceUsedExcludingSelfLong();                             \
+    repeated_slack = RepeatedFieldSlackBytes(repeated);                       \
+    break;                                                                    \
+  }
+
+        HANDLE_TYPE(INT32, int32_t);
+        HANDLE_TYPE(INT64, int64_t);
+        HANDLE_TYPE(UINT32, uint32_t);
+        HANDLE_TYPE(UINT64, uint64_t);
+        HANDLE_TYPE(DOUBLE, double);
+        HANDLE_TYPE(FLOAT, float);
+        HANDLE_TYPE(BOOL, bool);
+        HANDLE_TYPE(ENUM, int);
+#undef HANDLE_TYPE
+
+        case FieldDescriptor::CPPTYPE_STRING:
+        case FieldDescriptor::CPPTYPE_MESSAGE: {
+          const bool is_string =
+              field->cpp_type() == FieldDescriptor::CPPTYPE_STRING;
+          if (is_string && field->cpp_string_type() ==
+                               FieldDescriptor::CppStringType::kCord) {
+            const auto& repeated =
+                GetRaw<RepeatedField<absl::Cord>>(message, field);
+            used = repeated.SpaceUsedExcludingSelfLong();
+            repeated_slack = RepeatedFieldSlackBytes(repeated);
+            break;
+          }
+          if (IsMapFieldInApi(field)) {
+            const auto& map = GetRaw<MapFieldBase>(message, field);
+            used = map.SpaceUsedExcludingSelfLong();
+            map_overhead = map.GetMap().TableSpaceUsedLong();
+            break;
+          }
+          const auto& repeated = GetRaw<RepeatedPtrFieldBase>(message, field);
+          if (!repeated.using_sso()) {
+            used = static_cast<size_t>(repeated.Capacity()) * sizeof(void*) +
+                   RepeatedPtrFieldBase::kRepHeaderSize;
+            repeated_slack =
+                static_cast<size_t>(repeated.Capacity() - repeated.size()) *
+                sizeof(void*);
+          }
+          const int n = repeated.allocated_size();
+          void* const* elems = repeated.elements();
+          for (int j = 0; j < n; ++j) {
+            const size_t before = used;
+            if (is_string) {
+              const auto& str = *static_cast<const std::string*>(elems[j]);
+              used += sizeof(std::string) +
+                      StringSpaceUsedExcludingSelfLong(str);
+              if (j < repeated.size()) string_slack += StringSlackBytes(str);
+            } else if (j < repeated.size()) {
+              const Message& sub = *RepeatedPtrFieldBase::cast<
+                  GenericTypeHandler<Message>>(elems[j]);
+              add_submessage(sub.SpaceUsedBreakdown());
+            } else {
+              used += RepeatedPtrFieldBase::cast<GenericTypeHandler<Message>>(
+                          elems[j])
+                          ->SpaceUsedLong();
+            }
+            // Cleared elements are kept for reuse, so all of their space is
+            // slack.
+            if (j >= repeated.size()) repeated_slack += used - before;
+          }
+          break;
+        }
+      }
+    } else {
+      if (schema_.InRealOneof(field) && !HasOneofField(message, field)) {
+        continue;
+      }
+      switch (field->cpp_type()) {
+        case FieldDescriptor::CPPTYPE_INT32:
+        case FieldDescriptor::CPPTYPE_INT64:
+        case FieldDescriptor::CPPTYPE_UINT32:
+        case FieldDescriptor::CPPTYPE_UINT64:
+        case FieldDescriptor::CPPTYPE_DOUBLE:
+        case FieldDescriptor::CPPTYPE_FLOAT:
+        case FieldDescriptor::CPPTYPE_BOOL:
+        case FieldDescriptor::CPPTYPE_ENUM:
+          // Field is inline, so it is part of the object.
+          break;
+
+        case FieldDescriptor::CPPTYPE_STRING: {
+          switch (field->cpp_string_type()) {
+            case FieldDescriptor::CppStringType::kCord:
+              if (schema_.InRealOneof(field)) {
+                used = GetField<absl::Cord*>(message, field)
+                           ->EstimatedMemoryUsage();
+              } else {
+                used = GetField<absl::Cord>(message, field)
+                           .EstimatedMemoryUsage() -
+                       sizeof(absl::Cord);
+              }
+              break;
+            case FieldDescriptor::CppStringType::kView:
+            case FieldDescriptor::CppStringType::kString:
+              if (IsInlined(field)) {
+                const std::string& str =
+                    GetField<InlinedStringField>(message, field).GetNoArena();
+                used = StringSpaceUsedExcludingSelfLong(str);
+                string_slack = StringSlackBytes(str);
+              } else {
+                // Strings still pointing to the default value use no memory
+                // of their own, see SpaceUsedLong().
+                const auto& str = GetField<ArenaStringPtr>(message, field);
+                if (!str.IsDefault() || schema_.InRealOneof(field)) {
+                  used = sizeof(std::string) +
+                         StringSpaceUsedExcludingSelfLong(str.Get());
+                  string_slack = StringSlackBytes(str.Get());
+                }
+              }
+              break;
+          }
+          break;
+        }
+
+        case FieldDescriptor::CPPTYPE_MESSAGE:
+          if (!schema_.IsDefaultInstance(message)) {
+            const Message* sub_message = GetRaw<const Message*>(message, field);
+            if (sub_message != nullptr) {
+              add_submessage(sub_message->SpaceUsedBreakdown());
+            }
+          }
+          break;
+      }
+    }
+
+    if (used == 0) continue;
+    usage.total_bytes += used;
+    usage.repeated_slack_bytes += repeated_slack;
+    usage.string_slack_bytes += string_slack;
+    usage.map_overhead_bytes += map_overhead;
+    usage.fields.push_back(
+        {field, used, repeated_slack + string_slack + map_overhead});
+  }
+  return usage;
+}
+
+namespace {
+
 template <bool unsafe_shallow_swap>
 struct OneofFieldMover {
   template <typename FromType, typename ToType>
@@ -3261,6 +3459,14 @@ void Reflection::ClearOneof(Message* message,
       Message * message, const FieldDescriptor* field) const {             \
     return static_cast<RepeatedField<TYPE>*>(                              \
         MutableRawRepeatedField(message, field, CPPTYPE, CTYPE, nullptr)); \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  absl::Span<const TYPE> Reflection::GetRepeatedFieldSpan<TYPE>(           \
+      const Message& message, const FieldDescriptor* field) const {        \
+    const RepeatedField<TYPE>& repeated =                                  \
+        GetRepeatedFieldInternal<TYPE>(message, field);                    \
+    return absl::MakeConstSpan(repeated.data(), repeated.size());          \
   }
 
 HANDLE_TYPE(int32_t, FieldDescriptor::CPPTYPE_INT32, -1);
@@ -3485,28 +3691,18 @@ void Reflection::PopulateTcParseEntries(
     TcParseTableBase::FieldEntry* entries) const {
   for (const auto& entry : table_info.field_entries) {
     const FieldDescriptor* field = entry.field;
-    if (field->type() == field->TYPE_ENUM &&
-        (entry.type_card & internal::field_layout::kTvMask) ==
-            internal::field_layout::kTvEnum &&
-        table_info.aux_entries[entry.aux_idx].type ==
-            internal::TailCallTableInfo::kEnumValidator) {
-      // Mini parse can't handle it. Fallback to reflection.
-      *entries = {};
-      table_info.aux_entries[entry.aux_idx] = {};
+    const OneofDescriptor* oneof = field->real_containing_oneof();
+    entries->offset = schema_.GetFieldOffset(field);
+    if (oneof != nullptr) {
+      entries->has_idx = schema_.oneof_case_offset_ + 4 * oneof->index();
+    } else if (schema_.HasHasbits()) {
+      entries->has_idx =
+          static_cast<int>(8 * schema_.HasBitsOffset() + entry.hasbit_idx);
     } else {
-      const OneofDescriptor* oneof = field->real_containing_oneof();
-      entries->offset = schema_.GetFieldOffset(field);
-      if (oneof != nullptr) {
-        entries->has_idx = schema_.oneof_case_offset_ + 4 * oneof->index();
-      } else if (schema_.HasHasbits()) {
-        entries->has_idx =
-            static_cast<int>(8 * schema_.HasBitsOffset() + entry.hasbit_idx);
-      } else {
-        entries->has_idx = 0;
-      }
-      entries->aux_idx = entry.aux_idx;
-      entries->type_card = entry.type_card;
+      entries->has_idx = 0;
     }
+    entries->aux_idx = entry.aux_idx;
+    entries->type_card = entry.type_card;
 
     ++entries;
   }
@@ -3553,7 +3749,8 @@ void Reflection::PopulateTcParseFieldAux(
                                    aux_entry.enum_range.size};
         break;
       case internal::TailCallTableInfo::kEnumValidator:
-        ABSL_LOG(FATAL) << "Not supported.";
+        // Points into the table itself, see CreateTcParseTable().
+        *field_aux++ = {};
         break;
       case internal::TailCallTableInfo::kNumericOffset:
         field_aux++->offset = aux_entry.offset;
@@ -3601,6 +3798,27 @@ const internal::TcParseTableBase* Reflection::CreateTcParseTable() const {
       },
       fields);
 
+  // Closed enums whose values are not a contiguous range are validated with
+  // the same data that generated code emits as `Enum_internal_data_`.  It is
+  // stored after the name data.
+  std::vector<std::vector<uint32_t>> enum_data;
+  size_t enum_data_size = 0;
+  for (const auto& aux_entry : table_info.aux_entries) {
+    if (aux_entry.type != internal::TailCallTableInfo::kEnumValidator) {
+      continue;
+    }
+    const EnumDescriptor* enum_type = aux_entry.field->enum_type();
+    std::vector<int32_t> values;
+    values.reserve(enum_type->value_count());
+    for (int i = 0; i < enum_type->value_count(); ++i) {
+      values.push_back(enum_type->value(i)->number());
+    }
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    enum_data.push_back(internal::GenerateEnumData(values));
+    enum_data_size += enum_data.back().size();
+  }
+
   const size_t fast_entries_count = table_info.fast_path_fields.size();
   ABSL_CHECK_EQ(static_cast<int>(fast_entries_count),
                 1 << table_info.table_size_log2);
@@ -3614,10 +3832,12 @@ const internal::TcParseTableBase* Reflection::CreateTcParseTable() const {
       field_entry_offset +
       sizeof(TcParseTableBase::FieldEntry) * fields.size());
 
-  int byte_size =
+  const uint32_t enum_data_offset = AlignTo<uint32_t>(
       aux_offset +
       sizeof(TcParseTableBase::FieldAux) * table_info.aux_entries.size() +
-      sizeof(char) * table_info.field_name_data.size();
+      sizeof(char) * table_info.field_name_data.size());
+
+  int byte_size = enum_data_offset + sizeof(uint32_t) * enum_data_size;
 
   void* p = ::operator new(byte_size);
   auto* res = ::new (p) TcParseTableBase{
@@ -3663,7 +3883,26 @@ const internal::TcParseTableBase* Reflection::CreateTcParseTable() const {
            table_info.field_name_data.size());
   }
   // Validation to make sure we used all the bytes correctly.
-  ABSL_CHECK_EQ(res->name_data() + table_info.field_name_data.size() -
+  ABSL_CHECK_EQ(AlignTo<uint32_t>(static_cast<uint32_t>(
+                    res->name_data() + table_info.field_name_data.size() -
+                    reinterpret_cast<char*>(res))),
+                enum_data_offset);
+
+  // Copy the enum data and point the validators at it.
+  auto* enum_data_out = reinterpret_cast<uint32_t*>(
+      reinterpret_cast<char*>(res) + enum_data_offset);
+  auto next_enum_data = enum_data.begin();
+  for (size_t i = 0; i < table_info.aux_entries.size(); ++i) {
+    if (table_info.aux_entries[i].type !=
+        internal::TailCallTableInfo::kEnumValidator) {
+      continue;
+    }
+    res->field_aux(static_cast<uint32_t>(i))->enum_data = enum_data_out;
+    enum_data_out =
+        std::copy(next_enum_data->begin(), next_enum_data->end(), enum_data_out);
+    ++next_enum_data;
+  }
+  ABSL_CHECK_EQ(reinterpret_cast<char*>(enum_data_out) -
                     reinterpret_cast<char*>(res),
                 byte_size);
 
@@ -3726,9 +3965,10 @@ class AssignDescriptorsHelper {
       // If there is no descriptor_table in the class data, then it is not
       // interested in receiving reflection information either.
       if (class_data.descriptor_table != nullptr) {
-        class_data.descriptor = descriptor;
+        auto& reflection_data = *class_data.reflection_data;
+        reflection_data.descriptor = descriptor;
 
-        class_data.reflection = OnShutdownDelete(new Reflection(
+        reflection_data.reflection = OnShutdownDelete(new Reflection(
             descriptor,
             MigrationToReflectionSchema(default_instance_data_, offsets_,
                                         *schemas_),
@@ -3757,15 +3997,24 @@ class AssignDescriptorsHelper {
 
 namespace {
 
+// Serializes the calls to AddDescriptors() that happen after static
+// initialization.
+PROTOBUF_CONSTINIT absl::Mutex add_descriptors_mutex(absl::kConstInit);
+
+#ifdef PROTOBUF_DESCRIPTOR_TABLE_SECTION
+// Keeps the section, and so its start and stop symbols, defined even when no
+// linked file uses it.
+PROTOBUF_DESCRIPTOR_TABLE_SECTION const DescriptorTable* const
+    kNoDescriptorTable = nullptr;
+#endif  // PROTOBUF_DESCRIPTOR_TABLE_SECTION
+
 void AssignDescriptorsImpl(const DescriptorTable* table, bool eager) {
   // Ensure the file descriptor is added to the pool.
   {
     // This only happens once per proto file. So a global mutex to serialize
     // calls to AddDescriptors.
-    static absl::Mutex mu{absl::kConstInit};
-    mu.Lock();
+    absl::MutexLock lock(&add_descriptors_mutex);
     AddDescriptors(table);
-    mu.Unlock();
   }
   if (eager) {
     // Normally we do not want to eagerly build descriptors of our deps.
@@ -3865,6 +4114,21 @@ void AssignDescriptors(const DescriptorTable* table) {
   absl::call_once(*table->once, [=] { AssignDescriptorsOnceInnerCall(table); });
 }
 
+void AddDescriptorsFromLinkerSection() {
+#ifdef PROTOBUF_DESCRIPTOR_TABLE_SECTION
+  static const bool registered = [] {
+    absl::MutexLock lock(&add_descriptors_mutex);
+    for (const DescriptorTable* const* it =
+             &__start_protobuf_descriptor_tables;
+         it < &__stop_protobuf_descriptor_tables; ++it) {
+      if (*it != nullptr) AddDescriptors(*it);
+    }
+    return true;
+  }();
+  (void)registered;
+#endif  // PROTOBUF_DESCRIPTOR_TABLE_SECTION
+}
+
 AddDescriptorsRunner::AddDescriptorsRunner(const DescriptorTable* table) {
   AddDescriptors(table);
 }
@@ -339,6 +339,12 @@ PROTOBUF_EXPORT void InitializeFileDescriptorDefaultInstances();
 
 PROTOBUF_EXPORT void AddDescriptors(const DescriptorTable* table);
 
+// Registers the files of code generated with `lazy_descriptor_registration`,
+// whose descriptor tables are collected in a linker section instead of being
+// registered by static initializers.  Runs once, on first use of the generated
+// pool.
+PROTOBUF_EXPORT void AddDescriptorsFromLinkerSection();
+
 struct PROTOBUF_EXPORT AddDescriptorsRunner {
   explicit AddDescriptorsRunner(const DescriptorTable* table);
 };
@@ -262,6 +262,96 @@ TEST(GeneratedMessageReflectionTest, GetRepeatedStringViewWithExtensions) {
             reflection->GetRepeatedStringView(message, cord_ext, 0, scratch));
 }
 
+// Returns the breakdown entry of `field`, or nullptr if it has none.
+const MessageSpaceUsage::Field* FindFieldUsage(const MessageSpaceUsage& usage,
+                                               const FieldDescriptor* field) {
+  for (const auto& entry : usage.fields) {
+    if (entry.field == field) return &entry;
+  }
+  return nullptr;
+}
+
+TEST(GeneratedMessageReflectionTest, SpaceUsedBreakdownMatchesSpaceUsedLong) {
+  unittest::TestAllTypes message;
+  EXPECT_EQ(message.SpaceUsedBreakdown().object_bytes, sizeof(message));
+  EXPECT_THAT(message.SpaceUsedBreakdown().fields, testing::IsEmpty());
+
+  TestUtil::SetAllFields(&message);
+  const MessageSpaceUsage usage = message.SpaceUsedBreakdown();
+  if (!internal::DebugHardenFuzzMessageSpaceUsedLong()) {
+    EXPECT_EQ(usage.total_bytes, message.SpaceUsedLong());
+  }
+  size_t total = usage.object_bytes + usage.unknown_fields_bytes +
+                 usage.extensions_bytes;
+  size_t wasted = 0;
+  for (const auto& entry : usage.fields) {
+    EXPECT_LE(entry.bytes_wasted, entry.bytes_used) << entry.field->name();
+    total += entry.bytes_used;
+    wasted += entry.bytes_wasted;
+  }
+  EXPECT_EQ(total, usage.total_bytes);
+  EXPECT_EQ(wasted, usage.wasted_bytes());
+  EXPECT_NE(FindFieldUsage(usage, F("repeated_int32")), nullptr);
+  EXPECT_EQ(FindFieldUsage(usage, F("optional_int32")), nullptr);
+}
+
+TEST(GeneratedMessageReflectionTest, SpaceUsedBreakdownRepeatedSlack) {
+  unittest::TestAllTypes message;
+  message.add_repeated_int32(1);
+  message.mutable_repeated_int32()->Reserve(100);
+  const MessageSpaceUsage usage = message.SpaceUsedBreakdown();
+  const auto* entry = FindFieldUsage(usage, F("repeated_int32"));
+  ASSERT_NE(entry, nullptr);
+  EXPECT_GE(entry->bytes_wasted, 99 * sizeof(int32_t));
+  EXPECT_EQ(usage.repeated_slack_bytes, entry->bytes_wasted);
+
+  // Cleared elements are kept around, and are slack as a whole.
+  message.add_repeated_string(std::string(100, 'x'));
+  message.add_repeated_string(std::string(100, 'y'));
+  message.clear_repeated_string();
+  const auto* cleared = FindFieldUsage(message.SpaceUsedBreakdown(),
+                                       F("repeated_string"));
+  ASSERT_NE(cleared, nullptr);
+  EXPECT_EQ(cleared->bytes_wasted, cleared->bytes_used);
+}
+
+TEST(GeneratedMessageReflectionTest, SpaceUsedBreakdownStringSlack) {
+  unittest::TestAllTypes message;
+  message.mutable_optional_string()->assign(100, 'x');
+  message.mutable_optional_string()->resize(1);
+  const MessageSpaceUsage usage = message.SpaceUsedBreakdown();
+  EXPECT_GE(usage.string_slack_bytes, size_t{99});
+  const auto* entry = FindFieldUsage(usage, F("optional_string"));
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->bytes_wasted, usage.string_slack_bytes);
+}
+
+TEST(GeneratedMessageReflectionTest, SpaceUsedBreakdownMapOverhead) {
+  unittest::TestMap message;
+  (*message.mutable_map_int32_int32())[1] = 1;
+  const MessageSpaceUsage usage = message.SpaceUsedBreakdown();
+  EXPECT_GT(usage.map_overhead_bytes, size_t{0});
+  EXPECT_EQ(usage.repeated_slack_bytes, size_t{0});
+  EXPECT_EQ(usage.string_slack_bytes, size_t{0});
+}
+
+TEST(GeneratedMessageReflectionTest, SpaceUsedBreakdownIncludesSubmessages) {
+  unittest::NestedTestAllTypes message;
+  message.mutable_child()->mutable_payload()->mutable_repeated_int64()->Reserve(
+      10);
+  const MessageSpaceUsage child = message.child().SpaceUsedBreakdown();
+  const MessageSpaceUsage usage = message.SpaceUsedBreakdown();
+  EXPECT_GE(usage.repeated_slack_bytes, 10 * sizeof(int64_t));
+  EXPECT_EQ(usage.repeated_slack_bytes, child.repeated_slack_bytes);
+
+  const auto* entry = FindFieldUsage(
+      usage, unittest::NestedTestAllTypes::descriptor()->FindFieldByName(
+                 "child"));
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->bytes_used, child.total_bytes);
+  EXPECT_EQ(entry->bytes_wasted, child.wasted_bytes());
+}
+
 
 class GeneratedMessageReflectionSwapTest : public testing::TestWithParam<bool> {
  protected:
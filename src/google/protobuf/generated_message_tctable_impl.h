@@ -15,6 +15,7 @@
 #include <type_traits>
 
 #include "absl/base/optimization.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/absl_log.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
@@ -373,6 +374,60 @@ inline void AlignFail(std::integral_constant<size_t, 1>,
 enum class TcParseFunction : uint8_t { kNone, PROTOBUF_TC_PARSE_FUNCTION_LIST };
 #undef PROTOBUF_TC_PARSE_FUNCTION_X
 
+// Per-field fast-path statistics.
+//
+// When compiled with -DPROTOBUF_TC_PARSE_STATS, TcParser counts, for each
+// parse table and field number, the fields dispatched through the fast table
+// and those that ended up in MiniParse, along with why.  This is meant to
+// guide which fields deserve fast-table slots.  Otherwise the hooks compile to
+// nothing.
+enum class TcParseMissReason : uint8_t {
+  // The field is not in the table: an unknown field or an extension.
+  kUnknownField,
+  // The tag does not fit in the two bytes the fast table dispatches on.
+  kLongTag,
+  // The fast slot for the tag is empty or belongs to another field.
+  kNotInFastTable,
+  // The fast slot is for this field, but with another wire type, as for
+  // packed/unpacked mismatches.
+  kWireTypeMismatch,
+  // The fast handler for the field deferred to MiniParse.
+  kHandlerFallback,
+};
+inline constexpr int kNumTcParseMissReasons = 5;
+
+struct TcParseFieldStats {
+  const TcParseTableBase* table;
+  // The full name of the message type, or empty if the table has no
+  // prototype.
+  absl::string_view type_name;
+  uint32_t field_number;
+  // Fields dispatched through the fast table, including those that then fell
+  // back.  A run of repeated elements parsed by one fast handler counts once.
+  uint64_t fast_dispatches;
+  // Fields that went through MiniParse, by `TcParseMissReason`.
+  uint64_t misses[kNumTcParseMissReasons];
+};
+
+#if defined(PROTOBUF_TC_PARSE_STATS)
+PROTOBUF_EXPORT void RecordTcParseDispatch(const TcParseTableBase* table,
+                                           uint16_t coded_tag);
+PROTOBUF_EXPORT void RecordTcParseMiss(const TcParseTableBase* table,
+                                       uint32_t tag, bool in_table);
+#endif  // PROTOBUF_TC_PARSE_STATS
+
+// Calls `f` with the counts of every field seen so far.  The order is
+// unspecified.  Does nothing unless built with PROTOBUF_TC_PARSE_STATS.
+PROTOBUF_EXPORT void IterateTcParseStats(
+    absl::FunctionRef<void(const TcParseFieldStats&)> f);
+
+// Drops all the counts collected so far.
+PROTOBUF_EXPORT void ResetTcParseStats();
+
+// Returns a human readable table of the counts, fields with the most misses
+// first.
+PROTOBUF_EXPORT std::string TcParseStatsDebugString();
+
 // TcParser implements most of the parsing logic for tailcall tables.
 class PROTOBUF_EXPORT TcParser final {
  public:
@@ -746,6 +801,17 @@ class PROTOBUF_EXPORT TcParser final {
   static MessageLite* NewMessage(const TcParseTableBase* table, Arena* arena);
   static MessageLite* AddMessage(const TcParseTableBase* table,
                                  RepeatedPtrFieldBase& field);
+  // With EnableParsePrefetch(), prefetches the cleared message that the next
+  // AddMessage() on `field` reuses, so that parsing into it does not start on
+  // cold cache lines.
+  static void PrefetchNextMessage(const TcParseTableBase* table,
+                                  const RepeatedPtrFieldBase& field);
+  // Preallocates the elements of a run of length-delimited occurrences of
+  // `tag` on the arena, starting with the one whose length prefix is at `ptr`.
+  static void PreallocateMessages(const TcParseTableBase* table,
+                                  RepeatedPtrFieldBase& field,
+                                  const char* ptr, ParseContext* ctx,
+                                  uint32_t tag);
 
   template <typename T, bool is_split>
   static inline T& MaybeCreateRepeatedRefAt(void* x, size_t offset,
@@ -921,6 +987,10 @@ class PROTOBUF_EXPORT TcParser final {
               tag, ptr,
               static_cast<const MessageBaseT*>(table->default_instance()),
               &msg->_internal_metadata_, ctx);
+    } else if (ABSL_PREDICT_FALSE(ctx->data().discard_unknown_fields)) {
+      // A null unknown field set makes the parser skip the field.
+      return UnknownFieldParse(tag, static_cast<std::string*>(nullptr), ptr,
+                               ctx);
     } else {
       // Otherwise, we directly put it on the unknown field set.
       return UnknownFieldParse(
@@ -1085,6 +1155,9 @@ class PROTOBUF_EXPORT TcParser final {
 PROTOBUF_ALWAYS_INLINE const char* TcParser::TagDispatch(
     PROTOBUF_TC_PARAM_NO_DATA_DECL) {
   const auto coded_tag = UnalignedLoad<uint16_t>(ptr);
+#if defined(PROTOBUF_TC_PARSE_STATS)
+  RecordTcParseDispatch(table, coded_tag);
+#endif  // PROTOBUF_TC_PARSE_STATS
   const size_t idx = coded_tag & table->fast_idx_mask;
   PROTOBUF_ASSUME((idx & 7) == 0);
   auto* fast_entry = table->fast_entry(idx >> 3);
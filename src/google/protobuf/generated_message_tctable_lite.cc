@@ -14,8 +14,12 @@
 #include <numeric>
 #include <string>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "absl/base/optimization.h"
+#include "absl/base/prefetch.h"
+#include "absl/functional/function_ref.h"
 #include "absl/functional/overload.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
@@ -24,6 +28,11 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
+#if defined(PROTOBUF_TC_PARSE_STATS)
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#endif  // PROTOBUF_TC_PARSE_STATS
 #include "google/protobuf/arenastring.h"
 #include "google/protobuf/generated_enum_util.h"
 #include "google/protobuf/generated_message_tctable_decl.h"
@@ -34,6 +43,7 @@
 #include "google/protobuf/message_lite.h"
 #include "google/protobuf/parse_context.h"
 #include "google/protobuf/port.h"
+#include "google/protobuf/protoz_sampler.h"
 #include "google/protobuf/repeated_field.h"
 #include "google/protobuf/repeated_ptr_field.h"
 #include "google/protobuf/serial_arena.h"
@@ -393,6 +403,7 @@ PROTOBUF_ALWAYS_INLINE const char* TcParser::MiniParse(PROTOBUF_TC_PARAM_DECL) {
     test_out = reinterpret_cast<TestMiniParseResult*>(
         static_cast<uintptr_t>(data.data));
   }
+  ProtozScope::RecordFallbackField();
 
   uint32_t tag;
   ptr = ReadTagInlined(ptr, &tag);
@@ -402,6 +413,9 @@ PROTOBUF_ALWAYS_INLINE const char* TcParser::MiniParse(PROTOBUF_TC_PARAM_DECL) {
   }
 
   auto* entry = FindFieldEntry(table, tag >> 3);
+#if defined(PROTOBUF_TC_PARSE_STATS)
+  RecordTcParseMiss(table, tag, entry != nullptr);
+#endif  // PROTOBUF_TC_PARSE_STATS
   if (entry == nullptr) {
     if (export_called_function) *test_out = {table->fallback, tag};
     data.data = tag;
@@ -518,6 +532,58 @@ MessageLite* TcParser::AddMessage(const TcParseTableBase* table,
       [table](Arena* arena) { return NewMessage(table, arena); }));
 }
 
+PROTOBUF_ALWAYS_INLINE void TcParser::PrefetchNextMessage(
+    const TcParseTableBase* table, const RepeatedPtrFieldBase& field) {
+  if (!EnableParsePrefetch()) return;
+  const char* next = static_cast<const char*>(field.NextClearedElement());
+  if (next == nullptr) return;
+  absl::PrefetchToLocalCacheForWrite(next);
+  absl::PrefetchToLocalCacheForWrite(next + table->has_bits_offset);
+}
+
+namespace {
+
+// Returns the number of consecutive length-delimited fields with `tag` that
+// end before `end`, up to `max_count`, starting with the one whose length
+// prefix is at `ptr`.
+int CountLengthDelimited(const char* ptr, const char* end, uint32_t tag,
+                         int max_count) {
+  int count = 0;
+  while (count < max_count) {
+    const uint32_t size = ReadSize(&ptr);
+    if (ptr == nullptr || ptr > end ||
+        size > static_cast<size_t>(end - ptr)) {
+      break;
+    }
+    ++count;
+    ptr += size;
+    if (ptr >= end) break;
+    uint32_t next_tag;
+    ptr = ReadTag(ptr, &next_tag);
+    if (ptr == nullptr || next_tag != tag) break;
+  }
+  return count;
+}
+
+}  // namespace
+
+void TcParser::PreallocateMessages(const TcParseTableBase* table,
+                                   RepeatedPtrFieldBase& field,
+                                   const char* ptr, ParseContext* ctx,
+                                   uint32_t tag) {
+  if (field.GetArena() == nullptr || !field.PrepareForParse()) return;
+  // Bounded to limit the memory set aside for a run of elements that may
+  // still fail to parse.
+  constexpr int kMaxElements = 256;
+  const int n =
+      CountLengthDelimited(ptr, ctx->LimitEnd(), tag, kMaxElements);
+  const ClassData* class_data = table->class_data;
+  field.PreallocateElements(
+      n, class_data->allocation_size(), [class_data](Arena* arena, void* mem) {
+        return class_data->PlacementNew(mem, arena);
+      });
+}
+
 template <typename TagType, bool group_coding, bool aux_is_table>
 PROTOBUF_ALWAYS_INLINE const char* TcParser::SingularParseMessageAuxImpl(
     PROTOBUF_TC_PARAM_DECL) {
@@ -612,9 +678,14 @@ PROTOBUF_ALWAYS_INLINE const char* TcParser::RepeatedParseMessageAuxImpl(
   auto& field = RefAt<RepeatedPtrFieldBase>(msg, data.offset());
   const TcParseTableBase* inner_table =
       aux_is_table ? aux.table : aux.message_default()->GetTcParseTable();
+  if (!group_coding) {
+    PreallocateMessages(inner_table, field, ptr + sizeof(TagType), ctx,
+                        FastDecodeTag(expected_tag));
+  }
   do {
     ptr += sizeof(TagType);
     MessageLite* submsg = AddMessage(inner_table, field);
+    PrefetchNextMessage(inner_table, field);
     const auto inner_loop = [&](const char* ptr) {
       return ParseLoop(submsg, ptr, ctx, inner_table);
     };
@@ -1680,6 +1751,9 @@ PROTOBUF_ALWAYS_INLINE const char* TcParser::RepeatedString(
     }
   };
 
+  // Strings left over by Clear() are filled in place, keeping their capacity,
+  // before any new one is created: a field reused in a parse loop stops
+  // allocating once it has seen its largest input.
   auto* arena = field.GetArena();
   SerialArena* serial_arena;
   if (ABSL_PREDICT_TRUE(arena != nullptr &&
@@ -2394,6 +2468,7 @@ PROTOBUF_NOINLINE const char* TcParser::MpRepeatedString(
       const char* ptr2 = ptr;
       uint32_t next_tag;
 
+      // As in RepeatedString, cleared strings are reused first.
       auto* arena = field.GetArena();
       SerialArena* serial_arena;
       if (ABSL_PREDICT_TRUE(arena != nullptr &&
@@ -2553,10 +2628,14 @@ const char* TcParser::MpRepeatedMessageOrGroup(PROTOBUF_TC_PARAM_DECL) {
   const TcParseTableBase* inner_table =
       GetTableFromAux(type_card, *table->field_aux(&entry));
 
+  // AddMessage() hands out the messages left over by Clear() before creating
+  // new ones, so they keep their own fields' storage across parses.
+  if (!is_group) PreallocateMessages(inner_table, field, ptr, ctx, decoded_tag);
   const char* ptr2 = ptr;
   uint32_t next_tag;
   do {
     MessageLite* value = AddMessage(inner_table, field);
+    PrefetchNextMessage(inner_table, field);
     const auto inner_loop = [&](const char* ptr) {
       return ParseLoopPreserveNone(value, ptr, ctx, inner_table);
     };
@@ -2749,7 +2828,13 @@ const char* TcParser::ParseOneMapEntry(
           ABSL_DCHECK_EQ(static_cast<int>(type_kind),
                          static_cast<int>(UntypedMapBase::TypeKind::kMessage));
           ABSL_DCHECK_EQ(inner_tag, value_tag);
-          ptr = ctx->ParseMessage(reinterpret_cast<MessageLite*>(obj), ptr);
+          // Enter the value's parse loop directly with its table, instead of
+          // going through the out-of-line `_InternalParse()`. Small value
+          // messages like timestamps are otherwise dominated by that dispatch.
+          auto* value = reinterpret_cast<MessageLite*>(obj);
+          ptr = ctx->ParseLengthDelimitedInlined(ptr, [&](const char* ptr) {
+            return ParseLoopPreserveNone(value, ptr, ctx, aux[1].table);
+          });
           if (ABSL_PREDICT_FALSE(ptr == nullptr)) return nullptr;
           continue;
         }
@@ -2760,6 +2845,29 @@ const char* TcParser::ParseOneMapEntry(
   return ptr;
 }
 
+namespace {
+
+// Counts the consecutive map entries with tag `tag` in [ptr, end), starting
+// with the one whose length prefix is at `ptr`. Entries with fewer than 2
+// bytes of payload are not counted: they only repeat the default key, and
+// skipping them bounds the reservation by the input size.
+size_t CountMapEntries(const char* ptr, const char* end, uint32_t tag) {
+  size_t count = 0;
+  while (true) {
+    const uint32_t size = ReadSize(&ptr);
+    if (ptr == nullptr) break;
+    if (size >= 2) ++count;
+    if (ptr >= end || size >= static_cast<size_t>(end - ptr)) break;
+    ptr += size;
+    uint32_t next_tag;
+    ptr = ReadTag(ptr, &next_tag);
+    if (ptr == nullptr || next_tag != tag || ptr >= end) break;
+  }
+  return count;
+}
+
+}  // namespace
+
 template <bool is_split>
 PROTOBUF_NOINLINE const char* TcParser::MpMap(PROTOBUF_TC_PARAM_DECL) {
   const auto& entry = RefAt<FieldEntry>(table, data.entry_offset());
@@ -2788,8 +2896,37 @@ PROTOBUF_NOINLINE const char* TcParser::MpMap(PROTOBUF_TC_PARAM_DECL) {
 
   const uint32_t saved_tag = data.tag();
 
+  // Make room for all the entries in the buffer up front instead of growing
+  // the table repeatedly while inserting them, and carve nodes for them out
+  // of larger arena blocks.
+  const size_t node_size = map.type_info().node_size;
+  size_t pending_nodes = CountMapEntries(ptr, ctx->LimitEnd(), saved_tag);
+  map.VisitKeyType([&](auto key_type) {
+    static_cast<KeyMapBase<typename decltype(key_type)::type>&>(map).Reserve(
+        map.size() + pending_nodes);
+  });
+  char* bulk_nodes = nullptr;
+  char* bulk_nodes_end = nullptr;
+
   while (true) {
-    NodeBase* node = map.AllocNode();
+    NodeBase* node;
+    if (bulk_nodes != bulk_nodes_end) {
+      node = reinterpret_cast<NodeBase*>(bulk_nodes);
+      bulk_nodes += node_size;
+    } else if (map.arena() != nullptr && pending_nodes > 1) {
+      // Bounded to limit the memory set aside for a run of entries that may
+      // still fail to parse.
+      constexpr size_t kMaxBulkNodes = 256;
+      const size_t n = std::min(pending_nodes, kMaxBulkNodes);
+      bulk_nodes =
+          static_cast<char*>(map.arena()->AllocateAligned(n * node_size));
+      bulk_nodes_end = bulk_nodes + n * node_size;
+      node = reinterpret_cast<NodeBase*>(bulk_nodes);
+      bulk_nodes += node_size;
+    } else {
+      node = map.AllocNode();
+    }
+    if (pending_nodes > 0) --pending_nodes;
     char* const node_end =
         reinterpret_cast<char*>(node) + map.type_info().node_size;
     void* const node_key = node->GetVoidKey();
@@ -2806,9 +2943,9 @@ PROTOBUF_NOINLINE const char* TcParser::MpMap(PROTOBUF_TC_PARAM_DECL) {
 
     map.VisitKey(  //
         node, absl::Overload{
-                  [&](std::string* str) {
-                    Arena::CreateInArenaStorage(str, map.arena());
-                  },
+                  // Registered with the arena below, and only if the parsed
+                  // key ends up owning memory.
+                  [](std::string* str) { ::new (str) std::string(); },
                   // Already initialized above. Do nothing here.
                   [](void*) {},
               });
@@ -2829,6 +2966,12 @@ PROTOBUF_NOINLINE const char* TcParser::MpMap(PROTOBUF_TC_PARAM_DECL) {
       return ParseOneMapEntry(node, ptr, ctx, aux, table, entry, map);
     });
 
+    if (map.arena() != nullptr && map.type_info().key_type_kind() ==
+                                      UntypedMapBase::TypeKind::kString) {
+      std::string* key = map.GetKey<std::string>(node);
+      if (!IsInlineString(*key)) map.arena()->OwnDestructor(key);
+    }
+
     if (ABSL_PREDICT_FALSE(ptr == nullptr)) {
       // Parsing failed. Delete the node that we didn't insert.
       if (map.arena() == nullptr) map.DeleteNode(node);
@@ -2845,19 +2988,23 @@ PROTOBUF_NOINLINE const char* TcParser::MpMap(PROTOBUF_TC_PARAM_DECL) {
       switch (map.type_info().key_type_kind()) {
         case UntypedMapBase::TypeKind::kBool:
           static_cast<KeyMapBase<bool>&>(map).InsertOrReplaceNode(
-              static_cast<KeyMapBase<bool>::KeyNode*>(node));
+              static_cast<KeyMapBase<bool>::KeyNode*>(node),
+              /*grow_only=*/true);
           break;
         case UntypedMapBase::TypeKind::kU32:
           static_cast<KeyMapBase<uint32_t>&>(map).InsertOrReplaceNode(
-              static_cast<KeyMapBase<uint32_t>::KeyNode*>(node));
+              static_cast<KeyMapBase<uint32_t>::KeyNode*>(node),
+              /*grow_only=*/true);
           break;
         case UntypedMapBase::TypeKind::kU64:
           static_cast<KeyMapBase<uint64_t>&>(map).InsertOrReplaceNode(
-              static_cast<KeyMapBase<uint64_t>::KeyNode*>(node));
+              static_cast<KeyMapBase<uint64_t>::KeyNode*>(node),
+              /*grow_only=*/true);
           break;
         case UntypedMapBase::TypeKind::kString:
           static_cast<KeyMapBase<std::string>&>(map).InsertOrReplaceNode(
-              static_cast<KeyMapBase<std::string>::KeyNode*>(node));
+              static_cast<KeyMapBase<std::string>::KeyNode*>(node),
+              /*grow_only=*/true);
           break;
         default:
           Unreachable();
@@ -3025,6 +3172,171 @@ const char* TcParser::DiscardEverythingFallback(PROTOBUF_TC_PARAM_DECL) {
   return UnknownFieldParse(tag, nullptr, ptr, ctx);
 }
 
+#if defined(PROTOBUF_TC_PARSE_STATS)
+namespace {
+
+struct TcParseCounts {
+  uint64_t fast_dispatches = 0;
+  uint64_t misses[kNumTcParseMissReasons] = {};
+};
+
+using TcParseStatsKey = std::pair<const TcParseTableBase*, uint32_t>;
+
+// Counts are kept per thread so that parsing threads only ever take their own,
+// uncontended, lock.  Shards outlive their thread so that its counts are not
+// lost.
+struct TcParseStatsShard {
+  absl::Mutex mu;
+  absl::flat_hash_map<TcParseStatsKey, TcParseCounts> counts
+      ABSL_GUARDED_BY(mu);
+};
+
+struct TcParseStatsRegistry {
+  absl::Mutex mu;
+  std::vector<TcParseStatsShard*> shards ABSL_GUARDED_BY(mu);
+};
+
+TcParseStatsRegistry& GlobalTcParseStatsRegistry() {
+  static auto* registry = new TcParseStatsRegistry();
+  return *registry;
+}
+
+TcParseStatsShard& ThreadTcParseStatsShard() {
+  static thread_local TcParseStatsShard* shard = [] {
+    auto* shard = new TcParseStatsShard();
+    TcParseStatsRegistry& registry = GlobalTcParseStatsRegistry();
+    absl::MutexLock lock(&registry.mu);
+    registry.shards.push_back(shard);
+    return shard;
+  }();
+  return *shard;
+}
+
+// Decodes a tag of at most two bytes, in the layout of the `coded_tag` of
+// TcFieldData.  Returns 0 for longer tags.
+uint32_t DecodeCodedTag(uint16_t coded_tag) {
+  if ((coded_tag & 0x80) == 0) return coded_tag & 0x7F;
+  if ((coded_tag & 0x8000) != 0) return 0;
+  return (coded_tag & 0x7F) | ((coded_tag >> 8) << 7);
+}
+
+TcParseMissReason ClassifyTcParseMiss(const TcParseTableBase* table,
+                                      uint32_t tag, bool in_table) {
+  if (!in_table) return TcParseMissReason::kUnknownField;
+  if (tag >= (1 << 14)) return TcParseMissReason::kLongTag;
+  const uint32_t coded_tag =
+      tag < 0x80 ? tag : (tag & 0x7F) | 0x80 | ((tag >> 7) << 8);
+  const auto* fast_entry =
+      table->fast_entry((coded_tag & table->fast_idx_mask) >> 3);
+  const uint32_t fast_tag =
+      DecodeCodedTag(static_cast<uint16_t>(fast_entry->bits.data));
+  if (fast_entry->target() ==
+          static_cast<TailCallParseFunc>(&TcParser::MiniParse) ||
+      (fast_tag >> 3) != (tag >> 3)) {
+    return TcParseMissReason::kNotInFastTable;
+  }
+  if (fast_tag != tag) return TcParseMissReason::kWireTypeMismatch;
+  return TcParseMissReason::kHandlerFallback;
+}
+
+}  // namespace
+
+void RecordTcParseDispatch(const TcParseTableBase* table, uint16_t coded_tag) {
+  const uint32_t tag = DecodeCodedTag(coded_tag);
+  // Longer tags are only decoded by MiniParse, which records them.
+  if (tag == 0) return;
+  TcParseStatsShard& shard = ThreadTcParseStatsShard();
+  absl::MutexLock lock(&shard.mu);
+  ++shard.counts[{table, tag >> 3}].fast_dispatches;
+}
+
+void RecordTcParseMiss(const TcParseTableBase* table, uint32_t tag,
+                       bool in_table) {
+  const TcParseMissReason reason = ClassifyTcParseMiss(table, tag, in_table);
+  TcParseStatsShard& shard = ThreadTcParseStatsShard();
+  absl::MutexLock lock(&shard.mu);
+  TcParseCounts& counts = shard.counts[{table, tag >> 3}];
+  if (reason == TcParseMissReason::kLongTag) ++counts.fast_dispatches;
+  ++counts.misses[static_cast<int>(reason)];
+}
+
+void IterateTcParseStats(absl::FunctionRef<void(const TcParseFieldStats&)> f) {
+  absl::flat_hash_map<TcParseStatsKey, TcParseCounts> merged;
+  {
+    TcParseStatsRegistry& registry = GlobalTcParseStatsRegistry();
+    absl::MutexLock registry_lock(&registry.mu);
+    for (TcParseStatsShard* shard : registry.shards) {
+      absl::MutexLock lock(&shard->mu);
+      for (const auto& entry : shard->counts) {
+        TcParseCounts& counts = merged[entry.first];
+        counts.fast_dispatches += entry.second.fast_dispatches;
+        for (int i = 0; i < kNumTcParseMissReasons; ++i) {
+          counts.misses[i] += entry.second.misses[i];
+        }
+      }
+    }
+  }
+  // `f` runs without any lock held, so it may parse.
+  for (const auto& entry : merged) {
+    const TcParseTableBase* table = entry.first.first;
+    TcParseFieldStats stats = {};
+    stats.table = table;
+    if (table->class_data != nullptr &&
+        table->class_data->prototype != nullptr) {
+      stats.type_name = table->class_data->prototype->GetTypeName();
+    }
+    stats.field_number = entry.first.second;
+    stats.fast_dispatches = entry.second.fast_dispatches;
+    std::copy(std::begin(entry.second.misses), std::end(entry.second.misses),
+              std::begin(stats.misses));
+    f(stats);
+  }
+}
+
+void ResetTcParseStats() {
+  TcParseStatsRegistry& registry = GlobalTcParseStatsRegistry();
+  absl::MutexLock registry_lock(&registry.mu);
+  for (TcParseStatsShard* shard : registry.shards) {
+    absl::MutexLock lock(&shard->mu);
+    shard->counts.clear();
+  }
+}
+
+#else   // PROTOBUF_TC_PARSE_STATS
+
+void IterateTcParseStats(absl::FunctionRef<void(const TcParseFieldStats&)>) {}
+void ResetTcParseStats() {}
+
+#endif  // PROTOBUF_TC_PARSE_STATS
+
+std::string TcParseStatsDebugString() {
+  std::vector<TcParseFieldStats> all;
+  IterateTcParseStats(
+      [&](const TcParseFieldStats& stats) { all.push_back(stats); });
+  const auto total_misses = [](const TcParseFieldStats& stats) {
+    return std::accumulate(std::begin(stats.misses), std::end(stats.misses),
+                           uint64_t{0});
+  };
+  std::sort(all.begin(), all.end(),
+            [&](const TcParseFieldStats& a, const TcParseFieldStats& b) {
+              return total_misses(a) > total_misses(b);
+            });
+  std::string out = absl::StrFormat(
+      "%-40s %6s %10s %10s %8s %8s %8s %8s %8s\n", "type", "field", "fast",
+      "misses", "unknown", "longtag", "noslot", "wiretype", "handler");
+  for (const TcParseFieldStats& stats : all) {
+    absl::StrAppendFormat(
+        &out, "%-40s %6d %10d %10d %8d %8d %8d %8d %8d\n", stats.type_name,
+        stats.field_number, stats.fast_dispatches, total_misses(stats),
+        stats.misses[static_cast<int>(TcParseMissReason::kUnknownField)],
+        stats.misses[static_cast<int>(TcParseMissReason::kLongTag)],
+        stats.misses[static_cast<int>(TcParseMissReason::kNotInFastTable)],
+        stats.misses[static_cast<int>(TcParseMissReason::kWireTypeMismatch)],
+        stats.misses[static_cast<int>(TcParseMissReason::kHandlerFallback)]);
+  }
+  return out;
+}
+
 }  // namespace internal
 }  // namespace protobuf
 }  // namespace google
@@ -8,6 +8,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <string>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -23,6 +24,7 @@
 #include "google/protobuf/generated_message_tctable_decl.h"
 #include "google/protobuf/generated_message_tctable_impl.h"
 #include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 #include "google/protobuf/message_lite.h"
 #include "google/protobuf/parse_context.h"
 #include "google/protobuf/port.h"
@@ -985,6 +987,101 @@ TEST(GeneratedMessageTctableLiteTest,
   EXPECT_LE(proto.vals().Capacity(), 2048);
 }
 
+TEST(GeneratedMessageTctableLiteTest, PackedVarintMixedWidthRuns) {
+  // Interleave runs of single byte varints (which take the word-at-a-time
+  // path) with multi-byte and negative values at every possible alignment.
+  proto2_unittest::TestPackedTypes proto;
+  for (int i = 0; i < 4096; i++) {
+    int64_t small = i % 100;
+    int64_t value = (i % 13 == 0)   ? -i
+                    : (i % 9 == 0)  ? int64_t{1} << (i % 63)
+                                    : small;
+    proto.add_packed_int64(value);
+    proto.add_packed_uint32(static_cast<uint32_t>(value));
+    proto.add_packed_sint32(static_cast<int32_t>(value));
+    proto.add_packed_bool(value != 0);
+  }
+
+  proto2_unittest::TestPackedTypes new_proto;
+  ASSERT_TRUE(new_proto.ParseFromString(proto.SerializeAsString()));
+  EXPECT_THAT(new_proto.packed_int64(),
+              testing::ElementsAreArray(proto.packed_int64()));
+  EXPECT_THAT(new_proto.packed_uint32(),
+              testing::ElementsAreArray(proto.packed_uint32()));
+  EXPECT_THAT(new_proto.packed_sint32(),
+              testing::ElementsAreArray(proto.packed_sint32()));
+  EXPECT_THAT(new_proto.packed_bool(),
+              testing::ElementsAreArray(proto.packed_bool()));
+}
+
+TEST(GeneratedMessageTctableLiteTest, PackedFixedSpanningChunks) {
+  proto2_unittest::TestPackedTypes proto;
+  for (int i = 0; i < 10000; i++) {
+    proto.add_packed_double(i * 0.5);
+    proto.add_packed_fixed32(i * 7);
+  }
+  std::string serialized = proto.SerializeAsString();
+
+  // Use an odd block size so that element boundaries never line up with the
+  // chunk boundaries of the stream.
+  io::ArrayInputStream input(serialized.data(), serialized.size(),
+                             /*block_size=*/333);
+  proto2_unittest::TestPackedTypes new_proto;
+  ASSERT_TRUE(new_proto.ParseFromZeroCopyStream(&input));
+  EXPECT_THAT(new_proto.packed_double(),
+              testing::ElementsAreArray(proto.packed_double()));
+  EXPECT_THAT(new_proto.packed_fixed32(),
+              testing::ElementsAreArray(proto.packed_fixed32()));
+  // The field is grown once for the whole payload rather than per chunk.
+  EXPECT_LE(new_proto.packed_double().Capacity(),
+            proto.packed_double().Capacity());
+}
+
+#if defined(PROTOBUF_TC_PARSE_STATS)
+TEST(GeneratedMessageTctableLiteTest, ParseStatsCountFastAndMissedFields) {
+  ResetTcParseStats();
+  proto2_unittest::TestAllTypes proto;
+  proto.set_optional_int32(1);
+  std::string serialized = proto.SerializeAsString();
+  // An unknown field, which has to go through MiniParse.
+  serialized += std::string("\xf8\xf0\x04\x01", 4);  // field 9999 = 1
+  ASSERT_TRUE(proto.ParseFromString(serialized));
+
+  const TcParseTableBase* table = nullptr;
+  uint64_t fast = 0;
+  uint64_t unknown = 0;
+  IterateTcParseStats([&](const TcParseFieldStats& stats) {
+    if (stats.type_name != "proto2_unittest.TestAllTypes") return;
+    table = stats.table;
+    if (stats.field_number == 1) {
+      fast += stats.fast_dispatches;
+      for (uint64_t misses : stats.misses) EXPECT_EQ(misses, 0);
+    } else if (stats.field_number == 9999) {
+      unknown += stats.misses[static_cast<int>(
+          TcParseMissReason::kUnknownField)];
+    }
+  });
+  ASSERT_NE(table, nullptr);
+  EXPECT_EQ(fast, 1);
+  EXPECT_EQ(unknown, 1);
+  EXPECT_THAT(TcParseStatsDebugString(),
+              testing::HasSubstr("proto2_unittest.TestAllTypes"));
+
+  ResetTcParseStats();
+  int fields = 0;
+  IterateTcParseStats([&](const TcParseFieldStats&) { ++fields; });
+  EXPECT_EQ(fields, 0);
+}
+#else   // PROTOBUF_TC_PARSE_STATS
+TEST(GeneratedMessageTctableLiteTest, ParseStatsCompiledOut) {
+  proto2_unittest::TestAllTypes proto;
+  proto.set_optional_int32(1);
+  ASSERT_TRUE(proto.ParseFromString(proto.SerializeAsString()));
+  int fields = 0;
+  IterateTcParseStats([&](const TcParseFieldStats&) { ++fields; });
+  EXPECT_EQ(fields, 0);
+}
+#endif  // PROTOBUF_TC_PARSE_STATS
 
 }  // namespace internal
 }  // namespace protobuf
@@ -205,6 +205,10 @@ struct MapSorterIt {
   MapSorterIt operator+(int v) { return MapSorterIt{ptr + v}; }
 };
 
+// Maps with up to this many entries are sorted in storage inside the sorter
+// object, without a heap allocation.
+inline constexpr size_t kMapSorterInlineSize = 8;
+
 // Defined outside of MapSorterFlat to only be templatized on the key.
 template <typename KeyT>
 struct MapSorterLessThan {
@@ -243,22 +247,33 @@ class MapSorterFlat {
   };
 
   explicit MapSorterFlat(const MapT& m)
-      : size_(m.size()), items_(size_ ? new storage_type[size_] : nullptr) {
+      : size_(m.size()),
+        heap_items_(size_ > kMapSorterInlineSize ? new storage_type[size_]
+                                                 : nullptr),
+        items_(heap_items_ ? heap_items_.get() : inline_items_) {
     if (!size_) return;
-    storage_type* it = &items_[0];
+    storage_type* it = items_;
     for (const auto& entry : m) {
       *it++ = {entry.first, &entry};
     }
-    std::sort(&items_[0], &items_[size_],
-              MapSorterLessThan<typename MapT::key_type>{});
+    if (size_ > 1) {
+      std::sort(items_, items_ + size_,
+                MapSorterLessThan<typename MapT::key_type>{});
+    }
   }
+  MapSorterFlat(const MapSorterFlat&) = delete;
+  MapSorterFlat& operator=(const MapSorterFlat&) = delete;
+
   size_t size() const { return size_; }
-  const_iterator begin() const { return {items_.get()}; }
-  const_iterator end() const { return {items_.get() + size_}; }
+  const_iterator begin() const { return {items_}; }
+  const_iterator end() const { return {items_ + size_}; }
 
  private:
   size_t size_;
-  std::unique_ptr<storage_type[]> items_;
+  std::unique_ptr<storage_type[]> heap_items_;
+  // Points to either `heap_items_` or `inline_items_`.
+  storage_type* items_;
+  storage_type inline_items_[kMapSorterInlineSize];
 };
 
 // Defined outside of MapSorterPtr to only be templatized on the key.
@@ -300,24 +315,35 @@ class MapSorterPtr {
   };
 
   explicit MapSorterPtr(const MapT& m)
-      : size_(m.size()), items_(size_ ? new storage_type[size_] : nullptr) {
+      : size_(m.size()),
+        heap_items_(size_ > kMapSorterInlineSize ? new storage_type[size_]
+                                                 : nullptr),
+        items_(heap_items_ ? heap_items_.get() : inline_items_) {
     if (!size_) return;
-    storage_type* it = &items_[0];
+    storage_type* it = items_;
     for (const auto& entry : m) {
       *it++ = &entry;
     }
     static_assert(PROTOBUF_FIELD_OFFSET(typename MapT::value_type, first) == 0,
                   "Must hold for MapSorterPtrLessThan to work.");
-    std::sort(&items_[0], &items_[size_],
-              MapSorterPtrLessThan<typename MapT::key_type>{});
+    if (size_ > 1) {
+      std::sort(items_, items_ + size_,
+                MapSorterPtrLessThan<typename MapT::key_type>{});
+    }
   }
+  MapSorterPtr(const MapSorterPtr&) = delete;
+  MapSorterPtr& operator=(const MapSorterPtr&) = delete;
+
   size_t size() const { return size_; }
-  const_iterator begin() const { return {items_.get()}; }
-  const_iterator end() const { return {items_.get() + size_}; }
+  const_iterator begin() const { return {items_}; }
+  const_iterator end() const { return {items_ + size_}; }
 
  private:
   size_t size_;
-  std::unique_ptr<storage_type[]> items_;
+  std::unique_ptr<storage_type[]> heap_items_;
+  // Points to either `heap_items_` or `inline_items_`.
+  storage_type* items_;
+  storage_type inline_items_[kMapSorterInlineSize];
 };
 
 struct WeakDescriptorDefaultTail {
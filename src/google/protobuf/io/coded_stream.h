@@ -504,6 +504,18 @@ class PROTOBUF_EXPORT CodedInputStream {
   // factory has been provided.
   MessageFactory* GetExtensionFactory();
 
+  // Unknown Fields --------------------------------------------------
+
+  // If set, messages parsed from this stream with MergeFromCodedStream() and
+  // friends skip over unknown fields instead of keeping them, as if
+  // DiscardUnknownFields() were called on the result, but without storing the
+  // fields or walking the message tree a second time.  Unknown values of
+  // closed enums and unknown fields inside MessageSet items are still kept.
+  void SetDiscardUnknownFields(bool discard);
+
+  // Returns the value set via SetDiscardUnknownFields(); false by default.
+  bool DiscardUnknownFields() const;
+
  private:
   const uint8_t* buffer_;
   const uint8_t* buffer_end_;  // pointer to the end of the buffer.
@@ -556,6 +568,9 @@ class PROTOBUF_EXPORT CodedInputStream {
   const DescriptorPool* extension_pool_;
   MessageFactory* extension_factory_;
 
+  // See SetDiscardUnknownFields().
+  bool discard_unknown_fields_;
+
   // Private member functions.
 
   // Fallback when Skip() goes past the end of the current buffer.
@@ -877,9 +892,17 @@ class PROTOBUF_EXPORT EpsCopyOutputStream {
     ptr = WriteLengthDelim(num, size, ptr);
     auto it = r.data();
     auto end = it + r.size();
+    constexpr int kMaxVarintSize = (sizeof(encode(*it)) * 8 + 6) / 7;
     do {
       ptr = EnsureSpace(ptr);
-      ptr = UnsafeVarint(encode(*it++), ptr);
+      // We may write up to end_ + kSlopBytes, which is usually far more than a
+      // single varint needs. Encode every element that is guaranteed to fit
+      // before checking for space again.
+      std::ptrdiff_t fit = (end_ + kSlopBytes - ptr) / kMaxVarintSize;
+      auto chunk_end = end - it < fit ? end : it + fit;
+      do {
+        ptr = UnsafeVarint(encode(*it++), ptr);
+      } while (it < chunk_end);
     } while (it < end);
     return ptr;
   }
@@ -1548,6 +1571,14 @@ inline MessageFactory* CodedInputStream::GetExtensionFactory() {
   return extension_factory_;
 }
 
+inline void CodedInputStream::SetDiscardUnknownFields(bool discard) {
+  discard_unknown_fields_ = discard;
+}
+
+inline bool CodedInputStream::DiscardUnknownFields() const {
+  return discard_unknown_fields_;
+}
+
 inline int CodedInputStream::BufferSize() const {
   return static_cast<int>(buffer_end_ - buffer_);
 }
@@ -1568,7 +1599,8 @@ inline CodedInputStream::CodedInputStream(ZeroCopyInputStream* input)
       recursion_budget_(default_recursion_limit_),
       recursion_limit_(default_recursion_limit_),
       extension_pool_(nullptr),
-      extension_factory_(nullptr) {
+      extension_factory_(nullptr),
+      discard_unknown_fields_(false) {
   // Eagerly Refresh() so buffer space is immediately available.
   Refresh();
 }
@@ -1589,7 +1621,8 @@ inline CodedInputStream::CodedInputStream(const uint8_t* buffer, int size)
       recursion_budget_(default_recursion_limit_),
       recursion_limit_(default_recursion_limit_),
       extension_pool_(nullptr),
-      extension_factory_(nullptr) {
+      extension_factory_(nullptr),
+      discard_unknown_fields_(false) {
   // Note that setting current_limit_ == size is important to prevent some
   // code paths from trying to access input_ and segfaulting.
 }
@@ -755,6 +755,55 @@ TEST_P(BlockSizes, WriteRaw) {
   EXPECT_EQ(0, memcmp(buffer_, kRawBytes, sizeof(kRawBytes)));
 }
 
+TEST_P(BlockSizes, WriteVarintPacked) {
+  std::vector<int32_t> int32s;
+  std::vector<uint64_t> uint64s;
+  for (int i = 0; i < 1000; i++) {
+    int32s.push_back(static_cast<int32_t>(uint32_t{1} << (i % 32)));
+    uint64s.push_back(uint64_t{1} << (i % 64));
+  }
+  size_t int32_size = 0;
+  size_t uint64_size = 0;
+  for (int32_t v : int32s) {
+    int32_size += CodedOutputStream::VarintSize32SignExtended(v);
+  }
+  for (uint64_t v : uint64s) {
+    uint64_size += CodedOutputStream::VarintSize64(v);
+  }
+
+  ArrayOutputStream output(buffer_, sizeof(buffer_), GetParam());
+  {
+    CodedOutputStream coded_output(&output);
+    uint8_t* ptr = coded_output.Cur();
+    ptr = coded_output.EpsCopy()->WriteInt32Packed(
+        1, int32s, static_cast<int>(int32_size), ptr);
+    ptr = coded_output.EpsCopy()->WriteUInt64Packed(
+        2, uint64s, static_cast<int>(uint64_size), ptr);
+    coded_output.SetCur(ptr);
+    EXPECT_FALSE(coded_output.HadError());
+  }
+
+  ArrayInputStream input(buffer_, output.ByteCount());
+  CodedInputStream coded_input(&input);
+  uint32_t length;
+  uint64_t value;
+  EXPECT_EQ((1 << 3) | 2, coded_input.ReadTag());  // Length-delimited field 1.
+  ASSERT_TRUE(coded_input.ReadVarint32(&length));
+  EXPECT_EQ(int32_size, length);
+  for (int32_t v : int32s) {
+    ASSERT_TRUE(coded_input.ReadVarint64(&value));
+    EXPECT_EQ(v, static_cast<int32_t>(value));
+  }
+  EXPECT_EQ((2 << 3) | 2, coded_input.ReadTag());  // Length-delimited field 2.
+  ASSERT_TRUE(coded_input.ReadVarint32(&length));
+  EXPECT_EQ(uint64_size, length);
+  for (uint64_t v : uint64s) {
+    ASSERT_TRUE(coded_input.ReadVarint64(&value));
+    EXPECT_EQ(v, value);
+  }
+  EXPECT_TRUE(coded_input.ExpectAtEnd());
+}
+
 TEST_P(BlockSizes, ReadString) {
   int kBlockSizes_case = GetParam();
   memcpy(buffer_, kRawBytes, sizeof(kRawBytes));
@@ -14,6 +14,13 @@
 #if HAVE_ZLIB
 #include "google/protobuf/io/gzip_stream.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "google/protobuf/stubs/common.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
@@ -25,6 +32,78 @@ namespace io {
 
 static const int kDefaultBufferSize = 65536;
 
+namespace {
+
+// The largest distance a deflate match can reach back.
+constexpr size_t kDeflateWindowSize = 32768;
+
+// Keeps the last kDeflateWindowSize bytes of `window` followed by `data`.
+void AppendToWindow(std::string* window, const std::string& data) {
+  if (data.size() >= kDeflateWindowSize) {
+    window->assign(data, data.size() - kDeflateWindowSize, kDeflateWindowSize);
+    return;
+  }
+  window->append(data);
+  if (window->size() > kDeflateWindowSize) {
+    window->erase(0, window->size() - kDeflateWindowSize);
+  }
+}
+
+struct DeflatedBlock {
+  std::string data;
+  uLong check;
+  int error;
+};
+
+// Compresses `input` to raw deflate data that continues a stream whose last
+// input was `window`.  Unless `last`, the data ends on a byte boundary with an
+// empty stored block so that the next block can be appended to it.
+void DeflateBlock(const std::string& input, const std::string& window,
+                  bool last, int level, int strategy, bool gzip,
+                  DeflatedBlock* result) {
+  const Bytef* in = reinterpret_cast<const Bytef*>(input.data());
+  result->check = gzip ? crc32(crc32(0, Z_NULL, 0), in, input.size())
+                       : adler32(adler32(0, Z_NULL, 0), in, input.size());
+
+  z_stream zcontext;
+  zcontext.zalloc = Z_NULL;
+  zcontext.zfree = Z_NULL;
+  zcontext.opaque = Z_NULL;
+  result->error = deflateInit2(&zcontext, level, Z_DEFLATED,
+                               /* windowBits (raw) */ -15,
+                               /* memLevel (default) */ 8, strategy);
+  if (result->error != Z_OK) return;
+  if (!window.empty()) {
+    result->error = deflateSetDictionary(
+        &zcontext, reinterpret_cast<const Bytef*>(window.data()),
+        window.size());
+  }
+  if (result->error == Z_OK) {
+    // zlib does not modify the input.
+    zcontext.next_in = const_cast<Bytef*>(in);
+    zcontext.avail_in = input.size();
+    // The bound does not cover the marker a sync flush adds.
+    result->data.resize(deflateBound(&zcontext, input.size()) + 16);
+    size_t written = 0;
+    int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+    do {
+      if (written == result->data.size()) {
+        result->data.resize(result->data.size() * 2);
+      }
+      zcontext.next_out = reinterpret_cast<Bytef*>(&result->data[written]);
+      zcontext.avail_out = result->data.size() - written;
+      result->error = deflate(&zcontext, flush);
+      written = result->data.size() - zcontext.avail_out;
+    } while (result->error == Z_OK && zcontext.avail_out == 0);
+    result->data.resize(written);
+    if (result->error == Z_STREAM_END) result->error = Z_OK;
+  }
+  // Reports Z_DATA_ERROR for blocks that do not end the stream.
+  deflateEnd(&zcontext);
+}
+
+}  // namespace
+
 GzipInputStream::GzipInputStream(ZeroCopyInputStream* sub_stream, Format format,
                                  int buffer_size)
     : format_(format), sub_stream_(sub_stream), zerror_(Z_OK), byte_count_(0) {
@@ -96,6 +175,12 @@ int GzipInputStream::Inflate(int flush) {
   zcontext_.avail_out = output_buffer_length_;
   output_position_ = output_buffer_;
   int error = inflate(&zcontext_, flush);
+  if (error == Z_NEED_DICT && !dictionary_.empty()) {
+    error = inflateSetDictionary(
+        &zcontext_, reinterpret_cast<const Bytef*>(dictionary_.data()),
+        dictionary_.size());
+    if (error == Z_OK) error = inflate(&zcontext_, flush);
+  }
   return error;
 }
 
@@ -179,7 +264,8 @@ GzipOutputStream::Options::Options()
     : format(GZIP),
       buffer_size(kDefaultBufferSize),
       compression_level(Z_DEFAULT_COMPRESSION),
-      compression_strategy(Z_DEFAULT_STRATEGY) {}
+      compression_strategy(Z_DEFAULT_STRATEGY),
+      num_threads(1) {}
 
 GzipOutputStream::GzipOutputStream(ZeroCopyOutputStream* sub_stream) {
   Init(sub_stream, Options());
@@ -196,9 +282,23 @@ void GzipOutputStream::Init(ZeroCopyOutputStream* sub_stream,
   sub_data_ = NULL;
   sub_data_size_ = 0;
 
+  format_ = options.format;
+  compression_level_ = options.compression_level;
+  compression_strategy_ = options.compression_strategy;
+  num_threads_ = options.num_threads;
+  consumed_bytes_ = 0;
+  header_written_ = false;
+  check_ = options.format == GZIP ? crc32(0, Z_NULL, 0) : adler32(0, Z_NULL, 0);
+  has_dictionary_ = false;
+
   input_buffer_length_ = options.buffer_size;
-  input_buffer_ = operator new(input_buffer_length_);
-  ABSL_CHECK(input_buffer_ != NULL);
+  if (num_threads_ > 1) {
+    // Input goes to blocks_ instead.
+    input_buffer_ = nullptr;
+  } else {
+    input_buffer_ = operator new(input_buffer_length_);
+    ABSL_CHECK(input_buffer_ != NULL);
+  }
 
   zcontext_.zalloc = Z_NULL;
   zcontext_.zfree = Z_NULL;
@@ -210,6 +310,18 @@ void GzipOutputStream::Init(ZeroCopyOutputStream* sub_stream,
   zcontext_.avail_in = 0;
   zcontext_.total_in = 0;
   zcontext_.msg = NULL;
+  if (num_threads_ > 1) {
+    zerror_ = Z_OK;
+    if (options.format == ZLIB && !options.dictionary.empty()) {
+      AppendToWindow(&window_, options.dictionary);
+      has_dictionary_ = true;
+      dictionary_id_ = adler32(
+          adler32(0, Z_NULL, 0),
+          reinterpret_cast<const Bytef*>(options.dictionary.data()),
+          options.dictionary.size());
+    }
+    return;
+  }
   // default to GZIP format
   int windowBitsFormat = 16;
   if (options.format == ZLIB) {
@@ -219,6 +331,12 @@ void GzipOutputStream::Init(ZeroCopyOutputStream* sub_stream,
       deflateInit2(&zcontext_, options.compression_level, Z_DEFLATED,
                    /* windowBits */ 15 | windowBitsFormat,
                    /* memLevel (default) */ 8, options.compression_strategy);
+  if (zerror_ == Z_OK && options.format == ZLIB &&
+      !options.dictionary.empty()) {
+    zerror_ = deflateSetDictionary(
+        &zcontext_, reinterpret_cast<const Bytef*>(options.dictionary.data()),
+        options.dictionary.size());
+  }
 }
 
 GzipOutputStream::~GzipOutputStream() {
@@ -258,6 +376,23 @@ bool GzipOutputStream::Next(void** data, int* size) {
   if ((zerror_ != Z_OK) && (zerror_ != Z_BUF_ERROR)) {
     return false;
   }
+  if (num_threads_ > 1) {
+    if (blocks_.empty() || blocks_.back().size() == input_buffer_length_) {
+      if (blocks_.size() == static_cast<size_t>(num_threads_)) {
+        zerror_ = DeflateBlocks(/*finish=*/false);
+        if (zerror_ != Z_OK) {
+          return false;
+        }
+      }
+      blocks_.emplace_back();
+    }
+    std::string& block = blocks_.back();
+    size_t used = block.size();
+    block.resize(input_buffer_length_);
+    *data = &block[used];
+    *size = input_buffer_length_ - used;
+    return true;
+  }
   if (zcontext_.avail_in != 0) {
     zerror_ = Deflate(Z_NO_FLUSH);
     if (zerror_ != Z_OK) {
@@ -277,14 +412,33 @@ bool GzipOutputStream::Next(void** data, int* size) {
   return true;
 }
 void GzipOutputStream::BackUp(int count) {
+  if (num_threads_ > 1) {
+    ABSL_CHECK(!blocks_.empty());
+    ABSL_CHECK_GE(blocks_.back().size(), static_cast<size_t>(count));
+    blocks_.back().resize(blocks_.back().size() - count);
+    return;
+  }
   ABSL_CHECK_GE(zcontext_.avail_in, static_cast<uInt>(count));
   zcontext_.avail_in -= count;
 }
 int64_t GzipOutputStream::ByteCount() const {
+  if (num_threads_ > 1) {
+    int64_t count = consumed_bytes_;
+    for (const std::string& block : blocks_) count += block.size();
+    return count;
+  }
   return zcontext_.total_in + zcontext_.avail_in;
 }
 
 bool GzipOutputStream::Flush() {
+  if (num_threads_ > 1) {
+    if ((zerror_ != Z_OK) && (zerror_ != Z_BUF_ERROR)) {
+      return false;
+    }
+    // Every block ends on a byte boundary, as after a full flush.
+    zerror_ = DeflateBlocks(/*finish=*/false);
+    return zerror_ == Z_OK;
+  }
   zerror_ = Deflate(Z_FULL_FLUSH);
   // Return true if the flush succeeded or if it was a no-op.
   return (zerror_ == Z_OK) ||
@@ -296,6 +450,11 @@ bool GzipOutputStream::Close() {
   if ((zerror_ != Z_OK) && (zerror_ != Z_BUF_ERROR)) {
     return false;
   }
+  if (num_threads_ > 1) {
+    bool ok = DeflateBlocks(/*finish=*/true) == Z_OK && WriteTrailer();
+    zerror_ = Z_STREAM_END;
+    return ok;
+  }
   do {
     zerror_ = Deflate(Z_FINISH);
   } while (zerror_ == Z_OK);
@@ -305,6 +464,120 @@ bool GzipOutputStream::Close() {
   return ok;
 }
 
+int GzipOutputStream::DeflateBlocks(bool finish) {
+  if (finish && blocks_.empty()) {
+    // The stream still needs a final block.
+    blocks_.emplace_back();
+  }
+  // Each block is primed with the input before it, which may span several
+  // short blocks after flushes.
+  std::vector<std::string> windows(blocks_.size());
+  for (size_t i = 0; i < blocks_.size(); ++i) {
+    windows[i] = window_;
+    AppendToWindow(&window_, blocks_[i]);
+  }
+  std::vector<DeflatedBlock> results(blocks_.size());
+  auto deflate_block = [&](size_t i) {
+    DeflateBlock(blocks_[i], windows[i], finish && i + 1 == blocks_.size(),
+                 compression_level_, compression_strategy_, format_ == GZIP,
+                 &results[i]);
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < blocks_.size(); ++i) {
+    threads.emplace_back(deflate_block, i);
+  }
+  if (!blocks_.empty()) deflate_block(0);
+  for (std::thread& thread : threads) thread.join();
+
+  if (!header_written_) {
+    if (!WriteHeader()) return Z_BUF_ERROR;
+    header_written_ = true;
+  }
+  for (size_t i = 0; i < blocks_.size(); ++i) {
+    if (results[i].error != Z_OK) return results[i].error;
+    if (!WriteToSubStream(results[i].data.data(), results[i].data.size())) {
+      return Z_BUF_ERROR;
+    }
+    check_ = format_ == GZIP
+                 ? crc32_combine(check_, results[i].check, blocks_[i].size())
+                 : adler32_combine(check_, results[i].check,
+                                   blocks_[i].size());
+    consumed_bytes_ += blocks_[i].size();
+  }
+  blocks_.clear();
+  return Z_OK;
+}
+
+bool GzipOutputStream::WriteHeader() {
+  // The header fields are filled in the way zlib does.
+  int level = compression_level_ == Z_DEFAULT_COMPRESSION ? 6
+                                                          : compression_level_;
+  bool fastest = compression_strategy_ >= Z_HUFFMAN_ONLY || level < 2;
+  if (format_ == GZIP) {
+    uint8_t extra_flags = 0;
+    if (level == 9) {
+      extra_flags = 2;
+    } else if (fastest) {
+      extra_flags = 4;
+    }
+    // No file name or modification time, and an unknown OS.
+    const uint8_t header[10] = {0x1f, 0x8b, Z_DEFLATED, 0,           0,
+                                0,    0,    0,          extra_flags, 255};
+    return WriteToSubStream(header, sizeof(header));
+  }
+  int level_flags = 3;
+  if (fastest) {
+    level_flags = 0;
+  } else if (level < 6) {
+    level_flags = 1;
+  } else if (level == 6) {
+    level_flags = 2;
+  }
+  // Deflate with a 32kB window.
+  uint16_t header = (0x78 << 8) | (level_flags << 6);
+  if (has_dictionary_) header |= 0x20;
+  header += 31 - header % 31;
+  uint8_t bytes[6] = {static_cast<uint8_t>(header >> 8),
+                      static_cast<uint8_t>(header)};
+  if (!has_dictionary_) return WriteToSubStream(bytes, 2);
+  for (int i = 0; i < 4; ++i) {
+    bytes[2 + i] = static_cast<uint8_t>(dictionary_id_ >> (24 - 8 * i));
+  }
+  return WriteToSubStream(bytes, sizeof(bytes));
+}
+
+bool GzipOutputStream::WriteTrailer() {
+  uint8_t trailer[8];
+  if (format_ == GZIP) {
+    // CRC-32 and input size modulo 2^32, little-endian.
+    for (int i = 0; i < 4; ++i) {
+      trailer[i] = static_cast<uint8_t>(check_ >> (8 * i));
+      trailer[4 + i] = static_cast<uint8_t>(consumed_bytes_ >> (8 * i));
+    }
+    return WriteToSubStream(trailer, 8);
+  }
+  // Adler-32, big-endian.
+  for (int i = 0; i < 4; ++i) {
+    trailer[i] = static_cast<uint8_t>(check_ >> (24 - 8 * i));
+  }
+  return WriteToSubStream(trailer, 4);
+}
+
+bool GzipOutputStream::WriteToSubStream(const void* data, size_t size) {
+  const char* from = static_cast<const char*>(data);
+  while (size > 0) {
+    void* buffer;
+    int buffer_size;
+    if (!sub_stream_->Next(&buffer, &buffer_size)) return false;
+    size_t n = std::min(size, static_cast<size_t>(buffer_size));
+    memcpy(buffer, from, n);
+    sub_stream_->BackUp(buffer_size - n);
+    from += n;
+    size -= n;
+  }
+  return true;
+}
+
 }  // namespace io
 }  // namespace protobuf
 }  // namespace google
@@ -20,6 +20,11 @@
 #ifndef GOOGLE_PROTOBUF_IO_GZIP_STREAM_H__
 #define GOOGLE_PROTOBUF_IO_GZIP_STREAM_H__
 
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "google/protobuf/stubs/common.h"
 #include "google/protobuf/io/zero_copy_stream.h"
 #include "google/protobuf/port.h"
@@ -58,6 +63,13 @@ class PROTOBUF_EXPORT GzipInputStream final : public ZeroCopyInputStream {
   inline const char* ZlibErrorMessage() const { return zcontext_.msg; }
   inline int ZlibErrorCode() const { return zerror_; }
 
+  // Sets the preset dictionary for ZLIB streams that were compressed with
+  // GzipOutputStream::Options::dictionary. Must be called before the first
+  // Next().
+  void SetDictionary(std::string dictionary) {
+    dictionary_ = std::move(dictionary);
+  }
+
   // implements ZeroCopyInputStream ----------------------------------
   bool Next(const void** data, int* size) override;
   void BackUp(int count) override;
@@ -76,6 +88,7 @@ class PROTOBUF_EXPORT GzipInputStream final : public ZeroCopyInputStream {
   void* output_position_;
   size_t output_buffer_length_;
   int64_t byte_count_;
+  std::string dictionary_;
 
   int Inflate(int flush);
   void DoNextOutput(const void** data, int* size);
@@ -108,6 +121,19 @@ class PROTOBUF_EXPORT GzipOutputStream final : public ZeroCopyOutputStream {
     // zlib.h for definitions of these constants.
     int compression_strategy;
 
+    // A preset dictionary of byte strings that are likely to appear in the
+    // data, with the most common ones at the end. It helps most with small
+    // inputs such as single protobuf records. Only used with the ZLIB format;
+    // the reader needs the same dictionary (GzipInputStream::SetDictionary).
+    std::string dictionary;
+
+    // How many threads compress the stream.  Defaults to 1.  With more, the
+    // input is cut into blocks of buffer_size bytes which are deflated
+    // independently, up to num_threads at a time, each primed with the 32kB
+    // of input before it, as pigz does.  The result is still one ordinary
+    // stream but slightly larger; use a buffer_size of 128kB or more.
+    int num_threads;
+
     Options();  // Initializes with default values.
   };
 
@@ -168,6 +194,33 @@ class PROTOBUF_EXPORT GzipOutputStream final : public ZeroCopyOutputStream {
   // Takes zlib flush mode.
   // Returns zlib error code.
   int Deflate(int flush);
+
+  // Used instead of zcontext_ when compressing on several threads.
+  Format format_;
+  int compression_level_;
+  int compression_strategy_;
+  int num_threads_;
+  // Filled input blocks waiting to be compressed.  The last one may still be
+  // handed out by Next().
+  std::vector<std::string> blocks_;
+  // The last 32kB of input, which primes the next block.
+  std::string window_;
+  // CRC-32 (GZIP) or Adler-32 (ZLIB) of the input compressed so far.
+  uLong check_;
+  // Adler-32 of the preset dictionary, if there is one.
+  bool has_dictionary_;
+  uLong dictionary_id_;
+  // Input bytes already compressed.
+  int64_t consumed_bytes_;
+  bool header_written_;
+
+  // Compresses all of blocks_ in parallel and writes the result, ending the
+  // stream if `finish`.  Returns zlib error code.
+  int DeflateBlocks(bool finish);
+  // Writes the header or trailer of the stream.
+  bool WriteHeader();
+  bool WriteTrailer();
+  bool WriteToSubStream(const void* data, size_t size);
 };
 
 }  // namespace io
@@ -15,7 +15,9 @@
 
 #include <cstddef>
 #include <functional>
+#include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -74,6 +76,9 @@ struct Printer::Format {
 
   // Whether this is a multiline raw string, according to internal heuristics.
   bool is_raw_string = false;
+
+  // The template that the chunks point into, if this Format owns it.
+  std::string text;
 };
 
 Printer::Format Printer::TokenizeFormat(absl::string_view format_string,
@@ -282,6 +287,42 @@ Printer::Format Printer::TokenizeFormat(absl::string_view format_string,
   return format;
 }
 
+namespace {
+// Bounds the memory held by a printer that is fed many distinct templates,
+// such as ones assembled at runtime.
+constexpr size_t kMaxCachedFormats = 1024;
+}  // namespace
+
+const Printer::Format& Printer::CachedTokenizeFormat(
+    absl::string_view format_string, const PrintOptions& options,
+    Format& scratch) {
+  // Whether the output is at the start of a line only matters when stripping
+  // raw string indentation.
+  const bool strip = options.strip_raw_string_indentation;
+  auto it = format_cache_.find(
+      std::make_tuple(format_string, strip, strip && at_start_of_line_));
+  if (it != format_cache_.end()) return *it->second;
+
+  if (format_cache_.size() >= kMaxCachedFormats) {
+    scratch = TokenizeFormat(format_string, options);
+    return scratch;
+  }
+
+  // Tokenizes a copy owned by the cached Format, so that the chunks outlive
+  // `format_string`.
+  auto format = std::make_unique<Format>();
+  format->text = std::string(format_string);
+  Format tokenized = TokenizeFormat(format->text, options);
+  format->lines = std::move(tokenized.lines);
+  format->is_raw_string = tokenized.is_raw_string;
+  const Format& result = *format;
+  format_cache_.emplace(
+      std::make_tuple(absl::string_view(result.text), strip,
+                      strip && at_start_of_line_),
+      std::move(format));
+  return result;
+}
+
 constexpr absl::string_view Printer::kProtocCodegenTrace;
 
 Printer::Printer(ZeroCopyOutputStream* output) : Printer(output, Options{}) {}
@@ -302,6 +343,8 @@ Printer::Printer(ZeroCopyOutputStream* output, char variable_delimiter,
                  AnnotationCollector* annotation_collector)
     : Printer(output, Options{variable_delimiter, annotation_collector}) {}
 
+Printer::~Printer() = default;
+
 absl::string_view Printer::LookupVar(absl::string_view var) {
   auto result = LookupInFrameStack(var, absl::MakeSpan(var_lookups_));
   ABSL_CHECK(result.has_value()) << "could not find " << var;
@@ -528,7 +571,8 @@ void Printer::PrintImpl(absl::string_view format,
     substitutions_.clear();
   }
 
-  auto fmt = TokenizeFormat(format, opts);
+  Format uncached;
+  const Format& fmt = CachedTokenizeFormat(format, opts, uncached);
   PrintCodegenTrace(opts.loc);
 
   size_t arg_index = 0;
@@ -17,7 +17,9 @@
 #include <cstddef>
 #include <functional>
 #include <initializer_list>
+#include <memory>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -524,6 +526,7 @@ class PROTOBUF_EXPORT Printer {
 
   Printer(const Printer&) = delete;
   Printer& operator=(const Printer&) = delete;
+  ~Printer();
 
   // Pushes a new variable lookup frame that stores `vars` by reference.
   //
@@ -721,6 +724,13 @@ class PROTOBUF_EXPORT Printer {
   Format TokenizeFormat(absl::string_view format_string,
                         const PrintOptions& options);
 
+  // Returns the tokenization of `format_string`, reusing the one from an
+  // earlier call with the same template if there was one. `scratch` holds the
+  // result when it is not cached.
+  const Format& CachedTokenizeFormat(absl::string_view format_string,
+                                     const PrintOptions& options,
+                                     Format& scratch);
+
   // Emit an annotation for the range defined by the given substitution
   // variables, as set by the most recent call to PrintImpl() that set
   // `use_substitution_map` to true.
@@ -795,6 +805,13 @@ class PROTOBUF_EXPORT Printer {
   // indents are inserted. These are keys that refer to the beginning of the
   // current line.
   std::vector<std::string> line_start_variables_;
+
+  // Templates tokenized by CachedTokenizeFormat(), keyed by their text and by
+  // the state that changes how they tokenize. Each key points into the text
+  // owned by its Format.
+  absl::flat_hash_map<std::tuple<absl::string_view, bool, bool>,
+                      std::unique_ptr<Format>>
+      format_cache_;
 };
 
 // Options for PrintImpl().
@@ -962,6 +962,34 @@ TEST_F(PrinterTest, EmitCallbacks) {
             "};\n");
 }
 
+TEST_F(PrinterTest, EmitReusesTemplates) {
+  {
+    Printer printer(output());
+    for (int i = 0; i < 3; ++i) {
+      printer.Emit({{"i", i}}, R"cc(
+        int x$i$;
+      )cc");
+    }
+    // Templates that are not literals may be overwritten in place between
+    // calls.
+    std::string format = "a$v$\n";
+    printer.Emit({{"v", 1}}, format);
+    format[0] = 'b';
+    printer.Emit({{"v", 2}}, format);
+    printer.Print("$v$\n", "v", "c");
+    printer.Print("$v$\n", "v", "d");
+  }
+
+  EXPECT_EQ(written(),
+            "int x0;\n"
+            "int x1;\n"
+            "int x2;\n"
+            "a1\n"
+            "b2\n"
+            "c\n"
+            "d\n");
+}
+
 TEST_F(PrinterTest, PreserveNewlinesThroughEmits) {
   {
     Printer printer(output());
@@ -10,6 +10,7 @@
 #include <float.h>  // FLT_DIG and DBL_DIG
 
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -155,6 +156,27 @@ void DelocalizeRadix(char *buffer) {
   }
 }
 
+// Writes the integral `value`, whose magnitude must be below 1e18, the way
+// "%g" does with enough precision not to need an exponent. Integral values are
+// common and can skip formatting and parsing the result again.
+char *IntegralToBuffer(double value, char *buffer) {
+  char *out = buffer;
+  if (std::signbit(value)) {
+    *out++ = '-';
+    value = -value;
+  }
+  uint64_t n = static_cast<uint64_t>(value);
+  char digits[20];
+  int len = 0;
+  do {
+    digits[len++] = static_cast<char>('0' + n % 10);
+    n /= 10;
+  } while (n != 0);
+  while (len > 0) *out++ = digits[--len];
+  *out = '\0';
+  return buffer;
+}
+
 bool safe_strtof(const char *str, float *value) {
   char *endptr;
   errno = 0;  // errno only gets set on errors
@@ -178,6 +200,9 @@ char *FloatToBuffer(float value, char *buffer) {
   } else if (std::isnan(value)) {
     absl::SNPrintF(buffer, kFloatToBufferSize, "nan");
     return buffer;
+  } else if (std::abs(value) < 1e6f && value == std::trunc(value)) {
+    // "%.6g" prints these exactly and without an exponent.
+    return IntegralToBuffer(value, buffer);
   }
 
   int snprintf_result =
@@ -216,6 +241,9 @@ char *DoubleToBuffer(double value, char *buffer) {
   } else if (std::isnan(value)) {
     absl::SNPrintF(buffer, kDoubleToBufferSize, "nan");
     return buffer;
+  } else if (std::abs(value) < 1e15 && value == std::trunc(value)) {
+    // "%.15g" prints these exactly and without an exponent.
+    return IntegralToBuffer(value, buffer);
   }
 
   int snprintf_result =
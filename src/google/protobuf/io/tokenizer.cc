@@ -243,17 +243,21 @@ void Tokenizer::set_report_newlines(bool report) {
 // -------------------------------------------------------------------
 // Internal helpers.
 
-void Tokenizer::NextChar() {
-  // Update our line and column counters based on the character being
-  // consumed.
-  if (current_char_ == '\n') {
+inline void Tokenizer::UpdateLineAndColumn(char c) {
+  if (c == '\n') {
     ++line_;
     column_ = 0;
-  } else if (current_char_ == '\t') {
+  } else if (c == '\t') {
     column_ += kTabWidth - column_ % kTabWidth;
   } else {
     ++column_;
   }
+}
+
+void Tokenizer::NextChar() {
+  // Update our line and column counters based on the character being
+  // consumed.
+  UpdateLineAndColumn(current_char_);
 
   // Advance to the next character.
   ++buffer_pos_;
@@ -353,9 +357,19 @@ inline bool Tokenizer::TryConsume(char c) {
   }
 }
 
+template <typename CharacterClass>
+inline void Tokenizer::SkipInBuffer() {
+  while (buffer_pos_ + 1 < buffer_size_ &&
+         CharacterClass::InClass(buffer_[buffer_pos_ + 1])) {
+    UpdateLineAndColumn(current_char_);
+    current_char_ = buffer_[++buffer_pos_];
+  }
+}
+
 template <typename CharacterClass>
 inline void Tokenizer::ConsumeZeroOrMore() {
   while (CharacterClass::InClass(current_char_)) {
+    SkipInBuffer<CharacterClass>();
     NextChar();
   }
 }
@@ -365,9 +379,7 @@ inline void Tokenizer::ConsumeOneOrMore(const char* error) {
   if (!CharacterClass::InClass(current_char_)) {
     AddError(error);
   } else {
-    do {
-      NextChar();
-    } while (CharacterClass::InClass(current_char_));
+    ConsumeZeroOrMore<CharacterClass>();
   }
 }
 
@@ -433,6 +445,16 @@ void Tokenizer::ConsumeString(char delimiter) {
           NextChar();
           return;
         }
+        // Skip ahead to the next character the switch has to look at.
+        while (buffer_pos_ + 1 < buffer_size_) {
+          const char next = buffer_[buffer_pos_ + 1];
+          if (next == delimiter || next == '\\' || next == '\n' ||
+              next == '\0') {
+            break;
+          }
+          UpdateLineAndColumn(current_char_);
+          current_char_ = buffer_[++buffer_pos_];
+        }
         NextChar();
         break;
       }
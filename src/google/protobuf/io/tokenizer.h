@@ -304,6 +304,17 @@ class PROTOBUF_EXPORT Tokenizer {
   // Consume this character and advance to the next one.
   void NextChar();
 
+  // Updates line_ and column_ for consuming the character c.
+  inline void UpdateLineAndColumn(char c);
+
+  // Advances to the character before the next one that is not of the given
+  // class, or to the last character of the buffer, whichever comes first.
+  // Unlike NextChar(), this does not check for the end of the buffer for
+  // every character.  current_char_ must be of the given class, and still is
+  // when this returns; the caller then consumes it with NextChar().
+  template <typename CharacterClass>
+  inline void SkipInBuffer();
+
   // Read a new buffer from the input.
   void Refresh();
 
@@ -404,6 +404,17 @@ MultiTokenCase kMultiTokenCases[] = {
          {Tokenizer::TYPE_END, "", 0, 16, 16},
      }},
 
+    // Test runs of characters which span input buffers, and string literals
+    // with escapes and the other quote character.
+    {"long_identifier_0123456789 \"a 'b' \\\"c\\\" d\" 'e\\'' 1234567",
+     {
+         {Tokenizer::TYPE_IDENTIFIER, "long_identifier_0123456789", 0, 0, 26},
+         {Tokenizer::TYPE_STRING, "\"a 'b' \\\"c\\\" d\"", 0, 27, 42},
+         {Tokenizer::TYPE_STRING, "'e\\''", 0, 43, 48},
+         {Tokenizer::TYPE_INTEGER, "1234567", 0, 49, 56},
+         {Tokenizer::TYPE_END, "", 0, 56, 56},
+     }},
+
     // Test that line comments are ignored.
     {"foo // This is a comment\n"
      "bar // This is another comment",
@@ -15,15 +15,27 @@
 #include <sys/types.h>
 #include <unistd.h>
 #endif
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/uio.h>
+#endif
 #include <errno.h>
+#include <limits.h>
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <istream>
+#include <limits>
+#include <memory>
 #include <ostream>
+#include <vector>
 
 #include "google/protobuf/stubs/common.h"
+#include "absl/crc/crc32c.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
+#include "absl/strings/string_view.h"
 #include "google/protobuf/io/io_win32.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
 
@@ -87,6 +99,13 @@ FileInputStream::CopyingFileInputStream::CopyingFileInputStream(
   flags &= ~O_NONBLOCK;
   fcntl(file_, F_SETFL, flags);
 #endif
+#ifdef POSIX_FADV_SEQUENTIAL
+  // We only ever read forward, so let the kernel read ahead more aggressively;
+  // the next blocks are then fetched from disk while the caller parses the
+  // current one.  This is only a hint, and it fails harmlessly (ESPIPE) on
+  // pipes and sockets.
+  posix_fadvise(file_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
 }
 
 FileInputStream::CopyingFileInputStream::~CopyingFileInputStream() {
@@ -148,6 +167,112 @@ int FileInputStream::CopyingFileInputStream::Skip(int count) {
 
 // ===================================================================
 
+#ifndef _WIN32
+
+MmapInputStream::MmapInputStream(int file_descriptor, int64_t window_size)
+    : file_(file_descriptor) {
+  const int64_t page_size = sysconf(_SC_PAGESIZE);
+  if (window_size < 0) {
+    window_size = sizeof(void*) >= 8 ? std::numeric_limits<int64_t>::max()
+                                     : int64_t{64} << 20;
+  }
+  window_size_ = std::max(page_size, window_size);
+  if (window_size_ != std::numeric_limits<int64_t>::max()) {
+    window_size_ = (window_size_ + page_size - 1) / page_size * page_size;
+  }
+}
+
+MmapInputStream::~MmapInputStream() { Unmap(); }
+
+void MmapInputStream::Unmap() {
+  if (window_ != nullptr) {
+    munmap(window_, window_length_);
+    window_ = nullptr;
+    window_length_ = 0;
+  }
+}
+
+bool MmapInputStream::MapWindow() {
+  Unmap();
+  const int64_t page_size = sysconf(_SC_PAGESIZE);
+  window_offset_ = position_ / page_size * page_size;
+  window_length_ = std::min(window_size_, file_size_ - window_offset_);
+  void* mapping = mmap(nullptr, window_length_, PROT_READ, MAP_PRIVATE, file_,
+                       window_offset_);
+  if (mapping == MAP_FAILED) {
+    errno_ = errno;
+    window_length_ = 0;
+    return false;
+  }
+  window_ = static_cast<char*>(mapping);
+  madvise(window_, window_length_, MADV_SEQUENTIAL);
+  return true;
+}
+
+bool MmapInputStream::Next(const void** data, int* size) {
+  if (errno_ != 0) return false;
+  if (file_size_ < 0) {
+    struct stat info;
+    start_ = position_ = lseek(file_, 0, SEEK_CUR);
+    if (start_ < 0 || fstat(file_, &info) != 0) {
+      errno_ = errno;
+      return false;
+    }
+    if (!S_ISREG(info.st_mode)) {
+      errno_ = ENODEV;
+      return false;
+    }
+    file_size_ = info.st_size;
+  }
+  if (position_ >= file_size_) {
+    last_returned_size_ = 0;
+    return false;
+  }
+  if (position_ < window_offset_ ||
+      position_ >= window_offset_ + window_length_) {
+    if (!MapWindow()) return false;
+  }
+  const int64_t available = window_offset_ + window_length_ - position_;
+  last_returned_size_ = static_cast<int>(
+      std::min<int64_t>(available, std::numeric_limits<int>::max()));
+  *data = window_ + (position_ - window_offset_);
+  *size = last_returned_size_;
+  position_ += last_returned_size_;
+  return true;
+}
+
+void MmapInputStream::BackUp(int count) {
+  ABSL_CHECK_LE(count, last_returned_size_)
+      << "BackUp() can't back up more than the last Next() returned.";
+  ABSL_CHECK_GE(count, 0);
+  position_ -= count;
+  last_returned_size_ = 0;
+}
+
+bool MmapInputStream::Skip(int count) {
+  ABSL_CHECK_GE(count, 0);
+  last_returned_size_ = 0;
+  if (file_size_ < 0) {
+    // Let Next() find the file size and starting offset.
+    const void* data;
+    int size;
+    if (!Next(&data, &size)) return count == 0 && errno_ == 0;
+    BackUp(size);
+  }
+  if (count > file_size_ - position_) {
+    position_ = file_size_;
+    return false;
+  }
+  position_ += count;
+  return true;
+}
+
+int64_t MmapInputStream::ByteCount() const { return position_ - start_; }
+
+#endif  // !_WIN32
+
+// ===================================================================
+
 FileOutputStream::FileOutputStream(int file_descriptor, int block_size)
     : CopyingOutputStreamAdaptor(&copying_output_, block_size),
       copying_output_(file_descriptor) {}
@@ -226,6 +351,168 @@ bool FileOutputStream::CopyingFileOutputStream::Write(const void* buffer,
 
 // ===================================================================
 
+VectoredFileOutputStream::VectoredFileOutputStream(int file_descriptor,
+                                                   int block_size)
+    : file_(file_descriptor),
+      block_size_(block_size > 0 ? block_size : kDefaultBlockSize) {}
+
+VectoredFileOutputStream::~VectoredFileOutputStream() {
+  Flush();
+  if (close_on_delete_ && !is_closed_) {
+    if (!Close()) {
+      ABSL_LOG(ERROR) << "close() failed: " << strerror(errno_);
+    }
+  }
+}
+
+bool VectoredFileOutputStream::Close() {
+  ABSL_CHECK(!is_closed_);
+  bool flush_succeeded = Flush();
+
+  is_closed_ = true;
+  if (close_no_eintr(file_) != 0) {
+    errno_ = errno;
+    return false;
+  }
+  return flush_succeeded;
+}
+
+bool VectoredFileOutputStream::Flush() {
+  if (is_closed_ || errno_ != 0) return false;
+  bool ok = WritePieces();
+  flushed_bytes_ += buffered_bytes_;
+  buffered_bytes_ = 0;
+  pieces_.clear();
+  blocks_used_ = 0;
+  block_pos_ = 0;
+  return ok;
+}
+
+bool VectoredFileOutputStream::Next(void** data, int* size) {
+  if (is_closed_ || errno_ != 0) return false;
+  if (blocks_used_ == 0 || block_pos_ == block_size_) {
+    if ((blocks_used_ == kMaxBlocks || pieces_.size() >= kMaxPieces) &&
+        !Flush()) {
+      return false;
+    }
+    if (blocks_used_ == blocks_.size()) {
+      blocks_.emplace_back(new uint8_t[block_size_]);
+    }
+    ++blocks_used_;
+    block_pos_ = 0;
+  }
+  uint8_t* buffer = blocks_[blocks_used_ - 1].get() + block_pos_;
+  *data = buffer;
+  *size = block_size_ - block_pos_;
+  AddPiece(buffer, *size);
+  block_pos_ = block_size_;
+  buffered_bytes_ += *size;
+  return true;
+}
+
+void VectoredFileOutputStream::BackUp(int count) {
+  if (count == 0) return;
+  ABSL_CHECK(!pieces_.empty()) << " BackUp() can only be called after Next().";
+  ABSL_CHECK_LE(count, block_pos_)
+      << " Can't back up over more bytes than were returned by the last call"
+         " to Next().";
+  ABSL_CHECK_GE(count, 0) << " Parameter to BackUp() can't be negative.";
+  Piece& last = pieces_.back();
+  ABSL_DCHECK_GE(last.size, static_cast<size_t>(count));
+  last.size -= count;
+  if (last.size == 0) pieces_.pop_back();
+  block_pos_ -= count;
+  buffered_bytes_ -= count;
+}
+
+int64_t VectoredFileOutputStream::ByteCount() const {
+  return flushed_bytes_ + buffered_bytes_;
+}
+
+bool VectoredFileOutputStream::WriteAliasedRaw(const void* data, int size) {
+  if (is_closed_ || errno_ != 0) return false;
+  if (size <= 0) return size == 0;
+  if (pieces_.size() >= kMaxPieces && !Flush()) return false;
+  AddPiece(static_cast<const uint8_t*>(data), size);
+  buffered_bytes_ += size;
+  return true;
+}
+
+void VectoredFileOutputStream::AddPiece(const uint8_t* data, size_t size) {
+  if (!pieces_.empty() &&
+      pieces_.back().data + pieces_.back().size == data) {
+    pieces_.back().size += size;
+    return;
+  }
+  pieces_.push_back({data, size});
+}
+
+bool VectoredFileOutputStream::WritePieces() {
+#ifndef _WIN32
+#ifdef IOV_MAX
+  constexpr size_t kMaxIov = IOV_MAX;
+#else
+  constexpr size_t kMaxIov = 1024;
+#endif
+  std::vector<iovec> iov(pieces_.size());
+  for (size_t i = 0; i < pieces_.size(); ++i) {
+    iov[i].iov_base = const_cast<uint8_t*>(pieces_[i].data);
+    iov[i].iov_len = pieces_[i].size;
+  }
+  size_t next = 0;
+  while (next < iov.size()) {
+    const int count = static_cast<int>(std::min(iov.size() - next, kMaxIov));
+    ssize_t bytes;
+    do {
+      bytes = writev(file_, &iov[next], count);
+    } while (bytes < 0 && errno == EINTR);
+
+    if (bytes <= 0) {
+      // Write error.  As in FileOutputStream, a zero-byte write is treated
+      // as an error rather than retried.
+      if (bytes < 0) {
+        errno_ = errno;
+      }
+      return false;
+    }
+    // Skip what was written; the last vector may be written partially.
+    size_t written = static_cast<size_t>(bytes);
+    while (written > 0) {
+      if (written >= iov[next].iov_len) {
+        written -= iov[next].iov_len;
+        ++next;
+      } else {
+        iov[next].iov_base = static_cast<char*>(iov[next].iov_base) + written;
+        iov[next].iov_len -= written;
+        written = 0;
+      }
+    }
+  }
+#else   // _WIN32
+  for (const Piece& piece : pieces_) {
+    size_t total_written = 0;
+    while (total_written < piece.size) {
+      int bytes;
+      do {
+        bytes = write(file_, piece.data + total_written,
+                      static_cast<int>(std::min<size_t>(
+                          piece.size - total_written, INT_MAX)));
+      } while (bytes < 0 && errno == EINTR);
+      if (bytes <= 0) {
+        if (bytes < 0) {
+          errno_ = errno;
+        }
+        return false;
+      }
+      total_written += bytes;
+    }
+  }
+#endif  // !_WIN32
+  return true;
+}
+
+// ===================================================================
+
 IstreamInputStream::IstreamInputStream(std::istream* input, int block_size)
     : copying_input_(input), impl_(&copying_input_, block_size) {}
 
@@ -342,6 +629,53 @@ int64_t ConcatenatingInputStream::ByteCount() const {
   }
 }
 
+// ===================================================================
+
+bool Crc32cInputStream::Next(const void** data, int* size) {
+  crc_ = absl::ExtendCrc32c(crc_, pending_);
+  pending_ = absl::string_view();
+  if (!input_->Next(data, size)) return false;
+  pending_ = absl::string_view(static_cast<const char*>(*data), *size);
+  return true;
+}
+
+void Crc32cInputStream::BackUp(int count) {
+  ABSL_DCHECK_LE(static_cast<size_t>(count), pending_.size());
+  input_->BackUp(count);
+  pending_.remove_suffix(count);
+}
+
+bool Crc32cInputStream::Skip(int count) {
+  ABSL_DCHECK_GE(count, 0);
+  // The skipped bytes are part of the checksum, so they are read through
+  // Next() like the others.
+  const void* data;
+  int size;
+  while (count > 0) {
+    if (!Next(&data, &size)) return false;
+    if (size > count) {
+      BackUp(size - count);
+      return true;
+    }
+    count -= size;
+  }
+  return true;
+}
+
+bool Crc32cOutputStream::Next(void** data, int* size) {
+  crc_ = absl::ExtendCrc32c(crc_, pending_);
+  pending_ = absl::string_view();
+  if (!output_->Next(data, size)) return false;
+  pending_ = absl::string_view(static_cast<const char*>(*data), *size);
+  return true;
+}
+
+void Crc32cOutputStream::BackUp(int count) {
+  ABSL_DCHECK_LE(static_cast<size_t>(count), pending_.size());
+  output_->BackUp(count);
+  pending_.remove_suffix(count);
+}
+
 
 // ===================================================================
 
@@ -17,10 +17,16 @@
 #ifndef GOOGLE_PROTOBUF_IO_ZERO_COPY_STREAM_IMPL_H__
 #define GOOGLE_PROTOBUF_IO_ZERO_COPY_STREAM_IMPL_H__
 
+#include <cstddef>
+#include <cstdint>
 #include <iosfwd>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "google/protobuf/stubs/common.h"
+#include "absl/crc/crc32c.h"
+#include "absl/strings/string_view.h"
 #include "google/protobuf/io/zero_copy_stream.h"
 #include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 
@@ -39,6 +45,10 @@ namespace io {
 // The latter will introduce an extra layer of buffering, harming performance.
 // Also, it's conceivable that FileInputStream could someday be enhanced
 // to use zero-copy file descriptors on OSs which support them.
+//
+// Where the OS supports it, FileInputStream advises the kernel that the file
+// will be read sequentially, so that read-ahead fetches the next blocks while
+// the current one is being parsed.
 class PROTOBUF_EXPORT FileInputStream final : public ZeroCopyInputStream {
  public:
   // Creates a stream that reads from the given Unix file descriptor.
@@ -110,6 +120,61 @@ class PROTOBUF_EXPORT FileInputStream final : public ZeroCopyInputStream {
 
 // ===================================================================
 
+#ifndef _WIN32
+// A ZeroCopyInputStream which maps a regular file into memory, so that Next()
+// returns the file's contents in place instead of copying them into a buffer
+// like FileInputStream does.  Reading starts at the file descriptor's current
+// offset.  Pipes, sockets and other descriptors that cannot be mapped make
+// the first Next() fail with GetErrno() set; use FileInputStream for those.
+//
+// The file is mapped in windows of window_size bytes, rounded up to whole
+// pages.  By default the whole file is one window on 64-bit targets, and
+// windows are 64MB on 32-bit targets to conserve address space.  Windows are
+// advised for sequential access so the kernel reads ahead of the parser.
+//
+// Combined with an aliasing parse, a message parsed from this stream may keep
+// pointers into the mapping, which is unmapped when the stream is destroyed.
+class PROTOBUF_EXPORT MmapInputStream final : public ZeroCopyInputStream {
+ public:
+  // Creates a stream that maps the given Unix file descriptor.  The
+  // descriptor is not closed by the stream.
+  explicit MmapInputStream(int file_descriptor, int64_t window_size = -1);
+  MmapInputStream(const MmapInputStream&) = delete;
+  MmapInputStream& operator=(const MmapInputStream&) = delete;
+  ~MmapInputStream() override;
+
+  // If an I/O error has occurred on this file descriptor, this is the
+  // errno from that error.  Otherwise, this is zero.  Once an error
+  // occurs, the stream is broken and all subsequent operations will
+  // fail.
+  int GetErrno() const { return errno_; }
+
+  // implements ZeroCopyInputStream ----------------------------------
+  bool Next(const void** data, int* size) override;
+  void BackUp(int count) override;
+  bool Skip(int count) override;
+  int64_t ByteCount() const override;
+
+ private:
+  // Maps the window that contains position_.  Returns false on error.
+  bool MapWindow();
+  void Unmap();
+
+  const int file_;
+  int64_t window_size_;
+  int64_t start_ = 0;      // File offset at which reading started.
+  int64_t position_ = 0;   // File offset of the next byte to return.
+  int64_t file_size_ = -1;  // Determined on the first Next() or Skip().
+  char* window_ = nullptr;
+  int64_t window_offset_ = 0;  // File offset of window_[0].
+  int64_t window_length_ = 0;
+  int last_returned_size_ = 0;
+  int errno_ = 0;
+};
+
+// ===================================================================
+#endif  // !_WIN32
+
 // A ZeroCopyOutputStream which writes to a file descriptor.
 //
 // FileOutputStream is preferred over using an ofstream with
@@ -179,6 +244,97 @@ class PROTOBUF_EXPORT FileOutputStream final
 
 // ===================================================================
 
+// A ZeroCopyOutputStream which writes to a file descriptor with vectored I/O.
+//
+// Unlike FileOutputStream, this stream supports aliasing: with
+// CodedOutputStream::EnableAliasing(true), large string and bytes fields are
+// recorded by reference instead of being copied into the stream's buffers.
+// Buffered data and the referenced data are handed to the kernel together in
+// one writev() call per flush, so large blobs are copied once, into the kernel.
+//
+// Aliased data must stay valid until it has been written, i.e. until the next
+// Flush() or Close(), or until the stream is destroyed. The stream flushes on
+// its own once it holds a bounded number of buffers or references.
+class PROTOBUF_EXPORT VectoredFileOutputStream final
+    : public ZeroCopyOutputStream {
+ public:
+  // Creates a stream that writes to the given Unix file descriptor.
+  // If a block_size is given, it specifies the size of the buffers
+  // that should be returned by Next().  Otherwise, a reasonable default
+  // is used.
+  explicit VectoredFileOutputStream(int file_descriptor, int block_size = -1);
+  VectoredFileOutputStream(const VectoredFileOutputStream&) = delete;
+  VectoredFileOutputStream& operator=(const VectoredFileOutputStream&) =
+      delete;
+
+  ~VectoredFileOutputStream() override;
+
+  // Writes all buffered and referenced data to the file.  Returns false if
+  // an error occurs; use GetErrno() to examine the error.
+  bool Flush();
+
+  // Flushes any buffers and closes the underlying file.  Returns false if
+  // an error occurs during the process; use GetErrno() to examine the error.
+  // Even if an error occurs, the file descriptor is closed when this returns.
+  bool Close();
+
+  // By default, the file descriptor is not closed when the stream is
+  // destroyed.  Call SetCloseOnDelete(true) to change that.  WARNING:
+  // This leaves no way for the caller to detect if close() fails.  If
+  // detecting close() errors is important to you, you should arrange
+  // to close the descriptor yourself.
+  void SetCloseOnDelete(bool value) { close_on_delete_ = value; }
+
+  // If an I/O error has occurred on this file descriptor, this is the
+  // errno from that error.  Otherwise, this is zero.  Once an error
+  // occurs, the stream is broken and all subsequent operations will
+  // fail.
+  int GetErrno() const { return errno_; }
+
+  // implements ZeroCopyOutputStream ---------------------------------
+  bool Next(void** data, int* size) override;
+  void BackUp(int count) override;
+  int64_t ByteCount() const override;
+  bool WriteAliasedRaw(const void* data, int size) override;
+  bool AllowsAliasing() const override { return true; }
+
+ private:
+  static constexpr int kDefaultBlockSize = 8192;
+  // Buffers and references held before the stream flushes on its own.
+  static constexpr size_t kMaxBlocks = 8;
+  static constexpr size_t kMaxPieces = 1024;
+
+  // A contiguous range of output, either in one of `blocks_` or aliased.
+  struct Piece {
+    const uint8_t* data;
+    size_t size;
+  };
+
+  // Appends a piece, extending the last one if `data` directly follows it.
+  void AddPiece(const uint8_t* data, size_t size);
+  // Writes out all of `pieces_`.
+  bool WritePieces();
+
+  const int file_;
+  const int block_size_;
+  bool close_on_delete_ = false;
+  bool is_closed_ = false;
+  // The errno of the I/O error, if one has occurred.  Otherwise, zero.
+  int errno_ = 0;
+
+  // Buffers returned by Next(); they are reused after each flush.
+  std::vector<std::unique_ptr<uint8_t[]>> blocks_;
+  // Number of `blocks_` in use; the last of them is the current one.
+  size_t blocks_used_ = 0;
+  // Bytes of the current block handed out by Next().
+  int block_pos_ = 0;
+  std::vector<Piece> pieces_;
+  int64_t flushed_bytes_ = 0;
+  int64_t buffered_bytes_ = 0;
+};
+
+// ===================================================================
+
 // A ZeroCopyInputStream which reads from a C++ istream.
 //
 // Note that for reading files (or anything represented by a file descriptor),
@@ -302,6 +458,70 @@ class PROTOBUF_EXPORT ConcatenatingInputStream final
 
 // ===================================================================
 
+// A ZeroCopyInputStream which computes the CRC32C of the bytes read from
+// another stream, so that a record can be verified while it is parsed
+// instead of in a separate pass over it.  Each buffer is checksummed when the
+// next one is requested, right after it was parsed and while it is still in
+// cache.  Bytes skipped with Skip() are read and count as consumed.
+class PROTOBUF_EXPORT Crc32cInputStream final : public ZeroCopyInputStream {
+ public:
+  // |input| must outlive the Crc32cInputStream.
+  explicit Crc32cInputStream(ZeroCopyInputStream* input) : input_(input) {}
+  Crc32cInputStream(const Crc32cInputStream&) = delete;
+  Crc32cInputStream& operator=(const Crc32cInputStream&) = delete;
+  ~Crc32cInputStream() override = default;
+
+  // Returns the CRC32C of the bytes consumed so far: those returned by Next()
+  // and not given back with BackUp().
+  absl::crc32c_t crc() const { return absl::ExtendCrc32c(crc_, pending_); }
+
+  // implements ZeroCopyInputStream ----------------------------------
+  bool Next(const void** data, int* size) override;
+  void BackUp(int count) override;
+  bool Skip(int count) override;
+  int64_t ByteCount() const override { return input_->ByteCount(); }
+
+ private:
+  ZeroCopyInputStream* const input_;
+  // The CRC32C of the buffers before |pending_|.
+  absl::crc32c_t crc_{0};
+  // The consumed part of the last buffer returned by Next().
+  absl::string_view pending_;
+};
+
+// A ZeroCopyOutputStream which computes the CRC32C of the bytes written to
+// another stream, so that a record's checksum comes out of serializing it
+// instead of a separate pass over the output.  Each buffer is checksummed
+// when the next one is requested, right after it was written.
+class PROTOBUF_EXPORT Crc32cOutputStream final : public ZeroCopyOutputStream {
+ public:
+  // |output| must outlive the Crc32cOutputStream.
+  explicit Crc32cOutputStream(ZeroCopyOutputStream* output)
+      : output_(output) {}
+  Crc32cOutputStream(const Crc32cOutputStream&) = delete;
+  Crc32cOutputStream& operator=(const Crc32cOutputStream&) = delete;
+  ~Crc32cOutputStream() override = default;
+
+  // Returns the CRC32C of the bytes written so far.  The writer must be done
+  // with the last buffer returned by Next() and have backed up what it did not
+  // use, which a CodedOutputStream does when it is trimmed or destroyed.
+  absl::crc32c_t crc() const { return absl::ExtendCrc32c(crc_, pending_); }
+
+  // implements ZeroCopyOutputStream ---------------------------------
+  bool Next(void** data, int* size) override;
+  void BackUp(int count) override;
+  int64_t ByteCount() const override { return output_->ByteCount(); }
+
+ private:
+  ZeroCopyOutputStream* const output_;
+  // The CRC32C of the buffers before |pending_|.
+  absl::crc32c_t crc_{0};
+  // The last buffer returned by Next(), less what was backed up.
+  absl::string_view pending_;
+};
+
+// ===================================================================
+
 }  // namespace io
 }  // namespace protobuf
 }  // namespace google
@@ -620,7 +620,16 @@ bool CordOutputStream::Next(void** data, int* size) {
       ABSL_FALLTHROUGH_INTENDED;
     case State::kEmpty:
       assert(buffer_.length() == 0);
-      buffer_ = absl::CordBuffer::CreateWithDefaultLimit(desired_size);
+      // When the size hint says that a lot of data is still to come, use
+      // buffers of up to the maximum flat size rather than the default limit,
+      // so large outputs end up in a few large flats.
+      if (max_size == desired_size &&
+          desired_size > absl::CordBuffer::kDefaultLimit) {
+        buffer_ = absl::CordBuffer::CreateWithCustomLimit(
+            absl::CordBuffer::kCustomLimit, desired_size);
+      } else {
+        buffer_ = absl::CordBuffer::CreateWithDefaultLimit(desired_size);
+      }
       break;
   }
 
@@ -46,6 +46,7 @@
 #include "google/protobuf/testing/file.h"
 #include "google/protobuf/testing/file.h"
 #include <gtest/gtest.h>
+#include "absl/crc/crc32c.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
@@ -532,6 +533,40 @@ TEST_F(IoTest, ZlibIoInputAutodetect) {
   delete[] buffer;
 }
 
+TEST_F(IoTest, ZlibIoWithDictionary) {
+  const std::string dictionary = "record_id=timestamp=user_agent=referrer=";
+  const std::string record = "record_id=42 timestamp=1700000000 referrer=";
+
+  GzipOutputStream::Options options;
+  options.format = GzipOutputStream::ZLIB;
+  const std::string plain = Compress(record, options);
+  options.dictionary = dictionary;
+  const std::string compressed = Compress(record, options);
+  EXPECT_LT(compressed.size(), plain.size());
+
+  {
+    ArrayInputStream input(compressed.data(), compressed.size());
+    GzipInputStream gzin(&input, GzipInputStream::ZLIB);
+    gzin.SetDictionary(dictionary);
+    std::string result;
+    const void* buffer;
+    int size;
+    while (gzin.Next(&buffer, &size)) {
+      result.append(reinterpret_cast<const char*>(buffer), size);
+    }
+    EXPECT_EQ(record, result);
+  }
+  {
+    // Without the dictionary the stream cannot be decompressed.
+    ArrayInputStream input(compressed.data(), compressed.size());
+    GzipInputStream gzin(&input, GzipInputStream::ZLIB);
+    const void* buffer;
+    int size;
+    EXPECT_FALSE(gzin.Next(&buffer, &size));
+    EXPECT_EQ(Z_NEED_DICT, gzin.ZlibErrorCode());
+  }
+}
+
 std::string IoTest::Compress(const std::string& data,
                              const GzipOutputStream::Options& options) {
   std::string result;
@@ -591,6 +626,40 @@ TEST_F(IoTest, CompressionOptions) {
   EXPECT_TRUE(Uncompress(zlib_compressed) == golden);
 }
 
+TEST_F(IoTest, ParallelCompression) {
+  std::string golden;
+  for (int i = 0; i < 20000; ++i) {
+    absl::StrAppend(&golden, "record ", i % 997, " of ", i, "\n");
+  }
+
+  for (auto format : {GzipOutputStream::GZIP, GzipOutputStream::ZLIB}) {
+    GzipOutputStream::Options options;
+    options.format = format;
+    options.buffer_size = 4096;
+    const std::string serial = Compress(golden, options);
+    options.num_threads = 4;
+    const std::string parallel = Compress(golden, options);
+    EXPECT_EQ(Uncompress(parallel), golden);
+    // Each block sees the 32kB before it, so little is lost.
+    EXPECT_LT(parallel.size(), serial.size() * 11 / 10);
+
+    EXPECT_EQ(Uncompress(Compress("", options)), "");
+
+    // Flushes end a batch of blocks early.
+    std::string flushed;
+    {
+      StringOutputStream output(&flushed);
+      GzipOutputStream gzout(&output, options);
+      WriteToOutput(&gzout, golden.data(), 10000);
+      EXPECT_TRUE(gzout.Flush());
+      EXPECT_EQ(gzout.ByteCount(), 10000);
+      WriteToOutput(&gzout, golden.data() + 10000, golden.size() - 10000);
+      EXPECT_TRUE(gzout.Close());
+    }
+    EXPECT_EQ(Uncompress(flushed), golden);
+  }
+}
+
 TEST_F(IoTest, TwoSessionWriteGzip) {
   // Test that two concatenated gzip streams can be read correctly
 
@@ -1181,6 +1250,30 @@ TEST(CordOutputStreamTest, ProperHintCreatesSingleFlatCord) {
   EXPECT_EQ(flat, std::string(2000, 'a'));
 }
 
+TEST(CordOutputStreamTest, LargeHintUsesLargeFlats) {
+  const int kSize = 200000;
+  CordOutputStream output(kSize);
+  void* data;
+  int size;
+
+  int remaining = kSize;
+  int buffers = 0;
+  while (remaining > 0) {
+    ASSERT_TRUE(output.Next(&data, &size));
+    ASSERT_LE(size, remaining);
+    if (remaining > static_cast<int>(absl::CordBuffer::kDefaultLimit)) {
+      EXPECT_GT(size, static_cast<int>(absl::CordBuffer::kDefaultLimit));
+    }
+    memset(data, 'a', static_cast<size_t>(size));
+    remaining -= size;
+    ++buffers;
+  }
+  EXPECT_LE(buffers, kSize / (absl::CordBuffer::kCustomLimit / 2) + 1);
+
+  absl::Cord cord = output.Consume();
+  EXPECT_EQ(cord, std::string(kSize, 'a'));
+}
+
 TEST(CordOutputStreamTest, SizeHintDictatesTotalSize) {
   absl::Cord cord(std::string(500, 'a'));
   CordOutputStream output(std::move(cord), 2000);
@@ -1433,6 +1526,122 @@ TEST_F(IoTest, FileIo) {
   }
 }
 
+#ifndef _WIN32
+TEST_F(IoTest, MmapFileIo) {
+  std::string filename =
+      absl::StrCat(::testing::TempDir(), "/zero_copy_stream_test_file");
+  const int64_t page_size = sysconf(_SC_PAGESIZE);
+  std::string contents;
+  for (int i = 0; contents.size() < static_cast<size_t>(3 * page_size + 100);
+       i++) {
+    absl::StrAppend(&contents, i, ",");
+  }
+
+  // A window of 1 rounds up to a single page.
+  for (int64_t window_size : {int64_t{-1}, int64_t{1}, 2 * page_size}) {
+    int file =
+        open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0777);
+    ASSERT_GE(file, 0);
+    {
+      FileOutputStream output(file);
+      WriteToOutput(&output, contents.data(), contents.size());
+      EXPECT_EQ(0, output.GetErrno());
+    }
+    // Start reading after the first 10 bytes.
+    ASSERT_NE(lseek(file, 10, SEEK_SET), (off_t)-1);
+
+    {
+      MmapInputStream input(file, window_size);
+      std::string result;
+      const void* data;
+      int size;
+      ASSERT_TRUE(input.Next(&data, &size));
+      ASSERT_GT(size, 5);
+      input.BackUp(5);
+      result.append(static_cast<const char*>(data), size - 5);
+      ASSERT_TRUE(input.Skip(5));
+      result.append(contents, result.size() + 10, 5);
+      while (input.Next(&data, &size)) {
+        result.append(static_cast<const char*>(data), size);
+      }
+      EXPECT_EQ(0, input.GetErrno());
+      EXPECT_EQ(contents.substr(10), result);
+      EXPECT_EQ(static_cast<int64_t>(contents.size() - 10), input.ByteCount());
+      EXPECT_FALSE(input.Skip(1));
+    }
+
+    close(file);
+  }
+}
+#endif  // !_WIN32
+
+TEST_F(IoTest, VectoredFileIo) {
+  std::string filename =
+      absl::StrCat(::testing::TempDir(), "/zero_copy_stream_test_file");
+
+  for (int i = 0; i < kBlockSizeCount; i++) {
+    for (int j = 0; j < kBlockSizeCount; j++) {
+      // Make a temporary file.
+      int file =
+          open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0777);
+      ASSERT_GE(file, 0);
+
+      {
+        VectoredFileOutputStream output(file, kBlockSizes[i]);
+        WriteStuff(&output);
+        EXPECT_EQ(0, output.GetErrno());
+      }
+
+      // Rewind.
+      ASSERT_NE(lseek(file, 0, SEEK_SET), (off_t)-1);
+
+      {
+        FileInputStream input(file, kBlockSizes[j]);
+        ReadStuff(&input);
+        EXPECT_EQ(0, input.GetErrno());
+      }
+
+      close(file);
+    }
+  }
+}
+
+// Large aliased writes are passed through by reference, interleaved with the
+// buffered data in the right order.
+TEST_F(IoTest, VectoredFileIoAliasing) {
+  std::string filename =
+      absl::StrCat(::testing::TempDir(), "/zero_copy_stream_test_file");
+  const std::string large(100000, 'x');
+  std::string expected;
+
+  int file =
+      open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0777);
+  ASSERT_GE(file, 0);
+  {
+    VectoredFileOutputStream output(file, 64);
+    ASSERT_TRUE(output.AllowsAliasing());
+    {
+      CodedOutputStream coded_output(&output);
+      coded_output.EnableAliasing(true);
+      for (int i = 0; i < 2000; i++) {
+        const std::string small = absl::StrCat("small", i);
+        coded_output.WriteString(small);
+        expected += small;
+        if (i % 100 == 0) {
+          coded_output.WriteRawMaybeAliased(large.data(), large.size());
+          expected += large;
+        }
+      }
+    }
+    EXPECT_EQ(output.ByteCount(), static_cast<int64_t>(expected.size()));
+    EXPECT_TRUE(output.Close());
+  }
+
+  std::string contents;
+  ASSERT_TRUE(File::GetContents(filename, &contents, true).ok());
+  EXPECT_EQ(contents, expected);
+}
+
 #ifndef _WIN32
 // This tests the FileInputStream with a non blocking file. It opens a pipe in
 // non blocking mode, then starts reading it. The writing thread starts writing
@@ -1599,6 +1808,18 @@ TEST_F(IoTest, FileWriteError) {
   EXPECT_EQ(EBADF, input.GetErrno());
 }
 
+// Test that VectoredFileOutputStreams report errors correctly.
+TEST_F(IoTest, VectoredFileWriteError) {
+  MsvcDebugDisabler debug_disabler;
+
+  // -1 = invalid file descriptor.
+  VectoredFileOutputStream output(-1);
+  uint8_t buffer[1] = {'x'};
+  EXPECT_TRUE(output.WriteAliasedRaw(buffer, 1));
+  EXPECT_FALSE(output.Flush());
+  EXPECT_EQ(EBADF, output.GetErrno());
+}
+
 // Pipes are not seekable, so File{Input,Output}Stream ends up doing some
 // different things to handle them.  We'll test by writing to a pipe and
 // reading back from it.
@@ -1737,6 +1958,40 @@ TEST_F(IoTest, LimitingInputStreamByteCount) {
   EXPECT_EQ(kHalfBufferSize - 1, input.ByteCount());
 }
 
+TEST_F(IoTest, Crc32cStreams) {
+  std::string data;
+  for (int i = 0; i < 200; ++i) absl::StrAppend(&data, i, ",");
+  const absl::crc32c_t expected = absl::ComputeCrc32c(data);
+  const absl::crc32c_t prefix_crc =
+      absl::ComputeCrc32c(absl::string_view(data).substr(0, 100));
+
+  for (int i = 0; i < kBlockSizeCount; i++) {
+    std::string buffer(data.size() + 50, '\0');
+    ArrayOutputStream array_output(&buffer[0], buffer.size(), kBlockSizes[i]);
+    Crc32cOutputStream crc_output(&array_output);
+    {
+      CodedOutputStream coded_output(&crc_output);
+      coded_output.WriteString(data);
+    }
+    EXPECT_EQ(crc_output.ByteCount(), static_cast<int64_t>(data.size()));
+    EXPECT_EQ(crc_output.crc(), expected) << kBlockSizes[i];
+
+    ArrayInputStream array_input(data.data(), data.size(), kBlockSizes[i]);
+    Crc32cInputStream crc_input(&array_input);
+    {
+      CodedInputStream coded_input(&crc_input);
+      std::string prefix;
+      ASSERT_TRUE(coded_input.ReadString(&prefix, 100));
+    }
+    // The unread bytes were backed up.
+    EXPECT_EQ(crc_input.ByteCount(), 100);
+    EXPECT_EQ(crc_input.crc(), prefix_crc) << kBlockSizes[i];
+    ASSERT_TRUE(crc_input.Skip(static_cast<int>(data.size()) - 100));
+    EXPECT_FALSE(crc_input.Skip(1));
+    EXPECT_EQ(crc_input.crc(), expected) << kBlockSizes[i];
+  }
+}
+
 // Check that a zero-size array doesn't confuse the code.
 TEST(ZeroSizeArray, Input) {
   ArrayInputStream input(nullptr, 0);
@@ -256,18 +256,10 @@ struct Proto2Descriptor {
   static absl::StatusOr<int32_t> EnumNumberByName(Field f,
                                                   absl::string_view name,
                                                   bool case_insensitive) {
-    if (case_insensitive) {
-      for (int i = 0; i < f->enum_type()->value_count(); ++i) {
-        const auto* ev = f->enum_type()->value(i);
-        if (absl::EqualsIgnoreCase(name, ev->name())) {
-          return ev->number();
-        }
-      }
-      return absl::InvalidArgumentError(
-          absl::StrFormat("unknown enum value: '%s'", name));
-    }
-
-    if (const auto* ev = f->enum_type()->FindValueByName(name)) {
+    const auto* ev = case_insensitive
+                         ? f->enum_type()->FindValueByNameIgnoringCase(name)
+                         : f->enum_type()->FindValueByName(name);
+    if (ev != nullptr) {
       return ev->number();
     }
 
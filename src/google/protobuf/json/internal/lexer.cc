@@ -76,6 +76,29 @@ void HardenAgainstHyrumsLaw(absl::string_view to_obfuscate, std::string& out) {
     }
   }
 }
+
+// Parses `text` if it is an integer with few enough digits to be exactly
+// representable as a double. Such numbers are common, and much cheaper to
+// convert than in general.
+bool ParseSmallInteger(absl::string_view text, double* value) {
+  bool negative = !text.empty() && text[0] == '-';
+  if (negative) {
+    text.remove_prefix(1);
+  }
+  if (text.empty() || text.size() > 15) {
+    return false;
+  }
+
+  uint64_t n = 0;
+  for (char c : text) {
+    if (!absl::ascii_isdigit(c)) {
+      return false;
+    }
+    n = n * 10 + static_cast<uint64_t>(c - '0');
+  }
+  *value = negative ? -static_cast<double>(n) : static_cast<double>(n);
+  return true;
+}
 }  // namespace
 
 constexpr size_t ParseOptions::kDefaultDepth;
@@ -191,24 +214,35 @@ absl::StatusOr<uint16_t> JsonLexer::ParseU16HexCodepoint() {
 absl::Status JsonLexer::SkipToToken() {
   while (true) {
     RETURN_IF_ERROR(stream_.BufferAtLeast(1).status());
-    switch (stream_.PeekChar()) {
-      case '\n':
-        RETURN_IF_ERROR(Advance(1));
+    // Skip all the whitespace in the current buffer at once.
+    absl::string_view unread = stream_.Unread();
+    size_t skipped = 0;
+    for (; skipped < unread.size(); ++skipped) {
+      char c = unread[skipped];
+      if (c == '\n') {
         ++json_loc_.line;
         json_loc_.col = 0;
+      } else if (c == '\r' || c == '\t' || c == ' ') {
+        ++json_loc_.col;
+      } else {
         break;
-      case '\r':
-      case '\t':
-      case ' ':
-        RETURN_IF_ERROR(Advance(1));
-        break;
-      default:
-        return absl::OkStatus();
+      }
+    }
+    json_loc_.offset += static_cast<int>(skipped);
+    RETURN_IF_ERROR(stream_.Advance(skipped));
+    if (skipped < unread.size()) {
+      return absl::OkStatus();
     }
   }
 }
 
 absl::StatusOr<LocationWith<MaybeOwnedString>> JsonLexer::ParseRawNumber() {
+  double unused;
+  return ParseNumberText(&unused);
+}
+
+absl::StatusOr<LocationWith<MaybeOwnedString>> JsonLexer::ParseNumberText(
+    double* value) {
   RETURN_IF_ERROR(SkipToToken());
 
   enum { kInt, kFraction, kExponent } state = kInt;
@@ -261,8 +295,8 @@ absl::StatusOr<LocationWith<MaybeOwnedString>> JsonLexer::ParseRawNumber() {
     return number->loc.Invalid("number cannot have trailing period");
   }
 
-  double d;
-  if (!absl::SimpleAtod(number_text, &d) || !std::isfinite(d)) {
+  if (!ParseSmallInteger(number_text, value) &&
+      (!absl::SimpleAtod(number_text, value) || !std::isfinite(*value))) {
     return number->loc.Invalid(
         absl::StrFormat("invalid number: '%s'", number_text));
   }
@@ -286,15 +320,9 @@ absl::StatusOr<LocationWith<MaybeOwnedString>> JsonLexer::ParseRawNumber() {
 }
 
 absl::StatusOr<LocationWith<double>> JsonLexer::ParseNumber() {
-  auto number = ParseRawNumber();
-  RETURN_IF_ERROR(number.status());
-
   double d;
-  if (!absl::SimpleAtod(number->value.AsView(), &d) || !std::isfinite(d)) {
-    return number->loc.Invalid(
-        absl::StrFormat("invalid number: '%s'", number->value.AsView()));
-  }
-
+  auto number = ParseNumberText(&d);
+  RETURN_IF_ERROR(number.status());
   return LocationWith<double>{d, number->loc};
 }
 
@@ -390,9 +418,28 @@ absl::StatusOr<LocationWith<MaybeOwnedString>> JsonLexer::ParseUtf8() {
   // on_heap is empty if we do not need to heap-allocate the string.
   std::string on_heap;
   LocationWith<Mark> mark = BeginMark();
+  const char quote = is_single_quote ? '\'' : '"';
   while (true) {
     RETURN_IF_ERROR(stream_.BufferAtLeast(1).status());
 
+    // Consume the printable ASCII characters that need no further handling
+    // up to the end of the current buffer at once; the switch below then only
+    // sees quotes, escapes, control characters and multi-byte code points.
+    absl::string_view unread = stream_.Unread();
+    size_t plain = 0;
+    while (plain < unread.size()) {
+      uint8_t uc = static_cast<uint8_t>(unread[plain]);
+      if (uc < 0x20 || uc > 0x7e || uc == quote || uc == '\\') break;
+      ++plain;
+    }
+    if (plain > 0) {
+      if (!on_heap.empty()) {
+        on_heap.append(unread.data(), plain);
+      }
+      RETURN_IF_ERROR(Advance(plain));
+      continue;
+    }
+
     char c = stream_.PeekChar();
     RETURN_IF_ERROR(Advance(1));
     switch (c) {
@@ -15,10 +15,13 @@
 #include <cstdint>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
@@ -109,6 +112,21 @@ class JsonLexer {
   const MessagePath& path() const { return *path_; }
   MessagePath& path() { return *path_; }
 
+  // The keys of an object and the fields they resolved to, or nullptr for
+  // unknown keys, in the order they appeared.
+  using KeyOrder = std::vector<std::pair<std::string, const void*>>;
+
+  // Returns the KeyOrder recorded for objects of the message type `type`
+  // during this parse. Objects of the same type usually have the same keys in
+  // the same order, so the parser can resolve most keys with one comparison
+  // instead of a lookup by name. The returned reference remains valid for the
+  // lifetime of the lexer.
+  KeyOrder& KeyOrderFor(const void* type) {
+    std::unique_ptr<KeyOrder>& key_order = key_orders_[type];
+    if (key_order == nullptr) key_order = std::make_unique<KeyOrder>();
+    return *key_order;
+  }
+
   // Creates an absl::InvalidArgumentError with line/column information.
   absl::Status Invalid(absl::string_view message,
                        SourceLocation sl = SourceLocation::current()) {
@@ -241,6 +259,11 @@ class JsonLexer {
   // `out_utf8`; returns the number of bytes written.
   absl::StatusOr<size_t> ParseUnicodeEscape(char out_utf8[4]);
 
+  // Parses a number as a string, like ParseRawNumber(), and also stores its
+  // value in `value`; validating the number requires converting it anyway.
+  absl::StatusOr<LocationWith<MaybeOwnedString>> ParseNumberText(
+      double* value);
+
   // Parses an alphanumeric "identifier", for use with the non-standard
   // "unquoted keys" extension.
   absl::StatusOr<LocationWith<MaybeOwnedString>> ParseBareWord();
@@ -257,6 +280,7 @@ class JsonLexer {
   ParseOptions options_;
   JsonLocation json_loc_;
   MessagePath* path_;
+  absl::flat_hash_map<const void*, std::unique_ptr<KeyOrder>> key_orders_;
 };
 
 template <typename F>
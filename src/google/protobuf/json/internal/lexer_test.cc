@@ -300,6 +300,14 @@ TEST(LexerTest, UTFBoundaries) {
      });
 }
 
+TEST(LexerTest, StringWithEscapesBetweenRuns) {
+  Do(R"json("ab\"cd\\ef\u00e9gh'ij")json",
+     [](io::ZeroCopyInputStream* stream) {
+       EXPECT_THAT(Value::Parse(stream), IsOkAndHolds(ValueIs<std::string>(
+                                             "ab\"cd\\ef\xc3\xa9gh'ij")));
+     });
+}
+
 TEST(NonStandard, SingleQuoteString) {
   DoLegacy(R"json('My String')json", [=](const Value& value) {
     EXPECT_THAT(value, ValueIs<std::string>("My String"));
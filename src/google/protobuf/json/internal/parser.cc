@@ -19,6 +19,7 @@
 #include "google/protobuf/type.pb.h"
 #include "absl/base/attributes.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
@@ -1221,9 +1222,36 @@ absl::Status ParseListValue(JsonLexer& lex, const Desc<Traits>& desc,
   return ParseArray<Traits>(lex, entry_field, msg);
 }
 
+// Looks up the field for the key `name`, which is the `*position`th
+// non-extension key of the current object, in `key_order`: if the previous
+// object of this type had the same key at this position, it resolved to the
+// same field. Otherwise, looks the name up and records the result.
+template <typename Traits>
+absl::optional<Field<Traits>> FieldByNameInOrder(
+    const Desc<Traits>& desc, absl::string_view name,
+    JsonLexer::KeyOrder& key_order, size_t& position) {
+  size_t index = position++;
+  if (index < key_order.size() && key_order[index].first == name) {
+    const void* field = key_order[index].second;
+    if (field == nullptr) return absl::nullopt;
+    return static_cast<Field<Traits>>(field);
+  }
+
+  absl::optional<Field<Traits>> field = Traits::FieldByName(desc, name);
+  std::pair<std::string, const void*> entry(
+      std::string(name), field.has_value() ? *field : nullptr);
+  if (index < key_order.size()) {
+    key_order[index] = std::move(entry);
+  } else {
+    key_order.push_back(std::move(entry));
+  }
+  return field;
+}
+
 template <typename Traits>
 absl::Status ParseField(JsonLexer& lex, const Desc<Traits>& desc,
-                        absl::string_view name, Msg<Traits>& msg) {
+                        absl::string_view name, Msg<Traits>& msg,
+                        JsonLexer::KeyOrder& key_order, size_t& position) {
   absl::optional<Field<Traits>> field;
   if (absl::StartsWith(name, "[") && absl::EndsWith(name, "]")) {
     absl::string_view extn_name = name.substr(1, name.size() - 2);
@@ -1242,7 +1270,7 @@ absl::Status ParseField(JsonLexer& lex, const Desc<Traits>& desc,
       }
     }
   } else {
-    field = Traits::FieldByName(desc, name);
+    field = FieldByNameInOrder<Traits>(desc, name, key_order, position);
   }
 
   if (!field.has_value()) {
@@ -1319,6 +1347,8 @@ absl::Status ParseMessage(JsonLexer& lex, const Desc<Traits>& desc,
     }
   }
 
+  JsonLexer::KeyOrder& key_order = lex.KeyOrderFor(&desc);
+  size_t position = 0;
   return lex.VisitObject(
       [&](LocationWith<MaybeOwnedString>& name) -> absl::Status {
         // If this is a well-known type, we expect its contents to be inside
@@ -1341,7 +1371,8 @@ absl::Status ParseMessage(JsonLexer& lex, const Desc<Traits>& desc,
           }
         }
 
-        return ParseField<Traits>(lex, desc, name.value.ToString(), msg);
+        return ParseField<Traits>(lex, desc, name.value.ToString(), msg,
+                                  key_order, position);
       });
 }
 }  // namespace
@@ -1368,6 +1399,25 @@ absl::Status JsonStreamToMessage(io::ZeroCopyInputStream* input,
   return s;
 }
 
+absl::Status JsonStreamToMessages(io::ZeroCopyInputStream* input,
+                                  const Descriptor& descriptor,
+                                  absl::FunctionRef<Message*()> next_message,
+                                  json_internal::ParseOptions options) {
+  // A single lexer for all objects keeps its buffers and the key orders
+  // recorded for each message type.
+  MessagePath path(descriptor.full_name());
+  JsonLexer lex(input, options, &path);
+  while (!lex.AtEof()) {
+    Message* message = next_message();
+    ABSL_DCHECK_EQ(message->GetDescriptor(), &descriptor);
+
+    ParseProto2Descriptor::Msg msg(message);
+    RETURN_IF_ERROR(ParseMessage<ParseProto2Descriptor>(
+        lex, descriptor, msg, /*any_reparse=*/false));
+  }
+  return absl::OkStatus();
+}
+
 absl::Status JsonToBinaryStream(google::protobuf::util::TypeResolver* resolver,
                                 const std::string& type_url,
                                 io::ZeroCopyInputStream* json_input,
@@ -10,7 +10,9 @@
 
 #include <cfloat>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <limits>
 #include <memory>
 #include <string>
@@ -228,11 +230,32 @@ struct ParseProto2Descriptor : Proto2Descriptor {
 struct ParseProto3Type : Proto3Type {
   class Msg {
    public:
-    explicit Msg(io::ZeroCopyOutputStream* stream) : stream_(stream) {}
+    explicit Msg(io::ZeroCopyOutputStream* stream)
+        : stream_(stream), buffers_(&owned_buffers_), depth_(0) {}
 
    private:
     friend ParseProto3Type;
+
+    Msg(io::ZeroCopyOutputStream* stream, std::deque<std::string>* buffers,
+        size_t depth)
+        : stream_(stream), buffers_(buffers), depth_(depth) {}
+
+    // Returns the cleared buffer for a sub-message of this message. Buffers
+    // are shared by all messages at the same depth, so that repeated
+    // sub-messages reuse the capacity of their siblings instead of allocating.
+    std::string& ChildBuffer() {
+      if (buffers_->size() <= depth_) buffers_->resize(depth_ + 1);
+      std::string& buffer = (*buffers_)[depth_];
+      buffer.clear();
+      return buffer;
+    }
+
     io::CodedOutputStream stream_;
+    // Only used by the top-level message; a deque, because sub-messages
+    // append to it while their parents hold references into it.
+    std::deque<std::string> owned_buffers_;
+    std::deque<std::string>* buffers_;
+    size_t depth_;
     absl::flat_hash_set<int32_t> parsed_oneofs_indices_;
     absl::flat_hash_set<int32_t> parsed_fields_;
   };
@@ -277,9 +300,9 @@ struct ParseProto3Type : Proto3Type {
             return absl::OkStatus();
           }
 
-          std::string out;
+          std::string& out = msg.ChildBuffer();
           io::StringOutputStream stream(&out);
-          Msg new_msg(&stream);
+          Msg new_msg(&stream, msg.buffers_, msg.depth_ + 1);
           RETURN_IF_ERROR(body(desc, new_msg));
 
           new_msg.stream_.Trim();  // Should probably be called "Flush()".
@@ -40,6 +40,8 @@
 #include "google/protobuf/json/internal/unparser_traits.h"
 #include "google/protobuf/json/internal/writer.h"
 #include "google/protobuf/message.h"
+#include "google/protobuf/timestamp.pb.h"
+#include "google/protobuf/util/time_util.h"
 #include "google/protobuf/util/type_resolver.h"
 #include "google/protobuf/stubs/status_macros.h"
 
@@ -409,28 +411,32 @@ absl::Status WriteField(JsonWriter& writer, const Msg<Traits>& msg,
   writer.WriteComma(first);
   writer.NewLine();
 
-  if (Traits::IsExtension(field)) {
-    writer.Write(MakeQuoted("[", Traits::FieldFullName(field), "]"), ":");
-  } else if (writer.options().preserve_proto_field_names) {
-    writer.Write(MakeQuoted(Traits::FieldName(field)), ":");
-  } else {
-    // The generator for type.proto and the internals of descriptor.cc disagree
-    // on what the json name of a PascalCase field is supposed to be; type.proto
-    // seems to (incorrectly?) capitalize the first letter, which is the
-    // behavior ESF defaults to. To fix this, if the original field name starts
-    // with an uppercase letter, and the Json name does not, we uppercase it.
-    absl::string_view original_name = Traits::FieldName(field);
-    absl::string_view json_name = Traits::FieldJsonName(field);
-    if (writer.options().allow_legacy_syntax &&
-        absl::ascii_isupper(original_name[0]) &&
-        !absl::ascii_isupper(json_name[0])) {
-      writer.Write(MakeQuoted(absl::ascii_toupper(original_name[0]),
-                              original_name.substr(1)),
-                   ":");
+  writer.WriteKey(field, [field](JsonWriter& key_writer) {
+    if (Traits::IsExtension(field)) {
+      key_writer.Write(MakeQuoted("[", Traits::FieldFullName(field), "]"),
+                       ":");
+    } else if (key_writer.options().preserve_proto_field_names) {
+      key_writer.Write(MakeQuoted(Traits::FieldName(field)), ":");
     } else {
-      writer.Write(MakeQuoted(json_name), ":");
+      // The generator for type.proto and the internals of descriptor.cc
+      // disagree on what the json name of a PascalCase field is supposed to
+      // be; type.proto seems to (incorrectly?) capitalize the first letter,
+      // which is the behavior ESF defaults to. To fix this, if the original
+      // field name starts with an uppercase letter, and the Json name does
+      // not, we uppercase it.
+      absl::string_view original_name = Traits::FieldName(field);
+      absl::string_view json_name = Traits::FieldJsonName(field);
+      if (key_writer.options().allow_legacy_syntax &&
+          absl::ascii_isupper(original_name[0]) &&
+          !absl::ascii_isupper(json_name[0])) {
+        key_writer.Write(MakeQuoted(absl::ascii_toupper(original_name[0]),
+                                    original_name.substr(1)),
+                         ":");
+      } else {
+        key_writer.Write(MakeQuoted(json_name), ":");
+      }
     }
-  }
+  });
   writer.Whitespace(" ");
 
   if (Traits::IsMap(field)) {
@@ -593,15 +599,27 @@ absl::Status WriteTimestamp(JsonWriter& writer, const Msg<Traits>& msg,
         "maximum acceptable time value is 9999-12-31T23:59:59Z");
   }
 
-  // Ensure seconds is positive.
-  *secs += 62135596800;
-
   auto nanos_field = Traits::MustHaveField(desc, 2);
   auto nanos = Traits::GetSize(nanos_field, msg) > 0
                    ? Traits::GetInt32(nanos_field, msg)
                    : 0;
   RETURN_IF_ERROR(nanos.status());
 
+  if (*nanos >= 0 && *nanos <= 999999999) {
+    Timestamp timestamp;
+    timestamp.set_seconds(*secs);
+    timestamp.set_nanos(*nanos);
+    std::string out = "\"";
+    util::TimeUtil::AppendToString(timestamp, &out);
+    out.push_back('"');
+    writer.Write(out);
+    return absl::OkStatus();
+  }
+
+  // Out of range nanos are written as they always have been.
+  // Ensure seconds is positive.
+  *secs += 62135596800;
+
   // Julian Day -> Y/M/D, Algorithm from:
   // Fliegel, H. F., and Van Flandern, T. C., "A Machine Algorithm for
   //   Processing Calendar Dates," Communications of the Association of
@@ -850,6 +868,21 @@ absl::Status MessageToJsonString(const Message& message, std::string* output,
   return absl::OkStatus();
 }
 
+absl::Status MessageToJsonStream(const Message& message,
+                                 io::ZeroCopyOutputStream* output,
+                                 json_internal::WriterOptions options) {
+  JsonWriter writer(output, options);
+  RETURN_IF_ERROR(WriteMessage<UnparseProto2Descriptor>(
+      writer, message, *message.GetDescriptor(), /*is_top_level=*/true));
+  writer.NewLine();
+  return absl::OkStatus();
+}
+
+absl::Status WriteArrayElement(const Message& message, JsonWriter& writer) {
+  return WriteMessage<UnparseProto2Descriptor>(
+      writer, message, *message.GetDescriptor(), /*is_top_level=*/false);
+}
+
 absl::Status BinaryToJsonStream(google::protobuf::util::TypeResolver* resolver,
                                 const std::string& type_url,
                                 io::ZeroCopyInputStream* binary_input,
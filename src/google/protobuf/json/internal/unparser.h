@@ -22,6 +22,13 @@ namespace json_internal {
 // details.
 absl::Status MessageToJsonString(const Message& message, std::string* output,
                                  json_internal::WriterOptions options);
+// Writes `message` to `output` as JSON, without buffering it in a string.
+absl::Status MessageToJsonStream(const Message& message,
+                                 io::ZeroCopyOutputStream* output,
+                                 json_internal::WriterOptions options);
+// Writes `message` to `writer` as an element of a JSON array, without a
+// trailing newline. Used to write many messages with the same writer.
+absl::Status WriteArrayElement(const Message& message, JsonWriter& writer);
 // Internal version of google::protobuf::util::BinaryToJsonStream; see json_util.h for
 // details.
 absl::Status BinaryToJsonStream(google::protobuf::util::TypeResolver* resolver,
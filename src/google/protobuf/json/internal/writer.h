@@ -19,11 +19,14 @@
 #include <type_traits>
 #include <utility>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "google/protobuf/io/strtod.h"
 #include "google/protobuf/io/zero_copy_sink.h"
 #include "google/protobuf/io/zero_copy_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 #include "google/protobuf/stubs/status_macros.h"
 
 // Must be included last.
@@ -119,33 +122,13 @@ class JsonWriter {
     }
   }
 
-  void Write(int32_t val) {
-    char buf[22];
-    int len = absl::SNPrintF(buf, sizeof(buf), "%d", val);
-    absl::string_view view(buf, static_cast<size_t>(len));
-    Write(view);
-  }
+  void Write(int32_t val) { Write(absl::AlphaNum(val).Piece()); }
 
-  void Write(uint32_t val) {
-    char buf[22];
-    int len = absl::SNPrintF(buf, sizeof(buf), "%d", val);
-    absl::string_view view(buf, static_cast<size_t>(len));
-    Write(view);
-  }
+  void Write(uint32_t val) { Write(absl::AlphaNum(val).Piece()); }
 
-  void Write(int64_t val) {
-    char buf[22];
-    int len = absl::SNPrintF(buf, sizeof(buf), "%d", val);
-    absl::string_view view(buf, static_cast<size_t>(len));
-    Write(view);
-  }
+  void Write(int64_t val) { Write(absl::AlphaNum(val).Piece()); }
 
-  void Write(uint64_t val) {
-    char buf[22];
-    int len = absl::SNPrintF(buf, sizeof(buf), "%d", val);
-    absl::string_view view(buf, static_cast<size_t>(len));
-    Write(view);
-  }
+  void Write(uint64_t val) { Write(absl::AlphaNum(val).Piece()); }
 
   template <typename... Ts>
   void Write(Quoted<Ts...> val) {
@@ -185,6 +168,25 @@ class JsonWriter {
 
   void WriteBase64(absl::string_view str);
 
+  // Writes the key of `field`, as `write_key` writes it to a JsonWriter with
+  // the same options. Objects of the same type usually repeat the same fields,
+  // so the key is only formatted and escaped the first time `field` is written
+  // during this writing session.
+  template <typename F>
+  void WriteKey(const void* field, F write_key) {
+    auto it = keys_.find(field);
+    if (it == keys_.end()) {
+      std::string key;
+      {
+        io::StringOutputStream out(&key);
+        JsonWriter key_writer(&out, options_);
+        write_key(key_writer);
+      }
+      it = keys_.emplace(field, std::move(key)).first;
+    }
+    Write(it->second);
+  }
+
   // Returns a buffer that can be re-used throughout a writing session as
   // variable-length scratch space.
   std::string& ScratchBuf() { return scratch_buf_; }
@@ -209,6 +211,8 @@ class JsonWriter {
   int indent_ = 0;
 
   std::string scratch_buf_;
+  // Keys written by WriteKey(), by field.
+  absl::flat_hash_map<const void*, std::string> keys_;
 };
 }  // namespace json_internal
 }  // namespace protobuf
@@ -7,13 +7,20 @@
 
 #include "google/protobuf/json/json.h"
 
+#include <memory>
 #include <string>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "google/protobuf/descriptor.h"
 #include "google/protobuf/io/zero_copy_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 #include "google/protobuf/json/internal/parser.h"
 #include "google/protobuf/json/internal/unparser.h"
+#include "google/protobuf/json/internal/writer.h"
+#include "google/protobuf/message.h"
 #include "google/protobuf/util/type_resolver.h"
 #include "google/protobuf/stubs/status_macros.h"
 
@@ -23,12 +30,9 @@
 namespace google {
 namespace protobuf {
 namespace json {
-
-absl::Status BinaryToJsonStream(google::protobuf::util::TypeResolver* resolver,
-                                const std::string& type_url,
-                                io::ZeroCopyInputStream* binary_input,
-                                io::ZeroCopyOutputStream* json_output,
-                                const PrintOptions& options) {
+namespace {
+google::protobuf::json_internal::WriterOptions ToWriterOptions(
+    const PrintOptions& options) {
   google::protobuf::json_internal::WriterOptions opts;
   opts.add_whitespace = options.add_whitespace;
   opts.preserve_proto_field_names = options.preserve_proto_field_names;
@@ -39,9 +43,47 @@ absl::Status BinaryToJsonStream(google::protobuf::util::TypeResolver* resolver,
 
   // TODO: Drop this setting.
   opts.allow_legacy_syntax = true;
+  return opts;
+}
 
+google::protobuf::json_internal::ParseOptions ToParserOptions(
+    const ParseOptions& options) {
+  google::protobuf::json_internal::ParseOptions opts;
+  opts.ignore_unknown_fields = options.ignore_unknown_fields;
+  opts.case_insensitive_enum_parsing = options.case_insensitive_enum_parsing;
+
+  // TODO: Drop this setting.
+  opts.allow_legacy_syntax = true;
+  return opts;
+}
+
+// Returns a new message of the type named by `type_url`, which is looked up
+// in `pool` as for an Any.
+absl::StatusOr<std::unique_ptr<Message>> NewMessageForTypeUrl(
+    const DescriptorPool* pool, MessageFactory* factory,
+    absl::string_view type_url) {
+  absl::string_view type_name = type_url.substr(type_url.rfind('/') + 1);
+  const Descriptor* descriptor = pool->FindMessageTypeByName(type_name);
+  if (descriptor == nullptr) {
+    return absl::NotFoundError(
+        absl::StrCat("Invalid type URL, unknown type: ", type_name));
+  }
+  const Message* prototype = factory->GetPrototype(descriptor);
+  if (prototype == nullptr) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("No message factory for type: ", type_name));
+  }
+  return std::unique_ptr<Message>(prototype->New());
+}
+}  // namespace
+
+absl::Status BinaryToJsonStream(google::protobuf::util::TypeResolver* resolver,
+                                const std::string& type_url,
+                                io::ZeroCopyInputStream* binary_input,
+                                io::ZeroCopyOutputStream* json_output,
+                                const PrintOptions& options) {
   return google::protobuf::json_internal::BinaryToJsonStream(
-      resolver, type_url, binary_input, json_output, opts);
+      resolver, type_url, binary_input, json_output, ToWriterOptions(options));
 }
 
 absl::Status BinaryToJsonString(google::protobuf::util::TypeResolver* resolver,
@@ -55,18 +97,40 @@ absl::Status BinaryToJsonString(google::protobuf::util::TypeResolver* resolver,
                             options);
 }
 
+absl::Status BinaryToJsonStream(const DescriptorPool* pool,
+                                MessageFactory* factory,
+                                absl::string_view type_url,
+                                io::ZeroCopyInputStream* binary_input,
+                                io::ZeroCopyOutputStream* json_output,
+                                const PrintOptions& options) {
+  auto message = NewMessageForTypeUrl(pool, factory, type_url);
+  RETURN_IF_ERROR(message.status());
+  if (!(*message)->ParsePartialFromZeroCopyStream(binary_input)) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Invalid binary input for type: ", (*message)->GetTypeName()));
+  }
+  return google::protobuf::json_internal::MessageToJsonStream(**message, json_output,
+                                                    ToWriterOptions(options));
+}
+
+absl::Status BinaryToJsonString(const DescriptorPool* pool,
+                                MessageFactory* factory,
+                                absl::string_view type_url,
+                                absl::string_view binary_input,
+                                std::string* json_output,
+                                const PrintOptions& options) {
+  io::ArrayInputStream input_stream(binary_input.data(), binary_input.size());
+  io::StringOutputStream output_stream(json_output);
+  return BinaryToJsonStream(pool, factory, type_url, &input_stream,
+                            &output_stream, options);
+}
+
 absl::Status JsonToBinaryStream(google::protobuf::util::TypeResolver* resolver,
                                 const std::string& type_url,
                                 io::ZeroCopyInputStream* json_input,
                                 io::ZeroCopyOutputStream* binary_output,
                                 const ParseOptions& options) {
-  google::protobuf::json_internal::ParseOptions opts;
-  opts.ignore_unknown_fields = options.ignore_unknown_fields;
-  opts.case_insensitive_enum_parsing = options.case_insensitive_enum_parsing;
-
-  // TODO: Drop this setting.
-  opts.allow_legacy_syntax = true;
-
+  const auto opts = ToParserOptions(options);
   return google::protobuf::json_internal::JsonToBinaryStream(
       resolver, type_url, json_input, binary_output, opts);
 }
@@ -82,20 +146,72 @@ absl::Status JsonToBinaryString(google::protobuf::util::TypeResolver* resolver,
                             options);
 }
 
+absl::Status JsonToBinaryStream(const DescriptorPool* pool,
+                                MessageFactory* factory,
+                                absl::string_view type_url,
+                                io::ZeroCopyInputStream* json_input,
+                                io::ZeroCopyOutputStream* binary_output,
+                                const ParseOptions& options) {
+  auto message = NewMessageForTypeUrl(pool, factory, type_url);
+  RETURN_IF_ERROR(message.status());
+  RETURN_IF_ERROR(google::protobuf::json_internal::JsonStreamToMessage(
+      json_input, message->get(), ToParserOptions(options)));
+  if (!(*message)->SerializePartialToZeroCopyStream(binary_output)) {
+    return absl::InternalError("Failed to write binary output");
+  }
+  return absl::OkStatus();
+}
+
+absl::Status JsonToBinaryString(const DescriptorPool* pool,
+                                MessageFactory* factory,
+                                absl::string_view type_url,
+                                absl::string_view json_input,
+                                std::string* binary_output,
+                                const ParseOptions& options) {
+  io::ArrayInputStream input_stream(json_input.data(), json_input.size());
+  io::StringOutputStream output_stream(binary_output);
+  return JsonToBinaryStream(pool, factory, type_url, &input_stream,
+                            &output_stream, options);
+}
+
 absl::Status MessageToJsonString(const Message& message, std::string* output,
                                  const PrintOptions& options) {
-  google::protobuf::json_internal::WriterOptions opts;
-  opts.add_whitespace = options.add_whitespace;
-  opts.preserve_proto_field_names = options.preserve_proto_field_names;
-  opts.always_print_enums_as_ints = options.always_print_enums_as_ints;
-  opts.always_print_fields_with_no_presence =
-      options.always_print_fields_with_no_presence;
-  opts.unquote_int64_if_possible = options.unquote_int64_if_possible;
+  return google::protobuf::json_internal::MessageToJsonString(message, output,
+                                                    ToWriterOptions(options));
+}
 
-  // TODO: Drop this setting.
-  opts.allow_legacy_syntax = true;
+JsonArrayWriter::JsonArrayWriter(io::ZeroCopyOutputStream* output,
+                                 const PrintOptions& options)
+    : writer_(std::make_unique<google::protobuf::json_internal::JsonWriter>(
+          output, ToWriterOptions(options))) {
+  writer_->Write("[");
+  writer_->Push();
+}
+
+JsonArrayWriter::~JsonArrayWriter() = default;
+
+absl::Status JsonArrayWriter::Write(const Message& message) {
+  if (writer_ == nullptr) {
+    return absl::FailedPreconditionError("JSON array is already finished");
+  }
+  writer_->WriteComma(first_);
+  writer_->NewLine();
+  return google::protobuf::json_internal::WriteArrayElement(message, *writer_);
+}
 
-  return google::protobuf::json_internal::MessageToJsonString(message, output, opts);
+absl::Status JsonArrayWriter::Finish() {
+  if (writer_ == nullptr) {
+    return absl::FailedPreconditionError("JSON array is already finished");
+  }
+  writer_->Pop();
+  if (!first_) {
+    writer_->NewLine();
+  }
+  writer_->Write("]");
+  writer_->NewLine();
+  // Returns the unused part of the last buffer to the stream.
+  writer_.reset();
+  return absl::OkStatus();
 }
 
 absl::Status JsonStringToMessage(absl::string_view input, Message* message,
@@ -107,15 +223,18 @@ absl::Status JsonStringToMessage(absl::string_view input, Message* message,
 absl::Status JsonStreamToMessage(io::ZeroCopyInputStream* input,
                                  Message* message,
                                  const ParseOptions& options) {
-  google::protobuf::json_internal::ParseOptions opts;
-  opts.ignore_unknown_fields = options.ignore_unknown_fields;
-  opts.case_insensitive_enum_parsing = options.case_insensitive_enum_parsing;
-
-  // TODO: Drop this setting.
-  opts.allow_legacy_syntax = true;
-
+  const auto opts = ToParserOptions(options);
   return google::protobuf::json_internal::JsonStreamToMessage(input, message, opts);
 }
+
+absl::Status JsonStreamToMessages(io::ZeroCopyInputStream* input,
+                                  const Descriptor* descriptor,
+                                  absl::FunctionRef<Message*()> next_message,
+                                  const ParseOptions& options) {
+  const auto opts = ToParserOptions(options);
+  return google::protobuf::json_internal::JsonStreamToMessages(input, *descriptor,
+                                                     next_message, opts);
+}
 }  // namespace json
 }  // namespace protobuf
 }  // namespace google
@@ -10,11 +10,17 @@
 #ifndef GOOGLE_PROTOBUF_JSON_JSON_H__
 #define GOOGLE_PROTOBUF_JSON_JSON_H__
 
+#include <memory>
 #include <string>
 
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/zero_copy_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 #include "google/protobuf/message.h"
+#include "google/protobuf/repeated_ptr_field.h"
 #include "google/protobuf/util/type_resolver.h"
 
 // Must be included last.
@@ -22,6 +28,10 @@
 
 namespace google {
 namespace protobuf {
+namespace json_internal {
+class JsonWriter;
+}  // namespace json_internal
+
 namespace json {
 struct ParseOptions {
   // Whether to ignore unknown JSON fields during parsing
@@ -75,6 +85,43 @@ inline absl::Status MessageToJsonString(const Message& message,
 //
 // Please note that non-OK statuses are not a stable output of this API and
 // subject to change without notice.
+// Writes a JSON array of messages to `output` one element at a time, for
+// arrays too large to be built as a single repeated field. Only the element
+// being written is held in memory; everything else is in `output`.
+//
+// Example:
+//   JsonArrayWriter writer(&output, options);
+//   for (const Row& row : rows) {
+//     RETURN_IF_ERROR(writer.Write(row));
+//   }
+//   RETURN_IF_ERROR(writer.Finish());
+//
+// The array is the same as MessageToJsonString() prints for a repeated message
+// field with the same elements, followed by the same trailing newline.
+class PROTOBUF_EXPORT JsonArrayWriter {
+ public:
+  JsonArrayWriter(io::ZeroCopyOutputStream* output,
+                  const PrintOptions& options);
+  explicit JsonArrayWriter(io::ZeroCopyOutputStream* output)
+      : JsonArrayWriter(output, PrintOptions()) {}
+  JsonArrayWriter(const JsonArrayWriter&) = delete;
+  JsonArrayWriter& operator=(const JsonArrayWriter&) = delete;
+  // An array that was not finished is left incomplete.
+  ~JsonArrayWriter();
+
+  // Appends `message` to the array. On error, the output is left with a
+  // partial element, and no more elements should be written.
+  absl::Status Write(const Message& message);
+
+  // Closes the array and returns all buffers to `output`, which then contains
+  // the complete array. No more elements can be written.
+  absl::Status Finish();
+
+ private:
+  std::unique_ptr<json_internal::JsonWriter> writer_;
+  bool first_ = true;
+};
+
 PROTOBUF_EXPORT absl::Status JsonStringToMessage(absl::string_view input,
                                                  Message* message,
                                                  const ParseOptions& options);
@@ -98,6 +145,36 @@ inline absl::Status JsonStreamToMessage(io::ZeroCopyInputStream* input,
   return JsonStreamToMessage(input, message, ParseOptions());
 }
 
+// Parses a stream of JSON objects separated by whitespace, such as
+// newline-delimited JSON, into messages of type `descriptor`. For each object,
+// `next_message` is called to provide the message to parse it into.
+//
+// All objects are parsed with the same parser state, which is much cheaper
+// than one call to JsonStreamToMessage() per object. Parsing stops at the
+// first error, which leaves the last message partially parsed; errors report
+// the line of the input where they occurred.
+PROTOBUF_EXPORT absl::Status JsonStreamToMessages(
+    io::ZeroCopyInputStream* input, const Descriptor* descriptor,
+    absl::FunctionRef<Message*()> next_message, const ParseOptions& options);
+
+// Parses a stream of JSON objects, as above, appending a message to `messages`
+// for each. The messages are allocated on the arena of `messages`, if any.
+template <typename T>
+absl::Status JsonStreamToMessages(io::ZeroCopyInputStream* input,
+                                  RepeatedPtrField<T>* messages,
+                                  const ParseOptions& options = {}) {
+  return JsonStreamToMessages(
+      input, T::descriptor(), [messages] { return messages->Add(); }, options);
+}
+
+template <typename T>
+absl::Status JsonStringToMessages(absl::string_view input,
+                                  RepeatedPtrField<T>* messages,
+                                  const ParseOptions& options = {}) {
+  io::ArrayInputStream input_stream(input.data(), input.size());
+  return JsonStreamToMessages(&input_stream, messages, options);
+}
+
 // Converts protobuf binary data to JSON.
 // The conversion will fail if:
 //   1. TypeResolver fails to resolve a type.
@@ -133,6 +210,26 @@ inline absl::Status BinaryToJsonString(google::protobuf::util::TypeResolver* res
                             PrintOptions());
 }
 
+// Converts protobuf binary data to JSON, like BinaryToJsonStream() above, but
+// reads the type named by `type_url`, and the types of any Any fields, straight
+// from `pool` instead of converting them to google.protobuf.Type protos.  Only
+// the part of `type_url` after its last '/' is used.  The message is built by
+// `factory`, which must support the types in `pool`; reuse one factory across
+// calls so that it only sets up each type once.
+//
+// Unlike with a TypeResolver, fields whose wire type conflicts with the type
+// are kept as unknown fields, and not printed, instead of failing the
+// conversion.
+PROTOBUF_EXPORT absl::Status BinaryToJsonStream(
+    const DescriptorPool* pool, MessageFactory* factory,
+    absl::string_view type_url, io::ZeroCopyInputStream* binary_input,
+    io::ZeroCopyOutputStream* json_output, const PrintOptions& options = {});
+
+PROTOBUF_EXPORT absl::Status BinaryToJsonString(
+    const DescriptorPool* pool, MessageFactory* factory,
+    absl::string_view type_url, absl::string_view binary_input,
+    std::string* json_output, const PrintOptions& options = {});
+
 // Converts JSON data to protobuf binary format.
 // The conversion will fail if:
 //   1. TypeResolver fails to resolve a type.
@@ -154,6 +251,14 @@ inline absl::Status JsonToBinaryStream(
                             ParseOptions());
 }
 
+// Converts JSON data to protobuf binary format, like JsonToBinaryStream()
+// above, but reads the types straight from `pool`, as described for the
+// BinaryToJsonStream() overload that takes a pool.
+PROTOBUF_EXPORT absl::Status JsonToBinaryStream(
+    const DescriptorPool* pool, MessageFactory* factory,
+    absl::string_view type_url, io::ZeroCopyInputStream* json_input,
+    io::ZeroCopyOutputStream* binary_output, const ParseOptions& options = {});
+
 PROTOBUF_EXPORT absl::Status JsonToBinaryString(
     google::protobuf::util::TypeResolver* resolver, const std::string& type_url,
     absl::string_view json_input, std::string* binary_output,
@@ -166,6 +271,11 @@ inline absl::Status JsonToBinaryString(google::protobuf::util::TypeResolver* res
   return JsonToBinaryString(resolver, type_url, json_input, binary_output,
                             ParseOptions());
 }
+
+PROTOBUF_EXPORT absl::Status JsonToBinaryString(
+    const DescriptorPool* pool, MessageFactory* factory,
+    absl::string_view type_url, absl::string_view json_input,
+    std::string* binary_output, const ParseOptions& options = {});
 }  // namespace json
 }  // namespace protobuf
 }  // namespace google
@@ -8,6 +8,7 @@
 #include "google/protobuf/json/json.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -24,11 +25,13 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor_database.h"
 #include "google/protobuf/dynamic_message.h"
 #include "google/protobuf/io/test_zero_copy_stream.h"
 #include "google/protobuf/io/zero_copy_stream.h"
 #include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/repeated_ptr_field.h"
 #include "google/protobuf/util/json_format.pb.h"
 #include "google/protobuf/util/json_format_proto3.pb.h"
 #include "google/protobuf/unittest.pb.h"
@@ -45,11 +48,13 @@ namespace json {
 namespace {
 using ::google::protobuf::util::TypeResolver;
 using ::proto3::MapIn;
+using ::proto3::MessageType;
 using ::proto3::TestAny;
 using ::proto3::TestEnumValue;
 using ::proto3::TestMap;
 using ::proto3::TestMessage;
 using ::proto3::TestOneof;
+using ::proto3::TestStruct;
 using ::proto3::TestWrapper;
 using ::testing::ContainsRegex;
 using ::testing::ElementsAre;
@@ -84,6 +89,7 @@ MATCHER_P(StatusIs, status,
 enum class Codec {
   kReflective,
   kResolver,
+  kPool,
 };
 
 class JsonTest : public testing::TestWithParam<Codec> {
@@ -101,10 +107,16 @@ class JsonTest : public testing::TestWithParam<Codec> {
     std::string result;
     io::StringOutputStream out(&result);
 
-    RETURN_IF_ERROR(BinaryToJsonStream(
-        resolver_.get(),
-        absl::StrCat("type.googleapis.com/", proto.GetTypeName()), &in, &out,
-        options));
+    std::string type_url =
+        absl::StrCat("type.googleapis.com/", proto.GetTypeName());
+    if (GetParam() == Codec::kPool) {
+      RETURN_IF_ERROR(BinaryToJsonStream(DescriptorPool::generated_pool(),
+                                         &factory_, type_url, &in, &out,
+                                         options));
+    } else {
+      RETURN_IF_ERROR(BinaryToJsonStream(resolver_.get(), type_url, &in, &out,
+                                         options));
+    }
     return result;
   }
 
@@ -120,10 +132,16 @@ class JsonTest : public testing::TestWithParam<Codec> {
     std::string result;
     io::StringOutputStream out(&result);
 
-    RETURN_IF_ERROR(JsonToBinaryStream(
-        resolver_.get(),
-        absl::StrCat("type.googleapis.com/", proto.GetTypeName()), &in, &out,
-        options));
+    std::string type_url =
+        absl::StrCat("type.googleapis.com/", proto.GetTypeName());
+    if (GetParam() == Codec::kPool) {
+      RETURN_IF_ERROR(JsonToBinaryStream(DescriptorPool::generated_pool(),
+                                         &factory_, type_url, &in, &out,
+                                         options));
+    } else {
+      RETURN_IF_ERROR(JsonToBinaryStream(resolver_.get(), type_url, &in, &out,
+                                         options));
+    }
 
     if (!proto.ParseFromString(result)) {
       return absl::InternalError("wire format parse failed");
@@ -142,10 +160,14 @@ class JsonTest : public testing::TestWithParam<Codec> {
   std::unique_ptr<TypeResolver> resolver_{
       google::protobuf::util::NewTypeResolverForDescriptorPool(
           "type.googleapis.com", DescriptorPool::generated_pool())};
+  // Builds dynamic messages for kPool, so that the pool path does not depend
+  // on generated code.
+  DynamicMessageFactory factory_;
 };
 
 INSTANTIATE_TEST_SUITE_P(JsonTestSuite, JsonTest,
-                         testing::Values(Codec::kReflective, Codec::kResolver));
+                         testing::Values(Codec::kReflective, Codec::kResolver,
+                                         Codec::kPool));
 
 TEST_P(JsonTest, TestWhitespaces) {
   TestMessage m;
@@ -380,6 +402,30 @@ TEST_P(JsonTest, TestInvalidIntegerValue) {
               StatusIs(absl::StatusCode::kInvalidArgument));
 }
 
+TEST_P(JsonTest, IntegralFloatingPoint) {
+  TestMessage m;
+  m.set_double_value(-123456789012345);
+  m.set_float_value(999999);
+  m.add_repeated_double_value(-0.0);
+  m.add_repeated_double_value(1e15);
+  m.add_repeated_double_value(0.5);
+  m.add_repeated_float_value(1e6);
+  EXPECT_THAT(ToJson(m),
+              IsOkAndHolds(R"({"floatValue":999999,)"
+                           R"("doubleValue":-123456789012345,)"
+                           R"("repeatedFloatValue":[1e+06],)"
+                           R"("repeatedDoubleValue":[-0,1e+15,0.5]})"));
+
+  auto parsed = ToProto<TestMessage>(
+      R"json({"doubleValue": -123456789012345, "floatValue": -0,
+              "repeatedDoubleValue": [0, 1234567890123456789, -1e3]})json");
+  ASSERT_OK(parsed);
+  EXPECT_EQ(parsed->double_value(), -123456789012345.0);
+  EXPECT_TRUE(std::signbit(parsed->float_value()));
+  EXPECT_THAT(parsed->repeated_double_value(),
+              ElementsAre(0.0, 1234567890123456789.0, -1000.0));
+}
+
 TEST_P(JsonTest, WebSafeBytes) {
   auto m = ToProto<TestMessage>(R"json({
       "bytesValue": "-_"
@@ -707,6 +753,63 @@ TEST_P(JsonTest, TestParseIgnoreUnknownFields) {
   EXPECT_THAT(ToJson(m), IsOkAndHolds("{}"));
 }
 
+TEST_P(JsonTest, ParseObjectsWithChangingKeys) {
+  // Keys are resolved by comparing with the keys of the previous object of the
+  // same type; make sure that unknown keys and changing orders still work.
+  ParseOptions options;
+  options.ignore_unknown_fields = true;
+  auto m = ToProto<TestMessage>(R"json({
+    "repeatedMessageValue": [
+      {"value": 1},
+      {"value": 2},
+      {"unknown": 0, "value": 3},
+      {"value": 4, "unknown": 0},
+      {"unknown": 0},
+      {"value": 5}
+    ]
+  })json",
+                                options);
+  ASSERT_OK(m);
+  ASSERT_EQ(m->repeated_message_value_size(), 6);
+  EXPECT_EQ(m->repeated_message_value(0).value(), 1);
+  EXPECT_EQ(m->repeated_message_value(1).value(), 2);
+  EXPECT_EQ(m->repeated_message_value(2).value(), 3);
+  EXPECT_EQ(m->repeated_message_value(3).value(), 4);
+  EXPECT_EQ(m->repeated_message_value(4).value(), 0);
+  EXPECT_EQ(m->repeated_message_value(5).value(), 5);
+
+  EXPECT_THAT(ToProto<TestMessage>(R"json({
+    "repeatedMessageValue": [{"value": 1}, {"unknown": 0}]
+  })json"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_P(JsonTest, ParseSubMessagesOfShrinkingSize) {
+  // Sub-messages are encoded in buffers reused by their siblings; make sure no
+  // bytes of a larger sibling are left behind.
+  auto m = ToProto<TestMessage>(R"json({
+    "repeatedMessageValue": [{"value": 123456789}, {"value": 1}, {}]
+  })json");
+  ASSERT_OK(m);
+  ASSERT_EQ(m->repeated_message_value_size(), 3);
+  EXPECT_EQ(m->repeated_message_value(0).value(), 123456789);
+  EXPECT_EQ(m->repeated_message_value(1).value(), 1);
+  EXPECT_EQ(m->repeated_message_value(2).ByteSizeLong(), 0);
+
+  auto s = ToProto<TestStruct>(R"json({
+    "repeatedValue": [
+      {"a": {"b": ["long string value", {"c": 1}]}},
+      {"a": {"b": [2]}},
+      {"a": {}}
+    ]
+  })json");
+  ASSERT_OK(s);
+  EXPECT_THAT(ToJson(*s), IsOkAndHolds(R"({"repeatedValue":[)"
+                                       R"({"a":{"b":["long string value",)"
+                                       R"({"c":1}]}},{"a":{"b":[2]}},)"
+                                       R"({"a":{}}]})"));
+}
+
 TEST_P(JsonTest, TestParseErrors) {
   // Parsing should fail if the field name can not be recognized.
   EXPECT_THAT(ToProto<TestMessage>(R"({"unknownName": 0})"),
@@ -1431,6 +1534,104 @@ TEST(JsonErrorTest, FieldNameAndSyntaxErrorInSeparateChunks) {
                     "*@ *bool_value"));
 }
 
+TEST(JsonStreamToMessagesTest, ParsesNewlineDelimitedObjects) {
+  RepeatedPtrField<TestMessage> messages;
+  ASSERT_OK(JsonStringToMessages(R"json({"int32Value": 1}
+{"int32Value": 2, "stringValue": "two"}
+{}
+  {"stringValue": "four", "int32Value": 4}
+)json",
+                                 &messages));
+  ASSERT_EQ(messages.size(), 4);
+  EXPECT_EQ(messages[0].int32_value(), 1);
+  EXPECT_EQ(messages[1].int32_value(), 2);
+  EXPECT_EQ(messages[1].string_value(), "two");
+  EXPECT_EQ(messages[2].ByteSizeLong(), 0);
+  EXPECT_EQ(messages[3].int32_value(), 4);
+  EXPECT_EQ(messages[3].string_value(), "four");
+
+  RepeatedPtrField<TestMessage> empty;
+  ASSERT_OK(JsonStringToMessages("\n\n", &empty));
+  EXPECT_THAT(empty, IsEmpty());
+}
+
+TEST(JsonStreamToMessagesTest, StopsAtFirstError) {
+  Arena arena;
+  auto* messages = Arena::Create<RepeatedPtrField<TestMessage>>(&arena);
+  io::internal::TestZeroCopyInputStream input(
+      {"{\"int32Value\": 1}\n{\"int32", "Value\": 2}\n{\"bogus\": 3}\n",
+       "{\"int32Value\": 4}\n"});
+  EXPECT_THAT(JsonStreamToMessages(&input, messages),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  ASSERT_EQ(messages->size(), 3);
+  EXPECT_EQ(messages->Get(0).int32_value(), 1);
+  EXPECT_EQ(messages->Get(1).int32_value(), 2);
+  EXPECT_EQ(messages->Get(0).GetArena(), &arena);
+
+  std::vector<std::unique_ptr<TestMessage>> owned;
+  io::ArrayInputStream trailing("{} x", 4);
+  EXPECT_THAT(JsonStreamToMessages(
+                  &trailing, TestMessage::descriptor(),
+                  [&] {
+                    owned.push_back(std::make_unique<TestMessage>());
+                    return owned.back().get();
+                  },
+                  ParseOptions()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(owned, SizeIs(2));
+}
+
+TEST(JsonArrayWriterTest, WritesElementsOneAtATime) {
+  TestMessage m;
+  m.set_int32_value(1);
+  m.mutable_message_value()->set_value(2);
+
+  std::string result;
+  {
+    io::StringOutputStream output(&result);
+    JsonArrayWriter writer(&output);
+    ASSERT_OK(writer.Write(m));
+    ASSERT_OK(writer.Write(TestMessage()));
+    ASSERT_OK(writer.Write(m));
+    ASSERT_OK(writer.Finish());
+    EXPECT_THAT(writer.Write(m),
+                StatusIs(absl::StatusCode::kFailedPrecondition));
+  }
+  EXPECT_EQ(result,
+            R"([{"int32Value":1,"messageValue":{"value":2}},{},)"
+            R"({"int32Value":1,"messageValue":{"value":2}}])");
+}
+
+TEST(JsonArrayWriterTest, WritesWhitespace) {
+  PrintOptions options;
+  options.add_whitespace = true;
+  MessageType m;
+  m.set_value(1);
+
+  std::string result;
+  io::StringOutputStream output(&result);
+  JsonArrayWriter writer(&output, options);
+  ASSERT_OK(writer.Write(m));
+  ASSERT_OK(writer.Write(m));
+  ASSERT_OK(writer.Finish());
+  // Note: whitespace here is significant.
+  EXPECT_EQ(result, R"([
+ {
+  "value": 1
+ },
+ {
+  "value": 1
+ }
+]
+)");
+
+  std::string empty;
+  io::StringOutputStream empty_output(&empty);
+  JsonArrayWriter empty_writer(&empty_output, options);
+  ASSERT_OK(empty_writer.Finish());
+  EXPECT_EQ(empty, "[]\n");
+}
+
 }  // namespace
 }  // namespace json
 }  // namespace protobuf
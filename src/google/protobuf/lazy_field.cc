@@ -0,0 +1,137 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/lazy_field.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "absl/strings/cord.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/message_lite.h"
+#include "google/protobuf/parse_context.h"
+#include "google/protobuf/wire_format_lite.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+LazyField::~LazyField() {
+  if (arena_ != nullptr) return;
+  delete encoded_;
+  delete message_.load(std::memory_order_relaxed);
+}
+
+absl::Cord* LazyField::MutableEncoded() {
+  if (encoded_ == nullptr) encoded_ = Arena::Create<absl::Cord>(arena_);
+  return encoded_;
+}
+
+void LazyField::SetEncoded(absl::Cord bytes) {
+  Clear();
+  *MutableEncoded() = std::move(bytes);
+}
+
+void LazyField::MergeEncoded(const absl::Cord& bytes) {
+  if (MessageLite* message = message_.load(std::memory_order_relaxed)) {
+    // Errors leave partial contents, as for the first parse.
+    message->MergePartialFromString(bytes);
+    if (modified_) return;
+  }
+  // Keeps the bytes in sync with a parsed but unmodified message.
+  MutableEncoded()->Append(bytes);
+}
+
+const char* LazyField::ParseLengthDelimited(const char* ptr,
+                                            ParseContext* ctx) {
+  const int size = ReadSize(&ptr);
+  if (ptr == nullptr) return nullptr;
+  absl::Cord bytes;
+  ptr = ctx->ReadCord(ptr, size, &bytes);
+  if (ptr == nullptr) return nullptr;
+  MergeEncoded(bytes);
+  return ptr;
+}
+
+MessageLite* LazyField::GetOrParse(const MessageLite& prototype) const {
+  MessageLite* message = message_.load(std::memory_order_acquire);
+  if (message != nullptr) return message;
+  MessageLite* parsed = prototype.New(arena_);
+  if (encoded_ != nullptr) {
+    // Errors leave a partially parsed message, see the class comment.
+    parsed->ParsePartialFromString(*encoded_);
+  }
+  // Another thread may have parsed the same bytes concurrently; keep the
+  // first result.
+  if (!message_.compare_exchange_strong(message, parsed,
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+    if (arena_ == nullptr) delete parsed;
+    return message;
+  }
+  return parsed;
+}
+
+const MessageLite& LazyField::Get(const MessageLite& prototype) const {
+  if (MessageLite* message = message_.load(std::memory_order_acquire)) {
+    return *message;
+  }
+  if (encoded_ == nullptr || encoded_->empty()) return prototype;
+  return *GetOrParse(prototype);
+}
+
+MessageLite* LazyField::Mutable(const MessageLite& prototype) {
+  MessageLite* message = GetOrParse(prototype);
+  modified_ = true;
+  if (encoded_ != nullptr) encoded_->Clear();
+  return message;
+}
+
+void LazyField::Clear() {
+  modified_ = false;
+  if (encoded_ != nullptr) encoded_->Clear();
+  MessageLite* message = message_.exchange(nullptr, std::memory_order_relaxed);
+  if (arena_ == nullptr) delete message;
+}
+
+size_t LazyField::ByteSizeLong() const {
+  if (modified_) {
+    return message_.load(std::memory_order_relaxed)->ByteSizeLong();
+  }
+  return encoded_ == nullptr ? 0 : encoded_->size();
+}
+
+uint8_t* LazyField::InternalWrite(int number, uint8_t* target,
+                                  io::EpsCopyOutputStream* stream) const {
+  if (modified_) {
+    const MessageLite* message = message_.load(std::memory_order_relaxed);
+    return WireFormatLite::InternalWriteMessage(
+        number, *message, message->GetCachedSize(), target, stream);
+  }
+  // Never modified: pass the original bytes through.
+  target = stream->EnsureSpace(target);
+  target = WireFormatLite::WriteTagToArray(
+      number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, target);
+  if (encoded_ == nullptr) {
+    return io::CodedOutputStream::WriteVarint32ToArray(0, target);
+  }
+  target = io::CodedOutputStream::WriteVarint32ToArray(
+      static_cast<uint32_t>(encoded_->size()), target);
+  return stream->WriteCord(*encoded_, target);
+}
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
@@ -0,0 +1,114 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// LazyField holds a singular sub-message in serialized form and only parses it
+// when it is first accessed. Messages that are routed rather than read, e.g.
+// the payload of an envelope, then cost a copy of their bytes (often just a
+// reference into the input Cord) instead of a full parse.
+
+#ifndef GOOGLE_PROTOBUF_LAZY_FIELD_H__
+#define GOOGLE_PROTOBUF_LAZY_FIELD_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/strings/cord.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/message_lite.h"
+#include "google/protobuf/parse_context.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+// The field is in one of three states:
+//  - empty: neither bytes nor a message,
+//  - unparsed: only the serialized bytes,
+//  - parsed: the message, which Get() creates from the bytes on first access.
+//
+// Until the message is modified through Mutable(), it is serialized by copying
+// its original bytes, without re-encoding or verifying them. A message that is
+// only read, or not touched at all, is passed through unchanged.
+//
+// Const accessors may be called concurrently; parsing on first access is
+// synchronized. The bytes are parsed with ParsePartialFromString(): malformed
+// bytes leave a partially parsed message, like any lazily verified field.
+//
+// All accessors that take a `prototype` must be passed the default instance of
+// the same message type.
+class PROTOBUF_EXPORT LazyField {
+ public:
+  constexpr LazyField() : LazyField(nullptr) {}
+  explicit constexpr LazyField(Arena* arena)
+      : arena_(arena), encoded_(nullptr), message_(nullptr), modified_(false) {}
+  LazyField(const LazyField&) = delete;
+  LazyField& operator=(const LazyField&) = delete;
+  ~LazyField();
+
+  bool IsParsed() const {
+    return message_.load(std::memory_order_acquire) != nullptr;
+  }
+
+  // Replaces the contents with the serialized message `bytes`.
+  void SetEncoded(absl::Cord bytes);
+
+  // Merges the serialized message `bytes` into the contents. While unparsed,
+  // the bytes are appended: concatenating serialized messages merges them.
+  void MergeEncoded(const absl::Cord& bytes);
+
+  // Parses a length-delimited payload starting at its length prefix, as a
+  // table-driven parser handler would, and merges it into the contents.
+  [[nodiscard]] const char* ParseLengthDelimited(const char* ptr,
+                                                 ParseContext* ctx);
+
+  // Returns the message, parsing the bytes on first access. Returns
+  // `prototype` if the field is empty.
+  const MessageLite& Get(const MessageLite& prototype) const;
+
+  // Like Get(), but the returned message may be modified. Creates the message
+  // if the field is empty. From then on the field is serialized from the
+  // message.
+  MessageLite* Mutable(const MessageLite& prototype);
+
+  // Makes the field empty.
+  void Clear();
+
+  // Returns the serialized size of the message, without tag and length.
+  // Calls ByteSizeLong() on the message if it was modified, which caches sizes
+  // for InternalWrite().
+  size_t ByteSizeLong() const;
+
+  // Writes the message as field `number`. ByteSizeLong() must have been called
+  // since the last modification.
+  uint8_t* InternalWrite(int number, uint8_t* target,
+                         io::EpsCopyOutputStream* stream) const;
+
+ private:
+  MessageLite* GetOrParse(const MessageLite& prototype) const;
+  absl::Cord* MutableEncoded();
+
+  Arena* arena_;
+  // Owned, or on `arena_`. The serialized message, unless `modified_`.
+  absl::Cord* encoded_;
+  // Owned, or on `arena_`.
+  mutable std::atomic<MessageLite*> message_;
+  // Set by Mutable(): the message may differ from `encoded_`.
+  bool modified_;
+};
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_LAZY_FIELD_H__
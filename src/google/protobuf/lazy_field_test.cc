@@ -0,0 +1,195 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/lazy_field.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/message_lite.h"
+#include "google/protobuf/parse_context.h"
+#include "google/protobuf/unittest.pb.h"
+#include "google/protobuf/wire_format_lite.h"
+
+namespace google {
+namespace protobuf {
+namespace internal {
+namespace {
+
+using ::proto2_unittest::TestAllTypes;
+
+const TestAllTypes& Prototype() { return TestAllTypes::default_instance(); }
+
+TestAllTypes MakeMessage(int value) {
+  TestAllTypes message;
+  message.set_optional_int32(value);
+  message.set_optional_string("payload");
+  message.add_repeated_int64(value);
+  return message;
+}
+
+// Serializes `field` as field `number` the way a containing message would.
+std::string Write(const LazyField& field, int number) {
+  field.ByteSizeLong();
+  std::string out;
+  {
+    io::StringOutputStream output(&out);
+    io::CodedOutputStream coded(&output);
+    coded.SetCur(field.InternalWrite(number, coded.Cur(), coded.EpsCopy()));
+  }
+  return out;
+}
+
+std::string Expected(const TestAllTypes& message, int number) {
+  std::string out;
+  {
+    io::StringOutputStream output(&out);
+    io::CodedOutputStream coded(&output);
+    coded.WriteTag(WireFormatLite::MakeTag(
+        number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED));
+    coded.WriteVarint32(static_cast<uint32_t>(message.ByteSizeLong()));
+    message.SerializeWithCachedSizes(&coded);
+  }
+  return out;
+}
+
+TEST(LazyFieldTest, EmptyReturnsPrototype) {
+  LazyField field;
+  EXPECT_FALSE(field.IsParsed());
+  EXPECT_EQ(&field.Get(Prototype()), &Prototype());
+  EXPECT_EQ(field.ByteSizeLong(), 0);
+  EXPECT_EQ(Write(field, 1), std::string("\012\000", 2));
+}
+
+TEST(LazyFieldTest, ParsesOnFirstAccess) {
+  const TestAllTypes message = MakeMessage(7);
+  LazyField field;
+  field.SetEncoded(message.SerializeAsString());
+  EXPECT_FALSE(field.IsParsed());
+  EXPECT_EQ(field.ByteSizeLong(), message.ByteSizeLong());
+  EXPECT_EQ(Write(field, 5), Expected(message, 5));
+
+  const auto& parsed =
+      static_cast<const TestAllTypes&>(field.Get(Prototype()));
+  EXPECT_TRUE(field.IsParsed());
+  EXPECT_EQ(parsed.optional_int32(), 7);
+  EXPECT_EQ(parsed.optional_string(), "payload");
+  EXPECT_EQ(&field.Get(Prototype()), &parsed);
+}
+
+TEST(LazyFieldTest, MutableChangesSerialization) {
+  LazyField field;
+  field.SetEncoded(MakeMessage(1).SerializeAsString());
+  auto* message = static_cast<TestAllTypes*>(field.Mutable(Prototype()));
+  EXPECT_EQ(message->optional_int32(), 1);
+  message->set_optional_int32(2);
+  EXPECT_EQ(Write(field, 3), Expected(*message, 3));
+}
+
+TEST(LazyFieldTest, UnmodifiedMessagePassesBytesThrough) {
+  // optional_int32 twice and out of order with optional_int64: not how the
+  // parsed message would serialize.
+  const std::string bytes("\x10\x05\x08\x01\x08\x02", 6);
+  std::string expected_write("\x2a\x06", 2);
+  expected_write += bytes;
+
+  LazyField field;
+  field.SetEncoded(bytes);
+  const auto& message =
+      static_cast<const TestAllTypes&>(field.Get(Prototype()));
+  EXPECT_EQ(message.optional_int32(), 2);
+  EXPECT_EQ(field.ByteSizeLong(), bytes.size());
+  EXPECT_EQ(Write(field, 5), expected_write);
+
+  // Merging keeps the bytes in sync.
+  field.MergeEncoded(absl::Cord(absl::string_view("\x08\x03", 2)));
+  EXPECT_EQ(message.optional_int32(), 3);
+  EXPECT_EQ(Write(field, 5),
+            absl::StrCat(absl::string_view("\x2a\x08", 2), bytes,
+                         absl::string_view("\x08\x03", 2)));
+
+  // Once modified, the message is re-encoded.
+  field.Mutable(Prototype());
+  EXPECT_EQ(Write(field, 5), Expected(message, 5));
+}
+
+TEST(LazyFieldTest, MergeEncodedMergesMessages) {
+  TestAllTypes first = MakeMessage(1);
+  TestAllTypes second;
+  second.set_optional_int64(5);
+  second.add_repeated_int64(6);
+  TestAllTypes merged = first;
+  merged.MergeFrom(second);
+
+  LazyField unparsed;
+  unparsed.SetEncoded(first.SerializeAsString());
+  unparsed.MergeEncoded(absl::Cord(second.SerializeAsString()));
+  EXPECT_EQ(unparsed.Get(Prototype()).SerializeAsString(),
+            merged.SerializeAsString());
+
+  LazyField parsed;
+  parsed.SetEncoded(first.SerializeAsString());
+  parsed.Get(Prototype());
+  parsed.MergeEncoded(absl::Cord(second.SerializeAsString()));
+  EXPECT_EQ(parsed.Get(Prototype()).SerializeAsString(),
+            merged.SerializeAsString());
+}
+
+TEST(LazyFieldTest, ParseLengthDelimited) {
+  const TestAllTypes message = MakeMessage(9);
+  const std::string payload = message.SerializeAsString();
+  std::string data;
+  data.push_back(static_cast<char>(payload.size()));
+  data += payload;
+
+  LazyField field;
+  const char* ptr;
+  ParseContext ctx(io::CodedInputStream::GetDefaultRecursionLimit(), false,
+                   &ptr, data);
+  ptr = field.ParseLengthDelimited(ptr, &ctx);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(static_cast<const TestAllTypes&>(field.Get(Prototype()))
+                .optional_int32(),
+            9);
+}
+
+TEST(LazyFieldTest, ClearAndArena) {
+  Arena arena;
+  auto* field = Arena::Create<LazyField>(&arena, &arena);
+  field->SetEncoded(MakeMessage(3).SerializeAsString());
+  const MessageLite& parsed = field->Get(Prototype());
+  EXPECT_EQ(parsed.GetArena(), &arena);
+  field->Clear();
+  EXPECT_FALSE(field->IsParsed());
+  EXPECT_EQ(&field->Get(Prototype()), &Prototype());
+}
+
+TEST(LazyFieldTest, ConcurrentFirstAccess) {
+  LazyField field;
+  field.SetEncoded(MakeMessage(4).SerializeAsString());
+  std::vector<const MessageLite*> results(8);
+  std::vector<std::thread> threads;
+  for (auto& result : results) {
+    threads.emplace_back(
+        [&field, &result] { result = &field.Get(Prototype()); });
+  }
+  for (auto& thread : threads) thread.join();
+  for (const MessageLite* result : results) EXPECT_EQ(result, results[0]);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
@@ -346,6 +346,8 @@ class PROTOBUF_EXPORT UntypedMapBase {
 
   // Space used for the table and nodes.
   size_t SpaceUsedExcludingSelfLong() const;
+  // Space used for the table alone.
+  size_t TableSpaceUsedLong() const { return sizeof(void*) * num_buckets_; }
 
   TypeInfo type_info() const { return type_info_; }
 
@@ -436,6 +438,7 @@ class PROTOBUF_EXPORT UntypedMapBase {
   NodeBase* AllocNode() { return AllocNode(type_info_.node_size); }
 
   NodeBase* AllocNode(size_t node_size) {
+    PROTOBUF_ARENA_TRACE_SCOPE("Map.node");
     return static_cast<NodeBase*>(arena_ == nullptr
                                       ? ::operator new(node_size)
                                       : arena_->AllocateAligned(node_size));
@@ -459,6 +462,7 @@ class PROTOBUF_EXPORT UntypedMapBase {
   NodeBase** CreateEmptyTable(map_index_t n) {
     ABSL_DCHECK_GE(n, kMinTableSize);
     ABSL_DCHECK_EQ(n & (n - 1), 0u);
+    PROTOBUF_ARENA_TRACE_SCOPE("Map.table");
     NodeBase** result =
         arena_ == nullptr
             ? static_cast<NodeBase**>(::operator new(n * sizeof(NodeBase*)))
@@ -748,8 +752,12 @@ class KeyMapBase : public UntypedMapBase {
   }
 
   NodeAndBucket FindHelper(typename TS::ViewType k) const {
+    return FindHelper(k, BucketNumber(k));
+  }
+
+  // As above, for a bucket number `b` already computed for `k`.
+  NodeAndBucket FindHelper(typename TS::ViewType k, map_index_t b) const {
     AssertLoadFactor();
-    map_index_t b = BucketNumber(k);
     for (auto* node = table_[b]; node != nullptr; node = node->next) {
       if (TS::ToView(static_cast<KeyNode*>(node)->key()) == k) {
         return {node, b};
@@ -760,14 +768,17 @@ class KeyMapBase : public UntypedMapBase {
 
   // Insert the given node.
   // If the key is a duplicate, it inserts the new node and deletes the old one.
-  bool InsertOrReplaceNode(KeyNode* node) {
+  // With `grow_only` the table is never shrunk, so that room made by Reserve()
+  // is kept while the map fills up.
+  bool InsertOrReplaceNode(KeyNode* node, bool grow_only = false) {
     bool is_new = true;
     auto p = this->FindHelper(node->key());
     map_index_t b = p.bucket;
     if (ABSL_PREDICT_FALSE(p.node != nullptr)) {
       EraseImpl(p.bucket, static_cast<KeyNode*>(p.node), true);
       is_new = false;
-    } else if (ResizeIfLoadIsOutOfRange(num_elements_ + 1)) {
+    } else if (grow_only ? ResizeIfLoadIsTooHigh(num_elements_ + 1)
+                         : ResizeIfLoadIsOutOfRange(num_elements_ + 1)) {
       b = BucketNumber(node->key());  // bucket_number
     }
     InsertUnique(b, node);
@@ -837,6 +848,26 @@ class KeyMapBase : public UntypedMapBase {
     ABSL_DCHECK_LE(num_elements_, CalculateHiCutoff(num_buckets_));
   }
 
+  // Grows the table so that it can hold `n` elements without a resize.
+  void Reserve(size_type n) {
+    if (n > CalculateHiCutoff(num_buckets_)) {
+      Resize(CalculateCapacityForSize(n));
+    }
+  }
+
+  // Doubles the table if it cannot hold `new_size` elements.  Returns whether
+  // it did resize.
+  bool ResizeIfLoadIsTooHigh(size_type new_size) {
+    if (ABSL_PREDICT_TRUE(new_size <= CalculateHiCutoff(num_buckets_)) ||
+        num_buckets_ > max_size() / 2) {
+      return false;
+    }
+    Resize(kMinTableSize > kGlobalEmptyTableSize * 2
+               ? std::max(kMinTableSize, num_buckets_ * 2)
+               : num_buckets_ * 2);
+    return true;
+  }
+
   // Returns whether it did resize.  Currently this is only used when
   // num_elements_ increases, though it could be used in other situations.
   // It checks for load too low as well as load too high: because any number
@@ -852,12 +883,7 @@ class KeyMapBase : public UntypedMapBase {
     // we may resize even though there are many empty buckets.  In
     // practice, this seems fine.
     if (ABSL_PREDICT_FALSE(new_size > hi_cutoff)) {
-      if (num_buckets_ <= max_size() / 2) {
-        Resize(kMinTableSize > kGlobalEmptyTableSize * 2
-                   ? std::max(kMinTableSize, num_buckets_ * 2)
-                   : num_buckets_ * 2);
-        return true;
-      }
+      return ResizeIfLoadIsTooHigh(new_size);
     } else if (ABSL_PREDICT_FALSE(new_size <= lo_cutoff &&
                                   num_buckets_ > kMinTableSize)) {
       size_type lg2_of_size_reduction_factor = 1;
@@ -931,7 +957,18 @@ class KeyMapBase : public UntypedMapBase {
   }
 
   map_index_t BucketNumber(typename TS::ViewType k) const {
-    return static_cast<map_index_t>(absl::HashOf(k, table_) &
+    if constexpr (std::is_same<Key, std::string>::value) {
+      // String keys are hashed unseeded first, so that callers can compute
+      // that hash once and reuse it across maps; see Map::find(key, hash).
+      return BucketNumberForHash(absl::Hash<absl::string_view>{}(k));
+    } else {
+      return static_cast<map_index_t>(absl::HashOf(k, table_) &
+                                      (num_buckets_ - 1));
+    }
+  }
+
+  map_index_t BucketNumberForHash(size_t hash) const {
+    return static_cast<map_index_t>(absl::HashOf(hash, table_) &
                                     (num_buckets_ - 1));
   }
 };
@@ -941,6 +978,29 @@ bool InitializeMapKey(T*, K&&, Arena*) {
   return false;
 }
 
+// Returns true if `str` keeps its characters within its own footprint, in
+// which case it owns no memory and its destructor has no effect.
+inline bool IsInlineString(const std::string& str) {
+#if defined(_ITERATOR_DEBUG_LEVEL) && _ITERATOR_DEBUG_LEVEL != 0
+  // Checked iterators allocate a proxy object for every string.
+  return false;
+#else
+  const auto data = reinterpret_cast<uintptr_t>(str.data());
+  const auto self = reinterpret_cast<uintptr_t>(&str);
+  return data >= self && data < self + sizeof(str);
+#endif
+}
+
+// String keys on an arena only register their destructor if they own heap
+// memory. Most keys are short enough to be stored inline, so this saves a
+// cleanup node per entry and the walk over them on arena destruction.
+template <typename K>
+bool InitializeMapKey(std::string* key, K&& k, Arena* arena) {
+  ::new (key) std::string(std::forward<K>(k));
+  if (arena != nullptr && !IsInlineString(*key)) arena->OwnDestructor(key);
+  return true;
+}
+
 
 // The purpose of this class is to give the Rust implementation visibility into
 // some of the internals of C++ proto maps. We need access to these internals
@@ -1287,6 +1347,43 @@ class Map : private internal::KeyMapBase<internal::KeyForBase<Key>> {
     return find(key) != end();
   }
 
+  // Lookup with a precomputed `hash == hash_function()(key)`, for string keys
+  // only. The hash does not depend on the map, so batched lookups of the same
+  // keys in many maps can hash each key once.
+  template <typename K = key_type>
+  const_iterator find(const key_arg<K>& key, size_t hash) const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return const_cast<Map*>(this)->find(key, hash);
+  }
+  template <typename K = key_type>
+  iterator find(const key_arg<K>& key,
+                size_t hash) ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    static_assert(std::is_same<key_type, std::string>::value,
+                  "Precomputed hashes are only supported for string keys.");
+    ABSL_DCHECK_EQ(hash, hash_function()(TS::ToView(key)));
+    auto res =
+        this->FindHelper(TS::ToView(key), this->BucketNumberForHash(hash));
+    return iterator(internal::UntypedMapIterator{static_cast<Node*>(res.node),
+                                                 this, res.bucket});
+  }
+
+  // Prefetches the bucket `key` maps to, so that a later lookup of `key` does
+  // not wait for it. Useful to overlap the cache misses of batched lookups.
+  template <typename K = key_type>
+  void prefetch(const key_arg<K>& key) const {
+    absl::PrefetchToLocalCache(this->table_ +
+                               this->BucketNumber(TS::ToView(key)));
+  }
+  // As above, with a precomputed `hash == hash_function()(key)`, for string
+  // keys only.
+  template <typename K = key_type>
+  void prefetch(const key_arg<K>& key, size_t hash) const {
+    static_assert(std::is_same<key_type, std::string>::value,
+                  "Precomputed hashes are only supported for string keys.");
+    ABSL_DCHECK_EQ(hash, hash_function()(TS::ToView(key)));
+    absl::PrefetchToLocalCache(this->table_ + this->BucketNumberForHash(hash));
+  }
+
   template <typename K = key_type>
   std::pair<const_iterator, const_iterator> equal_range(
       const key_arg<K>& key) const ABSL_ATTRIBUTE_LIFETIME_BOUND {
@@ -1364,12 +1461,18 @@ class Map : private internal::KeyMapBase<internal::KeyForBase<Key>> {
       return insert(value_type(std::forward<Args>(args)...));
     }
   }
+  // For forward iterators the table is sized once for the whole range, and on
+  // an arena the nodes are carved from a single block.
   template <class InputIt>
   void insert(InputIt first, InputIt last) {
-    for (; first != last; ++first) {
-      auto&& pair = *first;
-      try_emplace(pair.first, pair.second);
-    }
+    InsertRange</*unique=*/false>(first, last);
+  }
+  // As above, for a range whose keys are distinct and not yet in the map, such
+  // as the contents of another map or a sorted range without duplicates.  This
+  // skips the lookup insert() makes for each key.
+  template <class InputIt>
+  void insert_unique(InputIt first, InputIt last) {
+    InsertRange</*unique=*/true>(first, last);
   }
   void insert(std::initializer_list<init_type> values) {
     insert(values.begin(), values.end());
@@ -1466,11 +1569,19 @@ class Map : private internal::KeyMapBase<internal::KeyForBase<Key>> {
 
   template <typename K, typename... Args>
   PROTOBUF_ALWAYS_INLINE Node* CreateNode(K&& k, Args&&... args) {
+    return ConstructNode(this->AllocNode(sizeof(Node)), std::forward<K>(k),
+                         std::forward<Args>(args)...);
+  }
+
+  // As CreateNode(), in the uninitialized node memory `mem`.
+  template <typename K, typename... Args>
+  PROTOBUF_ALWAYS_INLINE Node* ConstructNode(void* mem, K&& k,
+                                             Args&&... args) {
     // If K is not key_type, make the conversion to key_type explicit.
     using TypeToInit = typename std::conditional<
         std::is_same<typename std::decay<K>::type, key_type>::value, K&&,
         key_type>::type;
-    Node* node = static_cast<Node*>(this->AllocNode(sizeof(Node)));
+    Node* node = static_cast<Node*>(mem);
 
     // Even when arena is nullptr, CreateInArenaStorage is still used to
     // ensure the arena of submessage will be consistent. Otherwise,
@@ -1514,6 +1625,56 @@ class Map : private internal::KeyMapBase<internal::KeyForBase<Key>> {
     this->MergeIntoEmpty(CloneFromOther(other), other.size());
   }
 
+  // Inserts the elements of [first, last).  Unless `unique`, elements whose
+  // key is already in the map are skipped.
+  template <bool unique, class InputIt>
+  void InsertRange(InputIt first, InputIt last) {
+    size_t n = 0;
+    using Category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+      n = static_cast<size_t>(std::distance(first, last));
+      if (n == 0) return;
+      this->Reserve(this->num_elements_ + n);
+    }
+    char* slab = nullptr;
+    char* slab_end = nullptr;
+    if (this->arena_ != nullptr && n > 1) {
+      PROTOBUF_ARENA_TRACE_SCOPE("Map.node");
+      slab =
+          static_cast<char*>(this->arena_->AllocateAligned(n * sizeof(Node)));
+      slab_end = slab + n * sizeof(Node);
+    }
+    for (; first != last; ++first) {
+      auto&& pair = *first;
+      internal::map_index_t b = 0;
+      if constexpr (!unique) {
+        auto p = this->FindHelper(TS::ToView(pair.first));
+        if (p.node != nullptr) continue;
+        b = p.bucket;
+      }
+      void* mem;
+      if (slab != slab_end) {
+        mem = slab;
+        slab += sizeof(Node);
+      } else {
+        mem = this->AllocNode(sizeof(Node));
+      }
+      Node* node;
+      if constexpr (Arena::is_arena_constructable<mapped_type>::value) {
+        node = ConstructNode(mem, pair.first);
+        node->kv.second = pair.second;
+      } else {
+        node = ConstructNode(mem, pair.first, pair.second);
+      }
+      // Grow only: shrinking would undo the reservation made above.
+      if (this->ResizeIfLoadIsTooHigh(this->num_elements_ + 1) || unique) {
+        b = this->BucketNumber(TS::ToView(node->kv.first));
+      }
+      this->InsertUnique(b, node);
+      ++this->num_elements_;
+    }
+  }
+
   template <typename K, typename... Args>
   std::pair<iterator, bool> TryEmplaceInternal(K&& k, Args&&... args) {
     auto p = this->FindHelper(TS::ToView(k));
@@ -5,6 +5,8 @@
 // license that can be found in the LICENSE file or at
 // https://developers.google.com/open-source/licenses/bsd
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
@@ -12,6 +14,7 @@
 #include <string>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/random/random.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
@@ -115,6 +118,64 @@ Ratios CollectMeanProbeLengths() {
   return result;
 }
 
+struct LookupTimes {
+  // Nanoseconds per find() of a present and of an absent key.
+  double map_hit;
+  double map_miss;
+  // The same for absl::flat_hash_map, as the reference open-addressing
+  // layout.
+  double flat_hit;
+  double flat_miss;
+};
+
+template <class T, class Keys>
+double NanosPerFind(const T& t, const Keys& keys) {
+  // Repeat enough lookups that the clock resolution does not matter.
+  constexpr size_t kMinLookups = 1 << 22;
+  const size_t rounds = std::max<size_t>(1, kMinLookups / keys.size());
+  size_t found = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < rounds; ++r) {
+    for (const auto& key : keys) found += t.find(key) != t.end();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  // Keep the lookups from being optimized away.
+  volatile size_t sink = found;
+  (void)sink;
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         static_cast<double>(rounds * keys.size());
+}
+
+template <class ElemFn>
+LookupTimes CollectLookupTimes() {
+  const auto min_max_sizes = GetMinMaxLoadSizes();
+  const size_t size = (min_max_sizes.min_load + min_max_sizes.max_load) / 2;
+
+  ElemFn elem;
+  using Key = decltype(elem());
+  Table<Key> t;
+  absl::flat_hash_map<Key, int> flat;
+  std::vector<Key> present;
+  while (t.size() < size) {
+    Key key = elem();
+    if (t.insert({key, 0}).second) {
+      flat.insert({key, 0});
+      present.push_back(key);
+    }
+  }
+  std::vector<Key> absent;
+  while (absent.size() < present.size()) {
+    Key key = elem();
+    if (!t.contains(key)) absent.push_back(key);
+  }
+  // Probe in random order so lookups do not follow insertion order.
+  std::shuffle(present.begin(), present.end(), GlobalBitGen());
+  std::shuffle(absent.begin(), absent.end(), GlobalBitGen());
+
+  return {NanosPerFind(t, present), NanosPerFind(t, absent),
+          NanosPerFind(flat, present), NanosPerFind(flat, absent)};
+}
+
 constexpr char kStringFormat[] = "/path/to/file/name-%07d-of-9999999.txt";
 
 template <bool small>
@@ -229,11 +290,13 @@ struct Result {
   std::string name;
   std::string dist_name;
   Ratios ratios;
+  LookupTimes lookups;
 };
 
 template <typename T, typename Dist>
 void RunForTypeAndDistribution(std::vector<Result>& results) {
-  results.push_back({Name<T>(), Name<Dist>(), CollectMeanProbeLengths<Dist>()});
+  results.push_back({Name<T>(), Name<Dist>(), CollectMeanProbeLengths<Dist>(),
+                     CollectLookupTimes<Dist>()});
 }
 
 template <class T>
@@ -275,6 +338,22 @@ int main(int argc, char** argv) {
     print("min", &Ratios::min_load);
     print("avg", &Ratios::avg_load);
     print("max", &Ratios::max_load);
+
+    auto print_time = [&](absl::string_view stat, double LookupTimes::*val) {
+      std::string name =
+          absl::StrCat(result.name, "/", result.dist_name, "/", stat);
+      absl::PrintF("    %s{\n", comma);
+      absl::PrintF("      \"cpu_time\": %f,\n", result.lookups.*val);
+      absl::PrintF("      \"real_time\": %f,\n", result.lookups.*val);
+      absl::PrintF("      \"iterations\": 1,\n");
+      absl::PrintF("      \"name\": \"%s\",\n", name);
+      absl::PrintF("      \"time_unit\": \"ns\"\n");
+      absl::PrintF("    }\n");
+    };
+    print_time("find_hit", &LookupTimes::map_hit);
+    print_time("find_miss", &LookupTimes::map_miss);
+    print_time("flat_find_hit", &LookupTimes::flat_hit);
+    print_time("flat_find_miss", &LookupTimes::flat_miss);
   }
   absl::PrintF("  ],\n");
   absl::PrintF("  \"context\": {\n");
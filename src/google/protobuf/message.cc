@@ -42,6 +42,7 @@
 #include "google/protobuf/message_lite.h"
 #include "google/protobuf/parse_context.h"
 #include "google/protobuf/port.h"
+#include "google/protobuf/protoz_sampler.h"
 #include "google/protobuf/reflection_internal.h"
 #include "google/protobuf/reflection_ops.h"
 #include "google/protobuf/reflection_visit_fields.h"
@@ -101,6 +102,7 @@ void Message::MergeFrom(const Message& from) {
 
 void Message::CopyFrom(const Message& from) {
   if (&from == this) return;
+  internal::ProtozScope protoz(internal::ProtozOperation::kCopy, *this);
 
   auto* class_to = GetClassData();
   auto* class_from = from.GetClassData();
@@ -168,7 +170,7 @@ Metadata Message::GetMetadataImpl(const internal::ClassDataFull& data) {
       internal::AssignDescriptorsOnceInnerCall(table);
     });
   }
-  return {data.descriptor, data.reflection};
+  return {data.reflection_data->descriptor, data.reflection_data->reflection};
 }
 
 #if !defined(PROTOBUF_CUSTOM_VTABLE)
@@ -206,6 +208,10 @@ size_t Message::SpaceUsedLong() const {
   return GetClassData()->full().descriptor_methods->space_used_long(*this);
 }
 
+MessageSpaceUsage Message::SpaceUsedBreakdown() const {
+  return GetReflection()->SpaceUsedBreakdown(*this);
+}
+
 absl::string_view Message::GetTypeNameImpl(const internal::ClassData* data) {
   return GetMetadataImpl(data->full()).descriptor->full_name();
 }
@@ -21,9 +21,11 @@
 #include <string>
 #include <typeinfo>
 #include <utility>
+#include <vector>
 
 #include "absl/base/config.h"
 #include "absl/base/optimization.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/strings/cord.h"
@@ -42,6 +44,7 @@
 #include "google/protobuf/metadata_lite.h"
 #include "google/protobuf/parse_context.h"
 #include "google/protobuf/port.h"
+#include "google/protobuf/protoz_sampler.h"
 
 
 // Must be included last.
@@ -53,6 +56,7 @@ namespace protobuf {
 MessageLite* MessageLite::CopyConstruct(Arena* arena, const MessageLite& from) {
   auto* data = from.GetClassData();
   auto* res = data->New(arena);
+  internal::ProtozScope protoz(internal::ProtozOperation::kCopy, *res);
   data->merge_to_from(*res, from);
   return res;
 }
@@ -74,6 +78,73 @@ void MessageLite::DeleteInstance() {
   internal::SizedDelete(ptr, size);
 }
 
+namespace {
+
+// The messages given to MessageLite::ReturnToPool() on a thread, by type.
+class ThreadMessagePool {
+ public:
+  ThreadMessagePool() = default;
+  ThreadMessagePool(const ThreadMessagePool&) = delete;
+  ThreadMessagePool& operator=(const ThreadMessagePool&) = delete;
+
+  ~ThreadMessagePool() {
+    // Messages returned later during thread exit are deleted instead.
+    alive_ = false;
+    for (auto& entry : pools_) {
+      for (MessageLite* msg : entry.second) delete msg;
+    }
+  }
+
+  static ThreadMessagePool& Get() {
+    static thread_local ThreadMessagePool pool;
+    return pool;
+  }
+
+  MessageLite* Take(const internal::ClassData* data) {
+    if (!alive_) return nullptr;
+    auto it = pools_.find(data);
+    if (it == pools_.end() || it->second.empty()) return nullptr;
+    MessageLite* msg = it->second.back();
+    it->second.pop_back();
+    return msg;
+  }
+
+  bool Put(const internal::ClassData* data, MessageLite* msg) {
+    if (!alive_) return false;
+    std::vector<MessageLite*>& messages = pools_[data];
+    if (messages.size() >= MessageLite::kMaxPooledMessagesPerType) {
+      return false;
+    }
+    messages.push_back(msg);
+    return true;
+  }
+
+ private:
+  bool alive_ = true;
+  absl::flat_hash_map<const internal::ClassData*, std::vector<MessageLite*>>
+      pools_;
+};
+
+}  // namespace
+
+MessageLite* MessageLite::NewFromPool() const {
+  if (MessageLite* msg = ThreadMessagePool::Get().Take(GetClassData())) {
+    return msg;
+  }
+  return New(nullptr);
+}
+
+void MessageLite::ReturnToPool() {
+  ABSL_DCHECK_EQ(GetArena(), nullptr);
+  const internal::ClassData* data = GetClassData();
+  // Dynamic types can be destroyed before the pool is.
+  if (!data->is_dynamic && ThreadMessagePool::Get().Put(data, this)) {
+    Clear();
+    return;
+  }
+  delete this;
+}
+
 void MessageLite::CheckTypeAndMergeFrom(const MessageLite& other) {
   auto* data = GetClassData();
   auto* other_data = other.GetClassData();
@@ -218,8 +289,9 @@ void FailDynamicCast(const MessageLite& from, const MessageLite& to) {
   ABSL_LOG(FATAL) << "Cannot downcast " << from_name << " to " << to_name;
 }
 
-template <bool aliasing>
-bool MergeFromImpl(absl::string_view input, MessageLite* msg,
+// Parses all of a flat `input`, either a string_view or a PaddedInput.
+template <bool aliasing, typename Input>
+bool MergeFromFlat(Input input, MessageLite* msg,
                    const internal::TcParseTableBase* tc_table,
                    MessageLite::ParseFlags parse_flags) {
   const char* ptr;
@@ -233,14 +305,43 @@ bool MergeFromImpl(absl::string_view input, MessageLite* msg,
   return false;
 }
 
+// Inputs up to this size are parsed from a padded copy on the stack.  A flat
+// input is otherwise parsed in place up to its last few bytes, which the
+// parser then copies to its patch buffer to finish; for small messages that
+// switch is a large part of the parse.
+constexpr size_t kMaxPaddedCopySize = 64;
+
+template <bool aliasing>
+bool MergeFromImpl(absl::string_view input, MessageLite* msg,
+                   const internal::TcParseTableBase* tc_table,
+                   MessageLite::ParseFlags parse_flags) {
+  ProtozScope protoz(ProtozOperation::kParse, *msg);
+  protoz.RecordBytes(input.size());
+  using internal::EpsCopyInputStream;
+  if (input.size() <= kMaxPaddedCopySize) {
+    char buffer[kMaxPaddedCopySize + EpsCopyInputStream::kInputPaddingSize];
+    if (!input.empty()) memcpy(buffer, input.data(), input.size());
+    // The parser may read the padding, though it never uses what it reads.
+    memset(buffer + input.size(), 0, EpsCopyInputStream::kInputPaddingSize);
+    return MergeFromFlat<aliasing>(
+        EpsCopyInputStream::PaddedInput{
+            absl::string_view(buffer, input.size()), input.data()},
+        msg, tc_table, parse_flags);
+  }
+  return MergeFromFlat<aliasing>(input, msg, tc_table, parse_flags);
+}
+
 template <bool aliasing>
 bool MergeFromImpl(io::ZeroCopyInputStream* input, MessageLite* msg,
                    const internal::TcParseTableBase* tc_table,
                    MessageLite::ParseFlags parse_flags) {
+  ProtozScope protoz(ProtozOperation::kParse, *msg);
+  const int64_t start_byte_count = input->ByteCount();
   const char* ptr;
   internal::ParseContext ctx(io::CodedInputStream::GetDefaultRecursionLimit(),
                              aliasing, &ptr, input);
   ptr = internal::TcParser::ParseLoop(msg, ptr, &ctx, tc_table);
+  protoz.RecordBytes(input->ByteCount() - start_byte_count);
   // ctx has no explicit limit (hence we end on end of stream)
   if (ABSL_PREDICT_TRUE(ptr && ctx.EndedAtEndOfStream())) {
     return CheckFieldPresence(ctx, *msg, parse_flags);
@@ -252,6 +353,8 @@ template <bool aliasing>
 bool MergeFromImpl(BoundedZCIS input, MessageLite* msg,
                    const internal::TcParseTableBase* tc_table,
                    MessageLite::ParseFlags parse_flags) {
+  ProtozScope protoz(ProtozOperation::kParse, *msg);
+  protoz.RecordBytes(input.limit);
   const char* ptr;
   internal::ParseContext ctx(io::CodedInputStream::GetDefaultRecursionLimit(),
                              aliasing, &ptr, input.zcis, input.limit);
@@ -317,7 +420,37 @@ class ZeroCopyCodedInputStream : public io::ZeroCopyInputStream {
 
 bool MessageLite::MergeFromImpl(io::CodedInputStream* input,
                                 MessageLite::ParseFlags parse_flags) {
+  internal::ProtozScope protoz(internal::ProtozOperation::kParse, *this);
+  // Without a limit the size is only known once the parse is done, so it is
+  // not recorded.
+  const int bytes_until_limit = input->BytesUntilLimit();
+  if (bytes_until_limit >= 0) protoz.RecordBytes(bytes_until_limit);
   ZeroCopyCodedInputStream zcis(input);
+  const void* data;
+  int size;
+  if (input->GetDirectBufferPointer(&data, &size) &&
+      size == input->BytesUntilLimit()) {
+    // Everything up to the current limit is already in the stream's buffer, so
+    // parse it in place instead of through the ZeroCopyInputStream adapter.
+    const char* ptr;
+    internal::ParseContext ctx(
+        input->RecursionBudget(), zcis.aliasing_enabled(), &ptr,
+        absl::string_view(static_cast<const char*>(data), size));
+    ctx.TrackCorrectEnding();
+    ctx.data().pool = input->GetExtensionPool();
+    ctx.data().factory = input->GetExtensionFactory();
+    ctx.data().discard_unknown_fields = input->DiscardUnknownFields();
+    ptr = internal::TcParser::ParseLoop(this, ptr, &ctx, GetTcParseTable());
+    if (ABSL_PREDICT_FALSE(!ptr)) return false;
+    input->Skip(size - ctx.FlatBytesRemaining(ptr));
+    if (ctx.EndedAtLimit()) {
+      input->SetConsumed();
+    } else {
+      input->SetLastTag(ctx.LastTag());
+    }
+    return CheckFieldPresence(ctx, *this, parse_flags);
+  }
+
   const char* ptr;
   internal::ParseContext ctx(input->RecursionBudget(), zcis.aliasing_enabled(),
                              &ptr, &zcis);
@@ -327,6 +460,7 @@ bool MessageLite::MergeFromImpl(io::CodedInputStream* input,
   ctx.TrackCorrectEnding();
   ctx.data().pool = input->GetExtensionPool();
   ctx.data().factory = input->GetExtensionFactory();
+  ctx.data().discard_unknown_fields = input->DiscardUnknownFields();
   ptr = internal::TcParser::ParseLoop(this, ptr, &ctx, GetTcParseTable());
   if (ABSL_PREDICT_FALSE(!ptr)) return false;
   ctx.BackUp(ptr);
@@ -466,6 +600,60 @@ bool MessageLite::ParsePartialFromString(const absl::Cord& data) {
   return ParseFrom<kParsePartial>(internal::SourceWrapper<absl::Cord>(&data));
 }
 
+namespace internal {
+
+template <>
+struct SourceWrapper<absl::Span<const absl::string_view>> {
+  explicit SourceWrapper(absl::Span<const absl::string_view> b) : buffers(b) {}
+  template <bool alias>
+  bool MergeInto(MessageLite* msg, const internal::TcParseTableBase* tc_table,
+                 MessageLite::ParseFlags parse_flags) const {
+    if (buffers.size() == 1) {
+      return MergeFromImpl<alias>(buffers[0], msg, tc_table, parse_flags);
+    }
+    size_t size = 0;
+    for (absl::string_view buffer : buffers) size += buffer.size();
+    // Like the other sources, the input is limited to 2GB.
+    if (size > static_cast<size_t>(INT_MAX)) return false;
+    ProtozScope protoz(ProtozOperation::kParse, *msg);
+    protoz.RecordBytes(size);
+    const char* ptr;
+    internal::ParseContext ctx(io::CodedInputStream::GetDefaultRecursionLimit(),
+                               alias, &ptr, buffers);
+    ptr = internal::TcParser::ParseLoop(msg, ptr, &ctx, tc_table);
+    if (ABSL_PREDICT_TRUE(ptr && ctx.EndedAtEndOfStream())) {
+      return CheckFieldPresence(ctx, *msg, parse_flags);
+    }
+    return false;
+  }
+
+  const absl::Span<const absl::string_view> buffers;
+};
+
+using BuffersSource = SourceWrapper<absl::Span<const absl::string_view>>;
+
+}  // namespace internal
+
+bool MessageLite::MergeFromBuffers(
+    absl::Span<const absl::string_view> buffers) {
+  return ParseFrom<kMerge>(internal::BuffersSource(buffers));
+}
+
+bool MessageLite::MergePartialFromBuffers(
+    absl::Span<const absl::string_view> buffers) {
+  return ParseFrom<kMergePartial>(internal::BuffersSource(buffers));
+}
+
+bool MessageLite::ParseFromBuffers(
+    absl::Span<const absl::string_view> buffers) {
+  return ParseFrom<kParse>(internal::BuffersSource(buffers));
+}
+
+bool MessageLite::ParsePartialFromBuffers(
+    absl::Span<const absl::string_view> buffers) {
+  return ParseFrom<kParsePartial>(internal::BuffersSource(buffers));
+}
+
 // ===================================================================
 
 inline uint8_t* SerializeToArrayImpl(const MessageLite& msg, uint8_t* target,
@@ -508,7 +696,9 @@ bool MessageLite::SerializeToCodedStream(io::CodedOutputStream* output) const {
 
 bool MessageLite::SerializePartialToCodedStream(
     io::CodedOutputStream* output) const {
+  internal::ProtozScope protoz(internal::ProtozOperation::kSerialize, *this);
   const size_t size = ByteSizeLong();  // Force size to be cached.
+  protoz.RecordBytes(size);
   if (size > INT_MAX) {
     ABSL_LOG(ERROR) << GetTypeName()
                     << " exceeded maximum protobuf size of 2GB: " << size;
@@ -539,7 +729,9 @@ bool MessageLite::SerializeToZeroCopyStream(
 
 bool MessageLite::SerializePartialToZeroCopyStream(
     io::ZeroCopyOutputStream* output) const {
+  internal::ProtozScope protoz(internal::ProtozOperation::kSerialize, *this);
   const size_t size = ByteSizeLong();  // Force size to be cached.
+  protoz.RecordBytes(size);
   if (size > INT_MAX) {
     ABSL_LOG(ERROR) << GetTypeName()
                     << " exceeded maximum protobuf size of 2GB: " << size;
@@ -586,8 +778,10 @@ bool MessageLite::AppendToString(std::string* output) const {
 }
 
 bool MessageLite::AppendPartialToString(std::string* output) const {
+  internal::ProtozScope protoz(internal::ProtozOperation::kSerialize, *this);
   size_t old_size = output->size();
   size_t byte_size = ByteSizeLong();
+  protoz.RecordBytes(byte_size);
   if (byte_size > INT_MAX) {
     ABSL_LOG(ERROR) << GetTypeName()
                     << " exceeded maximum protobuf size of 2GB: " << byte_size;
@@ -619,7 +813,9 @@ bool MessageLite::SerializeToArray(void* data, int size) const {
 }
 
 bool MessageLite::SerializePartialToArray(void* data, int size) const {
+  internal::ProtozScope protoz(internal::ProtozOperation::kSerialize, *this);
   const size_t byte_size = ByteSizeLong();
+  protoz.RecordBytes(byte_size);
   if (byte_size > INT_MAX) {
     ABSL_LOG(ERROR) << GetTypeName()
                     << " exceeded maximum protobuf size of 2GB: " << byte_size;
@@ -656,7 +852,9 @@ bool MessageLite::AppendToString(absl::Cord* output) const {
 bool MessageLite::AppendPartialToString(absl::Cord* output) const {
   // For efficiency, we'd like to pass a size hint to CordOutputStream with
   // the exact total size expected.
+  internal::ProtozScope protoz(internal::ProtozOperation::kSerialize, *this);
   const size_t size = ByteSizeLong();
+  protoz.RecordBytes(size);
   const size_t total_size = size + output->size();
   if (size > INT_MAX) {
     ABSL_LOG(ERROR) << "Exceeded maximum protobuf size of 2GB: " << size;
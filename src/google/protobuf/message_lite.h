@@ -33,6 +33,7 @@
 #include "absl/numeric/bits.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/explicitly_constructed.h"
 #include "google/protobuf/internal_visibility.h"
@@ -489,15 +490,23 @@ struct PROTOBUF_EXPORT DescriptorMethods {
 };
 
 struct PROTOBUF_EXPORT ClassDataFull : ClassData {
+  // The reflection objects of the type, which are only known at runtime. They
+  // are kept out of the ClassDataFull itself, so that it has no mutable state
+  // and its pages stay clean, and shared between forked processes.
+  struct ReflectionData {
+    const Reflection* reflection = nullptr;
+    const Descriptor* descriptor = nullptr;
+  };
+
   constexpr ClassDataFull(ClassData base,
                           const DescriptorMethods* descriptor_methods,
                           const internal::DescriptorTable* descriptor_table,
+                          ReflectionData* reflection_data,
                           void (*get_metadata_tracker)())
       : ClassData(base),
         descriptor_methods(descriptor_methods),
         descriptor_table(descriptor_table),
-        reflection(),
-        descriptor(),
+        reflection_data(reflection_data),
         get_metadata_tracker(get_metadata_tracker) {}
 
   constexpr const ClassData* base() const { return this; }
@@ -507,13 +516,12 @@ struct PROTOBUF_EXPORT ClassDataFull : ClassData {
   // Codegen types will provide a DescriptorTable to do lazy
   // registration/initialization of the reflection objects.
   // Other types, like DynamicMessage, keep the table as null but eagerly
-  // populate `reflection`/`descriptor` fields.
+  // populate `reflection_data`.
   const internal::DescriptorTable* descriptor_table;
   // Accesses are protected by the once_flag in `descriptor_table`. When the
-  // table is null these are populated from the beginning and need to
+  // table is null these are populated from the beginning and need no
   // protection.
-  mutable const Reflection* reflection;
-  mutable const Descriptor* descriptor;
+  ReflectionData* reflection_data;
 
   // When an access tracker is installed, this function notifies the tracker
   // that GetMetadata was called.
@@ -572,6 +580,20 @@ class PROTOBUF_EXPORT MessageLite {
   // if arena is a nullptr.
   MessageLite* New(Arena* arena) const;
 
+  // Like New(), but reuses a message of the same type that was given to
+  // ReturnToPool() on this thread, if there is one.  Reused messages are
+  // clear, but keep the capacity of their repeated and string fields.
+  // Ownership is passed to the caller.
+  MessageLite* NewFromPool() const;
+
+  // Deletes this message, which must not be on an arena, or keeps it for a
+  // later NewFromPool() of its type on this thread.  Up to
+  // kMaxPooledMessagesPerType messages per type are kept, and they are
+  // deleted when the thread exits.  Messages of dynamic types are always
+  // deleted.
+  void ReturnToPool();
+  static constexpr size_t kMaxPooledMessagesPerType = 16;
+
   // Returns the arena, if any, that directly owns this message and its internal
   // memory (Arena::Own is different in that the arena doesn't directly own the
   // internal memory). This method is used in proto's implementation for
@@ -696,6 +718,16 @@ class PROTOBUF_EXPORT MessageLite {
   // required fields.
   ABSL_ATTRIBUTE_REINITIALIZES bool ParsePartialFromArray(const void* data,
                                                           int size);
+  // Parses a protocol buffer split across the non-contiguous `buffers`, such
+  // as the pages of a network receive.  The buffers are read in order, as if
+  // concatenated, without copying them together or wrapping them in a
+  // ZeroCopyInputStream.
+  ABSL_ATTRIBUTE_REINITIALIZES bool ParseFromBuffers(
+      absl::Span<const absl::string_view> buffers);
+  // Like ParseFromBuffers(), but accepts messages that are missing
+  // required fields.
+  ABSL_ATTRIBUTE_REINITIALIZES bool ParsePartialFromBuffers(
+      absl::Span<const absl::string_view> buffers);
 
 
   // Reads a protocol buffer from the stream and merges it into this
@@ -727,6 +759,12 @@ class PROTOBUF_EXPORT MessageLite {
   bool MergePartialFromString(absl::string_view data);
   bool MergePartialFromString(const absl::Cord& data);
 
+  // Merge a protocol buffer split across non-contiguous buffers.
+  bool MergeFromBuffers(absl::Span<const absl::string_view> buffers);
+  // Like MergeFromBuffers(), but accepts messages that are missing required
+  // fields.
+  bool MergePartialFromBuffers(absl::Span<const absl::string_view> buffers);
+
 
   // Serialization ---------------------------------------------------
   // Methods for serializing in protocol buffer format.  Most of these
@@ -1050,7 +1088,8 @@ class PROTOBUF_EXPORT MessageLite {
     // Default:  when merging, pointer is followed and expanded (deep-copy).
     // Aliasing: when merging, the destination message is allowed to retain
     //           pointers to the original structure (shallow-copy). This mostly
-    //           is intended for use with STRING_PIECE.
+    //           is intended for use with STRING_PIECE. Large [ctype = CORD]
+    //           fields parsed from a flat buffer also reference it this way.
     // NOTE: STRING_PIECE is not recommended for new usage. Prefer Cords.
     kMergeWithAliasing = 4,
     kParseWithAliasing = 5,
@@ -1400,6 +1439,7 @@ template <bool test_call, typename MessageLite>
 PROTOBUF_ALWAYS_INLINE MessageLite* MessageCreator::New(
     const MessageLite* prototype_for_func,
     const MessageLite* prototype_for_copy, Arena* arena) const {
+  PROTOBUF_ARENA_TRACE_SCOPE(prototype_for_func->GetTypeName());
   return PlacementNew<test_call>(prototype_for_func, prototype_for_copy,
                                  arena != nullptr
                                      ? arena->AllocateAligned(allocation_size_)
@@ -0,0 +1,73 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/parallel_parse.h"
+
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/wire_format_lite.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+bool SplitRepeatedField(absl::string_view data, int field_number,
+                        std::vector<absl::string_view>* elements,
+                        std::string* rest) {
+  if (data.size() > static_cast<size_t>(INT_MAX)) return false;
+  const uint32_t element_tag = WireFormatLite::MakeTag(
+      field_number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  io::CodedInputStream input(reinterpret_cast<const uint8_t*>(data.data()),
+                             static_cast<int>(data.size()));
+  while (true) {
+    const int start = input.CurrentPosition();
+    const uint32_t tag = input.ReadTag();
+    if (tag == 0) {
+      // Either the end of the input or a malformed (or zero) tag.
+      return static_cast<size_t>(start) == data.size();
+    }
+    if (tag == element_tag) {
+      uint32_t length;
+      if (!input.ReadVarint32(&length) ||
+          length > data.size() - input.CurrentPosition()) {
+        return false;
+      }
+      elements->push_back(data.substr(input.CurrentPosition(), length));
+      input.Skip(static_cast<int>(length));
+      continue;
+    }
+    if (!WireFormatLite::SkipField(&input, tag)) return false;
+    rest->append(data.data() + start, input.CurrentPosition() - start);
+  }
+}
+
+size_t FieldInsertionPoint(absl::string_view data, int field_number) {
+  if (data.size() > static_cast<size_t>(INT_MAX)) return data.size();
+  io::CodedInputStream input(reinterpret_cast<const uint8_t*>(data.data()),
+                             static_cast<int>(data.size()));
+  while (true) {
+    const int start = input.CurrentPosition();
+    const uint32_t tag = input.ReadTag();
+    if (tag == 0) return data.size();
+    if (WireFormatLite::GetTagFieldNumber(tag) > field_number) return start;
+    if (!WireFormatLite::SkipField(&input, tag)) return data.size();
+  }
+}
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
@@ -0,0 +1,167 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Parsing of messages dominated by one large repeated message field, e.g.
+//
+//   message Batch {
+//     repeated Record records = 1;
+//   }
+//
+// on several threads. The serialized input is first scanned for the
+// length-delimited occurrences of the repeated field. The elements are then
+// split into chunks of roughly equal size that are parsed concurrently on a
+// caller-supplied executor and finally appended to the field in their original
+// order. When the message lives on an arena the elements are allocated on the
+// same arena, and each worker thread allocates from its own SerialArena.
+
+#ifndef GOOGLE_PROTOBUF_PARALLEL_PARSE_H__
+#define GOOGLE_PROTOBUF_PARALLEL_PARSE_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/repeated_ptr_field.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+
+struct ParallelParseOptions {
+  // Upper bound on the number of chunks the repeated field is split into. One
+  // chunk is always parsed on the calling thread.
+  int max_chunks = 8;
+  // Chunks are not made smaller than this many bytes of serialized elements,
+  // so that small inputs are parsed on the calling thread only.
+  size_t min_chunk_bytes = size_t{256} << 10;
+  // Runs `task`, typically on another thread. It is only called from the
+  // thread calling ParallelParseFromString(), which blocks until all tasks have
+  // finished. If empty, all chunks are parsed on the calling thread.
+  std::function<void(std::function<void()> task)> executor;
+};
+
+namespace internal {
+
+// Splits the serialized message `data` into the payloads of the
+// length-delimited occurrences of field `field_number`, which are appended to
+// `elements`, and the serialized remaining fields, which are appended to
+// `rest`. Returns false if `data` is not a well-formed message.
+PROTOBUF_EXPORT bool SplitRepeatedField(
+    absl::string_view data, int field_number,
+    std::vector<absl::string_view>* elements, std::string* rest);
+
+// Returns the offset of the first top-level field in the serialized message
+// `data` whose number is greater than `field_number`, or `data.size()` if
+// there is none.
+PROTOBUF_EXPORT size_t FieldInsertionPoint(absl::string_view data,
+                                           int field_number);
+
+// Runs `fn(chunk)` for every chunk in [0, num_chunks): chunk 0 on the calling
+// thread and the others through `executor`. Returns once all have finished.
+template <typename F>
+void RunChunks(const std::function<void(std::function<void()>)>& executor,
+               size_t num_chunks, F fn) {
+  absl::BlockingCounter pending(static_cast<int>(num_chunks - 1));
+  for (size_t chunk = 1; chunk < num_chunks; ++chunk) {
+    executor([&pending, &fn, chunk] {
+      fn(chunk);
+      pending.DecrementCount();
+    });
+  }
+  fn(size_t{0});
+  pending.Wait();
+}
+
+}  // namespace internal
+
+// Like `message->ParseFromString(data)`, but the elements of the repeated
+// message field `field_number` are parsed in parallel according to `options`.
+// `field` must be the repeated field of `*message` with that number, e.g.
+//
+//   ParallelParseFromString(data, Batch::kRecordsFieldNumber,
+//                           batch.mutable_records(), &batch, options);
+//
+// The result is the same as that of ParseFromString().
+template <typename Msg, typename Element>
+bool ParallelParseFromString(absl::string_view data, int field_number,
+                             RepeatedPtrField<Element>* field, Msg* message,
+                             const ParallelParseOptions& options = {}) {
+  message->Clear();
+  std::vector<absl::string_view> elements;
+  std::string rest;
+  if (!internal::SplitRepeatedField(data, field_number, &elements, &rest) ||
+      !message->MergePartialFromString(rest)) {
+    return false;
+  }
+
+  size_t total_bytes = 0;
+  for (absl::string_view element : elements) total_bytes += element.size();
+  size_t num_chunks = 1;
+  if (options.executor) {
+    num_chunks = std::min<size_t>(
+        {static_cast<size_t>(std::max(options.max_chunks, 1)),
+         total_bytes / std::max<size_t>(options.min_chunk_bytes, 1),
+         elements.size()});
+    num_chunks = std::max<size_t>(num_chunks, 1);
+  }
+
+  // Chunk boundaries, balanced by serialized size.
+  std::vector<size_t> begin(num_chunks + 1, elements.size());
+  begin[0] = 0;
+  size_t bytes = 0;
+  for (size_t i = 0, chunk = 1; i < elements.size() && chunk < num_chunks;
+       ++i) {
+    if (bytes >= total_bytes / num_chunks * chunk) begin[chunk++] = i;
+    bytes += elements[i].size();
+  }
+
+  Arena* arena = message->GetArena();
+  std::vector<std::vector<Element*>> parsed(num_chunks);
+  // Not std::vector<bool>: chunks write their result concurrently.
+  std::vector<char> ok(num_chunks, true);
+  auto parse_chunk = [&](size_t chunk) {
+    parsed[chunk].reserve(begin[chunk + 1] - begin[chunk]);
+    for (size_t i = begin[chunk]; i < begin[chunk + 1]; ++i) {
+      Element* element = Arena::Create<Element>(arena);
+      parsed[chunk].push_back(element);
+      if (!element->ParsePartialFromString(elements[i])) {
+        ok[chunk] = false;
+        return;
+      }
+    }
+  };
+
+  internal::RunChunks(options.executor, num_chunks, parse_chunk);
+
+  if (std::find(ok.begin(), ok.end(), false) != ok.end()) {
+    if (arena == nullptr) {
+      for (const auto& chunk : parsed) {
+        for (Element* element : chunk) delete element;
+      }
+    }
+    return false;
+  }
+  field->Reserve(field->size() + static_cast<int>(elements.size()));
+  for (const auto& chunk : parsed) {
+    for (Element* element : chunk) field->AddAllocated(element);
+  }
+  return message->IsInitialized();
+}
+
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_PARALLEL_PARSE_H__
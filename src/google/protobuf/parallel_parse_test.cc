@@ -0,0 +1,144 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/parallel_parse.h"
+
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/strings/string_view.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/unittest.pb.h"
+
+namespace google {
+namespace protobuf {
+namespace {
+
+using ::proto2_unittest::TestAllTypes;
+using ::proto2_unittest::TestRequiredForeign;
+
+constexpr int kNestedField = TestAllTypes::kRepeatedNestedMessageFieldNumber;
+
+TestAllTypes MakeMessage(int elements) {
+  TestAllTypes message;
+  message.set_optional_int32(7);
+  for (int i = 0; i < elements; ++i) {
+    message.add_repeated_nested_message()->set_bb(i);
+    message.add_repeated_string(std::string(i % 50, 'x'));
+  }
+  message.set_optional_string("done");
+  return message;
+}
+
+// Runs every task on its own thread and joins them on destruction.
+class ThreadExecutor {
+ public:
+  ~ThreadExecutor() {
+    for (std::thread& thread : threads_) thread.join();
+  }
+
+  std::function<void(std::function<void()>)> executor() {
+    return [this](std::function<void()> task) {
+      threads_.emplace_back(std::move(task));
+    };
+  }
+
+  int tasks() const { return static_cast<int>(threads_.size()); }
+
+ private:
+  std::vector<std::thread> threads_;
+};
+
+ParallelParseOptions SmallChunks(ThreadExecutor& threads) {
+  ParallelParseOptions options;
+  options.max_chunks = 4;
+  options.min_chunk_bytes = 1;
+  options.executor = threads.executor();
+  return options;
+}
+
+TEST(ParallelParseTest, MatchesSerialParse) {
+  const std::string data = MakeMessage(1000).SerializeAsString();
+  TestAllTypes expected;
+  ASSERT_TRUE(expected.ParseFromString(data));
+
+  ThreadExecutor threads;
+  TestAllTypes message;
+  message.set_optional_int64(1);  // Cleared by the parse.
+  ASSERT_TRUE(ParallelParseFromString(data, kNestedField,
+                                      message.mutable_repeated_nested_message(),
+                                      &message, SmallChunks(threads)));
+  EXPECT_EQ(threads.tasks(), 3);
+  EXPECT_EQ(message.SerializeAsString(), expected.SerializeAsString());
+}
+
+TEST(ParallelParseTest, ParsesOnArena) {
+  const std::string data = MakeMessage(1000).SerializeAsString();
+  Arena arena;
+  ThreadExecutor threads;
+  auto* message = Arena::Create<TestAllTypes>(&arena);
+  ASSERT_TRUE(ParallelParseFromString(
+      data, kNestedField, message->mutable_repeated_nested_message(), message,
+      SmallChunks(threads)));
+  ASSERT_EQ(message->repeated_nested_message_size(), 1000);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(message->repeated_nested_message(i).bb(), i);
+    EXPECT_EQ(message->repeated_nested_message(i).GetArena(), &arena);
+  }
+  EXPECT_EQ(message->optional_string(), "done");
+}
+
+TEST(ParallelParseTest, SmallInputStaysOnCallingThread) {
+  const std::string data = MakeMessage(10).SerializeAsString();
+  ThreadExecutor threads;
+  ParallelParseOptions options;
+  options.executor = threads.executor();
+  TestAllTypes message;
+  ASSERT_TRUE(ParallelParseFromString(data, kNestedField,
+                                      message.mutable_repeated_nested_message(),
+                                      &message, options));
+  EXPECT_EQ(threads.tasks(), 0);
+  EXPECT_EQ(message.repeated_nested_message_size(), 10);
+}
+
+TEST(ParallelParseTest, RejectsMalformedInput) {
+  std::string data = MakeMessage(100).SerializeAsString();
+  ThreadExecutor threads;
+  TestAllTypes message;
+  // Truncated in the middle of the last field.
+  EXPECT_FALSE(ParallelParseFromString(
+      absl::string_view(data).substr(0, data.size() - 1), kNestedField,
+      message.mutable_repeated_nested_message(), &message,
+      SmallChunks(threads)));
+
+  // A well-delimited element with a truncated varint inside.
+  data = MakeMessage(100).SerializeAsString() +
+         std::string("\x82\x03\x02\x08\x80", 5) +
+         MakeMessage(100).SerializeAsString();
+  EXPECT_FALSE(ParallelParseFromString(
+      data, kNestedField, message.mutable_repeated_nested_message(), &message,
+      SmallChunks(threads)));
+}
+
+TEST(ParallelParseTest, ChecksRequiredFields) {
+  TestRequiredForeign message;
+  message.add_repeated_message()->set_a(1);
+  const std::string data = message.SerializePartialAsString();
+  ThreadExecutor threads;
+  TestRequiredForeign parsed;
+  EXPECT_FALSE(ParallelParseFromString(
+      data, TestRequiredForeign::kRepeatedMessageFieldNumber,
+      parsed.mutable_repeated_message(), &parsed, SmallChunks(threads)));
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,143 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Serialization of messages dominated by one large repeated message field on
+// several threads; the counterpart of parallel_parse.h.
+//
+// Once the sizes of all elements are known, the offset of every element in the
+// output is known as well, so the elements can be written to their disjoint
+// ranges of a flat buffer concurrently. The output is byte-for-byte identical
+// to that of SerializePartialToArray().
+
+#ifndef GOOGLE_PROTOBUF_PARALLEL_SERIALIZE_H__
+#define GOOGLE_PROTOBUF_PARALLEL_SERIALIZE_H__
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "google/protobuf/arena.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/parallel_parse.h"
+#include "google/protobuf/repeated_ptr_field.h"
+#include "google/protobuf/wire_format_lite.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+
+// The elements are split into chunks the same way as for parsing. Computing
+// the element sizes is spread over `max_chunks` tasks, writing them is split
+// by serialized size.
+using ParallelSerializeOptions = ParallelParseOptions;
+
+// Like `message->SerializePartialToArray(data, size)`, but the elements of the
+// repeated message field `field_number` are sized and serialized in parallel
+// according to `options`. `field` must be the repeated field of `*message`
+// with that number.
+//
+// The field is briefly detached from `*message` to serialize the other fields,
+// so the message must not be accessed concurrently. Afterwards the cached size
+// of `*message` itself does not include the field; call ByteSizeLong() before
+// serializing it with cached sizes. Messages with unknown fields are
+// serialized serially, as their unknown fields follow all known fields.
+template <typename Msg, typename Element>
+bool SerializePartialToArrayParallel(
+    Msg* message, int field_number, RepeatedPtrField<Element>* field,
+    void* data, int size, const ParallelSerializeOptions& options = {}) {
+  if (!options.executor || !message->unknown_fields().empty()) {
+    return message->SerializePartialToArray(data, size);
+  }
+
+  const int n = field->size();
+  std::vector<size_t> element_size(n);
+  const size_t sizing_chunks = std::max<size_t>(
+      std::min<size_t>(static_cast<size_t>(std::max(options.max_chunks, 1)),
+                       static_cast<size_t>(n)),
+      1);
+  internal::RunChunks(options.executor, sizing_chunks, [&](size_t chunk) {
+    const int begin = static_cast<int>(n * chunk / sizing_chunks);
+    const int end = static_cast<int>(n * (chunk + 1) / sizing_chunks);
+    for (int i = begin; i < end; ++i) {
+      element_size[i] = field->Get(i).ByteSizeLong();
+    }
+  });
+
+  // Serialize everything else with the field detached. Known fields are
+  // written in field number order, so the elements go right before the first
+  // field with a greater number.
+  Arena* arena = message->GetArena();
+  RepeatedPtrField<Element> heap_detached;
+  RepeatedPtrField<Element>* detached =
+      arena == nullptr ? &heap_detached
+                       : Arena::Create<RepeatedPtrField<Element>>(arena);
+  field->UnsafeArenaSwap(detached);
+  std::string rest;
+  const bool ok = message->SerializePartialToString(&rest);
+  field->UnsafeArenaSwap(detached);
+  if (!ok) return false;
+  const size_t split = internal::FieldInsertionPoint(rest, field_number);
+
+  const uint32_t tag = internal::WireFormatLite::MakeTag(
+      field_number, internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  const size_t tag_size = io::CodedOutputStream::VarintSize32(tag);
+  std::vector<size_t> offset(n + 1);
+  offset[0] = split;
+  for (int i = 0; i < n; ++i) {
+    if (element_size[i] > static_cast<size_t>(INT_MAX)) return false;
+    offset[i + 1] = offset[i] + tag_size +
+                    io::CodedOutputStream::VarintSize32(
+                        static_cast<uint32_t>(element_size[i])) +
+                    element_size[i];
+  }
+  const size_t total = offset[n] + (rest.size() - split);
+  if (size < 0 || total > static_cast<size_t>(size)) return false;
+
+  uint8_t* target = static_cast<uint8_t*>(data);
+  memcpy(target, rest.data(), split);
+  memcpy(target + offset[n], rest.data() + split, rest.size() - split);
+
+  const size_t element_bytes = offset[n] - split;
+  const size_t num_chunks = std::max<size_t>(
+      std::min<size_t>(
+          {static_cast<size_t>(std::max(options.max_chunks, 1)),
+           element_bytes / std::max<size_t>(options.min_chunk_bytes, 1),
+           static_cast<size_t>(n)}),
+      1);
+  // Chunk boundaries, balanced by serialized size.
+  std::vector<int> begin(num_chunks + 1, n);
+  begin[0] = 0;
+  for (size_t chunk = 1; chunk < num_chunks; ++chunk) {
+    begin[chunk] = static_cast<int>(
+        std::lower_bound(offset.begin(), offset.end() - 1,
+                         split + element_bytes / num_chunks * chunk) -
+        offset.begin());
+  }
+  internal::RunChunks(options.executor, num_chunks, [&](size_t chunk) {
+    for (int i = begin[chunk]; i < begin[chunk + 1]; ++i) {
+      uint8_t* ptr = target + offset[i];
+      ptr = io::CodedOutputStream::WriteTagToArray(tag, ptr);
+      ptr = io::CodedOutputStream::WriteVarint32ToArray(
+          static_cast<uint32_t>(element_size[i]), ptr);
+      field->Get(i).SerializeWithCachedSizesToArray(ptr);
+    }
+  });
+  return true;
+}
+
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_PARALLEL_SERIALIZE_H__
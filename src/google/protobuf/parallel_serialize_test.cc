@@ -0,0 +1,127 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/parallel_serialize.h"
+
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "google/protobuf/arena.h"
+#include "google/protobuf/unittest.pb.h"
+
+namespace google {
+namespace protobuf {
+namespace {
+
+using ::proto2_unittest::TestAllTypes;
+
+constexpr int kNestedField = TestAllTypes::kRepeatedNestedMessageFieldNumber;
+
+void FillMessage(int elements, TestAllTypes* message) {
+  message->set_optional_int32(7);
+  for (int i = 0; i < elements; ++i) {
+    message->add_repeated_nested_message()->set_bb(i * 1000);
+    message->add_repeated_string(std::string(i % 50, 'x'));
+    message->add_repeated_foreign_message()->set_c(i);
+  }
+  message->set_optional_string("done");
+  message->set_default_int32(3);
+}
+
+// Runs every task on its own thread and joins them on destruction.
+class ThreadExecutor {
+ public:
+  ~ThreadExecutor() {
+    for (std::thread& thread : threads_) thread.join();
+  }
+
+  std::function<void(std::function<void()>)> executor() {
+    return [this](std::function<void()> task) {
+      threads_.emplace_back(std::move(task));
+    };
+  }
+
+ private:
+  std::vector<std::thread> threads_;
+};
+
+ParallelSerializeOptions SmallChunks(ThreadExecutor& threads) {
+  ParallelSerializeOptions options;
+  options.max_chunks = 4;
+  options.min_chunk_bytes = 1;
+  options.executor = threads.executor();
+  return options;
+}
+
+std::string SerializeParallel(TestAllTypes* message,
+                              const ParallelSerializeOptions& options) {
+  std::string out(message->ByteSizeLong(), '\0');
+  EXPECT_TRUE(SerializePartialToArrayParallel(
+      message, kNestedField, message->mutable_repeated_nested_message(),
+      &out[0], static_cast<int>(out.size()), options));
+  return out;
+}
+
+TEST(ParallelSerializeTest, MatchesSerialSerialization) {
+  TestAllTypes message;
+  FillMessage(1000, &message);
+  ThreadExecutor threads;
+  EXPECT_EQ(SerializeParallel(&message, SmallChunks(threads)),
+            message.SerializePartialAsString());
+  // The field is attached again.
+  EXPECT_EQ(message.repeated_nested_message_size(), 1000);
+}
+
+TEST(ParallelSerializeTest, MatchesSerialSerializationOnArena) {
+  Arena arena;
+  auto* message = Arena::Create<TestAllTypes>(&arena);
+  FillMessage(1000, message);
+  ThreadExecutor threads;
+  EXPECT_EQ(SerializeParallel(message, SmallChunks(threads)),
+            message->SerializePartialAsString());
+}
+
+TEST(ParallelSerializeTest, FieldIsLastOrOnly) {
+  TestAllTypes message;
+  for (int i = 0; i < 100; ++i) message.add_repeated_nested_message();
+  ThreadExecutor threads;
+  EXPECT_EQ(SerializeParallel(&message, SmallChunks(threads)),
+            message.SerializePartialAsString());
+
+  message.Clear();
+  message.set_optional_int32(1);
+  EXPECT_EQ(SerializeParallel(&message, SmallChunks(threads)),
+            message.SerializePartialAsString());
+}
+
+TEST(ParallelSerializeTest, UnknownFields) {
+  TestAllTypes message;
+  FillMessage(100, &message);
+  message.mutable_unknown_fields()->AddVarint(2000, 1);
+  message.mutable_unknown_fields()->AddVarint(3, 1);
+  ThreadExecutor threads;
+  EXPECT_EQ(SerializeParallel(&message, SmallChunks(threads)),
+            message.SerializePartialAsString());
+}
+
+TEST(ParallelSerializeTest, BufferTooSmall) {
+  TestAllTypes message;
+  FillMessage(100, &message);
+  std::string out(message.ByteSizeLong() - 1, '\0');
+  ThreadExecutor threads;
+  EXPECT_FALSE(SerializePartialToArrayParallel(
+      &message, kNestedField, message.mutable_repeated_nested_message(),
+      &out[0], static_cast<int>(out.size()), SmallChunks(threads)));
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
@@ -11,9 +11,12 @@
 #include <cstring>
 
 #include "absl/base/optimization.h"
+#include "absl/base/prefetch.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "google/protobuf/message_lite.h"
+#include "google/protobuf/port.h"
 #include "google/protobuf/repeated_field.h"
 #include "google/protobuf/wire_format_lite.h"
 #include "utf8_validity.h"
@@ -100,6 +103,12 @@ const char* EpsCopyInputStream::NextBuffer(int overrun, int depth) {
     while (StreamNext(&data)) {
       if (size_ > kSlopBytes) {
         // We got a large chunk
+        if (EnableParsePrefetch() && size_ > 192) {
+          // The copy below brings in the first cache line; the parse reads
+          // on from there once it leaves the patch buffer.
+          absl::PrefetchToLocalCache(static_cast<const char*>(data) + 64);
+          absl::PrefetchToLocalCache(static_cast<const char*>(data) + 128);
+        }
         std::memcpy(patch_buffer_ + kSlopBytes, data, kSlopBytes);
         next_chunk_ = static_cast<const char*>(data);
         buffer_end_ = patch_buffer_ + kSlopBytes;
@@ -216,7 +225,15 @@ const char* EpsCopyInputStream::ReadCordFallback(const char* ptr, int size,
   if (zcis_ == nullptr) {
     int bytes_from_buffer = buffer_end_ - ptr + kSlopBytes;
     if (size <= bytes_from_buffer) {
-      *cord = absl::string_view(ptr, size);
+      const char* input = AliasedInput(ptr);
+      if (input != nullptr && size > kMaxCordBytesToCopy) {
+        // Aliasing parses promise that the input outlives the message, so
+        // large values can reference it instead of being copied.
+        *cord = absl::MakeCordFromExternal(absl::string_view(input, size),
+                                           [] {});
+      } else {
+        *cord = absl::string_view(ptr, size);
+      }
       return ptr + size;
     }
     return AppendSize(ptr, size, [cord](const char* p, int s) {
@@ -269,11 +286,22 @@ const char* EpsCopyInputStream::ReadCordFallback(const char* ptr, int size,
 
 const char* EpsCopyInputStream::InitFrom(io::ZeroCopyInputStream* zcis) {
   zcis_ = zcis;
+  return InitFromFirstBuffer();
+}
+
+const char* EpsCopyInputStream::InitFrom(
+    absl::Span<const absl::string_view> chunks) {
+  ABSL_DCHECK(zcis_ == nullptr);
+  chunks_ = chunks.data();
+  chunks_end_ = chunks.data() + chunks.size();
+  return InitFromFirstBuffer();
+}
+
+const char* EpsCopyInputStream::InitFromFirstBuffer() {
   const void* data;
-  int size;
   limit_ = INT_MAX;
-  if (zcis->Next(&data, &size)) {
-    overall_limit_ -= size;
+  if (StreamNext(&data)) {
+    const int size = size_;
     if (size > kSlopBytes) {
       auto ptr = static_cast<const char*>(data);
       limit_ -= size - kSlopBytes;
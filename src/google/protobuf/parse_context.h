@@ -26,6 +26,7 @@
 #include "absl/strings/internal/resize_uninitialized.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/arenastring.h"
 #include "google/protobuf/endian.h"
@@ -103,6 +104,18 @@ inline void WriteLengthDelimited(uint32_t num, absl::string_view val,
 class PROTOBUF_EXPORT EpsCopyInputStream {
  public:
   enum { kMaxCordBytesToCopy = 512 };
+  // The readable bytes that must follow the data of a PaddedInput.
+  enum { kInputPaddingSize = 16 };
+
+  // A flat input that is followed by at least kInputPaddingSize readable
+  // bytes, such as a padded copy of a small input, so that it can be parsed
+  // in place up to its end. `source` is where the data was copied from, which
+  // aliased strings point into.
+  struct PaddedInput {
+    absl::string_view data;
+    const char* source;
+  };
+
   explicit EpsCopyInputStream(bool enable_aliasing)
       : aliasing_(enable_aliasing ? kOnPatch : kNoAliasing) {}
 
@@ -117,6 +130,16 @@ class PROTOBUF_EXPORT EpsCopyInputStream {
     if (count > 0) StreamBackUp(count);
   }
 
+  // For a stream initialized from a flat buffer, returns the number of bytes
+  // of that buffer that follow `ptr`.
+  int FlatBytesRemaining(const char* ptr) const {
+    ABSL_DCHECK(zcis_ == nullptr);
+    if (next_chunk_ == patch_buffer_) return BytesAvailable(ptr);
+    // The last bytes of the buffer are in the patch buffer, which ends at
+    // buffer_end_.
+    return static_cast<int>(buffer_end_ - ptr);
+  }
+
   // In sanitizer mode we use memory poisoning to guarantee that:
   //  - We do not read an uninitialized token.
   //  - We would like to verify that this token was consumed, but unfortunately
@@ -255,6 +278,9 @@ class PROTOBUF_EXPORT EpsCopyInputStream {
   int MaximumReadSize(const char* ptr) const {
     return static_cast<int>(limit_end_ - ptr) + kSlopBytes;
   }
+  // End of the bytes that can be read before the next buffer seam or limit,
+  // not counting the slop bytes that follow it.
+  const char* LimitEnd() const { return limit_end_; }
   // Returns true if more data is available, if false is returned one has to
   // call Done for further checks.
   bool DataAvailable(const char* ptr) { return ptr < limit_end_; }
@@ -303,7 +329,32 @@ class PROTOBUF_EXPORT EpsCopyInputStream {
     }
   }
 
+  const char* InitFrom(PaddedInput padded) {
+    overall_limit_ = 0;
+    limit_ = 0;
+    limit_end_ = buffer_end_ = padded.data.data() + padded.data.size();
+    next_chunk_ = nullptr;
+    if (aliasing_ == kOnPatch) {
+      aliasing_ = reinterpret_cast<std::uintptr_t>(padded.source) -
+                  reinterpret_cast<std::uintptr_t>(padded.data.data());
+    }
+    return padded.data.data();
+  }
+
   const char* InitFrom(io::ZeroCopyInputStream* zcis);
+  // Reads the concatenation of `chunks`, stepping through them directly
+  // instead of through the virtual calls of a ZeroCopyInputStream. The span
+  // and the chunks must outlive the parse.
+  const char* InitFrom(absl::Span<const absl::string_view> chunks);
+
+  // Returns where the byte at `ptr` lives in the caller's input buffer if the
+  // parse may alias it, or nullptr if it has no stable address there.
+  const char* AliasedInput(const char* ptr) const {
+    if (aliasing_ == kNoAliasing || aliasing_ == kOnPatch) return nullptr;
+    if (aliasing_ == kNoDelta) return ptr;
+    return reinterpret_cast<const char*>(reinterpret_cast<std::uintptr_t>(ptr) +
+                                         aliasing_);
+  }
 
   const char* InitFrom(io::ZeroCopyInputStream* zcis, int limit) {
     if (limit == -1) return InitFrom(zcis);
@@ -316,6 +367,8 @@ class PROTOBUF_EXPORT EpsCopyInputStream {
 
  private:
   enum { kSlopBytes = 16, kPatchBufferSize = 32 };
+  static_assert(kInputPaddingSize >= kSlopBytes,
+                "The parser may read kSlopBytes past the end of the data.");
   static_assert(kPatchBufferSize >= kSlopBytes * 2,
                 "Patch buffer needs to be at least large enough to hold all "
                 "the slop bytes from the previous buffer, plus the first "
@@ -327,6 +380,9 @@ class PROTOBUF_EXPORT EpsCopyInputStream {
   int size_;
   int limit_;  // relative to buffer_end_;
   io::ZeroCopyInputStream* zcis_ = nullptr;
+  // When reading a span of chunks, the next chunk and the end of the span.
+  const absl::string_view* chunks_ = nullptr;
+  const absl::string_view* chunks_end_ = nullptr;
   char patch_buffer_[kPatchBufferSize] = {};
   enum { kNoAliasing = 0, kOnPatch = 1, kNoDelta = 2 };
   std::uintptr_t aliasing_ = kNoAliasing;
@@ -382,12 +438,26 @@ class PROTOBUF_EXPORT EpsCopyInputStream {
   const char* ReadStringFallback(const char* ptr, int size, std::string* str);
   const char* ReadCordFallback(const char* ptr, int size, absl::Cord* cord);
   static bool ParseEndsInSlopRegion(const char* begin, int overrun, int depth);
+  // Loads the first buffer of the stream or of the chunks.
+  const char* InitFromFirstBuffer();
   bool StreamNext(const void** data) {
-    bool res = zcis_->Next(data, &size_);
+    bool res;
+    if (zcis_ != nullptr) {
+      res = zcis_->Next(data, &size_);
+    } else {
+      res = chunks_ != chunks_end_;
+      if (res) {
+        ABSL_DCHECK_LE(chunks_->size(), static_cast<size_t>(INT_MAX));
+        *data = chunks_->data();
+        size_ = static_cast<int>(chunks_->size());
+        ++chunks_;
+      }
+    }
     if (res) overall_limit_ -= size_;
     return res;
   }
   void StreamBackUp(int count) {
+    ABSL_DCHECK(zcis_ != nullptr);
     zcis_->BackUp(count);
     overall_limit_ += count;
   }
@@ -459,6 +529,9 @@ class PROTOBUF_EXPORT ParseContext : public EpsCopyInputStream {
   struct Data {
     const DescriptorPool* pool = nullptr;
     MessageFactory* factory = nullptr;
+    // If true, unknown fields are skipped instead of being stored in the
+    // message.  See CodedInputStream::SetDiscardUnknownFields().
+    bool discard_unknown_fields = false;
   };
 
   template <typename... T>
@@ -1174,6 +1247,17 @@ const char* EpsCopyInputStream::ReadPackedFixed(const char* ptr, int size,
                                                 RepeatedField<T>* out) {
   GOOGLE_PROTOBUF_PARSER_ASSERT(ptr);
   int nbytes = BytesAvailable(ptr);
+  if (size > nbytes && ABSL_PREDICT_TRUE(size <= BytesUntilLimit(ptr))) {
+    // The payload spans buffers. Grow the field once for the whole payload,
+    // up to a static safe size, so that the per-buffer copies below don't
+    // each reallocate. This protects against malicious payloads making
+    // protobuf hold on to a lot of memory, as for strings.
+    int64_t new_size =
+        int64_t{out->size()} +
+        std::min<int>(size, kSafeStringSize) / static_cast<int>(sizeof(T));
+    out->Reserve(static_cast<int>(
+        std::min(new_size, int64_t{std::numeric_limits<int32_t>::max()})));
+  }
   while (size > nbytes) {
     int num = nbytes / sizeof(T);
     int old_entries = out->size();
@@ -1213,6 +1297,20 @@ const char* EpsCopyInputStream::ReadPackedFixed(const char* ptr, int size,
 template <typename Add>
 const char* ReadPackedVarintArray(const char* ptr, const char* end, Add add) {
   while (ptr < end) {
+    // Packed payloads are frequently dominated by small values. Check a whole
+    // word at a time and, when none of the next 8 bytes has a continuation
+    // bit, emit them as 8 single byte varints without going through
+    // VarintParse.
+    while (end - ptr >= 8) {
+      uint64_t word;
+      std::memcpy(&word, ptr, sizeof(word));
+      if ((word & uint64_t{0x8080808080808080}) != 0) break;
+      for (int i = 0; i < 8; ++i) {
+        add(static_cast<uint64_t>(static_cast<uint8_t>(ptr[i])));
+      }
+      ptr += 8;
+    }
+    if (ptr >= end) break;
     uint64_t varint;
     ptr = VarintParse(ptr, &varint);
     if (ptr == nullptr) return nullptr;
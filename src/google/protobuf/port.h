@@ -301,6 +301,18 @@ constexpr bool DebugHardenFuzzMessageSpaceUsedLong() {
   return false;
 }
 
+// Returns true if the parser prefetches the repeated message elements it is
+// about to reuse and the input buffers it is about to read.  This only pays on
+// memory-bound machines, so it is enabled by building with
+// -DPROTOBUF_ENABLE_PARSE_PREFETCH.
+constexpr bool EnableParsePrefetch() {
+#if defined(PROTOBUF_ENABLE_PARSE_PREFETCH)
+  return true;
+#else
+  return false;
+#endif
+}
+
 // Reads n bytes from p, if PerformDebugChecks() is true. This allows ASAN to
 // detect if a range of memory is not valid when we expect it to be. The
 // volatile keyword is necessary here to prevent the compiler from optimizing
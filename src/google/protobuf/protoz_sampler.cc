@@ -0,0 +1,216 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/protoz_sampler.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "absl/base/optimization.h"
+#include "absl/functional/function_ref.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/message_lite.h"
+
+#if defined(PROTOBUF_PROTOZ_SAMPLE)
+#include "absl/base/attributes.h"
+#include "absl/base/internal/raw_logging.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/profiling/internal/exponential_biased.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#endif  // defined(PROTOBUF_PROTOZ_SAMPLE)
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+#if defined(PROTOBUF_PROTOZ_SAMPLE)
+
+struct ProtozActiveSample {
+  ProtozOperation op;
+  absl::string_view type_name;
+  int64_t weight;
+  int64_t start_nanos;
+  int64_t bytes;
+  int64_t fallback_fields;
+  Arena* arena;
+  uint64_t arena_space_before;
+  // The sample this one is nested in, restored when this one finishes.
+  ProtozActiveSample* parent;
+};
+
+namespace {
+
+PROTOBUF_CONSTINIT std::atomic<bool> g_protoz_enabled{true};
+PROTOBUF_CONSTINIT std::atomic<int32_t> g_protoz_sample_parameter{1 << 10};
+PROTOBUF_THREAD_LOCAL absl::profiling_internal::ExponentialBiased
+    g_protoz_exponential_biased_generator;
+
+struct ProtozRegistry {
+  absl::Mutex mu;
+  absl::flat_hash_map<std::string, ProtozStats> stats ABSL_GUARDED_BY(mu);
+};
+
+ProtozRegistry& GlobalProtozRegistry() {
+  static auto* registry = new ProtozRegistry();
+  return *registry;
+}
+
+// Returns the weight of the operation that just hit the end of its stride, or
+// zero if it should not be sampled after all.
+int64_t NextStride(ProtozSamplingState& sampling_state) {
+  bool first = sampling_state.next_sample < 0;
+  const int64_t next_stride = g_protoz_exponential_biased_generator.GetStride(
+      g_protoz_sample_parameter.load(std::memory_order_relaxed));
+  // Small values of interval are equivalent to just sampling next time.
+  ABSL_ASSERT(next_stride >= 1);
+  sampling_state.next_sample = next_stride;
+  const int64_t old_stride =
+      std::exchange(sampling_state.sample_stride, next_stride);
+
+  if (!g_protoz_enabled.load(std::memory_order_relaxed)) return 0;
+  // We will only be negative on our first count, so we should just retry in
+  // that case.
+  if (first) {
+    if (ABSL_PREDICT_TRUE(--sampling_state.next_sample > 0)) return 0;
+    return NextStride(sampling_state);
+  }
+  return old_stride;
+}
+
+}  // namespace
+
+PROTOBUF_THREAD_LOCAL ProtozSamplingState global_protoz_sampling_state = {
+    /*next_sample=*/0, /*sample_stride=*/0};
+PROTOBUF_THREAD_LOCAL ProtozActiveSample* protoz_active_sample = nullptr;
+
+void ProtozScope::StartSlow(ProtozOperation op, const MessageLite& msg) {
+  const int64_t weight = NextStride(global_protoz_sampling_state);
+  if (weight == 0) return;
+  Arena* arena = msg.GetArena();
+  sample_ = new ProtozActiveSample{
+      op,
+      msg.GetTypeName(),
+      weight,
+      /*start_nanos=*/0,
+      /*bytes=*/0,
+      /*fallback_fields=*/0,
+      arena,
+      arena != nullptr ? arena->SpaceAllocated() : 0,
+      std::exchange(protoz_active_sample, nullptr)};
+  protoz_active_sample = sample_;
+  // Read the clock last so that the setup above is not accounted to the
+  // operation.
+  sample_->start_nanos = absl::GetCurrentTimeNanos();
+}
+
+void ProtozScope::FinishSlow() {
+  const int64_t duration = absl::GetCurrentTimeNanos() - sample_->start_nanos;
+  const int64_t arena_bytes =
+      sample_->arena != nullptr ? static_cast<int64_t>(
+                                      sample_->arena->SpaceAllocated() -
+                                      sample_->arena_space_before)
+                                : 0;
+  protoz_active_sample = sample_->parent;
+
+  ProtozRegistry& registry = GlobalProtozRegistry();
+  {
+    absl::MutexLock lock(&registry.mu);
+    auto it = registry.stats.find(sample_->type_name);
+    if (it == registry.stats.end()) {
+      it = registry.stats
+               .emplace(std::string(sample_->type_name), ProtozStats())
+               .first;
+      it->second.type_name = it->first;
+    }
+    ProtozStats::OperationStats& stats =
+        it->second.operations[static_cast<int>(sample_->op)];
+    const int64_t weight = sample_->weight;
+    stats.count += weight;
+    stats.samples += 1;
+    stats.bytes += weight * sample_->bytes;
+    stats.duration_nanos += weight * duration;
+    stats.fallback_fields += weight * sample_->fallback_fields;
+    stats.arena_bytes_allocated += weight * arena_bytes;
+  }
+  delete std::exchange(sample_, nullptr);
+}
+
+void ProtozScope::RecordBytesSlow(size_t bytes) {
+  sample_->bytes = static_cast<int64_t>(bytes);
+}
+
+void ProtozScope::RecordFallbackFieldSlow() {
+  ++protoz_active_sample->fallback_fields;
+}
+
+void IterateProtozStats(absl::FunctionRef<void(const ProtozStats&)> f) {
+  ProtozRegistry& registry = GlobalProtozRegistry();
+  absl::MutexLock lock(&registry.mu);
+  for (const auto& entry : registry.stats) f(entry.second);
+}
+
+void ResetProtozStats() {
+  ProtozRegistry& registry = GlobalProtozRegistry();
+  absl::MutexLock lock(&registry.mu);
+  registry.stats.clear();
+}
+
+void SetProtozEnabled(bool enabled) {
+  g_protoz_enabled.store(enabled, std::memory_order_release);
+}
+
+bool IsProtozEnabled() {
+  return g_protoz_enabled.load(std::memory_order_acquire);
+}
+
+void SetProtozSampleParameter(int32_t rate) {
+  if (rate > 0) {
+    g_protoz_sample_parameter.store(rate, std::memory_order_release);
+  } else {
+    ABSL_RAW_LOG(ERROR, "Invalid protoz sample rate: %lld",
+                 static_cast<long long>(rate));  // NOLINT(runtime/int)
+  }
+}
+
+int32_t ProtozSampleParameter() {
+  return g_protoz_sample_parameter.load(std::memory_order_relaxed);
+}
+
+void SetProtozGlobalNextSample(int64_t next_sample) {
+  if (next_sample >= 0) {
+    global_protoz_sampling_state.next_sample = next_sample;
+    global_protoz_sampling_state.sample_stride = next_sample;
+  } else {
+    ABSL_RAW_LOG(ERROR, "Invalid protoz next sample: %lld",
+                 static_cast<long long>(next_sample));  // NOLINT(runtime/int)
+  }
+}
+
+#else
+void IterateProtozStats(absl::FunctionRef<void(const ProtozStats&)>) {}
+void ResetProtozStats() {}
+void SetProtozEnabled(bool) {}
+bool IsProtozEnabled() { return false; }
+void SetProtozSampleParameter(int32_t) {}
+int32_t ProtozSampleParameter() { return 0; }
+void SetProtozGlobalNextSample(int64_t) {}
+#endif  // defined(PROTOBUF_PROTOZ_SAMPLE)
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
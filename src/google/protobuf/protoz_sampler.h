@@ -0,0 +1,166 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// protoz samples a fraction of the parse, serialize and copy operations of
+// the runtime and aggregates what they cost per message type, in the spirit of
+// arenaz (see arenaz_sampler.h).  It is compiled in only when
+// PROTOBUF_PROTOZ_SAMPLE is defined; otherwise every hook below is an empty
+// inline function.
+
+#ifndef GOOGLE_PROTOBUF_PROTOZ_SAMPLER_H__
+#define GOOGLE_PROTOBUF_PROTOZ_SAMPLER_H__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "absl/base/optimization.h"
+#include "absl/functional/function_ref.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+
+class MessageLite;
+
+namespace internal {
+
+enum class ProtozOperation : int {
+  kParse = 0,
+  kSerialize = 1,
+  kCopy = 2,
+};
+inline constexpr int kNumProtozOperations = 3;
+
+// Aggregated cost of the sampled operations on one message type.  Counts are
+// weighted by the sampling stride, so they estimate the totals of all the
+// operations, not only of the sampled ones.
+struct ProtozStats {
+  struct OperationStats {
+    // Number of operations, and how many of them were actually sampled.
+    int64_t count = 0;
+    int64_t samples = 0;
+    // Encoded bytes parsed or serialized.  Zero for copies.
+    int64_t bytes = 0;
+    // Wall time spent in the operation.
+    int64_t duration_nanos = 0;
+    // Fields that missed the fast table and went through the generic
+    // (MiniParse) parser.  Only parses record these.
+    int64_t fallback_fields = 0;
+    // Bytes the operation allocated from the message's arena.  Heap
+    // allocations are not tracked.
+    int64_t arena_bytes_allocated = 0;
+  };
+
+  std::string type_name;
+  std::array<OperationStats, kNumProtozOperations> operations;
+
+  const OperationStats& operation(ProtozOperation op) const {
+    return operations[static_cast<int>(op)];
+  }
+};
+
+#if defined(PROTOBUF_PROTOZ_SAMPLE)
+
+struct ProtozSamplingState {
+  // Number of operations to run before the next one is sampled.
+  int64_t next_sample;
+  // The distance between the previous sample and the next one, used to weight
+  // the next sample.
+  int64_t sample_stride;
+};
+
+extern PROTOBUF_THREAD_LOCAL ProtozSamplingState global_protoz_sampling_state;
+
+struct ProtozActiveSample;
+// The sample running on this thread, if any.  Fallback fields are attributed
+// to it.
+extern PROTOBUF_THREAD_LOCAL ProtozActiveSample* protoz_active_sample;
+
+// Measures one operation if it is picked for sampling.  Instances must live on
+// the stack for exactly the duration of the operation.
+class ProtozScope {
+ public:
+  ProtozScope(ProtozOperation op, const MessageLite& msg) {
+    if (ABSL_PREDICT_TRUE(--global_protoz_sampling_state.next_sample > 0)) {
+      return;
+    }
+    StartSlow(op, msg);
+  }
+  ~ProtozScope() {
+    if (ABSL_PREDICT_FALSE(sample_ != nullptr)) FinishSlow();
+  }
+
+  ProtozScope(const ProtozScope&) = delete;
+  ProtozScope& operator=(const ProtozScope&) = delete;
+
+  // Records the number of encoded bytes the operation processed.
+  void RecordBytes(size_t bytes) {
+    if (ABSL_PREDICT_FALSE(sample_ != nullptr)) RecordBytesSlow(bytes);
+  }
+
+  // Called by the parser for each field that missed the fast table.
+  static void RecordFallbackField() {
+    if (ABSL_PREDICT_FALSE(protoz_active_sample != nullptr)) {
+      RecordFallbackFieldSlow();
+    }
+  }
+
+ private:
+  void StartSlow(ProtozOperation op, const MessageLite& msg);
+  void FinishSlow();
+  void RecordBytesSlow(size_t bytes);
+  static void RecordFallbackFieldSlow();
+
+  ProtozActiveSample* sample_ = nullptr;
+};
+
+#else  // PROTOBUF_PROTOZ_SAMPLE
+
+class ProtozScope {
+ public:
+  ProtozScope(ProtozOperation, const MessageLite&) {}
+
+  void RecordBytes(size_t) {}
+  static void RecordFallbackField() {}
+};
+
+#endif  // defined(PROTOBUF_PROTOZ_SAMPLE)
+
+// Calls `f` with the stats of every message type sampled so far, holding the
+// registry lock.  `f` must not run protobuf operations.
+void IterateProtozStats(absl::FunctionRef<void(const ProtozStats&)> f);
+
+// Drops all the stats collected so far.
+void ResetProtozStats();
+
+// Enables or disables sampling.
+void SetProtozEnabled(bool enabled);
+
+// Returns true if sampling is on, false otherwise.
+bool IsProtozEnabled();
+
+// Sets the mean number of operations between two samples.
+void SetProtozSampleParameter(int32_t rate);
+
+// Returns the mean number of operations between two samples.
+int32_t ProtozSampleParameter();
+
+// Sets the current value for when operations on this thread should be next
+// sampled.
+void SetProtozGlobalNextSample(int64_t next_sample);
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_PROTOZ_SAMPLER_H__
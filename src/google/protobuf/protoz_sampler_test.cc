@@ -0,0 +1,137 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/protoz_sampler.h"
+
+#include <cstdint>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "google/protobuf/test_util.h"
+#include "google/protobuf/unittest.pb.h"
+
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace internal {
+namespace {
+
+// Returns the stats recorded for `type_name`, or empty stats if there are
+// none.
+ProtozStats FindStats(const std::string& type_name) {
+  ProtozStats result;
+  IterateProtozStats([&](const ProtozStats& stats) {
+    if (stats.type_name == type_name) result = stats;
+  });
+  return result;
+}
+
+#if defined(PROTOBUF_PROTOZ_SAMPLE)
+
+class ProtozSamplerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    old_rate_ = ProtozSampleParameter();
+    SetProtozEnabled(true);
+    SetProtozSampleParameter(1);
+    SetProtozGlobalNextSample(1);
+    ResetProtozStats();
+  }
+  void TearDown() override {
+    SetProtozSampleParameter(old_rate_);
+    ResetProtozStats();
+  }
+
+ private:
+  int32_t old_rate_;
+};
+
+TEST_F(ProtozSamplerTest, RecordsParseSerializeAndCopy) {
+  proto2_unittest::TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  const std::string data = message.SerializeAsString();
+
+  proto2_unittest::TestAllTypes parsed;
+  ASSERT_TRUE(parsed.ParseFromString(data));
+  proto2_unittest::TestAllTypes copy;
+  static_cast<Message&>(copy).CopyFrom(parsed);
+
+  const ProtozStats stats = FindStats("proto2_unittest.TestAllTypes");
+  const auto& parse = stats.operation(ProtozOperation::kParse);
+  EXPECT_EQ(parse.count, 1);
+  EXPECT_EQ(parse.samples, 1);
+  EXPECT_EQ(parse.bytes, static_cast<int64_t>(data.size()));
+  EXPECT_GE(parse.duration_nanos, 0);
+  // The oneof fields are numbered past the fast table.
+  EXPECT_GT(parse.fallback_fields, 0);
+  EXPECT_EQ(parse.arena_bytes_allocated, 0);
+
+  const auto& serialize = stats.operation(ProtozOperation::kSerialize);
+  EXPECT_EQ(serialize.count, 1);
+  EXPECT_EQ(serialize.bytes, static_cast<int64_t>(data.size()));
+  EXPECT_EQ(serialize.fallback_fields, 0);
+
+  const auto& copy_stats = stats.operation(ProtozOperation::kCopy);
+  EXPECT_EQ(copy_stats.count, 1);
+  EXPECT_EQ(copy_stats.bytes, 0);
+}
+
+TEST_F(ProtozSamplerTest, SeparatesTypes) {
+  proto2_unittest::TestAllTypes all_types;
+  all_types.set_optional_int32(1);
+  proto2_unittest::ForeignMessage foreign;
+  foreign.set_c(2);
+  ASSERT_TRUE(all_types.ParseFromString(all_types.SerializeAsString()));
+  ASSERT_TRUE(foreign.ParseFromString(foreign.SerializeAsString()));
+  ASSERT_TRUE(foreign.ParseFromString(foreign.SerializeAsString()));
+
+  EXPECT_EQ(FindStats("proto2_unittest.TestAllTypes")
+                .operation(ProtozOperation::kParse)
+                .count,
+            1);
+  EXPECT_EQ(FindStats("proto2_unittest.ForeignMessage")
+                .operation(ProtozOperation::kParse)
+                .count,
+            2);
+}
+
+TEST_F(ProtozSamplerTest, DisabledRecordsNothing) {
+  SetProtozEnabled(false);
+  proto2_unittest::TestAllTypes message;
+  message.set_optional_int32(1);
+  ASSERT_TRUE(message.ParseFromString(message.SerializeAsString()));
+  SetProtozEnabled(true);
+
+  int types = 0;
+  IterateProtozStats([&](const ProtozStats&) { ++types; });
+  EXPECT_EQ(types, 0);
+}
+
+#else
+
+TEST(ProtozSamplerTest, CompiledOut) {
+  EXPECT_FALSE(IsProtozEnabled());
+  proto2_unittest::TestAllTypes message;
+  message.set_optional_int32(1);
+  ASSERT_TRUE(message.ParseFromString(message.SerializeAsString()));
+  EXPECT_EQ(FindStats("proto2_unittest.TestAllTypes")
+                .operation(ProtozOperation::kParse)
+                .count,
+            0);
+}
+
+#endif  // defined(PROTOBUF_PROTOZ_SAMPLE)
+
+}  // namespace
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
@@ -1207,6 +1207,7 @@ PROTOBUF_NOINLINE void RepeatedField<Element>::GrowNoAnnotate(bool was_soo,
     new_size = static_cast<int>(num_available);
     new_rep = static_cast<HeapRep*>(res.p);
   } else {
+    PROTOBUF_ARENA_TRACE_SCOPE("RepeatedField");
     new_rep =
         reinterpret_cast<HeapRep*>(Arena::CreateArray<char>(arena, bytes));
   }
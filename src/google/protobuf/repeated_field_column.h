@@ -0,0 +1,70 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Columnar export of repeated message fields.
+//
+// The elements of a RepeatedPtrField are separately allocated objects, so a
+// kernel scanning one scalar field of millions of small messages, e.g.
+//
+//   message Point {
+//     double x = 1;
+//     double y = 2;
+//     double z = 3;
+//   }
+//   repeated Point points = 1;
+//
+// chases a pointer per element. ExtractColumns() gathers the fields of interest
+// into contiguous RepeatedFields in one pass, prefetching the elements ahead
+// of use. The resulting columns convert to absl::Span without copying.
+
+#ifndef GOOGLE_PROTOBUF_REPEATED_FIELD_COLUMN_H__
+#define GOOGLE_PROTOBUF_REPEATED_FIELD_COLUMN_H__
+
+#include <utility>
+
+#include "absl/base/prefetch.h"
+#include "google/protobuf/repeated_field.h"
+#include "google/protobuf/repeated_ptr_field.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+
+// Appends `column.first(element)` to `*column.second` for every element of
+// `field` and every column, e.g.
+//
+//   RepeatedField<double> xs, ys;
+//   ExtractColumns(points,
+//                  std::make_pair([](const Point& p) { return p.x(); }, &xs),
+//                  std::make_pair([](const Point& p) { return p.y(); }, &ys));
+//   Kernel(absl::Span<const double>(xs), absl::Span<const double>(ys));
+//
+// All columns are filled in a single pass over the elements.
+template <typename Element, typename... Getters, typename... Ts>
+void ExtractColumns(const RepeatedPtrField<Element>& field,
+                    std::pair<Getters, RepeatedField<Ts>*>... columns) {
+  // Far enough ahead to hide the miss latency of an element or two.
+  constexpr int kPrefetchDistance = 8;
+  const int n = field.size();
+  (columns.second->Reserve(columns.second->size() + n), ...);
+  for (int i = 0; i < n; ++i) {
+    if (i + kPrefetchDistance < n) {
+      absl::PrefetchToLocalCache(&field.Get(i + kPrefetchDistance));
+    }
+    const Element& element = field.Get(i);
+    (columns.second->AddAlreadyReserved(columns.first(element)), ...);
+  }
+}
+
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_REPEATED_FIELD_COLUMN_H__
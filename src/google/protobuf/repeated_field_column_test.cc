@@ -0,0 +1,72 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/repeated_field_column.h"
+
+#include <cstdint>
+#include <utility>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/types/span.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/repeated_field.h"
+#include "google/protobuf/unittest.pb.h"
+
+namespace google {
+namespace protobuf {
+namespace {
+
+using ::proto2_unittest::ForeignMessage;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(RepeatedFieldColumnTest, ExtractsColumnsInOrder) {
+  Arena arena;
+  auto* field = Arena::Create<RepeatedPtrField<ForeignMessage>>(&arena);
+  for (int i = 0; i < 20; ++i) {
+    ForeignMessage* element = field->Add();
+    element->set_c(i);
+    element->set_d(-i);
+  }
+
+  RepeatedField<int32_t> c;
+  RepeatedField<int64_t> d;
+  c.Add(100);
+  ExtractColumns(
+      *field,
+      std::make_pair([](const ForeignMessage& m) { return m.c(); }, &c),
+      std::make_pair([](const ForeignMessage& m) { return m.d(); }, &d));
+
+  ASSERT_EQ(c.size(), 21);
+  ASSERT_EQ(d.size(), 20);
+  EXPECT_EQ(c[0], 100);
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_EQ(c[i + 1], i);
+    EXPECT_EQ(d[i], -i);
+  }
+  absl::Span<const int32_t> span(c);
+  EXPECT_EQ(span.data(), c.data());
+  EXPECT_EQ(span.size(), 21);
+}
+
+TEST(RepeatedFieldColumnTest, EmptyField) {
+  RepeatedPtrField<ForeignMessage> field;
+  RepeatedField<int32_t> c;
+  ExtractColumns(
+      field, std::make_pair([](const ForeignMessage& m) { return m.c(); }, &c));
+  EXPECT_THAT(c, IsEmpty());
+
+  field.Add()->set_c(5);
+  ExtractColumns(
+      field, std::make_pair([](const ForeignMessage& m) { return m.c(); }, &c));
+  EXPECT_THAT(c, ElementsAre(5));
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
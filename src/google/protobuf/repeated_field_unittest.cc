@@ -1244,6 +1244,36 @@ TEST(RepeatedField, InitialSooCapacity) {
   }
 }
 
+TEST(RepeatedField, ParsingSmallFieldsStaysInSoo) {
+  if (sizeof(void*) != 8) GTEST_SKIP() << "SOO is disabled on 32-bit.";
+  proto2_unittest::TestAllTypes unpacked;
+  unpacked.add_repeated_int32(1);
+  unpacked.add_repeated_int32(2);
+  unpacked.add_repeated_int64(3);
+  unpacked.add_repeated_bool(true);
+  unpacked.add_repeated_bool(false);
+  unpacked.add_repeated_bool(true);
+  proto2_unittest::TestPackedTypes packed;
+  packed.add_packed_int32(1);
+  packed.add_packed_int32(2);
+  packed.add_packed_double(3);
+
+  Arena arena;
+  auto* parsed_unpacked =
+      Arena::Create<proto2_unittest::TestAllTypes>(&arena);
+  auto* parsed_packed = Arena::Create<proto2_unittest::TestPackedTypes>(&arena);
+  ASSERT_TRUE(parsed_unpacked->ParseFromString(unpacked.SerializeAsString()));
+  ASSERT_TRUE(parsed_packed->ParseFromString(packed.SerializeAsString()));
+
+  EXPECT_EQ(parsed_unpacked->repeated_int32().SpaceUsedExcludingSelf(), 0);
+  EXPECT_EQ(parsed_unpacked->repeated_int64().SpaceUsedExcludingSelf(), 0);
+  EXPECT_EQ(parsed_unpacked->repeated_bool().SpaceUsedExcludingSelf(), 0);
+  EXPECT_EQ(parsed_packed->packed_int32().SpaceUsedExcludingSelf(), 0);
+  EXPECT_EQ(parsed_packed->packed_double().SpaceUsedExcludingSelf(), 0);
+  EXPECT_THAT(parsed_unpacked->repeated_int32(), testing::ElementsAre(1, 2));
+  EXPECT_THAT(parsed_packed->packed_double(), testing::ElementsAre(3));
+}
+
 // ===================================================================
 
 // Iterator tests stolen from net/proto/proto-array_unittest.
@@ -63,6 +63,7 @@ void** RepeatedPtrFieldBase::InternalExtend(int extend_amount) {
       new_capacity = static_cast<int>((alloc.n - kRepHeaderSize) / kPtrSize);
       new_rep = reinterpret_cast<Rep*>(alloc.p);
     } else {
+      PROTOBUF_ARENA_TRACE_SCOPE("RepeatedPtrField");
       auto* alloc = Arena::CreateArray<char>(arena, new_size);
       new_rep = reinterpret_cast<Rep*>(alloc);
     }
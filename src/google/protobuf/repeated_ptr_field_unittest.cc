@@ -144,6 +144,52 @@ TEST(RepeatedPtrField, ClearThenReserveMore) {
   // strings.
 }
 
+TEST(RepeatedPtrField, MoveAddKeepsCapacityOfClearedString) {
+  RepeatedPtrField<std::string> field;
+  field.Add(std::string(64, 'x'));
+  const char* buffer = field.Get(0).data();
+  field.Clear();
+
+  field.Add(std::string(48, 'y'));
+  EXPECT_EQ(field.Get(0), std::string(48, 'y'));
+  EXPECT_EQ(field.Get(0).data(), buffer);
+  EXPECT_LE(64, field.Get(0).capacity());
+}
+
+TEST(RepeatedPtrField, ParseReusesClearedElements) {
+  TestAllTypes source;
+  for (int i = 0; i < 4; ++i) {
+    source.add_repeated_string(std::string(64, 'a' + i));
+    source.add_repeated_nested_message()->set_bb(i);
+  }
+  const std::string data = source.SerializeAsString();
+
+  TestAllTypes message;
+  ASSERT_TRUE(message.ParseFromString(data));
+  std::vector<const void*> elements;
+  for (const std::string& s : message.repeated_string()) {
+    elements.push_back(&s);
+    elements.push_back(s.data());
+  }
+  for (const auto& m : message.repeated_nested_message()) {
+    elements.push_back(&m);
+  }
+
+  for (int round = 0; round < 3; ++round) {
+    ASSERT_TRUE(message.ParseFromString(data));
+    EXPECT_EQ(message.SerializeAsString(), data);
+    std::vector<const void*> reused;
+    for (const std::string& s : message.repeated_string()) {
+      reused.push_back(&s);
+      reused.push_back(s.data());
+    }
+    for (const auto& m : message.repeated_nested_message()) {
+      reused.push_back(&m);
+    }
+    EXPECT_EQ(reused, elements);
+  }
+}
+
 // This helper overload set tests whether X::f can be called with a braced pair,
 // X::f({a, b}) of std::string iterators (specifically, pointers: That call is
 // ambiguous if and only if the call to ValidResolutionPointerRange is not.
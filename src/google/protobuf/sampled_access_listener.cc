@@ -0,0 +1,128 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/sampled_access_listener.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "absl/base/internal/raw_logging.h"
+#include "absl/base/optimization.h"
+#include "absl/functional/function_ref.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+namespace {
+
+PROTOBUF_CONSTINIT std::atomic<FieldAccessSamplerState*>
+    g_field_access_samplers{nullptr};
+PROTOBUF_CONSTINIT std::atomic<int32_t> g_field_access_sample_rate{1000};
+// Number of accesses to sampled types left before the next sample on this
+// thread.
+PROTOBUF_THREAD_LOCAL int32_t field_access_countdown = 0;
+
+template <typename F>
+void ForEachSampler(F f) {
+  for (FieldAccessSamplerState* state =
+           g_field_access_samplers.load(std::memory_order_acquire);
+       state != nullptr; state = state->next) {
+    f(*state);
+  }
+}
+
+}  // namespace
+
+void RegisterFieldAccessSampler(FieldAccessSamplerState* state) {
+  FieldAccessSamplerState* head =
+      g_field_access_samplers.load(std::memory_order_relaxed);
+  do {
+    state->next = head;
+  } while (!g_field_access_samplers.compare_exchange_weak(
+      head, state, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void RecordSampledFieldAccess(FieldAccessSamplerState& state, int field_index,
+                              bool write) {
+  if (ABSL_PREDICT_TRUE(--field_access_countdown > 0)) return;
+  const int32_t rate =
+      g_field_access_sample_rate.load(std::memory_order_relaxed);
+  field_access_countdown = rate;
+  std::atomic<uint64_t>* counters = write ? state.writes : state.reads;
+  counters[field_index].fetch_add(static_cast<uint64_t>(rate),
+                                  std::memory_order_relaxed);
+}
+
+void SetFieldAccessSampling(absl::string_view type_name, bool sampled) {
+  ForEachSampler([&](FieldAccessSamplerState& state) {
+    if (type_name.empty() || state.name() == type_name) {
+      state.sampled.store(sampled, std::memory_order_relaxed);
+    }
+  });
+}
+
+void SetFieldAccessSampleRate(int32_t rate) {
+  if (rate > 0) {
+    g_field_access_sample_rate.store(rate, std::memory_order_relaxed);
+  } else {
+    ABSL_RAW_LOG(ERROR, "Invalid field access sample rate: %lld",
+                 static_cast<long long>(rate));  // NOLINT(runtime/int)
+  }
+}
+
+void IterateSampledFieldAccesses(
+    absl::FunctionRef<void(const SampledFieldAccess&)> f) {
+  ForEachSampler([&](FieldAccessSamplerState& state) {
+    for (int i = 0; i < state.num_fields; ++i) {
+      const uint64_t reads = state.reads[i].load(std::memory_order_relaxed);
+      const uint64_t writes = state.writes[i].load(std::memory_order_relaxed);
+      if (reads != 0 || writes != 0) f({state.name(), i, reads, writes});
+    }
+  });
+}
+
+void ResetSampledFieldAccesses() {
+  ForEachSampler([&](FieldAccessSamplerState& state) {
+    for (int i = 0; i < state.num_fields; ++i) {
+      state.reads[i].store(0, std::memory_order_relaxed);
+      state.writes[i].store(0, std::memory_order_relaxed);
+    }
+  });
+}
+
+std::string SampledFieldAccessesDebugString() {
+  std::vector<SampledFieldAccess> all;
+  IterateSampledFieldAccesses(
+      [&](const SampledFieldAccess& access) { all.push_back(access); });
+  std::sort(all.begin(), all.end(),
+            [](const SampledFieldAccess& a, const SampledFieldAccess& b) {
+              return std::tie(a.type_name, a.field_index) <
+                     std::tie(b.type_name, b.field_index);
+            });
+  std::string out;
+  for (const SampledFieldAccess& access : all) {
+    absl::StrAppendFormat(&out, "%s %d %d %d\n", access.type_name,
+                          access.field_index, access.reads, access.writes);
+  }
+  return out;
+}
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
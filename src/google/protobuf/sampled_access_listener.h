@@ -0,0 +1,202 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// A field access listener (see field_access_listener.h) that samples accessor
+// calls and counts them per field, cheaply enough to stay on in production.
+//
+// It is used as the AccessListener when compiling with
+// -DPROTOBUF_SAMPLED_FIELD_ACCESS, for code generated with the
+// `inject_field_listener_events` option.  Until sampling is turned on for a
+// message type, each accessor of that type only tests one bit.  Once it is on,
+// one in `rate` accesses is counted, with relaxed atomic increments, in
+// counters that belong to the type.  The counts are meant to be turned into a
+// field usage profile for profile guided code generation.
+
+#ifndef GOOGLE_PROTOBUF_SAMPLED_ACCESS_LISTENER_H__
+#define GOOGLE_PROTOBUF_SAMPLED_ACCESS_LISTENER_H__
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "absl/base/optimization.h"
+#include "absl/functional/function_ref.h"
+#include "absl/strings/string_view.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+
+class MessageLite;
+
+namespace internal {
+
+// The sampling state and counters of one message type.
+struct FieldAccessSamplerState {
+  // Whether accesses to this type are sampled.
+  std::atomic<bool> sampled;
+  // Returns the full name of the type, set once the type is registered.
+  absl::string_view (*name)();
+  int num_fields;
+  // Estimated reads and writes of each field, indexed by field index, weighted
+  // by the sampling rate.
+  std::atomic<uint64_t>* reads;
+  std::atomic<uint64_t>* writes;
+  // The next registered type.
+  FieldAccessSamplerState* next;
+};
+
+// Adds `state` to the types whose accesses can be sampled.  Lock free, so that
+// it can run during static initialization.
+PROTOBUF_EXPORT void RegisterFieldAccessSampler(FieldAccessSamplerState* state);
+
+// Counts an access to `field_index` if this one is picked by the sampler.
+PROTOBUF_EXPORT void RecordSampledFieldAccess(FieldAccessSamplerState& state,
+                                              int field_index, bool write);
+
+template <typename Proto>
+class SampledAccessListener {
+ public:
+  static constexpr int kFields = Proto::_kInternalFieldNumber;
+
+  // Runs during static initialization, see NoOpAccessListener.
+  explicit SampledAccessListener(absl::string_view (*name_extractor)()) {
+    state_.name = name_extractor;
+    RegisterFieldAccessSampler(&state_);
+  }
+
+  // Whole message operations are not sampled.
+  static void OnSerialize(const MessageLite*) {}
+  static void OnDeserialize(const MessageLite*) {}
+  static void OnByteSize(const MessageLite*) {}
+  static void OnMergeFrom(const MessageLite*, const MessageLite*) {}
+  static void OnGetMetadata() {}
+  static void OnUnknownFields(const MessageLite*) {}
+  static void OnMutableUnknownFields(const MessageLite*) {}
+
+  template <int kFieldIndex>
+  static void OnGet(const MessageLite*, const void*) {
+    Record<kFieldIndex>(false);
+  }
+  template <int kFieldIndex>
+  static void OnHas(const MessageLite*, const void*) {
+    Record<kFieldIndex>(false);
+  }
+  template <int kFieldIndex>
+  static void OnSize(const MessageLite*, const void*) {
+    Record<kFieldIndex>(false);
+  }
+  template <int kFieldIndex>
+  static void OnList(const MessageLite*, const void*) {
+    Record<kFieldIndex>(false);
+  }
+  template <int kFieldIndex>
+  static void OnSet(const MessageLite*, const void*) {
+    Record<kFieldIndex>(true);
+  }
+  template <int kFieldIndex>
+  static void OnMutable(const MessageLite*, const void*) {
+    Record<kFieldIndex>(true);
+  }
+  template <int kFieldIndex>
+  static void OnRelease(const MessageLite*, const void*) {
+    Record<kFieldIndex>(true);
+  }
+  template <int kFieldIndex>
+  static void OnClear(const MessageLite*, const void*) {
+    Record<kFieldIndex>(true);
+  }
+  template <int kFieldIndex>
+  static void OnMutableList(const MessageLite*, const void*) {
+    Record<kFieldIndex>(true);
+  }
+  template <int kFieldIndex>
+  static void OnAdd(const MessageLite*, const void*) {
+    Record<kFieldIndex>(true);
+  }
+  template <int kFieldIndex>
+  static void OnAddMutable(const MessageLite*, const void*) {
+    Record<kFieldIndex>(true);
+  }
+
+  // Extensions have no field index, and are not sampled.
+  static void OnHasExtension(const MessageLite*, int, const void*) {}
+  static void OnClearExtension(const MessageLite*, int, const void*) {}
+  static void OnExtensionSize(const MessageLite*, int, const void*) {}
+  static void OnGetExtension(const MessageLite*, int, const void*) {}
+  static void OnMutableExtension(const MessageLite*, int, const void*) {}
+  static void OnSetExtension(const MessageLite*, int, const void*) {}
+  static void OnReleaseExtension(const MessageLite*, int, const void*) {}
+  static void OnAddExtension(const MessageLite*, int, const void*) {}
+  static void OnAddMutableExtension(const MessageLite*, int, const void*) {}
+  static void OnListExtension(const MessageLite*, int, const void*) {}
+  static void OnMutableListExtension(const MessageLite*, int, const void*) {}
+
+ private:
+  // Zero sized arrays are not allowed.
+  static constexpr int kCounters = kFields > 0 ? kFields : 1;
+
+  template <int kFieldIndex>
+  static void Record(bool write) {
+    static_assert(kFieldIndex >= 0 && kFieldIndex < kFields, "");
+    if (ABSL_PREDICT_FALSE(state_.sampled.load(std::memory_order_relaxed))) {
+      RecordSampledFieldAccess(state_, kFieldIndex, write);
+    }
+  }
+
+  static std::atomic<uint64_t> reads_[kCounters];
+  static std::atomic<uint64_t> writes_[kCounters];
+  static FieldAccessSamplerState state_;
+};
+
+template <typename Proto>
+PROTOBUF_CONSTINIT std::atomic<uint64_t>
+    SampledAccessListener<Proto>::reads_[kCounters] = {};
+template <typename Proto>
+PROTOBUF_CONSTINIT std::atomic<uint64_t>
+    SampledAccessListener<Proto>::writes_[kCounters] = {};
+template <typename Proto>
+PROTOBUF_CONSTINIT FieldAccessSamplerState
+    SampledAccessListener<Proto>::state_ = {
+        /*sampled=*/{false}, /*name=*/nullptr, kFields, reads_, writes_,
+        /*next=*/nullptr};
+
+struct SampledFieldAccess {
+  absl::string_view type_name;
+  int field_index;
+  uint64_t reads;
+  uint64_t writes;
+};
+
+// Turns sampling on or off for the type named `type_name`, or for every type if
+// it is empty.
+PROTOBUF_EXPORT void SetFieldAccessSampling(absl::string_view type_name,
+                                            bool sampled);
+
+// Samples one in `rate` accesses of the sampled types.  Defaults to 1000.
+PROTOBUF_EXPORT void SetFieldAccessSampleRate(int32_t rate);
+
+// Calls `f` for every field with sampled accesses.
+PROTOBUF_EXPORT void IterateSampledFieldAccesses(
+    absl::FunctionRef<void(const SampledFieldAccess&)> f);
+
+// Drops all the counts sampled so far.
+PROTOBUF_EXPORT void ResetSampledFieldAccesses();
+
+// Returns the counts as text, one field per line:
+//   <type name> <field index> <reads> <writes>
+PROTOBUF_EXPORT std::string SampledFieldAccessesDebugString();
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_SAMPLED_ACCESS_LISTENER_H__
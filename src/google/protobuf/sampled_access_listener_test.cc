@@ -0,0 +1,97 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/sampled_access_listener.h"
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+#include "absl/strings/string_view.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace internal {
+namespace {
+
+// Stands in for a generated message with three fields.
+struct FakeMessage {
+  static constexpr int _kInternalFieldNumber = 3;
+  static absl::string_view FullMessageName() { return "test.FakeMessage"; }
+};
+
+using Listener = SampledAccessListener<FakeMessage>;
+Listener tracker(&FakeMessage::FullMessageName);
+
+SampledFieldAccess FindAccess(int field_index) {
+  SampledFieldAccess result = {"", field_index, 0, 0};
+  IterateSampledFieldAccesses([&](const SampledFieldAccess& access) {
+    if (access.type_name == "test.FakeMessage" &&
+        access.field_index == field_index) {
+      result = access;
+    }
+  });
+  return result;
+}
+
+class SampledAccessListenerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    SetFieldAccessSampleRate(1);
+    ResetSampledFieldAccesses();
+  }
+  void TearDown() override {
+    SetFieldAccessSampling("", false);
+    SetFieldAccessSampleRate(1000);
+    ResetSampledFieldAccesses();
+  }
+};
+
+TEST_F(SampledAccessListenerTest, RecordsNothingUntilSampled) {
+  Listener::OnGet<0>(nullptr, nullptr);
+  Listener::OnSet<1>(nullptr, nullptr);
+  EXPECT_EQ(SampledFieldAccessesDebugString(), "");
+}
+
+TEST_F(SampledAccessListenerTest, CountsReadsAndWritesPerField) {
+  SetFieldAccessSampling("test.FakeMessage", true);
+  Listener::OnGet<0>(nullptr, nullptr);
+  Listener::OnHas<0>(nullptr, nullptr);
+  Listener::OnSize<0>(nullptr, nullptr);
+  Listener::OnSet<2>(nullptr, nullptr);
+  Listener::OnMutable<2>(nullptr, nullptr);
+
+  EXPECT_EQ(FindAccess(0).reads, 3);
+  EXPECT_EQ(FindAccess(0).writes, 0);
+  EXPECT_EQ(FindAccess(1).reads, 0);
+  EXPECT_EQ(FindAccess(2).writes, 2);
+  EXPECT_EQ(SampledFieldAccessesDebugString(),
+            "test.FakeMessage 0 3 0\n"
+            "test.FakeMessage 2 0 2\n");
+}
+
+TEST_F(SampledAccessListenerTest, SamplingIsPerType) {
+  SetFieldAccessSampling("test.OtherMessage", true);
+  Listener::OnGet<0>(nullptr, nullptr);
+  EXPECT_EQ(FindAccess(0).reads, 0);
+}
+
+TEST_F(SampledAccessListenerTest, WeightsSamplesByRate) {
+  SetFieldAccessSampleRate(4);
+  SetFieldAccessSampling("", true);
+  for (int i = 0; i < 8; ++i) Listener::OnGet<1>(nullptr, nullptr);
+  EXPECT_EQ(FindAccess(1).reads, 8);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
@@ -182,6 +182,9 @@ constexpr auto SourceContext::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(SourceContext),
                                             alignof(SourceContext));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    SourceContext_reflection_data_;
+
 constexpr auto SourceContext::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -201,6 +204,7 @@ constexpr auto SourceContext::InternalGenerateClassData_() {
       },
       &SourceContext::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fsource_5fcontext_2eproto,
+      &SourceContext_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -308,6 +312,13 @@ PROTOBUF_NOINLINE void SourceContext::Clear() {
 ::size_t SourceContext::ByteSizeLong() const {
   const SourceContext& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t SourceContext::UncachedByteSizeLong() const {
+  const SourceContext& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.SourceContext)
   ::size_t total_size = 0;
 
@@ -325,8 +336,11 @@ PROTOBUF_NOINLINE void SourceContext::Clear() {
       }
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void SourceContext::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -253,6 +253,9 @@ constexpr auto Struct_FieldsEntry_DoNotUse::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(Struct_FieldsEntry_DoNotUse),
                                             alignof(Struct_FieldsEntry_DoNotUse));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Struct_FieldsEntry_DoNotUse_reflection_data_;
+
 constexpr auto Struct_FieldsEntry_DoNotUse::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -273,6 +276,7 @@ constexpr auto Struct_FieldsEntry_DoNotUse::InternalGenerateClassData_() {
       },
       &Struct_FieldsEntry_DoNotUse::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fstruct_2eproto,
+      &Struct_FieldsEntry_DoNotUse_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -415,6 +419,9 @@ constexpr auto Struct::InternalNewImpl_() {
                                  alignof(Struct));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Struct_reflection_data_;
+
 constexpr auto Struct::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -434,6 +441,7 @@ constexpr auto Struct::InternalGenerateClassData_() {
       },
       &Struct::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fstruct_2eproto,
+      &Struct_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -727,22 +735,10 @@ void Value::clear_kind() {
 // @@protoc_insertion_point(one_of_clear_start:google.protobuf.Value)
   ::google::protobuf::internal::TSanWrite(&_impl_);
   switch (kind_case()) {
-    case kNullValue: {
-      // No need to clear
-      break;
-    }
-    case kNumberValue: {
-      // No need to clear
-      break;
-    }
     case kStringValue: {
       _impl_.kind_.string_value_.Destroy();
       break;
     }
-    case kBoolValue: {
-      // No need to clear
-      break;
-    }
     case kStructValue: {
       if (GetArena() == nullptr) {
         delete _impl_.kind_.struct_value_;
@@ -759,7 +755,7 @@ void Value::clear_kind() {
       }
       break;
     }
-    case KIND_NOT_SET: {
+    default: {
       break;
     }
   }
@@ -776,6 +772,9 @@ constexpr auto Value::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(Value),
                                             alignof(Value));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Value_reflection_data_;
+
 constexpr auto Value::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -795,6 +794,7 @@ constexpr auto Value::InternalGenerateClassData_() {
       },
       &Value::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fstruct_2eproto,
+      &Value_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -1154,6 +1154,9 @@ constexpr auto ListValue::InternalNewImpl_() {
                                  alignof(ListValue));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    ListValue_reflection_data_;
+
 constexpr auto ListValue::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -1173,6 +1176,7 @@ constexpr auto ListValue::InternalGenerateClassData_() {
       },
       &ListValue::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fstruct_2eproto,
+      &ListValue_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -28,6 +28,7 @@
 
 #include "absl/base/macros.h"
 #include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_check.h"
 #include "absl/strings/ascii.h"
 #include "absl/strings/cord.h"
@@ -398,6 +399,7 @@ class TextFormat::Parser::ParserImpl {
   // false if an error occurs (an error will also be logged to
   // ABSL_LOG(ERROR)).
   bool Parse(Message* output) {
+    FieldOrder order = FieldOrderFor(output->GetDescriptor());
     // Consume fields until we cannot do so anymore.
     while (true) {
       if (LookingAtType(io::Tokenizer::TYPE_END)) {
@@ -413,7 +415,7 @@ class TextFormat::Parser::ParserImpl {
         return !had_errors_;
       }
 
-      DO(ConsumeField(output));
+      DO(ConsumeField(output, order));
     }
   }
 
@@ -485,8 +487,9 @@ class TextFormat::Parser::ParserImpl {
   // This method checks to see that the end delimiter at the conclusion of
   // the consumption matches the starting delimiter passed in here.
   bool ConsumeMessage(Message* message, const std::string& delimiter) {
+    FieldOrder order = FieldOrderFor(message->GetDescriptor());
     while (!LookingAt(">") && !LookingAt("}")) {
-      DO(ConsumeField(message));
+      DO(ConsumeField(message, order));
     }
 
     // Confirm that we have a valid ending delimiter.
@@ -505,9 +508,50 @@ class TextFormat::Parser::ParserImpl {
     return true;
   }
 
+  // The fields of the last message of a type, in the order they were parsed,
+  // and the position of the next field of the message being parsed.
+  struct FieldOrder {
+    std::vector<const FieldDescriptor*>* fields;
+    size_t position;
+  };
+
+  // Returns the FieldOrder to parse a message of type `descriptor` with.
+  // Messages of the same type usually have the same fields in the same order,
+  // e.g. the elements of a repeated field, so most fields can be found by
+  // comparing with the field the previous message had at the same position
+  // instead of a lookup by name.
+  FieldOrder FieldOrderFor(const Descriptor* descriptor) {
+    std::unique_ptr<std::vector<const FieldDescriptor*>>& fields =
+        field_orders_[descriptor];
+    if (fields == nullptr) {
+      fields = std::make_unique<std::vector<const FieldDescriptor*>>();
+    }
+    return FieldOrder{fields.get(), 0};
+  }
+
+  // Like descriptor->FindFieldByName(name), but tries the field predicted by
+  // `order` first, and records the field found for the next message.
+  static const FieldDescriptor* FindFieldByName(const Descriptor* descriptor,
+                                                const std::string& name,
+                                                FieldOrder& order) {
+    std::vector<const FieldDescriptor*>& fields = *order.fields;
+    if (order.position < fields.size() &&
+        fields[order.position]->name() == name) {
+      return fields[order.position++];
+    }
+    const FieldDescriptor* field = descriptor->FindFieldByName(name);
+    if (field != nullptr) {
+      // The fields recorded beyond this point were from a different order.
+      fields.resize(order.position);
+      fields.push_back(field);
+      ++order.position;
+    }
+    return field;
+  }
+
   // Consumes the current field (as returned by the tokenizer) on the
   // passed in message.
-  bool ConsumeField(Message* message) {
+  bool ConsumeField(Message* message, FieldOrder& order) {
     const Reflection* reflection = message->GetReflection();
     const Descriptor* descriptor = message->GetDescriptor();
 
@@ -619,7 +663,7 @@ class TextFormat::Parser::ParserImpl {
           field = descriptor->FindFieldByNumber(field_number);
         }
       } else {
-        field = descriptor->FindFieldByName(field_name);
+        field = FindFieldByName(descriptor, field_name, order);
         // Group-like delimited fields will accept both the capitalized type
         // names as well.
         if (field == nullptr) {
@@ -1454,6 +1498,9 @@ class TextFormat::Parser::ParserImpl {
   bool had_silent_marker_;
   bool had_errors_;
   UnsetFieldsMetadata* no_op_fields_{};
+  absl::flat_hash_map<const Descriptor*,
+                      std::unique_ptr<std::vector<const FieldDescriptor*>>>
+      field_orders_;
 
 };
 
@@ -2015,6 +2062,21 @@ std::string TextFormat::FieldValuePrinter::PrintMessageEnd(
 
 TextFormat::FastFieldValuePrinter::FastFieldValuePrinter() {}
 TextFormat::FastFieldValuePrinter::~FastFieldValuePrinter() {}
+
+namespace {
+// Returns whether absl::CEscape() would change `val`. Most strings only have
+// printable ASCII characters that need no escaping, and can be printed without
+// building an escaped copy.
+bool NeedsCEscape(absl::string_view val) {
+  for (char c : val) {
+    if (c < 0x20 || c >= 0x7f || c == '"' || c == '\'' || c == '\\') {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
 void TextFormat::FastFieldValuePrinter::PrintBool(
     bool val, BaseTextGenerator* generator) const {
   if (val) {
@@ -2025,19 +2087,19 @@ void TextFormat::FastFieldValuePrinter::PrintBool(
 }
 void TextFormat::FastFieldValuePrinter::PrintInt32(
     int32_t val, BaseTextGenerator* generator) const {
-  generator->PrintString(absl::StrCat(val));
+  generator->PrintString(absl::AlphaNum(val).Piece());
 }
 void TextFormat::FastFieldValuePrinter::PrintUInt32(
     uint32_t val, BaseTextGenerator* generator) const {
-  generator->PrintString(absl::StrCat(val));
+  generator->PrintString(absl::AlphaNum(val).Piece());
 }
 void TextFormat::FastFieldValuePrinter::PrintInt64(
     int64_t val, BaseTextGenerator* generator) const {
-  generator->PrintString(absl::StrCat(val));
+  generator->PrintString(absl::AlphaNum(val).Piece());
 }
 void TextFormat::FastFieldValuePrinter::PrintUInt64(
     uint64_t val, BaseTextGenerator* generator) const {
-  generator->PrintString(absl::StrCat(val));
+  generator->PrintString(absl::AlphaNum(val).Piece());
 }
 void TextFormat::FastFieldValuePrinter::PrintFloat(
     float val, BaseTextGenerator* generator) const {
@@ -2056,8 +2118,10 @@ void TextFormat::FastFieldValuePrinter::PrintEnum(
 void TextFormat::FastFieldValuePrinter::PrintString(
     const std::string& val, BaseTextGenerator* generator) const {
   generator->PrintLiteral("\"");
-  if (!val.empty()) {
+  if (NeedsCEscape(val)) {
     generator->PrintString(absl::CEscape(val));
+  } else {
+    generator->PrintString(val);
   }
   generator->PrintLiteral("\"");
 }
@@ -2348,6 +2412,46 @@ struct FieldIndexSorter {
 
 }  // namespace
 
+struct TextFormat::Printer::MessagePrintPlan {
+  bool is_any = false;
+  bool is_map_entry = false;
+  // Indexed by FieldDescriptor::index().
+  std::vector<bool> redacted_fields;
+
+  bool IsRedacted(const FieldDescriptor* field) const {
+    // Extensions are not fields of the descriptor the plan was built for.
+    return field->is_extension() ? IsFieldRedacted(field)
+                                 : redacted_fields[field->index()];
+  }
+};
+
+const TextFormat::Printer::MessagePrintPlan&
+TextFormat::Printer::GetMessagePrintPlan(const Descriptor* descriptor) {
+  return descriptor->file()->pool()->MemoizeProjection(
+      descriptor, [](const Descriptor* descriptor) {
+        MessagePrintPlan plan;
+        plan.is_any = descriptor->full_name() == internal::kAnyFullTypeName;
+        plan.is_map_entry = descriptor->options().map_entry();
+        plan.redacted_fields.resize(descriptor->field_count());
+        for (int i = 0; i < descriptor->field_count(); ++i) {
+          plan.redacted_fields[i] =
+              TextFormat::GetRedactionState(descriptor->field(i)).redact;
+        }
+        return plan;
+      });
+}
+
+bool TextFormat::Printer::IsFieldRedacted(const FieldDescriptor* field) {
+  if (!field->is_extension()) {
+    return GetMessagePrintPlan(field->containing_type())
+        .redacted_fields[field->index()];
+  }
+  return field->file()->pool()->MemoizeProjection(
+      field, [](const FieldDescriptor* field) {
+        return TextFormat::GetRedactionState(field).redact;
+      });
+}
+
 bool TextFormat::Printer::PrintAny(const Message& message,
                                    BaseTextGenerator* generator) const {
   const FieldDescriptor* type_url_field;
@@ -2427,13 +2531,13 @@ void TextFormat::Printer::PrintMessage(const Message& message,
     return;
   }
   const Descriptor* descriptor = message.GetDescriptor();
-  if (descriptor->full_name() == internal::kAnyFullTypeName && expand_any_ &&
-      PrintAny(message, generator)) {
+  const MessagePrintPlan& plan = GetMessagePrintPlan(descriptor);
+  if (plan.is_any && expand_any_ && PrintAny(message, generator)) {
     return;
   }
   const Reflection* reflection = message.GetReflection();
   std::vector<const FieldDescriptor*> fields;
-  if (descriptor->options().map_entry()) {
+  if (plan.is_map_entry) {
     fields.push_back(descriptor->field(0));
     fields.push_back(descriptor->field(1));
   } else {
@@ -2444,7 +2548,7 @@ void TextFormat::Printer::PrintMessage(const Message& message,
     std::sort(fields.begin(), fields.end(), FieldIndexSorter());
   }
   for (const FieldDescriptor* field : fields) {
-    PrintField(message, reflection, field, generator);
+    PrintField(message, reflection, field, plan, generator);
   }
   if (!hide_unknown_fields_) {
     PrintUnknownFields(reflection->GetUnknownFields(message), generator,
@@ -2645,11 +2749,13 @@ void MapFieldPrinterHelper::CopyValue(const MapValueRef& value,
 void TextFormat::Printer::PrintField(const Message& message,
                                      const Reflection* reflection,
                                      const FieldDescriptor* field,
+                                     const MessagePrintPlan& plan,
                                      BaseTextGenerator* generator) const {
+  const bool redact = plan.IsRedacted(field);
   if (use_short_repeated_primitives_ && field->is_repeated() &&
       field->cpp_type() != FieldDescriptor::CPPTYPE_STRING &&
       field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
-    PrintShortRepeatedField(message, reflection, field, generator);
+    PrintShortRepeatedField(message, reflection, field, redact, generator);
     return;
   }
 
@@ -2657,8 +2763,7 @@ void TextFormat::Printer::PrintField(const Message& message,
 
   if (field->is_repeated()) {
     count = reflection->FieldSize(message, field);
-  } else if (reflection->HasField(message, field) ||
-             field->containing_type()->options().map_entry()) {
+  } else if (reflection->HasField(message, field) || plan.is_map_entry) {
     count = 1;
   }
 
@@ -2676,7 +2781,7 @@ void TextFormat::Printer::PrintField(const Message& message,
     PrintFieldName(message, field_index, count, reflection, field, generator);
 
     if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
-      if (TryRedactFieldValue(message, field, generator,
+      if (TryRedactFieldValue(redact, generator,
                               /*insert_value_separator=*/true)) {
         break;
       }
@@ -2699,7 +2804,8 @@ void TextFormat::Printer::PrintField(const Message& message,
     } else {
       generator->PrintMaybeWithMarker(MarkerToken(), ": ");
       // Write the field value.
-      PrintFieldValue(message, reflection, field, field_index, generator);
+      PrintFieldValue(message, reflection, field, field_index, redact,
+                      generator);
       if (single_line_mode_) {
         generator->PrintLiteral(" ");
       } else {
@@ -2717,7 +2823,8 @@ void TextFormat::Printer::PrintField(const Message& message,
 
 void TextFormat::Printer::PrintShortRepeatedField(
     const Message& message, const Reflection* reflection,
-    const FieldDescriptor* field, BaseTextGenerator* generator) const {
+    const FieldDescriptor* field, bool redact,
+    BaseTextGenerator* generator) const {
   // Print primitive repeated field in short form.
   int size = reflection->FieldSize(message, field);
   PrintFieldName(message, /*field_index=*/-1, /*field_count=*/size, reflection,
@@ -2725,7 +2832,7 @@ void TextFormat::Printer::PrintShortRepeatedField(
   generator->PrintMaybeWithMarker(MarkerToken(), ": ", "[");
   for (int i = 0; i < size; i++) {
     if (i > 0) generator->PrintLiteral(", ");
-    PrintFieldValue(message, reflection, field, i, generator);
+    PrintFieldValue(message, reflection, field, i, redact, generator);
   }
   if (single_line_mode_) {
     generator->PrintLiteral("] ");
@@ -2756,11 +2863,20 @@ void TextFormat::Printer::PrintFieldValue(const Message& message,
                                           const FieldDescriptor* field,
                                           int index,
                                           BaseTextGenerator* generator) const {
+  PrintFieldValue(message, reflection, field, index, IsFieldRedacted(field),
+                  generator);
+}
+
+void TextFormat::Printer::PrintFieldValue(const Message& message,
+                                          const Reflection* reflection,
+                                          const FieldDescriptor* field,
+                                          int index, bool redact,
+                                          BaseTextGenerator* generator) const {
   ABSL_DCHECK(field->is_repeated() || (index == -1))
       << "Index must be -1 for non-repeated fields";
 
   const FastFieldValuePrinter* printer = GetFieldPrinter(field);
-  if (TryRedactFieldValue(message, field, generator,
+  if (TryRedactFieldValue(redact, generator,
                           /*insert_value_separator=*/false)) {
     return;
   }
@@ -3089,15 +3205,11 @@ TextFormat::RedactionState TextFormat::GetRedactionState(
   }
   return state;
 }
+
 bool TextFormat::Printer::TryRedactFieldValue(
-    const Message& message, const FieldDescriptor* field,
-    BaseTextGenerator* generator, bool insert_value_separator) const {
-  TextFormat::RedactionState redaction_state =
-      field->file()->pool()->MemoizeProjection(
-          field, [](const FieldDescriptor* field) {
-            return TextFormat::GetRedactionState(field);
-          });
-  if (redaction_state.redact) {
+    bool redact, BaseTextGenerator* generator,
+    bool insert_value_separator) const {
+  if (redact) {
     if (redact_debug_string_) {
       IncrementRedactedFieldCounter();
       if (insert_value_separator) {
@@ -488,15 +488,25 @@ class PROTOBUF_EXPORT TextFormat {
     // the TextGenerator class.
     void Print(const Message& message, BaseTextGenerator* generator) const;
 
-    // Print a single field.
+    // The per-message-type decisions of the printer, such as which fields are
+    // redacted.  They are computed once per Descriptor and shared by all
+    // printers, instead of being looked up for every field value printed.
+    struct MessagePrintPlan;
+    static const MessagePrintPlan& GetMessagePrintPlan(
+        const Descriptor* descriptor);
+
+    // Returns true if the values of `field` are redacted by debug printing.
+    static bool IsFieldRedacted(const FieldDescriptor* field);
+
+    // Print a single field of a message whose type has the given plan.
     void PrintField(const Message& message, const Reflection* reflection,
-                    const FieldDescriptor* field,
+                    const FieldDescriptor* field, const MessagePrintPlan& plan,
                     BaseTextGenerator* generator) const;
 
     // Print a repeated primitive field in short form.
     void PrintShortRepeatedField(const Message& message,
                                  const Reflection* reflection,
-                                 const FieldDescriptor* field,
+                                 const FieldDescriptor* field, bool redact,
                                  BaseTextGenerator* generator) const;
 
     // Print the name of a field -- i.e. everything that comes before the
@@ -511,6 +521,10 @@ class PROTOBUF_EXPORT TextFormat {
     void PrintFieldValue(const Message& message, const Reflection* reflection,
                          const FieldDescriptor* field, int index,
                          BaseTextGenerator* generator) const;
+    // As above, where `redact` is IsFieldRedacted(field).
+    void PrintFieldValue(const Message& message, const Reflection* reflection,
+                         const FieldDescriptor* field, int index, bool redact,
+                         BaseTextGenerator* generator) const;
 
     // Print the fields in an UnknownFieldSet.  They are printed by tag number
     // only.  Embedded messages are heuristically identified by attempting to
@@ -521,11 +535,10 @@ class PROTOBUF_EXPORT TextFormat {
 
     bool PrintAny(const Message& message, BaseTextGenerator* generator) const;
 
-    // Try to redact a field value based on the annotations associated with
-    // the field. This function returns true if it redacts the field value.
-    bool TryRedactFieldValue(const Message& message,
-                             const FieldDescriptor* field,
-                             BaseTextGenerator* generator,
+    // Try to redact a field value whose field is redacted if `redact` is
+    // true, as computed by IsFieldRedacted(). This function returns true if
+    // it redacts the field value.
+    bool TryRedactFieldValue(bool redact, BaseTextGenerator* generator,
                              bool insert_value_separator) const;
 
     const FastFieldValuePrinter* GetFieldPrinter(
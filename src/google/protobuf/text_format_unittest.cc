@@ -1250,6 +1250,32 @@ TEST_F(TextFormatTest, ParseStringEscape) {
   EXPECT_EQ(kEscapeTestString, proto_.optional_string());
 }
 
+TEST_F(TextFormatTest, ParseMessagesWithChangingFieldOrder) {
+  // Fields are looked up by comparing with the fields of the previous message
+  // of the same type; make sure that changing orders still work.
+  std::string parse_string =
+      "repeated_foreign_message { c: 1 d: 2 }\n"
+      "repeated_foreign_message { c: 3 d: 4 }\n"
+      "repeated_foreign_message { d: 5 c: 6 }\n"
+      "repeated_foreign_message { c: 7 }\n"
+      "repeated_foreign_message { d: 8 }\n"
+      "optional_int32: 9\n";
+
+  ASSERT_TRUE(TextFormat::ParseFromString(parse_string, &proto_));
+  ASSERT_EQ(proto_.repeated_foreign_message_size(), 5);
+  EXPECT_EQ(proto_.repeated_foreign_message(0).c(), 1);
+  EXPECT_EQ(proto_.repeated_foreign_message(0).d(), 2);
+  EXPECT_EQ(proto_.repeated_foreign_message(1).c(), 3);
+  EXPECT_EQ(proto_.repeated_foreign_message(1).d(), 4);
+  EXPECT_EQ(proto_.repeated_foreign_message(2).c(), 6);
+  EXPECT_EQ(proto_.repeated_foreign_message(2).d(), 5);
+  EXPECT_EQ(proto_.repeated_foreign_message(3).c(), 7);
+  EXPECT_FALSE(proto_.repeated_foreign_message(3).has_d());
+  EXPECT_FALSE(proto_.repeated_foreign_message(4).has_c());
+  EXPECT_EQ(proto_.repeated_foreign_message(4).d(), 8);
+  EXPECT_EQ(proto_.optional_int32(), 9);
+}
+
 TEST_F(TextFormatTest, ParseConcatenatedString) {
   // Create a parse string with multiple parts on one line.
   std::string parse_string = "optional_string: \"foo\" \"bar\"\n";
@@ -2782,6 +2808,22 @@ TEST(AbslStringifyTest, StringifyRedactedOptionDoesNotRedact) {
                                        kTextMarkerRegex)));
 }
 
+TEST(AbslStringifyTest, StringifyRedactsFieldsAndExtensions) {
+  unittest::RedactedFields proto;
+  proto.set_optional_redacted_false_string("foo");
+  proto.SetExtension(unittest::redacted_extension, "bar");
+  // The second print reuses the redaction decisions made by the first one.
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_THAT(absl::StrCat(proto),
+                testing::MatchesRegex(absl::Substitute(
+                    "$0\n"
+                    "optional_redacted_false_string: \"foo\"\n"
+                    "\\[proto2_unittest.redacted_extension\\]: "
+                    "\\[REDACTED\\]\n",
+                    kTextMarkerRegex)));
+  }
+}
+
 
 TEST(TextFormatFloatingPointTest, PreservesNegative0) {
   proto3_unittest::TestAllTypes in_message;
@@ -115,6 +115,8 @@ class PROTOBUF_EXPORT ThreadSafeArena {
   static uint64_t GetNextLifeCycleId();
 
   class SerialArenaChunk;
+  struct RetainedBlock;
+  class RetainingDeallocator;
 
   // Returns a new SerialArenaChunk that has {id, serial} at slot 0. It may
   // grow based on "prev_num_slots".
@@ -147,6 +149,9 @@ class PROTOBUF_EXPORT ThreadSafeArena {
   absl::Mutex mutex_;
   // Pointer to a linked list of SerialArenaChunk.
   std::atomic<SerialArenaChunk*> head_{nullptr};
+  // Blocks kept by Reset() for reuse. Taking a block must be protected by
+  // mutex_.
+  std::atomic<RetainedBlock*> retained_blocks_{nullptr};
 
   void* first_owner_;
   // Must be declared after alloc_policy_; otherwise, it may lose info on
@@ -189,6 +194,13 @@ class PROTOBUF_EXPORT ThreadSafeArena {
 
   SerialArena* GetSerialArena();
 
+  // Returns a new block for a SerialArena whose current block has
+  // `last_size` bytes, big enough for `min_bytes`. Blocks retained by Reset()
+  // are used before allocating.
+  SizedPtr AllocateBlockForSerialArena(size_t last_size, size_t min_bytes);
+  // Frees the blocks retained by Reset().
+  void FreeRetainedBlocks();
+
   template <AllocationClient alloc_client = AllocationClient::kDefault>
   void* AllocateAlignedFallback(size_t n);
 
@@ -210,7 +222,8 @@ class PROTOBUF_EXPORT ThreadSafeArena {
   // Releases all memory except the first block which it returns. The first
   // block might be owned by the user and thus need some extra checks before
   // deleting.
-  SizedPtr Free();
+  template <typename Deallocator>
+  SizedPtr Free(Deallocator deallocator);
 
   // ThreadCache is accessed very frequently, so we align it such that it's
   // located within a single cache line.
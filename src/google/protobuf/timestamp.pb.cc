@@ -174,6 +174,9 @@ constexpr auto Timestamp::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(Timestamp),
                                             alignof(Timestamp));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Timestamp_reflection_data_;
+
 constexpr auto Timestamp::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -193,6 +196,7 @@ constexpr auto Timestamp::InternalGenerateClassData_() {
       },
       &Timestamp::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2ftimestamp_2eproto,
+      &Timestamp_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -313,6 +317,13 @@ PROTOBUF_NOINLINE void Timestamp::Clear() {
 ::size_t Timestamp::ByteSizeLong() const {
   const Timestamp& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t Timestamp::UncachedByteSizeLong() const {
+  const Timestamp& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.Timestamp)
   ::size_t total_size = 0;
 
@@ -338,8 +349,11 @@ PROTOBUF_NOINLINE void Timestamp::Clear() {
       }
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void Timestamp::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -522,6 +522,9 @@ constexpr auto Type::InternalNewImpl_() {
                                  alignof(Type));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Type_reflection_data_;
+
 constexpr auto Type::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -541,6 +544,7 @@ constexpr auto Type::InternalGenerateClassData_() {
       },
       &Type::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2ftype_2eproto,
+      &Type_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -722,7 +726,8 @@ PROTOBUF_NOINLINE void Type::Clear() {
   // .google.protobuf.SourceContext source_context = 5;
   if ((cached_has_bits & 0x00000004u) != 0) {
     target = ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
-        5, *this_._impl_.source_context_, this_._impl_.source_context_->GetCachedSize(), target,
+        5, *this_._impl_.source_context_,
+        static_cast<int>(this_._impl_.source_context_->UncachedByteSizeLong()), target,
         stream);
   }
 
@@ -813,7 +818,7 @@ PROTOBUF_NOINLINE void Type::Clear() {
     // .google.protobuf.SourceContext source_context = 5;
     if ((cached_has_bits & 0x00000004u) != 0) {
       total_size += 1 +
-                    ::google::protobuf::internal::WireFormatLite::MessageSize(*this_._impl_.source_context_);
+                    ::google::protobuf::internal::WireFormatLite::UncachedMessageSize(*this_._impl_.source_context_);
     }
     // .google.protobuf.Syntax syntax = 6;
     if ((cached_has_bits & 0x00000008u) != 0) {
@@ -1018,6 +1023,9 @@ constexpr auto Field::InternalNewImpl_() {
                                  alignof(Field));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Field_reflection_data_;
+
 constexpr auto Field::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -1037,6 +1045,7 @@ constexpr auto Field::InternalGenerateClassData_() {
       },
       &Field::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2ftype_2eproto,
+      &Field_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -1622,6 +1631,9 @@ constexpr auto Enum::InternalNewImpl_() {
                                  alignof(Enum));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Enum_reflection_data_;
+
 constexpr auto Enum::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -1641,6 +1653,7 @@ constexpr auto Enum::InternalGenerateClassData_() {
       },
       &Enum::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2ftype_2eproto,
+      &Enum_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -1807,7 +1820,8 @@ PROTOBUF_NOINLINE void Enum::Clear() {
   // .google.protobuf.SourceContext source_context = 4;
   if ((cached_has_bits & 0x00000004u) != 0) {
     target = ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
-        4, *this_._impl_.source_context_, this_._impl_.source_context_->GetCachedSize(), target,
+        4, *this_._impl_.source_context_,
+        static_cast<int>(this_._impl_.source_context_->UncachedByteSizeLong()), target,
         stream);
   }
 
@@ -1889,7 +1903,7 @@ PROTOBUF_NOINLINE void Enum::Clear() {
     // .google.protobuf.SourceContext source_context = 4;
     if ((cached_has_bits & 0x00000004u) != 0) {
       total_size += 1 +
-                    ::google::protobuf::internal::WireFormatLite::MessageSize(*this_._impl_.source_context_);
+                    ::google::protobuf::internal::WireFormatLite::UncachedMessageSize(*this_._impl_.source_context_);
     }
     // .google.protobuf.Syntax syntax = 5;
     if ((cached_has_bits & 0x00000008u) != 0) {
@@ -2072,6 +2086,9 @@ constexpr auto EnumValue::InternalNewImpl_() {
                                  alignof(EnumValue));
   }
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    EnumValue_reflection_data_;
+
 constexpr auto EnumValue::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -2091,6 +2108,7 @@ constexpr auto EnumValue::InternalGenerateClassData_() {
       },
       &EnumValue::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2ftype_2eproto,
+      &EnumValue_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -2410,6 +2428,9 @@ constexpr auto Option::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(Option),
                                             alignof(Option));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Option_reflection_data_;
+
 constexpr auto Option::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -2429,6 +2450,7 @@ constexpr auto Option::InternalGenerateClassData_() {
       },
       &Option::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2ftype_2eproto,
+      &Option_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -2538,7 +2560,8 @@ PROTOBUF_NOINLINE void Option::Clear() {
   // .google.protobuf.Any value = 2;
   if ((cached_has_bits & 0x00000002u) != 0) {
     target = ::google::protobuf::internal::WireFormatLite::InternalWriteMessage(
-        2, *this_._impl_.value_, this_._impl_.value_->GetCachedSize(), target,
+        2, *this_._impl_.value_,
+        static_cast<int>(this_._impl_.value_->UncachedByteSizeLong()), target,
         stream);
   }
 
@@ -2578,7 +2601,7 @@ PROTOBUF_NOINLINE void Option::Clear() {
     // .google.protobuf.Any value = 2;
     if ((cached_has_bits & 0x00000002u) != 0) {
       total_size += 1 +
-                    ::google::protobuf::internal::WireFormatLite::MessageSize(*this_._impl_.value_);
+                    ::google::protobuf::internal::WireFormatLite::UncachedMessageSize(*this_._impl_.value_);
     }
   }
   return this_.MaybeComputeUnknownFieldsSize(total_size,
@@ -184,7 +184,9 @@ void UnknownFieldSet::DeleteByNumber(int number) {
 }
 
 bool UnknownFieldSet::MergeFromCodedStream(io::CodedInputStream* input) {
-  UnknownFieldSet other;
+  // Parse on our arena so that MergeFromAndDestroy() can move the fields
+  // rather than copy them.
+  UnknownFieldSet other(arena());
   if (internal::WireFormat::SkipMessage(input, &other) &&
       input->ConsumedEntireMessage()) {
     MergeFromAndDestroy(&other);
@@ -206,8 +208,22 @@ bool UnknownFieldSet::ParseFromZeroCopyStream(io::ZeroCopyInputStream* input) {
 }
 
 bool UnknownFieldSet::ParseFromArray(const void* data, int size) {
-  io::ArrayInputStream input(data, size);
-  return ParseFromZeroCopyStream(&input);
+  Clear();
+  return MergeFromFlatArray(
+      absl::string_view(static_cast<const char*>(data), size));
+}
+
+bool UnknownFieldSet::MergeFromFlatArray(absl::string_view data) {
+  // Use the same parser as for the unknown fields of generated messages,
+  // which is much faster than WireFormat::SkipMessage() on a flat buffer.
+  UnknownFieldSet other(arena());
+  const char* ptr;
+  internal::ParseContext ctx(io::CodedInputStream::GetDefaultRecursionLimit(),
+                             false, &ptr, data);
+  ptr = internal::UnknownGroupParse(&other, ptr, &ctx);
+  if (ptr == nullptr || !ctx.EndedAtLimit()) return false;
+  MergeFromAndDestroy(&other);
+  return true;
 }
 
 bool UnknownFieldSet::SerializeToString(std::string* output) const {
@@ -246,6 +246,10 @@ class PROTOBUF_EXPORT UnknownFieldSet {
 
   std::string* AddLengthDelimited(int number);
 
+  // Merges the fields serialized in |data|.  Leaves this set unchanged if
+  // |data| is malformed.
+  bool MergeFromFlatArray(absl::string_view data);
+
   using InternalArenaConstructable_ = void;
   using DestructorSkippable_ = void;
 
@@ -271,11 +275,7 @@ class PROTOBUF_EXPORT UnknownFieldSet {
                     !std::is_base_of<Message, MessageType>::value,
                 int>::type = 0>
   bool InternalMergeFromMessage(const MessageType& message) {
-    const auto& unknown_fields = message.unknown_fields();
-    io::ArrayInputStream array_stream(unknown_fields.data(),
-                                      unknown_fields.size());
-    io::CodedInputStream coded_stream(&array_stream);
-    return MergeFromCodedStream(&coded_stream);
+    return MergeFromFlatArray(message.unknown_fields());
   }
 
   RepeatedField<UnknownField> fields_;
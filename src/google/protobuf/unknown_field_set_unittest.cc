@@ -317,6 +317,30 @@ TEST_F(UnknownFieldSetTest, Serialize) {
   EXPECT_TRUE(data == all_fields_data_);
 }
 
+TEST_F(UnknownFieldSetTest, ParseFromString) {
+  for (bool use_arena : {false, true}) {
+    SCOPED_TRACE(use_arena);
+    Arena arena;
+    UnknownFieldSet stack_set;
+    UnknownFieldSet& set =
+        use_arena ? *Arena::Create<UnknownFieldSet>(&arena) : stack_set;
+    set.AddVarint(1, 1);
+    ASSERT_TRUE(set.ParseFromString(all_fields_data_));
+    EXPECT_EQ(set.field_count(), unknown_fields_->field_count());
+    std::string data;
+    ASSERT_TRUE(set.SerializeToString(&data));
+    EXPECT_TRUE(data == all_fields_data_);
+
+    // Malformed input leaves the set empty, and so does a stray end-group
+    // tag.
+    EXPECT_FALSE(set.ParseFromString(all_fields_data_.substr(
+        0, all_fields_data_.size() - 1)));
+    EXPECT_TRUE(set.empty());
+    EXPECT_FALSE(set.ParseFromString("\x08\x01\x0c"));
+    EXPECT_TRUE(set.empty());
+  }
+}
+
 TEST_F(UnknownFieldSetTest, ParseViaReflection) {
   // Make sure fields are properly parsed to the UnknownFieldSet when parsing
   // via reflection.
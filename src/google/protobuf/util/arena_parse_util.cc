@@ -0,0 +1,65 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/arena_parse_util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "google/protobuf/arena.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+constexpr uint64_t kRatioScale = 256;
+// Each new parse moves the average 1/kWeight of the way to its ratio.
+constexpr int64_t kWeight = 8;
+// Keeps a mispredicted type from reserving unbounded memory up front.
+constexpr uint64_t kMaxStartBlockSize = uint64_t{64} << 20;
+// Inputs larger than this are predicted as if they were this large, which
+// keeps the arithmetic below from overflowing.
+constexpr uint64_t kMaxInputSize = std::numeric_limits<uint32_t>::max();
+
+}  // namespace
+
+ArenaOptions ArenaSizePredictor::Options(size_t input_size) const {
+  ArenaOptions options;
+  const uint32_t ratio = ratio_.load(std::memory_order_relaxed);
+  if (ratio == 0) return options;
+  uint64_t predicted =
+      std::min<uint64_t>(input_size, kMaxInputSize) * ratio / kRatioScale;
+  // Leaves room for messages that take more than the average.
+  predicted += predicted / 4;
+  options.start_block_size = static_cast<size_t>(std::clamp<uint64_t>(
+      predicted, options.start_block_size, kMaxStartBlockSize));
+  options.max_block_size =
+      std::max(options.max_block_size, options.start_block_size);
+  return options;
+}
+
+void ArenaSizePredictor::Record(size_t input_size, uint64_t arena_bytes) {
+  if (input_size == 0) return;
+  const uint64_t sample = std::clamp<uint64_t>(
+      std::min(arena_bytes, kMaxInputSize * kRatioScale) * kRatioScale /
+          input_size,
+      1, std::numeric_limits<uint32_t>::max());
+  const int64_t ratio = ratio_.load(std::memory_order_relaxed);
+  const int64_t updated =
+      ratio == 0 ? static_cast<int64_t>(sample)
+                 : ratio + (static_cast<int64_t>(sample) - ratio) / kWeight;
+  ratio_.store(static_cast<uint32_t>(std::max<int64_t>(updated, 1)),
+               std::memory_order_relaxed);
+}
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,85 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Defines ParseIntoNewArena(), which parses a message into an arena of its
+// own.  The arena's first block is sized from what earlier parses of the same
+// type used per input byte, so that large messages do not go through a chain
+// of doubling blocks, which wastes much of the last one.
+//
+// Example:
+//   ArenaParseResult<Request> result = ParseIntoNewArena<Request>(data);
+//   if (result.message == nullptr) return Reject();
+//   Handle(*result.message);
+
+#ifndef GOOGLE_PROTOBUF_UTIL_ARENA_PARSE_UTIL_H__
+#define GOOGLE_PROTOBUF_UTIL_ARENA_PARSE_UTIL_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "absl/strings/string_view.h"
+#include "google/protobuf/arena.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+// Learns how many arena bytes parsing one input byte of a message type takes,
+// as an exponential moving average over the parses recorded.  Thread-safe;
+// concurrent updates may lose samples, which only slows the learning.
+class PROTOBUF_EXPORT ArenaSizePredictor {
+ public:
+  constexpr ArenaSizePredictor() = default;
+  ArenaSizePredictor(const ArenaSizePredictor&) = delete;
+  ArenaSizePredictor& operator=(const ArenaSizePredictor&) = delete;
+
+  // Returns the arena options for parsing |input_size| bytes: the default
+  // ones until a parse has been recorded.
+  ArenaOptions Options(size_t input_size) const;
+
+  // Records that parsing |input_size| bytes used |arena_bytes| of the arena.
+  void Record(size_t input_size, uint64_t arena_bytes);
+
+ private:
+  // Arena bytes per input byte, in 1/256ths; 0 before the first parse is
+  // recorded.
+  std::atomic<uint32_t> ratio_{0};
+};
+
+template <typename T>
+struct ArenaParseResult {
+  std::unique_ptr<Arena> arena;
+  // The message, owned by |arena|, or nullptr if |data| did not parse.
+  T* message = nullptr;
+};
+
+// Parses |data| into a new message of type |T| on a new arena sized for it.
+template <typename T>
+ArenaParseResult<T> ParseIntoNewArena(absl::string_view data) {
+  // One predictor per message type.
+  static ArenaSizePredictor predictor;
+  ArenaParseResult<T> result;
+  result.arena = std::make_unique<Arena>(predictor.Options(data.size()));
+  T* message = Arena::Create<T>(result.arena.get());
+  if (!message->ParseFromString(data)) return result;
+  predictor.Record(data.size(), result.arena->SpaceUsed());
+  result.message = message;
+  return result;
+}
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_UTIL_ARENA_PARSE_UTIL_H__
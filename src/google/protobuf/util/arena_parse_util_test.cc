@@ -0,0 +1,79 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/arena_parse_util.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include "google/protobuf/arena.h"
+#include "google/protobuf/unittest.pb.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using ::proto2_unittest::TestAllTypes;
+
+TEST(ArenaSizePredictorTest, LearnsRatio) {
+  ArenaSizePredictor predictor;
+  const ArenaOptions defaults;
+  EXPECT_EQ(predictor.Options(100000).start_block_size,
+            defaults.start_block_size);
+
+  predictor.Record(1000, 4000);
+  ArenaOptions options = predictor.Options(100000);
+  EXPECT_GE(options.start_block_size, 400000);
+  EXPECT_LT(options.start_block_size, 550000);
+  EXPECT_GE(options.max_block_size, options.start_block_size);
+  // Small inputs still get at least the default block.
+  EXPECT_EQ(predictor.Options(1).start_block_size, defaults.start_block_size);
+
+  // Later parses move the average towards their ratio.
+  for (int i = 0; i < 100; ++i) predictor.Record(1000, 2000);
+  options = predictor.Options(100000);
+  EXPECT_GE(options.start_block_size, 200000);
+  EXPECT_LT(options.start_block_size, 275000);
+}
+
+TEST(ArenaSizePredictorTest, BoundsStartBlock) {
+  ArenaSizePredictor predictor;
+  predictor.Record(1, uint64_t{1} << 40);
+  EXPECT_LE(predictor.Options(size_t{1} << 40).start_block_size,
+            size_t{64} << 20);
+}
+
+TEST(ParseIntoNewArenaTest, Parses) {
+  TestAllTypes expected;
+  for (int i = 0; i < 1000; ++i) {
+    expected.add_repeated_string(std::string(i % 50, 'x'));
+    expected.add_repeated_nested_message()->set_bb(i);
+  }
+  const std::string data = expected.SerializeAsString();
+
+  ArenaParseResult<TestAllTypes> first = ParseIntoNewArena<TestAllTypes>(data);
+  ASSERT_NE(first.message, nullptr);
+  EXPECT_EQ(first.message->GetArena(), first.arena.get());
+  EXPECT_EQ(first.message->SerializeAsString(), data);
+
+  // The second parse uses what the first one learned.
+  ArenaParseResult<TestAllTypes> second =
+      ParseIntoNewArena<TestAllTypes>(data);
+  ASSERT_NE(second.message, nullptr);
+  EXPECT_EQ(second.message->SerializeAsString(), data);
+
+  ArenaParseResult<TestAllTypes> failed =
+      ParseIntoNewArena<TestAllTypes>("\xff");
+  EXPECT_EQ(failed.message, nullptr);
+  EXPECT_NE(failed.arena, nullptr);
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
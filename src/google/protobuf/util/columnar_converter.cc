@@ -0,0 +1,230 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/columnar_converter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/descriptor.pb.h"
+#include "google/protobuf/message.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+ColumnarConverter::ColumnarConverter(const Descriptor* descriptor) {
+  std::vector<const FieldDescriptor*> path;
+  std::vector<const Descriptor*> enclosing_types;
+  PlanColumns(descriptor, "", &path, -1, &enclosing_types);
+  Clear();
+}
+
+void ColumnarConverter::PlanColumns(
+    const Descriptor* descriptor, absl::string_view prefix,
+    std::vector<const FieldDescriptor*>* path, int repeated_index,
+    std::vector<const Descriptor*>* enclosing_types) {
+  enclosing_types->push_back(descriptor);
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const FieldDescriptor* field = descriptor->field(i);
+    if (field->is_repeated() && repeated_index >= 0) continue;
+    const int field_repeated_index =
+        field->is_repeated() ? static_cast<int>(path->size()) : repeated_index;
+    const std::string name = absl::StrCat(prefix, field->name());
+    path->push_back(field);
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      if (std::find(enclosing_types->begin(), enclosing_types->end(),
+                    field->message_type()) == enclosing_types->end()) {
+        PlanColumns(field->message_type(), absl::StrCat(name, "."), path,
+                    field_repeated_index, enclosing_types);
+      }
+    } else {
+      Column column;
+      column.name = name;
+      column.path = *path;
+      column.repeated_index = field_repeated_index;
+      columns_.push_back(std::move(column));
+    }
+    path->pop_back();
+  }
+  enclosing_types->pop_back();
+}
+
+void ColumnarConverter::AppendRow(const Message& row) {
+  const Message* rows[] = {&row};
+  AppendRows(rows);
+}
+
+void ColumnarConverter::AppendRows(absl::Span<const Message* const> rows) {
+  for (Column& column : columns_) {
+    for (const Message* row : rows) {
+      AppendToColumn(*row, &column);
+    }
+  }
+  num_rows_ += static_cast<int>(rows.size());
+}
+
+void ColumnarConverter::Clear() {
+  for (Column& column : columns_) {
+    column.offsets.clear();
+    if (column.repeated_index >= 0) column.offsets.push_back(0);
+    column.valid.clear();
+    column.int32_values.clear();
+    column.int64_values.clear();
+    column.uint32_values.clear();
+    column.uint64_values.clear();
+    column.double_values.clear();
+    column.float_values.clear();
+    column.bool_values.clear();
+    column.string_values.clear();
+  }
+  num_rows_ = 0;
+}
+
+const ColumnarConverter::Column* ColumnarConverter::FindColumn(
+    absl::string_view name) const {
+  for (const Column& column : columns_) {
+    if (column.name == name) return &column;
+  }
+  return nullptr;
+}
+
+namespace {
+
+// Follows the singular message fields in |path| from |message|.  Returns
+// nullptr if one of them is not set.
+const Message* FollowPath(const Message* message,
+                          absl::Span<const FieldDescriptor* const> path) {
+  for (const FieldDescriptor* field : path) {
+    const Reflection* reflection = message->GetReflection();
+    if (!reflection->HasField(*message, field)) return nullptr;
+    message = &reflection->GetMessage(*message, field);
+  }
+  return message;
+}
+
+template <typename T>
+void AppendSpan(absl::Span<const T> values, std::vector<T>* column) {
+  column->insert(column->end(), values.begin(), values.end());
+}
+
+}  // namespace
+
+void ColumnarConverter::AppendToColumn(const Message& row, Column* column) {
+  const absl::Span<const FieldDescriptor* const> path = column->path;
+  const FieldDescriptor* leaf = path.back();
+  if (column->repeated_index < 0) {
+    AppendValue(FollowPath(&row, path.first(path.size() - 1)), leaf, column);
+    return;
+  }
+
+  const FieldDescriptor* repeated = path[column->repeated_index];
+  const Message* message =
+      FollowPath(&row, path.first(column->repeated_index));
+  if (message != nullptr) {
+    if (repeated == leaf) {
+      AppendRepeatedValues(*message, leaf, column);
+    } else {
+      const Reflection* reflection = message->GetReflection();
+      const absl::Span<const FieldDescriptor* const> element_path =
+          path.subspan(column->repeated_index + 1,
+                       path.size() - column->repeated_index - 2);
+      const int size = reflection->FieldSize(*message, repeated);
+      for (int i = 0; i < size; ++i) {
+        const Message& element =
+            reflection->GetRepeatedMessage(*message, repeated, i);
+        AppendValue(FollowPath(&element, element_path), leaf, column);
+      }
+    }
+  }
+  column->offsets.push_back(static_cast<int32_t>(column->valid.size()));
+}
+
+void ColumnarConverter::AppendValue(const Message* message,
+                                    const FieldDescriptor* field,
+                                    Column* column) {
+  // Map entry fields are always considered present.
+  const bool valid =
+      message != nullptr &&
+      (!field->has_presence() ||
+       field->containing_type()->options().map_entry() ||
+       message->GetReflection()->HasField(*message, field));
+  column->valid.push_back(valid);
+  const Reflection* reflection =
+      message != nullptr ? message->GetReflection() : nullptr;
+  switch (field->cpp_type()) {
+#define HANDLE_TYPE(CPPTYPE, METHOD, NAME)                             \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE:                             \
+    column->NAME##_values.push_back(                                   \
+        message != nullptr ? reflection->Get##METHOD(*message, field)  \
+                           : field->default_value_##NAME());           \
+    break;
+    HANDLE_TYPE(INT32, Int32, int32);
+    HANDLE_TYPE(INT64, Int64, int64);
+    HANDLE_TYPE(UINT32, UInt32, uint32);
+    HANDLE_TYPE(UINT64, UInt64, uint64);
+    HANDLE_TYPE(DOUBLE, Double, double);
+    HANDLE_TYPE(FLOAT, Float, float);
+    HANDLE_TYPE(BOOL, Bool, bool);
+#undef HANDLE_TYPE
+    case FieldDescriptor::CPPTYPE_ENUM:
+      column->int32_values.push_back(
+          message != nullptr ? reflection->GetEnumValue(*message, field)
+                             : field->default_value_enum()->number());
+      break;
+    case FieldDescriptor::CPPTYPE_STRING:
+      column->string_values.push_back(
+          message != nullptr ? reflection->GetString(*message, field)
+                             : std::string(field->default_value_string()));
+      break;
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      break;
+  }
+}
+
+void ColumnarConverter::AppendRepeatedValues(const Message& message,
+                                             const FieldDescriptor* field,
+                                             Column* column) {
+  const Reflection* reflection = message.GetReflection();
+  const int size = reflection->FieldSize(message, field);
+  column->valid.insert(column->valid.end(), size, true);
+  switch (field->cpp_type()) {
+#define HANDLE_TYPE(CPPTYPE, TYPE, VALUES)                               \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE:                               \
+    AppendSpan(reflection->GetRepeatedFieldSpan<TYPE>(message, field),   \
+               &column->VALUES);                                         \
+    break;
+    HANDLE_TYPE(INT32, int32_t, int32_values);
+    HANDLE_TYPE(INT64, int64_t, int64_values);
+    HANDLE_TYPE(UINT32, uint32_t, uint32_values);
+    HANDLE_TYPE(UINT64, uint64_t, uint64_values);
+    HANDLE_TYPE(DOUBLE, double, double_values);
+    HANDLE_TYPE(FLOAT, float, float_values);
+    HANDLE_TYPE(BOOL, bool, bool_values);
+    HANDLE_TYPE(ENUM, int32_t, int32_values);
+#undef HANDLE_TYPE
+    case FieldDescriptor::CPPTYPE_STRING:
+      for (int i = 0; i < size; ++i) {
+        column->string_values.push_back(
+            reflection->GetRepeatedString(message, field, i));
+      }
+      break;
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      break;
+  }
+}
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,126 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Defines ColumnarConverter, which converts messages, one row per message,
+// into columns laid out the way columnar formats such as Apache Arrow expect:
+// a contiguous buffer of values per leaf field, a validity flag per value,
+// and, for fields under a repeated field, list offsets per row.
+//
+// Example:
+//   ColumnarConverter converter(Event::descriptor());
+//   converter.AppendRows(events);  // A RepeatedPtrField<Event>.
+//   const ColumnarConverter::Column* ids = converter.FindColumn("header.id");
+//   Export(ids->int64_values, ids->valid);
+
+#ifndef GOOGLE_PROTOBUF_UTIL_COLUMNAR_CONVERTER_H__
+#define GOOGLE_PROTOBUF_UTIL_COLUMNAR_CONVERTER_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/repeated_ptr_field.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+class PROTOBUF_EXPORT ColumnarConverter {
+ public:
+  // A column holding one leaf field of every row.
+  struct Column {
+    // The field names on the path from the row to the leaf, separated by
+    // dots, e.g. "header.id".  Map fields contribute their "key" and "value"
+    // columns, e.g. "labels.key".
+    std::string name;
+    // The fields on the path from the row to the leaf.
+    std::vector<const FieldDescriptor*> path;
+    // The index in |path| of the repeated field, if any, which makes this a
+    // list column.  There is at most one.
+    int repeated_index = -1;
+
+    // For list columns only: the values of row i are those at the indices in
+    // [offsets[i], offsets[i + 1]).  Starts with a single 0.
+    std::vector<int32_t> offsets;
+    // Whether each value is present.  A value is absent if a message on its
+    // path, or the leaf field itself, is not set; the value then holds the
+    // field's default.
+    std::vector<bool> valid;
+
+    // The values, in the member matching the cpp type of the leaf field.
+    // Enum fields are stored as their numbers in |int32_values|.
+    std::vector<int32_t> int32_values;
+    std::vector<int64_t> int64_values;
+    std::vector<uint32_t> uint32_values;
+    std::vector<uint64_t> uint64_values;
+    std::vector<double> double_values;
+    std::vector<float> float_values;
+    std::vector<bool> bool_values;
+    std::vector<std::string> string_values;
+  };
+
+  // Plans a column for every primitive, enum or string field reachable from
+  // |descriptor| through message fields, with at most one repeated field
+  // (the leaf itself, a repeated message or a map) on the way.  Fields under
+  // a second repeated field, recursive occurrences of a message type and
+  // extensions get no column.
+  explicit ColumnarConverter(const Descriptor* descriptor);
+  ColumnarConverter(const ColumnarConverter&) = delete;
+  ColumnarConverter& operator=(const ColumnarConverter&) = delete;
+
+  // Appends one row per message.  The messages must be of the descriptor
+  // passed to the constructor.  Rows are converted a column at a time, so
+  // appending them in batches is faster than one at a time.
+  void AppendRow(const Message& row);
+  void AppendRows(absl::Span<const Message* const> rows);
+  template <typename T>
+  void AppendRows(const RepeatedPtrField<T>& rows) {
+    const std::vector<const Message*> pointers(rows.pointer_begin(),
+                                               rows.pointer_end());
+    AppendRows(pointers);
+  }
+
+  // Removes all rows, keeping the columns.
+  void Clear();
+
+  int num_rows() const { return num_rows_; }
+  const std::vector<Column>& columns() const { return columns_; }
+  // Returns the column with the given name, or nullptr if there is none.
+  const Column* FindColumn(absl::string_view name) const;
+
+ private:
+  void PlanColumns(const Descriptor* descriptor, absl::string_view prefix,
+                   std::vector<const FieldDescriptor*>* path,
+                   int repeated_index,
+                   std::vector<const Descriptor*>* enclosing_types);
+  static void AppendToColumn(const Message& row, Column* column);
+  // Appends the value of |field| in |message|, which is nullptr if a message
+  // on the path is not set.
+  static void AppendValue(const Message* message, const FieldDescriptor* field,
+                          Column* column);
+  static void AppendRepeatedValues(const Message& message,
+                                   const FieldDescriptor* field,
+                                   Column* column);
+
+  std::vector<Column> columns_;
+  int num_rows_ = 0;
+};
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_UTIL_COLUMNAR_CONVERTER_H__
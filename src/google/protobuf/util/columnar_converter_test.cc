@@ -0,0 +1,143 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/columnar_converter.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "google/protobuf/map_unittest.pb.h"
+#include "google/protobuf/repeated_ptr_field.h"
+#include "google/protobuf/unittest.pb.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using ::proto2_unittest::NestedTestAllTypes;
+using ::proto2_unittest::TestAllTypes;
+using ::testing::ElementsAre;
+
+TEST(ColumnarConverterTest, PlansColumns) {
+  ColumnarConverter converter(NestedTestAllTypes::descriptor());
+  EXPECT_NE(converter.FindColumn("payload.optional_int32"), nullptr);
+  EXPECT_NE(converter.FindColumn("payload.optional_nested_message.bb"),
+            nullptr);
+  EXPECT_NE(converter.FindColumn("payload.repeated_int32"), nullptr);
+  EXPECT_NE(converter.FindColumn("payload.repeated_nested_message.bb"),
+            nullptr);
+  // Recursive message fields have no columns.
+  EXPECT_EQ(converter.FindColumn("child.payload.optional_int32"), nullptr);
+  EXPECT_EQ(converter.FindColumn("repeated_child.payload.optional_int32"),
+            nullptr);
+  EXPECT_EQ(converter.FindColumn("payload"), nullptr);
+}
+
+TEST(ColumnarConverterTest, ConvertsSingularFields) {
+  RepeatedPtrField<TestAllTypes> rows;
+  rows.Add()->set_optional_int32(1);
+  rows.Add();
+  TestAllTypes* row = rows.Add();
+  row->set_optional_int32(3);
+  row->set_optional_string("foo");
+  row->mutable_optional_nested_message()->set_bb(4);
+  row->set_optional_nested_enum(TestAllTypes::BAZ);
+
+  ColumnarConverter converter(TestAllTypes::descriptor());
+  converter.AppendRows(rows);
+  EXPECT_EQ(converter.num_rows(), 3);
+
+  const ColumnarConverter::Column* int32s =
+      converter.FindColumn("optional_int32");
+  ASSERT_NE(int32s, nullptr);
+  EXPECT_THAT(int32s->int32_values, ElementsAre(1, 0, 3));
+  EXPECT_THAT(int32s->valid, ElementsAre(true, false, true));
+  EXPECT_TRUE(int32s->offsets.empty());
+
+  const ColumnarConverter::Column* strings =
+      converter.FindColumn("optional_string");
+  ASSERT_NE(strings, nullptr);
+  EXPECT_THAT(strings->string_values, ElementsAre("", "", "foo"));
+  EXPECT_THAT(strings->valid, ElementsAre(false, false, true));
+
+  const ColumnarConverter::Column* nested =
+      converter.FindColumn("optional_nested_message.bb");
+  ASSERT_NE(nested, nullptr);
+  EXPECT_THAT(nested->int32_values, ElementsAre(0, 0, 4));
+  EXPECT_THAT(nested->valid, ElementsAre(false, false, true));
+
+  const ColumnarConverter::Column* enums =
+      converter.FindColumn("optional_nested_enum");
+  ASSERT_NE(enums, nullptr);
+  EXPECT_THAT(enums->int32_values,
+              ElementsAre(TestAllTypes::FOO, TestAllTypes::FOO,
+                          TestAllTypes::BAZ));
+}
+
+TEST(ColumnarConverterTest, ConvertsListColumns) {
+  TestAllTypes row1;
+  row1.add_repeated_int32(1);
+  row1.add_repeated_int32(2);
+  row1.add_repeated_nested_message()->set_bb(5);
+  row1.add_repeated_nested_message();
+  TestAllTypes row2;
+  TestAllTypes row3;
+  row3.add_repeated_int32(3);
+  row3.add_repeated_string("a");
+
+  ColumnarConverter converter(TestAllTypes::descriptor());
+  converter.AppendRow(row1);
+  converter.AppendRows({&row2, &row3});
+  EXPECT_EQ(converter.num_rows(), 3);
+
+  const ColumnarConverter::Column* int32s =
+      converter.FindColumn("repeated_int32");
+  ASSERT_NE(int32s, nullptr);
+  EXPECT_THAT(int32s->offsets, ElementsAre(0, 2, 2, 3));
+  EXPECT_THAT(int32s->int32_values, ElementsAre(1, 2, 3));
+
+  const ColumnarConverter::Column* strings =
+      converter.FindColumn("repeated_string");
+  ASSERT_NE(strings, nullptr);
+  EXPECT_THAT(strings->offsets, ElementsAre(0, 0, 0, 1));
+  EXPECT_THAT(strings->string_values, ElementsAre("a"));
+
+  const ColumnarConverter::Column* nested =
+      converter.FindColumn("repeated_nested_message.bb");
+  ASSERT_NE(nested, nullptr);
+  EXPECT_THAT(nested->offsets, ElementsAre(0, 2, 2, 2));
+  EXPECT_THAT(nested->int32_values, ElementsAre(5, 0));
+  EXPECT_THAT(nested->valid, ElementsAre(true, false));
+
+  converter.Clear();
+  EXPECT_EQ(converter.num_rows(), 0);
+  EXPECT_THAT(int32s->offsets, ElementsAre(0));
+  EXPECT_TRUE(int32s->int32_values.empty());
+}
+
+TEST(ColumnarConverterTest, ConvertsMaps) {
+  proto2_unittest::TestMap row;
+  (*row.mutable_map_int32_int32())[1] = 10;
+  ColumnarConverter converter(proto2_unittest::TestMap::descriptor());
+  converter.AppendRow(row);
+
+  const ColumnarConverter::Column* keys =
+      converter.FindColumn("map_int32_int32.key");
+  const ColumnarConverter::Column* values =
+      converter.FindColumn("map_int32_int32.value");
+  ASSERT_NE(keys, nullptr);
+  ASSERT_NE(values, nullptr);
+  EXPECT_THAT(keys->offsets, ElementsAre(0, 1));
+  EXPECT_THAT(keys->int32_values, ElementsAre(1));
+  EXPECT_THAT(values->int32_values, ElementsAre(10));
+  EXPECT_THAT(values->valid, ElementsAre(true));
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
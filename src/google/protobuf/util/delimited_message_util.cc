@@ -10,7 +10,18 @@
 
 #include "google/protobuf/util/delimited_message_util.h"
 
+#include <climits>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "google/protobuf/arena.h"
 #include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream.h"
+#include "google/protobuf/message_lite.h"
 
 namespace google {
 namespace protobuf {
@@ -101,6 +112,156 @@ bool SerializeDelimitedToCodedStream(const MessageLite& message,
   return true;
 }
 
+namespace {
+
+// Caches the sizes of |messages|, and returns the size of their serialization,
+// each one preceded by its size if |delimited|. Returns -1 if any message or
+// the whole batch is larger than INT_MAX.
+int64_t BatchByteSize(absl::Span<const MessageLite* const> messages,
+                      bool delimited) {
+  int64_t total = 0;
+  for (const MessageLite* message : messages) {
+    const size_t size = message->ByteSizeLong();
+    if (size > INT_MAX) return -1;
+    total += static_cast<int64_t>(size);
+    if (delimited) {
+      total += io::CodedOutputStream::VarintSize32(static_cast<uint32_t>(size));
+    }
+    if (total > INT_MAX) return -1;
+  }
+  return total;
+}
+
+// Writes |messages|, whose sizes are cached, to |target|.
+uint8_t* WriteBatchToArray(absl::Span<const MessageLite* const> messages,
+                           bool delimited, uint8_t* target) {
+  for (const MessageLite* message : messages) {
+    if (delimited) {
+      target = io::CodedOutputStream::WriteVarint32ToArray(
+          static_cast<uint32_t>(message->GetCachedSize()), target);
+    }
+    target = message->SerializeWithCachedSizesToArray(target);
+  }
+  return target;
+}
+
+bool AppendBatchToString(absl::Span<const MessageLite* const> messages,
+                         bool delimited, std::string* output) {
+  const int64_t total = BatchByteSize(messages, delimited);
+  if (total < 0) return false;
+  const size_t old_size = output->size();
+  output->resize(old_size + static_cast<size_t>(total));
+  uint8_t* target = reinterpret_cast<uint8_t*>(&(*output)[0]) + old_size;
+  WriteBatchToArray(messages, delimited, target);
+  return true;
+}
+
+}  // namespace
+
+bool SerializeDelimitedBatchToZeroCopyStream(
+    absl::Span<const MessageLite* const> messages,
+    io::ZeroCopyOutputStream* output) {
+  const int64_t total = BatchByteSize(messages, /*delimited=*/true);
+  if (total < 0) return false;
+  io::CodedOutputStream coded_output(output);
+  uint8_t* buffer =
+      coded_output.GetDirectBufferForNBytesAndAdvance(static_cast<int>(total));
+  if (buffer != nullptr) {
+    WriteBatchToArray(messages, /*delimited=*/true, buffer);
+    return true;
+  }
+  for (const MessageLite* message : messages) {
+    coded_output.WriteVarint32(static_cast<uint32_t>(message->GetCachedSize()));
+    message->SerializeWithCachedSizes(&coded_output);
+  }
+  return !coded_output.HadError();
+}
+
+bool AppendDelimitedBatchToString(absl::Span<const MessageLite* const> messages,
+                                  std::string* output) {
+  return AppendBatchToString(messages, /*delimited=*/true, output);
+}
+
+bool AppendConcatenatedBatchToString(
+    absl::Span<const MessageLite* const> messages, std::string* output) {
+  return AppendBatchToString(messages, /*delimited=*/false, output);
+}
+
+namespace {
+// Once a DelimitedMessageReader's CodedInputStream has read this many bytes,
+// it is replaced by a fresh one before reading the next message. Keeping this
+// well below INT_MAX leaves room for large messages.
+constexpr int kReaderResetBytes = 64 << 20;
+}  // namespace
+
+DelimitedMessageReader::DelimitedMessageReader(io::ZeroCopyInputStream* input)
+    : input_(input),
+      coded_input_(std::make_unique<io::CodedInputStream>(input)) {}
+
+DelimitedMessageReader::~DelimitedMessageReader() = default;
+
+void DelimitedMessageReader::MaybeResetCodedInput() {
+  if (coded_input_->CurrentPosition() < kReaderResetBytes) return;
+  bytes_before_ += coded_input_->CurrentPosition();
+  // Destroying the old stream backs up its unread data into input_.
+  coded_input_.reset();
+  coded_input_ = std::make_unique<io::CodedInputStream>(input_);
+}
+
+bool DelimitedMessageReader::Read(MessageLite* message, bool* clean_eof) {
+  MaybeResetCodedInput();
+  return ParseDelimitedFromCodedStream(message, coded_input_.get(), clean_eof);
+}
+
+int DelimitedMessageReader::ReadBatch(const MessageLite& prototype,
+                                      Arena* arena, int max_messages,
+                                      std::vector<MessageLite*>* messages,
+                                      bool* clean_eof) {
+  if (clean_eof != nullptr) *clean_eof = false;
+  int count = 0;
+  while (count < max_messages) {
+    MessageLite* message = prototype.New(arena);
+    if (!Read(message, clean_eof)) break;
+    messages->push_back(message);
+    ++count;
+  }
+  return count;
+}
+
+bool DelimitedMessageReader::Skip(int count, bool* clean_eof) {
+  if (clean_eof != nullptr) *clean_eof = false;
+  for (int i = 0; i < count; ++i) {
+    MaybeResetCodedInput();
+    int start = coded_input_->CurrentPosition();
+    uint32_t size;
+    if (!coded_input_->ReadVarint32(&size)) {
+      if (clean_eof != nullptr) {
+        *clean_eof = coded_input_->CurrentPosition() == start;
+      }
+      return false;
+    }
+    if (size > INT_MAX || !coded_input_->Skip(static_cast<int>(size))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+DelimitedMessageWriter::DelimitedMessageWriter(io::ZeroCopyOutputStream* output)
+    : coded_output_(output) {}
+
+bool DelimitedMessageWriter::Write(const MessageLite& message) {
+  if (!SerializeDelimitedToCodedStream(message, &coded_output_)) return false;
+  uint32_t size = static_cast<uint32_t>(message.GetCachedSize());
+  byte_count_ += io::CodedOutputStream::VarintSize32(size) + size;
+  return true;
+}
+
+bool DelimitedMessageWriter::Flush() {
+  coded_output_.Trim();
+  return !coded_output_.HadError();
+}
+
 }  // namespace util
 }  // namespace protobuf
 }  // namespace google
@@ -11,9 +11,16 @@
 #ifndef GOOGLE_PROTOBUF_UTIL_DELIMITED_MESSAGE_UTIL_H__
 #define GOOGLE_PROTOBUF_UTIL_DELIMITED_MESSAGE_UTIL_H__
 
+#include <cstdint>
+#include <memory>
 #include <ostream>
+#include <string>
+#include <vector>
 
+#include "absl/types/span.h"
+#include "google/protobuf/arena.h"
 #include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
 #include "google/protobuf/message_lite.h"
 
@@ -76,6 +83,111 @@ bool PROTOBUF_EXPORT SerializeDelimitedToZeroCopyStream(
 bool PROTOBUF_EXPORT SerializeDelimitedToCodedStream(
     const MessageLite& message, io::CodedOutputStream* output);
 
+// Writes each of |messages| as a size-delimited message, in order. All the
+// sizes are computed first, and the messages are then written through one
+// CodedOutputStream; when the stream's buffer has room for the whole batch,
+// it is written straight to that buffer. This is cheaper than calling
+// SerializeDelimitedToZeroCopyStream() for each of many small messages.
+bool PROTOBUF_EXPORT SerializeDelimitedBatchToZeroCopyStream(
+    absl::Span<const MessageLite* const> messages,
+    io::ZeroCopyOutputStream* output);
+
+// Appends each of |messages| to |output| as a size-delimited message, growing
+// |output| once for the whole batch.
+bool PROTOBUF_EXPORT AppendDelimitedBatchToString(
+    absl::Span<const MessageLite* const> messages, std::string* output);
+
+// Appends the serializations of |messages| to |output| back to back, growing
+// |output| once for the whole batch. Parsing the result merges the messages.
+bool PROTOBUF_EXPORT AppendConcatenatedBatchToString(
+    absl::Span<const MessageLite* const> messages, std::string* output);
+
+// Reads a sequence of size-delimited messages from a ZeroCopyInputStream.
+// ParseDelimitedFromZeroCopyStream() sets up a new CodedInputStream for every
+// message; a DelimitedMessageReader keeps one across messages, which matters
+// when reading long streams of small records. The ZeroCopyInputStream must
+// not be used directly while the reader exists; once it is destroyed, any
+// data the reader buffered but did not consume is backed up into the stream.
+class PROTOBUF_EXPORT DelimitedMessageReader {
+ public:
+  explicit DelimitedMessageReader(io::ZeroCopyInputStream* input);
+  DelimitedMessageReader(const DelimitedMessageReader&) = delete;
+  DelimitedMessageReader& operator=(const DelimitedMessageReader&) = delete;
+  ~DelimitedMessageReader();
+
+  // Merges the next message in the stream into |message|. Return value and
+  // |clean_eof| have the same meaning as for ParseDelimitedFromCodedStream().
+  bool Read(MessageLite* message, bool* clean_eof = nullptr);
+
+  // Reads up to |max_messages| messages, each into a new message of the same
+  // type as |prototype| allocated on |arena|, and appends them to |messages|.
+  // Returns the number of messages read; a result smaller than |max_messages|
+  // means the stream ended or an error occurred, which |clean_eof|
+  // distinguishes as in Read(). |arena| must not be null. It owns the
+  // messages, so a replay loop can Reset() it after each batch to reuse its
+  // memory.
+  int ReadBatch(const MessageLite& prototype, Arena* arena, int max_messages,
+                std::vector<MessageLite*>* messages,
+                bool* clean_eof = nullptr);
+
+  // Skips the next |count| messages without parsing them. Returns false if the
+  // stream ended or was malformed first; |clean_eof| is set as in Read() for
+  // the message at which that happened.
+  bool Skip(int count, bool* clean_eof = nullptr);
+
+  // Returns the number of bytes consumed since the reader was constructed,
+  // i.e. the offset of the next message. Together with
+  // DelimitedMessageWriter::ByteCount() this lets callers record the offsets
+  // of selected messages and later start a reader directly at one of them,
+  // for instance to seek or to split a large stream between workers.
+  int64_t ByteCount() const {
+    return bytes_before_ + coded_input_->CurrentPosition();
+  }
+
+ private:
+  void MaybeResetCodedInput();
+
+  io::ZeroCopyInputStream* input_;
+  // CodedInputStream tracks its position in an int, so it is recreated from
+  // time to time to read streams larger than 2GB.
+  std::unique_ptr<io::CodedInputStream> coded_input_;
+  // Bytes consumed by previous instances of coded_input_.
+  int64_t bytes_before_ = 0;
+};
+
+// Writes a sequence of size-delimited messages to a ZeroCopyOutputStream
+// through a single CodedOutputStream, so consecutive messages share output
+// buffers rather than each one acquiring and trimming its own. The
+// ZeroCopyOutputStream must not be used directly until Flush() is called or
+// the writer is destroyed.
+class PROTOBUF_EXPORT DelimitedMessageWriter {
+ public:
+  explicit DelimitedMessageWriter(io::ZeroCopyOutputStream* output);
+  DelimitedMessageWriter(const DelimitedMessageWriter&) = delete;
+  DelimitedMessageWriter& operator=(const DelimitedMessageWriter&) = delete;
+  ~DelimitedMessageWriter() = default;
+
+  // Writes |message| preceded by its size. Returns false on error, after
+  // which the writer should not be used further.
+  bool Write(const MessageLite& message);
+
+  // Returns the unused part of the current buffer to the ZeroCopyOutputStream,
+  // so that everything written so far has been handed to it. This does not
+  // flush the ZeroCopyOutputStream itself (e.g. FileOutputStream::Flush()).
+  // Returns false if an error occurred while writing.
+  bool Flush();
+
+  bool HadError() { return coded_output_.HadError(); }
+
+  // Returns the number of bytes written since the writer was constructed,
+  // i.e. the offset at which the next message will start.
+  int64_t ByteCount() const { return byte_count_; }
+
+ private:
+  io::CodedOutputStream coded_output_;
+  int64_t byte_count_ = 0;
+};
+
 }  // namespace util
 }  // namespace protobuf
 }  // namespace google
@@ -10,10 +10,15 @@
 
 #include "google/protobuf/util/delimited_message_util.h"
 
+#include <cstdint>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "google/protobuf/testing/googletest.h"
 #include <gtest/gtest.h>
+#include "google/protobuf/arena.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 #include "google/protobuf/test_util.h"
 #include "google/protobuf/unittest.pb.h"
 
@@ -88,6 +93,202 @@ TEST(DelimitedMessageUtilTest, FailsAtEndOfStream) {
   }
 }
 
+TEST(DelimitedMessageUtilTest, ReaderAndWriter) {
+  std::string data;
+
+  {
+    io::StringOutputStream zstream(&data);
+    DelimitedMessageWriter writer(&zstream);
+    for (int i = 0; i < 100; ++i) {
+      proto2_unittest::ForeignMessage message;
+      message.set_c(i);
+      EXPECT_TRUE(writer.Write(message));
+    }
+    proto2_unittest::TestAllTypes all_types;
+    TestUtil::SetAllFields(&all_types);
+    EXPECT_TRUE(writer.Write(all_types));
+    EXPECT_TRUE(writer.Flush());
+  }
+
+  // The writer produces the same bytes as the one-shot functions.
+  std::string expected;
+  {
+    io::StringOutputStream zstream(&expected);
+    for (int i = 0; i < 100; ++i) {
+      proto2_unittest::ForeignMessage message;
+      message.set_c(i);
+      EXPECT_TRUE(SerializeDelimitedToZeroCopyStream(message, &zstream));
+    }
+    proto2_unittest::TestAllTypes all_types;
+    TestUtil::SetAllFields(&all_types);
+    EXPECT_TRUE(SerializeDelimitedToZeroCopyStream(all_types, &zstream));
+  }
+  EXPECT_EQ(data, expected);
+
+  io::ArrayInputStream zstream(data.data(), static_cast<int>(data.size()),
+                               /*block_size=*/7);
+  DelimitedMessageReader reader(&zstream);
+  for (int i = 0; i < 100; ++i) {
+    proto2_unittest::ForeignMessage message;
+    bool clean_eof = true;
+    ASSERT_TRUE(reader.Read(&message, &clean_eof));
+    EXPECT_FALSE(clean_eof);
+    EXPECT_EQ(message.c(), i);
+  }
+  proto2_unittest::TestAllTypes all_types;
+  EXPECT_TRUE(reader.Read(&all_types));
+  TestUtil::ExpectAllFieldsSet(all_types);
+
+  bool clean_eof = false;
+  EXPECT_FALSE(reader.Read(&all_types, &clean_eof));
+  EXPECT_TRUE(clean_eof);
+}
+
+TEST(DelimitedMessageUtilTest, ReaderBatches) {
+  std::string data;
+  {
+    io::StringOutputStream zstream(&data);
+    DelimitedMessageWriter writer(&zstream);
+    for (int i = 0; i < 25; ++i) {
+      proto2_unittest::ForeignMessage message;
+      message.set_c(i);
+      EXPECT_TRUE(writer.Write(message));
+    }
+  }
+
+  io::ArrayInputStream zstream(data.data(), static_cast<int>(data.size()));
+  DelimitedMessageReader reader(&zstream);
+  Arena arena;
+  int next = 0;
+  for (int expected_count : {10, 10, 5}) {
+    std::vector<MessageLite*> messages;
+    bool clean_eof = false;
+    EXPECT_EQ(
+        reader.ReadBatch(proto2_unittest::ForeignMessage::default_instance(),
+                         &arena, 10, &messages, &clean_eof),
+        expected_count);
+    ASSERT_EQ(messages.size(), static_cast<size_t>(expected_count));
+    EXPECT_EQ(clean_eof, expected_count < 10);
+    for (MessageLite* message : messages) {
+      EXPECT_EQ(message->GetArena(), &arena);
+      EXPECT_EQ(static_cast<proto2_unittest::ForeignMessage*>(message)->c(),
+                next++);
+    }
+    arena.Reset();
+  }
+}
+
+TEST(DelimitedMessageUtilTest, SkipAndOffsets) {
+  std::string data;
+  std::vector<int64_t> offsets;
+  {
+    io::StringOutputStream zstream(&data);
+    DelimitedMessageWriter writer(&zstream);
+    for (int i = 0; i < 20; ++i) {
+      offsets.push_back(writer.ByteCount());
+      proto2_unittest::ForeignMessage message;
+      message.set_c(i * 1000);
+      EXPECT_TRUE(writer.Write(message));
+    }
+    EXPECT_TRUE(writer.Flush());
+    EXPECT_EQ(writer.ByteCount(), static_cast<int64_t>(data.size()));
+  }
+
+  {
+    io::ArrayInputStream zstream(data.data(), static_cast<int>(data.size()));
+    DelimitedMessageReader reader(&zstream);
+    EXPECT_EQ(reader.ByteCount(), 0);
+    EXPECT_TRUE(reader.Skip(10));
+    EXPECT_EQ(reader.ByteCount(), offsets[10]);
+    proto2_unittest::ForeignMessage message;
+    EXPECT_TRUE(reader.Read(&message));
+    EXPECT_EQ(message.c(), 10000);
+    EXPECT_EQ(reader.ByteCount(), offsets[11]);
+
+    bool clean_eof = false;
+    EXPECT_FALSE(reader.Skip(10, &clean_eof));
+    EXPECT_TRUE(clean_eof);
+  }
+
+  // A reader can start at any recorded offset.
+  {
+    io::ArrayInputStream zstream(data.data() + offsets[15],
+                                 static_cast<int>(data.size() - offsets[15]));
+    DelimitedMessageReader reader(&zstream);
+    proto2_unittest::ForeignMessage message;
+    EXPECT_TRUE(reader.Read(&message));
+    EXPECT_EQ(message.c(), 15000);
+  }
+}
+
+TEST(DelimitedMessageUtilTest, ReaderFailsOnTruncatedMessage) {
+  std::string data;
+  {
+    io::StringOutputStream zstream(&data);
+    proto2_unittest::ForeignMessage message;
+    message.set_c(42);
+    message.set_d(24);
+    EXPECT_TRUE(SerializeDelimitedToZeroCopyStream(message, &zstream));
+  }
+  data.resize(data.size() - 1);
+
+  io::ArrayInputStream zstream(data.data(), static_cast<int>(data.size()));
+  DelimitedMessageReader reader(&zstream);
+  proto2_unittest::ForeignMessage message;
+  bool clean_eof = true;
+  EXPECT_FALSE(reader.Read(&message, &clean_eof));
+  EXPECT_FALSE(clean_eof);
+}
+
+TEST(DelimitedMessageUtilTest, SerializeBatch) {
+  std::vector<proto2_unittest::ForeignMessage> foreign(100);
+  std::vector<const MessageLite*> messages;
+  for (int i = 0; i < 100; ++i) {
+    foreign[i].set_c(i);
+    messages.push_back(&foreign[i]);
+  }
+  proto2_unittest::TestAllTypes all_types;
+  TestUtil::SetAllFields(&all_types);
+  messages.push_back(&all_types);
+
+  std::string expected;
+  {
+    io::StringOutputStream zstream(&expected);
+    for (const MessageLite* message : messages) {
+      EXPECT_TRUE(SerializeDelimitedToZeroCopyStream(*message, &zstream));
+    }
+  }
+
+  std::string data = "prefix";
+  EXPECT_TRUE(AppendDelimitedBatchToString(messages, &data));
+  EXPECT_EQ(data, "prefix" + expected);
+
+  // Both with a buffer that holds the batch and with one that does not.
+  for (int block_size : {-1, 7}) {
+    std::string buffer(expected.size(), '\0');
+    io::ArrayOutputStream zstream(&buffer[0], static_cast<int>(buffer.size()),
+                                  block_size);
+    EXPECT_TRUE(SerializeDelimitedBatchToZeroCopyStream(messages, &zstream));
+    EXPECT_EQ(buffer, expected) << block_size;
+  }
+  // Fails when the stream runs out of space.
+  std::string buffer(expected.size() - 1, '\0');
+  io::ArrayOutputStream zstream(&buffer[0], static_cast<int>(buffer.size()));
+  EXPECT_FALSE(SerializeDelimitedBatchToZeroCopyStream(messages, &zstream));
+
+  std::string concatenated;
+  EXPECT_TRUE(AppendConcatenatedBatchToString(messages, &concatenated));
+  std::string expected_concatenated;
+  for (const MessageLite* message : messages) {
+    expected_concatenated += message->SerializeAsString();
+  }
+  EXPECT_EQ(concatenated, expected_concatenated);
+
+  data.clear();
+  EXPECT_TRUE(AppendDelimitedBatchToString({}, &data));
+  EXPECT_TRUE(data.empty());
+}
+
 }  // namespace util
 }  // namespace protobuf
 }  // namespace google
@@ -7,6 +7,7 @@
 
 #include "google/protobuf/util/field_mask_util.h"
 
+#include <climits>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -17,11 +18,14 @@
 #include "absl/log/absl_log.h"
 #include "absl/log/die_if_null.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/strip.h"
+#include "google/protobuf/io/coded_stream.h"
 #include "google/protobuf/message.h"
+#include "google/protobuf/wire_format_lite.h"
 
 // Must be included last.
 #include "google/protobuf/port_def.inc"
@@ -159,6 +163,83 @@ void FieldMaskUtil::GetFieldMaskForAllFields(const Descriptor* descriptor,
 }
 
 namespace {
+// Merges the value of `field` from `source` into `destination`.
+void MergeField(const FieldDescriptor* field, const Message& source,
+                const FieldMaskUtil::MergeOptions& options,
+                Message* destination) {
+  const Reflection* source_reflection = source.GetReflection();
+  const Reflection* destination_reflection = destination->GetReflection();
+  if (!field->is_repeated()) {
+    switch (field->cpp_type()) {
+#define COPY_VALUE(TYPE, Name)                                              \
+  case FieldDescriptor::CPPTYPE_##TYPE: {                                   \
+    if (source_reflection->HasField(source, field)) {                       \
+      destination_reflection->Set##Name(                                    \
+          destination, field, source_reflection->Get##Name(source, field)); \
+    } else {                                                                \
+      destination_reflection->ClearField(destination, field);               \
+    }                                                                       \
+    break;                                                                  \
+  }
+      COPY_VALUE(BOOL, Bool)
+      COPY_VALUE(INT32, Int32)
+      COPY_VALUE(INT64, Int64)
+      COPY_VALUE(UINT32, UInt32)
+      COPY_VALUE(UINT64, UInt64)
+      COPY_VALUE(FLOAT, Float)
+      COPY_VALUE(DOUBLE, Double)
+      COPY_VALUE(ENUM, Enum)
+      COPY_VALUE(STRING, String)
+#undef COPY_VALUE
+      case FieldDescriptor::CPPTYPE_MESSAGE: {
+        if (options.replace_message_fields()) {
+          destination_reflection->ClearField(destination, field);
+        }
+        if (source_reflection->HasField(source, field)) {
+          destination_reflection->MutableMessage(destination, field)
+              ->MergeFrom(source_reflection->GetMessage(source, field));
+        }
+        break;
+      }
+    }
+  } else {
+    if (options.replace_repeated_fields()) {
+      destination_reflection->ClearField(destination, field);
+    }
+    switch (field->cpp_type()) {
+#define COPY_REPEATED_VALUE(TYPE, Name)                            \
+  case FieldDescriptor::CPPTYPE_##TYPE: {                          \
+    int size = source_reflection->FieldSize(source, field);        \
+    for (int i = 0; i < size; ++i) {                               \
+      destination_reflection->Add##Name(                           \
+          destination, field,                                      \
+          source_reflection->GetRepeated##Name(source, field, i)); \
+    }                                                              \
+    break;                                                         \
+  }
+      COPY_REPEATED_VALUE(BOOL, Bool)
+      COPY_REPEATED_VALUE(INT32, Int32)
+      COPY_REPEATED_VALUE(INT64, Int64)
+      COPY_REPEATED_VALUE(UINT32, UInt32)
+      COPY_REPEATED_VALUE(UINT64, UInt64)
+      COPY_REPEATED_VALUE(FLOAT, Float)
+      COPY_REPEATED_VALUE(DOUBLE, Double)
+      COPY_REPEATED_VALUE(ENUM, Enum)
+      COPY_REPEATED_VALUE(STRING, String)
+#undef COPY_REPEATED_VALUE
+      case FieldDescriptor::CPPTYPE_MESSAGE: {
+        int size = source_reflection->FieldSize(source, field);
+        for (int i = 0; i < size; ++i) {
+          destination_reflection->AddMessage(destination, field)
+              ->MergeFrom(
+                  source_reflection->GetRepeatedMessage(source, field, i));
+        }
+        break;
+      }
+    }
+  }
+}
+
 // A FieldMaskTree represents a FieldMask in a tree structure. For example,
 // given a FieldMask "foo.bar,foo.baz,bar.baz", the FieldMaskTree will be:
 //
@@ -232,6 +313,17 @@ class FieldMaskTree {
     return TrimMessage(&root_, message);
   }
 
+  // Appends to "out" the fields of the serialized message "data" of type
+  // "descriptor" that are specified by this tree, in wire format. Returns
+  // false if "data" is malformed.
+  bool FilterWireFormat(const Descriptor* descriptor, absl::string_view data,
+                        std::string* out) {
+    if (data.size() > INT_MAX) return false;
+    io::CodedInputStream input(reinterpret_cast<const uint8_t*>(data.data()),
+                               static_cast<int>(data.size()));
+    return FilterWireFormat(&root_, descriptor, data.data(), &input, 0, out);
+  }
+
  private:
   struct Node {
     Node() = default;
@@ -271,6 +363,15 @@ class FieldMaskTree {
   // Returns true if the message is actually modified
   bool TrimMessage(const Node* node, Message* message);
 
+  // Copies the fields specified by a sub-tree from "input", which reads the
+  // buffer starting at "base", to "out". Stops at the current limit of
+  // "input" or, if "end_group_tag" is not zero, after that tag.
+  bool FilterWireFormat(const Node* node, const Descriptor* descriptor,
+                        const char* base, io::CodedInputStream* input,
+                        uint32_t end_group_tag, std::string* out);
+
+  friend class util::CompiledFieldMask;
+
   Node root_;
 };
 
@@ -454,75 +555,7 @@ void FieldMaskTree::MergeMessage(const Node* node, const Message& source,
                    destination_reflection->MutableMessage(destination, field));
       continue;
     }
-    if (!field->is_repeated()) {
-      switch (field->cpp_type()) {
-#define COPY_VALUE(TYPE, Name)                                              \
-  case FieldDescriptor::CPPTYPE_##TYPE: {                                   \
-    if (source_reflection->HasField(source, field)) {                       \
-      destination_reflection->Set##Name(                                    \
-          destination, field, source_reflection->Get##Name(source, field)); \
-    } else {                                                                \
-      destination_reflection->ClearField(destination, field);               \
-    }                                                                       \
-    break;                                                                  \
-  }
-        COPY_VALUE(BOOL, Bool)
-        COPY_VALUE(INT32, Int32)
-        COPY_VALUE(INT64, Int64)
-        COPY_VALUE(UINT32, UInt32)
-        COPY_VALUE(UINT64, UInt64)
-        COPY_VALUE(FLOAT, Float)
-        COPY_VALUE(DOUBLE, Double)
-        COPY_VALUE(ENUM, Enum)
-        COPY_VALUE(STRING, String)
-#undef COPY_VALUE
-        case FieldDescriptor::CPPTYPE_MESSAGE: {
-          if (options.replace_message_fields()) {
-            destination_reflection->ClearField(destination, field);
-          }
-          if (source_reflection->HasField(source, field)) {
-            destination_reflection->MutableMessage(destination, field)
-                ->MergeFrom(source_reflection->GetMessage(source, field));
-          }
-          break;
-        }
-      }
-    } else {
-      if (options.replace_repeated_fields()) {
-        destination_reflection->ClearField(destination, field);
-      }
-      switch (field->cpp_type()) {
-#define COPY_REPEATED_VALUE(TYPE, Name)                            \
-  case FieldDescriptor::CPPTYPE_##TYPE: {                          \
-    int size = source_reflection->FieldSize(source, field);        \
-    for (int i = 0; i < size; ++i) {                               \
-      destination_reflection->Add##Name(                           \
-          destination, field,                                      \
-          source_reflection->GetRepeated##Name(source, field, i)); \
-    }                                                              \
-    break;                                                         \
-  }
-        COPY_REPEATED_VALUE(BOOL, Bool)
-        COPY_REPEATED_VALUE(INT32, Int32)
-        COPY_REPEATED_VALUE(INT64, Int64)
-        COPY_REPEATED_VALUE(UINT32, UInt32)
-        COPY_REPEATED_VALUE(UINT64, UInt64)
-        COPY_REPEATED_VALUE(FLOAT, Float)
-        COPY_REPEATED_VALUE(DOUBLE, Double)
-        COPY_REPEATED_VALUE(ENUM, Enum)
-        COPY_REPEATED_VALUE(STRING, String)
-#undef COPY_REPEATED_VALUE
-        case FieldDescriptor::CPPTYPE_MESSAGE: {
-          int size = source_reflection->FieldSize(source, field);
-          for (int i = 0; i < size; ++i) {
-            destination_reflection->AddMessage(destination, field)
-                ->MergeFrom(
-                    source_reflection->GetRepeatedMessage(source, field, i));
-          }
-          break;
-        }
-      }
-    }
+    MergeField(field, source, options, destination);
   }
 }
 
@@ -594,6 +627,82 @@ bool FieldMaskTree::TrimMessage(const Node* node, Message* message) {
   return modified;
 }
 
+void AppendVarint32(uint32_t value, std::string* out) {
+  uint8_t buffer[5];
+  uint8_t* end = io::CodedOutputStream::WriteVarint32ToArray(value, buffer);
+  out->append(reinterpret_cast<const char*>(buffer), end - buffer);
+}
+
+bool FieldMaskTree::FilterWireFormat(const Node* node,
+                                     const Descriptor* descriptor,
+                                     const char* base,
+                                     io::CodedInputStream* input,
+                                     uint32_t end_group_tag, std::string* out) {
+  using internal::WireFormatLite;
+  while (input->BytesUntilLimit() > 0) {
+    const int start = input->CurrentPosition();
+    const uint32_t tag = input->ReadTag();
+    if (end_group_tag != 0 && tag == end_group_tag) return true;
+    const int field_number = WireFormatLite::GetTagFieldNumber(tag);
+    const WireFormatLite::WireType wire_type =
+        WireFormatLite::GetTagWireType(tag);
+    if (field_number == 0 || wire_type == WireFormatLite::WIRETYPE_END_GROUP) {
+      return false;
+    }
+
+    const FieldDescriptor* field = descriptor->FindFieldByNumber(field_number);
+    const Node* child = nullptr;
+    if (field != nullptr) {
+      auto it = node->children.find(field->name());
+      if (it != node->children.end()) child = it->second.get();
+    }
+
+    if (child != nullptr && !child->children.empty() &&
+        field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      // Only some of the sub-message's fields are specified, so filter it
+      // recursively.
+      if (wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+        uint32_t length;
+        if (!input->ReadVarint32(&length) ||
+            length > static_cast<uint32_t>(input->BytesUntilLimit())) {
+          return false;
+        }
+        std::string filtered;
+        io::CodedInputStream::Limit limit =
+            input->PushLimit(static_cast<int>(length));
+        if (!FilterWireFormat(child, field->message_type(), base, input, 0,
+                              &filtered)) {
+          return false;
+        }
+        input->PopLimit(limit);
+        AppendVarint32(tag, out);
+        AppendVarint32(static_cast<uint32_t>(filtered.size()), out);
+        out->append(filtered);
+        continue;
+      }
+      if (wire_type == WireFormatLite::WIRETYPE_START_GROUP) {
+        const uint32_t group_end_tag = WireFormatLite::MakeTag(
+            field_number, WireFormatLite::WIRETYPE_END_GROUP);
+        AppendVarint32(tag, out);
+        if (!FilterWireFormat(child, field->message_type(), base, input,
+                              group_end_tag, out)) {
+          return false;
+        }
+        AppendVarint32(group_end_tag, out);
+        continue;
+      }
+    }
+
+    // The field is either specified as a whole or not at all.
+    if (!WireFormatLite::SkipField(input, tag)) return false;
+    if (child != nullptr) {
+      out->append(base + start, input->CurrentPosition() - start);
+    }
+  }
+  // A group must end with its end-group tag rather than at a limit.
+  return end_group_tag == 0;
+}
+
 }  // namespace
 
 void FieldMaskUtil::ToCanonicalForm(const FieldMask& mask, FieldMask* out) {
@@ -676,6 +785,19 @@ bool FieldMaskUtil::TrimMessage(const FieldMask& mask, Message* message) {
   return tree.TrimMessage(ABSL_DIE_IF_NULL(message));
 }
 
+bool FieldMaskUtil::MergeFromString(const FieldMask& mask,
+                                    absl::string_view data, Message* message) {
+  if (mask.paths_size() == 0) return message->MergePartialFromString(data);
+  FieldMaskTree tree;
+  tree.MergeFromFieldMask(mask);
+  std::string filtered;
+  if (!tree.FilterWireFormat(ABSL_DIE_IF_NULL(message)->GetDescriptor(), data,
+                             &filtered)) {
+    return false;
+  }
+  return message->MergePartialFromString(filtered);
+}
+
 bool FieldMaskUtil::TrimMessage(const FieldMask& mask, Message* message,
                                 const TrimOptions& options) {
   // Build a FieldMaskTree and walk through the tree to merge all specified
@@ -690,6 +812,254 @@ bool FieldMaskUtil::TrimMessage(const FieldMask& mask, Message* message,
   return tree.TrimMessage(ABSL_DIE_IF_NULL(message));
 }
 
+namespace {
+// Trims a required field that FieldMaskUtil::TrimMessage() keeps because of
+// keep_required_fields although it is not in the mask: down to its own
+// required fields, recursively, or not at all if it has none.
+bool TrimToRequiredFields(Message* message) {
+  const Reflection* reflection = message->GetReflection();
+  const Descriptor* descriptor = message->GetDescriptor();
+  const int32_t field_count = descriptor->field_count();
+  bool has_required_fields = false;
+  for (int index = 0; index < field_count; ++index) {
+    has_required_fields |= descriptor->field(index)->is_required();
+  }
+  if (!has_required_fields) return false;
+  bool modified = false;
+  for (int index = 0; index < field_count; ++index) {
+    const FieldDescriptor* field = descriptor->field(index);
+    if (field->is_required()) {
+      if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+          reflection->HasField(*message, field)) {
+        modified = TrimToRequiredFields(
+                       reflection->MutableMessage(message, field)) ||
+                   modified;
+      }
+      continue;
+    }
+    if (field->is_repeated() ? reflection->FieldSize(*message, field) != 0
+                             : reflection->HasField(*message, field)) {
+      modified = true;
+    }
+    reflection->ClearField(message, field);
+  }
+  return modified;
+}
+}  // namespace
+
+CompiledFieldMask::CompiledFieldMask(const FieldMask& mask,
+                                     const Descriptor* descriptor)
+    : descriptor_(ABSL_DIE_IF_NULL(descriptor)) {
+  FieldMaskTree tree;
+  tree.MergeFromFieldMask(mask);
+  if (tree.root_.children.empty()) return;
+  AddNode(nullptr, /*leaf=*/false);
+  // Resolves the children of `tree_node`, a message of type `type`, into the
+  // children of `node`.
+  const auto compile = [this](const auto& compile,
+                              const FieldMaskTree::Node* tree_node,
+                              const Descriptor* type, int node) -> void {
+    nodes_[node].by_field_index.assign(type->field_count(), -1);
+    for (const auto& kv : tree_node->children) {
+      const FieldDescriptor* field = type->FindFieldByName(kv.first);
+      if (field == nullptr) {
+        ABSL_LOG(ERROR) << "Cannot find field \"" << kv.first
+                        << "\" in message " << type->full_name();
+        AddUnresolvedPaths(kv.first, kv.second.get(), node);
+        continue;
+      }
+      const FieldMaskTree::Node* tree_child = kv.second.get();
+      const int child = AddNode(field, tree_child->children.empty());
+      nodes_[node].children.push_back(child);
+      nodes_[node].by_field_index[field->index()] = child;
+      if (nodes_[child].leaf) continue;
+      if (field->is_repeated() ||
+          field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+        ABSL_LOG(ERROR) << "Field \"" << kv.first << "\" in message "
+                        << type->full_name()
+                        << " is not a singular message field and cannot "
+                        << "have sub-fields.";
+        nodes_[child].leaf = true;
+        nodes_[child].invalid_sub_paths = true;
+        for (const auto& sub_path : tree_child->children) {
+          AddUnresolvedPaths(sub_path.first, sub_path.second.get(), child);
+        }
+        continue;
+      }
+      compile(compile, tree_child, field->message_type(), child);
+    }
+  };
+  compile(compile, &tree.root_, descriptor_, 0);
+}
+
+template <typename TreeNode>
+void CompiledFieldMask::AddUnresolvedPaths(absl::string_view path,
+                                           const TreeNode* tree_node,
+                                           int node) {
+  if (tree_node->children.empty()) {
+    nodes_[node].unresolved_paths.emplace_back(path);
+    return;
+  }
+  for (const auto& kv : tree_node->children) {
+    AddUnresolvedPaths(absl::StrCat(path, ".", kv.first), kv.second.get(),
+                       node);
+  }
+}
+
+int CompiledFieldMask::AddNode(const FieldDescriptor* field, bool leaf) {
+  nodes_.emplace_back();
+  nodes_.back().field = field;
+  nodes_.back().leaf = leaf;
+  return static_cast<int>(nodes_.size()) - 1;
+}
+
+void CompiledFieldMask::MergeMessageTo(
+    const Message& source, const FieldMaskUtil::MergeOptions& options,
+    Message* destination) const {
+  ABSL_CHECK(source.GetDescriptor() == descriptor_);
+  ABSL_CHECK(destination->GetDescriptor() == descriptor_);
+  if (empty()) return;
+  MergeMessage(0, source, options, destination);
+}
+
+void CompiledFieldMask::MergeMessage(int node, const Message& source,
+                                     const FieldMaskUtil::MergeOptions& options,
+                                     Message* destination) const {
+  const Reflection* source_reflection = source.GetReflection();
+  const Reflection* destination_reflection = destination->GetReflection();
+  for (int child : nodes_[node].children) {
+    const Node& child_node = nodes_[child];
+    if (child_node.invalid_sub_paths) continue;
+    if (!child_node.leaf) {
+      MergeMessage(
+          child, source_reflection->GetMessage(source, child_node.field),
+          options,
+          destination_reflection->MutableMessage(destination,
+                                                 child_node.field));
+      continue;
+    }
+    MergeField(child_node.field, source, options, destination);
+  }
+}
+
+bool CompiledFieldMask::TrimMessage(Message* message) const {
+  return TrimMessage(message, FieldMaskUtil::TrimOptions());
+}
+
+bool CompiledFieldMask::TrimMessage(
+    Message* message, const FieldMaskUtil::TrimOptions& options) const {
+  ABSL_CHECK(ABSL_DIE_IF_NULL(message)->GetDescriptor() == descriptor_);
+  if (empty()) return false;
+  return TrimMessage(0, options.keep_required_fields(), message);
+}
+
+bool CompiledFieldMask::TrimMessage(int node, bool keep_required_fields,
+                                    Message* message) const {
+  const Reflection* reflection = message->GetReflection();
+  const Descriptor* descriptor = message->GetDescriptor();
+  const int32_t field_count = descriptor->field_count();
+  bool modified = false;
+  for (int index = 0; index < field_count; ++index) {
+    const FieldDescriptor* field = descriptor->field(index);
+    const int child = nodes_[node].by_field_index[index];
+    if (child < 0) {
+      if (keep_required_fields && field->is_required()) {
+        if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+            reflection->HasField(*message, field)) {
+          modified = TrimToRequiredFields(
+                         reflection->MutableMessage(message, field)) ||
+                     modified;
+        }
+        continue;
+      }
+      if (field->is_repeated() ? reflection->FieldSize(*message, field) != 0
+                               : reflection->HasField(*message, field)) {
+        modified = true;
+      }
+      reflection->ClearField(message, field);
+      continue;
+    }
+    if (!nodes_[child].leaf && reflection->HasField(*message, field)) {
+      modified = TrimMessage(child, keep_required_fields,
+                             reflection->MutableMessage(message, field)) ||
+                 modified;
+    }
+  }
+  return modified;
+}
+
+CompiledFieldMask CompiledFieldMask::Intersect(
+    const CompiledFieldMask& other) const {
+  ABSL_CHECK(descriptor_ == other.descriptor_);
+  CompiledFieldMask result(descriptor_);
+  if (!empty() && !other.empty()) result.Intersect(*this, 0, other, 0);
+  return result;
+}
+
+namespace {
+std::vector<std::string> IntersectPaths(const std::vector<std::string>& a,
+                                        const std::vector<std::string>& b) {
+  if (a.empty() || b.empty()) return {};
+  FieldMask a_mask, b_mask, intersection;
+  for (const std::string& path : a) a_mask.add_paths(path);
+  for (const std::string& path : b) b_mask.add_paths(path);
+  FieldMaskUtil::Intersect(a_mask, b_mask, &intersection);
+  return {intersection.paths().begin(), intersection.paths().end()};
+}
+}  // namespace
+
+// Adds the intersection of `a_node` and `b_node`, which are of the same field,
+// and returns its index, or -1 if no path is in both.
+int CompiledFieldMask::Intersect(const CompiledFieldMask& a, int a_node,
+                                 const CompiledFieldMask& b, int b_node) {
+  const Node& a_source = a.nodes_[a_node];
+  const Node& b_source = b.nodes_[b_node];
+  // A field in the mask as a whole covers all the paths below it.
+  if (a_source.leaf && !a_source.invalid_sub_paths) {
+    return CopySubtree(b, b_node);
+  }
+  if (b_source.leaf && !b_source.invalid_sub_paths) {
+    return CopySubtree(a, a_node);
+  }
+  const int node = AddNode(a_source.field, a_source.leaf);
+  nodes_[node].invalid_sub_paths = a_source.invalid_sub_paths;
+  nodes_[node].unresolved_paths =
+      IntersectPaths(a_source.unresolved_paths, b_source.unresolved_paths);
+  nodes_[node].by_field_index.assign(a_source.by_field_index.size(), -1);
+  for (int a_child : a_source.children) {
+    const FieldDescriptor* field = a.nodes_[a_child].field;
+    const int b_child = b_source.by_field_index[field->index()];
+    if (b_child < 0) continue;
+    const int child = Intersect(a, a_child, b, b_child);
+    if (child < 0) continue;
+    nodes_[node].children.push_back(child);
+    nodes_[node].by_field_index[field->index()] = child;
+  }
+  if (nodes_[node].children.empty() &&
+      nodes_[node].unresolved_paths.empty()) {
+    // Drop the node, and the nodes added for its children.
+    nodes_.resize(node);
+    return -1;
+  }
+  return node;
+}
+
+int CompiledFieldMask::CopySubtree(const CompiledFieldMask& from,
+                                   int from_node) {
+  const Node& source = from.nodes_[from_node];
+  const int node = AddNode(source.field, source.leaf);
+  nodes_[node].invalid_sub_paths = source.invalid_sub_paths;
+  nodes_[node].unresolved_paths = source.unresolved_paths;
+  nodes_[node].by_field_index.assign(source.by_field_index.size(), -1);
+  for (int from_child : source.children) {
+    const int child = CopySubtree(from, from_child);
+    nodes_[node].children.push_back(child);
+    nodes_[node].by_field_index[from.nodes_[from_child].field->index()] =
+        child;
+  }
+  return node;
+}
+
 }  // namespace util
 }  // namespace protobuf
 }  // namespace google
@@ -158,6 +158,17 @@ class PROTOBUF_EXPORT FieldMaskUtil {
   static bool TrimMessage(const FieldMask& mask, Message* message,
                           const TrimOptions& options);
 
+  // Merges into 'message' only those fields of the serialized 'data' (a
+  // message of the same type) that are represented in the given FieldMask.
+  // Fields outside the mask are skipped on the wire without being decoded.
+  // The result is the same as parsing 'data' and calling TrimMessage(),
+  // except that extensions and unknown fields are dropped as well. If the
+  // FieldMask is empty, all of 'data' is merged.
+  // As with MergePartialFromString(), required fields are not checked.
+  // Returns false if 'data' cannot be parsed.
+  static bool MergeFromString(const FieldMask& mask, absl::string_view data,
+                              Message* message);
+
  private:
   friend class SnakeCaseCamelCaseTest;
   // Converts a field name from snake_case to camelCase:
@@ -233,6 +244,82 @@ class PROTOBUF_EXPORT FieldMaskUtil::TrimOptions {
   bool keep_required_fields_;
 };
 
+// A FieldMask resolved against a message type, for applying the same mask to
+// many messages.  The paths are parsed and their fields looked up once, when
+// the CompiledFieldMask is built; MergeMessageTo(), TrimMessage() and
+// Intersect() then only walk the resolved fields.  They give the same results
+// as the FieldMaskUtil functions of the same name.
+//
+// Paths that don't name a field are handled the way FieldMaskUtil handles them,
+// with an error logged when the mask is compiled.  A compiled mask is
+// immutable, so it can be shared between threads.
+class PROTOBUF_EXPORT CompiledFieldMask {
+ public:
+  // `descriptor` must outlive the compiled mask.
+  CompiledFieldMask(const FieldMask& mask, const Descriptor* descriptor);
+
+  const Descriptor* descriptor() const { return descriptor_; }
+
+  // Whether the mask has no paths, in which case merging copies nothing and
+  // trimming does nothing.
+  bool empty() const { return nodes_.empty(); }
+
+  // Merges the fields in the mask from `source` into `destination`, which must
+  // both be of type descriptor().
+  void MergeMessageTo(const Message& source,
+                      const FieldMaskUtil::MergeOptions& options,
+                      Message* destination) const;
+
+  // Removes from `message` any field that is not in the mask.  Returns true if
+  // the message is modified.
+  bool TrimMessage(Message* message) const;
+  bool TrimMessage(Message* message,
+                   const FieldMaskUtil::TrimOptions& options) const;
+
+  // Returns the mask of the fields that are in both this mask and `other`,
+  // which must be of the same type.
+  CompiledFieldMask Intersect(const CompiledFieldMask& other) const;
+
+ private:
+  struct Node {
+    // Null for the root.
+    const FieldDescriptor* field = nullptr;
+    // Whether the whole field is in the mask, rather than some of its
+    // sub-fields.
+    bool leaf = false;
+    // Set for a field that is not a singular message but has sub-paths in the
+    // mask.  It is skipped when merging and kept whole when trimming.
+    bool invalid_sub_paths = false;
+    // Indices in nodes_ of the sub-fields in the mask, ordered by name.
+    std::vector<int> children;
+    // The index in nodes_ of each field of the message, by field index, or -1
+    // if it is not in the mask.  Empty for leaves.
+    std::vector<int> by_field_index;
+    // The paths in the mask below this node that name no field, relative to
+    // it.  They only matter to Intersect().
+    std::vector<std::string> unresolved_paths;
+  };
+
+  explicit CompiledFieldMask(const Descriptor* descriptor)
+      : descriptor_(descriptor) {}
+
+  int AddNode(const FieldDescriptor* field, bool leaf);
+  template <typename TreeNode>
+  void AddUnresolvedPaths(absl::string_view path, const TreeNode* tree_node,
+                          int node);
+  void MergeMessage(int node, const Message& source,
+                    const FieldMaskUtil::MergeOptions& options,
+                    Message* destination) const;
+  bool TrimMessage(int node, bool keep_required_fields,
+                   Message* message) const;
+  int Intersect(const CompiledFieldMask& a, int a_node,
+                const CompiledFieldMask& b, int b_node);
+  int CopySubtree(const CompiledFieldMask& from, int from_node);
+
+  const Descriptor* descriptor_;
+  std::vector<Node> nodes_;
+};
+
 }  // namespace util
 }  // namespace protobuf
 }  // namespace google
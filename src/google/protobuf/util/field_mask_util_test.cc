@@ -9,10 +9,13 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "google/protobuf/field_mask.pb.h"
 #include <gtest/gtest.h>
+#include "absl/strings/string_view.h"
 #include "google/protobuf/test_util.h"
 #include "google/protobuf/unittest.pb.h"
 
@@ -804,6 +807,169 @@ TEST(FieldMaskUtilTest, TrimMessageReturnValue) {
   // supported.
 }
 
+TEST(FieldMaskUtilTest, MergeFromString) {
+  TestAllTypes source;
+  TestUtil::SetAllFields(&source);
+  source.add_repeated_nested_message()->set_bb(1);
+  const std::string data = source.SerializeAsString();
+
+  for (absl::string_view paths :
+       {"optional_int32", "optional_int32,repeated_string,optional_bytes",
+        "optional_nested_message", "optional_nested_message.bb",
+        "optionalgroup.a",
+        "optional_foreign_message.c,repeated_foreign_message",
+        "oneof_uint32,oneof_string", "default_string,optional_lazy_message"}) {
+    SCOPED_TRACE(paths);
+    FieldMask mask;
+    FieldMaskUtil::FromString(paths, &mask);
+
+    TestAllTypes expected = source;
+    FieldMaskUtil::TrimMessage(mask, &expected);
+
+    TestAllTypes parsed;
+    EXPECT_TRUE(FieldMaskUtil::MergeFromString(mask, data, &parsed));
+    EXPECT_EQ(parsed.DebugString(), expected.DebugString());
+  }
+
+  // An empty mask merges all fields.
+  TestAllTypes parsed;
+  EXPECT_TRUE(FieldMaskUtil::MergeFromString(FieldMask(), data, &parsed));
+  TestUtil::ExpectAllFieldsSet(parsed);
+}
+
+TEST(FieldMaskUtilTest, MergeFromStringNested) {
+  NestedTestAllTypes source;
+  source.mutable_child()->mutable_payload()->set_optional_int32(1);
+  source.mutable_child()->mutable_payload()->set_optional_int64(2);
+  NestedTestAllTypes* grandchild = source.mutable_child()->mutable_child();
+  grandchild->mutable_payload()->set_optional_int32(3);
+  source.mutable_payload()->set_optional_int32(4);
+
+  FieldMask mask;
+  FieldMaskUtil::FromString("child.payload.optional_int32,payload", &mask);
+  NestedTestAllTypes parsed;
+  parsed.mutable_payload()->set_optional_string("kept");
+  EXPECT_TRUE(FieldMaskUtil::MergeFromString(mask, source.SerializeAsString(),
+                                             &parsed));
+
+  NestedTestAllTypes expected;
+  expected.mutable_child()->mutable_payload()->set_optional_int32(1);
+  expected.mutable_payload()->set_optional_int32(4);
+  expected.mutable_payload()->set_optional_string("kept");
+  EXPECT_EQ(parsed.DebugString(), expected.DebugString());
+}
+
+TEST(FieldMaskUtilTest, MergeFromStringMalformed) {
+  FieldMask mask;
+  FieldMaskUtil::FromString("optional_nested_message.bb", &mask);
+  TestAllTypes parsed;
+  // Truncated nested message.
+  EXPECT_FALSE(
+      FieldMaskUtil::MergeFromString(mask, "\x92\x01\x05\x08\x01", &parsed));
+  // Truncated varint in a skipped field.
+  EXPECT_FALSE(FieldMaskUtil::MergeFromString(mask, "\x08\x80", &parsed));
+  // Unmatched end-group tag.
+  EXPECT_FALSE(FieldMaskUtil::MergeFromString(mask, "\x84\x01", &parsed));
+}
+
+TEST(CompiledFieldMaskTest, MergeMessage) {
+  NestedTestAllTypes src, dst;
+  TestUtil::SetAllFields(src.mutable_payload());
+  TestUtil::SetAllFields(src.mutable_child()->mutable_payload());
+  dst.mutable_payload()->set_optional_int32(1);
+  dst.mutable_payload()->add_repeated_int32(2);
+  dst.mutable_child()->mutable_payload()->set_optional_string("dst");
+  FieldMask mask;
+  FieldMaskUtil::FromString(
+      "payload.optional_int32,payload.repeated_int32,"
+      "payload.optional_nested_message.bb,child.payload,unknown_field",
+      &mask);
+  const CompiledFieldMask compiled(mask, NestedTestAllTypes::descriptor());
+  for (bool replace_repeated : {false, true}) {
+    FieldMaskUtil::MergeOptions options;
+    options.set_replace_repeated_fields(replace_repeated);
+    NestedTestAllTypes expected = dst, merged = dst;
+    FieldMaskUtil::MergeMessageTo(src, mask, options, &expected);
+    compiled.MergeMessageTo(src, options, &merged);
+    EXPECT_EQ(expected.DebugString(), merged.DebugString());
+  }
+  // The compiled mask can be applied any number of times.
+  NestedTestAllTypes merged = dst;
+  compiled.MergeMessageTo(src, FieldMaskUtil::MergeOptions(), &merged);
+  compiled.MergeMessageTo(src, FieldMaskUtil::MergeOptions(), &merged);
+  EXPECT_EQ(merged.payload().repeated_int32_size(), 5);
+}
+
+TEST(CompiledFieldMaskTest, TrimMessage) {
+  FieldMask mask;
+  FieldMaskUtil::FromString(
+      "payload.optional_int32,payload.optional_nested_message.bb,"
+      "child.payload.repeated_string,payload.optional_string.invalid",
+      &mask);
+  const CompiledFieldMask compiled(mask, NestedTestAllTypes::descriptor());
+  NestedTestAllTypes expected;
+  TestUtil::SetAllFields(expected.mutable_payload());
+  TestUtil::SetAllFields(expected.mutable_child()->mutable_payload());
+  NestedTestAllTypes trimmed = expected;
+  EXPECT_TRUE(FieldMaskUtil::TrimMessage(mask, &expected));
+  EXPECT_TRUE(compiled.TrimMessage(&trimmed));
+  EXPECT_EQ(expected.DebugString(), trimmed.DebugString());
+  EXPECT_FALSE(compiled.TrimMessage(&trimmed));
+
+  // Required fields outside the mask are trimmed to their own required
+  // fields when keep_required_fields is set.
+  TestRequiredMessage required_msg;
+  for (TestRequired* field : {required_msg.mutable_optional_message(),
+                              required_msg.add_repeated_message(),
+                              required_msg.mutable_required_message()}) {
+    field->set_a(1);
+    field->set_b(2);
+    field->set_c(3);
+    field->set_dummy2(4);
+  }
+  FieldMaskUtil::FromString("optional_message.dummy2", &mask);
+  const CompiledFieldMask compiled_required(mask,
+                                            TestRequiredMessage::descriptor());
+  for (bool keep_required_fields : {false, true}) {
+    FieldMaskUtil::TrimOptions options;
+    options.set_keep_required_fields(keep_required_fields);
+    TestRequiredMessage expected_required = required_msg;
+    TestRequiredMessage trimmed_required = required_msg;
+    FieldMaskUtil::TrimMessage(mask, &expected_required, options);
+    compiled_required.TrimMessage(&trimmed_required, options);
+    EXPECT_EQ(expected_required.DebugString(), trimmed_required.DebugString());
+  }
+}
+
+TEST(CompiledFieldMaskTest, Intersect) {
+  const Descriptor* descriptor = NestedTestAllTypes::descriptor();
+  const std::pair<absl::string_view, absl::string_view> kCases[] = {
+      {"child,payload.optional_int32", "payload,child.child"},
+      {"payload.optional_int32", "payload.optional_string"},
+      {"payload.optional_nested_message.bb,unknown", "unknown,payload"},
+      {"", "payload"},
+  };
+  for (const auto& [paths1, paths2] : kCases) {
+    FieldMask mask1, mask2, intersection;
+    FieldMaskUtil::FromString(paths1, &mask1);
+    FieldMaskUtil::FromString(paths2, &mask2);
+    FieldMaskUtil::Intersect(mask1, mask2, &intersection);
+    const CompiledFieldMask compiled =
+        CompiledFieldMask(mask1, descriptor)
+            .Intersect(CompiledFieldMask(mask2, descriptor));
+    EXPECT_EQ(compiled.empty(), intersection.paths_size() == 0);
+
+    NestedTestAllTypes expected;
+    TestUtil::SetAllFields(expected.mutable_payload());
+    TestUtil::SetAllFields(expected.mutable_child()->mutable_payload());
+    NestedTestAllTypes trimmed = expected;
+    FieldMaskUtil::TrimMessage(intersection, &expected);
+    compiled.TrimMessage(&trimmed);
+    EXPECT_EQ(expected.DebugString(), trimmed.DebugString())
+        << paths1 << " & " << paths2;
+  }
+}
+
 
 }  // namespace
 }  // namespace util
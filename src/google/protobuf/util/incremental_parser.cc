@@ -0,0 +1,210 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/incremental_parser.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "absl/strings/string_view.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/message_lite.h"
+#include "google/protobuf/wire_format_lite.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using internal::WireFormatLite;
+
+constexpr int kMaxVarintBytes = 10;
+// The most bytes a field can take before its size is known: a tag and a
+// length or a varint value.
+constexpr size_t kMaxHeaderSize = 2 * kMaxVarintBytes;
+
+enum class Scan { kComplete, kIncomplete, kMalformed };
+
+// Reads the varint at |data[*pos]|, advancing |*pos| past it.
+Scan ReadVarint(absl::string_view data, size_t* pos, uint64_t* value) {
+  uint64_t result = 0;
+  for (int i = 0; i < kMaxVarintBytes; ++i) {
+    if (*pos == data.size()) return Scan::kIncomplete;
+    const uint8_t byte = static_cast<uint8_t>(data[(*pos)++]);
+    result |= uint64_t{byte & 0x7fu} << (7 * i);
+    if (byte < 0x80) {
+      *value = result;
+      return Scan::kComplete;
+    }
+  }
+  return Scan::kMalformed;
+}
+
+// Skips the |size| bytes at |data[*pos]|, which end the field that starts at
+// |data[start]|.
+Scan SkipBytes(absl::string_view data, size_t* pos, uint64_t size,
+               size_t start, size_t* field_size) {
+  if (size > data.size() - *pos) {
+    *field_size = static_cast<size_t>(*pos - start + size);
+    return Scan::kIncomplete;
+  }
+  *pos += static_cast<size_t>(size);
+  return Scan::kComplete;
+}
+
+// Scans the field at |data[*pos]|, advancing |*pos| past it.  If the field is
+// incomplete, sets |*field_size| to its size when that is known from its
+// header, and |*is_group| if it is a group, whose size is only known at its
+// end.
+Scan ScanField(absl::string_view data, size_t* pos, int depth,
+               size_t* field_size, bool* is_group) {
+  const size_t start = *pos;
+  uint64_t tag;
+  Scan scan = ReadVarint(data, pos, &tag);
+  if (scan != Scan::kComplete) return scan;
+  if (tag > std::numeric_limits<uint32_t>::max() ||
+      WireFormatLite::GetTagFieldNumber(static_cast<uint32_t>(tag)) == 0) {
+    return Scan::kMalformed;
+  }
+  switch (WireFormatLite::GetTagWireType(static_cast<uint32_t>(tag))) {
+    case WireFormatLite::WIRETYPE_VARINT: {
+      uint64_t value;
+      return ReadVarint(data, pos, &value);
+    }
+    case WireFormatLite::WIRETYPE_FIXED64:
+      return SkipBytes(data, pos, 8, start, field_size);
+    case WireFormatLite::WIRETYPE_FIXED32:
+      return SkipBytes(data, pos, 4, start, field_size);
+    case WireFormatLite::WIRETYPE_LENGTH_DELIMITED: {
+      uint64_t length;
+      scan = ReadVarint(data, pos, &length);
+      if (scan != Scan::kComplete) return scan;
+      if (length > std::numeric_limits<int32_t>::max()) return Scan::kMalformed;
+      return SkipBytes(data, pos, length, start, field_size);
+    }
+    case WireFormatLite::WIRETYPE_START_GROUP: {
+      if (depth >= io::CodedInputStream::GetDefaultRecursionLimit()) {
+        return Scan::kMalformed;
+      }
+      *is_group = true;
+      const uint64_t end_tag = WireFormatLite::MakeTag(
+          WireFormatLite::GetTagFieldNumber(static_cast<uint32_t>(tag)),
+          WireFormatLite::WIRETYPE_END_GROUP);
+      while (true) {
+        const size_t field_start = *pos;
+        uint64_t next_tag;
+        scan = ReadVarint(data, pos, &next_tag);
+        if (scan != Scan::kComplete) return scan;
+        if (next_tag == end_tag) return Scan::kComplete;
+        *pos = field_start;
+        size_t nested_size;
+        bool nested_is_group;
+        scan = ScanField(data, pos, depth + 1, &nested_size, &nested_is_group);
+        if (scan != Scan::kComplete) return scan;
+      }
+    }
+    default:
+      // An end group tag without a start, or an invalid wire type.
+      return Scan::kMalformed;
+  }
+}
+
+}  // namespace
+
+IncrementalParser::IncrementalParser(MessageLite* message)
+    : message_(message), has_size_(false) {
+  message_->Clear();
+}
+
+IncrementalParser::IncrementalParser(MessageLite* message, size_t size)
+    : message_(message), has_size_(true), remaining_(size) {
+  message_->Clear();
+}
+
+IncrementalParser::State IncrementalParser::Feed(absl::string_view chunk) {
+  if (state_ != kNeedMore) return Fail();
+  if (has_size_) {
+    if (chunk.size() > remaining_) return Fail();
+    remaining_ -= chunk.size();
+  }
+
+  // Complete the pending field first.  Only as much of |chunk| as it may need
+  // is copied, so that the fields after it are parsed straight from |chunk|.
+  while (!pending_.empty() && !chunk.empty()) {
+    size_t take = chunk.size();
+    if (needed_ == kNeedHeader) {
+      take = std::min(take, kMaxHeaderSize);
+    } else if (needed_ != kNeedAll) {
+      take = std::min(take, needed_ - pending_.size());
+    }
+    pending_.append(chunk.data(), take);
+    chunk.remove_prefix(take);
+    size_t consumed;
+    if (!Consume(pending_, &consumed)) return Fail();
+    pending_.erase(0, consumed);
+  }
+  if (pending_.empty()) {
+    size_t consumed;
+    if (!Consume(chunk, &consumed)) return Fail();
+    pending_.assign(chunk.data() + consumed, chunk.size() - consumed);
+  }
+
+  if (has_size_ && remaining_ == 0) return End();
+  return kNeedMore;
+}
+
+IncrementalParser::State IncrementalParser::Finish() {
+  if (state_ != kNeedMore) return state_;
+  if (has_size_ && remaining_ > 0) return Fail();
+  return End();
+}
+
+bool IncrementalParser::Consume(absl::string_view data, size_t* consumed) {
+  size_t pos = 0;
+  size_t end = 0;
+  while (true) {
+    size_t field_size = 0;
+    bool is_group = false;
+    const Scan scan = ScanField(data, &pos, 0, &field_size, &is_group);
+    if (scan == Scan::kMalformed) return false;
+    if (scan == Scan::kIncomplete) {
+      if (is_group) {
+        needed_ = kNeedAll;
+      } else if (field_size != 0) {
+        needed_ = field_size;
+      } else {
+        needed_ = kNeedHeader;
+      }
+      break;
+    }
+    end = pos;
+  }
+  // Parsing the fields separately merges them as parsing them together would.
+  if (end > 0 && !message_->MergePartialFromString(data.substr(0, end))) {
+    return false;
+  }
+  *consumed = end;
+  return true;
+}
+
+IncrementalParser::State IncrementalParser::Fail() {
+  pending_.clear();
+  state_ = kError;
+  return state_;
+}
+
+IncrementalParser::State IncrementalParser::End() {
+  if (!pending_.empty() || !message_->IsInitialized()) return Fail();
+  state_ = kDone;
+  return state_;
+}
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
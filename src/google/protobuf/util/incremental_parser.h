@@ -0,0 +1,112 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Defines IncrementalParser, which parses a message from chunks of data as
+// they arrive, for servers that read from non-blocking sockets.  Unlike
+// MessageLite::ParseFromZeroCopyStream(), it never waits for data: the caller
+// pushes each chunk with Feed() and learns whether more is needed.
+//
+// Complete top-level fields are parsed as soon as they arrive.  Only the
+// top-level field that straddles the end of the data fed so far is buffered,
+// so the memory held is bounded by the largest top-level field rather than by
+// the whole message.
+//
+// Example:
+//   Request request;
+//   IncrementalParser parser(&request, frame_size);
+//   while (true) {
+//     absl::string_view chunk = socket.ReadSome();
+//     switch (parser.Feed(chunk)) {
+//       case IncrementalParser::kNeedMore: continue;
+//       case IncrementalParser::kDone: return Handle(request);
+//       case IncrementalParser::kError: return Reject();
+//     }
+//   }
+
+#ifndef GOOGLE_PROTOBUF_UTIL_INCREMENTAL_PARSER_H__
+#define GOOGLE_PROTOBUF_UTIL_INCREMENTAL_PARSER_H__
+
+#include <cstddef>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "google/protobuf/message_lite.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+class PROTOBUF_EXPORT IncrementalParser {
+ public:
+  enum State {
+    // The data fed so far is a valid prefix of a message.
+    kNeedMore,
+    // The message is complete and initialized.
+    kDone,
+    // The data is not a valid message, or the message is missing required
+    // fields.  |message| holds whatever was parsed before the error.
+    kError,
+  };
+
+  // Parses into |message|, which is cleared first and must outlive the
+  // parser.  The end of the message is signaled by calling Finish().
+  explicit IncrementalParser(MessageLite* message);
+  // Parses a message of exactly |size| bytes into |message|.  Feed() returns
+  // kDone once all of them have been fed, and kError if fed more.
+  IncrementalParser(MessageLite* message, size_t size);
+  IncrementalParser(const IncrementalParser&) = delete;
+  IncrementalParser& operator=(const IncrementalParser&) = delete;
+
+  // Parses the next |chunk| of data.  Once kError is returned, the parser
+  // stays in that state.  Feeding data after kDone is an error.
+  State Feed(absl::string_view chunk);
+
+  // Signals the end of the data.  Returns kDone if it ends a complete message,
+  // and kError otherwise.
+  State Finish();
+
+  State state() const { return state_; }
+
+ private:
+  // Parses the complete top-level fields at the start of |data| into the
+  // message, and sets |*consumed| to their total size.  Records what is known
+  // about the size of the incomplete field that follows in |needed_|.
+  // Returns false if |data| is not a valid message prefix.
+  bool Consume(absl::string_view data, size_t* consumed);
+
+  State Fail();
+  // Ends the message; |pending_| must be empty for it to be complete.
+  State End();
+
+  // Values of |needed_| that are not sizes.
+  static constexpr size_t kNeedHeader = 0;
+  static constexpr size_t kNeedAll = static_cast<size_t>(-1);
+
+  MessageLite* message_;
+  State state_ = kNeedMore;
+  // The bytes still expected, if the size of the message is known.
+  bool has_size_;
+  size_t remaining_ = 0;
+  // The beginning of the top-level field that straddles the end of the data
+  // fed so far.
+  std::string pending_;
+  // The size of that field, if known; kNeedHeader if its tag or length has not
+  // been fed yet, or kNeedAll if its size is only known by scanning it (for
+  // groups).
+  size_t needed_ = kNeedHeader;
+};
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_UTIL_INCREMENTAL_PARSER_H__
@@ -0,0 +1,119 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/incremental_parser.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "absl/strings/string_view.h"
+#include "google/protobuf/unittest.pb.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using ::proto2_unittest::TestAllTypes;
+using ::proto2_unittest::TestRequired;
+
+TestAllTypes MakeMessage() {
+  TestAllTypes message;
+  message.set_optional_int32(-1);
+  message.set_optional_fixed64(64);
+  message.set_optional_fixed32(32);
+  message.set_optional_string(std::string(300, 'x'));
+  message.mutable_optional_nested_message()->set_bb(7);
+  message.mutable_optionalgroup()->set_a(16);
+  for (int i = 0; i < 10; ++i) {
+    message.add_repeated_int64(int64_t{1} << (6 * i));
+    message.add_repeated_string(std::string(i, 'a' + i));
+  }
+  return message;
+}
+
+TEST(IncrementalParserTest, ParsesAnyChunking) {
+  const TestAllTypes expected = MakeMessage();
+  const std::string data = expected.SerializeAsString();
+  for (size_t chunk_size = 1; chunk_size <= data.size(); ++chunk_size) {
+    TestAllTypes message;
+    message.set_optional_bool(true);
+    IncrementalParser parser(&message);
+    for (size_t i = 0; i < data.size(); i += chunk_size) {
+      ASSERT_EQ(parser.Feed(absl::string_view(data).substr(i, chunk_size)),
+                IncrementalParser::kNeedMore);
+    }
+    ASSERT_EQ(parser.Finish(), IncrementalParser::kDone);
+    EXPECT_EQ(message.SerializeAsString(), data) << chunk_size;
+  }
+}
+
+TEST(IncrementalParserTest, EndsAtKnownSize) {
+  const std::string data = MakeMessage().SerializeAsString();
+  TestAllTypes message;
+  IncrementalParser parser(&message, data.size());
+  const size_t half = data.size() / 2;
+  EXPECT_EQ(parser.Feed(absl::string_view(data).substr(0, half)),
+            IncrementalParser::kNeedMore);
+  EXPECT_EQ(parser.Feed(absl::string_view(data).substr(half)),
+            IncrementalParser::kDone);
+  EXPECT_EQ(message.SerializeAsString(), data);
+  EXPECT_EQ(parser.Finish(), IncrementalParser::kDone);
+  // Nothing may follow.
+  EXPECT_EQ(parser.Feed("x"), IncrementalParser::kError);
+
+  IncrementalParser too_much(&message, half);
+  EXPECT_EQ(too_much.Feed(data), IncrementalParser::kError);
+  IncrementalParser too_little(&message, data.size());
+  EXPECT_EQ(too_little.Feed(absl::string_view(data).substr(0, half)),
+            IncrementalParser::kNeedMore);
+  EXPECT_EQ(too_little.Finish(), IncrementalParser::kError);
+}
+
+TEST(IncrementalParserTest, RejectsInvalidData) {
+  TestAllTypes message;
+  {
+    // Truncated in the middle of a field.
+    const std::string data = MakeMessage().SerializeAsString();
+    IncrementalParser parser(&message);
+    EXPECT_EQ(parser.Feed(absl::string_view(data).substr(0, 10)),
+              IncrementalParser::kNeedMore);
+    EXPECT_EQ(parser.Finish(), IncrementalParser::kError);
+    EXPECT_EQ(parser.Feed("\x08\x01"), IncrementalParser::kError);
+  }
+  {
+    // Field number 0.
+    IncrementalParser parser(&message);
+    EXPECT_EQ(parser.Feed(absl::string_view("\x00\x01", 2)),
+              IncrementalParser::kError);
+  }
+  {
+    // An end group tag without a start, after a complete field.
+    IncrementalParser parser(&message);
+    EXPECT_EQ(parser.Feed("\x08\x01\x0c"), IncrementalParser::kError);
+  }
+  {
+    // A group ended by the wrong tag, split across chunks.
+    IncrementalParser parser(&message);
+    EXPECT_EQ(parser.Feed("\x83\x01\x88\x01"), IncrementalParser::kNeedMore);
+    EXPECT_EQ(parser.Feed("\x10\x8c\x01"), IncrementalParser::kError);
+  }
+  {
+    TestRequired required;
+    IncrementalParser parser(&required);
+    EXPECT_EQ(parser.Feed("\x08\x01"), IncrementalParser::kNeedMore);
+    EXPECT_EQ(parser.Finish(), IncrementalParser::kError);
+    EXPECT_EQ(required.a(), 1);
+  }
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,167 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/incremental_serializer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "absl/types/span.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/descriptor.pb.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/unknown_field_set.h"
+#include "google/protobuf/wire_format.h"
+#include "google/protobuf/wire_format_lite.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+using internal::WireFormat;
+using internal::WireFormatLite;
+
+IncrementalSerializer::IncrementalSerializer(const Message& message) {
+  // Caches the sizes of the nested messages.
+  message.ByteSizeLong();
+  Push(message, 0);
+  Advance();
+}
+
+size_t IncrementalSerializer::SerializeStep(absl::Span<char> buffer) {
+  size_t written = 0;
+  while (written < buffer.size()) {
+    Advance();
+    absl::string_view next;
+    if (buffer_pos_ < buffer_.size()) {
+      next = absl::string_view(buffer_).substr(buffer_pos_);
+    } else if (!contents_.empty()) {
+      next = contents_;
+    } else {
+      break;
+    }
+    const size_t n = std::min(next.size(), buffer.size() - written);
+    memcpy(buffer.data() + written, next.data(), n);
+    written += n;
+    if (buffer_pos_ < buffer_.size()) {
+      buffer_pos_ += n;
+    } else {
+      contents_.remove_prefix(n);
+    }
+  }
+  // Pops the finished frames, so that done() is accurate.
+  Advance();
+  return written;
+}
+
+bool IncrementalSerializer::done() const {
+  return stack_.empty() && buffer_pos_ == buffer_.size() && contents_.empty();
+}
+
+void IncrementalSerializer::Push(const Message& message, uint32_t end_tag) {
+  if (message.GetDescriptor()->options().message_set_wire_format()) {
+    // Message sets encode their extensions as groups of their own; leave that
+    // to the regular serializer.
+    message.AppendPartialToString(&buffer_);
+    if (end_tag != 0) AppendVarint(end_tag);
+    return;
+  }
+  Frame& frame = stack_.emplace_back();
+  frame.message = &message;
+  frame.end_tag = end_tag;
+  message.GetReflection()->ListFields(message, &frame.fields);
+}
+
+void IncrementalSerializer::Advance() {
+  while (buffer_pos_ == buffer_.size() && contents_.empty() &&
+         !stack_.empty()) {
+    buffer_.clear();
+    buffer_pos_ = 0;
+    Frame& frame = stack_.back();
+    const Message& message = *frame.message;
+    const Reflection* reflection = message.GetReflection();
+
+    if (frame.field_index == frame.fields.size()) {
+      // As in generated code, unknown fields come last.
+      const uint32_t end_tag = frame.end_tag;
+      reflection->GetUnknownFields(message).SerializeToString(&buffer_);
+      stack_.pop_back();
+      if (end_tag != 0) AppendVarint(end_tag);
+      continue;
+    }
+
+    const FieldDescriptor* field = frame.fields[frame.field_index];
+    if (field->is_map() || field->is_packed() ||
+        (field->cpp_type() != FieldDescriptor::CPPTYPE_STRING &&
+         field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE)) {
+      // Numbers are small, and packed fields and maps need their size up
+      // front, so these are encoded whole.
+      io::StringOutputStream stream(&buffer_);
+      io::CodedOutputStream output(&stream);
+      WireFormat::SerializeFieldWithCachedSizes(field, message, &output);
+      ++frame.field_index;
+      continue;
+    }
+
+    const int size =
+        field->is_repeated() ? reflection->FieldSize(message, field) : 1;
+    if (frame.element_index == size) {
+      ++frame.field_index;
+      frame.element_index = 0;
+      continue;
+    }
+    const int index = frame.element_index++;
+
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING) {
+      const std::string& value =
+          field->is_repeated() ? reflection->GetRepeatedStringReference(
+                                     message, field, index, &scratch_)
+                               : reflection->GetStringReference(message, field,
+                                                                &scratch_);
+      AppendVarint(WireFormatLite::MakeTag(
+          field->number(), WireFormatLite::WIRETYPE_LENGTH_DELIMITED));
+      AppendVarint(value.size());
+      contents_ = value;
+      continue;
+    }
+
+    const Message& nested =
+        field->is_repeated()
+            ? reflection->GetRepeatedMessage(message, field, index)
+            : reflection->GetMessage(message, field);
+    if (field->type() == FieldDescriptor::TYPE_GROUP) {
+      AppendVarint(WireFormatLite::MakeTag(
+          field->number(), WireFormatLite::WIRETYPE_START_GROUP));
+      Push(nested, WireFormatLite::MakeTag(field->number(),
+                                           WireFormatLite::WIRETYPE_END_GROUP));
+    } else {
+      AppendVarint(WireFormatLite::MakeTag(
+          field->number(), WireFormatLite::WIRETYPE_LENGTH_DELIMITED));
+      // Generated parents do not cache the size of small leaves.
+      AppendVarint(internal::cpp::IsSmallLeafMessage(field->message_type())
+                       ? nested.ByteSizeLong()
+                       : static_cast<size_t>(nested.GetCachedSize()));
+      Push(nested, 0);
+    }
+  }
+}
+
+void IncrementalSerializer::AppendVarint(uint64_t value) {
+  uint8_t bytes[10];
+  const uint8_t* end =
+      io::CodedOutputStream::WriteVarint64ToArray(value, bytes);
+  buffer_.append(reinterpret_cast<const char*>(bytes), end - bytes);
+}
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
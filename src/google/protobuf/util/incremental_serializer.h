@@ -0,0 +1,99 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Defines IncrementalSerializer, which serializes a message in steps, each
+// writing only as many bytes as the caller has room for, for servers that
+// write to non-blocking sockets.  Unlike serialization to a
+// ZeroCopyOutputStream, it never waits for output space: when the socket is
+// full, the caller stops and resumes the serializer once it drains.
+//
+// The serializer walks the message as it goes, writing nested messages and
+// string contents straight from the message.  Other fields are encoded one
+// at a time into a buffer, so the memory held is bounded by the largest of
+// them rather than by the whole message.
+//
+// Example:
+//   IncrementalSerializer serializer(response);
+//   while (!serializer.done()) {
+//     absl::Span<char> space = socket.WritableSpace();
+//     socket.Commit(serializer.SerializeStep(space));
+//     if (!serializer.done()) co_await socket.WaitWritable();
+//   }
+
+#ifndef GOOGLE_PROTOBUF_UTIL_INCREMENTAL_SERIALIZER_H__
+#define GOOGLE_PROTOBUF_UTIL_INCREMENTAL_SERIALIZER_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+class PROTOBUF_EXPORT IncrementalSerializer {
+ public:
+  // Serializes |message|, which must outlive the serializer and not change
+  // until it is done.  The bytes are those SerializePartialToString() writes,
+  // except that map entries may come in a different order.
+  explicit IncrementalSerializer(const Message& message);
+  IncrementalSerializer(const IncrementalSerializer&) = delete;
+  IncrementalSerializer& operator=(const IncrementalSerializer&) = delete;
+
+  // Writes the next bytes of the serialization to |buffer|, and returns how
+  // many were written.  That is fewer than |buffer.size()| only once the
+  // serializer is done.
+  size_t SerializeStep(absl::Span<char> buffer);
+
+  // Whether all of the serialization has been written.
+  bool done() const;
+
+ private:
+  // A message whose fields are being written.
+  struct Frame {
+    const Message* message;
+    // Its set fields, in field number order.
+    std::vector<const FieldDescriptor*> fields;
+    size_t field_index = 0;
+    // The next element of fields[field_index] to write.
+    int element_index = 0;
+    // For groups, the tag that ends it; otherwise 0.
+    uint32_t end_tag = 0;
+  };
+
+  // Pushes the frame for |message|, or encodes it into |buffer_| if its
+  // fields cannot be written one by one.
+  void Push(const Message& message, uint32_t end_tag);
+  // Prepares the next bytes to write, popping finished frames.
+  void Advance();
+  void AppendVarint(uint64_t value);
+
+  std::vector<Frame> stack_;
+  // Encoded bytes waiting to be written, from |buffer_pos_| on.
+  std::string buffer_;
+  size_t buffer_pos_ = 0;
+  // String contents waiting to be written, after |buffer_|.
+  absl::string_view contents_;
+  std::string scratch_;
+};
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_UTIL_INCREMENTAL_SERIALIZER_H__
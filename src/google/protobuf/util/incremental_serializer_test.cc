@@ -0,0 +1,95 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/incremental_serializer.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/types/span.h"
+#include "google/protobuf/map_unittest.pb.h"
+#include "google/protobuf/unittest.pb.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using ::proto2_unittest::TestAllTypes;
+using ::proto2_unittest::TestMap;
+
+std::string SerializeInSteps(const Message& message, size_t step_size) {
+  IncrementalSerializer serializer(message);
+  std::string output;
+  std::vector<char> buffer(step_size);
+  while (!serializer.done()) {
+    const size_t written = serializer.SerializeStep(absl::MakeSpan(buffer));
+    output.append(buffer.data(), written);
+    if (!serializer.done()) {
+      EXPECT_EQ(written, step_size);
+    }
+  }
+  return output;
+}
+
+TEST(IncrementalSerializerTest, MatchesSerializeToString) {
+  TestAllTypes message;
+  message.set_optional_int32(-1);
+  message.set_optional_fixed64(64);
+  message.set_optional_string(std::string(300, 'x'));
+  message.set_optional_bytes("");
+  message.mutable_optional_nested_message()->set_bb(7);
+  message.mutable_optional_foreign_message();
+  message.mutable_optionalgroup()->set_a(16);
+  for (int i = 0; i < 5; ++i) {
+    message.add_repeated_int32(i);
+    message.add_repeated_string(std::string(i, 'a' + i));
+    message.add_repeated_nested_message()->set_bb(i);
+    message.add_repeatedgroup()->set_a(i);
+  }
+  message.set_oneof_string("oneof");
+  message.GetReflection()->MutableUnknownFields(&message)->AddVarint(1000, 1);
+
+  const std::string expected = message.SerializePartialAsString();
+  for (size_t step_size = 1; step_size <= expected.size() + 1; ++step_size) {
+    EXPECT_EQ(SerializeInSteps(message, step_size), expected) << step_size;
+  }
+}
+
+TEST(IncrementalSerializerTest, SerializesMaps) {
+  TestMap message;
+  for (int i = 0; i < 10; ++i) {
+    (*message.mutable_map_int32_int32())[i] = -i;
+    (*message.mutable_map_string_string())[std::string(i, 'k')] = "v";
+    (*message.mutable_map_int32_foreign_message())[i].set_c(i);
+  }
+  TestMap parsed;
+  ASSERT_TRUE(parsed.ParseFromString(SerializeInSteps(message, 7)));
+  ASSERT_EQ(parsed.map_int32_int32_size(), 10);
+  ASSERT_EQ(parsed.map_string_string_size(), 10);
+  ASSERT_EQ(parsed.map_int32_foreign_message_size(), 10);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(parsed.map_int32_int32().at(i), -i);
+    EXPECT_EQ(parsed.map_string_string().at(std::string(i, 'k')), "v");
+    EXPECT_EQ(parsed.map_int32_foreign_message().at(i).c(), i);
+  }
+}
+
+TEST(IncrementalSerializerTest, EmptyMessage) {
+  TestAllTypes message;
+  IncrementalSerializer serializer(message);
+  EXPECT_TRUE(serializer.done());
+  char buffer[4];
+  EXPECT_EQ(serializer.SerializeStep(absl::MakeSpan(buffer)), 0);
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
@@ -21,8 +21,10 @@ using JsonPrintOptions = ::google::protobuf::json::PrintOptions;
 
 using ::google::protobuf::json::BinaryToJsonStream;
 using ::google::protobuf::json::BinaryToJsonString;
+using ::google::protobuf::json::JsonArrayWriter;
 
 using ::google::protobuf::json::JsonStringToMessage;
+using ::google::protobuf::json::JsonStringToMessages;
 using ::google::protobuf::json::JsonToBinaryStream;
 
 using ::google::protobuf::json::JsonToBinaryString;
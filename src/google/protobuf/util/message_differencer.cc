@@ -265,6 +265,14 @@ bool MessageDifferencer::MapEntryKeyComparator::IsMatch(
 
 bool MessageDifferencer::Equals(const Message& message1,
                                 const Message& message2) {
+  switch (FastEquals(message1, message2)) {
+    case FastEqualsResult::kEqual:
+      return true;
+    case FastEqualsResult::kNotEqual:
+      return false;
+    case FastEqualsResult::kUnsupported:
+      break;
+  }
   MessageDifferencer differencer;
 
   return differencer.Compare(message1, message2);
@@ -1172,6 +1180,179 @@ bool MessageDifferencer::CompareMapFieldByMapReflection(
   return true;
 }
 
+MessageDifferencer::FastEqualsResult MessageDifferencer::FastEquals(
+    const Message& message1, const Message& message2) {
+  const Descriptor* descriptor = message1.GetDescriptor();
+  if (descriptor != message2.GetDescriptor() ||
+      descriptor->full_name() == internal::kAnyFullTypeName ||
+      descriptor->options().map_entry() ||
+      descriptor->extension_range_count() > 0) {
+    return FastEqualsResult::kUnsupported;
+  }
+  const Reflection* reflection1 = message1.GetReflection();
+  const Reflection* reflection2 = message2.GetReflection();
+  if (!reflection1->GetUnknownFields(message1).empty() ||
+      !reflection2->GetUnknownFields(message2).empty()) {
+    return FastEqualsResult::kUnsupported;
+  }
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    FastEqualsResult result =
+        FastEqualsField(message1, message2, descriptor->field(i));
+    if (result != FastEqualsResult::kEqual) return result;
+  }
+  return FastEqualsResult::kEqual;
+}
+
+MessageDifferencer::FastEqualsResult MessageDifferencer::FastEqualsField(
+    const Message& message1, const Message& message2,
+    const FieldDescriptor* field) {
+  if (field->is_map()) return FastEqualsMapField(message1, message2, field);
+  const Reflection* reflection1 = message1.GetReflection();
+  const Reflection* reflection2 = message2.GetReflection();
+
+  if (field->is_repeated()) {
+    const int size = reflection1->FieldSize(message1, field);
+    if (size != reflection2->FieldSize(message2, field)) {
+      return FastEqualsResult::kNotEqual;
+    }
+    switch (field->cpp_type()) {
+#define HANDLE_TYPE(CPPTYPE, METHOD)                                  \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE:                            \
+    for (int i = 0; i < size; ++i) {                                  \
+      if (reflection1->GetRepeated##METHOD(message1, field, i) !=     \
+          reflection2->GetRepeated##METHOD(message2, field, i)) {     \
+        return FastEqualsResult::kNotEqual;                           \
+      }                                                               \
+    }                                                                 \
+    return FastEqualsResult::kEqual;
+      HANDLE_TYPE(INT32, Int32);
+      HANDLE_TYPE(INT64, Int64);
+      HANDLE_TYPE(UINT32, UInt32);
+      HANDLE_TYPE(UINT64, UInt64);
+      HANDLE_TYPE(DOUBLE, Double);
+      HANDLE_TYPE(FLOAT, Float);
+      HANDLE_TYPE(BOOL, Bool);
+      HANDLE_TYPE(ENUM, EnumValue);
+#undef HANDLE_TYPE
+      case FieldDescriptor::CPPTYPE_STRING: {
+        std::string scratch1;
+        std::string scratch2;
+        for (int i = 0; i < size; ++i) {
+          if (reflection1->GetRepeatedStringReference(message1, field, i,
+                                                      &scratch1) !=
+              reflection2->GetRepeatedStringReference(message2, field, i,
+                                                      &scratch2)) {
+            return FastEqualsResult::kNotEqual;
+          }
+        }
+        return FastEqualsResult::kEqual;
+      }
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        for (int i = 0; i < size; ++i) {
+          FastEqualsResult result =
+              FastEquals(reflection1->GetRepeatedMessage(message1, field, i),
+                         reflection2->GetRepeatedMessage(message2, field, i));
+          if (result != FastEqualsResult::kEqual) return result;
+        }
+        return FastEqualsResult::kEqual;
+    }
+    return FastEqualsResult::kUnsupported;
+  }
+
+  // Like ListFields(), which Compare() uses, HasField() treats a field
+  // without presence as set if it is not zero.
+  const bool has_field = reflection1->HasField(message1, field);
+  if (has_field != reflection2->HasField(message2, field)) {
+    return FastEqualsResult::kNotEqual;
+  }
+  if (!has_field) return FastEqualsResult::kEqual;
+  switch (field->cpp_type()) {
+#define HANDLE_TYPE(CPPTYPE, METHOD)                          \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE:                    \
+    return reflection1->Get##METHOD(message1, field) ==       \
+                   reflection2->Get##METHOD(message2, field)  \
+               ? FastEqualsResult::kEqual                     \
+               : FastEqualsResult::kNotEqual;
+    HANDLE_TYPE(INT32, Int32);
+    HANDLE_TYPE(INT64, Int64);
+    HANDLE_TYPE(UINT32, UInt32);
+    HANDLE_TYPE(UINT64, UInt64);
+    HANDLE_TYPE(DOUBLE, Double);
+    HANDLE_TYPE(FLOAT, Float);
+    HANDLE_TYPE(BOOL, Bool);
+    HANDLE_TYPE(ENUM, EnumValue);
+#undef HANDLE_TYPE
+    case FieldDescriptor::CPPTYPE_STRING: {
+      std::string scratch1;
+      std::string scratch2;
+      return reflection1->GetStringReference(message1, field, &scratch1) ==
+                     reflection2->GetStringReference(message2, field,
+                                                     &scratch2)
+                 ? FastEqualsResult::kEqual
+                 : FastEqualsResult::kNotEqual;
+    }
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      return FastEquals(reflection1->GetMessage(message1, field),
+                        reflection2->GetMessage(message2, field));
+  }
+  return FastEqualsResult::kUnsupported;
+}
+
+MessageDifferencer::FastEqualsResult MessageDifferencer::FastEqualsMapField(
+    const Message& message1, const Message& message2,
+    const FieldDescriptor* field) {
+  const Reflection* reflection1 = message1.GetReflection();
+  const Reflection* reflection2 = message2.GetReflection();
+  // Compare() matches entries by key only when both maps are in map form;
+  // otherwise it compares the entries in order.
+  if (!reflection1->GetMapData(message1, field)->IsMapValid() ||
+      !reflection2->GetMapData(message2, field)->IsMapValid()) {
+    return FastEqualsResult::kUnsupported;
+  }
+  if (reflection1->MapSize(message1, field) !=
+      reflection2->MapSize(message2, field)) {
+    return FastEqualsResult::kNotEqual;
+  }
+
+  const FieldDescriptor* value_field = field->message_type()->map_value();
+  Message* mutable_message1 = const_cast<Message*>(&message1);
+  for (MapIterator it = reflection1->MapBegin(mutable_message1, field),
+                   it_end = reflection1->MapEnd(mutable_message1, field);
+       it != it_end; ++it) {
+    MapValueConstRef value2;
+    if (!reflection2->LookupMapValue(message2, field, it.GetKey(), &value2)) {
+      return FastEqualsResult::kNotEqual;
+    }
+    const MapValueConstRef& value1 = it.GetValueRef();
+    bool equal = false;
+    switch (value_field->cpp_type()) {
+#define HANDLE_TYPE(CPPTYPE, METHOD)                        \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE:                  \
+    equal = value1.Get##METHOD() == value2.Get##METHOD();   \
+    break;
+      HANDLE_TYPE(INT32, Int32Value);
+      HANDLE_TYPE(INT64, Int64Value);
+      HANDLE_TYPE(UINT32, UInt32Value);
+      HANDLE_TYPE(UINT64, UInt64Value);
+      HANDLE_TYPE(DOUBLE, DoubleValue);
+      HANDLE_TYPE(FLOAT, FloatValue);
+      HANDLE_TYPE(BOOL, BoolValue);
+      HANDLE_TYPE(STRING, StringValue);
+      HANDLE_TYPE(ENUM, EnumValue);
+#undef HANDLE_TYPE
+      case FieldDescriptor::CPPTYPE_MESSAGE: {
+        FastEqualsResult result = FastEquals(value1.GetMessageValue(),
+                                             value2.GetMessageValue());
+        if (result != FastEqualsResult::kEqual) return result;
+        equal = true;
+        break;
+      }
+    }
+    if (!equal) return FastEqualsResult::kNotEqual;
+  }
+  return FastEqualsResult::kEqual;
+}
+
 bool MessageDifferencer::CompareMapField(
     const Message& message1, const Message& message2, int unpacked_any,
     const FieldDescriptor* repeated_field,
@@ -1544,24 +1725,35 @@ bool MessageDifferencer::UnpackAnyField::UnpackAny(
   if (!internal::GetAnyFieldDescriptors(any, &type_url_field, &value_field)) {
     return false;
   }
-  const std::string& type_url = reflection->GetString(any, type_url_field);
+  std::string scratch;
+  const std::string& type_url =
+      reflection->GetStringReference(any, type_url_field, &scratch);
   std::string full_type_name;
   if (!internal::ParseAnyTypeUrl(type_url, &full_type_name)) {
     return false;
   }
 
-  const Descriptor* desc =
-      any.GetDescriptor()->file()->pool()->FindMessageTypeByName(
-          full_type_name);
+  const DescriptorPool* pool = any.GetDescriptor()->file()->pool();
+  const Descriptor* desc = pool->FindMessageTypeByName(full_type_name);
   if (desc == NULL) {
     return false;
   }
 
-  if (dynamic_message_factory_ == NULL) {
-    dynamic_message_factory_.reset(new DynamicMessageFactory());
+  // Prefer the generated type, which parses much faster than a
+  // DynamicMessage.
+  const Message* prototype = nullptr;
+  if (pool == DescriptorPool::generated_pool()) {
+    prototype = MessageFactory::generated_factory()->GetPrototype(desc);
+  }
+  if (prototype == nullptr) {
+    if (dynamic_message_factory_ == NULL) {
+      dynamic_message_factory_.reset(new DynamicMessageFactory());
+    }
+    prototype = dynamic_message_factory_->GetPrototype(desc);
   }
-  data->reset(dynamic_message_factory_->GetPrototype(desc)->New());
-  std::string serialized_value = reflection->GetString(any, value_field);
+  data->reset(prototype->New());
+  const std::string& serialized_value =
+      reflection->GetStringReference(any, value_field, &scratch);
   if (!(*data)->ParsePartialFromString(serialized_value)) {
     ABSL_DLOG(ERROR) << "Failed to parse value for " << full_type_name;
     return false;
@@ -1969,6 +2161,12 @@ bool MessageDifferencer::MatchRepeatedFieldIndices(
     int match_count = matcher.FindMaximumMatch(early_return);
     if (match_count != count1 && early_return) return false;
     success = success && (match_count == count1);
+  } else if (CanMatchRepeatedFieldIndicesByValue(repeated_field,
+                                                 key_comparator)) {
+    success = MatchRepeatedFieldIndicesByValue(
+        message1, message2, repeated_field, reporter == nullptr, match_list1,
+        match_list2);
+    if (!success && reporter == nullptr) return false;
   } else {
     int start_offset = 0;
     // If the two repeated fields are treated as sets, optimize for the case
@@ -2061,6 +2259,129 @@ bool MessageDifferencer::MatchRepeatedFieldIndices(
   return success;
 }
 
+bool MessageDifferencer::CanMatchRepeatedFieldIndicesByValue(
+    const FieldDescriptor* repeated_field,
+    const MapKeyComparator* key_comparator) {
+  if (scope_ != FULL || key_comparator != nullptr ||
+      field_comparator_kind_ != kFCDefault ||
+      !IsTreatedAsSet(repeated_field)) {
+    return false;
+  }
+  switch (repeated_field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+    case FieldDescriptor::CPPTYPE_INT64:
+    case FieldDescriptor::CPPTYPE_UINT32:
+    case FieldDescriptor::CPPTYPE_UINT64:
+    case FieldDescriptor::CPPTYPE_BOOL:
+    case FieldDescriptor::CPPTYPE_ENUM:
+    case FieldDescriptor::CPPTYPE_STRING:
+      return true;
+    default:
+      // Floats may be compared approximately, and messages may match without
+      // being equal.
+      return false;
+  }
+}
+
+namespace {
+
+// Matches each element of the first list with the first unmatched equal
+// element of the second list, which is what the pairwise search in
+// MatchRepeatedFieldIndices finds for sets.  |get1| and |get2| return the
+// elements of the two lists as a T.
+template <typename T, typename Get1, typename Get2>
+bool MatchEqualElements(int count1, int count2, Get1 get1, Get2 get2,
+                        bool stop_on_mismatch, std::vector<int>* match_list1,
+                        std::vector<int>* match_list2) {
+  // For each distinct value, the first and last unmatched indices in the
+  // second list; |next2| chains the indices of equal elements.
+  struct Indices {
+    int first;
+    int last;
+  };
+  absl::flat_hash_map<T, Indices> indices2;
+  indices2.reserve(count2);
+  std::vector<int> next2(count2, -1);
+  for (int j = 0; j < count2; ++j) {
+    auto insert_result = indices2.try_emplace(get2(j), Indices{j, j});
+    if (!insert_result.second) {
+      next2[insert_result.first->second.last] = j;
+      insert_result.first->second.last = j;
+    }
+  }
+
+  bool success = true;
+  for (int i = 0; i < count1; ++i) {
+    auto it = indices2.find(get1(i));
+    if (it == indices2.end() || it->second.first == -1) {
+      if (stop_on_mismatch) return false;
+      success = false;
+      continue;
+    }
+    const int j = it->second.first;
+    it->second.first = next2[j];
+    (*match_list1)[i] = j;
+    (*match_list2)[j] = i;
+  }
+  return success;
+}
+
+}  // namespace
+
+bool MessageDifferencer::MatchRepeatedFieldIndicesByValue(
+    const Message& message1, const Message& message2,
+    const FieldDescriptor* repeated_field, bool stop_on_mismatch,
+    std::vector<int>* match_list1, std::vector<int>* match_list2) {
+  const Reflection* reflection1 = message1.GetReflection();
+  const Reflection* reflection2 = message2.GetReflection();
+  const int count1 = reflection1->FieldSize(message1, repeated_field);
+  const int count2 = reflection2->FieldSize(message2, repeated_field);
+
+  if (repeated_field->cpp_type() == FieldDescriptor::CPPTYPE_STRING) {
+    std::string scratch;
+    return MatchEqualElements<std::string>(
+        count1, count2,
+        [&](int i) -> const std::string& {
+          return reflection1->GetRepeatedStringReference(
+              message1, repeated_field, i, &scratch);
+        },
+        [&](int j) {
+          return reflection2->GetRepeatedString(message2, repeated_field, j);
+        },
+        stop_on_mismatch, match_list1, match_list2);
+  }
+
+  // All the remaining types fit in a uint64_t without collisions.
+  auto get = [repeated_field](const Message& message, int index) -> uint64_t {
+    const Reflection* reflection = message.GetReflection();
+    switch (repeated_field->cpp_type()) {
+      case FieldDescriptor::CPPTYPE_INT32:
+        return static_cast<uint64_t>(
+            reflection->GetRepeatedInt32(message, repeated_field, index));
+      case FieldDescriptor::CPPTYPE_INT64:
+        return static_cast<uint64_t>(
+            reflection->GetRepeatedInt64(message, repeated_field, index));
+      case FieldDescriptor::CPPTYPE_UINT32:
+        return reflection->GetRepeatedUInt32(message, repeated_field, index);
+      case FieldDescriptor::CPPTYPE_UINT64:
+        return reflection->GetRepeatedUInt64(message, repeated_field, index);
+      case FieldDescriptor::CPPTYPE_BOOL:
+        return reflection->GetRepeatedBool(message, repeated_field, index);
+      case FieldDescriptor::CPPTYPE_ENUM:
+        return static_cast<uint64_t>(
+            reflection->GetRepeatedEnumValue(message, repeated_field, index));
+      default:
+        ABSL_LOG(FATAL) << "Unexpected field type: "
+                        << repeated_field->type_name();
+    }
+    return 0;
+  };
+  return MatchEqualElements<uint64_t>(
+      count1, count2, [&](int i) { return get(message1, i); },
+      [&](int j) { return get(message2, j); }, stop_on_mismatch, match_list1,
+      match_list2);
+}
+
 FieldComparator::ComparisonResult MessageDifferencer::GetFieldComparisonResult(
     const Message& message1, const Message& message2,
     const FieldDescriptor* field, int index1, int index2,
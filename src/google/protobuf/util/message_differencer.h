@@ -651,8 +651,9 @@ class PROTOBUF_EXPORT MessageDifferencer {
    public:
     UnpackAnyField() = default;
     ~UnpackAnyField() = default;
-    // If "any" is of type google.protobuf.Any, extract its payload using
-    // DynamicMessageFactory and store in "data".
+    // If "any" is of type google.protobuf.Any, extract its payload into a
+    // generated message if one is linked in, or else one created by
+    // DynamicMessageFactory, and store it in "data".
     bool UnpackAny(const Message& any, std::unique_ptr<Message>* data);
   };
 
@@ -833,6 +834,24 @@ class PROTOBUF_EXPORT MessageDifferencer {
                                       std::vector<SpecificField>* parent_fields,
                                       DefaultFieldComparator* comparator);
 
+  // Result of the FastEquals family of functions.
+  enum class FastEqualsResult { kEqual, kNotEqual, kUnsupported };
+
+  // Compares two messages the way a default-configured MessageDifferencer
+  // does, but walking the fields directly instead of building field lists
+  // and parent field paths.  Returns kUnsupported, as soon as it meets
+  // something it does not handle this way (Any, extensions, unknown fields or
+  // maps not in map form), in which case the caller must fall back to
+  // Compare().  Used by Equals().
+  static FastEqualsResult FastEquals(const Message& message1,
+                                     const Message& message2);
+  static FastEqualsResult FastEqualsField(const Message& message1,
+                                          const Message& message2,
+                                          const FieldDescriptor* field);
+  static FastEqualsResult FastEqualsMapField(const Message& message1,
+                                             const Message& message2,
+                                             const FieldDescriptor* field);
+
   // Shorthand for CompareFieldValueUsingParentFields with NULL parent_fields.
   bool CompareFieldValue(const Message& message1, const Message& message2,
                          int unpacked_any, const FieldDescriptor* field,
@@ -918,6 +937,24 @@ class PROTOBUF_EXPORT MessageDifferencer {
       const std::vector<SpecificField>& parent_fields,
       std::vector<int>* match_list1, std::vector<int>* match_list2);
 
+  // Returns true if the elements of |repeated_field| pair up exactly when
+  // their values are equal, so that MatchRepeatedFieldIndicesByValue() gives
+  // the same matching as MatchRepeatedFieldIndices() does.  That is the case
+  // for integer, bool, enum and string fields treated as a set, compared in
+  // FULL scope with the default field comparator.
+  bool CanMatchRepeatedFieldIndicesByValue(
+      const FieldDescriptor* repeated_field,
+      const MapKeyComparator* key_comparator);
+
+  // Like MatchRepeatedFieldIndices, but looks the elements of message1 up in
+  // a hash table of the elements of message2 instead of comparing every pair,
+  // which takes linear rather than quadratic time.  Stops at the first
+  // element that has no match if |stop_on_mismatch| is true.
+  static bool MatchRepeatedFieldIndicesByValue(
+      const Message& message1, const Message& message2,
+      const FieldDescriptor* repeated_field, bool stop_on_mismatch,
+      std::vector<int>* match_list1, std::vector<int>* match_list2);
+
   // Checks if index is equal to new_index in all the specific fields.
   static bool CheckPathChanged(const std::vector<SpecificField>& parent_fields);
 
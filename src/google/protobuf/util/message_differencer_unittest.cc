@@ -14,6 +14,7 @@
 #include "google/protobuf/util/message_differencer.h"
 
 #include <algorithm>
+#include <limits>
 #include <random>
 #include <string>
 #include <vector>
@@ -194,6 +195,63 @@ TEST(MessageDifferencerTest, MapFieldEqualityTest) {
   EXPECT_FALSE(util::MessageDifferencer::Equals(msg1, msg2));
 }
 
+TEST(MessageDifferencerTest, EqualsAgreesWithCompare) {
+  // Equals() takes a shortcut for default settings; it must give the same
+  // answer as a default-configured differencer.
+  auto expect_same_result = [](const Message& msg1, const Message& msg2) {
+    util::MessageDifferencer differencer;
+    EXPECT_EQ(util::MessageDifferencer::Equals(msg1, msg2),
+              differencer.Compare(msg1, msg2));
+  };
+
+  unittest::TestAllTypes msg1;
+  unittest::TestAllTypes msg2;
+  TestUtil::SetAllFields(&msg1);
+  TestUtil::SetAllFields(&msg2);
+  expect_same_result(msg1, msg2);
+
+  msg1.mutable_optional_nested_message()->set_bb(-1);
+  expect_same_result(msg1, msg2);
+  msg1.mutable_optional_nested_message()->clear_bb();
+  expect_same_result(msg1, msg2);
+  TestUtil::SetAllFields(&msg1);
+
+  msg1.set_repeated_string(1, "x");
+  expect_same_result(msg1, msg2);
+  TestUtil::SetAllFields(&msg1);
+
+  msg1.set_optional_double(0.0);
+  msg2.set_optional_double(-0.0);
+  expect_same_result(msg1, msg2);
+  msg1.set_optional_double(std::numeric_limits<double>::quiet_NaN());
+  msg2.set_optional_double(std::numeric_limits<double>::quiet_NaN());
+  expect_same_result(msg1, msg2);
+  TestUtil::SetAllFields(&msg1);
+  TestUtil::SetAllFields(&msg2);
+
+  // Unknown fields and extensions are left to the full comparison.
+  msg1.mutable_unknown_fields()->AddVarint(123456, 1);
+  expect_same_result(msg1, msg2);
+  msg2.mutable_unknown_fields()->AddVarint(123456, 1);
+  expect_same_result(msg1, msg2);
+  unittest::TestAllExtensions ext1;
+  unittest::TestAllExtensions ext2;
+  TestUtil::SetAllExtensions(&ext1);
+  TestUtil::SetAllExtensions(&ext2);
+  expect_same_result(ext1, ext2);
+  ext1.SetExtension(unittest::optional_int32_extension, -1);
+  expect_same_result(ext1, ext2);
+
+  unittest::TestMap map1;
+  unittest::TestMap map2;
+  MapReflectionTester tester(unittest::TestMap::descriptor());
+  tester.SetMapFieldsViaReflection(&map1);
+  tester.SetMapFieldsViaReflection(&map2);
+  expect_same_result(map1, map2);
+  (*map1.mutable_map_int32_foreign_message())[0].set_c(-1);
+  expect_same_result(map1, map2);
+}
+
 TEST(MessageDifferencerTest, BasicPartialEqualityTest) {
   // Create the testing protos
   unittest::TestAllTypes msg1;
@@ -1793,6 +1851,50 @@ TEST(MessageDifferencerTest, RepeatedFieldSmartSet_NonMessageTypeTest) {
       diff_report);
 }
 
+TEST(MessageDifferencerTest, RepeatedFieldSetTest_LargeScalarSets) {
+  // Scalar sets are matched by hashing their values.
+  proto2_unittest::TestDiffMessage msg1;
+  proto2_unittest::TestDiffMessage msg2;
+  const int kSize = 10000;
+  for (int i = 0; i < kSize; ++i) {
+    msg1.add_rv(i);
+    msg1.add_rw(absl::StrCat("s", i));
+    msg2.add_rv(kSize - 1 - i);
+    msg2.add_rw(absl::StrCat("s", kSize - 1 - i));
+  }
+  util::MessageDifferencer differencer;
+  differencer.set_repeated_field_comparison(util::MessageDifferencer::AS_SET);
+  EXPECT_TRUE(differencer.Compare(msg1, msg2));
+
+  msg2.set_rw(0, "s0");
+  EXPECT_FALSE(differencer.Compare(msg1, msg2));
+  msg2.set_rw(0, absl::StrCat("s", kSize - 1));
+  msg2.set_rv(0, 0);
+  EXPECT_FALSE(differencer.Compare(msg1, msg2));
+}
+
+TEST(MessageDifferencerTest, RepeatedFieldSetTest_ScalarDuplicates) {
+  proto2_unittest::TestDiffMessage msg1;
+  proto2_unittest::TestDiffMessage msg2;
+  msg1.add_rv(1);
+  msg1.add_rv(1);
+  msg1.add_rv(2);
+  msg2.add_rv(1);
+  msg2.add_rv(2);
+  msg2.add_rv(2);
+
+  std::string diff_report;
+  util::MessageDifferencer differencer;
+  differencer.ReportDifferencesToString(&diff_report);
+  differencer.TreatAsSet(GetFieldDescriptor(msg1, "rv"));
+  EXPECT_FALSE(differencer.Compare(msg1, msg2));
+  EXPECT_THAT(diff_report, testing::HasSubstr("deleted: rv[1]: 1\n"));
+  EXPECT_THAT(diff_report, testing::HasSubstr("added: rv[2]: 2\n"));
+
+  msg2.set_rv(2, 1);
+  EXPECT_TRUE(differencer.Compare(msg1, msg2));
+}
+
 TEST(MessageDifferencerTest, RepeatedFieldSetTest_SetOfSet) {
   // Create the testing protos
   proto2_unittest::TestDiffMessage msg1;
@@ -0,0 +1,134 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/message_hash.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "absl/hash/hash.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/any.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/descriptor.pb.h"
+#include "google/protobuf/message.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+size_t HashValue(const Message& message, const FieldDescriptor* field,
+                 int index);
+
+// Equals() compares two Any messages by their unpacked payloads when both can
+// be unpacked into the same type, and by their fields otherwise.  Either way,
+// equal messages name the same type, which is all that is hashed here.
+size_t HashAny(const Message& message) {
+  const FieldDescriptor* type_url_field =
+      message.GetDescriptor()->FindFieldByNumber(1);
+  if (type_url_field == nullptr ||
+      type_url_field->cpp_type() != FieldDescriptor::CPPTYPE_STRING) {
+    return 0;
+  }
+  std::string scratch;
+  absl::string_view type_url = message.GetReflection()->GetStringReference(
+      message, type_url_field, &scratch);
+  std::string full_type_name;
+  if (internal::ParseAnyTypeUrl(type_url, &full_type_name)) {
+    return absl::HashOf(absl::string_view(full_type_name));
+  }
+  return absl::HashOf(type_url);
+}
+
+size_t HashMessage(const Message& message) {
+  const Descriptor* descriptor = message.GetDescriptor();
+  if (descriptor->full_name() == internal::kAnyFullTypeName) {
+    return HashAny(message);
+  }
+  const Reflection* reflection = message.GetReflection();
+
+  if (descriptor->options().map_entry()) {
+    // Equals() considers the fields of map entries always present.
+    size_t hash = 0;
+    for (int i = 0; i < descriptor->field_count(); ++i) {
+      hash = absl::HashOf(hash, HashValue(message, descriptor->field(i), -1));
+    }
+    return hash;
+  }
+
+  std::vector<const FieldDescriptor*> fields;
+  reflection->ListFields(message, &fields);
+  size_t hash = absl::HashOf(fields.size());
+  for (const FieldDescriptor* field : fields) {
+    size_t field_hash;
+    if (!field->is_repeated()) {
+      field_hash = HashValue(message, field, -1);
+    } else if (field->is_map()) {
+      // Sum the hashes of the entries so that their order does not matter.
+      field_hash = 0;
+      const int size = reflection->FieldSize(message, field);
+      for (int i = 0; i < size; ++i) {
+        field_hash +=
+            HashMessage(reflection->GetRepeatedMessage(message, field, i));
+      }
+    } else {
+      field_hash = 0;
+      const int size = reflection->FieldSize(message, field);
+      for (int i = 0; i < size; ++i) {
+        field_hash = absl::HashOf(field_hash, HashValue(message, field, i));
+      }
+    }
+    hash = absl::HashOf(hash, field->number(), field_hash);
+  }
+  return hash;
+}
+
+// Hashes the value of |field|, or its element at |index| if that is not -1.
+size_t HashValue(const Message& message, const FieldDescriptor* field,
+                 int index) {
+  const Reflection* reflection = message.GetReflection();
+  switch (field->cpp_type()) {
+#define HANDLE_TYPE(CPPTYPE, METHOD)                                   \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE:                             \
+    return absl::HashOf(                                               \
+        index < 0 ? reflection->Get##METHOD(message, field)            \
+                  : reflection->GetRepeated##METHOD(message, field, index));
+    HANDLE_TYPE(INT32, Int32);
+    HANDLE_TYPE(INT64, Int64);
+    HANDLE_TYPE(UINT32, UInt32);
+    HANDLE_TYPE(UINT64, UInt64);
+    // absl::Hash hashes 0.0 and -0.0, which compare equal, the same.
+    HANDLE_TYPE(DOUBLE, Double);
+    HANDLE_TYPE(FLOAT, Float);
+    HANDLE_TYPE(BOOL, Bool);
+    HANDLE_TYPE(ENUM, EnumValue);
+#undef HANDLE_TYPE
+    case FieldDescriptor::CPPTYPE_STRING: {
+      std::string scratch;
+      absl::string_view value =
+          index < 0 ? reflection->GetStringReference(message, field, &scratch)
+                    : reflection->GetRepeatedStringReference(message, field,
+                                                             index, &scratch);
+      return absl::HashOf(value);
+    }
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      return HashMessage(
+          index < 0 ? reflection->GetMessage(message, field)
+                    : reflection->GetRepeatedMessage(message, field, index));
+  }
+  return 0;
+}
+
+}  // namespace
+
+size_t MessageHash(const Message& message) { return HashMessage(message); }
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,69 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Defines a structural hash of messages that is consistent with
+// MessageDifferencer::Equals(), and functors that use it to make messages
+// usable as keys of hash containers:
+//
+//   absl::flat_hash_set<MyMessage, util::MessageHasher, util::MessageEquals>
+//       unique_messages;
+//
+// The hash is computed from the fields of the message through reflection,
+// without serializing it.  It is not stable across processes or releases and
+// must not be persisted.
+
+#ifndef GOOGLE_PROTOBUF_UTIL_MESSAGE_HASH_H__
+#define GOOGLE_PROTOBUF_UTIL_MESSAGE_HASH_H__
+
+#include <cstddef>
+
+#include "google/protobuf/message.h"
+#include "google/protobuf/util/message_differencer.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+// Returns a hash of |message| such that messages for which
+// MessageDifferencer::Equals() returns true have the same hash.  Map fields
+// are hashed independently of the order of their entries.  Unknown fields and
+// the payloads of google.protobuf.Any fields, which Equals() compares by
+// their contents rather than their bytes, do not contribute to the hash.
+PROTOBUF_EXPORT size_t MessageHash(const Message& message);
+
+// Hash functor for messages, or pointers to messages, based on MessageHash().
+struct MessageHasher {
+  size_t operator()(const Message& message) const {
+    return MessageHash(message);
+  }
+  size_t operator()(const Message* message) const {
+    return MessageHash(*message);
+  }
+};
+
+// Equality functor matching MessageHasher, based on
+// MessageDifferencer::Equals().  Messages of different types are not equal.
+struct MessageEquals {
+  bool operator()(const Message& message1, const Message& message2) const {
+    return message1.GetDescriptor() == message2.GetDescriptor() &&
+           MessageDifferencer::Equals(message1, message2);
+  }
+  bool operator()(const Message* message1, const Message* message2) const {
+    return (*this)(*message1, *message2);
+  }
+};
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_UTIL_MESSAGE_HASH_H__
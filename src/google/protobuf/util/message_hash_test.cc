@@ -0,0 +1,106 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/message_hash.h"
+
+#include <gtest/gtest.h>
+#include "absl/container/flat_hash_set.h"
+#include "google/protobuf/any_test.pb.h"
+#include "google/protobuf/map_unittest.pb.h"
+#include "google/protobuf/test_util.h"
+#include "google/protobuf/unittest.pb.h"
+#include "google/protobuf/util/message_differencer.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using ::proto2_unittest::TestAllTypes;
+
+TEST(MessageHashTest, EqualMessagesHaveEqualHashes) {
+  TestAllTypes message1;
+  TestAllTypes message2;
+  EXPECT_EQ(MessageHash(message1), MessageHash(message2));
+
+  TestUtil::SetAllFields(&message1);
+  TestUtil::SetAllFields(&message2);
+  EXPECT_EQ(MessageHash(message1), MessageHash(message2));
+
+  message1.set_optional_double(0.0);
+  message2.set_optional_double(-0.0);
+  ASSERT_TRUE(MessageDifferencer::Equals(message1, message2));
+  EXPECT_EQ(MessageHash(message1), MessageHash(message2));
+}
+
+TEST(MessageHashTest, DifferentMessagesHaveDifferentHashes) {
+  TestAllTypes message1;
+  TestAllTypes message2;
+  TestUtil::SetAllFields(&message1);
+  TestUtil::SetAllFields(&message2);
+
+  message2.set_optional_int32(-1);
+  EXPECT_NE(MessageHash(message1), MessageHash(message2));
+  TestUtil::SetAllFields(&message2);
+  message2.mutable_optional_nested_message()->set_bb(-1);
+  EXPECT_NE(MessageHash(message1), MessageHash(message2));
+  TestUtil::SetAllFields(&message2);
+  message2.set_repeated_string(1, "x");
+  EXPECT_NE(MessageHash(message1), MessageHash(message2));
+
+  // A set field and an unset one differ even if the value is the default.
+  message1.Clear();
+  message2.Clear();
+  message2.set_optional_int32(0);
+  EXPECT_NE(MessageHash(message1), MessageHash(message2));
+}
+
+TEST(MessageHashTest, MapOrderDoesNotMatter) {
+  proto2_unittest::TestMap message1;
+  proto2_unittest::TestMap message2;
+  for (int i = 0; i < 100; ++i) {
+    (*message1.mutable_map_int32_int32())[i] = i;
+    (*message1.mutable_map_int32_foreign_message())[i].set_c(i);
+  }
+  for (int i = 99; i >= 0; --i) {
+    (*message2.mutable_map_int32_int32())[i] = i;
+    (*message2.mutable_map_int32_foreign_message())[i].set_c(i);
+  }
+  EXPECT_EQ(MessageHash(message1), MessageHash(message2));
+
+  (*message2.mutable_map_int32_int32())[0] = 1;
+  EXPECT_NE(MessageHash(message1), MessageHash(message2));
+}
+
+TEST(MessageHashTest, AnyIsHashedByType) {
+  TestAllTypes payload;
+  payload.set_optional_int32(1);
+  proto2_unittest::TestAny message1;
+  proto2_unittest::TestAny message2;
+  message1.mutable_any_value()->PackFrom(payload);
+  message2.mutable_any_value()->PackFrom(payload, "example.com");
+  ASSERT_TRUE(MessageDifferencer::Equals(message1, message2));
+  EXPECT_EQ(MessageHash(message1), MessageHash(message2));
+}
+
+TEST(MessageHashTest, HashSetOfMessages) {
+  absl::flat_hash_set<TestAllTypes, MessageHasher, MessageEquals> messages;
+  TestAllTypes message;
+  for (int i = 0; i < 10; ++i) {
+    message.set_optional_int32(i % 5);
+    messages.insert(message);
+  }
+  EXPECT_EQ(messages.size(), 5);
+  EXPECT_TRUE(messages.contains(message));
+  message.set_optional_int32(5);
+  EXPECT_FALSE(messages.contains(message));
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,558 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/message_projector.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/absl_check.h"
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/wire_format_lite.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using internal::WireFormatLite;
+
+// Source fields numbered below this are found through a vector.
+constexpr int kMaxSmallNumber = 1024;
+
+// Whether every value of type |from| can be stored in type |to|.
+bool IsConvertible(FieldDescriptor::CppType from, FieldDescriptor::CppType to) {
+  if (from == to) return true;
+  switch (from) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      return to == FieldDescriptor::CPPTYPE_INT64 ||
+             to == FieldDescriptor::CPPTYPE_DOUBLE ||
+             to == FieldDescriptor::CPPTYPE_ENUM;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      return to == FieldDescriptor::CPPTYPE_INT64 ||
+             to == FieldDescriptor::CPPTYPE_UINT64 ||
+             to == FieldDescriptor::CPPTYPE_DOUBLE;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      return to == FieldDescriptor::CPPTYPE_DOUBLE;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      return to == FieldDescriptor::CPPTYPE_INT32 ||
+             to == FieldDescriptor::CPPTYPE_INT64;
+    default:
+      return false;
+  }
+}
+
+bool IsPlainVarint(FieldDescriptor::Type type) {
+  switch (type) {
+    case FieldDescriptor::TYPE_INT32:
+    case FieldDescriptor::TYPE_INT64:
+    case FieldDescriptor::TYPE_UINT32:
+    case FieldDescriptor::TYPE_UINT64:
+    case FieldDescriptor::TYPE_ENUM:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Whether values converted from type |from| to type |to| are serialized to the
+// same bytes.
+bool HasSameEncoding(FieldDescriptor::Type from, FieldDescriptor::Type to) {
+  if (from == to) return true;
+  // Negative 32-bit values are sign-extended to 64 bits on the wire, so a
+  // varint holds the same number whichever of these types it is read as.
+  if (IsPlainVarint(from) && IsPlainVarint(to)) return true;
+  return (from == FieldDescriptor::TYPE_STRING ||
+          from == FieldDescriptor::TYPE_BYTES) &&
+         (to == FieldDescriptor::TYPE_STRING ||
+          to == FieldDescriptor::TYPE_BYTES);
+}
+
+// A numeric value on its way from one type to another.  Only the members that
+// the source type can fill are meaningful, which covers every conversion
+// IsConvertible() allows.
+struct Scalar {
+  int64_t int_value = 0;
+  uint64_t uint_value = 0;
+  double double_value = 0;
+};
+
+Scalar FromSigned(int64_t value) {
+  Scalar scalar;
+  scalar.int_value = value;
+  scalar.double_value = static_cast<double>(value);
+  return scalar;
+}
+
+Scalar FromUnsigned(uint64_t value) {
+  Scalar scalar;
+  scalar.int_value = static_cast<int64_t>(value);
+  scalar.uint_value = value;
+  scalar.double_value = static_cast<double>(value);
+  return scalar;
+}
+
+Scalar FromDouble(double value) {
+  Scalar scalar;
+  scalar.double_value = value;
+  return scalar;
+}
+
+template <typename CType, WireFormatLite::FieldType kType>
+bool Read(io::CodedInputStream* input, CType* value) {
+  return WireFormatLite::ReadPrimitive<CType, kType>(input, value);
+}
+
+bool ReadScalar(FieldDescriptor::Type type, io::CodedInputStream* input,
+                Scalar* scalar) {
+  bool ok = false;
+  switch (type) {
+#define HANDLE_TYPE(TYPE, CTYPE, FROM)                            \
+  case FieldDescriptor::TYPE_##TYPE: {                            \
+    CTYPE value;                                                  \
+    ok = Read<CTYPE, WireFormatLite::TYPE_##TYPE>(input, &value); \
+    *scalar = FROM(value);                                        \
+    break;                                                        \
+  }
+    HANDLE_TYPE(INT32, int32_t, FromSigned)
+    HANDLE_TYPE(INT64, int64_t, FromSigned)
+    HANDLE_TYPE(SINT32, int32_t, FromSigned)
+    HANDLE_TYPE(SINT64, int64_t, FromSigned)
+    HANDLE_TYPE(SFIXED32, int32_t, FromSigned)
+    HANDLE_TYPE(SFIXED64, int64_t, FromSigned)
+    HANDLE_TYPE(ENUM, int, FromSigned)
+    HANDLE_TYPE(UINT32, uint32_t, FromUnsigned)
+    HANDLE_TYPE(UINT64, uint64_t, FromUnsigned)
+    HANDLE_TYPE(FIXED32, uint32_t, FromUnsigned)
+    HANDLE_TYPE(FIXED64, uint64_t, FromUnsigned)
+    HANDLE_TYPE(BOOL, bool, FromUnsigned)
+    HANDLE_TYPE(FLOAT, float, FromDouble)
+    HANDLE_TYPE(DOUBLE, double, FromDouble)
+#undef HANDLE_TYPE
+    default:
+      ABSL_LOG(FATAL) << "Not a scalar type: " << type;
+  }
+  return ok;
+}
+
+void WriteScalar(FieldDescriptor::Type type, const Scalar& scalar,
+                 io::CodedOutputStream* output) {
+  switch (type) {
+#define HANDLE_TYPE(TYPE, METHOD, VALUE)                 \
+  case FieldDescriptor::TYPE_##TYPE:                     \
+    WireFormatLite::Write##METHOD##NoTag(VALUE, output); \
+    break;
+    HANDLE_TYPE(INT32, Int32, static_cast<int32_t>(scalar.int_value))
+    HANDLE_TYPE(INT64, Int64, scalar.int_value)
+    HANDLE_TYPE(SINT32, SInt32, static_cast<int32_t>(scalar.int_value))
+    HANDLE_TYPE(SINT64, SInt64, scalar.int_value)
+    HANDLE_TYPE(SFIXED32, SFixed32, static_cast<int32_t>(scalar.int_value))
+    HANDLE_TYPE(SFIXED64, SFixed64, scalar.int_value)
+    HANDLE_TYPE(ENUM, Enum, static_cast<int>(scalar.int_value))
+    HANDLE_TYPE(UINT32, UInt32, static_cast<uint32_t>(scalar.uint_value))
+    HANDLE_TYPE(UINT64, UInt64, scalar.uint_value)
+    HANDLE_TYPE(FIXED32, Fixed32, static_cast<uint32_t>(scalar.uint_value))
+    HANDLE_TYPE(FIXED64, Fixed64, scalar.uint_value)
+    HANDLE_TYPE(BOOL, Bool, scalar.uint_value != 0)
+    HANDLE_TYPE(FLOAT, Float, static_cast<float>(scalar.double_value))
+    HANDLE_TYPE(DOUBLE, Double, scalar.double_value)
+#undef HANDLE_TYPE
+    default:
+      ABSL_LOG(FATAL) << "Not a scalar type: " << type;
+  }
+}
+
+// Copies the value of singular field |from_field|, or element |index| of
+// repeated field |from_field|, to |to_field|.
+void CopyValue(const Message& from, const FieldDescriptor* from_field,
+               int index, Message* to, const FieldDescriptor* to_field) {
+  const Reflection* from_reflection = from.GetReflection();
+  const Reflection* to_reflection = to->GetReflection();
+  const bool repeated = from_field->is_repeated();
+  if (from_field->cpp_type() == FieldDescriptor::CPPTYPE_STRING) {
+    std::string scratch;
+    const std::string& value =
+        repeated ? from_reflection->GetRepeatedStringReference(
+                       from, from_field, index, &scratch)
+                 : from_reflection->GetStringReference(from, from_field,
+                                                       &scratch);
+    if (repeated) {
+      to_reflection->AddString(to, to_field, value);
+    } else {
+      to_reflection->SetString(to, to_field, value);
+    }
+    return;
+  }
+
+  Scalar scalar;
+  switch (from_field->cpp_type()) {
+#define HANDLE_TYPE(CPPTYPE, METHOD, FROM)                                    \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE:                                    \
+    scalar = FROM(repeated ? from_reflection->GetRepeated##METHOD(            \
+                                 from, from_field, index)                     \
+                           : from_reflection->Get##METHOD(from, from_field)); \
+    break;
+    HANDLE_TYPE(INT32, Int32, FromSigned)
+    HANDLE_TYPE(INT64, Int64, FromSigned)
+    HANDLE_TYPE(UINT32, UInt32, FromUnsigned)
+    HANDLE_TYPE(UINT64, UInt64, FromUnsigned)
+    HANDLE_TYPE(BOOL, Bool, FromUnsigned)
+    HANDLE_TYPE(FLOAT, Float, FromDouble)
+    HANDLE_TYPE(DOUBLE, Double, FromDouble)
+    HANDLE_TYPE(ENUM, EnumValue, FromSigned)
+#undef HANDLE_TYPE
+    default:
+      ABSL_LOG(FATAL) << "Not a scalar field: " << from_field->full_name();
+  }
+
+  switch (to_field->cpp_type()) {
+#define HANDLE_TYPE(CPPTYPE, METHOD, VALUE)            \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE:             \
+    if (repeated) {                                    \
+      to_reflection->Add##METHOD(to, to_field, VALUE); \
+    } else {                                           \
+      to_reflection->Set##METHOD(to, to_field, VALUE); \
+    }                                                  \
+    break;
+    HANDLE_TYPE(INT32, Int32, static_cast<int32_t>(scalar.int_value))
+    HANDLE_TYPE(INT64, Int64, scalar.int_value)
+    HANDLE_TYPE(UINT32, UInt32, static_cast<uint32_t>(scalar.uint_value))
+    HANDLE_TYPE(UINT64, UInt64, scalar.uint_value)
+    HANDLE_TYPE(BOOL, Bool, scalar.uint_value != 0)
+    HANDLE_TYPE(FLOAT, Float, static_cast<float>(scalar.double_value))
+    HANDLE_TYPE(DOUBLE, Double, scalar.double_value)
+    HANDLE_TYPE(ENUM, EnumValue, static_cast<int>(scalar.int_value))
+#undef HANDLE_TYPE
+    default:
+      ABSL_LOG(FATAL) << "Not a scalar field: " << to_field->full_name();
+  }
+}
+
+void WriteLengthDelimited(int number, absl::string_view data,
+                          io::CodedOutputStream* output) {
+  output->WriteTag(WireFormatLite::MakeTag(
+      number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED));
+  output->WriteVarint32(static_cast<uint32_t>(data.size()));
+  output->WriteRaw(data.data(), static_cast<int>(data.size()));
+}
+
+}  // namespace
+
+absl::StatusOr<MessageProjector> MessageProjector::Create(
+    const Descriptor* from, const Descriptor* to) {
+  return Create(from, to, Options());
+}
+
+absl::StatusOr<MessageProjector> MessageProjector::Create(
+    const Descriptor* from, const Descriptor* to, const Options& options) {
+  ABSL_CHECK(from != nullptr);
+  ABSL_CHECK(to != nullptr);
+  MessageProjector projector;
+  // Message fields can nest the same pair of types again, so each pair gets
+  // one plan that all of its uses share.
+  absl::flat_hash_map<std::pair<const Descriptor*, const Descriptor*>, int>
+      plan_indices;
+  plan_indices[{from, to}] = 0;
+  projector.plans_.push_back(MessagePlan{from, to, {}, {}, {}});
+
+  for (size_t i = 0; i < projector.plans_.size(); ++i) {
+    const Descriptor* from_type = projector.plans_[i].from;
+    const Descriptor* to_type = projector.plans_[i].to;
+    std::vector<FieldPair> fields;
+    for (int j = 0; j < from_type->field_count(); ++j) {
+      const FieldDescriptor* from_field = from_type->field(j);
+      const FieldDescriptor* to_field =
+          options.match_by == Options::kByNumber
+              ? to_type->FindFieldByNumber(from_field->number())
+              : to_type->FindFieldByName(from_field->name());
+      if (to_field == nullptr) continue;
+      if (from_field->is_repeated() != to_field->is_repeated()) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Fields ", from_field->full_name(), " and ",
+            to_field->full_name(), " are not both repeated or both singular."));
+      }
+      if (!IsConvertible(from_field->cpp_type(), to_field->cpp_type())) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Field ", from_field->full_name(), " of type ",
+            from_field->type_name(), " cannot be projected to ",
+            to_field->full_name(), " of type ", to_field->type_name(), "."));
+      }
+      int message = -1;
+      if (from_field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+        auto inserted = plan_indices.try_emplace(
+            {from_field->message_type(), to_field->message_type()},
+            static_cast<int>(projector.plans_.size()));
+        if (inserted.second) {
+          projector.plans_.push_back(MessagePlan{from_field->message_type(),
+                                                 to_field->message_type(),
+                                                 {},
+                                                 {},
+                                                 {}});
+        }
+        message = inserted.first->second;
+      }
+      fields.push_back(
+          {from_field, to_field, message,
+           HasSameEncoding(from_field->type(), to_field->type())});
+    }
+
+    MessagePlan& plan = projector.plans_[i];
+    for (size_t j = 0; j < fields.size(); ++j) {
+      const int number = fields[j].from->number();
+      if (number < kMaxSmallNumber) {
+        if (number >= static_cast<int>(plan.small_numbers.size())) {
+          plan.small_numbers.resize(number + 1, -1);
+        }
+        plan.small_numbers[number] = static_cast<int>(j);
+      } else {
+        plan.large_numbers[number] = static_cast<int>(j);
+      }
+    }
+    plan.fields = std::move(fields);
+  }
+  return projector;
+}
+
+const MessageProjector::FieldPair* MessageProjector::MessagePlan::FindByNumber(
+    int number) const {
+  if (number < static_cast<int>(small_numbers.size())) {
+    const int index = small_numbers[number];
+    return index < 0 ? nullptr : &fields[index];
+  }
+  auto it = large_numbers.find(number);
+  return it == large_numbers.end() ? nullptr : &fields[it->second];
+}
+
+void MessageProjector::Project(const Message& from, Message* to) const {
+  ABSL_DCHECK_EQ(from.GetDescriptor(), from_type());
+  ABSL_DCHECK_EQ(to->GetDescriptor(), to_type());
+  to->Clear();
+  Merge(plans_[0], from, to);
+}
+
+void MessageProjector::Merge(const MessagePlan& plan, const Message& from,
+                             Message* to) const {
+  const Reflection* from_reflection = from.GetReflection();
+  const Reflection* to_reflection = to->GetReflection();
+  for (const FieldPair& field : plan.fields) {
+    if (field.from->is_repeated()) {
+      const int size = from_reflection->FieldSize(from, field.from);
+      for (int i = 0; i < size; ++i) {
+        if (field.message >= 0) {
+          Merge(plans_[field.message],
+                from_reflection->GetRepeatedMessage(from, field.from, i),
+                to_reflection->AddMessage(to, field.to));
+        } else {
+          CopyValue(from, field.from, i, to, field.to);
+        }
+      }
+    } else if (from_reflection->HasField(from, field.from)) {
+      if (field.message >= 0) {
+        Merge(plans_[field.message],
+              from_reflection->GetMessage(from, field.from),
+              to_reflection->MutableMessage(to, field.to));
+      } else {
+        CopyValue(from, field.from, -1, to, field.to);
+      }
+    }
+  }
+}
+
+bool MessageProjector::ProjectSerialized(absl::string_view from,
+                                         std::string* to) const {
+  to->clear();
+  if (from.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    return false;
+  }
+  io::CodedInputStream input(reinterpret_cast<const uint8_t*>(from.data()),
+                             static_cast<int>(from.size()));
+  io::StringOutputStream output_stream(to);
+  io::CodedOutputStream output(&output_stream);
+  return ProjectFields(plans_[0], &input, &output, /*end_group=*/0);
+}
+
+bool MessageProjector::ProjectFields(const MessagePlan& plan,
+                                     io::CodedInputStream* input,
+                                     io::CodedOutputStream* output,
+                                     int end_group) const {
+  while (true) {
+    const uint32_t tag = input->ReadTag();
+    if (tag == 0) return end_group == 0 && input->ConsumedEntireMessage();
+    const int number = WireFormatLite::GetTagFieldNumber(tag);
+    if (WireFormatLite::GetTagWireType(tag) ==
+        WireFormatLite::WIRETYPE_END_GROUP) {
+      return number == end_group;
+    }
+    const FieldPair* field = plan.FindByNumber(number);
+    if (field == nullptr) {
+      if (!WireFormatLite::SkipField(input, tag)) return false;
+    } else if (!ProjectField(*field, tag, input, output)) {
+      return false;
+    }
+  }
+}
+
+bool MessageProjector::ProjectField(const FieldPair& field, uint32_t tag,
+                                    io::CodedInputStream* input,
+                                    io::CodedOutputStream* output) const {
+  if (field.message >= 0) {
+    return ProjectMessageField(field, tag, input, output);
+  }
+  const WireFormatLite::WireType wire_type =
+      WireFormatLite::GetTagWireType(tag);
+  const WireFormatLite::WireType from_wire_type =
+      WireFormatLite::WireTypeForFieldType(
+          static_cast<WireFormatLite::FieldType>(field.from->type()));
+  const WireFormatLite::WireType to_wire_type =
+      WireFormatLite::WireTypeForFieldType(
+          static_cast<WireFormatLite::FieldType>(field.to->type()));
+  const int to_number = field.to->number();
+
+  if (wire_type == from_wire_type) {
+    if (!field.same_encoding) {
+      Scalar scalar;
+      if (!ReadScalar(field.from->type(), input, &scalar)) return false;
+      output->WriteTag(WireFormatLite::MakeTag(to_number, to_wire_type));
+      WriteScalar(field.to->type(), scalar, output);
+      return true;
+    }
+    switch (wire_type) {
+      case WireFormatLite::WIRETYPE_VARINT: {
+        uint64_t value;
+        if (!input->ReadVarint64(&value)) return false;
+        output->WriteTag(WireFormatLite::MakeTag(to_number, to_wire_type));
+        output->WriteVarint64(value);
+        return true;
+      }
+      case WireFormatLite::WIRETYPE_FIXED32: {
+        uint32_t value;
+        if (!input->ReadLittleEndian32(&value)) return false;
+        output->WriteTag(WireFormatLite::MakeTag(to_number, to_wire_type));
+        output->WriteLittleEndian32(value);
+        return true;
+      }
+      case WireFormatLite::WIRETYPE_FIXED64: {
+        uint64_t value;
+        if (!input->ReadLittleEndian64(&value)) return false;
+        output->WriteTag(WireFormatLite::MakeTag(to_number, to_wire_type));
+        output->WriteLittleEndian64(value);
+        return true;
+      }
+      case WireFormatLite::WIRETYPE_LENGTH_DELIMITED: {
+        int length;
+        std::string value;
+        if (!input->ReadVarintSizeAsInt(&length) ||
+            !input->ReadString(&value, length)) {
+          return false;
+        }
+        WriteLengthDelimited(to_number, value, output);
+        return true;
+      }
+      default:
+        return false;
+    }
+  }
+
+  if (wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED &&
+      field.from->is_packable()) {
+    // A packed repeated field.  Parsers accept repeated scalars packed or not,
+    // so the result stays packed whether or not |to| is.
+    int length;
+    if (!input->ReadVarintSizeAsInt(&length)) return false;
+    std::string values;
+    if (field.same_encoding) {
+      if (!input->ReadString(&values, length)) return false;
+    } else {
+      io::StringOutputStream values_stream(&values);
+      io::CodedOutputStream values_output(&values_stream);
+      const io::CodedInputStream::Limit limit = input->PushLimit(length);
+      while (input->BytesUntilLimit() > 0) {
+        Scalar scalar;
+        if (!ReadScalar(field.from->type(), input, &scalar)) return false;
+        WriteScalar(field.to->type(), scalar, &values_output);
+      }
+      input->PopLimit(limit);
+    }
+    WriteLengthDelimited(to_number, values, output);
+    return true;
+  }
+
+  // A parser would keep a value of the wrong wire type as an unknown field,
+  // which projections drop.
+  return WireFormatLite::SkipField(input, tag);
+}
+
+bool MessageProjector::ProjectMessageField(
+    const FieldPair& field, uint32_t tag, io::CodedInputStream* input,
+    io::CodedOutputStream* output) const {
+  const MessagePlan& plan = plans_[field.message];
+  const bool from_group = field.from->type() == FieldDescriptor::TYPE_GROUP;
+  const bool to_group = field.to->type() == FieldDescriptor::TYPE_GROUP;
+  if (WireFormatLite::GetTagWireType(tag) !=
+      (from_group ? WireFormatLite::WIRETYPE_START_GROUP
+                  : WireFormatLite::WIRETYPE_LENGTH_DELIMITED)) {
+    return WireFormatLite::SkipField(input, tag);
+  }
+
+  auto project_contents = [&](io::CodedOutputStream* contents_output) {
+    if (from_group) {
+      if (!input->IncrementRecursionDepth()) return false;
+      const bool ok = ProjectFields(plan, input, contents_output,
+                                    field.from->number());
+      input->DecrementRecursionDepth();
+      return ok;
+    }
+    int length;
+    if (!input->ReadVarintSizeAsInt(&length)) return false;
+    const auto limit = input->IncrementRecursionDepthAndPushLimit(length);
+    if (limit.second < 0 ||
+        !ProjectFields(plan, input, contents_output, /*end_group=*/0)) {
+      return false;
+    }
+    return input->DecrementRecursionDepthAndPopLimit(limit.first);
+  };
+
+  const int to_number = field.to->number();
+  if (to_group) {
+    output->WriteTag(WireFormatLite::MakeTag(
+        to_number, WireFormatLite::WIRETYPE_START_GROUP));
+    if (!project_contents(output)) return false;
+    output->WriteTag(WireFormatLite::MakeTag(
+        to_number, WireFormatLite::WIRETYPE_END_GROUP));
+    return true;
+  }
+  // The size of a message comes before it, so it is projected aside first.
+  std::string contents;
+  {
+    io::StringOutputStream contents_stream(&contents);
+    io::CodedOutputStream contents_output(&contents_stream);
+    if (!project_contents(&contents_output)) return false;
+  }
+  WriteLengthDelimited(to_number, contents, output);
+  return true;
+}
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
@@ -0,0 +1,145 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Defines MessageProjector, which copies messages of one type into messages
+// of another type with compatible fields, such as two versions of an API or
+// an internal and an external schema:
+//
+//   absl::StatusOr<util::MessageProjector> projector =
+//       util::MessageProjector::Create(InternalUser::descriptor(),
+//                                      PublicUser::descriptor());
+//   if (!projector.ok()) { ... }
+//   PublicUser user;
+//   projector->Project(internal_user, &user);
+//
+// The fields of the two types are paired up once, when the projector is
+// created, so copying a message does no lookups.  Messages can be projected
+// as objects, through reflection, or in serialized form, in one pass that
+// rewrites the tags of the fields that are kept.
+
+#ifndef GOOGLE_PROTOBUF_UTIL_MESSAGE_PROJECTOR_H__
+#define GOOGLE_PROTOBUF_UTIL_MESSAGE_PROJECTOR_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/message.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+// Copies the fields of messages of one type that have a counterpart in
+// another type.  Fields are paired up by number or by name; a field without a
+// counterpart is dropped, as are unknown fields and extensions.  Paired fields
+// must both be repeated or both be singular, and have the same type or one of
+// these lossless conversions:
+//
+//   int32, uint32 -> int64, double
+//   uint32        -> uint64
+//   float         -> double
+//   int32        <-> enum (by number)
+//   enum          -> int64
+//   string       <-> bytes
+//   enum          -> another enum (by number)
+//   message       -> another message type, projected the same way
+//
+// Groups count as messages, and map fields as repeated messages of their
+// entry types.  A projector is immutable once created and may be used from
+// several threads at once.
+class PROTOBUF_EXPORT MessageProjector {
+ public:
+  struct Options {
+    enum MatchBy {
+      kByNumber,
+      kByName,
+    };
+    // How the fields of the two types are paired up.
+    MatchBy match_by = kByNumber;
+  };
+
+  // Pairs up the fields of |from| and |to|, and those of the message types
+  // nested in them.  Fails if two paired fields are not compatible.
+  static absl::StatusOr<MessageProjector> Create(const Descriptor* from,
+                                                 const Descriptor* to);
+  static absl::StatusOr<MessageProjector> Create(const Descriptor* from,
+                                                 const Descriptor* to,
+                                                 const Options& options);
+
+  MessageProjector(MessageProjector&&) = default;
+  MessageProjector& operator=(MessageProjector&&) = default;
+
+  const Descriptor* from_type() const { return plans_[0].from; }
+  const Descriptor* to_type() const { return plans_[0].to; }
+
+  // Replaces the contents of |to| with the projection of |from|.  |from| and
+  // |to| must be of from_type() and to_type().
+  void Project(const Message& from, Message* to) const;
+
+  // Like Project(), for serialized messages: parses |from| as a from_type()
+  // and sets |to| to a serialized to_type().  Values are only re-encoded
+  // where the two types encode differently.  Returns false if |from| is not
+  // valid; it is not checked for missing required fields.
+  bool ProjectSerialized(absl::string_view from, std::string* to) const;
+
+ private:
+  // One field of the source type and its counterpart.
+  struct FieldPair {
+    const FieldDescriptor* from;
+    const FieldDescriptor* to;
+    // Index in plans_ of the plan for the message types of the fields, or -1.
+    int message;
+    // Whether serialized values can be copied as they are.
+    bool same_encoding;
+  };
+
+  // The pairing of the fields of two message types.
+  struct MessagePlan {
+    const Descriptor* from;
+    const Descriptor* to;
+    std::vector<FieldPair> fields;
+    // Index in |fields| by source field number, for small numbers.
+    std::vector<int> small_numbers;
+    absl::flat_hash_map<int, int> large_numbers;
+
+    const FieldPair* FindByNumber(int number) const;
+  };
+
+  MessageProjector() = default;
+
+  void Merge(const MessagePlan& plan, const Message& from, Message* to) const;
+  // Projects fields from |input| until it ends, or until the end of the group
+  // numbered |end_group| if that is not 0.
+  bool ProjectFields(const MessagePlan& plan, io::CodedInputStream* input,
+                     io::CodedOutputStream* output, int end_group) const;
+  bool ProjectField(const FieldPair& field, uint32_t tag,
+                    io::CodedInputStream* input,
+                    io::CodedOutputStream* output) const;
+  bool ProjectMessageField(const FieldPair& field, uint32_t tag,
+                           io::CodedInputStream* input,
+                           io::CodedOutputStream* output) const;
+
+  // plans_[0] is for the types the projector was created for.
+  std::vector<MessagePlan> plans_;
+};
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_UTIL_MESSAGE_PROJECTOR_H__
@@ -0,0 +1,281 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/message_projector.h"
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "absl/status/statusor.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/descriptor.pb.h"
+#include "google/protobuf/dynamic_message.h"
+#include "google/protobuf/map_test_util.h"
+#include "google/protobuf/map_unittest.pb.h"
+#include "google/protobuf/test_util.h"
+#include "google/protobuf/text_format.h"
+#include "google/protobuf/unittest.pb.h"
+#include "google/protobuf/util/message_differencer.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using ::proto2_unittest::TestAllTypes;
+using ::proto2_unittest::TestMap;
+using ::proto2_unittest::TestPackedTypes;
+using ::proto2_unittest::TestUnpackedTypes;
+
+// Two versions of a message, whose fields differ in type but can be
+// converted, a third whose fields match the first by name only, and a fourth
+// that cannot be projected from the first.
+constexpr char kSchema[] = R"pb(
+  name: "message_projector_test.proto"
+  package: "projector_test"
+  enum_type {
+    name: "Status"
+    value { name: "UNKNOWN" number: 0 }
+    value { name: "ACTIVE" number: 1 }
+  }
+  message_type {
+    name: "From"
+    field { name: "count" number: 1 label: LABEL_OPTIONAL type: TYPE_INT32 }
+    field { name: "ratio" number: 2 label: LABEL_OPTIONAL type: TYPE_FLOAT }
+    field {
+      name: "ids"
+      number: 3
+      label: LABEL_REPEATED
+      type: TYPE_UINT32
+      options { packed: true }
+    }
+    field { name: "name" number: 4 label: LABEL_OPTIONAL type: TYPE_STRING }
+    field {
+      name: "status"
+      number: 5
+      label: LABEL_OPTIONAL
+      type: TYPE_ENUM
+      type_name: ".projector_test.Status"
+    }
+    field { name: "delta" number: 6 label: LABEL_OPTIONAL type: TYPE_SINT32 }
+    field {
+      name: "child"
+      number: 7
+      label: LABEL_OPTIONAL
+      type: TYPE_MESSAGE
+      type_name: ".projector_test.From"
+    }
+    field { name: "secret" number: 8 label: LABEL_OPTIONAL type: TYPE_STRING }
+    field {
+      name: "weights"
+      number: 10
+      label: LABEL_REPEATED
+      type: TYPE_FLOAT
+      options { packed: true }
+    }
+  }
+  message_type {
+    name: "To"
+    field { name: "count" number: 1 label: LABEL_OPTIONAL type: TYPE_INT64 }
+    field { name: "ratio" number: 2 label: LABEL_OPTIONAL type: TYPE_DOUBLE }
+    field { name: "ids" number: 3 label: LABEL_REPEATED type: TYPE_INT64 }
+    field { name: "name" number: 4 label: LABEL_OPTIONAL type: TYPE_BYTES }
+    field { name: "status" number: 5 label: LABEL_OPTIONAL type: TYPE_INT32 }
+    field { name: "delta" number: 6 label: LABEL_OPTIONAL type: TYPE_SINT64 }
+    field {
+      name: "child"
+      number: 7
+      label: LABEL_OPTIONAL
+      type: TYPE_MESSAGE
+      type_name: ".projector_test.To"
+    }
+    field { name: "added" number: 9 label: LABEL_OPTIONAL type: TYPE_INT32 }
+    field { name: "weights" number: 10 label: LABEL_REPEATED type: TYPE_DOUBLE }
+  }
+  message_type {
+    name: "Renumbered"
+    field { name: "name" number: 1 label: LABEL_OPTIONAL type: TYPE_STRING }
+    field { name: "count" number: 2 label: LABEL_OPTIONAL type: TYPE_INT64 }
+  }
+  message_type {
+    name: "SingleId"
+    field { name: "ids" number: 3 label: LABEL_OPTIONAL type: TYPE_UINT32 }
+  }
+)pb";
+
+class MessageProjectorTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    FileDescriptorProto file;
+    ASSERT_TRUE(TextFormat::ParseFromString(kSchema, &file));
+    ASSERT_NE(pool_.BuildFile(file), nullptr);
+    from_type_ = pool_.FindMessageTypeByName("projector_test.From");
+    to_type_ = pool_.FindMessageTypeByName("projector_test.To");
+    renumbered_type_ = pool_.FindMessageTypeByName("projector_test.Renumbered");
+  }
+
+  std::unique_ptr<Message> Parse(const Descriptor* type,
+                                 const std::string& text) {
+    std::unique_ptr<Message> message(factory_.GetPrototype(type)->New());
+    EXPECT_TRUE(TextFormat::ParseFromString(text, message.get()));
+    return message;
+  }
+
+  DescriptorPool pool_;
+  DynamicMessageFactory factory_{&pool_};
+  const Descriptor* from_type_;
+  const Descriptor* to_type_;
+  const Descriptor* renumbered_type_;
+};
+
+constexpr char kFrom[] = R"pb(
+  count: -5
+  ratio: 0.5
+  ids: [ 1, 4000000000 ]
+  name: "alice"
+  status: ACTIVE
+  delta: -7
+  child { count: 3 secret: "x" }
+  secret: "y"
+  weights: [ 1.5, -2.25 ]
+)pb";
+
+constexpr char kTo[] = R"pb(
+  count: -5
+  ratio: 0.5
+  ids: [ 1, 4000000000 ]
+  name: "alice"
+  status: 1
+  delta: -7
+  child { count: 3 }
+  weights: [ 1.5, -2.25 ]
+)pb";
+
+TEST_F(MessageProjectorTest, ConvertsFields) {
+  absl::StatusOr<MessageProjector> projector =
+      MessageProjector::Create(from_type_, to_type_);
+  ASSERT_TRUE(projector.ok()) << projector.status();
+  EXPECT_EQ(projector->from_type(), from_type_);
+  EXPECT_EQ(projector->to_type(), to_type_);
+
+  std::unique_ptr<Message> from = Parse(from_type_, kFrom);
+  std::unique_ptr<Message> expected = Parse(to_type_, kTo);
+  std::unique_ptr<Message> to = Parse(to_type_, "added: 1");
+  projector->Project(*from, to.get());
+  EXPECT_TRUE(MessageDifferencer::Equals(*to, *expected)) << to->DebugString();
+
+  std::string serialized;
+  ASSERT_TRUE(projector->ProjectSerialized(from->SerializeAsString(),
+                                           &serialized));
+  to->Clear();
+  ASSERT_TRUE(to->ParseFromString(serialized));
+  EXPECT_TRUE(MessageDifferencer::Equals(*to, *expected)) << to->DebugString();
+}
+
+TEST_F(MessageProjectorTest, MatchesByName) {
+  MessageProjector::Options options;
+  options.match_by = MessageProjector::Options::kByName;
+  absl::StatusOr<MessageProjector> projector =
+      MessageProjector::Create(from_type_, renumbered_type_, options);
+  ASSERT_TRUE(projector.ok()) << projector.status();
+
+  std::unique_ptr<Message> from = Parse(from_type_, kFrom);
+  std::unique_ptr<Message> expected =
+      Parse(renumbered_type_, R"pb(name: "alice" count: -5)pb");
+  std::unique_ptr<Message> to(factory_.GetPrototype(renumbered_type_)->New());
+  projector->Project(*from, to.get());
+  EXPECT_TRUE(MessageDifferencer::Equals(*to, *expected)) << to->DebugString();
+
+  std::string serialized;
+  ASSERT_TRUE(projector->ProjectSerialized(from->SerializeAsString(),
+                                           &serialized));
+  to->Clear();
+  ASSERT_TRUE(to->ParseFromString(serialized));
+  EXPECT_TRUE(MessageDifferencer::Equals(*to, *expected)) << to->DebugString();
+}
+
+TEST_F(MessageProjectorTest, RejectsIncompatibleFields) {
+  // int64 does not fit in int32.
+  EXPECT_FALSE(MessageProjector::Create(to_type_, from_type_).ok());
+  // Nor does a string.
+  EXPECT_FALSE(MessageProjector::Create(renumbered_type_, from_type_).ok());
+  // Nor do repeated values in a singular field.
+  EXPECT_FALSE(
+      MessageProjector::Create(
+          from_type_, pool_.FindMessageTypeByName("projector_test.SingleId"))
+          .ok());
+}
+
+TEST_F(MessageProjectorTest, RejectsInvalidInput) {
+  absl::StatusOr<MessageProjector> projector =
+      MessageProjector::Create(from_type_, to_type_);
+  ASSERT_TRUE(projector.ok()) << projector.status();
+  std::string data = Parse(from_type_, kFrom)->SerializeAsString();
+  data.resize(data.size() - 1);
+  std::string serialized;
+  EXPECT_FALSE(projector->ProjectSerialized(data, &serialized));
+}
+
+TEST(MessageProjectorGeneratedTest, ProjectsAllTypes) {
+  absl::StatusOr<MessageProjector> projector = MessageProjector::Create(
+      TestAllTypes::descriptor(), TestAllTypes::descriptor());
+  ASSERT_TRUE(projector.ok()) << projector.status();
+  TestAllTypes from;
+  TestUtil::SetAllFields(&from);
+
+  TestAllTypes to;
+  projector->Project(from, &to);
+  TestUtil::ExpectAllFieldsSet(to);
+
+  std::string serialized;
+  ASSERT_TRUE(
+      projector->ProjectSerialized(from.SerializeAsString(), &serialized));
+  ASSERT_TRUE(to.ParseFromString(serialized));
+  TestUtil::ExpectAllFieldsSet(to);
+}
+
+TEST(MessageProjectorGeneratedTest, ProjectsPackedToUnpacked) {
+  absl::StatusOr<MessageProjector> projector = MessageProjector::Create(
+      TestPackedTypes::descriptor(), TestUnpackedTypes::descriptor());
+  ASSERT_TRUE(projector.ok()) << projector.status();
+  TestPackedTypes from;
+  TestUtil::SetPackedFields(&from);
+
+  TestUnpackedTypes to;
+  projector->Project(from, &to);
+  TestUtil::ExpectUnpackedFieldsSet(to);
+
+  std::string serialized;
+  ASSERT_TRUE(
+      projector->ProjectSerialized(from.SerializeAsString(), &serialized));
+  ASSERT_TRUE(to.ParseFromString(serialized));
+  TestUtil::ExpectUnpackedFieldsSet(to);
+}
+
+TEST(MessageProjectorGeneratedTest, ProjectsMaps) {
+  absl::StatusOr<MessageProjector> projector =
+      MessageProjector::Create(TestMap::descriptor(), TestMap::descriptor());
+  ASSERT_TRUE(projector.ok()) << projector.status();
+  TestMap from;
+  MapTestUtil::SetMapFields(&from);
+
+  TestMap to;
+  projector->Project(from, &to);
+  MapTestUtil::ExpectMapFieldsSet(to);
+
+  std::string serialized;
+  ASSERT_TRUE(
+      projector->ProjectSerialized(from.SerializeAsString(), &serialized));
+  ASSERT_TRUE(to.ParseFromString(serialized));
+  MapTestUtil::ExpectMapFieldsSet(to);
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,190 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/packed_delta_codec.h"
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "absl/log/absl_check.h"
+#include "absl/log/absl_log.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/reflection.h"
+#include "google/protobuf/repeated_field.h"
+#include "google/protobuf/wire_format_lite.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using internal::WireFormatLite;
+
+constexpr size_t kMaxVarintBytes = 10;
+
+// |values| is any range of integers with a size(): a span or a
+// RepeatedFieldRef.
+template <typename Range>
+void EncodeValues(const Range& values, std::string* output) {
+  const size_t old_size = output->size();
+  output->resize(old_size + (values.size() + 1) * kMaxVarintBytes);
+  uint8_t* const start = reinterpret_cast<uint8_t*>(&(*output)[old_size]);
+  uint8_t* ptr = io::CodedOutputStream::WriteVarint64ToArray(
+      static_cast<uint64_t>(values.size()), start);
+  uint64_t previous = 0;
+  for (const auto value : values) {
+    // Converting to uint64_t sign-extends signed values, so that differences
+    // between small negative numbers stay small.
+    const uint64_t current = static_cast<uint64_t>(value);
+    const int64_t delta = static_cast<int64_t>(current - previous);
+    ptr = io::CodedOutputStream::WriteVarint64ToArray(
+        WireFormatLite::ZigZagEncode64(delta), ptr);
+    previous = current;
+  }
+  output->resize(old_size + static_cast<size_t>(ptr - start));
+}
+
+template <typename T>
+bool DecodeValues(absl::string_view data, RepeatedField<T>* values) {
+  if (data.size() > INT_MAX) return false;
+  io::CodedInputStream input(reinterpret_cast<const uint8_t*>(data.data()),
+                             static_cast<int>(data.size()));
+  uint64_t count;
+  // Every value takes at least one byte, which bounds the reservation below.
+  if (!input.ReadVarint64(&count) ||
+      count > static_cast<uint64_t>(input.BytesUntilLimit())) {
+    return false;
+  }
+  const int old_size = values->size();
+  values->Reserve(old_size + static_cast<int>(count));
+  uint64_t previous = 0;
+  for (uint64_t i = 0; i < count; ++i) {
+    uint64_t delta;
+    if (!input.ReadVarint64(&delta)) break;
+    const uint64_t current =
+        previous + static_cast<uint64_t>(WireFormatLite::ZigZagDecode64(delta));
+    const T value = static_cast<T>(current);
+    if (static_cast<uint64_t>(value) != current) break;
+    values->AddAlreadyReserved(value);
+    previous = current;
+  }
+  if (values->size() != old_size + static_cast<int>(count) ||
+      input.BytesUntilLimit() != 0) {
+    values->Truncate(old_size);
+    return false;
+  }
+  return true;
+}
+
+template <typename T>
+bool DecodeFieldValues(absl::string_view data, const FieldDescriptor* field,
+                       Message* message) {
+  RepeatedField<T> values;
+  if (!DecodeValues(data, &values)) return false;
+  message->GetReflection()
+      ->GetMutableRepeatedFieldRef<T>(message, field)
+      .MergeFrom(values);
+  return true;
+}
+
+}  // namespace
+
+void PackedDeltaCodec::Encode(absl::Span<const int32_t> values,
+                              std::string* output) {
+  EncodeValues(values, output);
+}
+
+void PackedDeltaCodec::Encode(absl::Span<const int64_t> values,
+                              std::string* output) {
+  EncodeValues(values, output);
+}
+
+void PackedDeltaCodec::Encode(absl::Span<const uint32_t> values,
+                              std::string* output) {
+  EncodeValues(values, output);
+}
+
+void PackedDeltaCodec::Encode(absl::Span<const uint64_t> values,
+                              std::string* output) {
+  EncodeValues(values, output);
+}
+
+bool PackedDeltaCodec::Decode(absl::string_view data,
+                              RepeatedField<int32_t>* values) {
+  return DecodeValues(data, values);
+}
+
+bool PackedDeltaCodec::Decode(absl::string_view data,
+                              RepeatedField<int64_t>* values) {
+  return DecodeValues(data, values);
+}
+
+bool PackedDeltaCodec::Decode(absl::string_view data,
+                              RepeatedField<uint32_t>* values) {
+  return DecodeValues(data, values);
+}
+
+bool PackedDeltaCodec::Decode(absl::string_view data,
+                              RepeatedField<uint64_t>* values) {
+  return DecodeValues(data, values);
+}
+
+void PackedDeltaCodec::EncodeField(const Message& message,
+                                   const FieldDescriptor* field,
+                                   std::string* output) {
+  ABSL_CHECK(field->is_repeated());
+  const Reflection* reflection = message.GetReflection();
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      EncodeValues(reflection->GetRepeatedFieldRef<int32_t>(message, field),
+                   output);
+      break;
+    case FieldDescriptor::CPPTYPE_INT64:
+      EncodeValues(reflection->GetRepeatedFieldRef<int64_t>(message, field),
+                   output);
+      break;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      EncodeValues(reflection->GetRepeatedFieldRef<uint32_t>(message, field),
+                   output);
+      break;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      EncodeValues(reflection->GetRepeatedFieldRef<uint64_t>(message, field),
+                   output);
+      break;
+    default:
+      ABSL_LOG(FATAL) << field->full_name() << " is not an integer field.";
+  }
+}
+
+bool PackedDeltaCodec::DecodeField(absl::string_view data,
+                                   const FieldDescriptor* field,
+                                   Message* message) {
+  ABSL_CHECK(field->is_repeated());
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      return DecodeFieldValues<int32_t>(data, field, message);
+    case FieldDescriptor::CPPTYPE_INT64:
+      return DecodeFieldValues<int64_t>(data, field, message);
+    case FieldDescriptor::CPPTYPE_UINT32:
+      return DecodeFieldValues<uint32_t>(data, field, message);
+    case FieldDescriptor::CPPTYPE_UINT64:
+      return DecodeFieldValues<uint64_t>(data, field, message);
+    default:
+      ABSL_LOG(FATAL) << field->full_name() << " is not an integer field.";
+  }
+  return false;
+}
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
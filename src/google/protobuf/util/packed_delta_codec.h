@@ -0,0 +1,80 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Defines PackedDeltaCodec, a compact representation for repeated integer
+// fields whose values are sorted or clustered, such as lists of IDs.  Instead
+// of each value it stores the zigzag-encoded difference from the previous
+// value as a varint, so a sorted list of 64-bit IDs takes a byte or two per
+// value where the packed wire format takes up to ten.
+//
+// The encoding is not the protobuf wire format.  It is a side representation,
+// e.g. for a bytes field next to the repeated field or for storage outside of
+// the message; messages are still serialized and parsed as usual, and the
+// codec converts at the edges.
+//
+// Example:
+//   std::string ids;
+//   PackedDeltaCodec::EncodeField(
+//       request, Request::descriptor()->FindFieldByName("ids"), &ids);
+//   ...
+//   if (!PackedDeltaCodec::DecodeField(ids, ids_field, &request)) ...
+
+#ifndef GOOGLE_PROTOBUF_UTIL_PACKED_DELTA_CODEC_H__
+#define GOOGLE_PROTOBUF_UTIL_PACKED_DELTA_CODEC_H__
+
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/repeated_field.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+// The encoding is the number of values as a varint, followed by one zigzag
+// varint per value holding its difference from the previous value (from 0 for
+// the first one).  Differences are taken modulo 2^64, so any list round-trips;
+// unsorted lists just encode less compactly.
+class PROTOBUF_EXPORT PackedDeltaCodec {
+ public:
+  // Appends the encoding of |values| to |output|.
+  static void Encode(absl::Span<const int32_t> values, std::string* output);
+  static void Encode(absl::Span<const int64_t> values, std::string* output);
+  static void Encode(absl::Span<const uint32_t> values, std::string* output);
+  static void Encode(absl::Span<const uint64_t> values, std::string* output);
+
+  // Appends the values encoded in |data| to |values|.  Returns false, leaving
+  // |values| unchanged, if |data| is not a valid encoding or holds a value that
+  // does not fit in the element type.
+  static bool Decode(absl::string_view data, RepeatedField<int32_t>* values);
+  static bool Decode(absl::string_view data, RepeatedField<int64_t>* values);
+  static bool Decode(absl::string_view data, RepeatedField<uint32_t>* values);
+  static bool Decode(absl::string_view data, RepeatedField<uint64_t>* values);
+
+  // Like Encode() and Decode(), for the values of a repeated integer |field|
+  // of |message|: any of the int32, int64, uint32, uint64, sint32, sint64,
+  // fixed32, fixed64, sfixed32 and sfixed64 types.
+  static void EncodeField(const Message& message, const FieldDescriptor* field,
+                          std::string* output);
+  static bool DecodeField(absl::string_view data, const FieldDescriptor* field,
+                          Message* message);
+};
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_UTIL_PACKED_DELTA_CODEC_H__
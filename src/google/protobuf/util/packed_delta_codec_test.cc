@@ -0,0 +1,117 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/packed_delta_codec.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "google/protobuf/repeated_field.h"
+#include "google/protobuf/unittest.pb.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using ::proto2_unittest::TestAllTypes;
+using ::proto2_unittest::TestPackedTypes;
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+
+TEST(PackedDeltaCodecTest, RoundTripsSortedIds) {
+  std::vector<int64_t> ids;
+  for (int64_t i = 0; i < 1000; ++i) ids.push_back(int64_t{1} << 40 | i * 7);
+  std::string encoded;
+  PackedDeltaCodec::Encode(ids, &encoded);
+
+  TestPackedTypes packed;
+  for (int64_t id : ids) packed.add_packed_int64(id);
+  // One byte per value after the first, against six for the packed varints.
+  EXPECT_LT(encoded.size(), 1010);
+  EXPECT_GT(packed.ByteSizeLong(), 6000);
+
+  RepeatedField<int64_t> decoded;
+  ASSERT_TRUE(PackedDeltaCodec::Decode(encoded, &decoded));
+  EXPECT_THAT(decoded, ElementsAreArray(ids));
+}
+
+TEST(PackedDeltaCodecTest, RoundTripsExtremeValues) {
+  const std::vector<int32_t> int32s = {std::numeric_limits<int32_t>::max(),
+                                       std::numeric_limits<int32_t>::min(), -1,
+                                       0, 1};
+  const std::vector<uint64_t> uint64s = {
+      std::numeric_limits<uint64_t>::max(), 0,
+      std::numeric_limits<uint64_t>::max() / 2, 1};
+  std::string encoded;
+  PackedDeltaCodec::Encode(int32s, &encoded);
+  RepeatedField<int32_t> decoded_int32s;
+  ASSERT_TRUE(PackedDeltaCodec::Decode(encoded, &decoded_int32s));
+  EXPECT_THAT(decoded_int32s, ElementsAreArray(int32s));
+
+  encoded.clear();
+  PackedDeltaCodec::Encode(uint64s, &encoded);
+  RepeatedField<uint64_t> decoded_uint64s;
+  ASSERT_TRUE(PackedDeltaCodec::Decode(encoded, &decoded_uint64s));
+  EXPECT_THAT(decoded_uint64s, ElementsAreArray(uint64s));
+}
+
+TEST(PackedDeltaCodecTest, RejectsBadInput) {
+  RepeatedField<uint32_t> values;
+  values.Add(5);
+  // Truncated, trailing bytes, and a count larger than the data.
+  EXPECT_FALSE(PackedDeltaCodec::Decode(std::string("\x01\x80", 2), &values));
+  EXPECT_FALSE(
+      PackedDeltaCodec::Decode(std::string("\x01\x02\x02", 3), &values));
+  EXPECT_FALSE(PackedDeltaCodec::Decode(std::string("\x7f\x02", 2), &values));
+  // A value that does not fit the element type.
+  std::string encoded;
+  PackedDeltaCodec::Encode(std::vector<int64_t>{int64_t{1} << 32}, &encoded);
+  EXPECT_FALSE(PackedDeltaCodec::Decode(encoded, &values));
+  encoded.clear();
+  PackedDeltaCodec::Encode(std::vector<int64_t>{-1}, &encoded);
+  EXPECT_FALSE(PackedDeltaCodec::Decode(encoded, &values));
+  EXPECT_THAT(values, ElementsAre(5));
+
+  // An empty list is valid, but empty input is not.
+  encoded.clear();
+  PackedDeltaCodec::Encode(std::vector<uint32_t>{}, &encoded);
+  EXPECT_TRUE(PackedDeltaCodec::Decode(encoded, &values));
+  EXPECT_FALSE(PackedDeltaCodec::Decode("", &values));
+  EXPECT_THAT(values, ElementsAre(5));
+}
+
+TEST(PackedDeltaCodecTest, EncodesAndDecodesFields) {
+  TestAllTypes message;
+  message.add_repeated_sint32(-3);
+  message.add_repeated_sint32(-2);
+  message.add_repeated_fixed64(100);
+  message.add_repeated_fixed64(200);
+  const FieldDescriptor* sint32_field =
+      TestAllTypes::descriptor()->FindFieldByName("repeated_sint32");
+  const FieldDescriptor* fixed64_field =
+      TestAllTypes::descriptor()->FindFieldByName("repeated_fixed64");
+  std::string sint32s, fixed64s;
+  PackedDeltaCodec::EncodeField(message, sint32_field, &sint32s);
+  PackedDeltaCodec::EncodeField(message, fixed64_field, &fixed64s);
+
+  TestAllTypes decoded;
+  decoded.add_repeated_sint32(7);
+  ASSERT_TRUE(PackedDeltaCodec::DecodeField(sint32s, sint32_field, &decoded));
+  ASSERT_TRUE(PackedDeltaCodec::DecodeField(fixed64s, fixed64_field, &decoded));
+  EXPECT_THAT(decoded.repeated_sint32(), ElementsAre(7, -3, -2));
+  EXPECT_THAT(decoded.repeated_fixed64(), ElementsAre(100, 200));
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
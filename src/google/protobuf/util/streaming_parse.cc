@@ -0,0 +1,91 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/streaming_parse.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "absl/functional/function_ref.h"
+#include "absl/types/optional.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/message_lite.h"
+#include "google/protobuf/wire_format_lite.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using internal::WireFormatLite;
+
+// CodedInputStream counts the bytes it has read in an int, so a new one is
+// started once this many have been read.
+constexpr int kMaxBytesPerCodedStream = 64 << 20;
+
+}  // namespace
+
+bool ParseRepeatedFieldStreaming(
+    io::ZeroCopyInputStream* input, int field_number, MessageLite* element,
+    MessageLite* rest, absl::FunctionRef<bool(MessageLite&)> callback) {
+  // The other fields are copied here as they are, and parsed at the end.
+  std::string rest_data;
+  {
+    io::StringOutputStream rest_stream(&rest_data);
+    io::CodedOutputStream rest_output(&rest_stream);
+    absl::optional<io::CodedInputStream> coded;
+    while (true) {
+      if (!coded.has_value() ||
+          coded->CurrentPosition() >= kMaxBytesPerCodedStream) {
+        // Destroying the old stream returns its unread bytes to |input|.
+        coded.reset();
+        coded.emplace(input);
+        coded->SetTotalBytesLimit(std::numeric_limits<int>::max());
+      }
+      const uint32_t tag = coded->ReadTag();
+      if (tag == 0) {
+        if (!coded->ConsumedEntireMessage()) return false;
+        break;
+      }
+      if (WireFormatLite::GetTagFieldNumber(tag) == field_number) {
+        bool parsed;
+        switch (WireFormatLite::GetTagWireType(tag)) {
+          case WireFormatLite::WIRETYPE_LENGTH_DELIMITED:
+            element->Clear();
+            parsed = WireFormatLite::ReadMessage(&*coded, element);
+            break;
+          case WireFormatLite::WIRETYPE_START_GROUP:
+            element->Clear();
+            parsed = WireFormatLite::ReadGroup(field_number, &*coded, element);
+            break;
+          default:
+            // Generated parsers keep fields of the wrong wire type as unknown
+            // fields.
+            if (!WireFormatLite::SkipField(&*coded, tag, &rest_output)) {
+              return false;
+            }
+            continue;
+        }
+        if (!parsed || !element->IsInitialized() || !callback(*element)) {
+          return false;
+        }
+        continue;
+      }
+      if (!WireFormatLite::SkipField(&*coded, tag, &rest_output)) {
+        return false;
+      }
+    }
+  }
+  return rest->ParseFromString(rest_data);
+}
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,66 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Defines ParseRepeatedFieldStreaming(), which parses a message whose bulk is
+// one repeated message field, such as
+//
+//   message Dump {
+//     repeated Row rows = 1;
+//   }
+//
+// without holding the elements of that field in memory: each one is parsed
+// into a reused message and handed to a callback.  The memory held is bounded
+// by the largest element and the other fields, regardless of the input size.
+//
+// Example:
+//   Dump header;
+//   bool ok = ParseRepeatedFieldStreaming<Row>(
+//       &input, Dump::kRowsFieldNumber, &header,
+//       [&](Row& row) { return Process(row); });
+
+#ifndef GOOGLE_PROTOBUF_UTIL_STREAMING_PARSE_H__
+#define GOOGLE_PROTOBUF_UTIL_STREAMING_PARSE_H__
+
+#include "absl/functional/function_ref.h"
+#include "google/protobuf/io/zero_copy_stream.h"
+#include "google/protobuf/message_lite.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+// Parses the message that makes up the rest of |input|.  Each element of the
+// repeated message field numbered |field_number| is parsed into |element|,
+// which is cleared first, and handed to |callback|; all other fields are
+// parsed into |rest|, which is cleared first, once the input ends.  Returns
+// false if the input is malformed, if an element or |rest| is missing
+// required fields, or as soon as |callback| returns false.
+PROTOBUF_EXPORT bool ParseRepeatedFieldStreaming(
+    io::ZeroCopyInputStream* input, int field_number, MessageLite* element,
+    MessageLite* rest, absl::FunctionRef<bool(MessageLite&)> callback);
+
+// As above, parsing each element into a reused message of type |Element|.
+template <typename Element>
+bool ParseRepeatedFieldStreaming(io::ZeroCopyInputStream* input,
+                                 int field_number, MessageLite* rest,
+                                 absl::FunctionRef<bool(Element&)> callback) {
+  Element element;
+  return ParseRepeatedFieldStreaming(
+      input, field_number, &element, rest,
+      [&](MessageLite&) { return callback(element); });
+}
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_UTIL_STREAMING_PARSE_H__
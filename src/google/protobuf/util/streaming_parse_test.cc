@@ -0,0 +1,115 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/streaming_parse.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/unittest.pb.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using ::proto2_unittest::TestAllTypes;
+using ::proto2_unittest::TestRequired;
+using ::proto2_unittest::TestRequiredForeign;
+
+TestAllTypes MakeMessage() {
+  TestAllTypes message;
+  message.set_optional_int32(-1);
+  message.set_optional_string(std::string(300, 'x'));
+  for (int i = 0; i < 100; ++i) {
+    message.add_repeated_nested_message()->set_bb(i);
+    message.add_repeatedgroup()->set_a(i);
+    message.add_repeated_int32(i);
+  }
+  return message;
+}
+
+TEST(ParseRepeatedFieldStreamingTest, StreamsElements) {
+  const TestAllTypes message = MakeMessage();
+  const std::string data = message.SerializeAsString();
+  // A small block size makes elements straddle the stream's buffers.
+  io::ArrayInputStream input(data.data(), data.size(), /*block_size=*/7);
+
+  TestAllTypes rest;
+  std::vector<int> values;
+  EXPECT_TRUE(ParseRepeatedFieldStreaming<TestAllTypes::NestedMessage>(
+      &input, TestAllTypes::kRepeatedNestedMessageFieldNumber, &rest,
+      [&](TestAllTypes::NestedMessage& element) {
+        values.push_back(element.bb());
+        return true;
+      }));
+
+  ASSERT_EQ(values.size(), 100);
+  for (int i = 0; i < 100; ++i) EXPECT_EQ(values[i], i);
+  TestAllTypes expected = message;
+  expected.clear_repeated_nested_message();
+  EXPECT_EQ(rest.SerializeAsString(), expected.SerializeAsString());
+}
+
+TEST(ParseRepeatedFieldStreamingTest, StreamsGroups) {
+  const std::string data = MakeMessage().SerializeAsString();
+  io::ArrayInputStream input(data.data(), data.size());
+
+  TestAllTypes rest;
+  int count = 0;
+  EXPECT_TRUE(ParseRepeatedFieldStreaming<TestAllTypes::RepeatedGroup>(
+      &input, TestAllTypes::kRepeatedgroupFieldNumber, &rest,
+      [&](TestAllTypes::RepeatedGroup& element) {
+        EXPECT_EQ(element.a(), count++);
+        return true;
+      }));
+  EXPECT_EQ(count, 100);
+  EXPECT_EQ(rest.repeatedgroup_size(), 0);
+  EXPECT_EQ(rest.repeated_nested_message_size(), 100);
+}
+
+TEST(ParseRepeatedFieldStreamingTest, StopsWhenCallbackFails) {
+  const std::string data = MakeMessage().SerializeAsString();
+  io::ArrayInputStream input(data.data(), data.size());
+
+  TestAllTypes rest;
+  int count = 0;
+  EXPECT_FALSE(ParseRepeatedFieldStreaming<TestAllTypes::NestedMessage>(
+      &input, TestAllTypes::kRepeatedNestedMessageFieldNumber, &rest,
+      [&](TestAllTypes::NestedMessage&) { return ++count < 3; }));
+  EXPECT_EQ(count, 3);
+}
+
+TEST(ParseRepeatedFieldStreamingTest, RejectsInvalidInput) {
+  TestRequiredForeign message;
+  message.add_repeated_message();
+  std::string data = message.SerializePartialAsString();
+  TestRequiredForeign rest;
+  {
+    io::ArrayInputStream input(data.data(), data.size());
+    EXPECT_FALSE(ParseRepeatedFieldStreaming<TestRequired>(
+        &input, TestRequiredForeign::kRepeatedMessageFieldNumber, &rest,
+        [](TestRequired&) { return true; }));
+  }
+
+  data = MakeMessage().SerializeAsString();
+  data.resize(data.size() - 1);
+  {
+    io::ArrayInputStream input(data.data(), data.size());
+    TestAllTypes all_types;
+    EXPECT_FALSE(ParseRepeatedFieldStreaming<TestAllTypes::NestedMessage>(
+        &input, TestAllTypes::kRepeatedNestedMessageFieldNumber, &all_types,
+        [](TestAllTypes::NestedMessage&) { return true; }));
+  }
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,153 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/string_dictionary_codec.h"
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/message.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+void AppendVarint(uint64_t value, std::string* output) {
+  uint8_t buffer[10];
+  const uint8_t* end =
+      io::CodedOutputStream::WriteVarint64ToArray(value, buffer);
+  output->append(reinterpret_cast<const char*>(buffer), end - buffer);
+}
+
+// Reads a varint count of items that take at least one byte each, so that it
+// can be used to reserve space.
+bool ReadCount(io::CodedInputStream* input, uint32_t* count) {
+  return input->ReadVarint32(count) &&
+         *count <= static_cast<uint32_t>(input->BytesUntilLimit());
+}
+
+}  // namespace
+
+void StringDictionaryCodec::Encode(const Message& message,
+                                   std::string* output) {
+  const Reflection* reflection = message.GetReflection();
+  std::vector<const FieldDescriptor*> fields;
+  // Set fields, in field number order.
+  reflection->ListFields(message, &fields);
+
+  absl::flat_hash_map<std::string, uint32_t> indices;
+  std::string dictionary;
+  std::string columns;
+  std::string scratch;
+  for (const FieldDescriptor* field : fields) {
+    if (!field->is_repeated() || field->is_extension() ||
+        field->cpp_type() != FieldDescriptor::CPPTYPE_STRING) {
+      continue;
+    }
+    const int size = reflection->FieldSize(message, field);
+    AppendVarint(static_cast<uint32_t>(field->number()), &columns);
+    AppendVarint(static_cast<uint32_t>(size), &columns);
+    for (int i = 0; i < size; ++i) {
+      const std::string& value =
+          reflection->GetRepeatedStringReference(message, field, i, &scratch);
+      auto it = indices.find(value);
+      if (it == indices.end()) {
+        it = indices.emplace(value, static_cast<uint32_t>(indices.size()))
+                 .first;
+        AppendVarint(value.size(), &dictionary);
+        dictionary.append(value);
+      }
+      AppendVarint(it->second, &columns);
+    }
+  }
+
+  AppendVarint(indices.size(), output);
+  output->append(dictionary);
+  output->append(columns);
+}
+
+bool StringDictionaryCodec::Decode(absl::string_view data, Message* message) {
+  Decoded decoded;
+  if (!Parse(data, &decoded)) return false;
+
+  const Descriptor* descriptor = message->GetDescriptor();
+  std::vector<const FieldDescriptor*> fields;
+  fields.reserve(decoded.columns.size());
+  for (const Decoded::Column& column : decoded.columns) {
+    const FieldDescriptor* field =
+        descriptor->FindFieldByNumber(column.field_number);
+    if (field == nullptr || !field->is_repeated() ||
+        field->cpp_type() != FieldDescriptor::CPPTYPE_STRING) {
+      return false;
+    }
+    fields.push_back(field);
+  }
+
+  const Reflection* reflection = message->GetReflection();
+  for (size_t i = 0; i < fields.size(); ++i) {
+    for (uint32_t index : decoded.columns[i].indices) {
+      reflection->AddString(message, fields[i],
+                            std::string(decoded.dictionary[index]));
+    }
+  }
+  return true;
+}
+
+bool StringDictionaryCodec::Parse(absl::string_view data, Decoded* decoded) {
+  decoded->dictionary.clear();
+  decoded->columns.clear();
+  if (data.size() > INT_MAX) return false;
+  io::CodedInputStream input(reinterpret_cast<const uint8_t*>(data.data()),
+                             static_cast<int>(data.size()));
+
+  uint32_t dictionary_size;
+  if (!ReadCount(&input, &dictionary_size)) return false;
+  decoded->dictionary.reserve(dictionary_size);
+  for (uint32_t i = 0; i < dictionary_size; ++i) {
+    uint32_t length;
+    if (!input.ReadVarint32(&length) ||
+        length > static_cast<uint32_t>(input.BytesUntilLimit())) {
+      return false;
+    }
+    decoded->dictionary.push_back(
+        data.substr(static_cast<size_t>(input.CurrentPosition()), length));
+    input.Skip(static_cast<int>(length));
+  }
+
+  while (input.BytesUntilLimit() > 0) {
+    uint32_t field_number;
+    uint32_t count;
+    if (!input.ReadVarint32(&field_number) || field_number == 0 ||
+        field_number > static_cast<uint32_t>(FieldDescriptor::kMaxNumber) ||
+        !ReadCount(&input, &count)) {
+      return false;
+    }
+    Decoded::Column& column = decoded->columns.emplace_back();
+    column.field_number = static_cast<int>(field_number);
+    column.indices.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+      uint32_t index;
+      if (!input.ReadVarint32(&index) || index >= dictionary_size) {
+        return false;
+      }
+      column.indices.push_back(index);
+    }
+  }
+  return true;
+}
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,84 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Defines StringDictionaryCodec, a compact representation for the repeated
+// string and bytes fields of a message whose values repeat heavily, such as
+// host names or enum-like strings in logs.  Each distinct value is stored once,
+// in a dictionary shared by all the fields, and every element becomes a varint
+// index into it.
+//
+// The encoding is not the protobuf wire format.  It is a side representation:
+// messages are still serialized and parsed as usual, and the codec converts at
+// the edges.  Parse() reads the encoding without copying any string, which
+// suits columnar processing that only compares or groups the values.
+//
+// Example:
+//   std::string encoded;
+//   StringDictionaryCodec::Encode(log_entry, &encoded);
+//   ...
+//   StringDictionaryCodec::Decoded decoded;
+//   if (!StringDictionaryCodec::Parse(encoded, &decoded)) ...
+//   for (const auto& column : decoded.columns) ...
+
+#ifndef GOOGLE_PROTOBUF_UTIL_STRING_DICTIONARY_CODEC_H__
+#define GOOGLE_PROTOBUF_UTIL_STRING_DICTIONARY_CODEC_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "google/protobuf/message.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+// The encoding is the dictionary size as a varint and each dictionary entry as
+// a varint length followed by its bytes, then, for each non-empty field in
+// field number order, the field number, the number of elements and the
+// dictionary index of each element, all as varints.
+class PROTOBUF_EXPORT StringDictionaryCodec {
+ public:
+  // The encoding read back without copying: views into the encoded data.
+  struct Decoded {
+    struct Column {
+      int field_number = 0;
+      // An index into |dictionary| per element, in order.
+      std::vector<uint32_t> indices;
+    };
+
+    // The distinct values, each once.
+    std::vector<absl::string_view> dictionary;
+    std::vector<Column> columns;
+  };
+
+  // Appends the encoding of the repeated string and bytes fields of |message|
+  // to |output|.  Extensions and the fields of sub-messages are not included.
+  static void Encode(const Message& message, std::string* output);
+
+  // Appends the elements encoded in |data| to the fields of |message|.
+  // Returns false, leaving |message| unchanged, if |data| is not a valid
+  // encoding or names a field that is not a repeated string or bytes field of
+  // |message|.
+  static bool Decode(absl::string_view data, Message* message);
+
+  // Reads |data| into |decoded|, whose views point into |data|.  Returns false
+  // if |data| is not a valid encoding.
+  static bool Parse(absl::string_view data, Decoded* decoded);
+};
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_UTIL_STRING_DICTIONARY_CODEC_H__
@@ -0,0 +1,102 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/string_dictionary_codec.h"
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "google/protobuf/unittest.pb.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using ::proto2_unittest::TestAllTypes;
+using ::proto2_unittest::TestRequired;
+using ::testing::ElementsAre;
+
+TestAllTypes MakeLogEntry() {
+  TestAllTypes message;
+  for (int i = 0; i < 100; ++i) {
+    message.add_repeated_string(i % 2 == 0 ? "host-a.example.com"
+                                           : "host-b.example.com");
+  }
+  message.add_repeated_bytes("host-a.example.com");
+  message.add_repeated_bytes("");
+  message.set_optional_string("not encoded");
+  return message;
+}
+
+TEST(StringDictionaryCodecTest, RoundTrips) {
+  const TestAllTypes message = MakeLogEntry();
+  std::string encoded;
+  StringDictionaryCodec::Encode(message, &encoded);
+  // Each distinct value once, then a byte per element.
+  EXPECT_LT(encoded.size(), 2 * 19 + 110);
+
+  TestAllTypes decoded;
+  decoded.add_repeated_string("kept");
+  ASSERT_TRUE(StringDictionaryCodec::Decode(encoded, &decoded));
+  ASSERT_EQ(decoded.repeated_string_size(), 101);
+  EXPECT_EQ(decoded.repeated_string(0), "kept");
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(decoded.repeated_string(i + 1), message.repeated_string(i));
+  }
+  EXPECT_THAT(decoded.repeated_bytes(), ElementsAre("host-a.example.com", ""));
+  EXPECT_FALSE(decoded.has_optional_string());
+}
+
+TEST(StringDictionaryCodecTest, ParsesWithoutCopying) {
+  std::string encoded;
+  StringDictionaryCodec::Encode(MakeLogEntry(), &encoded);
+  StringDictionaryCodec::Decoded decoded;
+  ASSERT_TRUE(StringDictionaryCodec::Parse(encoded, &decoded));
+
+  EXPECT_THAT(decoded.dictionary,
+              ElementsAre("host-a.example.com", "host-b.example.com", ""));
+  for (absl::string_view value : decoded.dictionary) {
+    EXPECT_GE(value.data(), encoded.data());
+    EXPECT_LE(value.data() + value.size(), encoded.data() + encoded.size());
+  }
+  ASSERT_EQ(decoded.columns.size(), 2);
+  EXPECT_EQ(decoded.columns[0].field_number,
+            TestAllTypes::kRepeatedStringFieldNumber);
+  EXPECT_EQ(decoded.columns[0].indices.size(), 100);
+  EXPECT_EQ(decoded.columns[1].field_number,
+            TestAllTypes::kRepeatedBytesFieldNumber);
+  EXPECT_THAT(decoded.columns[1].indices, ElementsAre(0, 2));
+}
+
+TEST(StringDictionaryCodecTest, RejectsBadInput) {
+  std::string encoded;
+  StringDictionaryCodec::Encode(MakeLogEntry(), &encoded);
+  StringDictionaryCodec::Decoded decoded;
+  TestAllTypes message;
+  // Truncated.
+  EXPECT_FALSE(StringDictionaryCodec::Parse(
+      absl::string_view(encoded).substr(0, encoded.size() - 1), &decoded));
+  // An index past the end of the dictionary.
+  EXPECT_FALSE(StringDictionaryCodec::Decode(
+      std::string("\x01\x01x\x01\x01\x01", 6), &message));
+  EXPECT_TRUE(StringDictionaryCodec::Decode(
+      std::string("\x01\x01x\x2c\x01\x00", 6), &message));
+  // A field that is not a repeated string field of the message.
+  EXPECT_FALSE(
+      StringDictionaryCodec::Decode(std::string("\x01\x01x\x01\x01\x00", 6),
+                                    &message));
+  TestRequired other;
+  EXPECT_FALSE(StringDictionaryCodec::Decode(encoded, &other));
+  EXPECT_THAT(message.repeated_string(), ElementsAre("x"));
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
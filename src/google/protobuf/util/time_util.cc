@@ -7,8 +7,11 @@
 
 #include "google/protobuf/util/time_util.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <string>
+#include <vector>
 
 #include "google/protobuf/duration.pb.h"
 #include "google/protobuf/timestamp.pb.h"
@@ -19,6 +22,8 @@
 #include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "google/protobuf/repeated_ptr_field.h"
 
 // Must go after other includes.
 #include "google/protobuf/port_def.inc"
@@ -114,7 +119,121 @@ std::string FormatNanos(int32_t nanos) {
   }
 }
 
-std::string FormatTime(int64_t seconds, int32_t nanos) {
+// Writes `value` as exactly `width` decimal digits, zero-padded, and returns
+// the end of the output.
+char* WriteDigits(uint32_t value, int width, char* out) {
+  for (int i = width - 1; i >= 0; --i) {
+    out[i] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+  return out + width;
+}
+
+// Reads exactly `width` decimal digits, or returns -1 if any of them is not a
+// digit.
+int ReadDigits(const char* in, int width) {
+  int value = 0;
+  for (int i = 0; i < width; ++i) {
+    if (in[i] < '0' || in[i] > '9') return -1;
+    value = value * 10 + (in[i] - '0');
+  }
+  return value;
+}
+
+// Conversions between days since 1970-01-01 and proleptic Gregorian dates,
+// counting in 400-year eras of 146097 days.  See
+// https://howardhinnant.github.io/date_algorithms.html
+void CivilFromDays(int64_t days, uint32_t* year, uint32_t* month,
+                   uint32_t* day) {
+  days += 719468;  // Days from 0000-03-01 to 1970-01-01.
+  const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+  const uint32_t day_of_era = static_cast<uint32_t>(days - era * 146097);
+  const uint32_t year_of_era =
+      (day_of_era - day_of_era / 1460 + day_of_era / 36524 -
+       day_of_era / 146096) /
+      365;
+  const uint32_t day_of_year =
+      day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  const uint32_t march_month = (5 * day_of_year + 2) / 153;
+  *day = day_of_year - (153 * march_month + 2) / 5 + 1;
+  *month = march_month < 10 ? march_month + 3 : march_month - 9;
+  *year = static_cast<uint32_t>(year_of_era + era * 400 + (*month <= 2));
+}
+
+int64_t DaysFromCivil(uint32_t year, uint32_t month, uint32_t day) {
+  // Only called for years 0001 to 9999, so there is a single, positive era
+  // offset.
+  const int64_t march_year = int64_t{year} - (month <= 2);
+  const int64_t era = march_year / 400;
+  const uint32_t year_of_era = static_cast<uint32_t>(march_year - era * 400);
+  const uint32_t day_of_year =
+      (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  const uint32_t day_of_era = year_of_era * 365 + year_of_era / 4 -
+                              year_of_era / 100 + day_of_year;
+  return era * 146097 + int64_t{day_of_era} - 719468;
+}
+
+uint32_t DaysInMonth(uint32_t year, uint32_t month) {
+  static constexpr uint8_t kDays[] = {31, 28, 31, 30, 31, 30,
+                                      31, 31, 30, 31, 30, 31};
+  if (month == 2 && year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) {
+    return 29;
+  }
+  return kDays[month - 1];
+}
+
+// The longest output of FormatTime() for a valid Timestamp:
+// "9999-12-31T23:59:59.999999999Z".
+constexpr size_t kMaxTimestampLength = 30;
+
+// Formats a valid Timestamp into `out`, which must have room for
+// kMaxTimestampLength chars, and returns the end of the output.
+char* FormatValidTime(int64_t seconds, int32_t nanos, char* out) {
+  int64_t days = seconds / 86400;
+  int32_t second_of_day = static_cast<int32_t>(seconds % 86400);
+  if (second_of_day < 0) {
+    second_of_day += 86400;
+    --days;
+  }
+  uint32_t year, month, day;
+  CivilFromDays(days, &year, &month, &day);
+  out = WriteDigits(year, 4, out);
+  *out++ = '-';
+  out = WriteDigits(month, 2, out);
+  *out++ = '-';
+  out = WriteDigits(day, 2, out);
+  *out++ = 'T';
+  out = WriteDigits(second_of_day / kSecondsPerHour, 2, out);
+  *out++ = ':';
+  out = WriteDigits(second_of_day / kSecondsPerMinute % 60, 2, out);
+  *out++ = ':';
+  out = WriteDigits(second_of_day % kSecondsPerMinute, 2, out);
+  // Same precision as FormatNanos().
+  if (nanos != 0) {
+    *out++ = '.';
+    if (nanos % kNanosPerMillisecond == 0) {
+      out = WriteDigits(nanos / kNanosPerMillisecond, 3, out);
+    } else if (nanos % kNanosPerMicrosecond == 0) {
+      out = WriteDigits(nanos / kNanosPerMicrosecond, 6, out);
+    } else {
+      out = WriteDigits(nanos, 9, out);
+    }
+  }
+  *out++ = 'Z';
+  return out;
+}
+
+void AppendTime(int64_t seconds, int32_t nanos, std::string* result) {
+  if (seconds >= TimeUtil::kTimestampMinSeconds &&
+      seconds <= TimeUtil::kTimestampMaxSeconds &&
+      nanos >= TimeUtil::kTimestampMinNanoseconds &&
+      nanos <= TimeUtil::kTimestampMaxNanoseconds) {
+    char buffer[kMaxTimestampLength];
+    result->append(buffer, FormatValidTime(seconds, nanos, buffer));
+    return;
+  }
+
+  // Out of range values go through absl, as they always have.
   static constexpr absl::string_view kTimestampFormat = "%E4Y-%m-%dT%H:%M:%S";
 
   timespec spec;
@@ -122,18 +241,88 @@ std::string FormatTime(int64_t seconds, int32_t nanos) {
   // We only use absl::FormatTime to format the seconds part because we need
   // finer control over the precision of nanoseconds.
   spec.tv_nsec = 0;
-  std::string result = absl::FormatTime(
-      kTimestampFormat, absl::TimeFromTimespec(spec), absl::UTCTimeZone());
+  absl::StrAppend(result,
+                  absl::FormatTime(kTimestampFormat,
+                                   absl::TimeFromTimespec(spec),
+                                   absl::UTCTimeZone()));
   // We format the nanoseconds part separately to meet the precision
   // requirement.
   if (nanos != 0) {
-    absl::StrAppend(&result, ".", FormatNanos(nanos));
+    absl::StrAppend(result, ".", FormatNanos(nanos));
   }
-  absl::StrAppend(&result, "Z");
+  absl::StrAppend(result, "Z");
+}
+
+std::string FormatTime(int64_t seconds, int32_t nanos) {
+  std::string result;
+  AppendTime(seconds, nanos, &result);
   return result;
 }
 
+// Parses the common "YYYY-MM-DDTHH:MM:SS[.fraction](Z|+HH:MM|-HH:MM)" form of
+// RFC 3339 without going through absl::ParseTime().  Returns false for
+// anything else, including forms that ParseTime() accepts, such as leap
+// seconds or surrounding whitespace.
+bool ParseCommonTime(absl::string_view value, int64_t* seconds,
+                     int32_t* nanos) {
+  if (value.size() < 20 || value[4] != '-' || value[7] != '-' ||
+      value[10] != 'T' || value[13] != ':' || value[16] != ':') {
+    return false;
+  }
+  const char* data = value.data();
+  const int year = ReadDigits(data, 4);
+  const int month = ReadDigits(data + 5, 2);
+  const int day = ReadDigits(data + 8, 2);
+  const int hour = ReadDigits(data + 11, 2);
+  const int minute = ReadDigits(data + 14, 2);
+  const int second = ReadDigits(data + 17, 2);
+  if (year < 1 || month < 1 || month > 12 || day < 1 ||
+      day > static_cast<int>(DaysInMonth(year, month)) || hour < 0 ||
+      hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 59) {
+    return false;
+  }
+  value.remove_prefix(19);
+
+  int32_t fraction = 0;
+  if (!value.empty() && value[0] == '.') {
+    value.remove_prefix(1);
+    int digits = 0;
+    while (digits < static_cast<int>(value.size()) && value[digits] >= '0' &&
+           value[digits] <= '9') {
+      if (digits == 9) return false;
+      fraction = fraction * 10 + (value[digits] - '0');
+      ++digits;
+    }
+    if (digits == 0) return false;
+    for (int i = digits; i < 9; ++i) fraction *= 10;
+    value.remove_prefix(digits);
+  }
+
+  int32_t offset = 0;
+  if (value.size() == 6 && (value[0] == '+' || value[0] == '-') &&
+      value[3] == ':') {
+    const int offset_hours = ReadDigits(value.data() + 1, 2);
+    const int offset_minutes = ReadDigits(value.data() + 4, 2);
+    if (offset_hours < 0 || offset_hours > 23 || offset_minutes < 0 ||
+        offset_minutes > 59) {
+      return false;
+    }
+    offset =
+        offset_hours * kSecondsPerHour + offset_minutes * kSecondsPerMinute;
+    if (value[0] == '-') offset = -offset;
+  } else if (value != "Z") {
+    return false;
+  }
+
+  *seconds = DaysFromCivil(year, month, day) * 86400 +
+             hour * kSecondsPerHour + minute * kSecondsPerMinute + second -
+             offset;
+  *nanos = fraction;
+  return true;
+}
+
 bool ParseTime(absl::string_view value, int64_t* seconds, int32_t* nanos) {
+  if (ParseCommonTime(value, seconds, nanos)) return true;
   absl::Time result;
   if (!absl::ParseTime(absl::RFC3339_full, value, &result, nullptr)) {
     return false;
@@ -195,6 +384,41 @@ bool TimeUtil::FromString(absl::string_view value, Timestamp* timestamp) {
   return true;
 }
 
+void TimeUtil::AppendToString(const Timestamp& timestamp, std::string* output) {
+  AppendTime(timestamp.seconds(), timestamp.nanos(), output);
+}
+
+std::vector<std::string> TimeUtil::ToString(
+    const RepeatedPtrField<Timestamp>& timestamps) {
+  std::vector<std::string> result;
+  result.reserve(timestamps.size());
+  char buffer[kMaxTimestampLength];
+  for (const Timestamp& timestamp : timestamps) {
+    if (IsTimestampValid(timestamp)) {
+      result.emplace_back(
+          buffer,
+          FormatValidTime(timestamp.seconds(), timestamp.nanos(), buffer));
+    } else {
+      result.push_back(ToString(timestamp));
+    }
+  }
+  return result;
+}
+
+bool TimeUtil::FromString(absl::Span<const absl::string_view> values,
+                          RepeatedPtrField<Timestamp>* timestamps) {
+  timestamps->Reserve(timestamps->size() + static_cast<int>(values.size()));
+  for (absl::string_view value : values) {
+    int64_t seconds;
+    int32_t nanos;
+    if (!ParseTime(value, &seconds, &nanos)) {
+      return false;
+    }
+    *timestamps->Add() = CreateNormalized<Timestamp>(seconds, nanos);
+  }
+  return true;
+}
+
 Timestamp TimeUtil::GetCurrentTime() {
   int64_t seconds;
   int32_t nanos;
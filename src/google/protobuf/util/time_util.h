@@ -14,6 +14,7 @@
 #include <ctime>
 #include <ostream>
 #include <string>
+#include <vector>
 #ifdef _MSC_VER
 #ifdef _XBOX_ONE
 struct timeval {
@@ -29,6 +30,9 @@ struct timeval {
 
 #include "google/protobuf/duration.pb.h"
 #include "google/protobuf/timestamp.pb.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "google/protobuf/repeated_ptr_field.h"
 
 // Must be included last.
 #include "google/protobuf/port_def.inc"
@@ -89,6 +93,15 @@ class PROTOBUF_EXPORT TimeUtil {
   //   "1972-01-01T10:00:20.021-05:00"
   static std::string ToString(const Timestamp& timestamp);
   static bool FromString(absl::string_view value, Timestamp* timestamp);
+  // Appends ToString(timestamp) to `output`, so that many timestamps can be
+  // formatted into one buffer.
+  static void AppendToString(const Timestamp& timestamp, std::string* output);
+  // Batch forms of the above for time series.  FromString() appends to
+  // `timestamps` and returns false at the first value that cannot be parsed.
+  static std::vector<std::string> ToString(
+      const RepeatedPtrField<Timestamp>& timestamps);
+  static bool FromString(absl::Span<const absl::string_view> values,
+                         RepeatedPtrField<Timestamp>* timestamps);
 
   // Converts Duration to/from string format. The string format will contains
   // 3, 6, or 9 fractional digits depending on the precision required to
@@ -9,11 +9,15 @@
 
 #include <cstdint>
 #include <ctime>
+#include <string>
+#include <vector>
 
 #include "google/protobuf/duration.pb.h"
 #include "google/protobuf/timestamp.pb.h"
 #include "google/protobuf/testing/googletest.h"
 #include <gtest/gtest.h>
+#include "absl/strings/string_view.h"
+#include "google/protobuf/repeated_ptr_field.h"
 
 namespace google {
 namespace protobuf {
@@ -69,6 +73,52 @@ TEST(TimeUtilTest, TimestampStringFormat) {
   EXPECT_EQ(8 * 3600, TimeUtil::TimestampToSeconds(time));
 }
 
+TEST(TimeUtilTest, TimestampStringBatch) {
+  RepeatedPtrField<Timestamp> timestamps;
+  *timestamps.Add() = TimeUtil::NanosecondsToTimestamp(-1);
+  *timestamps.Add() = TimeUtil::SecondsToTimestamp(951782400);
+  *timestamps.Add() = TimeUtil::MillisecondsToTimestamp(1234567890123);
+  std::vector<std::string> strings = TimeUtil::ToString(timestamps);
+  EXPECT_EQ(strings, (std::vector<std::string>{"1969-12-31T23:59:59.999999999Z",
+                                               "2000-02-29T00:00:00Z",
+                                               "2009-02-13T23:31:30.123Z"}));
+
+  std::string appended = "at ";
+  TimeUtil::AppendToString(timestamps.Get(1), &appended);
+  EXPECT_EQ(appended, "at 2000-02-29T00:00:00Z");
+
+  std::vector<absl::string_view> values(strings.begin(), strings.end());
+  RepeatedPtrField<Timestamp> parsed;
+  EXPECT_TRUE(TimeUtil::FromString(values, &parsed));
+  ASSERT_EQ(parsed.size(), 3);
+  for (int i = 0; i < parsed.size(); ++i) {
+    EXPECT_EQ(parsed.Get(i), timestamps.Get(i));
+  }
+
+  // Parsing stops at the first bad value.
+  values = {"2000-02-29T00:00:00Z", "2001-02-29T00:00:00Z",
+            "2000-02-29T00:00:00Z"};
+  parsed.Clear();
+  EXPECT_FALSE(TimeUtil::FromString(values, &parsed));
+  EXPECT_EQ(parsed.size(), 1);
+}
+
+TEST(TimeUtilTest, TimestampParseUncommonForms) {
+  // Forms outside the common "YYYY-MM-DDTHH:MM:SS[.f](Z|+HH:MM)" shape are
+  // still accepted.
+  Timestamp time;
+  EXPECT_TRUE(TimeUtil::FromString("1970-01-01t00:00:01z", &time));
+  EXPECT_EQ(time.seconds(), 1);
+  EXPECT_TRUE(TimeUtil::FromString("1970-01-01T00:00:00.123456789012Z", &time));
+  EXPECT_EQ(time.nanos(), 123456789);
+  EXPECT_TRUE(TimeUtil::FromString("1970-01-01T00:00:00+00:30", &time));
+  EXPECT_EQ(time.seconds(), -1800);
+
+  EXPECT_FALSE(TimeUtil::FromString("1970-13-01T00:00:00Z", &time));
+  EXPECT_FALSE(TimeUtil::FromString("1970-01-01T00:00:00.Z", &time));
+  EXPECT_FALSE(TimeUtil::FromString("1970-01-01T00:00:00", &time));
+}
+
 TEST(TimeUtilTest, DurationStringFormat) {
   Timestamp begin, end;
   EXPECT_TRUE(TimeUtil::FromString("0001-01-01T00:00:00Z", &begin));
@@ -7,6 +7,7 @@
 
 #include "google/protobuf/util/type_resolver_util.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -15,12 +16,15 @@
 #include "google/protobuf/type.pb.h"
 #include "google/protobuf/wrappers.pb.h"
 #include "google/protobuf/descriptor.pb.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
 #include "google/protobuf/io/strtod.h"
 #include "google/protobuf/util/type_resolver.h"
 
@@ -366,8 +370,67 @@ class DescriptorPoolTypeResolver : public TypeResolver {
   const DescriptorPool* pool_;
 };
 
+class CachingTypeResolver : public TypeResolver {
+ public:
+  explicit CachingTypeResolver(TypeResolver* resolver) : resolver_(resolver) {}
+
+  absl::Status ResolveMessageType(const std::string& type_url,
+                                  Type* type) override {
+    return Resolve(
+        type_url, type, &types_,
+        [this](const std::string& url, Type* t) {
+          return resolver_->ResolveMessageType(url, t);
+        });
+  }
+
+  absl::Status ResolveEnumType(const std::string& type_url,
+                               Enum* enum_type) override {
+    return Resolve(
+        type_url, enum_type, &enums_,
+        [this](const std::string& url, Enum* e) {
+          return resolver_->ResolveEnumType(url, e);
+        });
+  }
+
+ private:
+  template <typename T, typename ResolveFn>
+  absl::Status Resolve(
+      const std::string& type_url, T* out,
+      absl::flat_hash_map<std::string, std::unique_ptr<const T>>* cache,
+      ResolveFn resolve) {
+    {
+      absl::ReaderMutexLock lock(&mutex_);
+      auto it = cache->find(type_url);
+      if (it != cache->end()) {
+        *out = *it->second;
+        return absl::OkStatus();
+      }
+    }
+    // Resolve without holding the lock, so that lookups of other types are
+    // not blocked.  Concurrent misses of the same type resolve it twice.
+    auto resolved = std::make_unique<T>();
+    absl::Status status = resolve(type_url, resolved.get());
+    if (!status.ok()) return status;
+    *out = *resolved;
+    absl::MutexLock lock(&mutex_);
+    cache->try_emplace(type_url, std::move(resolved));
+    return absl::OkStatus();
+  }
+
+  TypeResolver* resolver_;
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::unique_ptr<const Type>> types_
+      ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, std::unique_ptr<const Enum>> enums_
+      ABSL_GUARDED_BY(mutex_);
+};
+
 }  // namespace
 
+TypeResolver* NewCachingTypeResolver(TypeResolver* resolver) {
+  return new CachingTypeResolver(resolver);
+}
+
 TypeResolver* NewTypeResolverForDescriptorPool(absl::string_view url_prefix,
                                                const DescriptorPool* pool) {
   return new DescriptorPoolTypeResolver(url_prefix, pool);
@@ -28,6 +28,14 @@ class TypeResolver;
 PROTOBUF_EXPORT TypeResolver* NewTypeResolverForDescriptorPool(
     absl::string_view url_prefix, const DescriptorPool* pool);
 
+// Creates a TypeResolver that remembers the types resolved by `resolver`, so
+// that each type URL is only resolved once.  Worth it when resolving is
+// expensive, as with NewTypeResolverForDescriptorPool(), which converts the
+// descriptors on every call.  Failed lookups are not remembered.  `resolver`
+// remains property of the caller and must outlive the returned TypeResolver.
+// Caller takes ownership of the returned TypeResolver.
+PROTOBUF_EXPORT TypeResolver* NewCachingTypeResolver(TypeResolver* resolver);
+
 // Performs a direct conversion from a descriptor to a type proto.
 PROTOBUF_EXPORT google::protobuf::Type ConvertDescriptorToType(
     absl::string_view url_prefix, const Descriptor& descriptor);
@@ -755,6 +755,69 @@ TEST(ConvertDescriptorToTypeTest, TestCustomEnumOptions) {
       HasInt32Option(value->options(), "proto2_unittest.enum_value_opt1", 123));
 }
 
+// Counts the lookups that reach the wrapped resolver.
+class CountingTypeResolver : public TypeResolver {
+ public:
+  explicit CountingTypeResolver(TypeResolver* resolver)
+      : resolver_(resolver) {}
+
+  absl::Status ResolveMessageType(const std::string& type_url,
+                                  Type* type) override {
+    ++lookups_;
+    return resolver_->ResolveMessageType(type_url, type);
+  }
+
+  absl::Status ResolveEnumType(const std::string& type_url,
+                               Enum* enum_type) override {
+    ++lookups_;
+    return resolver_->ResolveEnumType(type_url, enum_type);
+  }
+
+  int lookups_ = 0;
+
+ private:
+  TypeResolver* resolver_;
+};
+
+TEST(CachingTypeResolverTest, ResolvesEachTypeOnce) {
+  std::unique_ptr<TypeResolver> pool_resolver(NewTypeResolverForDescriptorPool(
+      kUrlPrefix, DescriptorPool::generated_pool()));
+  CountingTypeResolver counting(pool_resolver.get());
+  std::unique_ptr<TypeResolver> resolver(NewCachingTypeResolver(&counting));
+
+  Type expected;
+  ASSERT_TRUE(pool_resolver
+                  ->ResolveMessageType(
+                      GetTypeUrl<proto2_unittest::TestAllTypes>(), &expected)
+                  .ok());
+  for (int i = 0; i < 2; ++i) {
+    Type type;
+    ASSERT_TRUE(
+        resolver
+            ->ResolveMessageType(GetTypeUrl<proto2_unittest::TestAllTypes>(),
+                                 &type)
+            .ok());
+    EXPECT_EQ(type.SerializeAsString(), expected.SerializeAsString());
+  }
+  EXPECT_EQ(counting.lookups_, 1);
+
+  std::string enum_url =
+      GetTypeUrl("proto2_unittest.TestAllTypes.NestedEnum");
+  Enum enum_type;
+  EXPECT_TRUE(resolver->ResolveEnumType(enum_url, &enum_type).ok());
+  EXPECT_TRUE(resolver->ResolveEnumType(enum_url, &enum_type).ok());
+  EXPECT_TRUE(EnumHasValue(enum_type, "BAR", 2));
+  EXPECT_EQ(counting.lookups_, 2);
+
+  // Failed lookups are not remembered.
+  Type type;
+  EXPECT_FALSE(
+      resolver->ResolveMessageType(GetTypeUrl("NoSuchType"), &type).ok());
+  EXPECT_FALSE(
+      resolver->ResolveMessageType(GetTypeUrl("NoSuchType"), &type).ok());
+  EXPECT_EQ(counting.lookups_, 4);
+}
+
 }  // namespace
 }  // namespace util
 }  // namespace protobuf
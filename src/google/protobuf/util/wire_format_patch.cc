@@ -0,0 +1,207 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/wire_format_patch.h"
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/wire_format_lite.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using internal::WireFormatLite;
+
+// The location of an enclosing message in the buffer.
+struct EnclosingMessage {
+  int prefix_start;  // Offset of the length prefix.
+  int value_start;   // Offset of the value, just after the prefix.
+  int value_end;
+};
+
+// Finds the last occurrence of the field at |path| in a serialized message.
+class FieldFinder {
+ public:
+  FieldFinder(absl::Span<const int> path, WireFormatLite::WireType wire_type)
+      : path_(path), wire_type_(wire_type) {}
+
+  // Returns false if the input is malformed.
+  bool Find(io::CodedInputStream* input) { return Walk(input, 0); }
+
+  bool found() const { return found_; }
+  // The value of the field; for a length-delimited field, including its
+  // length prefix.
+  int value_start() const { return value_start_; }
+  int value_end() const { return value_end_; }
+  // The messages enclosing the field, outermost first.
+  const std::vector<EnclosingMessage>& enclosing() const { return enclosing_; }
+
+ private:
+  bool Walk(io::CodedInputStream* input, int depth) {
+    const bool leaf = depth + 1 == static_cast<int>(path_.size());
+    while (input->BytesUntilLimit() > 0) {
+      const uint32_t tag = input->ReadTag();
+      if (WireFormatLite::GetTagFieldNumber(tag) == 0) return false;
+      const WireFormatLite::WireType wire_type =
+          WireFormatLite::GetTagWireType(tag);
+      if (WireFormatLite::GetTagFieldNumber(tag) != path_[depth] ||
+          (leaf && wire_type != wire_type_) ||
+          (!leaf && wire_type != WireFormatLite::WIRETYPE_LENGTH_DELIMITED)) {
+        if (!WireFormatLite::SkipField(input, tag)) return false;
+        continue;
+      }
+      const int value_start = input->CurrentPosition();
+      if (leaf) {
+        if (!WireFormatLite::SkipField(input, tag)) return false;
+        found_ = true;
+        value_start_ = value_start;
+        value_end_ = input->CurrentPosition();
+        enclosing_ = stack_;
+        continue;
+      }
+      uint32_t length;
+      if (!input->ReadVarint32(&length) ||
+          length > static_cast<uint32_t>(input->BytesUntilLimit())) {
+        return false;
+      }
+      const int start = input->CurrentPosition();
+      stack_.push_back({value_start, start, start + static_cast<int>(length)});
+      io::CodedInputStream::Limit limit =
+          input->PushLimit(static_cast<int>(length));
+      if (!Walk(input, depth + 1)) return false;
+      input->PopLimit(limit);
+      stack_.pop_back();
+    }
+    return true;
+  }
+
+  const absl::Span<const int> path_;
+  const WireFormatLite::WireType wire_type_;
+  std::vector<EnclosingMessage> stack_;
+  bool found_ = false;
+  int value_start_ = 0;
+  int value_end_ = 0;
+  std::vector<EnclosingMessage> enclosing_;
+};
+
+void AppendVarint(uint64_t value, std::string* out) {
+  uint8_t buffer[10];
+  uint8_t* end = io::CodedOutputStream::WriteVarint64ToArray(value, buffer);
+  out->append(reinterpret_cast<const char*>(buffer), end - buffer);
+}
+
+// |encoded| is the encoded value of the field, including the length prefix of
+// a length-delimited field.
+bool Patch(std::string* data, absl::Span<const int> path,
+           WireFormatLite::WireType wire_type, absl::string_view encoded) {
+  if (path.empty() || data->size() > INT_MAX) return false;
+  FieldFinder finder(path, wire_type);
+  {
+    io::CodedInputStream input(reinterpret_cast<const uint8_t*>(data->data()),
+                               static_cast<int>(data->size()));
+    if (!finder.Find(&input)) return false;
+  }
+
+  if (!finder.found()) {
+    // Append the field, wrapped in the enclosing messages.  Since the last
+    // occurrence of a singular field wins and messages are merged, this sets
+    // the field without disturbing the rest of the message.
+    std::string field;
+    AppendVarint(WireFormatLite::MakeTag(path.back(), wire_type), &field);
+    field.append(encoded.data(), encoded.size());
+    for (int i = static_cast<int>(path.size()) - 2; i >= 0; --i) {
+      std::string wrapped;
+      AppendVarint(WireFormatLite::MakeTag(
+                       path[i], WireFormatLite::WIRETYPE_LENGTH_DELIMITED),
+                   &wrapped);
+      AppendVarint(field.size(), &wrapped);
+      wrapped.append(field);
+      field = std::move(wrapped);
+    }
+    data->append(field);
+    return true;
+  }
+
+  const int old_size = finder.value_end() - finder.value_start();
+  const std::vector<EnclosingMessage>& enclosing = finder.enclosing();
+  // Each length prefix grows by at most 5 bytes, so the new lengths fit in an
+  // int if this does.
+  if (data->size() + encoded.size() + 5 * enclosing.size() > INT_MAX) {
+    return false;
+  }
+  if (static_cast<size_t>(old_size) == encoded.size()) {
+    // Same size: overwrite the value in place.
+    data->replace(finder.value_start(), old_size, encoded.data(),
+                  encoded.size());
+    return true;
+  }
+
+  // Splice in the new value, then fix up the length prefixes of the enclosing
+  // messages from the innermost one outwards.  Each edit only moves bytes
+  // after it, so the offsets of the remaining (earlier) prefixes stay valid.
+  int64_t delta = static_cast<int64_t>(encoded.size()) - old_size;
+  data->replace(finder.value_start(), old_size, encoded.data(),
+                encoded.size());
+  for (auto it = enclosing.rbegin(); it != enclosing.rend(); ++it) {
+    const int64_t length = it->value_end - it->value_start + delta;
+    std::string prefix;
+    AppendVarint(static_cast<uint64_t>(length), &prefix);
+    const int old_prefix_size = it->value_start - it->prefix_start;
+    data->replace(it->prefix_start, old_prefix_size, prefix);
+    delta += static_cast<int64_t>(prefix.size()) - old_prefix_size;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool PatchVarintField(std::string* data, absl::Span<const int> path,
+                      uint64_t value) {
+  std::string encoded;
+  AppendVarint(value, &encoded);
+  return Patch(data, path, WireFormatLite::WIRETYPE_VARINT, encoded);
+}
+
+bool PatchFixed32Field(std::string* data, absl::Span<const int> path,
+                       uint32_t value) {
+  uint8_t encoded[sizeof(value)];
+  io::CodedOutputStream::WriteLittleEndian32ToArray(value, encoded);
+  return Patch(data, path, WireFormatLite::WIRETYPE_FIXED32,
+               absl::string_view(reinterpret_cast<const char*>(encoded),
+                                 sizeof(encoded)));
+}
+
+bool PatchFixed64Field(std::string* data, absl::Span<const int> path,
+                       uint64_t value) {
+  uint8_t encoded[sizeof(value)];
+  io::CodedOutputStream::WriteLittleEndian64ToArray(value, encoded);
+  return Patch(data, path, WireFormatLite::WIRETYPE_FIXED64,
+               absl::string_view(reinterpret_cast<const char*>(encoded),
+                                 sizeof(encoded)));
+}
+
+bool PatchLengthDelimitedField(std::string* data, absl::Span<const int> path,
+                               absl::string_view value) {
+  std::string encoded;
+  AppendVarint(value.size(), &encoded);
+  encoded.append(value.data(), value.size());
+  return Patch(data, path, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, encoded);
+}
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,75 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Defines functions that set a single field of a serialized message by
+// editing its wire format, without parsing and re-serializing the message.
+// If the field is present, only its value and the length prefixes of the
+// messages enclosing it are rewritten; when the new value has the same
+// encoded size as the old one, the buffer is updated in place.  If the field
+// is absent, it is appended to the message.
+//
+// The field is identified by a |path| of field numbers, starting from the
+// top-level message.  All but the last number name singular message fields,
+// which must be length-delimited (not groups), and the last one names a
+// singular field that is not part of a oneof.  These functions operate at the
+// wire level and cannot check any of this; they also do not check that the
+// value matches the field's declared type.
+//
+// Example:
+//   // Sets request.header().timestamp_micros(), where header is field 1 and
+//   // timestamp_micros is field 3.
+//   std::string data = request.SerializeAsString();
+//   PatchVarintField(&data, {1, 3}, absl::ToUnixMicros(absl::Now()));
+
+#ifndef GOOGLE_PROTOBUF_UTIL_WIRE_FORMAT_PATCH_H__
+#define GOOGLE_PROTOBUF_UTIL_WIRE_FORMAT_PATCH_H__
+
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+// Sets a field encoded as a varint (int32, int64, uint32, uint64, bool and
+// enum fields) to |value|.  For sint32 and sint64 fields, pass the zigzag
+// encoding of the value.
+//
+// These functions return false, leaving |data| unchanged, if it is not valid
+// wire format or if |path| is empty.
+PROTOBUF_EXPORT bool PatchVarintField(std::string* data,
+                                      absl::Span<const int> path,
+                                      uint64_t value);
+
+// Sets a fixed32, sfixed32 or float field to the given bits.
+PROTOBUF_EXPORT bool PatchFixed32Field(std::string* data,
+                                       absl::Span<const int> path,
+                                       uint32_t value);
+
+// Sets a fixed64, sfixed64 or double field to the given bits.
+PROTOBUF_EXPORT bool PatchFixed64Field(std::string* data,
+                                       absl::Span<const int> path,
+                                       uint64_t value);
+
+// Sets a string, bytes or message field to the bytes of |value|.
+PROTOBUF_EXPORT bool PatchLengthDelimitedField(std::string* data,
+                                               absl::Span<const int> path,
+                                               absl::string_view value);
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_UTIL_WIRE_FORMAT_PATCH_H__
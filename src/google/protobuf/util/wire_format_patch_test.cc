@@ -0,0 +1,124 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/wire_format_patch.h"
+
+#include <cstdint>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
+#include "google/protobuf/test_util.h"
+#include "google/protobuf/unittest.pb.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using ::proto2_unittest::NestedTestAllTypes;
+using ::proto2_unittest::TestAllTypes;
+
+TEST(WireFormatPatchTest, SameSizeValueIsPatchedInPlace) {
+  TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  std::string data = message.SerializeAsString();
+  const char* buffer = data.data();
+  const size_t size = data.size();
+
+  ASSERT_TRUE(PatchVarintField(&data, {1}, 102));
+  ASSERT_TRUE(PatchFixed32Field(&data, {7}, 108));
+  ASSERT_TRUE(PatchFixed64Field(&data, {8}, 109));
+  ASSERT_TRUE(PatchLengthDelimitedField(&data, {14}, "116"));
+  ASSERT_TRUE(PatchVarintField(&data, {18, 1}, 119));
+  EXPECT_EQ(data.data(), buffer);
+  EXPECT_EQ(data.size(), size);
+
+  message.set_optional_int32(102);
+  message.set_optional_fixed32(108);
+  message.set_optional_fixed64(109);
+  message.set_optional_string("116");
+  message.mutable_optional_nested_message()->set_bb(119);
+  TestAllTypes patched;
+  ASSERT_TRUE(patched.ParseFromString(data));
+  EXPECT_EQ(patched.DebugString(), message.DebugString());
+}
+
+TEST(WireFormatPatchTest, ResizedValueAdjustsEnclosingLengths) {
+  NestedTestAllTypes message;
+  NestedTestAllTypes* grandchild = message.mutable_child()->mutable_child();
+  grandchild->mutable_payload()->set_optional_string("short");
+  grandchild->mutable_payload()->set_optional_int32(1);
+  message.mutable_child()->mutable_payload()->set_optional_int32(2);
+  message.mutable_payload()->set_optional_int32(3);
+  std::string data = message.SerializeAsString();
+
+  // Grow the string past 127 bytes so that every enclosing length prefix
+  // needs a second byte.
+  const std::string long_value(200, 'x');
+  ASSERT_TRUE(PatchLengthDelimitedField(&data, {1, 1, 2, 14}, long_value));
+  grandchild->mutable_payload()->set_optional_string(long_value);
+  NestedTestAllTypes patched;
+  ASSERT_TRUE(patched.ParseFromString(data));
+  EXPECT_EQ(patched.DebugString(), message.DebugString());
+
+  // And shrink it again.
+  ASSERT_TRUE(PatchLengthDelimitedField(&data, {1, 1, 2, 14}, "s"));
+  grandchild->mutable_payload()->set_optional_string("s");
+  ASSERT_TRUE(patched.ParseFromString(data));
+  EXPECT_EQ(patched.DebugString(), message.DebugString());
+  EXPECT_EQ(data.size(), message.ByteSizeLong());
+}
+
+TEST(WireFormatPatchTest, PatchesLastOccurrence) {
+  TestAllTypes first;
+  first.set_optional_int32(1);
+  first.mutable_optional_nested_message()->set_bb(1);
+  TestAllTypes second;
+  second.set_optional_int32(2);
+  second.mutable_optional_nested_message()->set_bb(2);
+  std::string data =
+      absl::StrCat(first.SerializeAsString(), second.SerializeAsString());
+
+  ASSERT_TRUE(PatchVarintField(&data, {1}, 300));
+  ASSERT_TRUE(PatchVarintField(&data, {18, 1}, 400));
+  TestAllTypes patched;
+  ASSERT_TRUE(patched.ParseFromString(data));
+  EXPECT_EQ(patched.optional_int32(), 300);
+  EXPECT_EQ(patched.optional_nested_message().bb(), 400);
+}
+
+TEST(WireFormatPatchTest, AbsentFieldIsAppended) {
+  TestAllTypes message;
+  message.set_optional_int32(1);
+  std::string data = message.SerializeAsString();
+
+  ASSERT_TRUE(PatchVarintField(&data, {2}, 5));
+  ASSERT_TRUE(PatchVarintField(&data, {18, 1}, 6));
+  ASSERT_TRUE(PatchLengthDelimitedField(&data, {14}, "foo"));
+  message.set_optional_int64(5);
+  message.mutable_optional_nested_message()->set_bb(6);
+  message.set_optional_string("foo");
+  TestAllTypes patched;
+  ASSERT_TRUE(patched.ParseFromString(data));
+  EXPECT_EQ(patched.DebugString(), message.DebugString());
+}
+
+TEST(WireFormatPatchTest, RejectsMalformedInput) {
+  std::string data = "\x92\x01\x05\x08\x01";  // Truncated nested message.
+  EXPECT_FALSE(PatchVarintField(&data, {18, 1}, 1));
+  EXPECT_EQ(data, "\x92\x01\x05\x08\x01");
+
+  data = "\x08\x01";
+  EXPECT_FALSE(PatchVarintField(&data, {}, 1));
+  EXPECT_EQ(data, "\x08\x01");
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
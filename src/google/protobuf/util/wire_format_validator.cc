@@ -0,0 +1,301 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/wire_format_validator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/numeric/int128.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/util/wire_format_visitor.h"
+#include "google/protobuf/wire_format_lite.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+using internal::WireFormatLite;
+
+// Visits the serialized message, tracking the type of the message being
+// visited and the number of elements seen of each constrained repeated field.
+class WireFormatValidator::Checker : public WireFormatVisitor {
+ public:
+  explicit Checker(const WireFormatValidator& validator)
+      : validator_(validator), types_{validator.descriptor_}, counts_(1) {}
+
+  const absl::Status& status() const { return status_; }
+
+  void OnVarint(absl::Span<const int> path, int field_number,
+                uint64_t value) override {
+    const Constrained constrained = Find(path, field_number);
+    if (constrained.field == nullptr ||
+        WireTypeOf(constrained.field) != WireFormatLite::WIRETYPE_VARINT) {
+      return;
+    }
+    CheckElement(path, constrained);
+    CheckValue(constrained, DecodeVarint(constrained.field, value));
+  }
+
+  void OnFixed32(absl::Span<const int> path, int field_number,
+                 uint32_t value) override {
+    const Constrained constrained = Find(path, field_number);
+    if (constrained.field == nullptr ||
+        WireTypeOf(constrained.field) != WireFormatLite::WIRETYPE_FIXED32) {
+      return;
+    }
+    CheckElement(path, constrained);
+    CheckValue(constrained, DecodeFixed32(constrained.field, value));
+  }
+
+  void OnFixed64(absl::Span<const int> path, int field_number,
+                 uint64_t value) override {
+    const Constrained constrained = Find(path, field_number);
+    if (constrained.field == nullptr ||
+        WireTypeOf(constrained.field) != WireFormatLite::WIRETYPE_FIXED64) {
+      return;
+    }
+    CheckElement(path, constrained);
+    CheckValue(constrained, DecodeFixed64(constrained.field, value));
+  }
+
+  void OnLengthDelimited(absl::Span<const int> path, int field_number,
+                         absl::string_view value) override {
+    const Constrained constrained = Find(path, field_number);
+    if (constrained.field == nullptr) return;
+    const FieldDescriptor* field = constrained.field;
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING) {
+      CheckElement(path, constrained);
+      if (constrained.constraints->max_length.has_value() &&
+          value.size() > *constrained.constraints->max_length) {
+        Fail(field, "is longer than its maximum length");
+      }
+    } else if (field->is_packable()) {
+      CheckPacked(path, constrained, value);
+    }
+    // Message fields are counted by ShouldDescend().
+  }
+
+  bool ShouldDescend(absl::Span<const int> path, int field_number) override {
+    if (!status_.ok()) return false;
+    const Descriptor* type = types_[path.size()];
+    const FieldDescriptor* field = type->FindFieldByNumber(field_number);
+    if (field == nullptr ||
+        field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+      return false;
+    }
+    const auto it = validator_.constraints_.find(field);
+    if (it != validator_.constraints_.end()) {
+      CheckElement(path, {field, &it->second});
+    }
+    if (!validator_.types_to_visit_.contains(field->message_type())) {
+      return false;
+    }
+    // A new message starts one level down.
+    types_.resize(path.size() + 1);
+    types_.push_back(field->message_type());
+    counts_.resize(path.size() + 2);
+    counts_.back().clear();
+    return true;
+  }
+
+ private:
+  struct Constrained {
+    const FieldDescriptor* field;
+    const FieldConstraints* constraints;
+  };
+
+  Constrained Find(absl::Span<const int> path, int field_number) const {
+    if (!status_.ok()) return {nullptr, nullptr};
+    const FieldDescriptor* field =
+        types_[path.size()]->FindFieldByNumber(field_number);
+    if (field == nullptr) return {nullptr, nullptr};
+    const auto it = validator_.constraints_.find(field);
+    if (it == validator_.constraints_.end()) return {nullptr, nullptr};
+    return {field, &it->second};
+  }
+
+  static WireFormatLite::WireType WireTypeOf(const FieldDescriptor* field) {
+    return WireFormatLite::WireTypeForFieldType(
+        static_cast<WireFormatLite::FieldType>(field->type()));
+  }
+
+  static absl::int128 DecodeVarint(const FieldDescriptor* field,
+                                   uint64_t value) {
+    switch (field->type()) {
+      case FieldDescriptor::TYPE_INT32:
+      case FieldDescriptor::TYPE_ENUM:
+        return static_cast<int32_t>(value);
+      case FieldDescriptor::TYPE_INT64:
+        return static_cast<int64_t>(value);
+      case FieldDescriptor::TYPE_UINT32:
+        return static_cast<uint32_t>(value);
+      case FieldDescriptor::TYPE_SINT32:
+        return WireFormatLite::ZigZagDecode32(static_cast<uint32_t>(value));
+      case FieldDescriptor::TYPE_SINT64:
+        return WireFormatLite::ZigZagDecode64(value);
+      default:  // uint64 and bool
+        return value;
+    }
+  }
+
+  static absl::int128 DecodeFixed32(const FieldDescriptor* field,
+                                    uint32_t value) {
+    if (field->type() == FieldDescriptor::TYPE_SFIXED32) {
+      return static_cast<int32_t>(value);
+    }
+    return value;
+  }
+
+  static absl::int128 DecodeFixed64(const FieldDescriptor* field,
+                                    uint64_t value) {
+    if (field->type() == FieldDescriptor::TYPE_SFIXED64) {
+      return static_cast<int64_t>(value);
+    }
+    return value;
+  }
+
+  // Counts one element of |constrained| in the message at |path|.
+  void CheckElement(absl::Span<const int> path,
+                    const Constrained& constrained) {
+    if (!constrained.field->is_repeated() ||
+        !constrained.constraints->max_count.has_value()) {
+      return;
+    }
+    size_t& count = counts_[path.size()][constrained.field];
+    if (++count > *constrained.constraints->max_count) {
+      Fail(constrained.field, "has more than its maximum number of elements");
+    }
+  }
+
+  void CheckValue(const Constrained& constrained, absl::int128 value) {
+    const FieldConstraints& constraints = *constrained.constraints;
+    if ((constraints.min.has_value() && value < *constraints.min) ||
+        (constraints.max.has_value() && value > *constraints.max)) {
+      Fail(constrained.field, "is out of range");
+    }
+  }
+
+  void CheckPacked(absl::Span<const int> path, const Constrained& constrained,
+                   absl::string_view value) {
+    io::CodedInputStream input(reinterpret_cast<const uint8_t*>(value.data()),
+                               static_cast<int>(value.size()));
+    const FieldDescriptor* field = constrained.field;
+    while (status_.ok() && input.BytesUntilLimit() > 0) {
+      absl::int128 element;
+      bool read;
+      switch (WireTypeOf(field)) {
+        case WireFormatLite::WIRETYPE_VARINT: {
+          uint64_t varint = 0;
+          read = input.ReadVarint64(&varint);
+          element = DecodeVarint(field, varint);
+          break;
+        }
+        case WireFormatLite::WIRETYPE_FIXED32: {
+          uint32_t fixed = 0;
+          read = input.ReadLittleEndian32(&fixed);
+          element = DecodeFixed32(field, fixed);
+          break;
+        }
+        default: {
+          uint64_t fixed = 0;
+          read = input.ReadLittleEndian64(&fixed);
+          element = DecodeFixed64(field, fixed);
+          break;
+        }
+      }
+      if (!read) {
+        Fail(field, "is not valid wire format");
+        return;
+      }
+      CheckElement(path, constrained);
+      CheckValue(constrained, element);
+    }
+  }
+
+  void Fail(const FieldDescriptor* field, absl::string_view problem) {
+    if (status_.ok()) {
+      status_ = absl::InvalidArgumentError(
+          absl::StrCat(field->full_name(), " ", problem));
+    }
+  }
+
+  const WireFormatValidator& validator_;
+  // The type of the message at each depth of the current path.
+  std::vector<const Descriptor*> types_;
+  // The number of elements of each constrained repeated field seen so far in
+  // the message at each depth of the current path.
+  std::vector<absl::flat_hash_map<const FieldDescriptor*, size_t>> counts_;
+  absl::Status status_;
+};
+
+WireFormatValidator::WireFormatValidator(const Descriptor* descriptor)
+    : descriptor_(descriptor) {
+  types_to_visit_.insert(descriptor_);
+}
+
+void WireFormatValidator::AddConstraint(const FieldDescriptor* field,
+                                        const FieldConstraints& constraints) {
+  constraints_[field] = constraints;
+  UpdateTypesToVisit();
+}
+
+void WireFormatValidator::UpdateTypesToVisit() {
+  // The message types reachable from the validated type.
+  std::vector<const Descriptor*> types = {descriptor_};
+  absl::flat_hash_set<const Descriptor*> reachable = {descriptor_};
+  for (size_t i = 0; i < types.size(); ++i) {
+    for (int j = 0; j < types[i]->field_count(); ++j) {
+      const Descriptor* type = types[i]->field(j)->message_type();
+      if (type != nullptr && reachable.insert(type).second) {
+        types.push_back(type);
+      }
+    }
+  }
+
+  types_to_visit_.clear();
+  for (const auto& entry : constraints_) {
+    types_to_visit_.insert(entry.first->containing_type());
+  }
+  // Add the types that contain those, until there are no more.
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (const Descriptor* type : types) {
+      if (types_to_visit_.contains(type)) continue;
+      for (int j = 0; j < type->field_count(); ++j) {
+        const Descriptor* field_type = type->field(j)->message_type();
+        if (field_type != nullptr && types_to_visit_.contains(field_type)) {
+          types_to_visit_.insert(type);
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
+  types_to_visit_.insert(descriptor_);
+}
+
+absl::Status WireFormatValidator::Validate(absl::string_view data) const {
+  Checker checker(*this);
+  if (!VisitWireFormat(data, &checker) && checker.status().ok()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid wire format for ", descriptor_->full_name()));
+  }
+  return checker.status();
+}
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
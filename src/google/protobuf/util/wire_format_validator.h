@@ -0,0 +1,94 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Defines WireFormatValidator, which checks per-field constraints (ranges of
+// numbers, lengths of strings and bytes, and numbers of repeated elements)
+// against a serialized message, before or instead of parsing it.  Checking
+// the bytes in one pass avoids a second, reflective traversal of the parsed
+// message, and nested messages without constrained fields are skipped over
+// without being decoded.
+//
+// Example:
+//   WireFormatValidator validator(Request::descriptor());
+//   FieldConstraints page_size;
+//   page_size.min = 1;
+//   page_size.max = 1000;
+//   validator.AddConstraint(
+//       Request::descriptor()->FindFieldByName("page_size"), page_size);
+//   ...
+//   absl::Status status = validator.Validate(serialized_request);
+
+#ifndef GOOGLE_PROTOBUF_UTIL_WIRE_FORMAT_VALIDATOR_H__
+#define GOOGLE_PROTOBUF_UTIL_WIRE_FORMAT_VALIDATOR_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "google/protobuf/descriptor.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+// The constraints on one field.  Unset members do not constrain it.
+struct FieldConstraints {
+  // For integer and enum fields: the smallest and largest allowed values,
+  // inclusive.  They apply to each element of a repeated field.
+  absl::optional<int64_t> min;
+  absl::optional<int64_t> max;
+  // For string and bytes fields: the largest allowed size in bytes.
+  absl::optional<size_t> max_length;
+  // For repeated fields: the largest number of elements in one message.
+  absl::optional<size_t> max_count;
+};
+
+class PROTOBUF_EXPORT WireFormatValidator {
+ public:
+  // Validates messages of type |descriptor|, which must outlive the validator.
+  explicit WireFormatValidator(const Descriptor* descriptor);
+  WireFormatValidator(const WireFormatValidator&) = delete;
+  WireFormatValidator& operator=(const WireFormatValidator&) = delete;
+
+  // Constrains |field|, a field of the validated type or of any message type
+  // nested in it, in every message in which it occurs.  Replaces the previous
+  // constraints on |field|, if any.  Extensions are not supported.
+  void AddConstraint(const FieldDescriptor* field,
+                     const FieldConstraints& constraints);
+
+  // Checks the serialized message in |data|.  Returns an InvalidArgument
+  // error naming the first field that violates its constraints, or if |data|
+  // is not valid wire format.  Fields whose wire type does not match their
+  // declaration are not checked, since parsing treats them as unknown.
+  absl::Status Validate(absl::string_view data) const;
+
+ private:
+  class Checker;
+
+  // Recomputes the message types that have constrained fields, directly or
+  // in messages nested in them, so that Validate() descends only into those.
+  void UpdateTypesToVisit();
+
+  const Descriptor* descriptor_;
+  absl::flat_hash_map<const FieldDescriptor*, FieldConstraints> constraints_;
+  absl::flat_hash_set<const Descriptor*> types_to_visit_;
+};
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_UTIL_WIRE_FORMAT_VALIDATOR_H__
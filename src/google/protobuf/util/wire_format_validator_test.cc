@@ -0,0 +1,183 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/wire_format_validator.h"
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/unittest.pb.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using ::proto2_unittest::NestedTestAllTypes;
+using ::proto2_unittest::TestAllTypes;
+using ::proto2_unittest::TestPackedTypes;
+using ::testing::HasSubstr;
+
+const FieldDescriptor* FieldOf(const Descriptor* descriptor,
+                               absl::string_view name) {
+  return descriptor->FindFieldByName(name);
+}
+
+FieldConstraints Range(int64_t min, int64_t max) {
+  FieldConstraints constraints;
+  constraints.min = min;
+  constraints.max = max;
+  return constraints;
+}
+
+TEST(WireFormatValidatorTest, ChecksRangesOfNumbers) {
+  const Descriptor* descriptor = TestAllTypes::descriptor();
+  WireFormatValidator validator(descriptor);
+  validator.AddConstraint(FieldOf(descriptor, "optional_int32"), Range(-5, 5));
+  validator.AddConstraint(FieldOf(descriptor, "optional_sint64"), Range(-5, 5));
+  validator.AddConstraint(FieldOf(descriptor, "optional_uint64"), Range(0, 5));
+  validator.AddConstraint(FieldOf(descriptor, "optional_sfixed32"),
+                          Range(-5, 5));
+  validator.AddConstraint(FieldOf(descriptor, "repeated_fixed64"),
+                          Range(0, 5));
+
+  TestAllTypes message;
+  message.set_optional_int32(-5);
+  message.set_optional_sint64(5);
+  message.set_optional_uint64(5);
+  message.set_optional_sfixed32(-5);
+  message.add_repeated_fixed64(0);
+  message.add_repeated_fixed64(5);
+  EXPECT_TRUE(validator.Validate(message.SerializeAsString()).ok());
+
+  TestAllTypes invalid = message;
+  invalid.set_optional_int32(-6);
+  absl::Status status = validator.Validate(invalid.SerializeAsString());
+  EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(status.message(), HasSubstr("optional_int32"));
+
+  invalid = message;
+  invalid.set_optional_sint64(6);
+  EXPECT_FALSE(validator.Validate(invalid.SerializeAsString()).ok());
+  invalid = message;
+  invalid.set_optional_uint64(~uint64_t{0});
+  EXPECT_FALSE(validator.Validate(invalid.SerializeAsString()).ok());
+  invalid = message;
+  invalid.set_optional_sfixed32(-6);
+  EXPECT_FALSE(validator.Validate(invalid.SerializeAsString()).ok());
+  invalid = message;
+  invalid.add_repeated_fixed64(6);
+  EXPECT_FALSE(validator.Validate(invalid.SerializeAsString()).ok());
+}
+
+TEST(WireFormatValidatorTest, ChecksLengthsAndCounts) {
+  const Descriptor* descriptor = TestAllTypes::descriptor();
+  WireFormatValidator validator(descriptor);
+  FieldConstraints strings;
+  strings.max_length = 3;
+  strings.max_count = 2;
+  validator.AddConstraint(FieldOf(descriptor, "repeated_string"), strings);
+  FieldConstraints messages;
+  messages.max_count = 1;
+  validator.AddConstraint(FieldOf(descriptor, "repeated_nested_message"),
+                          messages);
+
+  TestAllTypes message;
+  message.add_repeated_string("abc");
+  message.add_repeated_string("");
+  message.add_repeated_nested_message();
+  EXPECT_TRUE(validator.Validate(message.SerializeAsString()).ok());
+
+  TestAllTypes invalid = message;
+  invalid.set_repeated_string(1, "abcd");
+  EXPECT_THAT(validator.Validate(invalid.SerializeAsString()).message(),
+              HasSubstr("maximum length"));
+  invalid = message;
+  invalid.add_repeated_string("a");
+  EXPECT_THAT(validator.Validate(invalid.SerializeAsString()).message(),
+              HasSubstr("repeated_string"));
+  invalid = message;
+  invalid.add_repeated_nested_message();
+  EXPECT_THAT(validator.Validate(invalid.SerializeAsString()).message(),
+              HasSubstr("repeated_nested_message"));
+}
+
+TEST(WireFormatValidatorTest, ChecksNestedMessages) {
+  const Descriptor* payload = TestAllTypes::descriptor();
+  WireFormatValidator validator(NestedTestAllTypes::descriptor());
+  validator.AddConstraint(FieldOf(payload, "optional_int32"), Range(0, 10));
+  FieldConstraints count;
+  count.max_count = 2;
+  validator.AddConstraint(FieldOf(payload, "repeated_int64"), count);
+
+  NestedTestAllTypes message;
+  message.mutable_payload()->set_optional_int32(10);
+  message.mutable_child()->mutable_payload()->add_repeated_int64(1);
+  message.mutable_child()->mutable_payload()->add_repeated_int64(2);
+  // Counted per message, not across messages.
+  message.mutable_payload()->add_repeated_int64(3);
+  message.mutable_payload()->add_repeated_int64(4);
+  EXPECT_TRUE(validator.Validate(message.SerializeAsString()).ok());
+
+  NestedTestAllTypes invalid = message;
+  invalid.mutable_child()->mutable_child()->mutable_payload()
+      ->set_optional_int32(11);
+  EXPECT_THAT(validator.Validate(invalid.SerializeAsString()).message(),
+              HasSubstr("optional_int32"));
+  invalid = message;
+  invalid.mutable_child()->mutable_payload()->add_repeated_int64(5);
+  EXPECT_THAT(validator.Validate(invalid.SerializeAsString()).message(),
+              HasSubstr("repeated_int64"));
+}
+
+TEST(WireFormatValidatorTest, ChecksPackedElements) {
+  const Descriptor* descriptor = TestPackedTypes::descriptor();
+  WireFormatValidator validator(descriptor);
+  FieldConstraints constraints = Range(-1, 1);
+  constraints.max_count = 3;
+  validator.AddConstraint(FieldOf(descriptor, "packed_sint32"), constraints);
+  validator.AddConstraint(FieldOf(descriptor, "packed_sfixed64"), constraints);
+
+  TestPackedTypes message;
+  message.add_packed_sint32(-1);
+  message.add_packed_sint32(0);
+  message.add_packed_sint32(1);
+  message.add_packed_sfixed64(-1);
+  EXPECT_TRUE(validator.Validate(message.SerializeAsString()).ok());
+
+  TestPackedTypes invalid = message;
+  invalid.add_packed_sint32(0);
+  EXPECT_THAT(validator.Validate(invalid.SerializeAsString()).message(),
+              HasSubstr("packed_sint32"));
+  invalid = message;
+  invalid.add_packed_sfixed64(2);
+  EXPECT_THAT(validator.Validate(invalid.SerializeAsString()).message(),
+              HasSubstr("packed_sfixed64"));
+}
+
+TEST(WireFormatValidatorTest, RejectsInvalidWireFormat) {
+  const Descriptor* descriptor = TestAllTypes::descriptor();
+  WireFormatValidator validator(descriptor);
+  validator.AddConstraint(FieldOf(descriptor, "optional_int32"), Range(0, 1));
+
+  TestAllTypes message;
+  message.set_optional_int32(1);
+  message.set_optional_string("abc");
+  const std::string data = message.SerializeAsString();
+  EXPECT_EQ(validator.Validate(data.substr(0, data.size() - 1)).code(),
+            absl::StatusCode::kInvalidArgument);
+  // Wrong wire type for optional_int32: parsed as an unknown field.
+  EXPECT_TRUE(validator.Validate(std::string("\x0d\x09\x00\x00\x00", 5)).ok());
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,121 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/wire_format_visitor.h"
+
+#include <climits>
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/wire_format_lite.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using internal::WireFormatLite;
+
+class WireFormatWalker {
+ public:
+  explicit WireFormatWalker(WireFormatVisitor* visitor) : visitor_(visitor) {}
+
+  // Visits the fields of the message at |depth| until the current limit of
+  // |input| or, if |group_number| is not zero, until the end-group tag of that
+  // group.
+  bool Walk(io::CodedInputStream* input, int depth, int group_number) {
+    const absl::Span<const int> path(path_, depth);
+    while (input->BytesUntilLimit() > 0) {
+      uint32_t tag = input->ReadTag();
+      int field_number = WireFormatLite::GetTagFieldNumber(tag);
+      if (field_number == 0) return false;
+      switch (WireFormatLite::GetTagWireType(tag)) {
+        case WireFormatLite::WIRETYPE_VARINT: {
+          uint64_t value;
+          if (!input->ReadVarint64(&value)) return false;
+          visitor_->OnVarint(path, field_number, value);
+          break;
+        }
+        case WireFormatLite::WIRETYPE_FIXED32: {
+          uint32_t value;
+          if (!input->ReadLittleEndian32(&value)) return false;
+          visitor_->OnFixed32(path, field_number, value);
+          break;
+        }
+        case WireFormatLite::WIRETYPE_FIXED64: {
+          uint64_t value;
+          if (!input->ReadLittleEndian64(&value)) return false;
+          visitor_->OnFixed64(path, field_number, value);
+          break;
+        }
+        case WireFormatLite::WIRETYPE_LENGTH_DELIMITED: {
+          uint32_t length;
+          if (!input->ReadVarint32(&length)) return false;
+          if (length > static_cast<uint32_t>(input->BytesUntilLimit())) {
+            return false;
+          }
+          int size = static_cast<int>(length);
+          if (visitor_->ShouldDescend(path, field_number)) {
+            if (depth >= kMaxWireFormatVisitorDepth) return false;
+            path_[depth] = field_number;
+            io::CodedInputStream::Limit limit = input->PushLimit(size);
+            if (!Walk(input, depth + 1, 0)) return false;
+            input->PopLimit(limit);
+          } else {
+            // The whole input is one buffer, so the value can be reported in
+            // place.
+            const void* data = nullptr;
+            int available = 0;
+            if (size > 0) input->GetDirectBufferPointer(&data, &available);
+            if (available < size) return false;
+            visitor_->OnLengthDelimited(
+                path, field_number,
+                absl::string_view(static_cast<const char*>(data), size));
+            input->Skip(size);
+          }
+          break;
+        }
+        case WireFormatLite::WIRETYPE_START_GROUP: {
+          if (visitor_->ShouldDescend(path, field_number)) {
+            if (depth >= kMaxWireFormatVisitorDepth) return false;
+            path_[depth] = field_number;
+            if (!Walk(input, depth + 1, field_number)) return false;
+          } else {
+            if (!WireFormatLite::SkipField(input, tag)) return false;
+          }
+          break;
+        }
+        case WireFormatLite::WIRETYPE_END_GROUP:
+          return field_number == group_number;
+        default:
+          return false;
+      }
+    }
+    // Groups must end with their end-group tag, not at a limit.
+    return group_number == 0;
+  }
+
+ private:
+  WireFormatVisitor* visitor_;
+  int path_[kMaxWireFormatVisitorDepth];
+};
+
+}  // namespace
+
+bool VisitWireFormat(absl::string_view data, WireFormatVisitor* visitor) {
+  if (data.size() > INT_MAX) return false;
+  io::CodedInputStream input(reinterpret_cast<const uint8_t*>(data.data()),
+                             static_cast<int>(data.size()));
+  WireFormatWalker walker(visitor);
+  return walker.Walk(&input, 0, 0);
+}
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,79 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Defines a visitor interface for reading fields out of serialized messages
+// without parsing them into message objects.  This is useful when only a few
+// fields of a large message are needed, e.g. to route or filter it: nested
+// messages that are not of interest are skipped over without being decoded,
+// and nothing is allocated.
+
+#ifndef GOOGLE_PROTOBUF_UTIL_WIRE_FORMAT_VISITOR_H__
+#define GOOGLE_PROTOBUF_UTIL_WIRE_FORMAT_VISITOR_H__
+
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+// Receives the fields of a serialized message from VisitWireFormat(), in the
+// order in which they appear on the wire.  Since the wire format does not say
+// how a field was declared, values are reported in their wire representation;
+// for example, a sint32 field is reported as its zigzag-encoded varint and a
+// packed repeated field as its length-delimited bytes.
+//
+// Each callback gets the |path| of the enclosing fields that were descended
+// into, outermost first; it is empty for the fields of the top-level message.
+// The default implementations ignore the field.
+class PROTOBUF_EXPORT WireFormatVisitor {
+ public:
+  virtual ~WireFormatVisitor() = default;
+
+  virtual void OnVarint(absl::Span<const int> path, int field_number,
+                        uint64_t value) {}
+  virtual void OnFixed32(absl::Span<const int> path, int field_number,
+                         uint32_t value) {}
+  virtual void OnFixed64(absl::Span<const int> path, int field_number,
+                         uint64_t value) {}
+
+  // Called for a length-delimited field that is not descended into.  |value|
+  // points into the buffer passed to VisitWireFormat().
+  virtual void OnLengthDelimited(absl::Span<const int> path, int field_number,
+                                 absl::string_view value) {}
+
+  // Returns whether the length-delimited field or group |field_number| should
+  // be visited as a nested message, in which case its fields are reported
+  // with |field_number| appended to |path|.  Otherwise a length-delimited
+  // field is passed to OnLengthDelimited() and a group is skipped.
+  virtual bool ShouldDescend(absl::Span<const int> path, int field_number) {
+    return false;
+  }
+};
+
+// The deepest nesting of messages that VisitWireFormat() descends into.
+inline constexpr int kMaxWireFormatVisitorDepth = 100;
+
+// Reports every field of the serialized message in |data| to |visitor|.
+// Returns false if |data| is not valid wire format, or if descending into it
+// would nest more than kMaxWireFormatVisitorDepth levels deep; the visitor
+// may have received some of the fields by then.
+PROTOBUF_EXPORT bool VisitWireFormat(absl::string_view data,
+                                     WireFormatVisitor* visitor);
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_UTIL_WIRE_FORMAT_VISITOR_H__
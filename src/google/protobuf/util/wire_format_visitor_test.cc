@@ -0,0 +1,165 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/wire_format_visitor.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "google/protobuf/unittest.pb.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using ::testing::ElementsAre;
+
+// Records every callback as "path:field=value" and descends into the fields
+// listed in `descend`, which are given as "path:field" as well.
+class RecordingVisitor : public WireFormatVisitor {
+ public:
+  explicit RecordingVisitor(std::vector<std::string> descend = {})
+      : descend_(std::move(descend)) {}
+
+  void OnVarint(absl::Span<const int> path, int field_number,
+                uint64_t value) override {
+    events_.push_back(absl::StrCat(Name(path, field_number), "=", value));
+  }
+  void OnFixed32(absl::Span<const int> path, int field_number,
+                 uint32_t value) override {
+    events_.push_back(absl::StrCat(Name(path, field_number), "=f", value));
+  }
+  void OnFixed64(absl::Span<const int> path, int field_number,
+                 uint64_t value) override {
+    events_.push_back(absl::StrCat(Name(path, field_number), "=F", value));
+  }
+  void OnLengthDelimited(absl::Span<const int> path, int field_number,
+                         absl::string_view value) override {
+    events_.push_back(absl::StrCat(Name(path, field_number), "='", value, "'"));
+  }
+  bool ShouldDescend(absl::Span<const int> path, int field_number) override {
+    for (const std::string& d : descend_) {
+      if (d == Name(path, field_number)) return true;
+    }
+    return false;
+  }
+
+  const std::vector<std::string>& events() const { return events_; }
+
+ private:
+  static std::string Name(absl::Span<const int> path, int field_number) {
+    return absl::StrCat(absl::StrJoin(path, "."), ":", field_number);
+  }
+
+  std::vector<std::string> descend_;
+  std::vector<std::string> events_;
+};
+
+TEST(WireFormatVisitorTest, VisitsTopLevelFields) {
+  proto2_unittest::TestAllTypes message;
+  message.set_optional_int32(101);
+  message.set_optional_fixed32(107);
+  message.set_optional_fixed64(108);
+  message.set_optional_string("foo");
+  message.mutable_optional_nested_message()->set_bb(118);
+
+  RecordingVisitor visitor;
+  EXPECT_TRUE(VisitWireFormat(message.SerializeAsString(), &visitor));
+  EXPECT_THAT(visitor.events(),
+              ElementsAre(":1=101", ":7=f107", ":8=F108", ":14='foo'",
+                          ":18='\x08\x76'"));
+}
+
+TEST(WireFormatVisitorTest, DescendsIntoSelectedMessages) {
+  proto2_unittest::TestAllTypes message;
+  message.mutable_optional_nested_message()->set_bb(118);
+  message.mutable_optional_foreign_message()->set_c(119);
+  message.mutable_optionalgroup()->set_a(117);
+
+  RecordingVisitor visitor({":18", ":16"});
+  EXPECT_TRUE(VisitWireFormat(message.SerializeAsString(), &visitor));
+  EXPECT_THAT(visitor.events(),
+              ElementsAre("16:17=117", "18:1=118", ":19='\x08\x77'"));
+}
+
+TEST(WireFormatVisitorTest, SkipsGroups) {
+  proto2_unittest::TestAllTypes message;
+  message.mutable_optionalgroup()->set_a(117);
+  message.set_optional_int32(101);
+
+  RecordingVisitor visitor;
+  EXPECT_TRUE(VisitWireFormat(message.SerializeAsString(), &visitor));
+  EXPECT_THAT(visitor.events(), ElementsAre(":1=101"));
+}
+
+TEST(WireFormatVisitorTest, NestedPaths) {
+  proto2_unittest::NestedTestAllTypes message;
+  auto* payload = message.mutable_child()->mutable_child()->mutable_payload();
+  payload->set_optional_int32(5);
+
+  RecordingVisitor visitor({":1", "1:1", "1.1:2"});
+  EXPECT_TRUE(VisitWireFormat(message.SerializeAsString(), &visitor));
+  EXPECT_THAT(visitor.events(), ElementsAre("1.1.2:1=5"));
+}
+
+TEST(WireFormatVisitorTest, RejectsMalformedInput) {
+  RecordingVisitor visitor({":18"});
+  // Zero tag.
+  EXPECT_FALSE(VisitWireFormat(absl::string_view("\0", 1), &visitor));
+  // Truncated varint.
+  EXPECT_FALSE(VisitWireFormat("\x08\x80", &visitor));
+  // Length-delimited field longer than the input.
+  EXPECT_FALSE(VisitWireFormat("\x0a\x05" "abc", &visitor));
+  // Truncated varint in a nested message.
+  EXPECT_FALSE(VisitWireFormat("\x92\x01\x02\x08\x80", &visitor));
+  // Nested message longer than the input.
+  EXPECT_FALSE(VisitWireFormat("\x92\x01\x05\x08\x01", &visitor));
+  // Unterminated group.
+  EXPECT_FALSE(VisitWireFormat("\x83\x01\x08\x01", &visitor));
+  // Unmatched end-group tag.
+  EXPECT_FALSE(VisitWireFormat("\x84\x01", &visitor));
+}
+
+TEST(WireFormatVisitorTest, RejectsDeepNesting) {
+  // Returns a message nested `depth` levels deep in field 1.
+  auto nested = [](int depth) {
+    std::string data;
+    for (int i = 0; i < depth; ++i) {
+      std::string length;
+      uint32_t size = static_cast<uint32_t>(data.size());
+      while (size >= 0x80) {
+        length += static_cast<char>((size & 0x7f) | 0x80);
+        size >>= 7;
+      }
+      length += static_cast<char>(size);
+      data = absl::StrCat("\x0a", length, data);
+    }
+    return data;
+  };
+
+  class DescendAll : public WireFormatVisitor {
+    bool ShouldDescend(absl::Span<const int>, int) override { return true; }
+  };
+  DescendAll visitor;
+  EXPECT_TRUE(VisitWireFormat(nested(kMaxWireFormatVisitorDepth), &visitor));
+  EXPECT_FALSE(
+      VisitWireFormat(nested(kMaxWireFormatVisitorDepth + 1), &visitor));
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
@@ -1391,8 +1391,13 @@ uint8_t* WireFormat::InternalSerializeField(const FieldDescriptor* field,
 
       case FieldDescriptor::TYPE_MESSAGE: {
         auto* msg = get_message_from_field(field, j);
-        target = WireFormatLite::InternalWriteMessage(
-            field->number(), *msg, msg->GetCachedSize(), target, stream);
+        // Generated parents do not cache the size of small leaves.
+        const int size =
+            internal::cpp::IsSmallLeafMessage(field->message_type())
+                ? ToCachedSize(msg->ByteSizeLong())
+                : msg->GetCachedSize();
+        target = WireFormatLite::InternalWriteMessage(field->number(), *msg,
+                                                      size, target, stream);
       } break;
 
       case FieldDescriptor::TYPE_ENUM: {
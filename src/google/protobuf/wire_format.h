@@ -103,8 +103,9 @@ class PROTOBUF_EXPORT WireFormat {
   // Serialize a message in protocol buffer wire format.
   //
   // Any embedded messages within the message must have their correct sizes
-  // cached.  However, the top-level message need not; its size is passed as
-  // a parameter to this procedure.
+  // cached, except for small leaves (see internal::cpp::IsSmallLeafMessage),
+  // which are sized again.  However, the top-level message need not; its size
+  // is passed as a parameter to this procedure.
   //
   // These return false iff the underlying stream returns a write error.
   static void SerializeWithCachedSizes(const Message& message, int size,
@@ -690,7 +690,7 @@ static size_t VarintSize(const T* data, const int n) {
 }
 
 template <bool ZigZag, typename T>
-static size_t VarintSize64(const T* data, const int n) {
+PROTOBUF_ALWAYS_INLINE static size_t VarintSize64(const T* data, const int n) {
   static_assert(sizeof(T) == 8, "This routine only works for 64 bit integers");
   // is_unsigned<T> => !ZigZag
   static_assert(!ZigZag || !std::is_unsigned<T>::value,
@@ -736,7 +736,9 @@ static size_t VarintSize64(const T* data, const int n) {
 // opportunity, so only enable for clang.
 // When last tested, AVX512-vectorized lzcnt was slower than the SSE/AVX2
 // implementation, so __AVX512CD__ is not checked.
-#if defined(__SSE__) && defined(__clang__)
+// NEON provides the same 128-bit compare and subtract sequence as SSE, so the
+// loop vectorizes equally well on arm.
+#if (defined(__SSE__) || defined(__ARM_NEON)) && defined(__clang__)
 size_t WireFormatLite::Int32Size(const RepeatedField<int32_t>& value) {
   return VarintSize<false, true>(value.data(), value.size());
 }
@@ -754,7 +756,7 @@ size_t WireFormatLite::EnumSize(const RepeatedField<int>& value) {
   return VarintSize<false, true>(value.data(), value.size());
 }
 
-#else  // !(defined(__SSE__) && defined(__clang__))
+#else  // !((defined(__SSE__) || defined(__ARM_NEON)) && defined(__clang__))
 
 size_t WireFormatLite::Int32Size(const RepeatedField<int32_t>& value) {
   size_t out = 0;
@@ -809,6 +811,54 @@ size_t WireFormatLite::SInt64Size(const RepeatedField<int64_t>& value) {
   return VarintSize64<true>(value.data(), value.size());
 }
 
+#elif defined(__x86_64__) && defined(__clang__)
+
+// Binaries built for baseline x86-64 still use the vectorized loop on CPUs
+// that have AVX2, which is checked once per process.
+template <bool ZigZag, typename T>
+__attribute__((target("avx2"))) static size_t VarintSize64Avx2(const T* data,
+                                                                const int n) {
+  return VarintSize64<ZigZag>(data, n);
+}
+
+static bool HasAvx2() {
+  static const bool has_avx2 = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+  }();
+  return has_avx2;
+}
+
+size_t WireFormatLite::Int64Size(const RepeatedField<int64_t>& value) {
+  if (HasAvx2()) return VarintSize64Avx2<false>(value.data(), value.size());
+  size_t out = 0;
+  const int n = value.size();
+  for (int i = 0; i < n; i++) {
+    out += Int64Size(value.Get(i));
+  }
+  return out;
+}
+
+size_t WireFormatLite::UInt64Size(const RepeatedField<uint64_t>& value) {
+  if (HasAvx2()) return VarintSize64Avx2<false>(value.data(), value.size());
+  size_t out = 0;
+  const int n = value.size();
+  for (int i = 0; i < n; i++) {
+    out += UInt64Size(value.Get(i));
+  }
+  return out;
+}
+
+size_t WireFormatLite::SInt64Size(const RepeatedField<int64_t>& value) {
+  if (HasAvx2()) return VarintSize64Avx2<true>(value.data(), value.size());
+  size_t out = 0;
+  const int n = value.size();
+  for (int i = 0; i < n; i++) {
+    out += SInt64Size(value.Get(i));
+  }
+  return out;
+}
+
 #else
 
 size_t WireFormatLite::Int64Size(const RepeatedField<int64_t>& value) {
@@ -755,6 +755,11 @@ class PROTOBUF_EXPORT WireFormatLite {
   template <typename MessageType>
   static inline size_t MessageSizeNoVirtual(const MessageType& value);
 
+  // Like MessageSize(), but does not store the size in `value`.  Only for
+  // generated messages that have UncachedByteSizeLong().
+  template <typename MessageType>
+  static inline size_t UncachedMessageSize(const MessageType& value);
+
   // Given the length of data, calculate the byte size of the data on the
   // wire if we encode the data as a length delimited field.
   static inline size_t LengthDelimitedSize(size_t length);
@@ -1911,6 +1916,11 @@ inline size_t WireFormatLite::MessageSizeNoVirtual(
       value.MessageType_WorkAroundCppLookupDefect::ByteSizeLong());
 }
 
+template <typename MessageType>
+inline size_t WireFormatLite::UncachedMessageSize(const MessageType& value) {
+  return LengthDelimitedSize(value.UncachedByteSizeLong());
+}
+
 inline size_t WireFormatLite::LengthDelimitedSize(size_t length) {
   // The static_cast here prevents an error in certain compiler configurations
   // but is not technically correct--if length is too large to fit in a uint32_t
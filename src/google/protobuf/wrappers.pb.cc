@@ -472,6 +472,9 @@ constexpr auto DoubleValue::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(DoubleValue),
                                             alignof(DoubleValue));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    DoubleValue_reflection_data_;
+
 constexpr auto DoubleValue::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -491,6 +494,7 @@ constexpr auto DoubleValue::InternalGenerateClassData_() {
       },
       &DoubleValue::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fwrappers_2eproto,
+      &DoubleValue_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -591,6 +595,13 @@ PROTOBUF_NOINLINE void DoubleValue::Clear() {
 ::size_t DoubleValue::ByteSizeLong() const {
   const DoubleValue& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t DoubleValue::UncachedByteSizeLong() const {
+  const DoubleValue& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.DoubleValue)
   ::size_t total_size = 0;
 
@@ -607,8 +618,11 @@ PROTOBUF_NOINLINE void DoubleValue::Clear() {
       }
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void DoubleValue::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -706,6 +720,9 @@ constexpr auto FloatValue::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(FloatValue),
                                             alignof(FloatValue));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    FloatValue_reflection_data_;
+
 constexpr auto FloatValue::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -725,6 +742,7 @@ constexpr auto FloatValue::InternalGenerateClassData_() {
       },
       &FloatValue::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fwrappers_2eproto,
+      &FloatValue_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -825,6 +843,13 @@ PROTOBUF_NOINLINE void FloatValue::Clear() {
 ::size_t FloatValue::ByteSizeLong() const {
   const FloatValue& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t FloatValue::UncachedByteSizeLong() const {
+  const FloatValue& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.FloatValue)
   ::size_t total_size = 0;
 
@@ -841,8 +866,11 @@ PROTOBUF_NOINLINE void FloatValue::Clear() {
       }
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void FloatValue::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -940,6 +968,9 @@ constexpr auto Int64Value::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(Int64Value),
                                             alignof(Int64Value));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Int64Value_reflection_data_;
+
 constexpr auto Int64Value::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -959,6 +990,7 @@ constexpr auto Int64Value::InternalGenerateClassData_() {
       },
       &Int64Value::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fwrappers_2eproto,
+      &Int64Value_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -1059,6 +1091,13 @@ PROTOBUF_NOINLINE void Int64Value::Clear() {
 ::size_t Int64Value::ByteSizeLong() const {
   const Int64Value& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t Int64Value::UncachedByteSizeLong() const {
+  const Int64Value& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.Int64Value)
   ::size_t total_size = 0;
 
@@ -1076,8 +1115,11 @@ PROTOBUF_NOINLINE void Int64Value::Clear() {
       }
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void Int64Value::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -1175,6 +1217,9 @@ constexpr auto UInt64Value::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(UInt64Value),
                                             alignof(UInt64Value));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    UInt64Value_reflection_data_;
+
 constexpr auto UInt64Value::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -1194,6 +1239,7 @@ constexpr auto UInt64Value::InternalGenerateClassData_() {
       },
       &UInt64Value::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fwrappers_2eproto,
+      &UInt64Value_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -1294,6 +1340,13 @@ PROTOBUF_NOINLINE void UInt64Value::Clear() {
 ::size_t UInt64Value::ByteSizeLong() const {
   const UInt64Value& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t UInt64Value::UncachedByteSizeLong() const {
+  const UInt64Value& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.UInt64Value)
   ::size_t total_size = 0;
 
@@ -1311,8 +1364,11 @@ PROTOBUF_NOINLINE void UInt64Value::Clear() {
       }
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void UInt64Value::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -1410,6 +1466,9 @@ constexpr auto Int32Value::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(Int32Value),
                                             alignof(Int32Value));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    Int32Value_reflection_data_;
+
 constexpr auto Int32Value::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -1429,6 +1488,7 @@ constexpr auto Int32Value::InternalGenerateClassData_() {
       },
       &Int32Value::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fwrappers_2eproto,
+      &Int32Value_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -1529,6 +1589,13 @@ PROTOBUF_NOINLINE void Int32Value::Clear() {
 ::size_t Int32Value::ByteSizeLong() const {
   const Int32Value& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t Int32Value::UncachedByteSizeLong() const {
+  const Int32Value& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.Int32Value)
   ::size_t total_size = 0;
 
@@ -1546,8 +1613,11 @@ PROTOBUF_NOINLINE void Int32Value::Clear() {
       }
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void Int32Value::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -1645,6 +1715,9 @@ constexpr auto UInt32Value::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(UInt32Value),
                                             alignof(UInt32Value));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    UInt32Value_reflection_data_;
+
 constexpr auto UInt32Value::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -1664,6 +1737,7 @@ constexpr auto UInt32Value::InternalGenerateClassData_() {
       },
       &UInt32Value::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fwrappers_2eproto,
+      &UInt32Value_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -1764,6 +1838,13 @@ PROTOBUF_NOINLINE void UInt32Value::Clear() {
 ::size_t UInt32Value::ByteSizeLong() const {
   const UInt32Value& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t UInt32Value::UncachedByteSizeLong() const {
+  const UInt32Value& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.UInt32Value)
   ::size_t total_size = 0;
 
@@ -1781,8 +1862,11 @@ PROTOBUF_NOINLINE void UInt32Value::Clear() {
       }
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void UInt32Value::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -1880,6 +1964,9 @@ constexpr auto BoolValue::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::ZeroInit(sizeof(BoolValue),
                                             alignof(BoolValue));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    BoolValue_reflection_data_;
+
 constexpr auto BoolValue::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -1899,6 +1986,7 @@ constexpr auto BoolValue::InternalGenerateClassData_() {
       },
       &BoolValue::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fwrappers_2eproto,
+      &BoolValue_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -1999,6 +2087,13 @@ PROTOBUF_NOINLINE void BoolValue::Clear() {
 ::size_t BoolValue::ByteSizeLong() const {
   const BoolValue& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t BoolValue::UncachedByteSizeLong() const {
+  const BoolValue& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.BoolValue)
   ::size_t total_size = 0;
 
@@ -2015,8 +2110,11 @@ PROTOBUF_NOINLINE void BoolValue::Clear() {
       }
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void BoolValue::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -2128,6 +2226,9 @@ constexpr auto StringValue::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(StringValue),
                                             alignof(StringValue));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    StringValue_reflection_data_;
+
 constexpr auto StringValue::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -2147,6 +2248,7 @@ constexpr auto StringValue::InternalGenerateClassData_() {
       },
       &StringValue::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fwrappers_2eproto,
+      &StringValue_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -2254,6 +2356,13 @@ PROTOBUF_NOINLINE void StringValue::Clear() {
 ::size_t StringValue::ByteSizeLong() const {
   const StringValue& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t StringValue::UncachedByteSizeLong() const {
+  const StringValue& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.StringValue)
   ::size_t total_size = 0;
 
@@ -2271,8 +2380,11 @@ PROTOBUF_NOINLINE void StringValue::Clear() {
       }
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void StringValue::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -2390,6 +2502,9 @@ constexpr auto BytesValue::InternalNewImpl_() {
   return ::google::protobuf::internal::MessageCreator::CopyInit(sizeof(BytesValue),
                                             alignof(BytesValue));
 }
+PROTOBUF_CONSTINIT static ::google::protobuf::internal::ClassDataFull::ReflectionData
+    BytesValue_reflection_data_;
+
 constexpr auto BytesValue::InternalGenerateClassData_() {
   return ::google::protobuf::internal::ClassDataFull{
       ::google::protobuf::internal::ClassData{
@@ -2409,6 +2524,7 @@ constexpr auto BytesValue::InternalGenerateClassData_() {
       },
       &BytesValue::kDescriptorMethods,
       &descriptor_table_google_2fprotobuf_2fwrappers_2eproto,
+      &BytesValue_reflection_data_,
       nullptr,  // tracker
   };
 }
@@ -2511,6 +2627,13 @@ PROTOBUF_NOINLINE void BytesValue::Clear() {
 ::size_t BytesValue::ByteSizeLong() const {
   const BytesValue& this_ = *this;
 #endif  // PROTOBUF_CUSTOM_VTABLE
+  const ::size_t total_size = this_.UncachedByteSizeLong();
+  this_._impl_._cached_size_.Set(::_pbi::ToCachedSize(total_size));
+  return total_size;
+}
+
+::size_t BytesValue::UncachedByteSizeLong() const {
+  const BytesValue& this_ = *this;
   // @@protoc_insertion_point(message_byte_size_start:google.protobuf.BytesValue)
   ::size_t total_size = 0;
 
@@ -2528,8 +2651,11 @@ PROTOBUF_NOINLINE void BytesValue::Clear() {
       }
     }
   }
-  return this_.MaybeComputeUnknownFieldsSize(total_size,
-                                             &this_._impl_._cached_size_);
+  if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
+    total_size += ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        this_._internal_metadata_.unknown_fields<::google::protobuf::UnknownFieldSet>(::google::protobuf::UnknownFieldSet::default_instance));
+  }
+  return total_size;
 }
 
 void BytesValue::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::google::protobuf::MessageLite& from_msg) {
@@ -29,6 +29,19 @@
 #define FORCE_INLINE_ATTR
 #endif
 
+/* When the library is built for a baseline x86-64 target (no -msse4.1), the
+ * SSE4.1 kernel is still compiled, with a function level target attribute, and
+ * selected at run time if the CPU supports it. Define
+ * UTF8_RANGE_DISABLE_RUNTIME_DISPATCH to always use the portable code instead.
+ */
+#if !defined(__SSE4_1__) && defined(__x86_64__) && defined(__GNUC__) && \
+    !defined(UTF8_RANGE_DISABLE_RUNTIME_DISPATCH)
+#define UTF8_RANGE_SSE_RUNTIME_DISPATCH 1
+#define UTF8_RANGE_SIMD_ATTR __attribute__((target("sse4.1"), noinline))
+#else
+#define UTF8_RANGE_SIMD_ATTR FORCE_INLINE_ATTR inline
+#endif
+
 static FORCE_INLINE_ATTR inline uint64_t utf8_range_UnalignedLoad64(
     const void* p) {
   uint64_t t;
@@ -137,7 +150,8 @@ static size_t utf8_range_ValidateUTF8Naive(const char* data, const char* end,
   return err_pos + (1 - return_position);
 }
 
-#if defined(__SSE4_1__) || (defined(__ARM_NEON) && defined(__ARM_64BIT_STATE))
+#if defined(__SSE4_1__) || defined(UTF8_RANGE_SSE_RUNTIME_DISPATCH) || \
+    (defined(__ARM_NEON) && defined(__ARM_64BIT_STATE))
 /* Returns the number of bytes needed to skip backwards to get to the first
    byte of codepoint.
  */
@@ -169,12 +183,27 @@ static inline const char* utf8_range_SkipAscii(const char* data,
   return data;
 }
 
-#if defined(__SSE4_1__)
+#if defined(__SSE4_1__) || defined(UTF8_RANGE_SSE_RUNTIME_DISPATCH)
 #include "utf8_range_sse.inc"
 #elif defined(__ARM_NEON) && defined(__ARM_64BIT_STATE)
 #include "utf8_range_neon.inc"
 #endif
 
+#if defined(UTF8_RANGE_SSE_RUNTIME_DISPATCH)
+/* The result of the CPUID check is cached; racing initializations all store
+   the same value. */
+static int utf8_range_HasSse41(void) {
+  static volatile int has_sse41 = -1;
+  int result = has_sse41;
+  if (result < 0) {
+    __builtin_cpu_init();
+    result = __builtin_cpu_supports("sse4.1") ? 1 : 0;
+    has_sse41 = result;
+  }
+  return result;
+}
+#endif
+
 static FORCE_INLINE_ATTR inline size_t utf8_range_Validate(
     const char* data, size_t len, int return_position) {
   if (len == 0) return 1 - return_position;
@@ -193,6 +222,12 @@ static FORCE_INLINE_ATTR inline size_t utf8_range_Validate(
   return utf8_range_ValidateUTF8Simd(
       data_original, data, end, return_position);
 #else
+#if defined(UTF8_RANGE_SSE_RUNTIME_DISPATCH)
+  if (utf8_range_HasSse41()) {
+    return utf8_range_ValidateUTF8Simd(data_original, data, end,
+                                       return_position);
+  }
+#endif
   return (return_position ? (data - data_original) : 0) +
          utf8_range_ValidateUTF8Naive(data, end, return_position);
 #endif
@@ -76,7 +76,12 @@ typedef bool eqlfunc_t(upb_tabkey k1, lookupkey_t k2);
 
 /* Base table (shared code) ***************************************************/
 
-static uint32_t upb_inthash(uintptr_t key) { return (uint32_t)key; }
+// Multiplicative (Fibonacci) hashing. Sequential keys still land in distinct
+// main positions, and pointer keys, whose low bits are mostly zero, are spread
+// over the whole table instead of every eighth or sixteenth entry.
+static uint32_t upb_inthash(uintptr_t key) {
+  return (uint32_t)(((uint64_t)key * 0x9E3779B97F4A7C15) >> 32);
+}
 
 static const upb_tabent* upb_getentry(const upb_table* t, uint32_t hash) {
   return t->entries + (hash & t->mask);
@@ -446,16 +451,34 @@ bool upb_strtable_resize(upb_strtable* t, size_t size_lg2, upb_Arena* a) {
   upb_strtable new_table;
   if (!init(&new_table.t, size_lg2, a)) return false;
 
-  intptr_t iter = UPB_STRTABLE_BEGIN;
-  upb_StringView key;
-  upb_value val;
-  while (upb_strtable_next2(t, &key, &val, &iter)) {
-    upb_strtable_insert(&new_table, key.data, key.size, val, a);
+  // The keys were already copied into an arena by upb_strtable_insert(), so
+  // they move to the new table as they are.
+  const size_t size = upb_table_size(&t->t);
+  for (size_t i = 0; i < size; i++) {
+    const upb_tabent* e = &t->t.entries[i];
+    if (upb_tabent_isempty(e)) continue;
+    uint32_t len;
+    char* str = upb_tabstr(e->key, &len);
+    upb_value val;
+    _upb_value_setval(&val, e->val.val);
+    insert(&new_table.t, strkey2(str, len), e->key, val,
+           _upb_Hash_NoSeed(str, len), &strhash, &streql);
   }
   *t = new_table;
   return true;
 }
 
+bool upb_strtable_reserve(upb_strtable* t, size_t count, upb_Arena* a) {
+  const size_t need = t->t.count + count;
+  if (need <= t->t.max_count) return true;
+  // Like upb_strtable_init(), but at least doubling so that repeated calls
+  // stay amortized.
+  size_t need_entries = (need + 1) * 1204 / 1024;
+  int size_lg2 = upb_Log2Ceiling(need_entries);
+  if (size_lg2 <= t->t.size_lg2) size_lg2 = t->t.size_lg2 + 1;
+  return upb_strtable_resize(t, size_lg2, a);
+}
+
 bool upb_strtable_insert(upb_strtable* t, const char* k, size_t len,
                          upb_value v, upb_Arena* a) {
   lookupkey_t key;
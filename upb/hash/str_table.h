@@ -41,6 +41,11 @@ void upb_strtable_clear(upb_strtable* t);
 bool upb_strtable_insert(upb_strtable* t, const char* key, size_t len,
                          upb_value val, upb_Arena* a);
 
+// Grows the table, if needed, so that `count` more keys can be inserted without
+// resizing it.  Returns false if memory allocation failed, leaving the table
+// unchanged.
+bool upb_strtable_reserve(upb_strtable* t, size_t count, upb_Arena* a);
+
 // Looks up key in this table, returning "true" if the key was found.
 // If v is non-NULL, copies the value for this key into *v.
 bool upb_strtable_lookup2(const upb_strtable* t, const char* key, size_t len,
@@ -229,6 +229,34 @@ TEST(Table, Delete) {
   }
 }
 
+TEST(Table, Reserve) {
+  upb::Arena arena;
+  upb_strtable t;
+  upb_strtable_init(&t, 0, arena.ptr());
+  std::vector<std::string> keys;
+  for (int i = 0; i < 1000; i++) keys.push_back(std::to_string(i));
+
+  EXPECT_TRUE(upb_strtable_reserve(&t, keys.size(), arena.ptr()));
+  const upb_tabent* entries = t.t.entries;
+  for (const auto& key : keys) {
+    EXPECT_TRUE(upb_strtable_insert(&t, key.data(), key.size(),
+                                    upb_value_int32(key.size()), arena.ptr()));
+  }
+  // No resize happened.
+  EXPECT_EQ(t.t.entries, entries);
+
+  // Keys survive a resize.
+  size_t room = t.t.max_count - t.t.count;
+  EXPECT_TRUE(upb_strtable_reserve(&t, room + 1, arena.ptr()));
+  EXPECT_NE(t.t.entries, entries);
+  for (const auto& key : keys) {
+    upb_value val;
+    EXPECT_TRUE(upb_strtable_lookup2(&t, key.data(), key.size(), &val));
+    EXPECT_EQ(upb_value_getint32(val), key.size());
+  }
+  EXPECT_EQ(upb_strtable_count(&t), keys.size());
+}
+
 TEST(Table, Init) {
   for (int i = 0; i < 2048; i++) {
     /* Tests that the size calculations in init() (lg2 size for target load)
@@ -23,6 +23,7 @@
 #include "upb/base/status.h"
 #include "upb/base/string_view.h"
 #include "upb/lex/atoi.h"
+#include "upb/lex/json_string.h"
 #include "upb/lex/unicode.h"
 #include "upb/mem/arena.h"
 #include "upb/message/array.h"
@@ -446,6 +447,18 @@ static upb_StringView jsondec_string(jsondec* d) {
   }
 
   while (d->ptr < d->end) {
+    /* Copy runs without escapes at once, leaving room for the terminator. */
+    size_t run = upb_JsonString_PlainPrefix(d->ptr, d->end);
+    if (run > 0) {
+      while ((size_t)(buf_end - end) <= run) {
+        jsondec_resize(d, &buf, &end, &buf_end);
+      }
+      memcpy(end, d->ptr, run);
+      end += run;
+      d->ptr += run;
+      continue;
+    }
+
     char ch = *d->ptr++;
 
     if (end == buf_end) {
@@ -13,6 +13,7 @@
 #include "google/protobuf/struct.upb.h"
 #include <gtest/gtest.h>
 #include "upb/base/status.hpp"
+#include "upb/base/string_view.h"
 #include "upb/base/upcast.h"
 #include "upb/json/test.upb.h"
 #include "upb/json/test.upbdefs.h"
@@ -97,3 +98,16 @@ TEST(JsonTest, AcceptsTrailingWhitespace) {
   upb_test_Box* box = JsonDecode(json_string.c_str(), a.ptr());
   EXPECT_NE(box, nullptr);
 }
+
+TEST(JsonTest, DecodeStringsWithEscapesBetweenRuns) {
+  upb::Arena a;
+  upb_test_Box* box = JsonDecode(
+      R"({"name": "abcdefghijklmnopqrstuvwxyz\n0123456789\"é\\xy"})",
+      a.ptr());
+  ASSERT_NE(box, nullptr);
+  upb_StringView name = upb_test_Box_name(box);
+  EXPECT_EQ(std::string(name.data, name.size),
+            "abcdefghijklmnopqrstuvwxyz\n0123456789\"\xc3\xa9\\xy");
+
+  EXPECT_EQ(JsonDecode("{\"name\": \"abcdefghij\x01\"}", a.ptr()), nullptr);
+}
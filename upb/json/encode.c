@@ -14,6 +14,7 @@
 #include <stdarg.h>
 #include <string.h>
 
+#include "upb/lex/json_string.h"
 #include "upb/lex/round_trip.h"
 #include "upb/message/map.h"
 #include "upb/port/vsnprintf_compat.h"
@@ -256,6 +257,15 @@ static void jsonenc_stringbody(jsonenc* e, upb_StringView str) {
   const char* end = UPB_PTRADD(ptr, str.size);
 
   while (ptr < end) {
+    /* Copy runs that need no escaping at once.  Non-ASCII bytes are copied
+     * as-is; we rely on the string being valid UTF-8. */
+    size_t run = upb_JsonString_PlainPrefix(ptr, end);
+    if (run > 0) {
+      jsonenc_putbytes(e, ptr, run);
+      ptr += run;
+      continue;
+    }
+
     switch (*ptr) {
       case '\n':
         jsonenc_putstr(e, "\\n");
@@ -279,13 +289,8 @@ static void jsonenc_stringbody(jsonenc* e, upb_StringView str) {
         jsonenc_putstr(e, "\\\\");
         break;
       default:
-        if ((uint8_t)*ptr < 0x20) {
-          jsonenc_printf(e, "\\u%04x", (int)(uint8_t)*ptr);
-        } else {
-          /* This could be a non-ASCII byte.  We rely on the string being valid
-           * UTF-8. */
-          jsonenc_putbytes(e, ptr, 1);
-        }
+        /* Only control characters are left. */
+        jsonenc_printf(e, "\\u%04x", (int)(uint8_t)*ptr);
         break;
     }
     ptr++;
@@ -13,6 +13,7 @@
 #include "google/protobuf/struct.upb.h"
 #include <gtest/gtest.h>
 #include "upb/base/status.hpp"
+#include "upb/base/string_view.h"
 #include "upb/base/upcast.h"
 #include "upb/json/test.upb.h"
 #include "upb/json/test.upbdefs.h"
@@ -96,3 +97,16 @@ TEST(JsonTest, EncodeConflictJsonName) {
   upb_test_Box_set_new_value(new_box, 2);
   EXPECT_EQ(R"({"value":2})", JsonEncode(new_box, 0));
 }
+
+TEST(JsonTest, EncodeStringsWithEscapesBetweenRuns) {
+  upb::Arena a;
+  upb_test_Box* box = upb_test_Box_new(a.ptr());
+  std::string name("abcdefghijklmnopqrstuvwxyz\n0123456789\"\xc3\xa9\\\x01xy");
+  upb_test_Box_set_name(box,
+                        upb_StringView_FromDataAndSize(name.data(), name.size()));
+  EXPECT_EQ(
+      R"({"name":"abcdefghijklmnopqrstuvwxyz\n0123456789\")"
+      "\xc3\xa9"
+      R"(\\\u0001xy"})",
+      JsonEncode(box, 0));
+}
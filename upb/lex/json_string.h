@@ -0,0 +1,62 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2023 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef UPB_LEX_JSON_STRING_H_
+#define UPB_LEX_JSON_STRING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Must be last.
+#include "upb/port/def.inc"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Returns true iff the byte can appear in a JSON string as is, ie. it is not a
+// control character, a quote or a backslash. Non-ASCII bytes are plain.
+UPB_INLINE bool upb_JsonString_IsPlain(char ch) {
+  uint8_t c = (uint8_t)ch;
+  return c >= 0x20 && c != '"' && c != '\\';
+}
+
+// Returns the number of plain bytes at the start of [ptr, end), checking
+// eight bytes at a time. Strings are mostly plain, so encoders and decoders can
+// copy the whole run at once.
+UPB_INLINE size_t upb_JsonString_PlainPrefix(const char* ptr,
+                                             const char* end) {
+  const uint64_t kOnes = 0x0101010101010101ULL;
+  const uint64_t kHighBits = 0x8080808080808080ULL;
+  const char* start = ptr;
+
+  while (end - ptr >= 8) {
+    uint64_t word;
+    memcpy(&word, ptr, 8);
+    // Each of these has the high bit of a byte set if that byte is a control
+    // character, a quote, or a backslash respectively, and only then.
+    uint64_t ctrl = (word - 0x20 * kOnes) & ~word;
+    uint64_t quote = word ^ ('"' * kOnes);
+    uint64_t backslash = word ^ ('\\' * kOnes);
+    quote = (quote - kOnes) & ~quote;
+    backslash = (backslash - kOnes) & ~backslash;
+    if ((ctrl | quote | backslash) & kHighBits) break;
+    ptr += 8;
+  }
+
+  while (ptr < end && upb_JsonString_IsPlain(*ptr)) ptr++;
+  return (size_t)(ptr - start);
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#include "upb/port/undef.inc"
+
+#endif /* UPB_LEX_JSON_STRING_H_ */
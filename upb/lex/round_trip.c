@@ -9,8 +9,10 @@
 
 #include <float.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // Must be last.
 #include "upb/port/def.inc"
@@ -28,12 +30,25 @@ static void upb_FixLocale(char* p) {
   }
 }
 
+// With a precision of N, printf("%.*g") prints integers below 10^N exactly and
+// without an exponent, so those can skip printf() and the strtod() round trip
+// check.  `limit` is 10^N.  Negative zero still goes through printf().
+static bool upb_EncodeIntegral(double val, double limit, char* buf) {
+  if (!(val > -limit && val < limit) || val != (double)(int64_t)val ||
+      (val == 0 && signbit(val))) {
+    return false;
+  }
+  buf[_upb_EncodeInt64((int64_t)val, buf)] = '\0';
+  return true;
+}
+
 void _upb_EncodeRoundTripDouble(double val, char* buf, size_t size) {
   assert(size >= kUpb_RoundTripBufferSize);
   if (isnan(val)) {
     snprintf(buf, size, "%s", "nan");
     return;
   }
+  if (upb_EncodeIntegral(val, 1e15, buf)) return;  // DBL_DIG digits.
   snprintf(buf, size, "%.*g", DBL_DIG, val);
   if (strtod(buf, NULL) != val) {
     snprintf(buf, size, "%.*g", DBL_DIG + 2, val);
@@ -48,6 +63,7 @@ void _upb_EncodeRoundTripFloat(float val, char* buf, size_t size) {
     snprintf(buf, size, "%s", "nan");
     return;
   }
+  if (upb_EncodeIntegral(val, 1e6, buf)) return;  // FLT_DIG digits.
   snprintf(buf, size, "%.*g", FLT_DIG, val);
   if (strtof(buf, NULL) != val) {
     snprintf(buf, size, "%.*g", FLT_DIG + 3, val);
@@ -55,3 +71,38 @@ void _upb_EncodeRoundTripFloat(float val, char* buf, size_t size) {
   }
   upb_FixLocale(buf);
 }
+
+/* Integers *******************************************************************/
+
+static const char kUpb_DecimalPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536"
+    "37383940414243444546474849505152535455565758596061626364656667686970717273"
+    "7475767778798081828384858687888990919293949596979899";
+
+size_t _upb_EncodeUInt64(uint64_t val, char* buf) {
+  // Digits are produced from the end, two at a time, then moved to the front.
+  char tmp[20];
+  char* end = tmp + sizeof(tmp);
+  char* p = end;
+  while (val >= 100) {
+    p -= 2;
+    memcpy(p, &kUpb_DecimalPairs[(val % 100) * 2], 2);
+    val /= 100;
+  }
+  if (val >= 10) {
+    p -= 2;
+    memcpy(p, &kUpb_DecimalPairs[val * 2], 2);
+  } else {
+    *--p = (char)('0' + val);
+  }
+  const size_t n = end - p;
+  memcpy(buf, p, n);
+  return n;
+}
+
+size_t _upb_EncodeInt64(int64_t val, char* buf) {
+  if (val >= 0) return _upb_EncodeUInt64(val, buf);
+  buf[0] = '-';
+  // Negating as unsigned is well defined for INT64_MIN.
+  return 1 + _upb_EncodeUInt64(0 - (uint64_t)val, buf + 1);
+}
@@ -8,6 +8,9 @@
 #ifndef UPB_LEX_ROUND_TRIP_H_
 #define UPB_LEX_ROUND_TRIP_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 // Must be last.
 #include "upb/port/def.inc"
 
@@ -26,6 +29,12 @@ extern "C" {
 void _upb_EncodeRoundTripDouble(double val, char* buf, size_t size);
 void _upb_EncodeRoundTripFloat(float val, char* buf, size_t size);
 
+// Writes `val` in decimal, like printf("%" PRIu64) but without the NUL
+// terminator or format parsing, and returns the number of bytes written.  The
+// buffer must hold at least kUpb_RoundTripBufferSize bytes.
+size_t _upb_EncodeUInt64(uint64_t val, char* buf);
+size_t _upb_EncodeInt64(int64_t val, char* buf);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -1,6 +1,9 @@
 #include "upb/lex/round_trip.h"
 
 #include <math.h>
+#include <stdint.h>
+
+#include <string>
 
 #include <gtest/gtest.h>
 
@@ -19,6 +22,25 @@ TEST(RoundTripTest, Double) {
   EXPECT_STREQ(buf, "nan");
 }
 
+TEST(RoundTripTest, IntegralDouble) {
+  char buf[32];
+
+  _upb_EncodeRoundTripDouble(-0.0, buf, sizeof(buf));
+  EXPECT_STREQ(buf, "-0");
+
+  _upb_EncodeRoundTripDouble(-12345, buf, sizeof(buf));
+  EXPECT_STREQ(buf, "-12345");
+
+  _upb_EncodeRoundTripDouble(999999999999999, buf, sizeof(buf));
+  EXPECT_STREQ(buf, "999999999999999");
+
+  _upb_EncodeRoundTripDouble(1e15, buf, sizeof(buf));
+  EXPECT_STREQ(buf, "1e+15");
+
+  _upb_EncodeRoundTripDouble(INFINITY, buf, sizeof(buf));
+  EXPECT_STREQ(buf, "inf");
+}
+
 TEST(RoundTripTest, Float) {
   char buf[32];
 
@@ -32,4 +54,45 @@ TEST(RoundTripTest, Float) {
   EXPECT_STREQ(buf, "nan");
 }
 
+TEST(RoundTripTest, IntegralFloat) {
+  char buf[32];
+
+  _upb_EncodeRoundTripFloat(999999, buf, sizeof(buf));
+  EXPECT_STREQ(buf, "999999");
+
+  _upb_EncodeRoundTripFloat(1e6, buf, sizeof(buf));
+  EXPECT_STREQ(buf, "1e+06");
+
+  _upb_EncodeRoundTripFloat(16777216, buf, sizeof(buf));
+  EXPECT_STREQ(buf, "16777216");
+}
+
+std::string EncodeUInt64(uint64_t val) {
+  char buf[32];
+  return std::string(buf, _upb_EncodeUInt64(val, buf));
+}
+
+std::string EncodeInt64(int64_t val) {
+  char buf[32];
+  return std::string(buf, _upb_EncodeInt64(val, buf));
+}
+
+TEST(RoundTripTest, Integers) {
+  EXPECT_EQ(EncodeUInt64(0), "0");
+  EXPECT_EQ(EncodeUInt64(7), "7");
+  EXPECT_EQ(EncodeUInt64(10), "10");
+  EXPECT_EQ(EncodeUInt64(105), "105");
+  EXPECT_EQ(EncodeUInt64(UINT64_MAX), "18446744073709551615");
+  EXPECT_EQ(EncodeInt64(0), "0");
+  EXPECT_EQ(EncodeInt64(-1), "-1");
+  EXPECT_EQ(EncodeInt64(INT64_MAX), "9223372036854775807");
+  EXPECT_EQ(EncodeInt64(INT64_MIN), "-9223372036854775808");
+
+  for (uint64_t val = 1; val < UINT64_MAX / 3; val = val * 3 + 1) {
+    EXPECT_EQ(EncodeUInt64(val), std::to_string(val));
+    EXPECT_EQ(EncodeInt64(-static_cast<int64_t>(val)),
+              std::to_string(-static_cast<int64_t>(val)));
+  }
+}
+
 }  // namespace
@@ -33,6 +33,107 @@ typedef struct upb_MemBlock {
   // Data follows.
 } upb_MemBlock;
 
+static UPB_ATOMIC(size_t) g_block_cache_limit = 0;
+
+void upb_Arena_SetBlockCacheLimit(size_t max) {
+  upb_Atomic_Store(&g_block_cache_limit, max, memory_order_relaxed);
+}
+
+#ifdef UPB_THREAD_LOCAL
+
+// Blocks larger than this are never cached.
+#define kUpb_BlockCache_MaxSizeClass 20
+
+typedef struct {
+  // Freed blocks of size (1 << i), linked through upb_MemBlock.next.
+  upb_MemBlock* free[kUpb_BlockCache_MaxSizeClass + 1];
+  size_t bytes;
+} upb_BlockCache;
+
+static UPB_THREAD_LOCAL upb_BlockCache g_block_cache;
+
+static int _upb_BlockCache_SizeClass(size_t size) {
+  int size_class = 0;
+  while (((size_t)1 << size_class) < size) size_class++;
+  return size_class;
+}
+
+static bool _upb_BlockCache_Enabled(upb_alloc* alloc, size_t* limit) {
+  if (alloc != &upb_alloc_global) return false;
+  // Relaxed order is safe here as we don't need any ordering with the setter.
+  *limit = upb_Atomic_Load(&g_block_cache_limit, memory_order_relaxed);
+  return *limit != 0;
+}
+
+#endif  // UPB_THREAD_LOCAL
+
+// Allocates a block of at least `*size` bytes and sets `*size` to its actual
+// size.
+static void* _upb_Arena_MallocBlock(upb_alloc* alloc, size_t* size) {
+#ifdef UPB_THREAD_LOCAL
+  size_t limit;
+  if (_upb_BlockCache_Enabled(alloc, &limit) &&
+      *size <= ((size_t)1 << kUpb_BlockCache_MaxSizeClass)) {
+    int size_class = _upb_BlockCache_SizeClass(*size);
+    *size = (size_t)1 << size_class;
+    upb_MemBlock* block = g_block_cache.free[size_class];
+    if (block) {
+      g_block_cache.free[size_class] = block->next;
+      g_block_cache.bytes -= *size;
+      // The previous arena poisoned the parts it did not allocate.
+      UPB_UNPOISON_MEMORY_REGION(block, *size);
+      return block;
+    }
+  }
+#endif
+  return upb_malloc(alloc, *size);
+}
+
+static void _upb_Arena_FreeBlock(upb_alloc* alloc, upb_MemBlock* block,
+                                 size_t size) {
+#ifdef UPB_THREAD_LOCAL
+  size_t limit;
+  if (_upb_BlockCache_Enabled(alloc, &limit) &&
+      size <= ((size_t)1 << kUpb_BlockCache_MaxSizeClass) &&
+      (size & (size - 1)) == 0 && g_block_cache.bytes + size <= limit) {
+    int size_class = _upb_BlockCache_SizeClass(size);
+    block->next = g_block_cache.free[size_class];
+    g_block_cache.free[size_class] = block;
+    g_block_cache.bytes += size;
+    return;
+  }
+#endif
+  upb_free_sized(alloc, block, size);
+}
+
+void upb_Arena_ReleaseBlockCache(void) {
+#ifdef UPB_THREAD_LOCAL
+  for (int i = 0; i <= kUpb_BlockCache_MaxSizeClass; i++) {
+    upb_MemBlock* block = g_block_cache.free[i];
+    while (block != NULL) {
+      upb_MemBlock* next = block->next;
+      upb_free_sized(&upb_alloc_global, block, (size_t)1 << i);
+      block = next;
+    }
+    g_block_cache.free[i] = NULL;
+  }
+  g_block_cache.bytes = 0;
+#endif
+}
+
+size_t upb_Arena_BlockCacheBytes(void) {
+#ifdef UPB_THREAD_LOCAL
+  return g_block_cache.bytes;
+#else
+  return 0;
+#endif
+}
+
+typedef struct upb_ArenaRef {
+  struct upb_ArenaRef* next;
+  const upb_Arena* arena;
+} upb_ArenaRef;
+
 typedef struct upb_ArenaInternal {
   // upb_alloc* together with a low bit which signals if there is an initial
   // block.
@@ -64,6 +165,10 @@ typedef struct upb_ArenaInternal {
   // Linked list of blocks to free/cleanup.
   upb_MemBlock* blocks;
 
+  // Arenas referenced with upb_Arena_RefArena(), released when this arena is
+  // freed. The list nodes live in `blocks`.
+  upb_ArenaRef* refs;
+
   // Total space allocated in blocks, atomic only for SpaceAllocated
   UPB_ATOMIC(uintptr_t) space_allocated;
 
@@ -322,7 +427,7 @@ static bool _upb_Arena_AllocBlock(upb_Arena* a, size_t size) {
   size_t block_size = UPB_MAX(kUpb_MemblockReserve + size, clamped_size);
 
   upb_MemBlock* block =
-      upb_malloc(_upb_ArenaInternal_BlockAlloc(ai), block_size);
+      _upb_Arena_MallocBlock(_upb_ArenaInternal_BlockAlloc(ai), &block_size);
 
   if (!block) return false;
   _upb_Arena_AddBlock(a, block, kUpb_MemblockReserve, block_size);
@@ -354,7 +459,7 @@ static upb_Arena* _upb_Arena_InitSlow(upb_alloc* alloc, size_t first_size) {
   size_t block_size =
       first_block_overhead +
       UPB_MAX(256, UPB_ALIGN_MALLOC(first_size) + UPB_ASAN_GUARD_SIZE);
-  if (!alloc || !(mem = upb_malloc(alloc, block_size))) {
+  if (!alloc || !(mem = _upb_Arena_MallocBlock(alloc, &block_size))) {
     return NULL;
   }
 
@@ -367,6 +472,7 @@ static upb_Arena* _upb_Arena_InitSlow(upb_alloc* alloc, size_t first_size) {
                   _upb_Arena_TaggedFromTail(&a->body));
   upb_Atomic_Init(&a->body.space_allocated, block_size);
   a->body.blocks = NULL;
+  a->body.refs = NULL;
   a->body.upb_alloc_cleanup = NULL;
   UPB_TSAN_INIT_PUBLISHED(&a->body);
 
@@ -402,6 +508,7 @@ upb_Arena* upb_Arena_Init(void* mem, size_t n, upb_alloc* alloc) {
                   _upb_Arena_TaggedFromTail(&a->body));
   upb_Atomic_Init(&a->body.space_allocated, 0);
   a->body.blocks = NULL;
+  a->body.refs = NULL;
   a->body.upb_alloc_cleanup = NULL;
   a->body.block_alloc = _upb_Arena_MakeBlockAlloc(alloc, 1);
   a->head.UPB_PRIVATE(ptr) = (void*)UPB_ALIGN_MALLOC((uintptr_t)(a + 1));
@@ -425,13 +532,17 @@ static void _upb_Arena_DoFree(upb_ArenaInternal* ai) {
     if (next_arena) {
       UPB_TSAN_CHECK_PUBLISHED(next_arena);
     }
+    // Release the referenced arenas before the blocks holding the list.
+    for (upb_ArenaRef* ref = ai->refs; ref != NULL; ref = ref->next) {
+      upb_Arena_DecRefFor(ref->arena, ai);
+    }
     upb_alloc* block_alloc = _upb_ArenaInternal_BlockAlloc(ai);
     upb_MemBlock* block = ai->blocks;
     upb_AllocCleanupFunc* alloc_cleanup = *ai->upb_alloc_cleanup;
     while (block != NULL) {
       // Load first since we are deleting block.
       upb_MemBlock* next_block = block->next;
-      upb_free_sized(block_alloc, block, block->size);
+      _upb_Arena_FreeBlock(block_alloc, block, block->size);
       block = next_block;
     }
     if (alloc_cleanup != NULL) {
@@ -581,10 +692,15 @@ static upb_ArenaInternal* _upb_Arena_DoFuse(upb_ArenaInternal** ai1,
   // delta.
   uintptr_t r2_untagged_count = r2.tagged_count & ~1;
   uintptr_t with_r2_refs = r1.tagged_count + r2_untagged_count;
-  if (!upb_Atomic_CompareExchangeStrong(
-          &r1.root->parent_or_count, &r1.tagged_count, with_r2_refs,
-          memory_order_release, memory_order_acquire)) {
-    return NULL;
+  while (!upb_Atomic_CompareExchangeStrong(
+      &r1.root->parent_or_count, &r1.tagged_count, with_r2_refs,
+      memory_order_release, memory_order_acquire)) {
+    // Only restart from the top if `r1` stopped being a root. If other threads
+    // merely changed its refcount (concurrent fuses into the same root, frees
+    // of fused arenas), retry with the count we just read instead of walking
+    // both trees again, which would contend with them on every level.
+    if (_upb_Arena_IsTaggedPointer(r1.tagged_count)) return NULL;
+    with_r2_refs = r1.tagged_count + r2_untagged_count;
   }
 
   // Perform the actual fuse by removing the refs from `r2` and swapping in the
@@ -701,6 +817,18 @@ void upb_Arena_DecRefFor(const upb_Arena* a, const void* owner) {
   upb_Arena_Free((upb_Arena*)a);
 }
 
+bool upb_Arena_RefArena(upb_Arena* a, const upb_Arena* ref) {
+  // Already freed together; a ref would keep the group alive forever.
+  if (upb_Arena_IsFused(a, ref)) return true;
+  upb_ArenaRef* node = upb_Arena_Malloc(a, sizeof(*node));
+  if (!node || !upb_Arena_IncRefFor(ref, a)) return false;
+  upb_ArenaInternal* ai = upb_Arena_Internal(a);
+  node->arena = ref;
+  node->next = ai->refs;
+  ai->refs = node;
+  return true;
+}
+
 upb_alloc* upb_Arena_GetUpbAlloc(upb_Arena* a) {
   UPB_TSAN_CHECK_READ(a->UPB_ONLYBITS(ptr));
   upb_ArenaInternal* ai = upb_Arena_Internal(a);
@@ -72,6 +72,15 @@ bool upb_Arena_IncRefFor(const upb_Arena* a, const void* owner);
 // This operation is safe to use concurrently from multiple threads.
 void upb_Arena_DecRefFor(const upb_Arena* a, const void* owner);
 
+// Keeps `ref` alive at least until `a` is freed, without fusing them: unlike
+// upb_Arena_Fuse(), `a` may still be freed before `ref`, so many short-lived
+// arenas can reference one long-lived arena. Returns false if `ref` has an
+// initial block or on allocation failure.
+//
+// `a` and `ref` must not be fused afterwards, as the reference would then keep
+// the fused arenas alive forever.
+UPB_API bool upb_Arena_RefArena(upb_Arena* a, const upb_Arena* ref);
+
 // This operation is safe to use concurrently from multiple threads.
 uintptr_t upb_Arena_SpaceAllocated(const upb_Arena* a, size_t* fused_count);
 // This operation is safe to use concurrently from multiple threads.
@@ -103,6 +112,28 @@ static const size_t UPB_PRIVATE(kUpbDefaultMaxBlockSize) =
 // This operation is safe to use concurrently from multiple threads.
 void upb_Arena_SetMaxBlockSize(size_t max);
 
+// Enables recycling of arena blocks: upb_Arena_Free() keeps blocks that were
+// allocated from upb_alloc_global in a cache of the calling thread, up to `max`
+// bytes, and arenas subsequently created or grown on that thread reuse them
+// instead of calling malloc(). While enabled, such blocks are allocated in
+// power-of-two size classes. 0 (the default) disables recycling.
+//
+// Cached blocks are not returned to the system when a thread exits; threads
+// should call upb_Arena_ReleaseBlockCache() before exiting. Has no effect if
+// the compiler does not support thread-local storage.
+//
+// This API is meant for experimentation only. It will likely be removed in
+// the future.
+// This operation is safe to use concurrently from multiple threads.
+void upb_Arena_SetBlockCacheLimit(size_t max);
+
+// Frees all blocks cached by the calling thread.
+void upb_Arena_ReleaseBlockCache(void);
+
+// Returns the number of bytes in blocks cached by the calling thread. Blocks
+// in use by an arena are counted by upb_Arena_SpaceAllocated() instead.
+size_t upb_Arena_BlockCacheBytes(void);
+
 // Shrinks the last alloc from arena.
 // REQUIRES: (ptr, oldsize) was the last malloc/realloc from this arena.
 // We could also add a upb_Arena_TryShrinkLast() which is simply a no-op if
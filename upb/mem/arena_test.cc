@@ -127,6 +127,30 @@ TEST(ArenaTest, SizeHint) {
   EXPECT_EQ(sizes.size(), 0);
 }
 
+TEST(ArenaTest, BlockCacheRecyclesBlocks) {
+  upb_Arena_SetBlockCacheLimit(1 << 20);
+  absl::Cleanup reset = [] {
+    upb_Arena_SetBlockCacheLimit(0);
+    upb_Arena_ReleaseBlockCache();
+  };
+
+  upb_Arena* arena = upb_Arena_New();
+  EXPECT_NE(upb_Arena_Malloc(arena, 5000), nullptr);
+  uintptr_t space = upb_Arena_SpaceAllocated(arena, nullptr);
+  upb_Arena_Free(arena);
+  EXPECT_EQ(upb_Arena_BlockCacheBytes(), space);
+
+  // The same allocations on a new arena are served from the cache.
+  arena = upb_Arena_New();
+  EXPECT_NE(upb_Arena_Malloc(arena, 5000), nullptr);
+  EXPECT_EQ(upb_Arena_SpaceAllocated(arena, nullptr), space);
+  EXPECT_EQ(upb_Arena_BlockCacheBytes(), 0);
+  upb_Arena_Free(arena);
+
+  upb_Arena_ReleaseBlockCache();
+  EXPECT_EQ(upb_Arena_BlockCacheBytes(), 0);
+}
+
 class OverheadTest {
  public:
   OverheadTest(const OverheadTest&) = delete;
@@ -627,6 +651,30 @@ TEST(ArenaTest, ArenaIncRef) {
   upb_Arena_Free(arena1);
 }
 
+TEST(ArenaTest, RefArena) {
+  upb_Arena* shared = upb_Arena_New();
+  upb_Arena* arena1 = upb_Arena_New();
+  upb_Arena* arena2 = upb_Arena_New();
+  EXPECT_TRUE(upb_Arena_RefArena(arena1, shared));
+  EXPECT_TRUE(upb_Arena_RefArena(arena2, shared));
+  EXPECT_FALSE(upb_Arena_IsFused(arena1, arena2));
+  EXPECT_EQ(upb_Arena_DebugRefCount(shared), 3);
+
+  upb_Arena_Free(shared);
+  EXPECT_EQ(upb_Arena_DebugRefCount(shared), 2);
+  upb_Arena_Free(arena1);
+  EXPECT_EQ(upb_Arena_DebugRefCount(shared), 1);
+  // Frees `shared` as well.
+  upb_Arena_Free(arena2);
+
+  char buf[1024];
+  upb_Arena* initial_block = upb_Arena_Init(buf, sizeof(buf), nullptr);
+  upb_Arena* arena3 = upb_Arena_New();
+  EXPECT_FALSE(upb_Arena_RefArena(arena3, initial_block));
+  upb_Arena_Free(arena3);
+  upb_Arena_Free(initial_block);
+}
+
 TEST(ArenaTest, FuzzFuseIncRefCountRace) {
   Environment env;
 
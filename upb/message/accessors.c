@@ -41,3 +41,16 @@ bool upb_Message_SetMapEntry(upb_Map* map, const upb_MiniTable* m,
       map_entry_message, map_entry_value_field, default_val);
   return upb_Map_Set(map, map_entry_key, map_entry_value, arena);
 }
+
+bool upb_Message_SetFrozenMessage(upb_Message* msg,
+                                  const upb_MiniTableField* f,
+                                  const upb_Message* value,
+                                  const upb_Arena* value_arena,
+                                  upb_Arena* arena) {
+  UPB_ASSERT(!upb_Message_IsFrozen(msg));
+  UPB_ASSERT(upb_Message_IsFrozen(value));
+  if (!upb_Arena_RefArena(arena, value_arena)) return false;
+  // The message is frozen, so it is never written through this pointer.
+  upb_Message_SetMessage(msg, f, (upb_Message*)value);
+  return true;
+}
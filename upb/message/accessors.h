@@ -302,6 +302,17 @@ UPB_API_INLINE const upb_MiniTableField* upb_Message_WhichOneof(
     const upb_Message* msg, const upb_MiniTable* m,
     const upb_MiniTableField* f);
 
+// Sets the sub-message field `f` of `msg`, which lives on `arena`, to the
+// frozen message `value` from `value_arena` without copying it. Since `value`
+// can no longer change, any number of messages on other arenas may share it;
+// `arena` keeps `value_arena` alive, see upb_Arena_RefArena(). Returns false
+// if `value_arena` has an initial block or on allocation failure.
+UPB_API bool upb_Message_SetFrozenMessage(upb_Message* msg,
+                                          const upb_MiniTableField* f,
+                                          const upb_Message* value,
+                                          const upb_Arena* value_arena,
+                                          upb_Arena* arena);
+
 // Updates a map entry given an entry message.
 bool upb_Message_SetMapEntry(upb_Map* map, const upb_MiniTable* mini_table,
                              const upb_MiniTableField* field,
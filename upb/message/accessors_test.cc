@@ -348,6 +348,42 @@ TEST(GeneratedCode, SubMessage) {
   upb_Arena_Free(arena);
 }
 
+TEST(GeneratedCode, SetFrozenMessage) {
+  upb_Arena* shared_arena = upb_Arena_New();
+  upb_Message* shared = UPB_UPCAST(
+      protobuf_test_messages_proto2_TestAllTypesProto2_NestedMessage_new(
+          shared_arena));
+  const upb_MiniTableField* nested_message_a_field =
+      upb_MiniTable_FindFieldByNumber(
+          &protobuf_0test_0messages__proto2__TestAllTypesProto2__NestedMessage_msg_init,
+          kFieldOptionalNestedMessageA);
+  upb_Message_SetBaseFieldInt32(shared, nested_message_a_field, 123);
+  upb_Message_Freeze(
+      shared,
+      &protobuf_0test_0messages__proto2__TestAllTypesProto2__NestedMessage_msg_init);
+
+  const upb_MiniTableField* optional_message_field =
+      find_proto2_field(kFieldOptionalNestedMessage);
+  upb_Arena* arena1 = upb_Arena_New();
+  upb_Arena* arena2 = upb_Arena_New();
+  upb_Message* msg1 = UPB_UPCAST(
+      protobuf_test_messages_proto2_TestAllTypesProto2_new(arena1));
+  upb_Message* msg2 = UPB_UPCAST(
+      protobuf_test_messages_proto2_TestAllTypesProto2_new(arena2));
+  ASSERT_TRUE(upb_Message_SetFrozenMessage(msg1, optional_message_field,
+                                           shared, shared_arena, arena1));
+  ASSERT_TRUE(upb_Message_SetFrozenMessage(msg2, optional_message_field,
+                                           shared, shared_arena, arena2));
+  upb_Arena_Free(shared_arena);
+
+  // Both messages share the sub-message, which outlives its own arena.
+  EXPECT_EQ(upb_Message_GetMessage(msg1, optional_message_field), shared);
+  upb_Arena_Free(arena1);
+  EXPECT_EQ(upb_Message_GetMessage(msg2, optional_message_field), shared);
+  EXPECT_EQ(123, upb_Message_GetInt32(shared, nested_message_a_field, 0));
+  upb_Arena_Free(arena2);
+}
+
 TEST(GeneratedCode, RepeatedScalar) {
   upb_Arena* arena = upb_Arena_New();
   protobuf_test_messages_proto2_TestAllTypesProto2* msg =
@@ -63,6 +63,23 @@ bool upb_Array_Append(upb_Array* arr, upb_MessageValue val, upb_Arena* arena) {
   return true;
 }
 
+bool upb_Array_AppendN(upb_Array* arr, const void* data, size_t count,
+                       upb_Arena* arena) {
+  UPB_ASSERT(!upb_Array_IsFrozen(arr));
+  UPB_ASSERT(arena);
+  const size_t oldsize = arr->UPB_PRIVATE(size);
+  if (count > SIZE_MAX - oldsize ||
+      !UPB_PRIVATE(_upb_Array_ResizeUninitialized)(arr, oldsize + count,
+                                                   arena)) {
+    return false;
+  }
+  if (count == 0) return true;
+  const int lg2 = UPB_PRIVATE(_upb_Array_ElemSizeLg2)(arr);
+  char* dst = upb_Array_MutableDataPtr(arr);
+  memcpy(dst + (oldsize << lg2), data, count << lg2);
+  return true;
+}
+
 void upb_Array_Move(upb_Array* arr, size_t dst_idx, size_t src_idx,
                     size_t count) {
   UPB_ASSERT(!upb_Array_IsFrozen(arr));
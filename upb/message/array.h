@@ -46,6 +46,13 @@ UPB_API void upb_Array_Set(upb_Array* arr, size_t i, upb_MessageValue val);
 UPB_API bool upb_Array_Append(upb_Array* array, upb_MessageValue val,
                               upb_Arena* arena);
 
+// Appends `count` elements to the array, copied from `data`, which holds them
+// as a C array of the type used for this array's values in upb_MessageValue
+// (for example `int32_t` for int32 arrays, `upb_StringView` for strings).
+// The array grows at most once.  Returns false on allocation failure.
+UPB_API bool upb_Array_AppendN(upb_Array* array, const void* data,
+                               size_t count, upb_Arena* arena);
+
 // Moves elements within the array using memmove().
 // Like memmove(), the source and destination elements may be overlapping.
 UPB_API void upb_Array_Move(upb_Array* array, size_t dst_idx, size_t src_idx,
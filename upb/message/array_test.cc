@@ -7,8 +7,11 @@
 
 #include "upb/message/array.h"
 
+#include <cstdint>
+
 #include <gtest/gtest.h>
 #include "upb/base/status.hpp"
+#include "upb/base/string_view.h"
 #include "upb/mem/arena.hpp"
 
 TEST(ArrayTest, Resize) {
@@ -41,3 +44,31 @@ TEST(ArrayTest, Resize) {
   EXPECT_EQ(upb_Array_Get(array, 4).int32_val, 0);
   EXPECT_EQ(upb_Array_Get(array, 5).int32_val, 0);
 }
+
+TEST(ArrayTest, AppendN) {
+  upb::Arena arena;
+
+  upb_Array* array = upb_Array_New(arena.ptr(), kUpb_CType_Int64);
+  EXPECT_TRUE(upb_Array_AppendN(array, nullptr, 0, arena.ptr()));
+  EXPECT_EQ(upb_Array_Size(array), 0);
+
+  int64_t values[100];
+  for (int i = 0; i < 100; i++) values[i] = -i;
+  EXPECT_TRUE(upb_Array_AppendN(array, values, 3, arena.ptr()));
+  EXPECT_TRUE(upb_Array_AppendN(array, values, 100, arena.ptr()));
+  EXPECT_EQ(upb_Array_Size(array), 103);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(upb_Array_Get(array, i).int64_val, -i);
+  }
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(upb_Array_Get(array, i + 3).int64_val, -i);
+  }
+
+  upb_Array* strings = upb_Array_New(arena.ptr(), kUpb_CType_String);
+  upb_StringView views[] = {upb_StringView_FromString("a"),
+                            upb_StringView_FromString("bc")};
+  EXPECT_TRUE(upb_Array_AppendN(strings, views, 2, arena.ptr()));
+  EXPECT_EQ(upb_Array_Size(strings), 2);
+  EXPECT_TRUE(upb_StringView_IsEqual(upb_Array_Get(strings, 1).str_val,
+                                     upb_StringView_FromString("bc")));
+}
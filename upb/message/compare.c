@@ -9,6 +9,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "upb/base/descriptor_constants.h"
 #include "upb/message/accessors.h"
@@ -22,6 +23,7 @@
 #include "upb/mini_table/extension.h"
 #include "upb/mini_table/field.h"
 #include "upb/mini_table/internal/field.h"
+#include "upb/mini_table/internal/message.h"
 #include "upb/mini_table/message.h"
 
 // Must be last.
@@ -129,6 +131,18 @@ static bool _upb_Message_BaseFieldsAreEqual(const upb_Message* msg1,
   }
 }
 
+// Returns whether the two messages hold the same bytes past the header.  If so,
+// their hasbits, oneof cases, scalar values and pointers are all identical, so
+// the base fields are equal without visiting them one by one.  Messages with
+// equal base fields need not be identical, e.g. when equal strings are held in
+// different buffers.
+static bool _upb_Message_BaseFieldsAreIdentical(const upb_Message* msg1,
+                                                const upb_Message* msg2,
+                                                const upb_MiniTable* m) {
+  return memcmp(msg1 + 1, msg2 + 1,
+                m->UPB_PRIVATE(size) - sizeof(upb_Message)) == 0;
+}
+
 static bool _upb_Message_ExtensionsAreEqual(const upb_Message* msg1,
                                             const upb_Message* msg2,
                                             const upb_MiniTable* m,
@@ -180,7 +194,10 @@ bool upb_Message_IsEqual(const upb_Message* msg1, const upb_Message* msg2,
                          const upb_MiniTable* m, int options) {
   if (UPB_UNLIKELY(msg1 == msg2)) return true;
 
-  if (!_upb_Message_BaseFieldsAreEqual(msg1, msg2, m, options)) return false;
+  if (!_upb_Message_BaseFieldsAreIdentical(msg1, msg2, m) &&
+      !_upb_Message_BaseFieldsAreEqual(msg1, msg2, m, options)) {
+    return false;
+  }
   if (!_upb_Message_ExtensionsAreEqual(msg1, msg2, m, options)) return false;
 
   if (!(options & kUpb_CompareOption_IncludeUnknownFields)) return true;
@@ -149,6 +149,15 @@ upb_Array* upb_Array_DeepClone(const upb_Array* array, upb_CType value_type,
   if (!UPB_PRIVATE(_upb_Array_ResizeUninitialized)(cloned_array, size, arena)) {
     return NULL;
   }
+  if (value_type != kUpb_CType_String && value_type != kUpb_CType_Bytes &&
+      value_type != kUpb_CType_Message) {
+    // Scalar elements own no memory, so they are copied in one go.
+    if (size != 0) {
+      memcpy(upb_Array_MutableDataPtr(cloned_array), upb_Array_DataPtr(array),
+             size << lg2);
+    }
+    return cloned_array;
+  }
   for (size_t i = 0; i < size; ++i) {
     upb_MessageValue val = upb_Array_Get(array, i);
     if (!upb_Clone_MessageValue(&val, value_type, sub, arena)) {
@@ -309,7 +318,11 @@ bool upb_Message_DeepCopy(upb_Message* dst, const upb_Message* src,
 // Returns NULL on failure.
 upb_Message* upb_Message_DeepClone(const upb_Message* msg,
                                    const upb_MiniTable* m, upb_Arena* arena) {
-  upb_Message* clone = upb_Message_New(m, arena);
+  // _upb_Message_Copy() overwrites everything but the header, so there is no
+  // need to zero the whole message first.
+  upb_Message* clone = upb_Arena_Malloc(arena, m->UPB_PRIVATE(size));
+  if (!clone) return NULL;
+  memset(clone, 0, sizeof(upb_Message));
   return _upb_Message_Copy(clone, msg, m, arena);
 }
 
@@ -162,6 +162,48 @@ TEST(GeneratedCode, DeepCloneMessageArrayField) {
   upb_Arena_Free(arena);
 }
 
+TEST(GeneratedCode, DeepCloneMessageArrayElementSizes) {
+  upb_Arena* source_arena = upb_Arena_New();
+  protobuf_test_messages_proto2_TestAllTypesProto2* msg =
+      protobuf_test_messages_proto2_TestAllTypesProto2_new(source_arena);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(
+        protobuf_test_messages_proto2_TestAllTypesProto2_add_repeated_double(
+            msg, i * 1.5, source_arena));
+    ASSERT_TRUE(
+        protobuf_test_messages_proto2_TestAllTypesProto2_add_repeated_bool(
+            msg, i % 3 == 0, source_arena));
+  }
+  ASSERT_TRUE(
+      protobuf_test_messages_proto2_TestAllTypesProto2_add_repeated_string(
+          msg, upb_StringView_FromString(kTestStr1), source_arena));
+  upb_Arena* arena = upb_Arena_New();
+  protobuf_test_messages_proto2_TestAllTypesProto2* clone =
+      (protobuf_test_messages_proto2_TestAllTypesProto2*)upb_Message_DeepClone(
+          UPB_UPCAST(msg),
+          &protobuf_0test_0messages__proto2__TestAllTypesProto2_msg_init,
+          arena);
+  upb_Arena_Free(source_arena);
+
+  size_t size = 0;
+  const double* doubles =
+      protobuf_test_messages_proto2_TestAllTypesProto2_repeated_double(clone,
+                                                                       &size);
+  ASSERT_EQ(size, 10);
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(doubles[i], i * 1.5);
+  const bool* bools =
+      protobuf_test_messages_proto2_TestAllTypesProto2_repeated_bool(clone,
+                                                                     &size);
+  ASSERT_EQ(size, 10);
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(bools[i], i % 3 == 0);
+  const upb_StringView* strings =
+      protobuf_test_messages_proto2_TestAllTypesProto2_repeated_string(clone,
+                                                                       &size);
+  ASSERT_EQ(size, 1);
+  EXPECT_EQ(std::string(strings[0].data, strings[0].size), kTestStr1);
+  upb_Arena_Free(arena);
+}
+
 TEST(GeneratedCode, DeepCloneMessageMapField) {
   upb_Arena* source_arena = upb_Arena_New();
   protobuf_test_messages_proto2_TestAllTypesProto2* msg =
@@ -9,8 +9,10 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "upb/base/string_view.h"
+#include "upb/hash/common.h"
 #include "upb/mem/alloc.h"
 #include "upb/message/message.h"
 #include "upb/wire/eps_copy_input_stream.h"
@@ -286,10 +288,123 @@ static bool upb_UnknownFields_IsEqual(const upb_UnknownFields* uf1,
   return true;
 }
 
+static uint64_t upb_UnknownFields_Mix(uint64_t a, uint64_t b) {
+  uint64_t x = a ^ (b * 0x9e3779b97f4a7c15ULL);
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+// Hashes the unknown fields in buf, up to the end of the stream or of the
+// enclosing group.  The hashes of the fields are summed, so that the result
+// does not depend on their order: fields that compare equal once sorted always
+// hash the same.
+static uint64_t upb_UnknownFields_HashFromBuffer(upb_UnknownField_Context* ctx,
+                                                 const char** buf) {
+  const char* ptr = *buf;
+  uint64_t sum = 0;
+  while (!upb_EpsCopyInputStream_IsDone(&ctx->stream, &ptr)) {
+    uint32_t tag;
+    ptr = upb_WireReader_ReadTag(ptr, &tag);
+    int wire_type = upb_WireReader_GetWireType(tag);
+    if (wire_type == kUpb_WireType_EndGroup) break;
+
+    uint64_t value;
+    switch (wire_type) {
+      case kUpb_WireType_Varint:
+        ptr = upb_WireReader_ReadVarint(ptr, &value);
+        break;
+      case kUpb_WireType_64Bit:
+        ptr = upb_WireReader_ReadFixed64(ptr, &value);
+        break;
+      case kUpb_WireType_32Bit: {
+        uint32_t u32;
+        ptr = upb_WireReader_ReadFixed32(ptr, &u32);
+        value = u32;
+        break;
+      }
+      case kUpb_WireType_Delimited: {
+        int size;
+        ptr = upb_WireReader_ReadSize(ptr, &size);
+        const char* s_ptr = ptr;
+        ptr = upb_EpsCopyInputStream_ReadStringAliased(&ctx->stream, &s_ptr,
+                                                       size);
+        value = _upb_Hash(s_ptr, size, size);
+        break;
+      }
+      case kUpb_WireType_StartGroup:
+        if (--ctx->depth == 0) {
+          ctx->status = kUpb_UnknownCompareResult_MaxDepthExceeded;
+          UPB_LONGJMP(ctx->err, 1);
+        }
+        value = upb_UnknownFields_HashFromBuffer(ctx, &ptr);
+        ctx->depth++;
+        break;
+      default:
+        UPB_UNREACHABLE();
+    }
+    sum += upb_UnknownFields_Mix(tag, value);
+  }
+  *buf = ptr;
+  return sum;
+}
+
+// Hashes the unknown fields of a upb_Message.
+static uint64_t upb_UnknownFields_Hash(upb_UnknownField_Context* ctx,
+                                       const upb_Message* msg) {
+  uint64_t sum = 0;
+  uintptr_t iter = kUpb_Message_UnknownBegin;
+  upb_StringView view;
+  while (upb_Message_NextUnknown(msg, &view, &iter)) {
+    upb_EpsCopyInputStream_Init(&ctx->stream, &view.data, view.size, true);
+    sum += upb_UnknownFields_HashFromBuffer(ctx, &view.data);
+  }
+  return sum;
+}
+
+// Moves `view` to the next non-empty chunk of unknown fields, if it is empty.
+static bool upb_UnknownFields_NextBytes(const upb_Message* msg,
+                                        upb_StringView* view,
+                                        uintptr_t* iter) {
+  while (view->size == 0) {
+    if (!upb_Message_NextUnknown(msg, view, iter)) return false;
+  }
+  return true;
+}
+
+// Returns true if the unknown fields of the two messages are the same bytes,
+// however they are split into chunks.
+static bool upb_UnknownFields_BytesAreEqual(const upb_Message* msg1,
+                                            const upb_Message* msg2) {
+  uintptr_t iter1 = kUpb_Message_UnknownBegin;
+  uintptr_t iter2 = kUpb_Message_UnknownBegin;
+  upb_StringView view1 = {NULL, 0};
+  upb_StringView view2 = {NULL, 0};
+  for (;;) {
+    const bool got1 = upb_UnknownFields_NextBytes(msg1, &view1, &iter1);
+    const bool got2 = upb_UnknownFields_NextBytes(msg2, &view2, &iter2);
+    if (!got1 || !got2) return got1 == got2;
+    const size_t n = UPB_MIN(view1.size, view2.size);
+    if (memcmp(view1.data, view2.data, n) != 0) return false;
+    view1.data += n;
+    view1.size -= n;
+    view2.data += n;
+    view2.size -= n;
+  }
+}
+
 static upb_UnknownCompareResult upb_UnknownField_DoCompare(
     upb_UnknownField_Context* ctx, const upb_Message* msg1,
     const upb_Message* msg2) {
   upb_UnknownCompareResult ret;
+  // Unequal hashes prove that the fields differ, without building anything.
+  if (upb_UnknownFields_Hash(ctx, msg1) != upb_UnknownFields_Hash(ctx, msg2)) {
+    return kUpb_UnknownCompareResult_NotEqual;
+  }
+
   // First build both unknown fields into a sorted data structure (similar
   // to the UnknownFieldSet in C++).
   upb_UnknownFields* uf1 = upb_UnknownFields_Build(ctx, msg1);
@@ -327,6 +442,12 @@ upb_UnknownCompareResult UPB_PRIVATE(_upb_Message_UnknownFieldsAreEqual)(
   if (msg1_empty && msg2_empty) return kUpb_UnknownCompareResult_Equal;
   if (msg1_empty || msg2_empty) return kUpb_UnknownCompareResult_NotEqual;
 
+  // Messages that were parsed from the same bytes, or copied from one another,
+  // are equal without being parsed.
+  if (upb_UnknownFields_BytesAreEqual(msg1, msg2)) {
+    return kUpb_UnknownCompareResult_Equal;
+  }
+
   upb_UnknownField_Context ctx = {
       .arena = upb_Arena_New(),
       .depth = max_depth,
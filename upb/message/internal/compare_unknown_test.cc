@@ -189,3 +189,50 @@ TEST(CompareTest, MaxDepth) {
           {{1, Group({{2, Group({{4, Fixed64(123)}, {3, Fixed32(456)}})}})}},
           2));
 }
+
+TEST(CompareTest, IdenticalBytes) {
+  // Identical bytes are equal without being parsed, so the depth limit does
+  // not apply.
+  EXPECT_EQ(
+      kUpb_UnknownCompareResult_Equal,
+      CompareUnknownWithMaxDepth(
+          {{1, Group({{2, Group({{3, Fixed32(456)}, {4, Fixed64(123)}})}})}},
+          {{1, Group({{2, Group({{3, Fixed32(456)}, {4, Fixed64(123)}})}})}},
+          2));
+}
+
+TEST(CompareTest, SplitIntoChunks) {
+  upb::Arena arena;
+  protobuf_test_messages_proto2_TestAllTypesProto2* msg1 =
+      protobuf_test_messages_proto2_TestAllTypesProto2_new(arena.ptr());
+  protobuf_test_messages_proto2_TestAllTypesProto2* msg2 =
+      protobuf_test_messages_proto2_TestAllTypesProto2_new(arena.ptr());
+  protobuf_test_messages_proto2_TestAllTypesProto2* msg3 =
+      protobuf_test_messages_proto2_TestAllTypesProto2_new(arena.ptr());
+  protobuf_test_messages_proto2_TestAllTypesProto2* msg4 =
+      protobuf_test_messages_proto2_TestAllTypesProto2_new(arena.ptr());
+  std::string first = ToBinaryPayload({{1, Varint(111)}, {2, Varint(222)}});
+  std::string second = ToBinaryPayload({{3, Delimited("ABC")}});
+  std::string both = first + second;
+  UPB_PRIVATE(_upb_Message_AddUnknown)(UPB_UPCAST(msg1), both.data(),
+                                       both.size(), arena.ptr(), false);
+  UPB_PRIVATE(_upb_Message_AddUnknown)(UPB_UPCAST(msg2), first.data(),
+                                       first.size(), arena.ptr(), false);
+  UPB_PRIVATE(_upb_Message_AddUnknown)(UPB_UPCAST(msg2), second.data(),
+                                       second.size(), arena.ptr(), false);
+  UPB_PRIVATE(_upb_Message_AddUnknown)(UPB_UPCAST(msg3), second.data(),
+                                       second.size(), arena.ptr(), false);
+  UPB_PRIVATE(_upb_Message_AddUnknown)(UPB_UPCAST(msg3), first.data(),
+                                       first.size(), arena.ptr(), false);
+  UPB_PRIVATE(_upb_Message_AddUnknown)(UPB_UPCAST(msg4), first.data(),
+                                       first.size(), arena.ptr(), false);
+  EXPECT_EQ(kUpb_UnknownCompareResult_Equal,
+            UPB_PRIVATE(_upb_Message_UnknownFieldsAreEqual)(
+                UPB_UPCAST(msg1), UPB_UPCAST(msg2), 64));
+  EXPECT_EQ(kUpb_UnknownCompareResult_Equal,
+            UPB_PRIVATE(_upb_Message_UnknownFieldsAreEqual)(
+                UPB_UPCAST(msg1), UPB_UPCAST(msg3), 64));
+  EXPECT_EQ(kUpb_UnknownCompareResult_NotEqual,
+            UPB_PRIVATE(_upb_Message_UnknownFieldsAreEqual)(
+                UPB_UPCAST(msg2), UPB_UPCAST(msg4), 64));
+}
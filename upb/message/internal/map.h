@@ -34,6 +34,10 @@ struct upb_Map {
   char val_size;
   bool UPB_PRIVATE(is_frozen);
 
+  // The entries of `table` in key order, cached by _upb_Map_CacheOrder() for
+  // deterministic encoding, or NULL.  Inserting, deleting or clearing drops it.
+  const void** UPB_PRIVATE(sorted);
+
   upb_strtable table;
 };
 
@@ -108,6 +112,7 @@ UPB_INLINE void* _upb_map_next(const struct upb_Map* map, size_t* iter) {
 UPB_INLINE void _upb_Map_Clear(struct upb_Map* map) {
   UPB_ASSERT(!upb_Map_IsFrozen(map));
 
+  map->UPB_PRIVATE(sorted) = NULL;
   upb_strtable_clear(&map->table);
 }
 
@@ -115,6 +120,7 @@ UPB_INLINE bool _upb_Map_Delete(struct upb_Map* map, const void* key,
                                 size_t key_size, upb_value* val) {
   UPB_ASSERT(!upb_Map_IsFrozen(map));
 
+  map->UPB_PRIVATE(sorted) = NULL;
   upb_StringView k = _upb_map_tokey(key, key_size);
   return upb_strtable_remove2(&map->table, k.data, k.size, val);
 }
@@ -136,6 +142,7 @@ UPB_INLINE upb_MapInsertStatus _upb_Map_Insert(struct upb_Map* map,
                                                upb_Arena* a) {
   UPB_ASSERT(!upb_Map_IsFrozen(map));
 
+  map->UPB_PRIVATE(sorted) = NULL;
   upb_StringView strkey = _upb_map_tokey(key, key_size);
   upb_value tabval = {0};
   if (!_upb_map_tovalue(val, val_size, &tabval, a)) {
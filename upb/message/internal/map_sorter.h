@@ -81,6 +81,12 @@ UPB_INLINE void _upb_mapsorter_popmap(_upb_mapsorter* s,
 bool _upb_mapsorter_pushmap(_upb_mapsorter* s, upb_FieldType key_type,
                             const struct upb_Map* map, _upb_sortedmap* sorted);
 
+// Caches the key order of `map` in the map itself, so that
+// _upb_mapsorter_pushmap() and the wire encoder don't have to sort it.  The
+// cache is allocated from `a`, which must outlive the map.
+bool _upb_Map_CacheOrder(struct upb_Map* map, upb_FieldType key_type,
+                         upb_Arena* a);
+
 bool _upb_mapsorter_pushexts(_upb_mapsorter* s, const upb_Message_Internal* in,
                              _upb_sortedmap* sorted);
 
@@ -16,6 +16,7 @@
 #include "upb/base/string_view.h"
 #include "upb/hash/common.h"
 #include "upb/mem/alloc.h"
+#include "upb/mem/arena.h"
 #include "upb/message/internal/extension.h"
 #include "upb/message/internal/map.h"
 #include "upb/message/internal/message.h"
@@ -96,6 +97,70 @@ static int (*const compar[kUpb_FieldType_SizeOf])(const void*, const void*) = {
     [kUpb_FieldType_Bytes] = _upb_mapsorter_cmpstr,
 };
 
+// Returns the key of an integer-keyed entry mapped to an unsigned value that
+// preserves the key type's ordering.
+static uint64_t _upb_mapsorter_ordkey(const void* ent, upb_FieldType key_type) {
+  upb_StringView key = upb_tabstrview(((const upb_tabent*)ent)->key);
+  uint64_t v64;
+  uint32_t v32;
+  switch (key_type) {
+    case kUpb_FieldType_Int64:
+    case kUpb_FieldType_SFixed64:
+    case kUpb_FieldType_SInt64:
+      _upb_map_fromkey(key, &v64, 8);
+      return v64 ^ (1ULL << 63);
+    case kUpb_FieldType_UInt64:
+    case kUpb_FieldType_Fixed64:
+      _upb_map_fromkey(key, &v64, 8);
+      return v64;
+    case kUpb_FieldType_Int32:
+    case kUpb_FieldType_SInt32:
+    case kUpb_FieldType_SFixed32:
+    case kUpb_FieldType_Enum:
+      _upb_map_fromkey(key, &v32, 4);
+      return v32 ^ (1U << 31);
+    default:
+      _upb_map_fromkey(key, &v32, 4);
+      return v32;
+  }
+}
+
+// If the keys of an integer-keyed map form a contiguous range, each entry's
+// position in sorted order is simply its key minus the smallest key, so the
+// entries can be permuted into place in O(n) without calling qsort().
+static bool _upb_mapsorter_sortdense(const void** entries, int size,
+                                     upb_FieldType key_type) {
+  switch (key_type) {
+    case kUpb_FieldType_Bool:
+    case kUpb_FieldType_String:
+    case kUpb_FieldType_Bytes:
+      return false;
+    default:
+      break;
+  }
+
+  uint64_t min = UINT64_MAX;
+  uint64_t max = 0;
+  for (int i = 0; i < size; i++) {
+    uint64_t k = _upb_mapsorter_ordkey(entries[i], key_type);
+    if (k < min) min = k;
+    if (k > max) max = k;
+  }
+  if (max - min != (uint64_t)size - 1) return false;
+
+  // Keys are unique, so every swap moves one entry to its final slot.
+  for (int i = 0; i < size; i++) {
+    for (;;) {
+      int j = (int)(_upb_mapsorter_ordkey(entries[i], key_type) - min);
+      if (j == i) break;
+      const void* tmp = entries[j];
+      entries[j] = entries[i];
+      entries[i] = tmp;
+    }
+  }
+  return true;
+}
+
 static bool _upb_mapsorter_resize(_upb_mapsorter* s, _upb_sortedmap* sorted,
                                   int size) {
   sorted->start = s->size;
@@ -114,15 +179,14 @@ static bool _upb_mapsorter_resize(_upb_mapsorter* s, _upb_sortedmap* sorted,
   return true;
 }
 
-bool _upb_mapsorter_pushmap(_upb_mapsorter* s, upb_FieldType key_type,
-                            const upb_Map* map, _upb_sortedmap* sorted) {
-  int map_size = _upb_Map_Size(map);
-  UPB_ASSERT(map_size);
+// Fills `entries` with the entries of `map`, in key order.
+static void _upb_mapsorter_sortentries(const void** entries,
+                                       upb_FieldType key_type,
+                                       const upb_Map* map) {
+  const int map_size = _upb_Map_Size(map);
 
-  if (!_upb_mapsorter_resize(s, sorted, map_size)) return false;
-
-  // Copy non-empty entries from the table to s->entries.
-  const void** dst = &s->entries[sorted->start];
+  // Copy non-empty entries from the table to `entries`.
+  const void** dst = entries;
   const upb_tabent* src = map->table.t.entries;
   const upb_tabent* end = src + upb_table_size(&map->table.t);
   for (; src < end; src++) {
@@ -131,11 +195,37 @@ bool _upb_mapsorter_pushmap(_upb_mapsorter* s, upb_FieldType key_type,
       dst++;
     }
   }
-  UPB_ASSERT(dst == &s->entries[sorted->end]);
+  UPB_ASSERT(dst == entries + map_size);
 
   // Sort entries according to the key type.
-  qsort(&s->entries[sorted->start], map_size, sizeof(*s->entries),
-        compar[key_type]);
+  if (_upb_mapsorter_sortdense(entries, map_size, key_type)) return;
+  qsort(entries, map_size, sizeof(*entries), compar[key_type]);
+}
+
+bool _upb_mapsorter_pushmap(_upb_mapsorter* s, upb_FieldType key_type,
+                            const upb_Map* map, _upb_sortedmap* sorted) {
+  int map_size = _upb_Map_Size(map);
+  UPB_ASSERT(map_size);
+
+  if (!_upb_mapsorter_resize(s, sorted, map_size)) return false;
+
+  const void* const* cached = map->UPB_PRIVATE(sorted);
+  if (cached) {
+    memcpy(&s->entries[sorted->start], cached, map_size * sizeof(*cached));
+    return true;
+  }
+  _upb_mapsorter_sortentries(&s->entries[sorted->start], key_type, map);
+  return true;
+}
+
+bool _upb_Map_CacheOrder(upb_Map* map, upb_FieldType key_type, upb_Arena* a) {
+  UPB_ASSERT(!upb_Map_IsFrozen(map));
+  if (map->UPB_PRIVATE(sorted) || _upb_Map_Size(map) == 0) return true;
+  const void** entries =
+      upb_Arena_Malloc(a, _upb_Map_Size(map) * sizeof(*entries));
+  if (!entries) return false;
+  _upb_mapsorter_sortentries(entries, key_type, map);
+  map->UPB_PRIVATE(sorted) = entries;
   return true;
 }
 
@@ -18,6 +18,7 @@
 #include "upb/message/array.h"
 #include "upb/message/internal/accessors.h"
 #include "upb/message/internal/extension.h"
+#include "upb/message/internal/map_sorter.h"
 #include "upb/message/internal/message.h"
 #include "upb/message/internal/types.h"
 #include "upb/message/map.h"
@@ -207,3 +208,97 @@ void upb_Message_Freeze(upb_Message* msg, const upb_MiniTable* m) {
     }
   }
 }
+
+static bool _upb_Array_CacheMapOrder(upb_Array* arr, const upb_MiniTable* m,
+                                     upb_Arena* a) {
+  if (!m || upb_Array_IsFrozen(arr)) return true;
+  const size_t size = upb_Array_Size(arr);
+  for (size_t i = 0; i < size; i++) {
+    upb_Message* msg = (upb_Message*)upb_Array_Get(arr, i).msg_val;
+    if (!upb_Message_CacheMapOrder(msg, m, a)) return false;
+  }
+  return true;
+}
+
+static bool _upb_Map_CacheMapOrder(upb_Map* map, const upb_MiniTable* entry,
+                                   upb_Arena* a) {
+  if (upb_Map_IsFrozen(map)) return true;
+  const upb_MiniTableField* key_f = upb_MiniTable_MapKey(entry);
+  if (!_upb_Map_CacheOrder(map, upb_MiniTableField_Type(key_f), a)) {
+    return false;
+  }
+
+  const upb_MiniTable* m =
+      upb_MiniTable_SubMessage(entry, upb_MiniTable_MapValue(entry));
+  if (m) {
+    size_t iter = kUpb_Map_Begin;
+    upb_MessageValue key, val;
+    while (upb_Map_Next(map, &key, &val, &iter)) {
+      if (!upb_Message_CacheMapOrder((upb_Message*)val.msg_val, m, a)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool upb_Message_CacheMapOrder(upb_Message* msg, const upb_MiniTable* m,
+                               upb_Arena* a) {
+  if (upb_Message_IsFrozen(msg)) return true;
+
+  // Base Fields.
+  const size_t field_count = upb_MiniTable_FieldCount(m);
+
+  for (size_t i = 0; i < field_count; i++) {
+    const upb_MiniTableField* f = upb_MiniTable_GetFieldByIndex(m, i);
+    const upb_MiniTable* m2 = upb_MiniTable_SubMessage(m, f);
+    bool ok = true;
+
+    switch (UPB_PRIVATE(_upb_MiniTableField_Mode)(f)) {
+      case kUpb_FieldMode_Array: {
+        upb_Array* arr = upb_Message_GetMutableArray(msg, f);
+        if (arr) ok = _upb_Array_CacheMapOrder(arr, m2, a);
+        break;
+      }
+      case kUpb_FieldMode_Map: {
+        upb_Map* map = upb_Message_GetMutableMap(msg, f);
+        if (map) ok = _upb_Map_CacheMapOrder(map, m2, a);
+        break;
+      }
+      case kUpb_FieldMode_Scalar: {
+        if (m2) {
+          upb_Message* msg2 = upb_Message_GetMutableMessage(msg, f);
+          if (msg2) ok = upb_Message_CacheMapOrder(msg2, m2, a);
+        }
+        break;
+      }
+    }
+    if (!ok) return false;
+  }
+
+  // Extensions.
+  const upb_MiniTableExtension* e;
+  upb_MessageValue val;
+  uintptr_t iter = kUpb_Message_ExtensionBegin;
+  while (upb_Message_NextExtension(msg, &e, &val, &iter)) {
+    const upb_MiniTableField* f = &e->UPB_PRIVATE(field);
+    const upb_MiniTable* m2 = upb_MiniTableExtension_GetSubMessage(e);
+    bool ok = true;
+
+    switch (UPB_PRIVATE(_upb_MiniTableField_Mode)(f)) {
+      case kUpb_FieldMode_Array:
+        ok = _upb_Array_CacheMapOrder((upb_Array*)val.array_val, m2, a);
+        break;
+      case kUpb_FieldMode_Map:
+        UPB_UNREACHABLE();  // Maps cannot be extensions.
+        break;
+      case kUpb_FieldMode_Scalar:
+        if (upb_MiniTableField_IsSubMessage(f)) {
+          ok = upb_Message_CacheMapOrder((upb_Message*)val.msg_val, m2, a);
+        }
+        break;
+    }
+    if (!ok) return false;
+  }
+  return true;
+}
@@ -102,6 +102,15 @@ UPB_API void upb_Message_Freeze(upb_Message* msg, const upb_MiniTable* m);
 // Returns whether a message has been frozen.
 UPB_API_INLINE bool upb_Message_IsFrozen(const upb_Message* msg);
 
+// Records the key order of every map in a message and its descendents, so that
+// deterministic encoding (kUpb_EncodeOption_Deterministic) doesn't need to sort
+// them.  A map forgets its order when it is modified.  Frozen messages are
+// skipped, so call this before upb_Message_Freeze() if the message will be
+// frozen.  `a` must outlive the message; it is typically the message's arena.
+// Returns false if memory allocation failed.
+UPB_API bool upb_Message_CacheMapOrder(upb_Message* msg, const upb_MiniTable* m,
+                                       upb_Arena* a);
+
 #ifdef UPB_TRACING_ENABLED
 UPB_API void upb_Message_LogNewMessage(const upb_MiniTable* m,
                                        const upb_Arena* arena);
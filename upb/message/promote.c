@@ -24,7 +24,9 @@
 #include "upb/message/message.h"
 #include "upb/message/tagged_ptr.h"
 #include "upb/mini_table/extension.h"
+#include "upb/mini_table/extension_registry.h"
 #include "upb/mini_table/field.h"
+#include "upb/mini_table/internal/message.h"
 #include "upb/mini_table/message.h"
 #include "upb/mini_table/sub.h"
 #include "upb/wire/decode.h"
@@ -112,6 +114,74 @@ upb_GetExtension_Status upb_Message_GetOrPromoteExtension(
   return kUpb_GetExtension_Ok;
 }
 
+// Returns whether the unknown fields in `data` hold an extension known to
+// `extreg`.
+static bool upb_Message_UnknownHasExtension(upb_StringView data,
+                                            const upb_MiniTable* mini_table,
+                                            const upb_ExtensionRegistry* extreg,
+                                            int depth_limit) {
+  upb_EpsCopyInputStream stream;
+  const char* ptr = data.data;
+  upb_EpsCopyInputStream_Init(&stream, &ptr, data.size, true);
+  while (!upb_EpsCopyInputStream_IsDone(&stream, &ptr)) {
+    uint32_t tag;
+    ptr = upb_WireReader_ReadTag(ptr, &tag);
+    if (!ptr) return false;
+    uint32_t field_number = upb_WireReader_GetFieldNumber(tag);
+    if (upb_ExtensionRegistry_Lookup(extreg, mini_table, field_number)) {
+      return true;
+    }
+    ptr = _upb_WireReader_SkipValue(ptr, tag, depth_limit, &stream);
+    if (!ptr) return false;
+  }
+  return false;
+}
+
+upb_DecodeStatus upb_Message_PromoteExtensions(
+    upb_Message* msg, const upb_MiniTable* mini_table,
+    const upb_ExtensionRegistry* extreg, int decode_options,
+    upb_Arena* arena) {
+  UPB_ASSERT(!upb_Message_IsFrozen(msg));
+  upb_Message_Internal* in = UPB_PRIVATE(_upb_Message_GetInternal)(msg);
+  if (!in || !extreg) return kUpb_DecodeStatus_Ok;
+
+  const int depth_limit = upb_DecodeOptions_GetMaxDepth(decode_options)
+                              ? upb_DecodeOptions_GetMaxDepth(decode_options)
+                              : 100;
+  const bool is_message_set =
+      mini_table->UPB_PRIVATE(ext) == kUpb_ExtMode_IsMessageSet;
+
+  // Decoding appends to the aux data, and may move it, so only the entries
+  // that were there to begin with are visited, by index.
+  const size_t size = in->size;
+  for (size_t i = 0; i < size; i++) {
+    in = UPB_PRIVATE(_upb_Message_GetInternal)(msg);
+    upb_TaggedAuxPtr tagged_ptr = in->aux_data[i];
+    if (!upb_TaggedAuxPtr_IsUnknown(tagged_ptr)) continue;
+    upb_StringView data = *upb_TaggedAuxPtr_UnknownData(tagged_ptr);
+
+    // MessageSet items hold their extension number inside a group, which the
+    // decoder resolves, so every item is decoded.
+    if (!is_message_set && !upb_Message_UnknownHasExtension(
+                               data, mini_table, extreg, depth_limit)) {
+      continue;
+    }
+
+    // Decoding the bytes again with the registry promotes the known
+    // extensions, merging them with any already present, and adds back any
+    // other fields as unknown fields.
+    in->aux_data[i] = upb_TaggedAuxPtr_Null();
+    upb_DecodeStatus status =
+        upb_Decode(data.data, data.size, msg, mini_table, extreg,
+                   decode_options & ~kUpb_DecodeOption_ReuseStorage, arena);
+    if (status != kUpb_DecodeStatus_Ok) {
+      UPB_PRIVATE(_upb_Message_GetInternal)(msg)->aux_data[i] = tagged_ptr;
+      return status;
+    }
+  }
+  return kUpb_DecodeStatus_Ok;
+}
+
 static upb_FindUnknownRet upb_FindUnknownRet_ParseError(void) {
   return (upb_FindUnknownRet){.status = kUpb_FindUnknown_ParseError};
 }
@@ -167,7 +237,8 @@ static upb_DecodeStatus upb_Message_PromoteOne(upb_TaggedMessagePtr* tagged,
   while (upb_Message_NextUnknown(empty, &unknown_data, &iter)) {
     upb_DecodeStatus status =
         upb_Decode(unknown_data.data, unknown_data.size, promoted, mini_table,
-                   NULL, decode_options, arena);
+                   NULL, decode_options & ~kUpb_DecodeOption_ReuseStorage,
+                   arena);
     if (status != kUpb_DecodeStatus_Ok) {
       return status;
     }
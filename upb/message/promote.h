@@ -41,6 +41,20 @@ upb_GetExtension_Status upb_Message_GetOrPromoteExtension(
     upb_Message* msg, const upb_MiniTableExtension* ext_table,
     int decode_options, upb_Arena* arena, upb_MessageValue* value);
 
+// Promotes every unknown field of `msg` that is an extension known to
+// `extreg` to that extension, in a single pass over the unknown fields.  This
+// is much cheaper than calling upb_Message_GetOrPromoteExtension() for each
+// extension in turn, which scans the unknown fields every time.  Extensions of
+// any type are promoted, and repeated occurrences are merged as the decoder
+// would merge them.  `mini_table` is the message's own MiniTable.
+//
+// If the return value indicates an error status, some but not all extensions
+// may have been promoted.  The unknown field that failed to parse is kept, and
+// part of it may also have been promoted.
+upb_DecodeStatus upb_Message_PromoteExtensions(
+    upb_Message* msg, const upb_MiniTable* mini_table,
+    const upb_ExtensionRegistry* extreg, int decode_options, upb_Arena* arena);
+
 typedef enum {
   kUpb_FindUnknown_Ok,
   kUpb_FindUnknown_NotPresent,
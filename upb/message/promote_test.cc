@@ -39,6 +39,7 @@
 #include "upb/mini_descriptor/internal/modifiers.h"
 #include "upb/mini_descriptor/link.h"
 #include "upb/mini_table/extension.h"
+#include "upb/mini_table/extension_registry.h"
 #include "upb/mini_table/field.h"
 #include "upb/mini_table/message.h"
 #include "upb/test/test.upb.h"
@@ -327,6 +328,74 @@ void CheckReserialize(const upb_Message* msg, const upb_MiniTable* mini_table,
   EXPECT_EQ(0, memcmp(reserialized, serialized, serialized_size));
 }
 
+TEST(GeneratedCode, PromoteExtensions) {
+  upb::Arena arena;
+  std::string serialized;
+  for (const char* str : {"Hello", "World"}) {
+    // The second occurrence of the extension is merged into the first.
+    upb_test_ModelWithExtensions* msg =
+        upb_test_ModelWithExtensions_new(arena.ptr());
+    upb_test_ModelExtension1* extension1 =
+        upb_test_ModelExtension1_new(arena.ptr());
+    upb_test_ModelExtension1_set_str(extension1,
+                                     upb_StringView_FromString(str));
+    upb_test_ModelExtension1_set_model_ext(msg, extension1, arena.ptr());
+    if (serialized.empty()) {
+      upb_test_ModelWithExtensions_set_random_int32(msg, 10);
+      upb_test_ModelExtension2* extension2 =
+          upb_test_ModelExtension2_new(arena.ptr());
+      upb_test_ModelExtension2_set_i(extension2, 5);
+      upb_test_ModelExtension2_set_model_ext(msg, extension2, arena.ptr());
+      upb_test_ModelExtension2_set_model_ext_2(msg, extension2, arena.ptr());
+    }
+    size_t size;
+    char* buf = upb_test_ModelWithExtensions_serialize(msg, arena.ptr(), &size);
+    ASSERT_NE(buf, nullptr);
+    serialized.append(buf, size);
+  }
+
+  upb_test_ModelWithExtensions* parsed = upb_test_ModelWithExtensions_parse(
+      serialized.data(), serialized.size(), arena.ptr());
+  ASSERT_NE(parsed, nullptr);
+  EXPECT_EQ(0, upb_Message_ExtensionCount(UPB_UPCAST(parsed)));
+
+  // Only the extensions in the registry are promoted.
+  upb_ExtensionRegistry* extreg = upb_ExtensionRegistry_New(arena.ptr());
+  ASSERT_EQ(kUpb_ExtensionRegistryStatus_Ok,
+            upb_ExtensionRegistry_Add(
+                extreg, &upb_test_ModelExtension1_model_ext_ext));
+  ASSERT_EQ(kUpb_ExtensionRegistryStatus_Ok,
+            upb_ExtensionRegistry_Add(
+                extreg, &upb_test_ModelExtension2_model_ext_ext));
+  EXPECT_EQ(kUpb_DecodeStatus_Ok,
+            upb_Message_PromoteExtensions(
+                UPB_UPCAST(parsed), &upb_0test__ModelWithExtensions_msg_init,
+                extreg, 0, arena.ptr()));
+  EXPECT_EQ(2, upb_Message_ExtensionCount(UPB_UPCAST(parsed)));
+  EXPECT_GT(GetUnknownLength(UPB_UPCAST(parsed)), 0);
+  EXPECT_EQ(10, upb_test_ModelWithExtensions_random_int32(parsed));
+
+  EXPECT_TRUE(upb_test_ModelExtension1_has_model_ext(parsed));
+  const upb_test_ModelExtension1* ext1 =
+      upb_test_ModelExtension1_model_ext(parsed);
+  EXPECT_TRUE(upb_StringView_IsEqual(upb_StringView_FromString("World"),
+                                     upb_test_ModelExtension1_str(ext1)));
+  EXPECT_TRUE(upb_test_ModelExtension2_has_model_ext(parsed));
+  EXPECT_EQ(5, upb_test_ModelExtension2_i(
+                   upb_test_ModelExtension2_model_ext(parsed)));
+  EXPECT_FALSE(upb_test_ModelExtension2_has_model_ext_2(parsed));
+
+  // The unknown field left is still found by the single lookup.
+  upb_MessageValue value;
+  EXPECT_EQ(kUpb_GetExtension_Ok,
+            upb_Message_GetOrPromoteExtension(
+                UPB_UPCAST(parsed), &upb_test_ModelExtension2_model_ext_2_ext,
+                0, arena.ptr(), &value));
+  EXPECT_EQ(5, upb_test_ModelExtension2_i(
+                   (const upb_test_ModelExtension2*)value.msg_val));
+  EXPECT_EQ(0, GetUnknownLength(UPB_UPCAST(parsed)));
+}
+
 TEST(GeneratedCode, PromoteUnknownMessage) {
   upb::Arena arena;
   upb_test_ModelWithSubMessages* input_msg =
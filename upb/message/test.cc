@@ -441,6 +441,91 @@ TEST(MessageTest, TestBadUTF8) {
                          serialized.data(), serialized.size(), arena.ptr()));
 }
 
+TEST(MessageTest, DecodeReuseStorage) {
+  upb::Arena arena;
+  const upb_MiniTable* m =
+      &protobuf_0test_0messages__proto3__TestAllTypesProto3_msg_init;
+  size_t size;
+
+  protobuf_test_messages_proto3_TestAllTypesProto3* src =
+      protobuf_test_messages_proto3_TestAllTypesProto3_new(arena.ptr());
+  protobuf_test_messages_proto3_TestAllTypesProto3_NestedMessage_set_a(
+      protobuf_test_messages_proto3_TestAllTypesProto3_mutable_optional_nested_message(
+          src, arena.ptr()),
+      1);
+  for (int i = 0; i < 2; i++) {
+    protobuf_test_messages_proto3_TestAllTypesProto3_NestedMessage_set_a(
+        protobuf_test_messages_proto3_TestAllTypesProto3_add_repeated_nested_message(
+            src, arena.ptr()),
+        2 + i);
+  }
+  protobuf_test_messages_proto3_TestAllTypesProto3_add_repeated_int32(
+      src, 4, arena.ptr());
+  char* first = protobuf_test_messages_proto3_TestAllTypesProto3_serialize(
+      src, arena.ptr(), &size);
+  ASSERT_NE(nullptr, first);
+  std::string first_bytes(first, size);
+
+  protobuf_test_messages_proto3_TestAllTypesProto3_clear_optional_nested_message(
+      src);
+  protobuf_test_messages_proto3_TestAllTypesProto3_clear_repeated_int32(src);
+  protobuf_test_messages_proto3_TestAllTypesProto3_resize_repeated_nested_message(
+      src, 1, arena.ptr());
+  char* second = protobuf_test_messages_proto3_TestAllTypesProto3_serialize(
+      src, arena.ptr(), &size);
+  ASSERT_NE(nullptr, second);
+  std::string second_bytes(second, size);
+
+  upb::Arena decode_arena;
+  protobuf_test_messages_proto3_TestAllTypesProto3* msg =
+      protobuf_test_messages_proto3_TestAllTypesProto3_new(decode_arena.ptr());
+  ASSERT_EQ(kUpb_DecodeStatus_Ok,
+            upb_Decode(first_bytes.data(), first_bytes.size(), UPB_UPCAST(msg),
+                       m, nullptr, kUpb_DecodeOption_ReuseStorage,
+                       decode_arena.ptr()));
+  const protobuf_test_messages_proto3_TestAllTypesProto3_NestedMessage* const*
+      nested =
+          protobuf_test_messages_proto3_TestAllTypesProto3_repeated_nested_message(
+              msg, &size);
+  ASSERT_EQ(2, size);
+  const protobuf_test_messages_proto3_TestAllTypesProto3_NestedMessage*
+      first_nested = nested[0];
+
+  ASSERT_EQ(kUpb_DecodeStatus_Ok,
+            upb_Decode(second_bytes.data(), second_bytes.size(),
+                       UPB_UPCAST(msg), m, nullptr,
+                       kUpb_DecodeOption_ReuseStorage, decode_arena.ptr()));
+  EXPECT_FALSE(
+      protobuf_test_messages_proto3_TestAllTypesProto3_has_optional_nested_message(
+          msg));
+  EXPECT_EQ(
+      nullptr,
+      protobuf_test_messages_proto3_TestAllTypesProto3_optional_nested_message(
+          msg));
+  protobuf_test_messages_proto3_TestAllTypesProto3_repeated_int32(msg, &size);
+  EXPECT_EQ(0, size);
+  nested =
+      protobuf_test_messages_proto3_TestAllTypesProto3_repeated_nested_message(
+          msg, &size);
+  ASSERT_EQ(1, size);
+  // The element was cleared and decoded into again.
+  EXPECT_EQ(first_nested, nested[0]);
+  EXPECT_EQ(2, protobuf_test_messages_proto3_TestAllTypesProto3_NestedMessage_a(
+                   nested[0]));
+
+  // Decoding the same payload again allocates nothing.
+  uintptr_t used = upb_Arena_SpaceAllocated(decode_arena.ptr(), nullptr);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(kUpb_DecodeStatus_Ok,
+              upb_Decode(first_bytes.data(), first_bytes.size(),
+                         UPB_UPCAST(msg), m, nullptr,
+                         kUpb_DecodeOption_ReuseStorage |
+                             kUpb_DecodeOption_AliasString,
+                         decode_arena.ptr()));
+  }
+  EXPECT_EQ(used, upb_Arena_SpaceAllocated(decode_arena.ptr(), nullptr));
+}
+
 TEST(MessageTest, DecodeRequiredFieldsTopLevelMessage) {
   upb::Arena arena;
   upb_test_TestRequiredFields* test_msg;
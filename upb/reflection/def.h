@@ -17,6 +17,7 @@
 #include "upb/reflection/file_def.h"
 #include "upb/reflection/message_def.h"
 #include "upb/reflection/method_def.h"
+#include "upb/reflection/mini_table_cache.h"
 #include "upb/reflection/oneof_def.h"
 #include "upb/reflection/service_def.h"
 // IWYU pragma: end_exports
@@ -21,6 +21,7 @@
 #include "upb/reflection/internal/field_def.h"
 #include "upb/reflection/internal/file_def.h"
 #include "upb/reflection/internal/message_def.h"
+#include "upb/reflection/internal/mini_table_cache.h"
 #include "upb/reflection/internal/service_def.h"
 #include "upb/reflection/internal/upb_edition_defaults.h"
 
@@ -35,6 +36,7 @@ struct upb_DefPool {
   upb_ExtensionRegistry* extreg;
   const UPB_DESC(FeatureSetDefaults) * feature_set_defaults;
   upb_MiniTablePlatform platform;
+  upb_MiniTableCache* mini_table_cache;
   void* scratch_data;
   size_t scratch_size;
   size_t bytes_loaded;
@@ -67,6 +69,7 @@ upb_DefPool* upb_DefPool_New(void) {
   if (!s->extreg) goto err;
 
   s->platform = kUpb_MiniTablePlatform_Native;
+  s->mini_table_cache = NULL;
 
   upb_Status status;
   if (!upb_DefPool_SetFeatureSetDefaults(
@@ -146,6 +149,10 @@ bool _upb_DefPool_InsertExt(upb_DefPool* s, const upb_MiniTableExtension* ext,
                              s->arena);
 }
 
+bool _upb_DefPool_ReserveSyms(upb_DefPool* s, size_t count) {
+  return upb_strtable_reserve(&s->syms, count, s->arena);
+}
+
 bool _upb_DefPool_InsertSym(upb_DefPool* s, upb_StringView sym, upb_value v,
                             upb_Status* status) {
   // TODO: table should support an operation "tryinsert" to avoid the double
@@ -191,6 +198,19 @@ void _upb_DefPool_SetPlatform(upb_DefPool* s, upb_MiniTablePlatform platform) {
   s->platform = platform;
 }
 
+bool upb_DefPool_SetMiniTableCache(upb_DefPool* s, upb_MiniTableCache* c) {
+  UPB_ASSERT(upb_strtable_count(&s->files) == 0);
+  if (!upb_Arena_RefArena(s->arena, _upb_MiniTableCache_Arena(c))) {
+    return false;
+  }
+  s->mini_table_cache = c;
+  return true;
+}
+
+upb_MiniTableCache* _upb_DefPool_MiniTableCache(const upb_DefPool* s) {
+  return s->mini_table_cache;
+}
+
 const upb_MessageDef* upb_DefPool_FindMessageByName(const upb_DefPool* s,
                                                     const char* sym) {
   return _upb_DefPool_Unpack(s, sym, strlen(sym), UPB_DEFTYPE_MSG);
@@ -14,6 +14,7 @@
 #include "upb/base/string_view.h"
 #include "upb/reflection/common.h"
 #include "upb/reflection/def_type.h"
+#include "upb/reflection/mini_table_cache.h"
 
 // Must be last.
 #include "upb/port/def.inc"
@@ -34,6 +35,12 @@ UPB_API bool upb_DefPool_SetFeatureSetDefaults(upb_DefPool* s,
                                                size_t serialized_len,
                                                upb_Status* status);
 
+// Makes the pool take the MiniTables of the files added to it from `c`, and
+// keeps the cached tables alive as long as the pool.  Must be called before
+// any file is added.  Returns false on allocation failure.
+UPB_API bool upb_DefPool_SetMiniTableCache(upb_DefPool* s,
+                                           upb_MiniTableCache* c);
+
 UPB_API const upb_MessageDef* upb_DefPool_FindMessageByName(
     const upb_DefPool* s, const char* sym);
 
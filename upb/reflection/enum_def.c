@@ -24,10 +24,12 @@
 #include "upb/reflection/def.h"
 #include "upb/reflection/def_type.h"
 #include "upb/reflection/internal/def_builder.h"
+#include "upb/reflection/internal/def_pool.h"
 #include "upb/reflection/internal/desc_state.h"
 #include "upb/reflection/internal/enum_reserved_range.h"
 #include "upb/reflection/internal/enum_value_def.h"
 #include "upb/reflection/internal/file_def.h"
+#include "upb/reflection/internal/mini_table_cache.h"
 #include "upb/reflection/internal/strdup2.h"
 
 // Must be last.
@@ -209,17 +211,49 @@ bool upb_EnumDef_MiniDescriptorEncode(const upb_EnumDef* e, upb_Arena* a,
   return true;
 }
 
-static upb_MiniTableEnum* create_enumlayout(upb_DefBuilder* ctx,
-                                            const upb_EnumDef* e) {
+static const upb_MiniTableEnum* create_enumlayout(upb_DefBuilder* ctx,
+                                                  const upb_EnumDef* e) {
   upb_StringView sv;
   bool ok = upb_EnumDef_MiniDescriptorEncode(e, ctx->tmp_arena, &sv);
   if (!ok) _upb_DefBuilder_Errf(ctx, "OOM while building enum MiniDescriptor");
 
   upb_Status status;
-  upb_MiniTableEnum* layout =
-      upb_MiniTableEnum_Build(sv.data, sv.size, ctx->arena, &status);
-  if (!layout)
+  upb_MiniTableCache* cache = _upb_DefPool_MiniTableCache(ctx->symtab);
+  if (!cache) {
+    upb_MiniTableEnum* layout =
+        upb_MiniTableEnum_Build(sv.data, sv.size, ctx->arena, &status);
+    if (!layout) {
+      _upb_DefBuilder_Errf(ctx, "Error building enum MiniTable: %s",
+                           status.msg);
+    }
+    return layout;
+  }
+
+  // Enum tables link to nothing, so their MiniDescriptor is the whole key.  It
+  // starts with a byte that file keys never start with.
+  char* key = upb_Arena_Malloc(ctx->tmp_arena, sv.size + 1);
+  if (!key) _upb_DefBuilder_OomErr(ctx);
+  key[0] = 'E';
+  memcpy(key + 1, sv.data, sv.size);
+
+  upb_value v;
+  const upb_MiniTableEnum* layout = NULL;
+  bool oom = false;
+  _upb_MiniTableCache_Lock(cache);
+  if (_upb_MiniTableCache_Lookup(cache, key, sv.size + 1, &v)) {
+    layout = upb_value_getconstptr(v);
+  } else {
+    layout = upb_MiniTableEnum_Build(
+        sv.data, sv.size, _upb_MiniTableCache_Arena(cache), &status);
+    oom = layout && !_upb_MiniTableCache_Insert(cache, key, sv.size + 1,
+                                                upb_value_constptr(layout));
+  }
+  _upb_MiniTableCache_Unlock(cache);
+
+  if (!layout) {
     _upb_DefBuilder_Errf(ctx, "Error building enum MiniTable: %s", status.msg);
+  }
+  if (oom) _upb_DefBuilder_OomErr(ctx);
   return layout;
 }
 
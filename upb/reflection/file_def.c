@@ -205,6 +205,34 @@ static int count_exts_in_msg(const UPB_DESC(DescriptorProto) * msg_proto) {
   return ext_count;
 }
 
+static size_t count_syms_in_enums(
+    const UPB_DESC(EnumDescriptorProto) * const* enums, size_t n) {
+  size_t count = n;
+  for (size_t i = 0; i < n; i++) {
+    size_t values;
+    UPB_DESC(EnumDescriptorProto_value)(enums[i], &values);
+    count += values;
+  }
+  return count;
+}
+
+// Counts the symbols that `msg_proto` adds to the pool, other than extensions:
+// itself, and its nested messages, enums and enum values.
+static size_t count_syms_in_msg(const UPB_DESC(DescriptorProto) * msg_proto) {
+  size_t n;
+  size_t count = 1;
+  const UPB_DESC(EnumDescriptorProto)* const* enums =
+      UPB_DESC(DescriptorProto_enum_type)(msg_proto, &n);
+  count += count_syms_in_enums(enums, n);
+
+  const UPB_DESC(DescriptorProto)* const* nested_msgs =
+      UPB_DESC(DescriptorProto_nested_type)(msg_proto, &n);
+  for (size_t i = 0; i < n; i++) {
+    count += count_syms_in_msg(nested_msgs[i]);
+  }
+  return count;
+}
+
 const UPB_DESC(FeatureSet*)
     _upb_FileDef_FindEdition(upb_DefBuilder* ctx, int edition) {
   const UPB_DESC(FeatureSetDefaults)* defaults =
@@ -401,6 +429,21 @@ void _upb_FileDef_Create(upb_DefBuilder* ctx,
     mutable_weak_deps[i] = weak_deps[i];
   }
 
+  // Size the symbol table once for every symbol of the file, rather than
+  // growing it step by step as they are added.
+  size_t sym_count = file->ext_count;
+  UPB_DESC(FileDescriptorProto_service)(file_proto, &n);
+  sym_count += n;
+  enums = UPB_DESC(FileDescriptorProto_enum_type)(file_proto, &n);
+  sym_count += count_syms_in_enums(enums, n);
+  msgs = UPB_DESC(FileDescriptorProto_message_type)(file_proto, &n);
+  for (size_t i = 0; i < n; i++) {
+    sym_count += count_syms_in_msg(msgs[i]);
+  }
+  if (!_upb_DefPool_ReserveSyms(ctx->symtab, sym_count)) {
+    _upb_DefBuilder_OomErr(ctx);
+  }
+
   // Create enums.
   enums = UPB_DESC(FileDescriptorProto_enum_type)(file_proto, &n);
   file->top_lvl_enum_count = n;
@@ -437,9 +480,27 @@ void _upb_FileDef_Create(upb_DefBuilder* ctx,
     _upb_FieldDef_Resolve(ctx, file->package, f);
   }
 
-  for (int i = 0; i < file->top_lvl_msg_count; i++) {
-    upb_MessageDef* m = (upb_MessageDef*)upb_FileDef_TopLevelMessage(file, i);
-    _upb_MessageDef_CreateMiniTable(ctx, (upb_MessageDef*)m);
+  // Messages of a file may refer to each other in cycles, so iterate until no
+  // more messages can be found to reach a required field.
+  bool changed;
+  do {
+    changed = false;
+    for (int i = 0; i < file->top_lvl_msg_count; i++) {
+      upb_MessageDef* m =
+          (upb_MessageDef*)upb_FileDef_TopLevelMessage(file, i);
+      if (_upb_MessageDef_UpdateCanReachRequired(m)) changed = true;
+    }
+  } while (changed);
+
+  if (!ctx->layout && _upb_DefPool_MiniTableCache(ctx->symtab)) {
+    _upb_MessageDefs_CreateCachedMiniTables(
+        ctx, (upb_MessageDef*)file->top_lvl_msgs, file->top_lvl_msg_count);
+  } else {
+    for (int i = 0; i < file->top_lvl_msg_count; i++) {
+      upb_MessageDef* m =
+          (upb_MessageDef*)upb_FileDef_TopLevelMessage(file, i);
+      _upb_MessageDef_CreateMiniTable(ctx, (upb_MessageDef*)m);
+    }
   }
 
   for (int i = 0; i < file->top_lvl_ext_count; i++) {
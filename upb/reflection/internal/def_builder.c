@@ -11,7 +11,7 @@
 
 #include "upb/base/internal/log2.h"
 #include "upb/base/upcast.h"
-#include "upb/mem/alloc.h"
+#include "upb/mem/arena.h"
 #include "upb/message/copy.h"
 #include "upb/reflection/def_pool.h"
 #include "upb/reflection/def_type.h"
@@ -99,6 +99,16 @@ const char* _upb_DefBuilder_MakeFullName(upb_DefBuilder* ctx,
   }
 }
 
+// Returns ctx->tmp_buf, grown to at least `size` bytes.
+static char* _upb_DefBuilder_TmpBuf(upb_DefBuilder* ctx, size_t size) {
+  if (ctx->tmp_buf_size < size) {
+    ctx->tmp_buf_size = UPB_MAX(64, upb_RoundUpToPowerOfTwo(size));
+    ctx->tmp_buf = upb_Arena_Malloc(ctx->tmp_arena, ctx->tmp_buf_size);
+    if (!ctx->tmp_buf) _upb_DefBuilder_OomErr(ctx);
+  }
+  return ctx->tmp_buf;
+}
+
 static bool remove_component(char* base, size_t* len) {
   if (*len == 0) return false;
 
@@ -126,9 +136,10 @@ const void* _upb_DefBuilder_ResolveAny(upb_DefBuilder* ctx,
       goto notfound;
     }
   } else {
-    // Remove components from base until we find an entry or run out.
+    // Remove components from base until we find an entry or run out.  The
+    // candidates are built in the reusable temporary buffer.
     size_t baselen = base ? strlen(base) : 0;
-    char* tmp = upb_gmalloc(sym.size + baselen + 1);
+    char* tmp = _upb_DefBuilder_TmpBuf(ctx, sym.size + baselen + 1);
     while (1) {
       char* p = tmp;
       if (baselen) {
@@ -141,12 +152,8 @@ const void* _upb_DefBuilder_ResolveAny(upb_DefBuilder* ctx,
       if (_upb_DefPool_LookupSym(ctx->symtab, tmp, p - tmp, &v)) {
         break;
       }
-      if (!remove_component(tmp, &baselen)) {
-        upb_gfree(tmp);
-        goto notfound;
-      }
+      if (!remove_component(tmp, &baselen)) goto notfound;
     }
-    upb_gfree(tmp);
   }
 
   *type = _upb_DefType_Type(v);
@@ -349,15 +356,10 @@ upb_StringView _upb_DefBuilder_MakeKey(upb_DefBuilder* ctx,
                                        const UPB_DESC(FeatureSet*) parent,
                                        upb_StringView key) {
   size_t need = key.size + sizeof(void*);
-  if (ctx->tmp_buf_size < need) {
-    ctx->tmp_buf_size = UPB_MAX(64, upb_RoundUpToPowerOfTwo(need));
-    ctx->tmp_buf = upb_Arena_Malloc(ctx->tmp_arena, ctx->tmp_buf_size);
-    if (!ctx->tmp_buf) _upb_DefBuilder_OomErr(ctx);
-  }
-
-  memcpy(ctx->tmp_buf, &parent, sizeof(void*));
-  memcpy(ctx->tmp_buf + sizeof(void*), key.data, key.size);
-  return upb_StringView_FromDataAndSize(ctx->tmp_buf, need);
+  char* buf = _upb_DefBuilder_TmpBuf(ctx, need);
+  memcpy(buf, &parent, sizeof(void*));
+  memcpy(buf + sizeof(void*), key.data, key.size);
+  return upb_StringView_FromDataAndSize(buf, need);
 }
 
 bool _upb_DefBuilder_GetOrCreateFeatureSet(upb_DefBuilder* ctx,
@@ -24,6 +24,8 @@ upb_ExtensionRegistry* _upb_DefPool_ExtReg(const upb_DefPool* s);
 
 bool _upb_DefPool_InsertExt(upb_DefPool* s, const upb_MiniTableExtension* ext,
                             const upb_FieldDef* f);
+// Makes room for `count` more symbols.
+bool _upb_DefPool_ReserveSyms(upb_DefPool* s, size_t count);
 bool _upb_DefPool_InsertSym(upb_DefPool* s, upb_StringView sym, upb_value v,
                             upb_Status* status);
 bool _upb_DefPool_LookupSym(const upb_DefPool* s, const char* sym, size_t size,
@@ -32,6 +34,8 @@ bool _upb_DefPool_LookupSym(const upb_DefPool* s, const char* sym, size_t size,
 void** _upb_DefPool_ScratchData(const upb_DefPool* s);
 size_t* _upb_DefPool_ScratchSize(const upb_DefPool* s);
 void _upb_DefPool_SetPlatform(upb_DefPool* s, upb_MiniTablePlatform platform);
+// NULL unless upb_DefPool_SetMiniTableCache() was called.
+upb_MiniTableCache* _upb_DefPool_MiniTableCache(const upb_DefPool* s);
 
 // For generated code only: loads a generated descriptor.
 typedef struct _upb_DefPool_Init {
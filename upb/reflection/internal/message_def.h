@@ -8,6 +8,8 @@
 #ifndef UPB_REFLECTION_MESSAGE_DEF_INTERNAL_H_
 #define UPB_REFLECTION_MESSAGE_DEF_INTERNAL_H_
 
+#include <stdint.h>
+
 #include "upb/reflection/message_def.h"
 
 // Must be last.
@@ -17,18 +19,49 @@
 extern "C" {
 #endif
 
+// Lets upb_Message_Next() find the set fields of a message from its hasbits,
+// instead of testing every field.  Indexed fields are the fields of the
+// MiniTable that have a hasbit and are not required; their hasbits increase
+// with their field index.
+typedef struct {
+  // The field index of each indexed field, by hasbit - hasbit_begin.
+  const uint16_t* hasbit_field;
+  // For each field index i, and for the field count, the hasbit of the first
+  // indexed field at or after i, or hasbit_end.
+  const uint16_t* next_hasbit;
+  // For each field index i, and for the field count, the first field at or
+  // after i that is not indexed, or the field count.
+  const uint16_t* next_other;
+  // For each field index, the index of the field in upb_MessageDef_Field().
+  const uint16_t* def_index;
+  uint16_t hasbit_begin;
+  uint16_t hasbit_end;
+} _upb_FieldPresenceIndex;
+
 upb_MessageDef* _upb_MessageDef_At(const upb_MessageDef* m, int i);
 bool _upb_MessageDef_InMessageSet(const upb_MessageDef* m);
+// Returns NULL if the hasbits of the MiniTable are not laid out as above.
+const _upb_FieldPresenceIndex* _upb_MessageDef_PresenceIndex(
+    const upb_MessageDef* m);
 bool _upb_MessageDef_Insert(upb_MessageDef* m, const char* name, size_t size,
                             upb_value v, upb_Arena* a);
 void _upb_MessageDef_InsertField(upb_DefBuilder* ctx, upb_MessageDef* m,
                                  const upb_FieldDef* f);
 bool _upb_MessageDef_IsValidExtensionNumber(const upb_MessageDef* m, int n);
 void _upb_MessageDef_CreateMiniTable(upb_DefBuilder* ctx, upb_MessageDef* m);
+// In place of _upb_MessageDef_CreateMiniTable(), when the pool has a MiniTable
+// cache: takes linked tables for the `n` messages `msgs` of a file, and their
+// nested messages, from the cache, or builds and links them into it.
+void _upb_MessageDefs_CreateCachedMiniTables(upb_DefBuilder* ctx,
+                                             upb_MessageDef* msgs, int n);
 void _upb_MessageDef_LinkMiniTable(upb_DefBuilder* ctx,
                                    const upb_MessageDef* m);
 void _upb_MessageDef_Resolve(upb_DefBuilder* ctx, upb_MessageDef* m);
 
+// Sets can_reach_required on |m| and its nested messages where one of their
+// fields now reaches a required field, returning true if anything changed.
+bool _upb_MessageDef_UpdateCanReachRequired(upb_MessageDef* m);
+
 // Allocate and initialize an array of |n| message defs.
 upb_MessageDef* _upb_MessageDefs_New(upb_DefBuilder* ctx, int n,
                                      const UPB_DESC(DescriptorProto*)
@@ -0,0 +1,43 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2023 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef UPB_REFLECTION_INTERNAL_MINI_TABLE_CACHE_H_
+#define UPB_REFLECTION_INTERNAL_MINI_TABLE_CACHE_H_
+
+#include <stddef.h>
+
+#include "upb/hash/common.h"
+#include "upb/mem/arena.h"
+#include "upb/reflection/mini_table_cache.h"
+
+// Must be last.
+#include "upb/port/def.inc"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Every other function below must be called between these two.  Nothing may
+// longjmp() out while the lock is held.
+void _upb_MiniTableCache_Lock(upb_MiniTableCache* c);
+void _upb_MiniTableCache_Unlock(upb_MiniTableCache* c);
+
+// The arena that cached tables are allocated from.
+upb_Arena* _upb_MiniTableCache_Arena(upb_MiniTableCache* c);
+
+bool _upb_MiniTableCache_Lookup(const upb_MiniTableCache* c, const char* key,
+                                size_t size, upb_value* v);
+bool _upb_MiniTableCache_Insert(upb_MiniTableCache* c, const char* key,
+                                size_t size, upb_value v);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#include "upb/port/undef.inc"
+
+#endif /* UPB_REFLECTION_INTERNAL_MINI_TABLE_CACHE_H_ */
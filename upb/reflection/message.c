@@ -24,6 +24,7 @@
 #include "upb/mini_table/message.h"
 #include "upb/reflection/def.h"
 #include "upb/reflection/def_pool.h"
+#include "upb/reflection/internal/message_def.h"
 #include "upb/reflection/message_def.h"
 #include "upb/reflection/oneof_def.h"
 
@@ -132,41 +133,91 @@ void upb_Message_ClearByDef(upb_Message* msg, const upb_MessageDef* m) {
   upb_Message_Clear(msg, upb_MessageDef_MiniTable(m));
 }
 
+// Returns the first set hasbit in [h, end), or `end`.
+static size_t _upb_Message_NextSetHasbit(const upb_Message* msg, size_t h,
+                                         size_t end) {
+  const char* mem = (const char*)msg;
+  while (h < end) {
+    if (h % 8 == 0 && end - h >= 64) {
+      uint64_t word;
+      memcpy(&word, mem + h / 8, sizeof(word));
+      if (word == 0) {
+        h += 64;
+        continue;
+      }
+    }
+    uint8_t byte = (uint8_t)mem[h / 8] >> (h % 8);
+    if (byte == 0) {
+      h = (h | 7) + 1;
+      continue;
+    }
+    for (; !(byte & 1); byte >>= 1) h++;
+    return UPB_MIN(h, end);
+  }
+  return end;
+}
+
+// Returns the first field at or after `i` that is indexed and set, or `n`.
+static size_t _upb_Message_NextIndexedField(
+    const upb_Message* msg, const _upb_FieldPresenceIndex* index, size_t i,
+    size_t n) {
+  const size_t h = _upb_Message_NextSetHasbit(msg, index->next_hasbit[i],
+                                              index->hasbit_end);
+  if (h == index->hasbit_end) return n;
+  return index->hasbit_field[h - index->hasbit_begin];
+}
+
+static bool _upb_Message_FieldIsSet(const upb_Message* msg,
+                                    const upb_MiniTableField* field,
+                                    const upb_MessageValue* val) {
+  if (upb_MiniTableField_HasPresence(field)) {
+    return upb_Message_HasBaseField(msg, field);
+  }
+  switch (UPB_PRIVATE(_upb_MiniTableField_Mode)(field)) {
+    case kUpb_FieldMode_Map:
+      return val->map_val && upb_Map_Size(val->map_val) != 0;
+    case kUpb_FieldMode_Array:
+      return val->array_val && upb_Array_Size(val->array_val) != 0;
+    case kUpb_FieldMode_Scalar:
+      return !UPB_PRIVATE(_upb_MiniTableField_DataIsZero)(field, val);
+  }
+  UPB_UNREACHABLE();
+}
+
 bool upb_Message_Next(const upb_Message* msg, const upb_MessageDef* m,
                       const upb_DefPool* ext_pool, const upb_FieldDef** out_f,
                       upb_MessageValue* out_val, size_t* iter) {
   const upb_MiniTable* mt = upb_MessageDef_MiniTable(m);
+  const _upb_FieldPresenceIndex* index = _upb_MessageDef_PresenceIndex(m);
   size_t i = *iter;
   size_t n = upb_MiniTable_FieldCount(mt);
   upb_MessageValue zero = upb_MessageValue_Zero();
   UPB_UNUSED(ext_pool);
 
+  // Indexed fields are found from their hasbits, so only the other fields are
+  // tested one by one.
+  size_t next_set = n;
+  if (index && i + 1 < n) {
+    next_set = _upb_Message_NextIndexedField(msg, index, i + 1, n);
+  }
+
   // Iterate over normal fields, returning the first one that is set.
   while (++i < n) {
+    if (index) {
+      i = UPB_MIN(next_set, index->next_other[i]);
+      if (i == n) break;
+    }
+
     const upb_MiniTableField* field = upb_MiniTable_GetFieldByIndex(mt, i);
     upb_MessageValue val = upb_Message_GetField(msg, field, zero);
 
     // Skip field if unset or empty.
-    if (upb_MiniTableField_HasPresence(field)) {
-      if (!upb_Message_HasBaseField(msg, field)) continue;
-    } else {
-      switch (UPB_PRIVATE(_upb_MiniTableField_Mode)(field)) {
-        case kUpb_FieldMode_Map:
-          if (!val.map_val || upb_Map_Size(val.map_val) == 0) continue;
-          break;
-        case kUpb_FieldMode_Array:
-          if (!val.array_val || upb_Array_Size(val.array_val) == 0) continue;
-          break;
-        case kUpb_FieldMode_Scalar:
-          if (UPB_PRIVATE(_upb_MiniTableField_DataIsZero)(field, &val))
-            continue;
-          break;
-      }
-    }
+    if (i != next_set && !_upb_Message_FieldIsSet(msg, field, &val)) continue;
 
     *out_val = val;
-    *out_f =
-        upb_MessageDef_FindFieldByNumber(m, upb_MiniTableField_Number(field));
+    *out_f = index ? upb_MessageDef_Field(m, index->def_index[i])
+                   : upb_MessageDef_FindFieldByNumber(
+                         m, upb_MiniTableField_Number(field));
     *iter = i;
     return true;
   }
@@ -20,16 +20,20 @@
 #include "upb/mini_descriptor/decode.h"
 #include "upb/mini_descriptor/internal/encode.h"
 #include "upb/mini_descriptor/internal/modifiers.h"
+#include "upb/mini_table/field.h"
 #include "upb/mini_table/file.h"
+#include "upb/mini_table/internal/field.h"
 #include "upb/mini_table/message.h"
 #include "upb/reflection/def.h"
 #include "upb/reflection/internal/def_builder.h"
+#include "upb/reflection/internal/def_pool.h"
 #include "upb/reflection/internal/desc_state.h"
 #include "upb/reflection/internal/enum_def.h"
 #include "upb/reflection/internal/extension_range.h"
 #include "upb/reflection/internal/field_def.h"
 #include "upb/reflection/internal/file_def.h"
 #include "upb/reflection/internal/message_reserved_range.h"
+#include "upb/reflection/internal/mini_table_cache.h"
 #include "upb/reflection/internal/oneof_def.h"
 #include "upb/reflection/internal/strdup2.h"
 
@@ -40,6 +44,7 @@ struct upb_MessageDef {
   const UPB_DESC(MessageOptions*) opts;
   const UPB_DESC(FeatureSet*) resolved_features;
   const upb_MiniTable* layout;
+  const _upb_FieldPresenceIndex* presence_index;
   const upb_FileDef* file;
   const upb_MessageDef* containing_type;
   const char* full_name;
@@ -75,10 +80,8 @@ struct upb_MessageDef {
   int nested_ext_count;
   bool in_message_set;
   bool is_sorted;
+  bool can_reach_required;
   upb_WellKnown well_known_type;
-#if UINTPTR_MAX == 0xffffffff
-  uint32_t padding;  // Increase size to a multiple of 8.
-#endif
 };
 
 static void assign_msg_wellknowntype(upb_MessageDef* m) {
@@ -143,6 +146,10 @@ const UPB_DESC(MessageOptions) *
   return m->opts;
 }
 
+bool upb_MessageDef_CanReachRequired(const upb_MessageDef* m) {
+  return m->can_reach_required;
+}
+
 bool upb_MessageDef_HasOptions(const upb_MessageDef* m) {
   return m->opts != (void*)kUpbDefOptDefault;
 }
@@ -330,6 +337,11 @@ bool _upb_MessageDef_InMessageSet(const upb_MessageDef* m) {
   return m->in_message_set;
 }
 
+const _upb_FieldPresenceIndex* _upb_MessageDef_PresenceIndex(
+    const upb_MessageDef* m) {
+  return m->presence_index;
+}
+
 const upb_FieldDef* upb_MessageDef_FindFieldByName(const upb_MessageDef* m,
                                                    const char* name) {
   return upb_MessageDef_FindFieldByNameWithSize(m, name, strlen(name));
@@ -391,6 +403,33 @@ void _upb_MessageDef_Resolve(upb_DefBuilder* ctx, upb_MessageDef* m) {
   }
 }
 
+bool _upb_MessageDef_UpdateCanReachRequired(upb_MessageDef* m) {
+  bool changed = false;
+  if (!m->can_reach_required) {
+    // Extensions with required fields may be defined in any file, so we have
+    // to assume that an extendable message can reach them.
+    bool reach = m->ext_range_count > 0;
+    for (int i = 0; !reach && i < m->field_count; i++) {
+      const upb_FieldDef* f = upb_MessageDef_Field(m, i);
+      if (upb_FieldDef_IsRequired(f)) {
+        reach = true;
+      } else if (upb_FieldDef_IsSubMessage(f)) {
+        reach = upb_FieldDef_MessageSubDef(f)->can_reach_required;
+      }
+    }
+    if (reach) {
+      m->can_reach_required = true;
+      changed = true;
+    }
+  }
+
+  for (int i = 0; i < upb_MessageDef_NestedMessageCount(m); i++) {
+    upb_MessageDef* n = (upb_MessageDef*)upb_MessageDef_NestedMessage(m, i);
+    if (_upb_MessageDef_UpdateCanReachRequired(n)) changed = true;
+  }
+  return changed;
+}
+
 void _upb_MessageDef_InsertField(upb_DefBuilder* ctx, upb_MessageDef* m,
                                  const upb_FieldDef* f) {
   const int32_t field_number = upb_FieldDef_Number(f);
@@ -465,19 +504,9 @@ void _upb_MessageDef_CreateMiniTable(upb_DefBuilder* ctx, upb_MessageDef* m) {
   }
 }
 
-void _upb_MessageDef_LinkMiniTable(upb_DefBuilder* ctx,
-                                   const upb_MessageDef* m) {
-  for (int i = 0; i < upb_MessageDef_NestedExtensionCount(m); i++) {
-    const upb_FieldDef* ext = upb_MessageDef_NestedExtension(m, i);
-    _upb_FieldDef_BuildMiniTableExtension(ctx, ext);
-  }
-
-  for (int i = 0; i < m->nested_msg_count; i++) {
-    _upb_MessageDef_LinkMiniTable(ctx, upb_MessageDef_NestedMessage(m, i));
-  }
-
-  if (ctx->layout) return;
-
+// Points the fields of `m->layout` at the tables of their submessages and
+// closed enums.  Returns NULL on success, or else what went wrong.
+static const char* _upb_MessageDef_LinkFields(const upb_MessageDef* m) {
   for (int i = 0; i < m->field_count; i++) {
     const upb_FieldDef* f = upb_MessageDef_Field(m, i);
     const upb_MessageDef* sub_m = upb_FieldDef_MessageSubDef(f);
@@ -489,21 +518,107 @@ void _upb_MessageDef_LinkMiniTable(upb_DefBuilder* ctx,
     upb_MiniTableField* mt_f =
         (upb_MiniTableField*)&m->layout->UPB_PRIVATE(fields)[layout_index];
     if (sub_m) {
-      if (!mt->UPB_PRIVATE(subs)) {
-        _upb_DefBuilder_Errf(ctx, "unexpected submsg for (%s)", m->full_name);
-      }
+      if (!mt->UPB_PRIVATE(subs)) return "unexpected submsg";
       UPB_ASSERT(mt_f);
       UPB_ASSERT(sub_m->layout);
       if (UPB_UNLIKELY(!upb_MiniTable_SetSubMessage(mt, mt_f, sub_m->layout))) {
-        _upb_DefBuilder_Errf(ctx, "invalid submsg for (%s)", m->full_name);
+        return "invalid submsg";
       }
     } else if (_upb_FieldDef_IsClosedEnum(f)) {
       const upb_MiniTableEnum* mt_e = _upb_EnumDef_MiniTable(sub_e);
       if (UPB_UNLIKELY(!upb_MiniTable_SetSubEnum(mt, mt_f, mt_e))) {
-        _upb_DefBuilder_Errf(ctx, "invalid subenum for (%s)", m->full_name);
+        return "invalid subenum";
       }
     }
   }
+  return NULL;
+}
+
+static bool _upb_MessageDef_IsIndexedField(const upb_MessageDef* m,
+                                           const uint16_t* def_index, int i) {
+  const upb_MiniTableField* f = upb_MiniTable_GetFieldByIndex(m->layout, i);
+  return UPB_PRIVATE(_upb_MiniTableField_HasHasbit)(f) &&
+         !upb_FieldDef_IsRequired(upb_MessageDef_Field(m, def_index[i]));
+}
+
+// Returns NULL if `m` has no indexed fields, or if their hasbits are not
+// consecutive and in field order, as the MiniDescriptor decoder assigns them.
+static const _upb_FieldPresenceIndex* _upb_MessageDef_BuildPresenceIndex(
+    upb_DefBuilder* ctx, const upb_MessageDef* m) {
+  const int n = upb_MiniTable_FieldCount(m->layout);
+  if (n == 0) return NULL;
+
+  uint16_t* def_index = _upb_DefBuilder_Alloc(ctx, sizeof(*def_index) * n);
+  for (int i = 0; i < m->field_count; i++) {
+    const upb_FieldDef* f = upb_MessageDef_Field(m, i);
+    def_index[_upb_FieldDef_LayoutIndex(f)] = i;
+  }
+
+  int begin = 0;
+  int end = 0;
+  for (int i = 0; i < n; i++) {
+    if (!_upb_MessageDef_IsIndexedField(m, def_index, i)) continue;
+    const int hasbit = upb_MiniTable_GetFieldByIndex(m->layout, i)->presence;
+    if (end == 0) {
+      begin = hasbit;
+    } else if (hasbit != end) {
+      return NULL;
+    }
+    end = hasbit + 1;
+  }
+  if (end == 0) return NULL;
+
+  uint16_t* hasbit_field =
+      _upb_DefBuilder_Alloc(ctx, sizeof(*hasbit_field) * (end - begin));
+  uint16_t* next_hasbit =
+      _upb_DefBuilder_Alloc(ctx, sizeof(*next_hasbit) * (n + 1));
+  uint16_t* next_other =
+      _upb_DefBuilder_Alloc(ctx, sizeof(*next_other) * (n + 1));
+  next_hasbit[n] = end;
+  next_other[n] = n;
+  for (int i = n - 1; i >= 0; i--) {
+    if (_upb_MessageDef_IsIndexedField(m, def_index, i)) {
+      const int hasbit = upb_MiniTable_GetFieldByIndex(m->layout, i)->presence;
+      hasbit_field[hasbit - begin] = i;
+      next_hasbit[i] = hasbit;
+      next_other[i] = next_other[i + 1];
+    } else {
+      next_hasbit[i] = next_hasbit[i + 1];
+      next_other[i] = i;
+    }
+  }
+
+  _upb_FieldPresenceIndex* index = _upb_DefBuilder_Alloc(ctx, sizeof(*index));
+  index->hasbit_field = hasbit_field;
+  index->next_hasbit = next_hasbit;
+  index->next_other = next_other;
+  index->def_index = def_index;
+  index->hasbit_begin = begin;
+  index->hasbit_end = end;
+  return index;
+}
+
+void _upb_MessageDef_LinkMiniTable(upb_DefBuilder* ctx,
+                                   const upb_MessageDef* m) {
+  for (int i = 0; i < upb_MessageDef_NestedExtensionCount(m); i++) {
+    const upb_FieldDef* ext = upb_MessageDef_NestedExtension(m, i);
+    _upb_FieldDef_BuildMiniTableExtension(ctx, ext);
+  }
+
+  for (int i = 0; i < m->nested_msg_count; i++) {
+    _upb_MessageDef_LinkMiniTable(ctx, upb_MessageDef_NestedMessage(m, i));
+  }
+
+  ((upb_MessageDef*)m)->presence_index =
+      _upb_MessageDef_BuildPresenceIndex(ctx, m);
+
+  if (ctx->layout) return;
+
+  // Tables from the MiniTable cache were linked when they were built.
+  if (!_upb_DefPool_MiniTableCache(ctx->symtab)) {
+    const char* err = _upb_MessageDef_LinkFields(m);
+    if (err) _upb_DefBuilder_Errf(ctx, "%s for (%s)", err, m->full_name);
+  }
 
 #ifndef NDEBUG
   for (int i = 0; i < m->field_count; i++) {
@@ -520,6 +635,160 @@ void _upb_MessageDef_LinkMiniTable(upb_DefBuilder* ctx,
 #endif
 }
 
+// The key of the tables of one file in the MiniTable cache.
+typedef struct {
+  char* data;
+  size_t size;
+  size_t capacity;
+} _upb_MiniTableCacheKey;
+
+static void _upb_MiniTableCacheKey_Append(upb_DefBuilder* ctx,
+                                          _upb_MiniTableCacheKey* key,
+                                          const void* data, size_t size) {
+  if (key->capacity - key->size < size) {
+    size_t capacity = UPB_MAX(key->capacity * 2, key->size + size);
+    char* p =
+        upb_Arena_Realloc(ctx->tmp_arena, key->data, key->capacity, capacity);
+    if (!p) _upb_DefBuilder_OomErr(ctx);
+    key->data = p;
+    key->capacity = capacity;
+  }
+  memcpy(key->data + key->size, data, size);
+  key->size += size;
+}
+
+static int _upb_MessageDef_CountWithNested(const upb_MessageDef* m) {
+  int n = 1;
+  for (int i = 0; i < m->nested_msg_count; i++) {
+    n += _upb_MessageDef_CountWithNested(&m->nested_msgs[i]);
+  }
+  return n;
+}
+
+static void _upb_MessageDef_CollectWithNested(upb_MessageDef* m,
+                                              upb_MessageDef** msgs, int* n) {
+  msgs[(*n)++] = m;
+  for (int i = 0; i < m->nested_msg_count; i++) {
+    _upb_MessageDef_CollectWithNested((upb_MessageDef*)&m->nested_msgs[i],
+                                      msgs, n);
+  }
+}
+
+void _upb_MessageDefs_CreateCachedMiniTables(upb_DefBuilder* ctx,
+                                             upb_MessageDef* msgs, int n) {
+  upb_MiniTableCache* cache = _upb_DefPool_MiniTableCache(ctx->symtab);
+  UPB_ASSERT(cache && !ctx->layout);
+
+  int count = 0;
+  for (int i = 0; i < n; i++) {
+    count += _upb_MessageDef_CountWithNested(&msgs[i]);
+  }
+  if (count == 0) return;
+
+  upb_MessageDef** all =
+      upb_Arena_Malloc(ctx->tmp_arena, sizeof(*all) * count);
+  upb_StringView* descs =
+      upb_Arena_Malloc(ctx->tmp_arena, sizeof(*descs) * count);
+  upb_inttable index;
+  if (!all || !descs || !upb_inttable_init(&index, ctx->tmp_arena)) {
+    _upb_DefBuilder_OomErr(ctx);
+  }
+  int collected = 0;
+  for (int i = 0; i < n; i++) {
+    _upb_MessageDef_CollectWithNested(&msgs[i], all, &collected);
+  }
+  for (int i = 0; i < count; i++) {
+    if (!upb_inttable_insert(&index, (uintptr_t)all[i], upb_value_int32(i),
+                             ctx->tmp_arena)) {
+      _upb_DefBuilder_OomErr(ctx);
+    }
+  }
+
+  // The key holds the MiniDescriptor of every message of the file, and for
+  // each field that links to another table, either the index of a message of
+  // the file or the address of a table of a dependency.  Those were built
+  // through the cache too, or are generated, so they outlive the entry.
+  _upb_MiniTableCacheKey key = {NULL, 0, 0};
+  const char header[2] = {'F', (char)ctx->platform};
+  _upb_MiniTableCacheKey_Append(ctx, &key, header, sizeof(header));
+  for (int i = 0; i < count; i++) {
+    const upb_MessageDef* m = all[i];
+    // This assigns layout_index for the fields of `m`.
+    if (!upb_MessageDef_MiniDescriptorEncode(m, ctx->tmp_arena, &descs[i])) {
+      _upb_DefBuilder_OomErr(ctx);
+    }
+    const uint32_t size = descs[i].size;
+    _upb_MiniTableCacheKey_Append(ctx, &key, &size, sizeof(size));
+    _upb_MiniTableCacheKey_Append(ctx, &key, descs[i].data, descs[i].size);
+
+    for (int j = 0; j < m->field_count; j++) {
+      const upb_FieldDef* f = upb_MessageDef_Field(m, j);
+      const upb_MessageDef* sub_m = upb_FieldDef_MessageSubDef(f);
+      // Tables are at least pointer aligned, so indexes are tagged with the
+      // low bit.
+      uintptr_t link[2] = {(uintptr_t)_upb_FieldDef_LayoutIndex(f), 0};
+      upb_value v;
+      if (sub_m && upb_inttable_lookup(&index, (uintptr_t)sub_m, &v)) {
+        link[1] = ((uintptr_t)upb_value_getint32(v) << 1) | 1;
+      } else if (sub_m) {
+        link[1] = (uintptr_t)sub_m->layout;
+      } else if (_upb_FieldDef_IsClosedEnum(f)) {
+        link[1] = (uintptr_t)_upb_EnumDef_MiniTable(upb_FieldDef_EnumSubDef(f));
+      } else {
+        continue;
+      }
+      _upb_MiniTableCacheKey_Append(ctx, &key, link, sizeof(link));
+    }
+  }
+
+  // Nothing may longjmp() while the cache is locked, so errors are raised
+  // after unlocking it.
+  bool build_failed = false;
+  bool oom = false;
+  const char* link_err = NULL;
+  const upb_MessageDef* link_err_msg = NULL;
+  upb_value v;
+  _upb_MiniTableCache_Lock(cache);
+  if (_upb_MiniTableCache_Lookup(cache, key.data, key.size, &v)) {
+    const upb_MiniTable* const* tables = upb_value_getconstptr(v);
+    for (int i = 0; i < count; i++) all[i]->layout = tables[i];
+  } else {
+    upb_Arena* arena = _upb_MiniTableCache_Arena(cache);
+    const upb_MiniTable** tables =
+        upb_Arena_Malloc(arena, sizeof(*tables) * count);
+    oom = !tables;
+    for (int i = 0; !oom && i < count; i++) {
+      tables[i] = upb_MiniTable_BuildWithBuf(
+          descs[i].data, descs[i].size, ctx->platform, arena,
+          _upb_DefPool_ScratchData(ctx->symtab),
+          _upb_DefPool_ScratchSize(ctx->symtab), ctx->status);
+      if (!tables[i]) {
+        build_failed = true;
+        break;
+      }
+      all[i]->layout = tables[i];
+    }
+    for (int i = 0; !oom && !build_failed && i < count; i++) {
+      link_err = _upb_MessageDef_LinkFields(all[i]);
+      if (link_err) {
+        link_err_msg = all[i];
+        break;
+      }
+    }
+    if (!oom && !build_failed && !link_err) {
+      oom = !_upb_MiniTableCache_Insert(cache, key.data, key.size,
+                                        upb_value_constptr(tables));
+    }
+  }
+  _upb_MiniTableCache_Unlock(cache);
+
+  if (build_failed) _upb_DefBuilder_FailJmp(ctx);
+  if (link_err) {
+    _upb_DefBuilder_Errf(ctx, "%s for (%s)", link_err, link_err_msg->full_name);
+  }
+  if (oom) _upb_DefBuilder_OomErr(ctx);
+}
+
 static bool _upb_MessageDef_ValidateUtf8(const upb_MessageDef* m) {
   bool has_string = false;
   for (int i = 0; i < m->field_count; i++) {
@@ -676,6 +945,7 @@ static void create_msgdef(upb_DefBuilder* ctx, const char* prefix,
 
   m->containing_type = containing_type;
   m->is_sorted = true;
+  m->can_reach_required = false;
 
   name = UPB_DESC(DescriptorProto_name)(msg_proto);
 
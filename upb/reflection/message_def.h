@@ -63,6 +63,10 @@ typedef enum {
 extern "C" {
 #endif
 
+// Returns false if no message of this type can have an unset required field,
+// neither in itself nor in any sub-message or extension.
+bool upb_MessageDef_CanReachRequired(const upb_MessageDef* m);
+
 const upb_MessageDef* upb_MessageDef_ContainingType(const upb_MessageDef* m);
 
 const upb_ExtensionRange* upb_MessageDef_ExtensionRange(const upb_MessageDef* m,
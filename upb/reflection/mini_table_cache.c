@@ -0,0 +1,71 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2023 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "upb/reflection/internal/mini_table_cache.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "upb/hash/common.h"
+#include "upb/hash/str_table.h"
+#include "upb/mem/arena.h"
+#include "upb/port/atomic.h"
+
+// Must be last.
+#include "upb/port/def.inc"
+
+struct upb_MiniTableCache {
+  upb_Arena* arena;     // Owns the cache itself and every cached table.
+  upb_strtable tables;  // key -> cached tables
+  UPB_ATOMIC(uintptr_t) lock;
+};
+
+upb_MiniTableCache* upb_MiniTableCache_New(void) {
+  upb_Arena* arena = upb_Arena_New();
+  if (!arena) return NULL;
+  upb_MiniTableCache* c = upb_Arena_Malloc(arena, sizeof(*c));
+  if (!c || !upb_strtable_init(&c->tables, 16, arena)) {
+    upb_Arena_Free(arena);
+    return NULL;
+  }
+  c->arena = arena;
+  upb_Atomic_Init(&c->lock, 0);
+  return c;
+}
+
+void upb_MiniTableCache_Free(upb_MiniTableCache* c) {
+  // Pools using the cache hold references to its arena.
+  upb_Arena_Free(c->arena);
+}
+
+void _upb_MiniTableCache_Lock(upb_MiniTableCache* c) {
+  // Pools only take the lock to look up or build the tables of one file.
+  uintptr_t expected = 0;
+  while (!upb_Atomic_CompareExchangeWeak(&c->lock, &expected, 1,
+                                         memory_order_acquire,
+                                         memory_order_relaxed)) {
+    expected = 0;
+  }
+}
+
+void _upb_MiniTableCache_Unlock(upb_MiniTableCache* c) {
+  upb_Atomic_Store(&c->lock, 0, memory_order_release);
+}
+
+upb_Arena* _upb_MiniTableCache_Arena(upb_MiniTableCache* c) {
+  return c->arena;
+}
+
+bool _upb_MiniTableCache_Lookup(const upb_MiniTableCache* c, const char* key,
+                                size_t size, upb_value* v) {
+  return upb_strtable_lookup2(&c->tables, key, size, v);
+}
+
+bool _upb_MiniTableCache_Insert(upb_MiniTableCache* c, const char* key,
+                                size_t size, upb_value v) {
+  return upb_strtable_insert(&c->tables, key, size, v, c->arena);
+}
@@ -0,0 +1,43 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2023 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// IWYU pragma: private, include "upb/reflection/def.h"
+
+#ifndef UPB_REFLECTION_MINI_TABLE_CACHE_H_
+#define UPB_REFLECTION_MINI_TABLE_CACHE_H_
+
+// Must be last.
+#include "upb/port/def.inc"
+
+// A store of the MiniTables built for the files added to DefPools, shared by
+// every pool it is attached to with upb_DefPool_SetMiniTableCache().
+//
+// Tables are keyed by the MiniDescriptors of a file together with the tables
+// that its messages link to, so a file whose layout was already built for
+// another pool, on top of the same dependencies, reuses the same immutable
+// tables instead of building new ones.  This saves time and memory when many
+// pools load mostly identical schemas.
+//
+// The cache may be used by pools on different threads at the same time.
+typedef struct upb_MiniTableCache upb_MiniTableCache;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+UPB_API upb_MiniTableCache* upb_MiniTableCache_New(void);
+
+// The tables stay alive until every pool that uses them has been freed too.
+UPB_API void upb_MiniTableCache_Free(upb_MiniTableCache* c);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#include "upb/port/undef.inc"
+
+#endif /* UPB_REFLECTION_MINI_TABLE_CACHE_H_ */
@@ -13,15 +13,19 @@
 #include <iostream>
 #include <set>
 #include <sstream>
+#include <string>
 
 #include "google/protobuf/timestamp.upb.h"
 #include "google/protobuf/timestamp.upbdefs.h"
 #include <gtest/gtest.h>
+#include "upb/base/string_view.h"
 #include "upb/base/upcast.h"
 #include "upb/json/decode.h"
 #include "upb/json/encode.h"
 #include "upb/reflection/def.h"
 #include "upb/reflection/def.hpp"
+#include "upb/reflection/internal/def_pool.h"
+#include "upb/reflection/message.h"
 #include "upb/test/test_cpp.upb.h"
 #include "upb/test/test_cpp.upbdefs.h"
 
@@ -103,3 +107,61 @@ TEST(Cpp, TimestampEncoder) {
     EXPECT_EQ(timestamp, timestamp_decoded);
   }
 }
+
+TEST(Cpp, MessageNext) {
+  upb::DefPool defpool;
+  upb::Arena arena;
+  upb::MessageDefPtr md(upb_test_TestMessage_getmsgdef(defpool.ptr()));
+  upb_test_TestMessage* msg = upb_test_TestMessage_new(arena.ptr());
+  upb_test_TestMessage_set_i32(msg, 0);
+  ASSERT_TRUE(upb_test_TestMessage_add_r_i32(msg, 7, arena.ptr()));
+  ASSERT_TRUE(upb_test_TestMessage_mutable_msg(msg, arena.ptr()));
+  upb_test_TestMessage_resize_r_str(msg, 0, arena.ptr());
+
+  auto set_fields = [&]() {
+    std::string names;
+    size_t iter = kUpb_Message_Begin;
+    const upb_FieldDef* f;
+    upb_MessageValue val;
+    while (upb_Message_Next(UPB_UPCAST(msg), md.ptr(), defpool.ptr(), &f,
+                            &val, &iter)) {
+      names += upb_FieldDef_Name(f);
+      names += " ";
+    }
+    return names;
+  };
+
+  EXPECT_EQ(set_fields(), "i32 r_i32 msg ");
+  upb_test_TestMessage_clear_i32(msg);
+  upb_test_TestMessage_clear_msg(msg);
+  EXPECT_EQ(set_fields(), "r_i32 ");
+  upb_test_TestMessage_set_str(msg, upb_StringView_FromString(""));
+  EXPECT_EQ(set_fields(), "r_i32 str ");
+}
+
+TEST(Cpp, MiniTableCacheSharesTables) {
+  upb_MiniTableCache* cache = upb_MiniTableCache_New();
+  ASSERT_TRUE(cache);
+  upb::DefPool pool1;
+  upb::DefPool pool2;
+  upb::DefPool uncached;
+  ASSERT_TRUE(upb_DefPool_SetMiniTableCache(pool1.ptr(), cache));
+  ASSERT_TRUE(upb_DefPool_SetMiniTableCache(pool2.ptr(), cache));
+  // The pools keep the cached tables alive.
+  upb_MiniTableCache_Free(cache);
+
+  for (upb::DefPool* pool : {&pool1, &pool2, &uncached}) {
+    ASSERT_TRUE(_upb_DefPool_LoadDefInitEx(
+        pool->ptr(), &upb_test_test_cpp_proto_upbdefinit,
+        /*rebuild_minitable=*/true));
+  }
+
+  const upb_MiniTable* table1 =
+      pool1.FindMessageByName("upb.test.TestMessage").mini_table();
+  ASSERT_TRUE(table1);
+  EXPECT_EQ(table1,
+            pool2.FindMessageByName("upb.test.TestMessage").mini_table());
+  EXPECT_NE(table1,
+            uncached.FindMessageByName("upb.test.TestMessage").mini_table());
+  EXPECT_NE(table1, &upb_0test__TestMessage_msg_init);
+}
@@ -10,17 +10,23 @@
  * upb/def.c and tests/conformance_upb.c, respectively).
  */
 
+#include <algorithm>
+#include <climits>
 #include <cstddef>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include "google/protobuf/test_messages_proto2.upb.h"
 #include "google/protobuf/test_messages_proto3.upb.h"
 #include "upb/base/status.h"
 #include "upb/base/string_view.h"
+#include "upb/base/upcast.h"
 #include "upb/mem/arena.hpp"
 #include "upb/message/array.h"
 #include "upb/message/map.h"
+#include "upb/message/message.h"
 #include "upb/test/test.upb.h"
 
 // Must be last.
@@ -474,6 +480,41 @@ TEST(GeneratedCode, Bytes) {
   upb_Arena_Free(arena);
 }
 
+TEST(GeneratedCode, EncodeUnpackedFixedAndLongVarints) {
+  upb_Arena* arena = upb_Arena_New();
+  protobuf_test_messages_proto2_TestAllTypesProto2* msg =
+      protobuf_test_messages_proto2_TestAllTypesProto2_new(arena);
+  protobuf_test_messages_proto2_TestAllTypesProto2_set_optional_uint64(
+      msg, uint64_t{1} << 63);
+  for (uint32_t val : {1u, 0xffffffffu, 3u}) {
+    ASSERT_TRUE(
+        protobuf_test_messages_proto2_TestAllTypesProto2_add_repeated_fixed32(
+            msg, val, arena));
+  }
+  for (int64_t val : {-1, 2}) {
+    ASSERT_TRUE(
+        protobuf_test_messages_proto2_TestAllTypesProto2_add_repeated_sfixed64(
+            msg, val, arena));
+  }
+
+  size_t size;
+  char* serialized = protobuf_test_messages_proto2_TestAllTypesProto2_serialize(
+      msg, arena, &size);
+  ASSERT_NE(serialized, nullptr);
+  // Field 37 and 40 have two byte tags.
+  const char expected[] =
+      "\x20\x80\x80\x80\x80\x80\x80\x80\x80\x80\x01"
+      "\xad\x02\x01\x00\x00\x00"
+      "\xad\x02\xff\xff\xff\xff"
+      "\xad\x02\x03\x00\x00\x00"
+      "\xc1\x02\xff\xff\xff\xff\xff\xff\xff\xff"
+      "\xc1\x02\x02\x00\x00\x00\x00\x00\x00\x00";
+  EXPECT_EQ(std::string(serialized, size),
+            std::string(expected, sizeof(expected) - 1));
+
+  upb_Arena_Free(arena);
+}
+
 TEST(GeneratedCode, UTF8) {
   const char invalid_utf8[] = "\xff";
   const upb_StringView invalid_utf8_view =
@@ -781,6 +822,133 @@ TEST(GeneratedCode, Int32Map) {
   upb_Arena_Free(arena);
 }
 
+// Deterministic encoding must order both dense and sparse integer keys,
+// including keys on either side of zero.
+TEST(GeneratedCode, DeterministicInt32MapOrder) {
+  upb::Arena arena;
+  for (const std::vector<int32_t>& keys :
+       {std::vector<int32_t>{3, -2, 0, 4, -1, 1, 2, -3},
+        std::vector<int32_t>{100, -7, 0, 42, INT32_MIN, INT32_MAX}}) {
+    protobuf_test_messages_proto3_TestAllTypesProto3* msg =
+        protobuf_test_messages_proto3_TestAllTypesProto3_new(arena.ptr());
+    for (int32_t key : keys) {
+      protobuf_test_messages_proto3_TestAllTypesProto3_map_int32_int32_set(
+          msg, key, 1, arena.ptr());
+    }
+
+    // Concatenating single-entry encodings in key order gives the expected
+    // output.
+    std::vector<int32_t> sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    std::string expected;
+    for (int32_t key : sorted) {
+      protobuf_test_messages_proto3_TestAllTypesProto3* one =
+          protobuf_test_messages_proto3_TestAllTypesProto3_new(arena.ptr());
+      protobuf_test_messages_proto3_TestAllTypesProto3_map_int32_int32_set(
+          one, key, 1, arena.ptr());
+      size_t size;
+      char* buf = protobuf_test_messages_proto3_TestAllTypesProto3_serialize(
+          one, arena.ptr(), &size);
+      ASSERT_NE(buf, nullptr);
+      expected.append(buf, size);
+    }
+
+    size_t size;
+    char* buf = protobuf_test_messages_proto3_TestAllTypesProto3_serialize_ex(
+        msg, kUpb_EncodeOption_Deterministic, arena.ptr(), &size);
+    ASSERT_NE(buf, nullptr);
+    EXPECT_EQ(std::string(buf, size), expected);
+  }
+}
+
+// With the map order cached, deterministic encoding gives the same output, and
+// modifying a map drops its cached order.
+TEST(GeneratedCode, CachedMapOrder) {
+  upb::Arena arena;
+  protobuf_test_messages_proto3_TestAllTypesProto3* msg =
+      protobuf_test_messages_proto3_TestAllTypesProto3_new(arena.ptr());
+  for (int32_t key : {7, -3, 100, 0, 12}) {
+    protobuf_test_messages_proto3_TestAllTypesProto3_map_int32_int32_set(
+        msg, key, key * 2, arena.ptr());
+  }
+  const char* const keys[] = {"b", "a", "abc", "", "z"};
+  for (const char* key : keys) {
+    protobuf_test_messages_proto3_TestAllTypesProto3_map_string_string_set(
+        msg, upb_StringView_FromString(key), upb_StringView_FromString(key),
+        arena.ptr());
+  }
+
+  auto serialize = [&]() {
+    size_t size;
+    char* buf = protobuf_test_messages_proto3_TestAllTypesProto3_serialize_ex(
+        msg, kUpb_EncodeOption_Deterministic, arena.ptr(), &size);
+    EXPECT_NE(buf, nullptr);
+    return std::string(buf, size);
+  };
+  std::string sorted = serialize();
+
+  const upb_MiniTable* m =
+      &protobuf_0test_0messages__proto3__TestAllTypesProto3_msg_init;
+  ASSERT_TRUE(upb_Message_CacheMapOrder(UPB_UPCAST(msg), m, arena.ptr()));
+  EXPECT_EQ(serialize(), sorted);
+
+  protobuf_test_messages_proto3_TestAllTypesProto3_map_int32_int32_set(
+      msg, 5, 10, arena.ptr());
+  protobuf_test_messages_proto3_TestAllTypesProto3_map_string_string_delete(
+      msg, upb_StringView_FromString("abc"));
+  std::string modified = serialize();
+  EXPECT_NE(modified, sorted);
+
+  protobuf_test_messages_proto3_TestAllTypesProto3* copy =
+      protobuf_test_messages_proto3_TestAllTypesProto3_parse(
+          modified.data(), modified.size(), arena.ptr());
+  ASSERT_NE(copy, nullptr);
+  size_t size;
+  char* buf = protobuf_test_messages_proto3_TestAllTypesProto3_serialize_ex(
+      copy, kUpb_EncodeOption_Deterministic, arena.ptr(), &size);
+  ASSERT_NE(buf, nullptr);
+  EXPECT_EQ(std::string(buf, size), modified);
+}
+
+// Packed varint fields are decoded into arrays sized from the byte length.
+TEST(GeneratedCode, PackedVarintRoundTrip) {
+  upb::Arena arena;
+  protobuf_test_messages_proto3_TestAllTypesProto3* msg =
+      protobuf_test_messages_proto3_TestAllTypesProto3_new(arena.ptr());
+  for (int32_t i = 0; i < 1000; i++) {
+    // Varints of every length, negative int32 values taking ten bytes.
+    int32_t v = i % 3 == 0 ? -i : i << (i % 21);
+    protobuf_test_messages_proto3_TestAllTypesProto3_add_packed_int32(
+        msg, v, arena.ptr());
+    protobuf_test_messages_proto3_TestAllTypesProto3_add_packed_sint64(
+        msg, -int64_t{v} * 1000, arena.ptr());
+  }
+
+  size_t size;
+  char* buf = protobuf_test_messages_proto3_TestAllTypesProto3_serialize(
+      msg, arena.ptr(), &size);
+  ASSERT_NE(buf, nullptr);
+  protobuf_test_messages_proto3_TestAllTypesProto3* parsed =
+      protobuf_test_messages_proto3_TestAllTypesProto3_parse(buf, size,
+                                                             arena.ptr());
+  ASSERT_NE(parsed, nullptr);
+
+  size_t n32, n64;
+  const int32_t* v32 =
+      protobuf_test_messages_proto3_TestAllTypesProto3_packed_int32(parsed,
+                                                                    &n32);
+  const int64_t* v64 =
+      protobuf_test_messages_proto3_TestAllTypesProto3_packed_sint64(parsed,
+                                                                     &n64);
+  ASSERT_EQ(n32, 1000);
+  ASSERT_EQ(n64, 1000);
+  for (int32_t i = 0; i < 1000; i++) {
+    int32_t v = i % 3 == 0 ? -i : i << (i % 21);
+    EXPECT_EQ(v32[i], v);
+    EXPECT_EQ(v64[i], -int64_t{v} * 1000);
+  }
+}
+
 TEST(GeneratedCode, TestRepeated) {
   upb_Arena* arena = upb_Arena_New();
   protobuf_test_messages_proto3_TestAllTypesProto3* msg =
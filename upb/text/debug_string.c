@@ -7,11 +7,9 @@
 
 #include "upb/text/debug_string.h"
 
-#include <inttypes.h>
 #include <stdarg.h>
 #include <stddef.h>
 #include <stdint.h>
-#include <stdio.h>
 #include <string.h>
 
 #include "upb/base/descriptor_constants.h"
@@ -42,20 +40,18 @@ static void _upb_FieldDebugString(txtenc* e, upb_MessageValue val,
   UPB_PRIVATE(_upb_TextEncode_Indent)(e);
   const upb_CType ctype = upb_MiniTableField_CType(f);
   const bool is_ext = upb_MiniTableField_IsExtension(f);
-  char number[10];  // A 32-bit integer can hold up to 10 digits.
-  snprintf(number, sizeof(number), "%" PRIu32, upb_MiniTableField_Number(f));
   // label is to pass down whether we're dealing with a "key" of a map or
   // a "value" of a map.
-  if (!label) label = number;
-
-  if (is_ext) {
-    UPB_PRIVATE(_upb_TextEncode_Printf)(e, "[%s]", label);
+  if (is_ext) UPB_PRIVATE(_upb_TextEncode_PutStr)(e, "[");
+  if (label) {
+    UPB_PRIVATE(_upb_TextEncode_PutStr)(e, label);
   } else {
-    UPB_PRIVATE(_upb_TextEncode_Printf)(e, "%s", label);
+    UPB_PRIVATE(_upb_TextEncode_PutUInt64)(e, upb_MiniTableField_Number(f));
   }
+  if (is_ext) UPB_PRIVATE(_upb_TextEncode_PutStr)(e, "]");
 
   if (ctype == kUpb_CType_Message) {
-    UPB_PRIVATE(_upb_TextEncode_Printf)(e, " {");
+    UPB_PRIVATE(_upb_TextEncode_PutStr)(e, " {");
     UPB_PRIVATE(_upb_TextEncode_EndField)(e);
     e->indent_depth++;
     const upb_MiniTable* subm = ext ? upb_MiniTableExtension_GetSubMessage(ext)
@@ -68,12 +64,12 @@ static void _upb_FieldDebugString(txtenc* e, upb_MessageValue val,
     return;
   }
 
-  UPB_PRIVATE(_upb_TextEncode_Printf)(e, ": ");
+  UPB_PRIVATE(_upb_TextEncode_PutStr)(e, ": ");
 
   if (ctype ==
       kUpb_CType_Enum) {  // Enum has to be processed separately because of
                           // divergent behavior between encoders
-    UPB_PRIVATE(_upb_TextEncode_Printf)(e, "%" PRId32, val.int32_val);
+    UPB_PRIVATE(_upb_TextEncode_PutInt64)(e, val.int32_val);
   } else {
     UPB_PRIVATE(_upb_TextEncode_Scalar)(e, val, ctype);
   }
@@ -106,7 +102,8 @@ static void _upb_MapEntryDebugString(txtenc* e, upb_MessageValue key,
   const upb_MiniTableField* val_f = upb_MiniTable_MapValue(entry);
 
   UPB_PRIVATE(_upb_TextEncode_Indent)(e);
-  UPB_PRIVATE(_upb_TextEncode_Printf)(e, "%u {", upb_MiniTableField_Number(f));
+  UPB_PRIVATE(_upb_TextEncode_PutUInt64)(e, upb_MiniTableField_Number(f));
+  UPB_PRIVATE(_upb_TextEncode_PutStr)(e, " {");
   UPB_PRIVATE(_upb_TextEncode_EndField)(e);
   e->indent_depth++;
 
@@ -7,7 +7,6 @@
 
 #include "upb/text/encode.h"
 
-#include <inttypes.h>
 #include <stdarg.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -39,9 +38,9 @@ static void _upb_TextEncode_Enum(int32_t val, const upb_FieldDef* f,
   const upb_EnumValueDef* ev = upb_EnumDef_FindValueByNumber(e_def, val);
 
   if (ev) {
-    UPB_PRIVATE(_upb_TextEncode_Printf)(e, "%s", upb_EnumValueDef_Name(ev));
+    UPB_PRIVATE(_upb_TextEncode_PutStr)(e, upb_EnumValueDef_Name(ev));
   } else {
-    UPB_PRIVATE(_upb_TextEncode_Printf)(e, "%" PRId32, val);
+    UPB_PRIVATE(_upb_TextEncode_PutInt64)(e, val);
   }
 }
 
@@ -53,12 +52,16 @@ static void _upb_TextEncode_Field(txtenc* e, upb_MessageValue val,
   const char* full = upb_FieldDef_FullName(f);
   const char* name = upb_FieldDef_Name(f);
 
+  if (is_ext) {
+    UPB_PRIVATE(_upb_TextEncode_PutStr)(e, "[");
+    UPB_PRIVATE(_upb_TextEncode_PutStr)(e, full);
+    UPB_PRIVATE(_upb_TextEncode_PutStr)(e, "]");
+  } else {
+    UPB_PRIVATE(_upb_TextEncode_PutStr)(e, name);
+  }
+
   if (ctype == kUpb_CType_Message) {
-    if (is_ext) {
-      UPB_PRIVATE(_upb_TextEncode_Printf)(e, "[%s] {", full);
-    } else {
-      UPB_PRIVATE(_upb_TextEncode_Printf)(e, "%s {", name);
-    }
+    UPB_PRIVATE(_upb_TextEncode_PutStr)(e, " {");
     UPB_PRIVATE(_upb_TextEncode_EndField)(e);
     e->indent_depth++;
     _upb_TextEncode_Msg(e, val.msg_val, upb_FieldDef_MessageSubDef(f));
@@ -69,11 +72,7 @@ static void _upb_TextEncode_Field(txtenc* e, upb_MessageValue val,
     return;
   }
 
-  if (is_ext) {
-    UPB_PRIVATE(_upb_TextEncode_Printf)(e, "[%s]: ", full);
-  } else {
-    UPB_PRIVATE(_upb_TextEncode_Printf)(e, "%s: ", name);
-  }
+  UPB_PRIVATE(_upb_TextEncode_PutStr)(e, ": ");
 
   if (ctype == kUpb_CType_Enum) {
     _upb_TextEncode_Enum(val.int32_val, f, e);
@@ -108,7 +107,8 @@ static void _upb_TextEncode_MapEntry(txtenc* e, upb_MessageValue key,
   const upb_FieldDef* key_f = upb_MessageDef_Field(entry, 0);
   const upb_FieldDef* val_f = upb_MessageDef_Field(entry, 1);
   UPB_PRIVATE(_upb_TextEncode_Indent)(e);
-  UPB_PRIVATE(_upb_TextEncode_Printf)(e, "%s {", upb_FieldDef_Name(f));
+  UPB_PRIVATE(_upb_TextEncode_PutStr)(e, upb_FieldDef_Name(f));
+  UPB_PRIVATE(_upb_TextEncode_PutStr)(e, " {");
   UPB_PRIVATE(_upb_TextEncode_EndField)(e);
   e->indent_depth++;
 
@@ -57,14 +57,15 @@ const char* UPB_PRIVATE(_upb_TextEncode_Unknown)(txtenc* e, const char* ptr,
     if (tag == end_group) return ptr;
 
     UPB_PRIVATE(_upb_TextEncode_Indent)(e);
-    UPB_PRIVATE(_upb_TextEncode_Printf)
-    (e, "%d: ", (int)upb_WireReader_GetFieldNumber(tag));
+    UPB_PRIVATE(_upb_TextEncode_PutUInt64)
+    (e, upb_WireReader_GetFieldNumber(tag));
+    UPB_PRIVATE(_upb_TextEncode_PutBytes)(e, ": ", 2);
 
     switch (upb_WireReader_GetWireType(tag)) {
       case kUpb_WireType_Varint: {
         uint64_t val;
         CHK(ptr = upb_WireReader_ReadVarint(ptr, &val));
-        UPB_PRIVATE(_upb_TextEncode_Printf)(e, "%" PRIu64, val);
+        UPB_PRIVATE(_upb_TextEncode_PutUInt64)(e, val);
         break;
       }
       case kUpb_WireType_32Bit: {
@@ -172,16 +173,16 @@ void UPB_PRIVATE(_upb_TextEncode_Scalar)(txtenc* e, upb_MessageValue val,
       break;
     }
     case kUpb_CType_Int32:
-      UPB_PRIVATE(_upb_TextEncode_Printf)(e, "%" PRId32, val.int32_val);
+      UPB_PRIVATE(_upb_TextEncode_PutInt64)(e, val.int32_val);
       break;
     case kUpb_CType_UInt32:
-      UPB_PRIVATE(_upb_TextEncode_Printf)(e, "%" PRIu32, val.uint32_val);
+      UPB_PRIVATE(_upb_TextEncode_PutUInt64)(e, val.uint32_val);
       break;
     case kUpb_CType_Int64:
-      UPB_PRIVATE(_upb_TextEncode_Printf)(e, "%" PRId64, val.int64_val);
+      UPB_PRIVATE(_upb_TextEncode_PutInt64)(e, val.int64_val);
       break;
     case kUpb_CType_UInt64:
-      UPB_PRIVATE(_upb_TextEncode_Printf)(e, "%" PRIu64, val.uint64_val);
+      UPB_PRIVATE(_upb_TextEncode_PutUInt64)(e, val.uint64_val);
       break;
     case kUpb_CType_String:
       UPB_PRIVATE(_upb_HardenedPrintString)
@@ -9,10 +9,12 @@
 #define UPB_TEXT_ENCODE_INTERNAL_H_
 
 #include <stdarg.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "upb/base/descriptor_constants.h"
 #include "upb/base/string_view.h"
+#include "upb/lex/round_trip.h"
 #include "upb/message/array.h"
 #include "upb/message/internal/map_sorter.h"
 #include "upb/message/message.h"
@@ -72,11 +74,25 @@ UPB_INLINE void UPB_PRIVATE(_upb_TextEncode_Printf)(txtenc* e, const char* fmt,
   }
 }
 
+// Integers are formatted by hand, as printf() spends most of its time parsing
+// the format string.
+UPB_INLINE void UPB_PRIVATE(_upb_TextEncode_PutUInt64)(txtenc* e,
+                                                       uint64_t val) {
+  char buf[kUpb_RoundTripBufferSize];
+  UPB_PRIVATE(_upb_TextEncode_PutBytes)(e, buf, _upb_EncodeUInt64(val, buf));
+}
+
+UPB_INLINE void UPB_PRIVATE(_upb_TextEncode_PutInt64)(txtenc* e,
+                                                      int64_t val) {
+  char buf[kUpb_RoundTripBufferSize];
+  UPB_PRIVATE(_upb_TextEncode_PutBytes)(e, buf, _upb_EncodeInt64(val, buf));
+}
+
 UPB_INLINE void UPB_PRIVATE(_upb_TextEncode_Indent)(txtenc* e) {
   if ((e->options & UPB_TXTENC_SINGLELINE) == 0) {
     int i = e->indent_depth;
     while (i-- > 0) {
-      UPB_PRIVATE(_upb_TextEncode_PutStr)(e, "  ");
+      UPB_PRIVATE(_upb_TextEncode_PutBytes)(e, "  ", 2);
     }
   }
 }
@@ -110,9 +126,12 @@ UPB_INLINE void UPB_PRIVATE(_upb_TextEncode_Escaped)(txtenc* e,
     case '\\':
       UPB_PRIVATE(_upb_TextEncode_PutStr)(e, "\\\\");
       break;
-    default:
-      UPB_PRIVATE(_upb_TextEncode_Printf)(e, "\\%03o", ch);
+    default: {
+      const char octal[4] = {'\\', '0' + (ch >> 6), '0' + ((ch >> 3) & 7),
+                             '0' + (ch & 7)};
+      UPB_PRIVATE(_upb_TextEncode_PutBytes)(e, octal, sizeof(octal));
       break;
+    }
   }
 }
 
@@ -134,6 +153,25 @@ UPB_INLINE bool UPB_PRIVATE(_upb_AsciiIsPrint)(unsigned char ch) {
   return ch >= 32 && ch < 127;
 }
 
+UPB_INLINE uint64_t UPB_PRIVATE(_upb_HasZeroByte)(uint64_t word) {
+  return (word - 0x0101010101010101ULL) & ~word & 0x8080808080808080ULL;
+}
+
+// Returns true if all eight bytes at `ptr` are printable ASCII that is printed
+// as is, i.e. neither `DefinitelyNeedsEscape()` nor `NeedsUtf8Validation()`.
+UPB_INLINE bool UPB_PRIVATE(_upb_WordIsPassthrough)(const char* ptr) {
+  uint64_t word;
+  memcpy(&word, ptr, sizeof(word));
+  const uint64_t ones = 0x0101010101010101ULL;
+  // Bytes below 32 borrow into their high bit, and high bytes have it set.
+  uint64_t bad = ((word - ones * 32) & ~word) | word;
+  bad |= UPB_PRIVATE(_upb_HasZeroByte)(word ^ (ones * 127));
+  bad |= UPB_PRIVATE(_upb_HasZeroByte)(word ^ (ones * '"'));
+  bad |= UPB_PRIVATE(_upb_HasZeroByte)(word ^ (ones * '\''));
+  bad |= UPB_PRIVATE(_upb_HasZeroByte)(word ^ (ones * '\\'));
+  return (bad & 0x8080808080808080ULL) == 0;
+}
+
 // Returns true if this is a high byte that requires UTF-8 validation.  If the
 // UTF-8 validation fails, we must escape the byte.
 UPB_INLINE bool UPB_PRIVATE(_upb_NeedsUtf8Validation)(unsigned char ch) {
@@ -151,6 +189,11 @@ UPB_INLINE bool UPB_PRIVATE(_upb_NeedsUtf8Validation)(unsigned char ch) {
 UPB_INLINE size_t UPB_PRIVATE(_SkipPassthroughBytes)(const char* ptr,
                                                      size_t size) {
   for (size_t i = 0; i < size; i++) {
+    // Plain ASCII is skipped a word at a time.
+    while (size - i >= 8 && UPB_PRIVATE(_upb_WordIsPassthrough)(ptr + i)) {
+      i += 8;
+    }
+    if (i == size) break;
     unsigned char uc = ptr[i];
     if (UPB_PRIVATE(_upb_DefinitelyNeedsEscape)(uc)) return i;
     if (UPB_PRIVATE(_upb_NeedsUtf8Validation)(uc)) {
@@ -205,13 +248,14 @@ UPB_INLINE void UPB_PRIVATE(_upb_TextEncode_Bytes)(txtenc* e,
   const char* ptr = data.data;
   const char* end = ptr + data.size;
   UPB_PRIVATE(_upb_TextEncode_PutStr)(e, "\"");
-  for (; ptr < end; ptr++) {
-    unsigned char uc = *ptr;
-    if (UPB_PRIVATE(_upb_AsciiIsPrint)(uc)) {
-      UPB_PRIVATE(_upb_TextEncode_PutBytes)(e, ptr, 1);
-    } else {
-      UPB_PRIVATE(_upb_TextEncode_Escaped)(e, uc);
-    }
+  while (ptr < end) {
+    // Runs of printable bytes are copied at once.
+    const char* run = ptr;
+    while (ptr < end && UPB_PRIVATE(_upb_AsciiIsPrint)(*ptr)) ptr++;
+    if (ptr != run) UPB_PRIVATE(_upb_TextEncode_PutBytes)(e, run, ptr - run);
+    if (ptr == end) break;
+    UPB_PRIVATE(_upb_TextEncode_Escaped)(e, *ptr);
+    ptr++;
   }
   UPB_PRIVATE(_upb_TextEncode_PutStr)(e, "\"");
 }
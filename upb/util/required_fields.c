@@ -226,9 +226,8 @@ static void upb_util_FindUnsetInMessage(upb_FindContext* ctx,
 static void upb_util_FindUnsetRequiredInternal(upb_FindContext* ctx,
                                                const upb_Message* msg,
                                                const upb_MessageDef* m) {
-  // OPT: add markers in the schema for where we can avoid iterating:
-  // 1. messages with no required fields.
-  // 2. messages that cannot possibly reach any required fields.
+  // Skip whole subtrees that cannot possibly reach any required fields.
+  if (!upb_MessageDef_CanReachRequired(m)) return;
 
   upb_util_FindUnsetInMessage(ctx, msg, m);
   if (!msg) return;
@@ -245,11 +244,12 @@ static void upb_util_FindUnsetRequiredInternal(upb_FindContext* ctx,
   const upb_FieldDef* f;
   upb_MessageValue val;
   while (upb_Message_Next(msg, m, ctx->ext_pool, &f, &val, &iter)) {
-    // Skip non-submessage fields.
+    // Skip non-submessage fields, and those that cannot reach a required field.
     if (!upb_FieldDef_IsSubMessage(f)) continue;
+    const upb_MessageDef* sub_m = upb_FieldDef_MessageSubDef(f);
+    if (!upb_MessageDef_CanReachRequired(sub_m)) continue;
 
     upb_FindContext_Push(ctx, (upb_FieldPathEntry){.field = f});
-    const upb_MessageDef* sub_m = upb_FieldDef_MessageSubDef(f);
 
     if (upb_FieldDef_IsMap(f)) {
       // Map field.
@@ -221,3 +221,36 @@ TYPED_TEST(RequiredFieldsTest, TestRequired) {
       )json",
       {R"(map_string_message["d\"ef"].required_int32)"});
 }
+
+TEST(RequiredFieldsTest, CanReachRequired) {
+  upb::DefPool defpool;
+  EXPECT_FALSE(upb_MessageDef_CanReachRequired(
+      upb_util_test_EmptyMessage_getmsgdef(defpool.ptr())));
+  EXPECT_FALSE(upb_MessageDef_CanReachRequired(
+      upb_util_test_CannotReachRequired_getmsgdef(defpool.ptr())));
+  EXPECT_TRUE(upb_MessageDef_CanReachRequired(
+      upb_util_test_HasRequiredField_getmsgdef(defpool.ptr())));
+  EXPECT_TRUE(upb_MessageDef_CanReachRequired(
+      upb_util_test_TestRequiredFields_getmsgdef(defpool.ptr())));
+  EXPECT_TRUE(upb_MessageDef_CanReachRequired(
+      upb_util_test_ReachesRequiredThroughCycle_getmsgdef(defpool.ptr())));
+}
+
+TEST(RequiredFieldsTest, SkipsMessagesThatCannotReachRequired) {
+  upb::Arena arena;
+  upb::DefPool defpool;
+  const upb_MessageDef* m =
+      upb_util_test_ReachesRequiredThroughCycle_getmsgdef(defpool.ptr());
+  upb::Status status;
+  absl::string_view json = R"json(
+      {
+        "optional_message": {"other_message": {"optional_message": {}}}
+      }
+      )json";
+  auto* msg = upb_util_test_ReachesRequiredThroughCycle_new(arena.ptr());
+  EXPECT_TRUE(upb_JsonDecode(json.data(), json.size(), UPB_UPCAST(msg), m,
+                             defpool.ptr(), 0, arena.ptr(), status.ptr()))
+      << status.error_message();
+  EXPECT_FALSE(
+      upb_util_HasUnsetRequired(UPB_UPCAST(msg), m, defpool.ptr(), nullptr));
+}
@@ -7,12 +7,18 @@
 
 #include "upb/wire/byte_size.h"
 
+#include <stddef.h>
+
+#include <string>
+
 #include <gtest/gtest.h>
 #include "google/protobuf/test_messages_proto2.upb.h"
 #include "google/protobuf/test_messages_proto2.upb_minitable.h"
+#include "upb/base/string_view.h"
 #include "upb/base/upcast.h"
 #include "upb/mem/arena.h"
 #include "upb/mini_table/message.h"
+#include "upb/wire/encode.h"
 
 namespace {
 static const upb_MiniTable* kTestMiniTable =
@@ -37,4 +43,38 @@ TEST(ByteSizeTest, PopulatedMsg) {
   upb_Arena_Free(arena);
 }
 
+TEST(ByteSizeTest, EncodeToExactlySizedBuffer) {
+  upb_Arena* arena = upb_Arena_New();
+  protobuf_test_messages_proto2_TestAllTypesProto2* msg =
+      protobuf_test_messages_proto2_TestAllTypesProto2_new(arena);
+  protobuf_test_messages_proto2_TestAllTypesProto2_set_optional_int32(msg, 322);
+  protobuf_test_messages_proto2_TestAllTypesProto2_set_optional_string(
+      msg, upb_StringView_FromString("hello"));
+  char* expected;
+  size_t expected_size;
+  ASSERT_EQ(upb_Encode(UPB_UPCAST(msg), kTestMiniTable, 0, arena, &expected,
+                       &expected_size),
+            kUpb_EncodeStatus_Ok);
+
+  std::string buf(upb_ByteSize(UPB_UPCAST(msg), kTestMiniTable), '\0');
+  size_t size;
+  EXPECT_EQ(upb_EncodeToBuffer(UPB_UPCAST(msg), kTestMiniTable, 0, &buf[0],
+                               buf.size(), &size),
+            kUpb_EncodeStatus_Ok);
+  EXPECT_EQ(buf, std::string(expected, expected_size));
+  EXPECT_EQ(size, expected_size);
+
+  // A larger buffer holds the message at its start.
+  std::string larger(expected_size + 10, '\0');
+  EXPECT_EQ(upb_EncodeToBuffer(UPB_UPCAST(msg), kTestMiniTable, 0, &larger[0],
+                               larger.size(), &size),
+            kUpb_EncodeStatus_Ok);
+  EXPECT_EQ(larger.substr(0, size), std::string(expected, expected_size));
+
+  EXPECT_EQ(upb_EncodeToBuffer(UPB_UPCAST(msg), kTestMiniTable, 0, &buf[0],
+                               buf.size() - 1, &size),
+            kUpb_EncodeStatus_BufferTooSmall);
+  upb_Arena_Free(arena);
+}
+
 }  // namespace
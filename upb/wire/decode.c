@@ -132,12 +132,28 @@ static void _upb_Decoder_VerifyUtf8(upb_Decoder* d, const char* buf, int len) {
   }
 }
 
+// With kUpb_DecodeOption_ReuseStorage, the capacity of arrays past their size
+// holds either NULL or sub-messages that can be reused (see
+// _upb_Decoder_ClearForReuse()), so new capacity must start out zeroed.
+static void _upb_Decoder_ZeroCapacity(upb_Decoder* d, upb_Array* arr,
+                                      size_t from) {
+  if (UPB_LIKELY(!(d->options & kUpb_DecodeOption_ReuseStorage))) return;
+  const int lg2 = UPB_PRIVATE(_upb_Array_ElemSizeLg2)(arr);
+  char* data = upb_Array_MutableDataPtr(arr);
+  memset(data + (from << lg2), 0,
+         (arr->UPB_PRIVATE(capacity) - from) << lg2);
+}
+
 static bool _upb_Decoder_Reserve(upb_Decoder* d, upb_Array* arr, size_t elem) {
   bool need_realloc =
       arr->UPB_PRIVATE(capacity) - arr->UPB_PRIVATE(size) < elem;
-  if (need_realloc && !UPB_PRIVATE(_upb_Array_Realloc)(
-                          arr, arr->UPB_PRIVATE(size) + elem, &d->arena)) {
-    _upb_Decoder_ErrorJmp(d, kUpb_DecodeStatus_OutOfMemory);
+  if (need_realloc) {
+    const size_t capacity = arr->UPB_PRIVATE(capacity);
+    if (!UPB_PRIVATE(_upb_Array_Realloc)(arr, arr->UPB_PRIVATE(size) + elem,
+                                         &d->arena)) {
+      _upb_Decoder_ErrorJmp(d, kUpb_DecodeStatus_OutOfMemory);
+    }
+    _upb_Decoder_ZeroCapacity(d, arr, capacity);
   }
   return need_realloc;
 }
@@ -293,7 +309,7 @@ static upb_Message* _upb_Decoder_ReuseSubMessage(
   while (upb_Message_NextUnknown(existing, &unknown, &iter)) {
     upb_DecodeStatus status =
         upb_Decode(unknown.data, unknown.size, promoted, subl, d->extreg,
-                   d->options, &d->arena);
+                   d->options & ~kUpb_DecodeOption_ReuseStorage, &d->arena);
     if (status != kUpb_DecodeStatus_Ok) _upb_Decoder_ErrorJmp(d, status);
   }
   return promoted;
@@ -460,12 +476,44 @@ const char* _upb_Decoder_DecodeFixedPacked(upb_Decoder* d, const char* ptr,
   return ptr;
 }
 
+// Returns the number of varints that end in `size` bytes at `ptr`, which is
+// the number of bytes without the continuation bit.  Counts eight bytes at a
+// time.
+static size_t _upb_Decoder_CountVarints(const char* ptr, size_t size) {
+  const uint64_t kHighBits = 0x8080808080808080ULL;
+  const uint64_t kLowBytes = 0x0101010101010101ULL;
+  size_t count = 0;
+  for (; size >= 8; ptr += 8, size -= 8) {
+    uint64_t word;
+    memcpy(&word, ptr, 8);
+    // One bit per terminating byte, moved to the bottom of its byte and then
+    // summed into the top byte by the multiplication.
+    count += (((~word & kHighBits) >> 7) * kLowBytes) >> 56;
+  }
+  for (; size > 0; ptr++, size--) {
+    count += (*ptr & 0x80) == 0;
+  }
+  return count;
+}
+
+// Reserves room for the elements of a packed varint field of `size` bytes at
+// `ptr`, so that the array grows at most once.  If the data is not all in the
+// current buffer, the array just grows as elements are added.
+UPB_FORCEINLINE
+void _upb_Decoder_ReserveVarintPacked(upb_Decoder* d, const char* ptr,
+                                      upb_Array* arr, int size) {
+  if (upb_EpsCopyInputStream_CheckDataSizeAvailable(&d->input, ptr, size)) {
+    _upb_Decoder_Reserve(d, arr, _upb_Decoder_CountVarints(ptr, size));
+  }
+}
+
 UPB_FORCEINLINE
 const char* _upb_Decoder_DecodeVarintPacked(upb_Decoder* d, const char* ptr,
                                             upb_Array* arr, wireval* val,
                                             const upb_MiniTableField* field,
                                             int lg2) {
   int scale = 1 << lg2;
+  _upb_Decoder_ReserveVarintPacked(d, ptr, arr, val->size);
   int saved_limit = upb_EpsCopyInputStream_PushLimit(&d->input, ptr, val->size);
   char* out = UPB_PTR_AT(upb_Array_MutableDataPtr(arr),
                          arr->UPB_PRIVATE(size) << lg2, void);
@@ -491,6 +539,7 @@ static const char* _upb_Decoder_DecodeEnumPacked(
     const upb_MiniTableSubInternal* subs, const upb_MiniTableField* field,
     wireval* val) {
   const upb_MiniTableEnum* e = _upb_MiniTableSubs_EnumByField(subs, field);
+  _upb_Decoder_ReserveVarintPacked(d, ptr, arr, val->size);
   int saved_limit = upb_EpsCopyInputStream_PushLimit(&d->input, ptr, val->size);
   char* out = UPB_PTR_AT(upb_Array_MutableDataPtr(arr),
                          arr->UPB_PRIVATE(size) * 4, void);
@@ -519,6 +568,7 @@ static upb_Array* _upb_Decoder_CreateArray(upb_Decoder* d,
   const size_t lg2 = UPB_PRIVATE(_upb_FieldType_SizeLg2)(field_type);
   upb_Array* ret = UPB_PRIVATE(_upb_Array_New)(&d->arena, 4, lg2);
   if (!ret) _upb_Decoder_ErrorJmp(d, kUpb_DecodeStatus_OutOfMemory);
+  _upb_Decoder_ZeroCapacity(d, ret, 0);
   return ret;
 }
 
@@ -562,7 +612,10 @@ static const char* _upb_Decoder_DecodeToArray(
       upb_TaggedMessagePtr* target = UPB_PTR_AT(
           upb_Array_MutableDataPtr(arr), arr->UPB_PRIVATE(size) * sizeof(void*),
           upb_TaggedMessagePtr);
-      upb_Message* submsg = _upb_Decoder_NewSubMessage(d, subs, field, target);
+      upb_Message* submsg =
+          UPB_UNLIKELY(d->options & kUpb_DecodeOption_ReuseStorage) && *target
+              ? UPB_PRIVATE(_upb_TaggedMessagePtr_GetMessage)(*target)
+              : _upb_Decoder_NewSubMessage(d, subs, field, target);
       arr->UPB_PRIVATE(size)++;
       if (UPB_UNLIKELY(field->UPB_PRIVATE(descriptortype) ==
                        kUpb_FieldType_Group)) {
@@ -1397,6 +1450,113 @@ uint16_t upb_DecodeOptions_GetEffectiveMaxDepth(uint32_t options) {
   return max_depth ? max_depth : kUpb_WireFormat_DefaultDepthLimit;
 }
 
+static void _upb_Decoder_ClearForReuse(upb_Message* msg,
+                                       const upb_MiniTable* m, int depth);
+
+// Clears the sub-message `tagged` of type `subl` for reuse, or returns false
+// if it must be dropped instead.
+static bool _upb_Decoder_ClearSubMessageForReuse(upb_TaggedMessagePtr tagged,
+                                                 const upb_MiniTable* subl,
+                                                 int depth) {
+  if (!tagged || depth == 0 || upb_TaggedMessagePtr_IsEmpty(tagged) ||
+      UPB_PRIVATE(_upb_MiniTable_IsEmpty)(subl)) {
+    return false;
+  }
+  upb_Message* sub = UPB_PRIVATE(_upb_TaggedMessagePtr_GetMessage)(tagged);
+  if (upb_Message_IsFrozen(sub)) return false;
+  _upb_Decoder_ClearForReuse(sub, subl, depth - 1);
+  return true;
+}
+
+static void _upb_Decoder_ClearArrayForReuse(upb_Array** arrp,
+                                            const upb_MiniTable* subl,
+                                            int depth) {
+  upb_Array* arr = *arrp;
+  if (!arr) return;
+  if (upb_Array_IsFrozen(arr)) {
+    *arrp = NULL;
+    return;
+  }
+  if (subl) {
+    // The cleared elements stay in the capacity of the array, where
+    // _upb_Decoder_DecodeToArray() takes them back as it appends.
+    upb_TaggedMessagePtr* elems = upb_Array_MutableDataPtr(arr);
+    for (size_t i = 0; i < arr->UPB_PRIVATE(size); i++) {
+      if (!_upb_Decoder_ClearSubMessageForReuse(elems[i], subl, depth)) {
+        elems[i] = 0;
+      }
+    }
+    memset(elems + arr->UPB_PRIVATE(size), 0,
+           (arr->UPB_PRIVATE(capacity) - arr->UPB_PRIVATE(size)) *
+               sizeof(*elems));
+  }
+  arr->UPB_PRIVATE(size) = 0;
+}
+
+// Clears `msg` for kUpb_DecodeOption_ReuseStorage.  Singular sub-messages are
+// cleared too but keep their pointer, with their hasbit cleared, so that the
+// decoder merges into them if they occur again.
+static void _upb_Decoder_ClearForReuse(upb_Message* msg,
+                                       const upb_MiniTable* m, int depth) {
+  upb_Message_Internal* in = UPB_PRIVATE(_upb_Message_GetInternal)(msg);
+  if (in) in->size = 0;
+
+  for (int i = 0; i < upb_MiniTable_FieldCount(m); i++) {
+    const upb_MiniTableField* f = upb_MiniTable_GetFieldByIndex(m, i);
+    void* mem = UPB_PRIVATE(_upb_Message_MutableDataPtr)(msg, f);
+    if (upb_MiniTableField_IsMap(f)) {
+      upb_Map** mapp = mem;
+      if (*mapp && upb_Map_IsFrozen(*mapp)) *mapp = NULL;
+      if (*mapp) _upb_Map_Clear(*mapp);
+    } else if (upb_MiniTableField_IsArray(f)) {
+      _upb_Decoder_ClearArrayForReuse(mem, upb_MiniTable_SubMessage(m, f),
+                                      depth);
+    } else if (upb_MiniTableField_IsSubMessage(f) &&
+               UPB_PRIVATE(_upb_MiniTableField_HasHasbit)(f)) {
+      upb_TaggedMessagePtr* ptr = mem;
+      if (!_upb_Decoder_ClearSubMessageForReuse(
+              *ptr, upb_MiniTable_SubMessage(m, f), depth)) {
+        *ptr = 0;
+      }
+      UPB_PRIVATE(_upb_Message_ClearHasbit)(msg, f);
+    } else {
+      upb_Message_ClearBaseField(msg, f);
+    }
+  }
+}
+
+// Drops the singular sub-messages that _upb_Decoder_ClearForReuse() kept but
+// that the payload did not set again.
+static void _upb_Decoder_DropUnusedSubMessages(upb_Message* msg,
+                                               const upb_MiniTable* m) {
+  for (int i = 0; i < upb_MiniTable_FieldCount(m); i++) {
+    const upb_MiniTableField* f = upb_MiniTable_GetFieldByIndex(m, i);
+    if (!upb_MiniTableField_IsSubMessage(f) || upb_MiniTableField_IsMap(f)) {
+      continue;
+    }
+    const upb_MiniTable* subl = upb_MiniTable_SubMessage(m, f);
+    void* mem = UPB_PRIVATE(_upb_Message_MutableDataPtr)(msg, f);
+    const upb_TaggedMessagePtr* elems = mem;
+    size_t n = 1;
+    if (upb_MiniTableField_IsArray(f)) {
+      const upb_Array* arr = *(upb_Array**)mem;
+      if (!arr) continue;
+      elems = upb_Array_DataPtr(arr);
+      n = arr->UPB_PRIVATE(size);
+    } else if (!UPB_PRIVATE(_upb_MiniTableField_HasHasbit)(f)) {
+      continue;
+    } else if (!UPB_PRIVATE(_upb_Message_GetHasbit)(msg, f)) {
+      *(upb_TaggedMessagePtr*)mem = 0;
+      continue;
+    }
+    for (size_t j = 0; j < n; j++) {
+      if (!elems[j] || upb_TaggedMessagePtr_IsEmpty(elems[j])) continue;
+      _upb_Decoder_DropUnusedSubMessages(
+          UPB_PRIVATE(_upb_TaggedMessagePtr_GetMessage)(elems[j]), subl);
+    }
+  }
+}
+
 upb_DecodeStatus upb_Decode(const char* buf, size_t size, upb_Message* msg,
                             const upb_MiniTable* mt,
                             const upb_ExtensionRegistry* extreg, int options,
@@ -1421,7 +1581,13 @@ upb_DecodeStatus upb_Decode(const char* buf, size_t size, upb_Message* msg,
   // (particularly parent_or_count).
   UPB_PRIVATE(_upb_Arena_SwapIn)(&decoder.arena, arena);
 
-  return upb_Decoder_Decode(&decoder, buf, msg, mt, arena);
+  if (!(options & kUpb_DecodeOption_ReuseStorage)) {
+    return upb_Decoder_Decode(&decoder, buf, msg, mt, arena);
+  }
+  _upb_Decoder_ClearForReuse(msg, mt, decoder.depth);
+  upb_DecodeStatus status = upb_Decoder_Decode(&decoder, buf, msg, mt, arena);
+  _upb_Decoder_DropUnusedSubMessages(msg, mt);
+  return status;
 }
 
 upb_DecodeStatus upb_DecodeLengthPrefixed(const char* buf, size_t size,
@@ -93,6 +93,20 @@ enum {
    * as non-UTF-8 proto3 string fields.
    */
   kUpb_DecodeOption_AlwaysValidateUtf8 = 8,
+
+  /* If set, the message is cleared before decoding, but its storage is kept
+   * for the decoder to fill again instead of allocating new storage from the
+   * arena: arrays and maps keep their capacity, the internal buffer of unknown
+   * fields and extensions keeps its size, and sub-messages, including the
+   * elements of repeated sub-message fields, are cleared and reused.  This
+   * keeps arena growth bounded when the same message is decoded into in a
+   * loop.
+   *
+   * The message must own its sub-messages: a sub-message that is present in
+   * more than one place of the message will be decoded into more than once.
+   * Frozen sub-messages, arrays and maps are never reused.  Strings, and the
+   * values of maps and extensions, are not reused. */
+  kUpb_DecodeOption_ReuseStorage = 16,
 };
 
 UPB_INLINE uint32_t upb_DecodeOptions_MaxDepth(uint16_t depth) {
@@ -0,0 +1,57 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "upb/wire/decode_stream.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "upb/base/status.h"
+#include "upb/io/zero_copy_input_stream.h"
+#include "upb/mem/arena.h"
+#include "upb/message/message.h"
+#include "upb/mini_table/extension_registry.h"
+#include "upb/mini_table/message.h"
+#include "upb/wire/decode.h"
+
+// Must be last.
+#include "upb/port/def.inc"
+
+upb_DecodeStatus upb_DecodeStream(upb_ZeroCopyInputStream* stream,
+                                  upb_Message* msg, const upb_MiniTable* mt,
+                                  const upb_ExtensionRegistry* extreg,
+                                  int options, upb_Arena* arena) {
+  upb_Status status;
+  upb_Status_Clear(&status);
+  char* buf = NULL;
+  size_t size = 0;
+  size_t capacity = 0;
+
+  while (true) {
+    size_t count;
+    const void* chunk = upb_ZeroCopyInputStream_Next(stream, &count, &status);
+    if (!chunk) break;
+    if (capacity - size < count) {
+      size_t new_capacity = UPB_MAX(capacity * 2, 128);
+      if (new_capacity - size < count) new_capacity = size + count;
+      buf = upb_Arena_Realloc(arena, buf, capacity, new_capacity);
+      if (!buf) return kUpb_DecodeStatus_OutOfMemory;
+      capacity = new_capacity;
+    }
+    memcpy(buf + size, chunk, count);
+    size += count;
+  }
+  if (!upb_Status_IsOk(&status)) return kUpb_DecodeStatus_Malformed;
+
+  if (!buf) {
+    return upb_Decode("", 0, msg, mt, extreg, options, arena);
+  }
+  // The buffer lives as long as the arena, so the message can alias it.
+  return upb_Decode(buf, size, msg, mt, extreg,
+                    options | kUpb_DecodeOption_AliasString, arena);
+}
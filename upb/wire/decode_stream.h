@@ -0,0 +1,47 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// upb_DecodeStream: parsing a upb_ZeroCopyInputStream into a upb_Message.
+
+#ifndef UPB_WIRE_DECODE_STREAM_H_
+#define UPB_WIRE_DECODE_STREAM_H_
+
+#include "upb/io/zero_copy_input_stream.h"
+#include "upb/mem/arena.h"
+#include "upb/message/message.h"
+#include "upb/mini_table/extension_registry.h"
+#include "upb/mini_table/message.h"
+#include "upb/wire/decode.h"
+
+// Must be last.
+#include "upb/port/def.inc"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Like upb_Decode(), but reads the serialized message from `stream` until EOF.
+//
+// The chunks returned by the stream are gathered into a single buffer on
+// `arena`, which strings and unknown fields then alias instead of being copied
+// a second time, as if kUpb_DecodeOption_AliasString were passed. Callers
+// therefore need not flatten chunked input themselves.
+//
+// Returns kUpb_DecodeStatus_Malformed if the stream reports an error.
+UPB_API upb_DecodeStatus upb_DecodeStream(upb_ZeroCopyInputStream* stream,
+                                          upb_Message* msg,
+                                          const upb_MiniTable* mt,
+                                          const upb_ExtensionRegistry* extreg,
+                                          int options, upb_Arena* arena);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#include "upb/port/undef.inc"
+
+#endif /* UPB_WIRE_DECODE_STREAM_H_ */
@@ -0,0 +1,90 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "upb/wire/decode_stream.h"
+
+#include <stddef.h>
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include "google/protobuf/test_messages_proto2.upb.h"
+#include "google/protobuf/test_messages_proto2.upb_minitable.h"
+#include "upb/base/string_view.h"
+#include "upb/base/upcast.h"
+#include "upb/io/chunked_input_stream.h"
+#include "upb/mem/arena.h"
+#include "upb/mini_table/message.h"
+#include "upb/wire/decode.h"
+#include "upb/wire/encode.h"
+
+namespace {
+static const upb_MiniTable* kTestMiniTable =
+    &protobuf_0test_0messages__proto2__TestAllTypesProto2_msg_init;
+
+TEST(DecodeStreamTest, DecodesAcrossChunks) {
+  upb_Arena* arena = upb_Arena_New();
+  protobuf_test_messages_proto2_TestAllTypesProto2* msg =
+      protobuf_test_messages_proto2_TestAllTypesProto2_new(arena);
+  protobuf_test_messages_proto2_TestAllTypesProto2_set_optional_int32(msg, 322);
+  const std::string payload(100, 'x');
+  protobuf_test_messages_proto2_TestAllTypesProto2_set_optional_string(
+      msg, upb_StringView_FromDataAndSize(payload.data(), payload.size()));
+  char* serialized;
+  size_t size;
+  ASSERT_EQ(upb_Encode(UPB_UPCAST(msg), kTestMiniTable, 0, arena, &serialized,
+                       &size),
+            kUpb_EncodeStatus_Ok);
+
+  for (size_t limit : {size_t{1}, size_t{7}, size}) {
+    upb_ZeroCopyInputStream* stream =
+        upb_ChunkedInputStream_New(serialized, size, limit, arena);
+    protobuf_test_messages_proto2_TestAllTypesProto2* parsed =
+        protobuf_test_messages_proto2_TestAllTypesProto2_new(arena);
+    ASSERT_EQ(upb_DecodeStream(stream, UPB_UPCAST(parsed), kTestMiniTable,
+                               nullptr, 0, arena),
+              kUpb_DecodeStatus_Ok);
+    EXPECT_EQ(
+        protobuf_test_messages_proto2_TestAllTypesProto2_optional_int32(parsed),
+        322);
+    upb_StringView str =
+        protobuf_test_messages_proto2_TestAllTypesProto2_optional_string(
+            parsed);
+    EXPECT_EQ(std::string(str.data, str.size), payload);
+  }
+  upb_Arena_Free(arena);
+}
+
+TEST(DecodeStreamTest, EmptyStream) {
+  upb_Arena* arena = upb_Arena_New();
+  upb_ZeroCopyInputStream* stream =
+      upb_ChunkedInputStream_New(nullptr, 0, 16, arena);
+  protobuf_test_messages_proto2_TestAllTypesProto2* parsed =
+      protobuf_test_messages_proto2_TestAllTypesProto2_new(arena);
+  EXPECT_EQ(upb_DecodeStream(stream, UPB_UPCAST(parsed), kTestMiniTable,
+                             nullptr, 0, arena),
+            kUpb_DecodeStatus_Ok);
+  EXPECT_FALSE(
+      protobuf_test_messages_proto2_TestAllTypesProto2_has_optional_int32(
+          parsed));
+  upb_Arena_Free(arena);
+}
+
+TEST(DecodeStreamTest, MalformedInput) {
+  upb_Arena* arena = upb_Arena_New();
+  const char bad[] = "\x0a\x05xx";  // Length exceeds the input.
+  upb_ZeroCopyInputStream* stream =
+      upb_ChunkedInputStream_New(bad, sizeof(bad) - 1, 2, arena);
+  protobuf_test_messages_proto2_TestAllTypesProto2* parsed =
+      protobuf_test_messages_proto2_TestAllTypesProto2_new(arena);
+  EXPECT_EQ(upb_DecodeStream(stream, UPB_UPCAST(parsed), kTestMiniTable,
+                             nullptr, 0, arena),
+            kUpb_DecodeStatus_Malformed);
+  upb_Arena_Free(arena);
+}
+
+}  // namespace
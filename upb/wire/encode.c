@@ -76,7 +76,7 @@ static uint64_t encode_zz64(int64_t n) {
 typedef struct {
   upb_EncodeStatus status;
   jmp_buf err;
-  upb_Arena* arena;
+  upb_Arena* arena;  // NULL when encoding into a caller-provided buffer.
   char *buf, *ptr, *limit;
   int options;
   int depth;
@@ -99,6 +99,9 @@ UPB_NORETURN static void encode_err(upb_encstate* e, upb_EncodeStatus s) {
 
 UPB_NOINLINE
 static void encode_growbuffer(upb_encstate* e, size_t bytes) {
+  // A caller-provided buffer cannot grow.
+  if (!e->arena) encode_err(e, kUpb_EncodeStatus_BufferTooSmall);
+
   size_t old_size = e->limit - e->buf;
   size_t new_size = upb_roundup_pow2(bytes + (e->limit - e->ptr));
   char* new_buf = upb_Arena_Realloc(e->arena, e->buf, old_size, new_size);
@@ -148,16 +151,22 @@ static void encode_fixed32(upb_encstate* e, uint32_t val) {
   encode_bytes(e, &val, sizeof(uint32_t));
 }
 
+static size_t encode_varintsize(uint64_t val) {
+  size_t len = 1;
+  while (val >= 128) {
+    val >>= 7;
+    len++;
+  }
+  return len;
+}
+
 UPB_NOINLINE
 static void encode_longvarint(upb_encstate* e, uint64_t val) {
-  size_t len;
-  char* start;
-
-  encode_reserve(e, UPB_PB_VARINT_MAX_LEN);
-  len = encode_varint64(val, e->ptr);
-  start = e->ptr + UPB_PB_VARINT_MAX_LEN - len;
-  memmove(start, e->ptr, len);
-  e->ptr = start;
+  // Reserving exactly the encoded size lets us write the varint in place,
+  // instead of writing to a maximum-sized space and moving it to the end.
+  size_t len = encode_varintsize(val);
+  encode_reserve(e, len);
+  encode_varint64(val, e->ptr);
 }
 
 UPB_FORCEINLINE
@@ -193,26 +202,30 @@ static void encode_fixedarray(upb_encstate* e, const upb_Array* arr,
                               size_t elem_size, uint32_t tag) {
   size_t bytes = upb_Array_Size(arr) * elem_size;
   const char* data = upb_Array_DataPtr(arr);
-  const char* ptr = data + bytes - elem_size;
 
   if (tag || !upb_IsLittleEndian()) {
-    while (true) {
+    // The size of the output is known, so reserve it at once and write the
+    // elements front to back.
+    char tag_buf[UPB_PB_VARINT_MAX_LEN];
+    size_t tag_len = tag ? encode_varint64(tag, tag_buf) : 0;
+    encode_reserve(e, bytes + upb_Array_Size(arr) * tag_len);
+    char* out = e->ptr;
+    for (const char* ptr = data; ptr < data + bytes; ptr += elem_size) {
+      memcpy(out, tag_buf, tag_len);
+      out += tag_len;
       if (elem_size == 4) {
         uint32_t val;
         memcpy(&val, ptr, sizeof(val));
         val = upb_BigEndian32(val);
-        encode_bytes(e, &val, elem_size);
+        memcpy(out, &val, sizeof(val));
       } else {
         UPB_ASSERT(elem_size == 8);
         uint64_t val;
         memcpy(&val, ptr, sizeof(val));
         val = upb_BigEndian64(val);
-        encode_bytes(e, &val, elem_size);
+        memcpy(out, &val, sizeof(val));
       }
-
-      if (tag) encode_varint(e, tag);
-      if (ptr == data) break;
-      ptr -= elem_size;
+      out += elem_size;
     }
   } else {
     encode_bytes(e, data, bytes);
@@ -445,7 +458,19 @@ static void encode_map(upb_encstate* e, const upb_Message* msg,
 
   if (!map || !upb_Map_Size(map)) return;
 
-  if (e->options & kUpb_EncodeOption_Deterministic) {
+  const void* const* cached = map->UPB_PRIVATE(sorted);
+  if ((e->options & kUpb_EncodeOption_Deterministic) && cached) {
+    // The order was cached by upb_Message_CacheMapOrder().
+    const void* const* end = cached + upb_Map_Size(map);
+    for (; cached < end; cached++) {
+      const upb_tabent* tabent = (const upb_tabent*)*cached;
+      upb_MapEntry ent;
+      _upb_map_fromkey(upb_tabstrview(tabent->key), &ent.k, map->key_size);
+      upb_value val = {tabent->val.val};
+      _upb_map_fromvalue(val, &ent.v, map->val_size);
+      encode_mapentry(e, upb_MiniTableField_Number(f), layout, &ent);
+    }
+  } else if (e->options & kUpb_EncodeOption_Deterministic) {
     _upb_sortedmap sorted;
     _upb_mapsorter_pushmap(
         &e->sorter, layout->UPB_PRIVATE(fields)[0].UPB_PRIVATE(descriptortype),
@@ -712,6 +737,29 @@ upb_EncodeStatus upb_EncodeLengthPrefixed(const upb_Message* msg,
   return _upb_Encode(msg, l, options, arena, buf, size, true);
 }
 
+upb_EncodeStatus upb_EncodeToBuffer(const upb_Message* msg,
+                                    const upb_MiniTable* l, int options,
+                                    char* buf, size_t capacity, size_t* size) {
+  upb_encstate e;
+
+  e.status = kUpb_EncodeStatus_Ok;
+  e.arena = NULL;
+  e.buf = buf;
+  e.limit = buf + capacity;
+  e.ptr = e.limit;
+  e.depth = upb_EncodeOptions_GetEffectiveMaxDepth(options);
+  e.options = options;
+  _upb_mapsorter_init(&e.sorter);
+
+  char* encoded;
+  upb_EncodeStatus status =
+      upb_Encoder_Encode(&e, msg, l, &encoded, size, false);
+  if (status == kUpb_EncodeStatus_Ok && encoded != buf && *size > 0) {
+    memmove(buf, encoded, *size);
+  }
+  return status;
+}
+
 const char* upb_EncodeStatus_String(upb_EncodeStatus status) {
   switch (status) {
     case kUpb_EncodeStatus_Ok:
@@ -722,6 +770,8 @@ const char* upb_EncodeStatus_String(upb_EncodeStatus status) {
       return "Max depth exceeded";
     case kUpb_EncodeStatus_OutOfMemory:
       return "Arena alloc failed";
+    case kUpb_EncodeStatus_BufferTooSmall:
+      return "Buffer too small";
     default:
       return "Unknown encode status";
   }
@@ -48,6 +48,9 @@ typedef enum {
 
   // kUpb_EncodeOption_CheckRequired failed but the parse otherwise succeeded.
   kUpb_EncodeStatus_MissingRequired = 3,
+
+  // The caller-provided buffer of upb_EncodeToBuffer() was too small.
+  kUpb_EncodeStatus_BufferTooSmall = 4,
 } upb_EncodeStatus;
 // LINT.ThenChange(//depot/google3/third_party/protobuf/rust/upb.rs:encode_status)
 
@@ -77,6 +80,20 @@ UPB_API upb_EncodeStatus upb_EncodeLengthPrefixed(const upb_Message* msg,
                                                   const upb_MiniTable* l,
                                                   int options, upb_Arena* arena,
                                                   char** buf, size_t* size);
+
+// Encodes the message into the caller-provided buffer `buf` of `capacity`
+// bytes, without allocating. On success the encoded message occupies the first
+// `*size` bytes of `buf`. Returns kUpb_EncodeStatus_BufferTooSmall if the
+// message does not fit, in which case the contents of `buf` are unspecified.
+//
+// Pairing this with upb_ByteSize() encodes into a buffer of exactly the right
+// size; since the encoder writes back to front, an exactly sized buffer is
+// filled in place without moving the result.
+UPB_API upb_EncodeStatus upb_EncodeToBuffer(const upb_Message* msg,
+                                            const upb_MiniTable* l,
+                                            int options, char* buf,
+                                            size_t capacity, size_t* size);
+
 // Utility function for wrapper languages to get an error string from a
 // upb_EncodeStatus.
 UPB_API const char* upb_EncodeStatus_String(upb_EncodeStatus status);
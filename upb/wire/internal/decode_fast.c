@@ -900,8 +900,23 @@ const char* fastdecode_tosubmsg(upb_EpsCopyInputStream* e, const char* ptr,
   return ptr;
 }
 
+// Groups have no length prefix. The sub-message is parsed until the generic
+// decoder sees its END_GROUP tag, which must carry the group's field number.
+UPB_FORCEINLINE
+const char* fastdecode_togroup(upb_Decoder* d, const char* ptr,
+                               fastdecode_submsgdata* submsg, int tagbytes) {
+  uint32_t number = (uint8_t)ptr[0] & 0x7f;
+  if (tagbytes == 2) number |= (uint32_t)(uint8_t)ptr[1] << 7;
+  number >>= 3;
+  ptr += tagbytes;
+  ptr = fastdecode_dispatch(d, ptr, submsg->msg, submsg->table, 0, 0);
+  if (UPB_UNLIKELY(d->end_group != number)) return NULL;
+  d->end_group = DECODE_NOGROUP;
+  return ptr;
+}
+
 #define FASTDECODE_SUBMSG(d, ptr, msg, table, hasbits, data, tagbytes,    \
-                          msg_ceil_bytes, card)                           \
+                          msg_ceil_bytes, card, group)                    \
                                                                           \
   if (UPB_UNLIKELY(!fastdecode_checktag(data, tagbytes))) {               \
     RETURN_GENERIC("submessage field tag mismatch\n");                    \
@@ -924,6 +939,13 @@ const char* fastdecode_tosubmsg(upb_EpsCopyInputStream* e, const char* ptr,
     RETURN_GENERIC("submessage doesn't have fast tables.");               \
   }                                                                       \
                                                                           \
+  /* The generic decoder reuses the elements of the array. */             \
+  if (card == CARD_r &&                                                   \
+      UPB_UNLIKELY(d->options & kUpb_DecodeOption_ReuseStorage)) {        \
+    d->depth++;                                                           \
+    RETURN_GENERIC("reusing repeated submessages\n");                     \
+  }                                                                       \
+                                                                          \
   dst = fastdecode_getfield(d, ptr, msg, &data, &hasbits, &farr,          \
                             sizeof(upb_Message*), card);                  \
                                                                           \
@@ -943,8 +965,12 @@ const char* fastdecode_tosubmsg(upb_EpsCopyInputStream* e, const char* ptr,
     *dst = submsg.msg = decode_newmsg_ceil(d, subtablep, msg_ceil_bytes); \
   }                                                                       \
                                                                           \
-  ptr += tagbytes;                                                        \
-  ptr = fastdecode_delimited(d, ptr, fastdecode_tosubmsg, &submsg);       \
+  if (group) {                                                            \
+    ptr = fastdecode_togroup(d, ptr, &submsg, tagbytes);                  \
+  } else {                                                                \
+    ptr += tagbytes;                                                      \
+    ptr = fastdecode_delimited(d, ptr, fastdecode_tosubmsg, &submsg);     \
+  }                                                                       \
                                                                           \
   if (UPB_UNLIKELY(ptr == NULL || d->end_group != DECODE_NOGROUP)) {      \
     _upb_FastDecoder_ErrorJmp(d, kUpb_DecodeStatus_Malformed);            \
@@ -970,28 +996,38 @@ const char* fastdecode_tosubmsg(upb_EpsCopyInputStream* e, const char* ptr,
   d->depth++;                                                             \
   UPB_MUSTTAIL return fastdecode_dispatch(UPB_PARSE_ARGS);
 
-#define F(card, tagbytes, size_ceil, ceil_arg)                               \
-  const char* upb_p##card##m_##tagbytes##bt_max##size_ceil##b(               \
+#define m_GROUP false
+#define g_GROUP true
+
+#define F(card, type, tagbytes, size_ceil, ceil_arg)                         \
+  const char* upb_p##card##type##_##tagbytes##bt_max##size_ceil##b(          \
       UPB_PARSE_PARAMS) {                                                    \
     FASTDECODE_SUBMSG(d, ptr, msg, table, hasbits, data, tagbytes, ceil_arg, \
-                      CARD_##card);                                          \
+                      CARD_##card, type##_GROUP);                            \
   }
 
-#define SIZES(card, tagbytes) \
-  F(card, tagbytes, 64, 64)   \
-  F(card, tagbytes, 128, 128) \
-  F(card, tagbytes, 192, 192) \
-  F(card, tagbytes, 256, 256) \
-  F(card, tagbytes, max, -1)
+#define SIZES(card, type, tagbytes) \
+  F(card, type, tagbytes, 64, 64)   \
+  F(card, type, tagbytes, 128, 128) \
+  F(card, type, tagbytes, 192, 192) \
+  F(card, type, tagbytes, 256, 256) \
+  F(card, type, tagbytes, max, -1)
+
+#define TYPES(card, tagbytes) \
+  SIZES(card, m, tagbytes)    \
+  SIZES(card, g, tagbytes)
 
 #define TAGBYTES(card) \
-  SIZES(card, 1)       \
-  SIZES(card, 2)
+  TYPES(card, 1)       \
+  TYPES(card, 2)
 
 TAGBYTES(s)
 TAGBYTES(o)
 TAGBYTES(r)
 
+#undef m_GROUP
+#undef g_GROUP
+#undef TYPES
 #undef TAGBYTES
 #undef SIZES
 #undef F
@@ -32,6 +32,7 @@
 //   - 'f4' for 4-byte fixed
 //   - 'f8' for 8-byte fixed
 //   - 'm' for sub-message
+//   - 'g' for group (sub-message delimited by START/END_GROUP tags)
 //   - 's' for string (validate UTF-8)
 //   - 'b' for bytes
 //
@@ -115,19 +116,24 @@ TAGBYTES(r)
 
 /* sub-message fields *********************************************************/
 
-#define F(card, tagbytes, size_ceil, ceil_arg) \
-  const char* upb_p##card##m_##tagbytes##bt_max##size_ceil##b(UPB_PARSE_PARAMS);
+#define F(card, type, tagbytes, size_ceil, ceil_arg)               \
+  const char* upb_p##card##type##_##tagbytes##bt_max##size_ceil##b( \
+      UPB_PARSE_PARAMS);
 
-#define SIZES(card, tagbytes) \
-  F(card, tagbytes, 64, 64)   \
-  F(card, tagbytes, 128, 128) \
-  F(card, tagbytes, 192, 192) \
-  F(card, tagbytes, 256, 256) \
-  F(card, tagbytes, max, -1)
+#define SIZES(card, type, tagbytes) \
+  F(card, type, tagbytes, 64, 64)   \
+  F(card, type, tagbytes, 128, 128) \
+  F(card, type, tagbytes, 192, 192) \
+  F(card, type, tagbytes, 256, 256) \
+  F(card, type, tagbytes, max, -1)
+
+#define TYPES(card, tagbytes) \
+  SIZES(card, m, tagbytes)    \
+  SIZES(card, g, tagbytes)
 
 #define TAGBYTES(card) \
-  SIZES(card, 1)       \
-  SIZES(card, 2)
+  TYPES(card, 1)       \
+  TYPES(card, 2)
 
 TAGBYTES(s)
 TAGBYTES(o)
@@ -135,6 +141,7 @@ TAGBYTES(r)
 
 #undef F
 #undef SIZES
+#undef TYPES
 #undef TAGBYTES
 
 #undef UPB_PARSE_PARAMS
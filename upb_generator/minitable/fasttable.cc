@@ -167,6 +167,9 @@ bool TryFillTableEntry(const DefPoolPair& pools, upb::FieldDefPtr field,
     case kUpb_FieldType_Message:
       type = "m";
       break;
+    case kUpb_FieldType_Group:
+      type = "g";
+      break;
     default:
       return false;  // Not supported yet.
   }
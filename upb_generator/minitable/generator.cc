@@ -8,11 +8,13 @@
 #include "upb_generator/minitable/generator.h"
 
 #include <cstdint>
+#include <deque>
 #include <map>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_check.h"
 #include "absl/memory/memory.h"
@@ -246,6 +248,65 @@ void WriteExtension(const DefPoolPair& pools, upb::FieldDefPtr ext,
   output("\n};\n");
 }
 
+// Writes the upb_MiniTableFile of `file`.  Its arrays are named with `prefix`
+// so that several layouts can share a source file.
+void WriteFileLayout(upb::FileDefPtr file,
+                     const std::vector<upb::MessageDefPtr>& messages,
+                     const std::vector<upb::EnumDefPtr>& enums,
+                     const std::vector<upb::FieldDefPtr>& extensions,
+                     absl::string_view prefix, Output& output) {
+  const std::string messages_init = absl::StrCat(prefix, kMessagesInit);
+  const std::string enums_init = absl::StrCat(prefix, kEnumsInit);
+  const std::string extensions_init = absl::StrCat(prefix, kExtensionsInit);
+
+  // Messages.
+  if (!messages.empty()) {
+    output("static const upb_MiniTable *$0[$1] = {\n", messages_init,
+           messages.size());
+    for (auto message : messages) {
+      output("  &$0,\n", MessageVarName(message));
+    }
+    output("};\n");
+    output("\n");
+  }
+
+  // Enums.
+  if (!enums.empty()) {
+    output("static const upb_MiniTableEnum *$0[$1] = {\n", enums_init,
+           enums.size());
+    for (const auto e : enums) {
+      output("  &$0,\n", EnumVarName(e));
+    }
+    output("};\n");
+    output("\n");
+  }
+
+  if (!extensions.empty()) {
+    // Extensions.
+    output(
+        "\n"
+        "static const upb_MiniTableExtension *$0[$1] = {\n",
+        extensions_init, extensions.size());
+
+    for (auto ext : extensions) {
+      output("  &$0,\n", ExtensionVarName(ext));
+    }
+
+    output(
+        "};\n"
+        "\n");
+  }
+
+  output("const upb_MiniTableFile $0 = {\n", FileVarName(file));
+  output("  $0,\n", messages.empty() ? "NULL" : messages_init.c_str());
+  output("  $0,\n", enums.empty() ? "NULL" : enums_init.c_str());
+  output("  $0,\n", extensions.empty() ? "NULL" : extensions_init.c_str());
+  output("  $0,\n", messages.size());
+  output("  $0,\n", enums.size());
+  output("  $0,\n", extensions.size());
+  output("};\n\n");
+}
+
 }  // namespace
 
 void WriteMiniTableHeader(const DefPoolPair& pools, upb::FileDefPtr file,
@@ -375,52 +436,7 @@ void WriteMiniTableSource(const DefPoolPair& pools, upb::FileDefPtr file,
     }
   }
 
-  // Messages.
-  if (!messages.empty()) {
-    output("static const upb_MiniTable *$0[$1] = {\n", kMessagesInit,
-           messages.size());
-    for (auto message : messages) {
-      output("  &$0,\n", MessageVarName(message));
-    }
-    output("};\n");
-    output("\n");
-  }
-
-  // Enums.
-  if (!enums.empty()) {
-    output("static const upb_MiniTableEnum *$0[$1] = {\n", kEnumsInit,
-           enums.size());
-    for (const auto e : enums) {
-      output("  &$0,\n", EnumVarName(e));
-    }
-    output("};\n");
-    output("\n");
-  }
-
-  if (!extensions.empty()) {
-    // Extensions.
-    output(
-        "\n"
-        "static const upb_MiniTableExtension *$0[$1] = {\n",
-        kExtensionsInit, extensions.size());
-
-    for (auto ext : extensions) {
-      output("  &$0,\n", ExtensionVarName(ext));
-    }
-
-    output(
-        "};\n"
-        "\n");
-  }
-
-  output("const upb_MiniTableFile $0 = {\n", FileVarName(file));
-  output("  $0,\n", messages.empty() ? "NULL" : kMessagesInit);
-  output("  $0,\n", enums.empty() ? "NULL" : kEnumsInit);
-  output("  $0,\n", extensions.empty() ? "NULL" : kExtensionsInit);
-  output("  $0,\n", messages.size());
-  output("  $0,\n", enums.size());
-  output("  $0,\n", extensions.size());
-  output("};\n\n");
+  WriteFileLayout(file, messages, enums, extensions, "", output);
 
   output("#include \"upb/port/undef.inc\"\n");
   output("\n");
@@ -468,5 +484,176 @@ void WriteMiniTableMultipleSources(
   }
 }
 
+namespace {
+
+// The definitions a whole program source keeps, in the order they are written.
+struct WholeProgram {
+  std::vector<upb::MessageDefPtr> messages;
+  std::vector<upb::EnumDefPtr> enums;
+  std::vector<upb::FieldDefPtr> extensions;
+};
+
+bool CollectWholeProgram(const std::vector<upb::FileDefPtr>& files,
+                         const MiniTableOptions& options, WholeProgram* program,
+                         std::string* error) {
+  absl::flat_hash_map<std::string, upb::MessageDefPtr> messages;
+  std::vector<upb::MessageDefPtr> all_messages;
+  std::vector<upb::FieldDefPtr> all_extensions;
+  std::vector<upb::EnumDefPtr> all_enums;
+  for (auto file : files) {
+    for (auto message : SortedMessages(file)) {
+      messages.emplace(message.full_name(), message);
+      all_messages.push_back(message);
+    }
+    for (auto ext : SortedExtensions(file)) all_extensions.push_back(ext);
+    for (auto e : SortedEnums(file, kClosedEnums)) all_enums.push_back(e);
+  }
+
+  // Messages are written breadth first from each root, so that the tables of a
+  // message end up close to those of its sub-messages.
+  absl::flat_hash_set<std::string> kept;
+  auto reach = [&](upb::MessageDefPtr root) {
+    std::deque<upb::MessageDefPtr> queue;
+    if (!kept.insert(root.full_name()).second) return;
+    queue.push_back(root);
+    while (!queue.empty()) {
+      upb::MessageDefPtr message = queue.front();
+      queue.pop_front();
+      program->messages.push_back(message);
+      for (int i = 0; i < message.field_count(); i++) {
+        upb::MessageDefPtr sub = message.field(i).message_type();
+        // Messages outside the program are defined by their own sources.
+        if (!sub || !messages.contains(sub.full_name())) continue;
+        if (kept.insert(sub.full_name()).second) queue.push_back(sub);
+      }
+    }
+  };
+
+  const bool keep_all = options.whole_program_roots.empty();
+  if (keep_all) {
+    for (auto message : all_messages) reach(message);
+  }
+  for (const auto& name : options.whole_program_roots) {
+    auto it = messages.find(name);
+    if (it == messages.end()) {
+      *error = absl::Substitute("Unknown whole_program_root: $0", name);
+      return false;
+    }
+    reach(it->second);
+  }
+
+  // An extension is kept with the message it extends, and keeps its own type.
+  std::vector<bool> kept_extensions(all_extensions.size());
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (size_t i = 0; i < all_extensions.size(); i++) {
+      if (kept_extensions[i]) continue;
+      const std::string extendee =
+          all_extensions[i].containing_type().full_name();
+      if (!keep_all && messages.contains(extendee) &&
+          !kept.contains(extendee)) {
+        continue;
+      }
+      kept_extensions[i] = true;
+      changed = true;
+      upb::MessageDefPtr sub = all_extensions[i].message_type();
+      if (sub && messages.contains(sub.full_name())) reach(sub);
+    }
+  }
+  for (size_t i = 0; i < all_extensions.size(); i++) {
+    if (kept_extensions[i]) program->extensions.push_back(all_extensions[i]);
+  }
+
+  // Closed enums are kept if a kept field refers to them.
+  absl::flat_hash_set<std::string> used_enums;
+  auto use_enum = [&](upb::FieldDefPtr field) {
+    if (auto e = field.enum_subdef()) used_enums.insert(e.full_name());
+  };
+  for (auto message : program->messages) {
+    for (int i = 0; i < message.field_count(); i++) use_enum(message.field(i));
+  }
+  for (auto ext : program->extensions) use_enum(ext);
+  for (auto e : all_enums) {
+    if (keep_all || used_enums.contains(e.full_name())) {
+      program->enums.push_back(e);
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool WriteMiniTableWholeProgramSource(const DefPoolPair& pools,
+                                      const std::vector<upb::FileDefPtr>& files,
+                                      const MiniTableOptions& options,
+                                      Output& output, std::string* error) {
+  WholeProgram program;
+  if (!CollectWholeProgram(files, options, &program, error)) return false;
+
+  output(
+      "/* This file was generated by upb_generator from the input files:\n"
+      " *\n");
+  for (auto file : files) {
+    output(" *     $0\n", file.name());
+  }
+  output(
+      " *\n"
+      " * Do not edit -- your changes will be discarded when the file is\n"
+      " * regenerated.\n"
+      " * NO CHECKED-IN "
+      // Intentional line break.
+      "PROTOBUF GENCODE */\n"
+      "\n");
+
+  output(
+      "#include <stddef.h>\n"
+      "#include \"upb/generated_code_support.h\"\n");
+  absl::flat_hash_set<std::string> included;
+  auto include = [&](upb::FileDefPtr file) {
+    if (!included.insert(file.name()).second) return;
+    output("#include \"$0\"\n", HeaderFilename(file, options.bootstrap));
+  };
+  for (auto file : files) include(file);
+  for (auto file : files) {
+    for (int i = 0; i < file.dependency_count(); i++) {
+      if (options.strip_nonfunctional_codegen &&
+          google::protobuf::compiler::IsKnownFeatureProto(
+              file.dependency(i).name())) {
+        continue;
+      }
+      include(file.dependency(i));
+    }
+  }
+
+  output(
+      "\n"
+      "// Must be last.\n"
+      "#include \"upb/port/def.inc\"\n"
+      "\n");
+
+  for (auto message : program.messages) {
+    WriteMessage(message, pools, options, output);
+  }
+  for (const auto e : program.enums) {
+    WriteEnum(e, output);
+  }
+  for (const auto ext : program.extensions) {
+    WriteExtension(pools, ext, output);
+  }
+
+  // The layouts list every definition of their file, for reflection.
+  if (options.whole_program_roots.empty()) {
+    for (auto file : files) {
+      WriteFileLayout(file, SortedMessages(file),
+                      SortedEnums(file, kClosedEnums), SortedExtensions(file),
+                      absl::StrCat(FileVarName(file), "_"), output);
+    }
+  }
+
+  output("#include \"upb/port/undef.inc\"\n");
+  output("\n");
+  return true;
+}
+
 }  // namespace generator
 }  // namespace upb
@@ -5,6 +5,9 @@
 // license that can be found in the LICENSE file or at
 // https://developers.google.com/open-source/licenses/bsd
 
+#include <string>
+#include <vector>
+
 #include "google/protobuf/compiler/code_generator.h"
 #include "upb/reflection/def.hpp"
 #include "upb_generator/common.h"
@@ -17,6 +20,16 @@ struct MiniTableOptions {
   bool bootstrap = false;
   bool one_output_per_message = false;
   bool strip_nonfunctional_codegen = false;
+
+  // If set, the MiniTables of every file given to the generator are written to
+  // this one source file instead of one source per .proto file.  The files
+  // must cover the whole program, and must not have sources of their own.
+  std::string whole_program_output;
+  // In whole program mode, the messages the program uses.  Only these, the
+  // messages and enums they reach, and the extensions of the messages kept are
+  // written; the rest are left out.  The file layouts used by reflection are
+  // not written either.  If empty, everything is kept.
+  std::vector<std::string> whole_program_roots;
 };
 
 void WriteMiniTableSource(const DefPoolPair& pools, upb::FileDefPtr file,
@@ -25,6 +38,10 @@ void WriteMiniTableMultipleSources(const DefPoolPair& pools,
                                    upb::FileDefPtr file,
                                    const MiniTableOptions& options,
                                    google::protobuf::compiler::GeneratorContext* context);
+bool WriteMiniTableWholeProgramSource(const DefPoolPair& pools,
+                                      const std::vector<upb::FileDefPtr>& files,
+                                      const MiniTableOptions& options,
+                                      Output& output, std::string* error);
 void WriteMiniTableHeader(const DefPoolPair& pools, upb::FileDefPtr file,
                           const MiniTableOptions& options, Output& output);
 
@@ -64,6 +64,30 @@ void GenerateFile(const DefPoolPair& pools, upb::FileDefPtr file,
   }
 }
 
+// Writes the headers of `files` and a single source holding all their
+// MiniTables.
+bool GenerateWholeProgram(const DefPoolPair& pools,
+                          const std::vector<upb::FileDefPtr>& files,
+                          const MiniTableOptions& options,
+                          google::protobuf::compiler::GeneratorContext* context,
+                          std::string* error) {
+  Output c_output;
+  if (!WriteMiniTableWholeProgramSource(pools, files, options, c_output,
+                                        error)) {
+    return false;
+  }
+  for (auto file : files) {
+    Output h_output;
+    WriteMiniTableHeader(pools, file, options, h_output);
+    auto stream = absl::WrapUnique(
+        context->Open(MiniTableHeaderFilename(file.name(), false)));
+    ABSL_CHECK(stream->WriteCord(absl::Cord(h_output.output())));
+  }
+  auto stream = absl::WrapUnique(context->Open(options.whole_program_output));
+  ABSL_CHECK(stream->WriteCord(absl::Cord(c_output.output())));
+  return true;
+}
+
 bool ParseOptions(MiniTableOptions* options, absl::string_view parameter,
                   std::string* error) {
   for (const auto& pair : ParseGeneratorParameter(parameter)) {
@@ -73,12 +97,26 @@ bool ParseOptions(MiniTableOptions* options, absl::string_view parameter,
       options->strip_nonfunctional_codegen = true;
     } else if (pair.first == "one_output_per_message") {
       options->one_output_per_message = true;
+    } else if (pair.first == "whole_program") {
+      options->whole_program_output = pair.second;
+    } else if (pair.first == "whole_program_root") {
+      options->whole_program_roots.push_back(pair.second);
     } else {
       *error = absl::Substitute("Unknown parameter: $0", pair.first);
       return false;
     }
   }
 
+  if (options->whole_program_output.empty()) {
+    if (!options->whole_program_roots.empty()) {
+      *error = "whole_program_root requires whole_program";
+      return false;
+    }
+  } else if (options->one_output_per_message) {
+    *error = "whole_program and one_output_per_message are exclusive";
+    return false;
+  }
+
   return true;
 }
 
@@ -103,6 +141,15 @@ class MiniTableGenerator : public google::protobuf::compiler::CodeGenerator {
     upb::Arena arena;
     DefPoolPair pools;
     absl::flat_hash_set<std::string> files_seen;
+    if (!options.whole_program_output.empty()) {
+      std::vector<upb::FileDefPtr> upb_files;
+      for (const auto* file : files) {
+        PopulateDefPool(file, &arena, &pools, &files_seen);
+        upb_files.push_back(pools.GetFile(file->name()));
+      }
+      return GenerateWholeProgram(pools, upb_files, options, generator_context,
+                                  error);
+    }
     for (const auto* file : files) {
       PopulateDefPool(file, &arena, &pools, &files_seen);
       upb::FileDefPtr upb_file = pools.GetFile(file->name());